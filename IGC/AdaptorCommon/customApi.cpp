@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #endif
 
 #include "common/debug/Debug.hpp"
+#include "common/LockStats.hpp"
 #include "common/Stats.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/SysUtils.hpp"
@@ -360,8 +361,8 @@ namespace IGC
         OutputFolderName IGC_DEBUG_API_CALL GetBaseIGCOutputFolder()
         {
 #if defined(IGC_DEBUG_VARIABLES)
-            static std::mutex m;
-            std::lock_guard<std::mutex> lck(m);
+            static ProfiledMutex m("customApi.GetBaseIGCOutputFolder");
+            std::lock_guard<ProfiledMutex> lck(m);
             static std::string IGCBaseFolder;
             if(IGCBaseFolder != "")
             {
@@ -471,8 +472,8 @@ namespace IGC
         {
             if(IGC_IS_FLAG_ENABLED(ShaderOverride))
             {
-                static std::mutex m;
-                std::lock_guard<std::mutex> lck(m);
+                static ProfiledMutex m("customApi.GetShaderOverridePath");
+                std::lock_guard<ProfiledMutex> lck(m);
                 static std::string overridePath;
                 if(overridePath == "")
                 {
@@ -486,8 +487,8 @@ namespace IGC
         OutputFolderName IGC_DEBUG_API_CALL GetShaderOutputFolder()
         {
 #if defined(IGC_DEBUG_VARIABLES)
-            static std::mutex m;
-            std::lock_guard<std::mutex> lck(m);
+            static ProfiledMutex m("customApi.GetShaderOutputFolder");
+            std::lock_guard<ProfiledMutex> lck(m);
             if(g_shaderOutputFolder != "")
             {
                 return g_shaderOutputFolder.c_str();
@@ -95,7 +95,6 @@ E_RETVAL CElfWriter::AddSection(
 {
     E_RETVAL retVal = SUCCESS;
     SSectionNode* pNode = NULL;
-    size_t nameSize = 0;
     unsigned int dataSize = 0;
 
     // The section header must be non-NULL
@@ -118,7 +117,6 @@ E_RETVAL CElfWriter::AddSection(
         pNode->Flags = pSectionNode->Flags;
         pNode->Type  = pSectionNode->Type;
 
-        nameSize = pSectionNode->Name.size() + 1;
         dataSize = pSectionNode->DataSize;
 
         pNode->Name = pSectionNode->Name;
@@ -141,12 +139,22 @@ E_RETVAL CElfWriter::AddSection(
 
         if( retVal == SUCCESS )
         {
+            // add the name to the string table unless it is already there
+            auto nameIt = m_stringOffsets.find( pNode->Name );
+            if( nameIt == m_stringOffsets.end() )
+            {
+                Elf64_Word nameOffset = (Elf64_Word)m_stringTable.size();
+                m_stringTable.append( pNode->Name ).push_back( '\0' );
+                nameIt = m_stringOffsets.emplace( pNode->Name, nameOffset ).first;
+            }
+
             // push the node onto the queue
             m_nodeQueue.push( pNode );
+            m_nameOffsetQueue.push( nameIt->second );
 
             // increment the sizes for each section
             m_dataSize += dataSize;
-            m_stringTableSize += nameSize;
+            m_stringTableSize = m_stringTable.size();
             m_numSections++;
         }
         else
@@ -180,7 +188,6 @@ E_RETVAL CElfWriter::ResolveBinary(
     SElf64SectionHeader* pCurSectionHeader = NULL;
     char* pData = NULL;
     char* pStringTable = NULL;
-    char* pCurString = NULL;
 
     m_totalBinarySize =
         sizeof( SElf64Header ) +
@@ -204,8 +211,6 @@ E_RETVAL CElfWriter::ResolveBinary(
             ( ( m_numSections + 1 ) * sizeof( SElf64SectionHeader ) ) + // +1 to account for string table entry
             m_dataSize ;
 
-        pCurString = pStringTable;
-
         // Walk through the section nodes
         while( m_nodeQueue.empty() == false )
         {
@@ -221,7 +226,8 @@ E_RETVAL CElfWriter::ResolveBinary(
                 pCurSectionHeader->Flags = pNode->Flags;
                 pCurSectionHeader->DataSize = pNode->DataSize;
                 pCurSectionHeader->DataOffset = pData - pBinary;
-                pCurSectionHeader->Name = (Elf64_Word)( pCurString - pStringTable );
+                pCurSectionHeader->Name = m_nameOffsetQueue.front();
+                m_nameOffsetQueue.pop();
                 pCurSectionHeader = (SElf64SectionHeader*)(
                     (unsigned char*)pCurSectionHeader + sizeof( SElf64SectionHeader ) );
 
@@ -229,14 +235,6 @@ E_RETVAL CElfWriter::ResolveBinary(
                 memcpy_s( pData, pNode->DataSize, pNode->pData, pNode->DataSize );
                 pData += pNode->DataSize;
 
-                // copy the name into the string table, move the string pointer
-                if ( pNode->Name.size() > 0 )
-                {
-                    memcpy_s( pCurString, pNode->Name.size(), pNode->Name.c_str(), pNode->Name.size() );
-                    pCurString += pNode->Name.size();
-                }
-                *(pCurString++) = '\0';
-
                 // delete the node and it's data
                 if( pNode )
                 {
@@ -251,6 +249,9 @@ E_RETVAL CElfWriter::ResolveBinary(
             }
         }
 
+        // copy the section names
+        memcpy_s( pStringTable, m_stringTableSize, m_stringTable.data(), m_stringTableSize );
+
         // add the string table section header
         SElf64SectionHeader stringSectionHeader = { 0 };
         stringSectionHeader.Type = SH_TYPE_STR_TBL;
@@ -9,6 +9,7 @@ SPDX-License-Identifier: MIT
 #pragma once
 
 #include "CLElfTypes.h"
+#include <map>
 #include <queue>
 #include <string>
 
@@ -89,6 +90,12 @@ protected:
     Elf64_Xword m_flags;
 
     std::queue<SSectionNode*> m_nodeQueue;
+    // string table offset of each queued node's name
+    std::queue<Elf64_Word> m_nameOffsetQueue;
+
+    // section name string table, each distinct name is stored once
+    std::string m_stringTable;
+    std::map<std::string, Elf64_Word> m_stringOffsets;
 
     unsigned int m_dataSize;
     unsigned int m_numSections;
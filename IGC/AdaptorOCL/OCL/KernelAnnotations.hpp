@@ -257,6 +257,8 @@ struct ThreadPayload
     bool  HasGlobalIDOffset = false;
     bool  HasGroupID = false;
     bool  HasLocalID = false;
+    // local ids are computed in the kernel, without any per-thread payload
+    bool  HasInKernelLocalIDs = false;
     bool  HasFlattenedLocalID = false;
     bool  CompiledForIndirectPayloadStorage = false;
     bool  UnusedPerThreadConstantPresent = false;
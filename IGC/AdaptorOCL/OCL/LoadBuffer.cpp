@@ -48,8 +48,11 @@ MemoryBuffer *llvm::LoadBufferFromResource(const char *pResName,
         return NULL;
     }
 
-    // Create a copy of the buffer for the caller. This copy is managed
-    return MemoryBuffer::getMemBufferCopy(StringRef((char *)symbol, size)).release();
+    // The resource lives in the read-only data of the loaded library, so it
+    // is already mapped once and shared by all compilations in the process.
+    // Hand out a non-owning view instead of copying several megabytes of
+    // bitcode on every build; the memory never needs to be freed.
+    return MemoryBuffer::getMemBuffer(StringRef((char *)symbol, size), "", false).release();
 }
 
 #endif
@@ -404,6 +404,29 @@ bool createElfFileName(std::string &name, unsigned int maxNameLen, SIMDMode simd
     return retValue;
 }
 
+CGen8OpenCLProgram::CodeStatistics CGen8OpenCLProgram::GetCodeStatistics() const
+{
+    CodeStatistics stats;
+    for (auto pKernel : m_ShaderProgramList)
+    {
+        for (auto simd : { SIMDMode::SIMD8, SIMDMode::SIMD16, SIMDMode::SIMD32 })
+        {
+            IGC::CShader* shader = pKernel->GetShader(simd);
+            if (!shader || shader->ProgramOutput()->m_programSize == 0)
+                continue;
+            const IGC::SProgramOutput* output = shader->ProgramOutput();
+            stats.NumKernels++;
+            stats.NumSpilledKernels += output->m_scratchSpaceUsedBySpills > 0 ? 1 : 0;
+            stats.SpillSizeBytes += output->m_scratchSpaceUsedBySpills;
+            stats.NumInstructions += output->m_InstructionCount;
+            stats.NumCycles += output->m_NumCycles.value_or(0);
+            stats.NumGRFSpills += output->m_NumGRFSpill.value_or(0);
+            stats.NumGRFFills += output->m_NumGRFFill.value_or(0);
+        }
+    }
+    return stats;
+}
+
 void CGen8OpenCLProgram::GetZEBinary(
     llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
     const char* spv, uint32_t spvSize)
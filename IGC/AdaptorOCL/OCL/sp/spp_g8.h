@@ -91,6 +91,20 @@ public:
     void GetZEBinary(llvm::raw_pwrite_stream& programBinary, unsigned pointerSizeInBytes,
         const char* spv, uint32_t spvSize);
 
+    struct CodeStatistics
+    {
+        uint32_t NumKernels = 0;
+        uint32_t NumSpilledKernels = 0;
+        uint32_t SpillSizeBytes = 0;
+        uint64_t NumInstructions = 0;
+        uint64_t NumCycles = 0;
+        uint64_t NumGRFSpills = 0;
+        uint64_t NumGRFFills = 0;
+    };
+    /// GetCodeStatistics - sum the code quality statistics reported by
+    /// the finalizer over all generated kernels
+    CodeStatistics GetCodeStatistics() const;
+
     // Used to track the kernel info from CodeGen
     std::vector<IGC::CShaderProgram*> m_ShaderProgramList;
 
@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "llvm/ADT/SmallVector.h"
 #include "Probe/Assertion.h"
 #include "llvm/MC/MCELFObjectWriter.h"
+#include "llvm/Support/raw_ostream.h"
 
 using namespace IGC;
 using namespace iOpenCL;
@@ -20,6 +21,36 @@ using namespace zebin;
 using namespace CLElfLib;   // ElfReader related typedefs
 using namespace llvm;
 
+namespace {
+// BinaryStreamWriter - a raw_pwrite_stream appending directly to a
+// Util::BinaryStream, so that the ELF image is not first built in a separate
+// buffer and then copied. Offsets are relative to where the writer started.
+class BinaryStreamWriter : public raw_pwrite_stream {
+public:
+    explicit BinaryStreamWriter(Util::BinaryStream& stream)
+        : m_stream(stream), m_base(stream.Size()) {}
+    ~BinaryStreamWriter() override { flush(); }
+
+private:
+    void write_impl(const char* ptr, size_t size) override
+    {
+        m_stream.Write(ptr, size);
+    }
+
+    void pwrite_impl(const char* ptr, size_t size, uint64_t offset) override
+    {
+        // the patched bytes may still be in our buffer
+        flush();
+        m_stream.WriteAt(ptr, size, m_base + offset);
+    }
+
+    uint64_t current_pos() const override { return m_stream.Size() - m_base; }
+
+    Util::BinaryStream& m_stream;
+    const uint64_t m_base;
+};
+} // namespace
+
 ZEBinaryBuilder::ZEBinaryBuilder(
     const PLATFORM plat, bool is64BitPointer, const IGC::SOpenCLProgramInfo& programInfo,
     const uint8_t* spvData, uint32_t spvSize)
@@ -34,6 +65,10 @@ ZEBinaryBuilder::ZEBinaryBuilder(
     metadata.maxHwRevisionId = plat.usRevId;
     metadata.generatorId = TargetMetadata::GeneratorId::IGC;
     mBuilder.setTargetMetadata(metadata);
+    mBuilder.setCompressNonLoadableSections(
+        IGC_IS_FLAG_ENABLED(ZeBinCompressSections));
+    mBuilder.setShareIdenticalTextSections(
+        IGC_IS_FLAG_ENABLED(ZeBinShareIdenticalKernels));
 
     addProgramScopeInfo(programInfo);
 
@@ -78,6 +113,7 @@ void ZEBinaryBuilder::createKernel(
     addPayloadArgsAndBTI(annotations, zeKernel);
     addMemoryBuffer(annotations, zeKernel);
     addGTPinInfo(annotations);
+    addPerfModelReport(annotations);
 }
 
 void ZEBinaryBuilder::addGTPinInfo(const IGC::SOpenCLKernelInfo& annotations)
@@ -108,6 +144,30 @@ void ZEBinaryBuilder::addGTPinInfo(const IGC::SOpenCLKernelInfo& annotations)
         mBuilder.addSectionGTPinInfo(annotations.m_kernelName, buffer, size);
 }
 
+void ZEBinaryBuilder::addPerfModelReport(const IGC::SOpenCLKernelInfo& annotations)
+{
+    const IGC::SKernelProgram* program = &(annotations.m_kernelProgram);
+    const std::string* report = nullptr;
+    switch (annotations.m_executionEnivronment.CompiledSIMDSize) {
+    case 1:
+        report = &program->simd1.m_perfModelReport;
+        break;
+    case 8:
+        report = &program->simd8.m_perfModelReport;
+        break;
+    case 16:
+        report = &program->simd16.m_perfModelReport;
+        break;
+    case 32:
+        report = &program->simd32.m_perfModelReport;
+        break;
+    }
+
+    if (report != nullptr && !report->empty())
+        mBuilder.addSectionMisc("perf_model." + annotations.m_kernelName,
+            (const uint8_t*)report->data(), report->size());
+}
+
 void ZEBinaryBuilder::addProgramScopeInfo(const IGC::SOpenCLProgramInfo& programInfo)
 {
     addGlobalConstants(programInfo);
@@ -443,6 +503,7 @@ void ZEBinaryBuilder::addKernelExecEnv(const SOpenCLKernelInfo& annotations,
     env.has_device_enqueue = annotations.m_executionEnivronment.HasDeviceEnqueue;
     env.has_fence_for_image_access = annotations.m_executionEnivronment.HasReadWriteImages;
     env.has_global_atomics = annotations.m_executionEnivronment.HasGlobalAtomics;
+    env.has_in_kernel_local_ids = annotations.m_threadPayload.HasInKernelLocalIDs;
     env.offset_to_skip_per_thread_data_load = annotations.m_threadPayload.OffsetToSkipPerThreadDataLoad;;
     env.offset_to_skip_set_ffid_gp = annotations.m_threadPayload.OffsetToSkipSetFFIDGP;;
     env.required_sub_group_size = annotations.m_executionEnivronment.CompiledSubGroupsNumber;
@@ -758,10 +819,8 @@ void ZEBinaryBuilder::getBinaryObject(llvm::raw_pwrite_stream& os)
 
 void ZEBinaryBuilder::getBinaryObject(Util::BinaryStream& outputStream)
 {
-    llvm::SmallVector<char, 64> buf;
-    llvm::raw_svector_ostream llvm_os(buf);
-    getBinaryObject(llvm_os);
-    outputStream.Write(buf.data(), buf.size());
+    BinaryStreamWriter os(outputStream);
+    getBinaryObject(os);
 }
 
 void ZEBinaryBuilder::printBinaryObject(const std::string& filename)
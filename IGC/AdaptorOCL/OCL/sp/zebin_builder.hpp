@@ -154,6 +154,10 @@ private:
     /// into gtpin_info section
     void addGTPinInfo(const IGC::SOpenCLKernelInfo& annotations);
 
+    /// add .misc.perf_model.<kernel> section
+    /// The text report of the vISA static performance model (EnablePerfModelReport)
+    void addPerfModelReport(const IGC::SOpenCLKernelInfo& annotations);
+
     /// ------------ Verifier sub-functions ------------
     bool hasSystemKernel(
         const IGC::OpenCLProgramContext* clContext,
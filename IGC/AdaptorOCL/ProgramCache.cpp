@@ -0,0 +1,267 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "AdaptorOCL/ProgramCache.hpp"
+#include "common/igc_regkeys.hpp"
+#include "common/SysUtils.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MD5.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#include <cstring>
+#include <mutex>
+
+using namespace llvm;
+
+namespace IGC
+{
+namespace ProgramCache
+{
+    // Bump whenever the layout of a cache entry or the key composition changes.
+    static const uint32_t CacheFormatVersion = 1;
+    static const char CacheMagic[4] = { 'I', 'G', 'C', 'P' };
+
+    struct EntryHeader
+    {
+        char     Magic[4];
+        uint32_t Version;
+        uint32_t OutputSize;
+        uint32_t DebugDataSize;
+    };
+
+    // Identifies the IGC binary that produced an entry. The build id is not
+    // always available, so the size and modification time of the library
+    // that contains this code are mixed in as well; any rebuild or update of
+    // IGC then invalidates all existing entries.
+    static std::string GetIGCBuildStamp()
+    {
+        static std::once_flag flag;
+        static std::string stamp;
+        std::call_once(flag, []() {
+            raw_string_ostream os(stamp);
+#ifdef TB_BUILD_ID
+            os << TB_BUILD_ID << ";";
+#endif
+            os << LLVM_VERSION_STRING << ";";
+
+            std::string libPath;
+#if defined(_WIN32)
+            HMODULE hModule = nullptr;
+            char path[MAX_PATH] = {};
+            if (GetModuleHandleExA(
+                    GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                    reinterpret_cast<LPCSTR>(&GetIGCBuildStamp), &hModule) &&
+                GetModuleFileNameA(hModule, path, MAX_PATH) > 0)
+            {
+                libPath = path;
+            }
+#else
+            Dl_info info;
+            if (dladdr(reinterpret_cast<void*>(&GetIGCBuildStamp), &info) && info.dli_fname)
+            {
+                libPath = info.dli_fname;
+            }
+#endif
+            sys::fs::file_status status;
+            if (!libPath.empty() && !sys::fs::status(libPath, status))
+            {
+                os << status.getSize() << ";"
+                   << sys::toTimeT(status.getLastModificationTime());
+            }
+            os.flush();
+        });
+        return stamp;
+    }
+
+    static std::string GetCacheDir()
+    {
+        if (const char* dir = IGC_GET_REGKEYSTRING(ProgramCacheDir))
+        {
+            if (dir[0] != '\0')
+                return dir;
+        }
+        SmallString<256> path;
+        sys::path::system_temp_directory(true, path);
+        sys::path::append(path, "igc_cache");
+        return path.str().str();
+    }
+
+    static std::string GetEntryPath(const std::string& key)
+    {
+        SmallString<256> path(GetCacheDir());
+        sys::path::append(path, key + ".progbin");
+        return path.str().str();
+    }
+
+    bool IsEnabled(const TC::STB_TranslateInputArgs* pInputArgs)
+    {
+        if (IGC_IS_FLAG_DISABLED(EnableProgramCache))
+            return false;
+
+        // Overrides, dumps and instrumentation must see a real compilation.
+        if (IGC_IS_FLAG_ENABLED(ShaderOverride) ||
+            IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+            IGC_IS_FLAG_ENABLED(DumpCompilerStats))
+            return false;
+
+        if (pInputArgs->GTPinInput != nullptr ||
+            pInputArgs->TracingOptionsCount != 0 ||
+            pInputArgs->CompileTimeStatisticsEnable)
+            return false;
+
+        return pInputArgs->pInput != nullptr && pInputArgs->InputSize != 0;
+    }
+
+    std::string ComputeKey(
+        const TC::STB_TranslateInputArgs* pInputArgs,
+        TC::TB_DATA_FORMAT inputDataFormat,
+        const CPlatform& platform)
+    {
+        MD5 hasher;
+        auto addBytes = [&hasher](const void* data, size_t size) {
+            // Prefix every field with its size so that adjacent fields
+            // cannot be shifted into each other.
+            uint64_t sz = size;
+            hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(&sz), sizeof(sz)));
+            if (size != 0)
+                hasher.update(ArrayRef<uint8_t>(reinterpret_cast<const uint8_t*>(data), size));
+        };
+        auto addString = [&addBytes](const std::string& str) {
+            addBytes(str.data(), str.size());
+        };
+
+        addBytes(&CacheFormatVersion, sizeof(CacheFormatVersion));
+        addString(GetIGCBuildStamp());
+
+        uint32_t format = static_cast<uint32_t>(inputDataFormat);
+        addBytes(&format, sizeof(format));
+        addBytes(pInputArgs->pInput, pInputArgs->InputSize);
+        addBytes(pInputArgs->pOptions, pInputArgs->pOptions ? pInputArgs->OptionsSize : 0);
+        addBytes(pInputArgs->pInternalOptions,
+                 pInputArgs->pInternalOptions ? pInputArgs->InternalOptionsSize : 0);
+
+        for (uint32_t i = 0; i < pInputArgs->SpecConstantsSize; ++i)
+        {
+            addBytes(&pInputArgs->pSpecConstantsIds[i], sizeof(uint32_t));
+            addBytes(&pInputArgs->pSpecConstantsValues[i], sizeof(uint64_t));
+        }
+        // Each set of known argument values is a separate variant.
+        addBytes(pInputArgs->pKernelArgValues,
+                 pInputArgs->pKernelArgValues ? pInputArgs->KernelArgValuesSize : 0);
+
+        const PLATFORM& platformInfo = platform.getPlatformInfo();
+        addBytes(&platformInfo, sizeof(platformInfo));
+        const GT_SYSTEM_INFO sysInfo = platform.GetGTSystemInfo();
+        addBytes(&sysInfo, sizeof(sysInfo));
+        addBytes(&platform.getWATable(), sizeof(WA_TABLE));
+        addBytes(&platform.getSkuTable(), sizeof(SKU_FEATURE_TABLE));
+
+        // Regkeys alter code generation, so they are part of the key.
+        std::string keyValues, optionKeys;
+        GetKeysSetExplicitly(&keyValues, &optionKeys);
+        addString(keyValues);
+
+        MD5::MD5Result result;
+        hasher.final(result);
+        return result.digest().str().str();
+    }
+
+    bool Load(const std::string& key, TC::STB_TranslateOutputArgs* pOutputArgs)
+    {
+        ErrorOr<std::unique_ptr<MemoryBuffer>> bufOrErr =
+            MemoryBuffer::getFile(GetEntryPath(key), -1, false);
+        if (!bufOrErr)
+            return false;
+
+        const MemoryBuffer& buf = **bufOrErr;
+        EntryHeader header;
+        if (buf.getBufferSize() < sizeof(header))
+            return false;
+        memcpy(&header, buf.getBufferStart(), sizeof(header));
+
+        if (memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0 ||
+            header.Version != CacheFormatVersion ||
+            header.OutputSize == 0 ||
+            buf.getBufferSize() !=
+                sizeof(header) + (size_t)header.OutputSize + (size_t)header.DebugDataSize)
+            return false;
+
+        const char* data = buf.getBufferStart() + sizeof(header);
+
+        char* binaryOutput = new char[header.OutputSize];
+        memcpy(binaryOutput, data, header.OutputSize);
+        pOutputArgs->pOutput = binaryOutput;
+        pOutputArgs->OutputSize = header.OutputSize;
+
+        if (header.DebugDataSize > 0)
+        {
+            char* debugDataOutput = new char[header.DebugDataSize];
+            memcpy(debugDataOutput, data + header.OutputSize, header.DebugDataSize);
+            pOutputArgs->pDebugData = debugDataOutput;
+            pOutputArgs->DebugDataSize = header.DebugDataSize;
+        }
+        return true;
+    }
+
+    void Store(const std::string& key, const TC::STB_TranslateOutputArgs* pOutputArgs)
+    {
+        if (pOutputArgs->pOutput == nullptr || pOutputArgs->OutputSize == 0)
+            return;
+
+        std::string dir = GetCacheDir();
+        if (!SysUtils::CreateDir(dir))
+            return;
+
+        // Write to a unique temporary file first and rename it into place, so
+        // readers never observe a partially written entry.
+        SmallString<256> tmpModel(dir);
+        sys::path::append(tmpModel, key + "-%%%%%%.tmp");
+        int fd = -1;
+        SmallString<256> tmpPath;
+        if (sys::fs::createUniqueFile(tmpModel, fd, tmpPath))
+            return;
+
+        {
+            raw_fd_ostream os(fd, /*shouldClose=*/true);
+            EntryHeader header;
+            memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+            header.Version = CacheFormatVersion;
+            header.OutputSize = pOutputArgs->OutputSize;
+            header.DebugDataSize = pOutputArgs->pDebugData ? pOutputArgs->DebugDataSize : 0;
+
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            os.write(pOutputArgs->pOutput, header.OutputSize);
+            if (header.DebugDataSize > 0)
+                os.write(pOutputArgs->pDebugData, header.DebugDataSize);
+            os.close();
+            if (os.has_error())
+            {
+                os.clear_error();
+                sys::fs::remove(tmpPath);
+                return;
+            }
+        }
+
+        if (sys::fs::rename(tmpPath, GetEntryPath(key)))
+            sys::fs::remove(tmpPath);
+    }
+}
+}
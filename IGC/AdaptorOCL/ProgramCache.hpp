@@ -0,0 +1,45 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "AdaptorOCL/OCL/TB/igc_tb.h"
+#include "Compiler/CISACodeGen/Platform.hpp"
+
+#include <string>
+
+namespace IGC
+{
+    // Persistent, content-addressed cache of OpenCL program binaries.
+    //
+    // Entries are keyed by a digest of everything that can influence the
+    // output of TC::TranslateBuild: the input bytes and its format, API and
+    // internal options, specialization constants, the target platform,
+    // explicitly set regkeys and the identity of the IGC binary itself.
+    // Each entry lives in its own file named after the key, so concurrent
+    // processes can share a cache directory without extra locking.
+    namespace ProgramCache
+    {
+        // Returns true if the cache is enabled and can be used for this input.
+        bool IsEnabled(const TC::STB_TranslateInputArgs* pInputArgs);
+
+        // Computes the cache key for the given compilation request.
+        std::string ComputeKey(
+            const TC::STB_TranslateInputArgs* pInputArgs,
+            TC::TB_DATA_FORMAT inputDataFormat,
+            const CPlatform& platform);
+
+        // Fills program binary and debug data of pOutputArgs on a hit.
+        // Buffers are allocated with new[] to match TranslateBuild.
+        bool Load(const std::string& key, TC::STB_TranslateOutputArgs* pOutputArgs);
+
+        // Stores program binary and debug data of a successful compilation.
+        // Failures are silently ignored; the cache is only an optimization.
+        void Store(const std::string& key, const TC::STB_TranslateOutputArgs* pOutputArgs);
+    }
+}
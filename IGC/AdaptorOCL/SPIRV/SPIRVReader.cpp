@@ -52,8 +52,11 @@ THE SOFTWARE.
 #include "llvmWrapper/IR/Module.h"
 #include "llvmWrapper/Support/Alignment.h"
 #include "llvmWrapper/Support/TypeSize.h"
+#include "llvmWrapper/Bitcode/BitcodeWriter.h"
 
 #include <llvm/Support/ScaledNumber.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/Analysis/CFG.h>
 #include "libSPIRV/SPIRVDebugInfoExt.h"
@@ -68,11 +71,14 @@ THE SOFTWARE.
 #include "libSPIRV/SPIRVMemAliasingINTEL.h"
 #include "SPIRVInternal.h"
 #include "common/MDFrameWork.h"
+#include "common/igc_regkeys.hpp"
 #include <llvm/Transforms/Scalar.h>
 #include <llvm/IR/MDBuilder.h>
 
 #include <iostream>
 #include <fstream>
+#include <thread>
+#include <unordered_set>
 
 #include "Probe/Assertion.h"
 
@@ -1364,6 +1370,13 @@ public:
   std::string transTypeToOCLTypeName(SPIRVType *BT, bool IsSigned = true);
   std::vector<Type *> transTypeVector(const std::vector<SPIRVType *>&);
   bool translate();
+  /// Translate the bodies of \p Bodies, in this order, with every other
+  /// function only declared and every global variable of
+  /// \p GlobalNames external, and write the module to \p Bitcode for
+  /// translateFunctionsInParallel to link. Returns false if a global value
+  /// does not get the name the linking relies on.
+  bool translateStaging(const std::vector<SPIRVFunction *> &Bodies,
+      const std::vector<std::string> &GlobalNames, std::string &Bitcode);
   bool transAddressingModel();
 
   enum class BoolAction
@@ -1453,6 +1466,13 @@ private:
   GlobalVariable *m_named_barrier_id;
   DICompileUnit* compileUnit = nullptr;
 
+  // Set on the translators of translateFunctionsInParallel, which only
+  // translate the bodies of StagingBodies.
+  bool IsStaging = false;
+  std::unordered_set<SPIRVFunction *> StagingBodies;
+
+  bool translateFunctionsInParallel();
+
   // These storages are used to prevent duplication of alias.scope/noalias
   // metadata
   SPIRVToLLVMMDAliasInstMap MDAliasDomainMap;
@@ -2221,7 +2241,10 @@ SPIRVToLLVM::transValue(SPIRVValue *BV, Function *F, BasicBlock *BB,
   if (!V) {
     return nullptr;
   }
-  V->setName(BV->getName());
+  // A function keeps the name it was created with, see
+  // OpConstFunctionPointerINTEL.
+  if (!isa<Function>(V))
+    V->setName(BV->getName());
   if (!transDecoration(BV, V)) {
     IGC_ASSERT_EXIT_MESSAGE(0, "trans decoration fail");
     return nullptr;
@@ -2894,7 +2917,9 @@ SPIRVToLLVM::transValueWithoutDecoration(SPIRVValue *BV, Function *F,
     SPIRVConstFunctionPointerINTEL* BC =
       static_cast<SPIRVConstFunctionPointerINTEL*>(BV);
     SPIRVFunction* F = BC->getFunction();
-    BV->setName(F->getName());
+    // Staging translators share BM across threads, so they leave it as is.
+    if (!IsStaging)
+      BV->setName(F->getName());
     return mapValue(BV, transFunction(F));
   }
 
@@ -3632,6 +3657,10 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
   auto IsKernel = BM->isEntryPoint(ExecutionModelKernel, BF->getId());
   auto Linkage = IsKernel ? GlobalValue::ExternalLinkage :
       transLinkageType(BF);
+  // Functions are linked by name, translateFunctionsInParallel restores the
+  // linkage.
+  if (IsStaging)
+    Linkage = GlobalValue::ExternalLinkage;
   FunctionType *FT = dyn_cast<FunctionType>(transType(BF->getFunctionType()));
   Function *F = dyn_cast<Function>(mapValue(BF, Function::Create(FT, Linkage,
       BF->getName(), M)));
@@ -3668,6 +3697,9 @@ SPIRVToLLVM::transFunction(SPIRVFunction *BF) {
         SPIRSPIRVFuncParamAttrMap::rmap(Kind));
   });
 
+  if (IsStaging && !StagingBodies.count(BF))
+    return F;
+
   // Creating all basic blocks before creating instructions.
   for (size_t I = 0, E = BF->getNumBasicBlock(); I != E; ++I) {
     transValue(BF->getBasicBlock(I), F, nullptr, true, BoolAction::Noop);
@@ -4008,8 +4040,10 @@ SPIRVToLLVM::translate() {
       transValue(BV, nullptr, nullptr, true, BoolAction::Noop);
   }
 
-  for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
-    transFunction(BM->getFunction(I));
+  if (!translateFunctionsInParallel()) {
+    for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+      transFunction(BM->getFunction(I));
+    }
   }
   for(auto& funcs : FuncMap)
   {
@@ -4035,6 +4069,169 @@ SPIRVToLLVM::translate() {
   return true;
 }
 
+bool
+SPIRVToLLVM::translateStaging(const std::vector<SPIRVFunction *> &Bodies,
+    const std::vector<std::string> &GlobalNames, std::string &Bitcode) {
+  IsStaging = true;
+  StagingBodies.insert(Bodies.begin(), Bodies.end());
+  if (!transAddressingModel())
+    return false;
+
+  for (unsigned I = 0, E = BM->getNumVariables(); I != E; ++I) {
+    auto BV = BM->getVariable(I);
+    if (BV->getStorageClass() != StorageClassFunction)
+      transValue(BV, nullptr, nullptr, true, BoolAction::Noop);
+  }
+  // The global variables are defined in the main module, which translated
+  // them the same way.
+  std::vector<GlobalVariable *> Globals;
+  for (auto &GV : M->globals())
+    Globals.push_back(&GV);
+  if (Globals.size() != GlobalNames.size())
+    return false;
+  for (size_t I = 0, E = Globals.size(); I != E; ++I) {
+    if (Globals[I]->getName() != GlobalNames[I])
+      return false;
+  }
+
+  for (auto BF : Bodies)
+    transFunction(BF);
+  for (auto &KV : FuncMap) {
+    if (KV.second->getName() != KV.first->getName())
+      return false;
+  }
+
+  for (auto GV : Globals) {
+    GV->setInitializer(nullptr);
+    GV->setComdat(nullptr);
+    GV->setLinkage(GlobalValue::ExternalLinkage);
+  }
+
+  raw_string_ostream OS(Bitcode);
+  IGCLLVM::WriteBitcodeToFile(M, OS);
+  OS.flush();
+  return true;
+}
+
+// LLVM IR may only be built on one thread per LLVMContext, so each thread
+// translates a contiguous range of functions into a module of its own,
+// which is serialized and linked into M in range order. Everything the
+// staging modules share is resolved by name, so this falls back to
+// translating on the calling thread if a function or global variable has
+// no name or a duplicated one, and when there is debug info, which is
+// translated for the whole module by one DbgTran.
+bool
+SPIRVToLLVM::translateFunctionsInParallel() {
+  unsigned NumThreads = IGC_GET_FLAG_VALUE(SPIRVParallelTranslationThreads);
+  if (NumThreads < 2 || BM->hasDebugInfo())
+    return false;
+
+  // Functions referenced by global variables are already translated.
+  std::unordered_set<std::string> Names;
+  std::vector<std::string> GlobalNames;
+  for (auto &GV : M->globals()) {
+    if (!GV.hasName())
+      return false;
+    Names.insert(GV.getName().str());
+    GlobalNames.push_back(GV.getName().str());
+  }
+  for (auto &F : *M) {
+    if (!F.hasName())
+      return false;
+    Names.insert(F.getName().str());
+  }
+  std::vector<SPIRVFunction *> Pending;
+  uint64_t TotalInsts = 0;
+  for (unsigned I = 0, E = BM->getNumFunctions(); I != E; ++I) {
+    SPIRVFunction *BF = BM->getFunction(I);
+    if (FuncMap.count(BF))
+      continue;
+    if (BF->getName().empty() || !Names.insert(BF->getName()).second)
+      return false;
+    Pending.push_back(BF);
+    TotalInsts += 1;
+    for (size_t B = 0, BE = BF->getNumBasicBlock(); B != BE; ++B)
+      TotalInsts += BF->getBasicBlock(B)->getNumInst();
+  }
+  if (Pending.size() < IGC_GET_FLAG_VALUE(SPIRVParallelTranslationMinFunctions))
+    return false;
+  NumThreads = std::min<unsigned>(NumThreads, Pending.size());
+
+  // Ranges of about the same number of instructions.
+  std::vector<std::vector<SPIRVFunction *>> Ranges(NumThreads);
+  uint64_t Insts = 0;
+  for (auto BF : Pending) {
+    unsigned R = std::min<uint64_t>(Insts * NumThreads / TotalInsts, NumThreads - 1);
+    Ranges[R].push_back(BF);
+    Insts += 1;
+    for (size_t B = 0, BE = BF->getNumBasicBlock(); B != BE; ++B)
+      Insts += BF->getBasicBlock(B)->getNumInst();
+  }
+
+  struct StagingResult {
+    std::string Bitcode;
+    bool Succeeded = false;
+  };
+  std::vector<StagingResult> Results(NumThreads);
+  BM->setConcurrentTranslation(true);
+  std::vector<std::thread> Workers;
+  for (unsigned T = 0; T < NumThreads; ++T) {
+    Workers.emplace_back([&, T]() {
+      LLVMContext StagingContext;
+      Module StagingModule("", StagingContext);
+      SPIRVToLLVM Staging(&StagingModule, BM);
+      Results[T].Succeeded = Staging.translateStaging(Ranges[T], GlobalNames,
+          Results[T].Bitcode);
+    });
+  }
+  for (auto &W : Workers)
+    W.join();
+  BM->setConcurrentTranslation(false);
+  for (auto &R : Results) {
+    if (!R.Succeeded)
+      return false;
+  }
+
+  // Declarations of the staging modules resolve to definitions of M or of
+  // an earlier staging module, which requires them to be external while
+  // linking.
+  std::vector<std::pair<GlobalValue *, GlobalValue::LinkageTypes>> LocalLinkage;
+  for (auto &GV : M->global_values()) {
+    if (GV.hasLocalLinkage()) {
+      LocalLinkage.push_back({ &GV, GV.getLinkage() });
+      GV.setLinkage(GlobalValue::ExternalLinkage);
+    }
+  }
+  for (auto &R : Results) {
+    auto StagingModule = parseBitcodeFile(
+        MemoryBufferRef(R.Bitcode, "spirv-staging"), *Context);
+    if (Error E = StagingModule.takeError()) {
+      consumeError(std::move(E));
+      IGC_ASSERT_EXIT_MESSAGE(0, "Invalid staging module");
+    }
+    bool Failed = Linker::linkModules(*M, std::move(StagingModule.get()));
+    IGC_ASSERT_EXIT_MESSAGE(!Failed, "Staging module linking failed");
+    R.Bitcode.clear();
+  }
+  for (auto &L : LocalLinkage)
+    L.first->setLinkage(L.second);
+
+  // Functions are ordered as in BM, whatever the number of threads.
+  for (auto BF : Pending) {
+    Function *F = M->getFunction(BF->getName());
+    IGC_ASSERT_EXIT_MESSAGE(F, "Staged function is missing");
+    auto IsKernel = BM->isEntryPoint(ExecutionModelKernel, BF->getId());
+    F->setLinkage(IsKernel ? GlobalValue::ExternalLinkage :
+        transLinkageType(BF));
+    F->removeFromParent();
+    M->getFunctionList().push_back(F);
+    mapValue(BF, mapFunction(BF, F));
+    for (auto &Arg : F->args())
+      mapValue(BF->getArgument(Arg.getArgNo()), &Arg);
+  }
+  return true;
+}
+
 bool
 SPIRVToLLVM::transAddressingModel() {
   switch (BM->getAddressingModel()) {
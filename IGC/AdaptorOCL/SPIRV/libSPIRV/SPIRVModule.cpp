@@ -55,6 +55,8 @@ THE SOFTWARE.
 #include "SPIRVAsm.h"
 #include "Probe/Assertion.h"
 
+#include <mutex>
+
 namespace igc_spv{
 
 SPIRVModule::SPIRVModule()
@@ -158,6 +160,7 @@ public:
     SrcLang = Lang;
     SrcLangVer = Ver;
   }
+  void setConcurrentTranslation(bool Concurrent) override;
   void setModuleProcessed(const std::string& MP) override {
     ModuleProcessed = MP;
   }
@@ -346,6 +349,11 @@ private:
   SPIRVSpecConstantMap *SCMap;
   std::map<unsigned, SPIRVTypeInt*> IntTypeMap;
   std::map<unsigned, SPIRVConstant*> LiteralMap;
+  std::mutex LiteralMutex;
+  bool ConcurrentTranslation = false;
+  // Literals created during concurrent translation, which are not in
+  // IdEntryMap
+  std::vector<SPIRVConstant*> ConcurrentLiterals;
   SPIRVAliasInstMDVec AliasInstMDVec;
   SPIRVAliasInstMDMap AliasInstMDMap;
 
@@ -358,6 +366,9 @@ SPIRVModuleImpl::~SPIRVModuleImpl() {
 
     for (auto I : EntryNoId)
         delete I;
+
+    for (auto I : ConcurrentLiterals)
+        delete I;
 }
 
 SPIRVLine*
@@ -374,16 +385,29 @@ SPIRVModuleImpl::addCapability(SPIRVCapabilityKind Cap) {
 
 SPIRVConstant*
 SPIRVModuleImpl::getLiteralAsConstant(unsigned Literal) {
+  std::lock_guard<std::mutex> Lock(LiteralMutex);
   auto Loc = LiteralMap.find(Literal);
   if (Loc != LiteralMap.end())
     return Loc->second;
   auto Ty = addIntegerType(32);
   auto V = new SPIRVConstant(this, Ty, getId(), static_cast<uint64_t>(Literal));
   LiteralMap[Literal] = V;
-  addConstant(V);
+  if (ConcurrentTranslation)
+    ConcurrentLiterals.push_back(V);
+  else
+    addConstant(V);
   return V;
 }
 
+void
+SPIRVModuleImpl::setConcurrentTranslation(bool Concurrent) {
+  std::lock_guard<std::mutex> Lock(LiteralMutex);
+  // The literal type must exist before, as adding it would modify the id map
+  if (Concurrent)
+    addIntegerType(32);
+  ConcurrentTranslation = Concurrent;
+}
+
 void
 SPIRVModuleImpl::layoutEntry(SPIRVEntry* E) {
   auto OC = E->getOpCode();
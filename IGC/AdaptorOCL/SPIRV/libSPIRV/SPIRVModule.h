@@ -162,6 +162,10 @@ public:
   virtual void setName(SPIRVEntry *, const std::string&) = 0;
   virtual void setSourceLanguage(SpvSourceLanguage, SPIRVWord) = 0;
   virtual void setModuleProcessed(const std::string& MP) = 0;
+  /// While set, function bodies are translated on several threads. The
+  /// literal constants getLiteralAsConstant creates meanwhile are then kept
+  /// out of the id map the other threads are reading.
+  virtual void setConcurrentTranslation(bool Concurrent) = 0;
 
   // Object creation functions
   template<class T> T *add(T *Entry) { addEntry(Entry); return Entry; }
@@ -175,6 +175,8 @@ struct STB_TranslateInputArgs
     const uint32_t* pSpecConstantsIds;    // user-defined spec constants ids
     const uint64_t* pSpecConstantsValues; // spec constants values to be translated
     uint32_t        SpecConstantsSize;    // number of specialization constants
+    const char*     pKernelArgValues;     // known kernel argument values, one "<kernel> <arg> <value>" per line
+    uint32_t        KernelArgValuesSize;  // size of kernel argument values list
 
     STB_TranslateInputArgs()
     {
@@ -191,6 +193,53 @@ struct STB_TranslateInputArgs
         pSpecConstantsIds     = NULL;
         pSpecConstantsValues  = NULL;
         SpecConstantsSize     = 0;
+        pKernelArgValues      = NULL;
+        KernelArgValuesSize   = 0;
+    }
+};
+
+/******************************************************************************\
+
+Structure:
+    STB_TranslateTelemetry
+
+Description:
+    Compile-time telemetry gathered on every translation. Only counters that
+    are already known or cost a clock read per phase are collected, so it is
+    always on.
+
+\******************************************************************************/
+struct STB_TranslateTelemetry
+{
+    uint64_t    TotalTimeUs;        // wall time of the whole translation
+    uint64_t    OptimizeIRTimeUs;   // wall time spent in IR optimization, all tries
+    uint64_t    CodeGenTimeUs;      // wall time spent in code generation, all tries
+    uint64_t    PeakMemoryKB;       // process peak resident set size, 0 if unknown
+    uint32_t    NumRetries;         // number of recompilations done by the retry manager
+    uint32_t    NumKernels;         // number of kernels generated
+    uint32_t    NumSpilledKernels;  // number of kernels that spill
+    uint32_t    SpillSizeBytes;     // per-thread scratch used for spills, summed over kernels
+    uint64_t    NumInstructions;    // gen instructions, summed over kernels
+    uint64_t    NumCycles;          // static cycle estimate, summed over kernels
+    uint64_t    NumGRFSpills;       // GRF spill instructions, summed over kernels
+    uint64_t    NumGRFFills;        // GRF fill instructions, summed over kernels
+    bool        CacheHit;           // output was served from the program cache
+
+    STB_TranslateTelemetry()
+    {
+        TotalTimeUs         = 0;
+        OptimizeIRTimeUs    = 0;
+        CodeGenTimeUs       = 0;
+        PeakMemoryKB        = 0;
+        NumRetries          = 0;
+        NumKernels          = 0;
+        NumSpilledKernels   = 0;
+        SpillSizeBytes      = 0;
+        NumInstructions     = 0;
+        NumCycles           = 0;
+        NumGRFSpills        = 0;
+        NumGRFFills         = 0;
+        CacheHit            = false;
     }
 };
 
@@ -211,6 +260,7 @@ struct STB_TranslateOutputArgs
     uint32_t    ErrorStringSize;    // size of error string
     char*       pDebugData;         // pointer to translated debug data buffer
     uint32_t    DebugDataSize;      // translated debug data data size (bytes)
+    STB_TranslateTelemetry Telemetry; // compile-time telemetry
 
     STB_TranslateOutputArgs()
     {
@@ -83,6 +83,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/OpenCLPasses/TransformUnmaskedFunctionsPass.h"
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStatefull/StatelessToStatefull.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/KernelFunctionCloning.h"
+#include "Compiler/Optimizer/OpenCLPasses/KernelArgSpecialization.h"
 #include "Compiler/Legalizer/TypeLegalizerPass.h"
 #include "Compiler/Optimizer/OpenCLPasses/ClampLoopUnroll/ClampLoopUnroll.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/Image3dToImage2darray/Image3dToImage2darray.hpp"
@@ -97,6 +98,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/InitializePasses.h"
 #include "Compiler/MetaDataApi/SpirMetaDataApi.h"
 #include "Compiler/Optimizer/FixFastMathFlags.hpp"
+#include "Compiler/Optimizer/ShaderProfileInstrumentation.hpp"
 #include "MoveStaticAllocas.h"
 #include "PreprocessSPVIR.h"
 #include "Compiler/Optimizer/IGCInstCombiner/IGCInstructionCombining.hpp"
@@ -274,6 +276,26 @@ static void CommonOCLBasedPasses(
     mpmSPIR.add(new SPIRMetaDataTranslation());
     mpmSPIR.run(*pContext->getModule());
 
+    // The runtime rebuilds kernels without reqd_work_group_size once their
+    // launch size is known. Treat that size as required, so that local size
+    // queries are folded and the SIMD width is picked for it.
+    const uint32_t* SpecializedLocalSize = pContext->m_InternalOptions.SpecializedLocalSize;
+    if (SpecializedLocalSize[0] != 0)
+    {
+        for (auto i = pMdUtils->begin_FunctionsInfo(), e = pMdUtils->end_FunctionsInfo(); i != e; ++i)
+        {
+            if (i->second->getType() != FunctionTypeMD::KernelFunction)
+                continue;
+            ThreadGroupSizeMetaDataHandle TGS = i->second->getThreadGroupSize();
+            if (TGS->hasValue())
+                continue;
+            TGS->setXDim(SpecializedLocalSize[0]);
+            TGS->setYDim(SpecializedLocalSize[1]);
+            TGS->setZDim(SpecializedLocalSize[2]);
+        }
+        pMdUtils->save(*pContext->getLLVMContext());
+    }
+
     bool isOptDisabled = CompilerOpts.OptDisable;
     IGCPassManager mpm(pContext, "Unify");
 
@@ -309,6 +331,11 @@ static void CommonOCLBasedPasses(
     // Clone kernel function being used as user function.
     mpm.add(createKernelFunctionCloningPass());
 
+    if (!pContext->m_KernelArgValues.empty())
+    {
+        mpm.add(createKernelArgSpecializationPass());
+    }
+
     mpm.add(new CorrectlyRoundedDivSqrt(shouldForceCR, false));
     if(IGC_IS_FLAG_ENABLED(EnableIntelFast))
     {
@@ -424,6 +451,16 @@ static void CommonOCLBasedPasses(
 
     mpm.add(CreateFoldKnownWorkGroupSizes());
 
+    // Number blocks, and count their executions if requested, before the
+    // counters' atomics are resolved and the counter buffer is laid out with
+    // the other program scope globals.
+    if (IGC_IS_FLAG_ENABLED(ShaderProfileInstrumentation) ||
+        IGC_IS_FLAG_ENABLED(DumpShaderProfileIds) ||
+        IGC_GET_REGKEYSTRING(ShaderProfileDir)[0] != '\0')
+    {
+        mpm.add(createShaderProfileInstrumentationPass());
+    }
+
     // 64-bit atomics have to be resolved before AddImplicitArgs pass as it uses
     // local ids for spin lock initialization
     mpm.add(new ResolveOCLAtomics());
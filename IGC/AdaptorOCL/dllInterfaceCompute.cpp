@@ -18,6 +18,7 @@ SPDX-License-Identifier: MIT
 #include <stdexcept>
 #include <fstream>
 #include <mutex>
+#include <chrono>
 
 #include "AdaptorCommon/customApi.hpp"
 #include "AdaptorOCL/OCL/LoadBuffer.h"
@@ -26,13 +27,16 @@ SPDX-License-Identifier: MIT
 
 #include "AdaptorOCL/UnifyIROCL.hpp"
 #include "AdaptorOCL/DriverInfoOCL.hpp"
+#include "AdaptorOCL/ProgramCache.hpp"
 
 #include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
 #include "common/debug/Dump.hpp"
+#include "common/debug/DumpWriter.hpp"
 #include "common/debug/Debug.hpp"
 #include "common/igc_regkeys.hpp"
 #include "common/secure_mem.h"
 #include "common/shaderOverride.hpp"
+#include "common/SysUtils.hpp"
 
 #include "CLElfLib/ElfReader.h"
 
@@ -142,7 +146,10 @@ using namespace IGC;
 
 namespace TC
 {
-    static std::mutex llvm_mutex;
+    // LLVM command line options are process-wide state. They are configured
+    // exactly once, before the first compilation, and never mutated afterwards,
+    // so concurrent TranslateBuild calls do not need to synchronize on them.
+    static std::once_flag llvm_options_once;
 
 
 extern bool ProcessElfInput(
@@ -341,13 +348,7 @@ void DumpShaderFile(
             << std::setfill(' ')
             << ext;
 
-        FILE* pFile = NULL;
-        fopen_s(&pFile, fullPath.str().c_str(), "wb");
-        if (pFile)
-        {
-            fwrite(pBuffer, 1, bufferSize, pFile);
-            fclose(pFile);
-        }
+        IGC::Debug::WriteDumpFile(fullPath.str(), std::string(pBuffer, bufferSize), false, true);
 
         if (fileName != nullptr)
         {
@@ -392,6 +393,46 @@ spv_result_t DisassembleSPIRV(const char* pBuffer, UINT bufferSize, spv_text* ou
 #endif // defined(IGC_SPIRV_TOOLS_ENABLED)
 
 #if defined(IGC_SPIRV_ENABLED)
+// Read-only stream buffer over memory owned by the caller. It lets SPIR-V
+// readers that consume a std::istream work on the input directly, instead
+// of on a private copy of a possibly multi-megabyte binary.
+class SPIRVInputStreamBuf : public std::streambuf
+{
+public:
+    explicit SPIRVInputStreamBuf(llvm::StringRef Data)
+    {
+        char* begin = const_cast<char*>(Data.data());
+        setg(begin, begin, begin + Data.size());
+    }
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                     std::ios_base::openmode which = std::ios_base::in) override
+    {
+        if (!(which & std::ios_base::in))
+            return pos_type(off_type(-1));
+
+        off_type base = 0;
+        if (dir == std::ios_base::cur)
+            base = gptr() - eback();
+        else if (dir == std::ios_base::end)
+            base = egptr() - eback();
+
+        off_type pos = base + off;
+        if (pos < 0 || pos > egptr() - eback())
+            return pos_type(off_type(-1));
+
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    pos_type seekpos(pos_type pos,
+                     std::ios_base::openmode which = std::ios_base::in) override
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+};
+
 // Translate SPIR-V binary to LLVM Module
 bool TranslateSPIRVToLLVM(
     const STB_TranslateInputArgs& InputArgs,
@@ -401,7 +442,8 @@ bool TranslateSPIRVToLLVM(
     std::string& stringErrMsg)
 {
     bool success = true;
-    std::istringstream IS(SPIRVBinary.str());
+    SPIRVInputStreamBuf SB(SPIRVBinary);
+    std::istream IS(&SB);
     std::unordered_map<uint32_t, uint64_t> specIDToSpecValueMap = UnpackSpecConstants(
         InputArgs.pSpecConstantsIds,
         InputArgs.pSpecConstantsValues,
@@ -772,42 +814,95 @@ bool ParseInput(
 }
 
 #if defined(IGC_SPIRV_ENABLED)
-bool ReadSpecConstantsFromSPIRV(std::istream &IS, std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo)
+bool ReadSpecConstantsFromSPIRV(llvm::StringRef SPIRVBinary, std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo)
 {
 #if defined(IGC_SCALAR_USE_KHRONOS_SPIRV_TRANSLATOR)
     // Parse SPIRV Module and add all decorated specialization constants to OutSCInfo vector
     // as a pair of <spec-const-id, spec-const-size-in-bytes>. It's crucial for OCL Runtime to
     // properly validate clSetProgramSpecializationConstant API call.
+    SPIRVInputStreamBuf SB(SPIRVBinary);
+    std::istream IS(&SB);
     return llvm::getSpecConstInfo(IS, OutSCInfo);
 #else // IGC Legacy SPIRV Translator
     using namespace igc_spv;
 
-    std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
-    IS >> *BM;
+    // Only SpecId decorations, scalar types and scalar spec constants are
+    // needed, so walk the instruction stream in place instead of decoding the
+    // whole module. Decorations and types always precede the constants.
+    const char* data = SPIRVBinary.data();
+    const size_t numWords = SPIRVBinary.size() / sizeof(SPIRVWord);
+    auto readWord = [data](size_t idx) {
+        SPIRVWord word;
+        memcpy(&word, data + idx * sizeof(SPIRVWord), sizeof(word));
+        return word;
+    };
 
-    auto SPV = BM->parseSpecConstants();
+    const size_t headerWords = 5;
+    if (SPIRVBinary.size() % sizeof(SPIRVWord) != 0 ||
+        numWords < headerWords ||
+        readWord(0) != MagicNumber)
+    {
+        return false;
+    }
+
+    std::unordered_map<SPIRVId, SPIRVWord> specIds;
+    std::unordered_map<SPIRVId, uint32_t> typeSizes;
+    // Ordered by result id, like the module's entry map.
+    std::map<SPIRVId, std::pair<uint32_t, uint32_t>> specConstants;
 
-    for (auto& SC : SPV)
+    for (size_t idx = headerWords; idx < numWords;)
     {
-        SPIRVType *type = SC->getType();
-        uint32_t spec_size = type->isTypeBool() ? 1 : type->getBitWidth() / 8;
+        SPIRVWord first = readWord(idx);
+        SPIRVWord wordCount = first >> WordCountShift;
+        Op opCode = static_cast<Op>(first & OpCodeMask);
+        if (wordCount == 0 || idx + wordCount > numWords)
+        {
+            return false;
+        }
 
-        if (SC->hasDecorate(DecorationSpecId))
+        switch (opCode)
         {
-            SPIRVWord spec_id = *SC->getDecorate(DecorationSpecId).begin();
-            Op OP = SC->getOpCode();
-            if (OP == OpSpecConstant ||
-                OP == OpSpecConstantFalse ||
-                OP == OpSpecConstantTrue)
-            {
-                OutSCInfo.push_back(std::make_pair(spec_id, spec_size));
-            }
-            else
+        case OpDecorate:
+            if (wordCount >= 4 && readWord(idx + 2) == DecorationSpecId)
+                specIds[readWord(idx + 1)] = readWord(idx + 3);
+            break;
+        case OpTypeBool:
+            if (wordCount >= 2)
+                typeSizes[readWord(idx + 1)] = 1;
+            break;
+        case OpTypeInt:
+        case OpTypeFloat:
+            if (wordCount >= 3)
+                typeSizes[readWord(idx + 1)] = readWord(idx + 2) / 8;
+            break;
+        case OpSpecConstant:
+        case OpSpecConstantTrue:
+        case OpSpecConstantFalse:
+            if (wordCount >= 3)
             {
-                IGC_ASSERT_MESSAGE(0, "Wrong instruction opcode, shouldn't be here!");
-                return false;
+                SPIRVId resultId = readWord(idx + 2);
+                auto specId = specIds.find(resultId);
+                auto typeSize = typeSizes.find(readWord(idx + 1));
+                if (specId != specIds.end())
+                {
+                    if (typeSize == typeSizes.end())
+                    {
+                        IGC_ASSERT_MESSAGE(0, "Spec constant of unknown type, shouldn't be here!");
+                        return false;
+                    }
+                    specConstants[resultId] = std::make_pair(specId->second, typeSize->second);
+                }
             }
+            break;
+        default:
+            break;
         }
+        idx += wordCount;
+    }
+
+    for (auto& SC : specConstants)
+    {
+        OutSCInfo.push_back(SC.second);
     }
     return true;
 #endif
@@ -859,10 +954,38 @@ void dumpOCLProgramBinary(OpenCLProgramContext &Ctx, const char *binaryOutput, s
 #endif
 }
 
+// Builtin resources are looked up once per process. The returned buffers are
+// non-owning views over the shared, read-only resource data, so every compile
+// gets its own MemoryBuffer object without copying or re-resolving the bitcode.
+static std::unique_ptr<llvm::MemoryBuffer> GetBuiltinResourceBuffer(int resourceId) {
+    auto load = [](int id) {
+        char Resource[5] = {'-'};
+        _snprintf(Resource, sizeof(Resource), "#%d", id);
+        std::unique_ptr<llvm::MemoryBuffer> pBuffer{llvm::LoadBufferFromResource(Resource, "BC")};
+        return pBuffer ? pBuffer->getBuffer() : llvm::StringRef();
+    };
+
+    static const llvm::StringRef genericBC = load(OCL_BC);
+    static const llvm::StringRef sizeT32BC = load(OCL_BC_32);
+    static const llvm::StringRef sizeT64BC = load(OCL_BC_64);
+
+    llvm::StringRef data;
+    switch (resourceId)
+    {
+    case OCL_BC:    data = genericBC; break;
+    case OCL_BC_32: data = sizeT32BC; break;
+    case OCL_BC_64: data = sizeT64BC; break;
+    default:
+        IGC_ASSERT_MESSAGE(0, "Unknown builtin resource");
+    }
+
+    if (data.empty())
+        return nullptr;
+    return llvm::MemoryBuffer::getMemBuffer(data, "", false);
+}
+
 static std::unique_ptr<llvm::MemoryBuffer> GetGenericModuleBuffer() {
-    char Resource[5] = {'-'};
-    _snprintf(Resource, sizeof(Resource), "#%d", OCL_BC);
-    return std::unique_ptr<llvm::MemoryBuffer>{llvm::LoadBufferFromResource(Resource, "BC")};
+    return GetBuiltinResourceBuffer(OCL_BC);
 }
 
 static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
@@ -876,6 +999,83 @@ static void WriteSpecConstantsDump(const STB_TranslateInputArgs *pInputArgs,
                    hash, "_specconst.txt");
 }
 
+// Sets up the LLVM command line options that IGC relies on. Must only be
+// called through std::call_once, see llvm_options_once.
+static void InitializeLLVMOptions()
+{
+    // Disable code sinking in instruction combining.
+    // This is a workaround for a performance issue caused by code sinking
+    // that is being done in LLVM's instcombine pass.
+    // This code will be removed once sinking is removed from instcombine.
+    auto optionsMap = llvm::cl::getRegisteredOptions();
+    llvm::StringRef instCombineFlag = "-instcombine-code-sinking=0";
+    auto instCombineSinkingSwitch = optionsMap.find(instCombineFlag.trim("-=0"));
+    if (instCombineSinkingSwitch != optionsMap.end()) {
+        if (instCombineSinkingSwitch->getValue()->getNumOccurrences() == 0) {
+            const char* const args[] = { "igc", instCombineFlag.data() };
+            llvm::cl::ParseCommandLineOptions(sizeof(args) / sizeof(args[0]), args);
+        }
+    }
+}
+
+// State of the OCL program right after unification (SPIR-V translation,
+// builtin import and the unify passes). None of it depends on the retry
+// state, so a recompilation can start from here instead of from the input.
+struct UnifiedModuleSnapshot
+{
+    llvm::SmallVector<char, 0> bitcode;
+    SInstrTypes instrTypes = {};
+    bool enableSubroutine = false;
+    bool enableFunctionPointer = false;
+};
+
+static void TakeUnifiedModuleSnapshot(OpenCLProgramContext& ctx, UnifiedModuleSnapshot& snapshot)
+{
+    ctx.getMetaDataUtils()->flush(*ctx.getLLVMContext());
+    serialize(*ctx.getModuleMetaData(), ctx.getModule());
+
+    snapshot.bitcode.clear();
+    llvm::raw_svector_ostream OS(snapshot.bitcode);
+    IGCLLVM::WriteBitcodeToFile(ctx.getModule(), OS);
+
+    snapshot.instrTypes = ctx.m_instrTypes;
+    snapshot.enableSubroutine = ctx.m_enableSubroutine;
+    snapshot.enableFunctionPointer = ctx.m_enableFunctionPointer;
+}
+
+static bool RestoreUnifiedModuleSnapshot(OpenCLProgramContext& ctx, const UnifiedModuleSnapshot& snapshot)
+{
+    llvm::MemoryBufferRef bufferRef(
+        llvm::StringRef(snapshot.bitcode.data(), snapshot.bitcode.size()), "<retry-snapshot>");
+    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+        llvm::parseBitcodeFile(bufferRef, *ctx.getLLVMContext());
+    if (llvm::Error EC = ModuleOrErr.takeError())
+    {
+        llvm::consumeError(std::move(EC));
+        return false;
+    }
+
+    ctx.setModule(ModuleOrErr->release());
+    deserialize(*ctx.getModuleMetaData(), ctx.getModule());
+
+    ctx.m_instrTypes = snapshot.instrTypes;
+    ctx.m_enableSubroutine = snapshot.enableSubroutine;
+    ctx.m_enableFunctionPointer = snapshot.enableFunctionPointer;
+    return true;
+}
+
+static uint64_t ElapsedUs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+// TranslateBuild is reentrant: all per-compilation state lives in the
+// OpenCLProgramContext and its own LLVMContext, and process-wide LLVM options
+// are only written once by InitializeLLVMOptions. Drivers may therefore run
+// any number of TranslateBuild calls in parallel on separate threads, as long
+// as regkeys are loaded (LoadRegistryKeys) before the first compilation and
+// not changed while compilations are in flight.
 bool TranslateBuild(
     const STB_TranslateInputArgs* pInputArgs,
     STB_TranslateOutputArgs* pOutputArgs,
@@ -883,14 +1083,16 @@ bool TranslateBuild(
     const IGC::CPlatform& IGCPlatform,
     float profilingTimerResolution)
 {
-    ShaderHash inputShHash = ShaderHashOCL(reinterpret_cast<const UINT *>(pInputArgs->pInput),
-                                           pInputArgs->InputSize / 4);
+    const auto translateStart = std::chrono::steady_clock::now();
+    STB_TranslateTelemetry& telemetry = pOutputArgs->Telemetry;
 
     // on wrong spec constants, vc::translateBuild may fail
     // so lets dump those early
     if (pInputArgs->SpecConstantsSize > 0 &&
         IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
-      WriteSpecConstantsDump(pInputArgs, inputShHash.getAsmHash());
+      WriteSpecConstantsDump(pInputArgs,
+          ShaderHashOCL(reinterpret_cast<const UINT *>(pInputArgs->pInput),
+                        pInputArgs->InputSize / 4).getAsmHash());
 
 #if defined(IGC_VC_ENABLED)
     if (pInputArgs->pOptions) {
@@ -898,33 +1100,34 @@ bool TranslateBuild(
             vc::translateBuild(pInputArgs, pOutputArgs, inputDataFormatTemp,
                                IGCPlatform, profilingTimerResolution);
         if (!Status)
+        {
+            telemetry.TotalTimeUs = ElapsedUs(translateStart);
             return true;
+        }
         // If vc codegen option was not specified, then vc was not called.
         if (static_cast<vc::errc>(Status.value()) != vc::errc::not_vc_codegen)
             return false;
     }
 #endif // defined(IGC_VC_ENABLED)
 
-    // This part of code is a critical-section for threads,
-    // due static LLVM object which handles options.
-    // Setting mutex to ensure that single thread will enter and setup this flag.
+    // vc hashes its input itself, and only when it dumps or overrides
+    ShaderHash inputShHash = ShaderHashOCL(reinterpret_cast<const UINT *>(pInputArgs->pInput),
+                                           pInputArgs->InputSize / 4);
+
+    std::string programCacheKey;
+    if (ProgramCache::IsEnabled(pInputArgs))
     {
-        const std::lock_guard<std::mutex> lock(llvm_mutex);
-        // Disable code sinking in instruction combining.
-        // This is a workaround for a performance issue caused by code sinking
-        // that is being done in LLVM's instcombine pass.
-        // This code will be removed once sinking is removed from instcombine.
-        auto optionsMap = llvm::cl::getRegisteredOptions();
-        llvm::StringRef instCombineFlag = "-instcombine-code-sinking=0";
-        auto instCombineSinkingSwitch = optionsMap.find(instCombineFlag.trim("-=0"));
-        if (instCombineSinkingSwitch != optionsMap.end()) {
-            if (instCombineSinkingSwitch->getValue()->getNumOccurrences() == 0) {
-                const char* const args[] = { "igc", instCombineFlag.data() };
-                llvm::cl::ParseCommandLineOptions(sizeof(args) / sizeof(args[0]), args);
-            }
+        programCacheKey = ProgramCache::ComputeKey(pInputArgs, inputDataFormatTemp, IGCPlatform);
+        if (ProgramCache::Load(programCacheKey, pOutputArgs))
+        {
+            telemetry.CacheHit = true;
+            telemetry.TotalTimeUs = ElapsedUs(translateStart);
+            return true;
         }
     }
 
+    std::call_once(llvm_options_once, InitializeLLVMOptions);
+
     if (IGC_IS_FLAG_ENABLED(QualityMetricsEnable))
     {
         IGC::Debug::SetDebugFlag(IGC::Debug::DebugFlag::SHADER_QUALITY_METRICS, true);
@@ -934,7 +1137,7 @@ bool TranslateBuild(
 
     // Parse the module we want to compile
     llvm::Module* pKernelModule = nullptr;
-    LLVMContextWrapper* llvmContext = new LLVMContextWrapper;
+    LLVMContextWrapper* llvmContext = LLVMContextWrapper::getPooledContext();
     RegisterComputeErrHandlers(*llvmContext);
 
     if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable))
@@ -1065,124 +1268,134 @@ bool TranslateBuild(
     /// set retry manager
     bool retry = false;
     oclContext.m_retryManager.Enable();
+    std::unique_ptr<UnifiedModuleSnapshot> unifiedSnapshot;
+    bool restoredFromSnapshot = false;
     do
     {
-        std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
-        std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
-        std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
+        if (!restoredFromSnapshot)
         {
-            // IGC has two BIF Modules:
-            //            1. kernel Module (pKernelModule)
-            //            2. BIF Modules:
-            //                 a) generic Module (BuiltinGenericModule)
-            //                 b) size Module (BuiltinSizeModule)
-            //
-            // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
-            // those types, its original names are themselves; the derived names are ones with
-            // '.<digit>' appended to the original names. For example,  clk_event_t is the original
-            // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
-            //
-            // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
-            // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
-            // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
-            // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
-            // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
-            // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
-            // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
-            // used in M0.
-
-            // Load the builtin module -  Generic BC
-            // Load the builtin module -  Generic BC
+            std::unique_ptr<llvm::Module> BuiltinGenericModule = nullptr;
+            std::unique_ptr<llvm::Module> BuiltinSizeModule = nullptr;
+            std::unique_ptr<llvm::MemoryBuffer> pGenericBuffer = nullptr;
+            std::unique_ptr<llvm::MemoryBuffer> pSizeTBuffer = nullptr;
             {
-                COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
+                // IGC has two BIF Modules:
+                //            1. kernel Module (pKernelModule)
+                //            2. BIF Modules:
+                //                 a) generic Module (BuiltinGenericModule)
+                //                 b) size Module (BuiltinSizeModule)
+                //
+                // OCL builtin types, such as clk_event_t/queue_t, etc., are struct (opaque) types. For
+                // those types, its original names are themselves; the derived names are ones with
+                // '.<digit>' appended to the original names. For example,  clk_event_t is the original
+                // name, its derived names are clk_event_t.0, clk_event_t.1, etc.
+                //
+                // When llvm reads in multiple modules, say, M0, M1, under the same llvmcontext, if both
+                // M0 and M1 has the same struct type,  M0 will have the original name and M1 the derived
+                // name for that type.  For example, clk_event_t,  M0 will have clk_event_t, while M1 will
+                // have clk_event_t.2 (number is arbitary). After linking, those two named types should be
+                // mapped to the same type, otherwise, we could have type-mismatch (for example, OCL GAS
+                // builtin_functions tests will assertion fail during inlining due to type-mismatch).  Furthermore,
+                // when linking M1 into M0 (M0 : dstModule, M1 : srcModule), the final type is the type
+                // used in M0.
+
+                // Load the builtin module -  Generic BC
+                // Load the builtin module -  Generic BC
+                {
+                    COMPILER_TIME_START(&oclContext, TIME_OCL_LazyBiFLoading);
 
-                pGenericBuffer = GetGenericModuleBuffer();
+                    pGenericBuffer = GetGenericModuleBuffer();
 
-                if (pGenericBuffer == NULL)
-                {
-                    SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
-                    return false;
-                }
+                    if (pGenericBuffer == NULL)
+                    {
+                        SetErrorMessage("Error loading the Generic builtin resource", *pOutputArgs);
+                        return false;
+                    }
 
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                        getLazyBitcodeModule(pGenericBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
 
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                {
-                    std::string error_str = "Error lazily loading bitcode for generic builtins,"
-                                            "is bitcode the right version and correctly formed?";
-                    SetErrorMessage(error_str, *pOutputArgs);
-                    return false;
-                }
-                else
-                {
-                    BuiltinGenericModule = std::move(*ModuleOrErr);
-                }
+                    if (llvm::Error EC = ModuleOrErr.takeError())
+                    {
+                        std::string error_str = "Error lazily loading bitcode for generic builtins,"
+                                                "is bitcode the right version and correctly formed?";
+                        SetErrorMessage(error_str, *pOutputArgs);
+                        return false;
+                    }
+                    else
+                    {
+                        BuiltinGenericModule = std::move(*ModuleOrErr);
+                    }
 
-                if (BuiltinGenericModule == NULL)
-                {
-                    SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
-                    return false;
+                    if (BuiltinGenericModule == NULL)
+                    {
+                        SetErrorMessage("Error loading the Generic builtin module from buffer", *pOutputArgs);
+                        return false;
+                    }
+                    COMPILER_TIME_END(&oclContext, TIME_OCL_LazyBiFLoading);
                 }
-                COMPILER_TIME_END(&oclContext, TIME_OCL_LazyBiFLoading);
-            }
 
-            // Load the builtin module -  pointer depended
-            {
-                char ResNumber[5] = { '-' };
-                switch (PtrSzInBits)
+                // Load the builtin module -  pointer depended
                 {
-                case 32:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_32);
-                    break;
-                case 64:
-                    _snprintf(ResNumber, sizeof(ResNumber), "#%d", OCL_BC_64);
-                    break;
-                default:
-                    IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
-                }
+                    switch (PtrSzInBits)
+                    {
+                    case 32:
+                        pSizeTBuffer = GetBuiltinResourceBuffer(OCL_BC_32);
+                        break;
+                    case 64:
+                        pSizeTBuffer = GetBuiltinResourceBuffer(OCL_BC_64);
+                        break;
+                    default:
+                        IGC_ASSERT_MESSAGE(0, "Unknown bitness of compiled module");
+                    }
+                    IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
 
-                // the MemoryBuffer becomes owned by the module and does not need to be managed
-                pSizeTBuffer.reset(llvm::LoadBufferFromResource(ResNumber, "BC"));
-                IGC_ASSERT_MESSAGE(pSizeTBuffer, "Error loading builtin resource");
+                    llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
+                        getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
+                    if (llvm::Error EC = ModuleOrErr.takeError())
+                        IGC_ASSERT_MESSAGE(0, "Error lazily loading bitcode for size_t builtins");
+                    else
+                        BuiltinSizeModule = std::move(*ModuleOrErr);
 
-                llvm::Expected<std::unique_ptr<llvm::Module>> ModuleOrErr =
-                    getLazyBitcodeModule(pSizeTBuffer->getMemBufferRef(), *oclContext.getLLVMContext());
-                if (llvm::Error EC = ModuleOrErr.takeError())
-                    IGC_ASSERT_MESSAGE(0, "Error lazily loading bitcode for size_t builtins");
-                else
-                    BuiltinSizeModule = std::move(*ModuleOrErr);
+                    IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
+                }
 
-                IGC_ASSERT_MESSAGE(BuiltinSizeModule, "Error loading builtin module from buffer");
+                BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
+                BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
             }
 
-            BuiltinGenericModule->setDataLayout(BuiltinSizeModule->getDataLayout());
-            BuiltinGenericModule->setTargetTriple(BuiltinSizeModule->getTargetTriple());
-        }
-
-        oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
+            oclContext.getModuleMetaData()->csInfo.forcedSIMDSize |= IGC_GET_FLAG_VALUE(ForceOCLSIMDWidth);
 
-        if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
-        {
-            IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
-        else // not SPIR
-        {
-            IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
-        }
+            if (llvm::StringRef(oclContext.getModule()->getTargetTriple()).startswith("spir"))
+            {
+                IGC::UnifyIRSPIR(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            }
+            else // not SPIR
+            {
+                IGC::UnifyIROCL(&oclContext, std::move(BuiltinGenericModule), std::move(BuiltinSizeModule));
+            }
 
-        if (oclContext.HasError())
-        {
-            if (oclContext.HasWarning())
+            if (oclContext.HasError())
             {
-                SetOutputMessage(oclContext.GetErrorAndWarning(), *pOutputArgs);
+                if (oclContext.HasWarning())
+                {
+                    SetOutputMessage(oclContext.GetErrorAndWarning(), *pOutputArgs);
+                }
+                else
+                {
+                    SetOutputMessage(oclContext.GetError(), *pOutputArgs);
+                }
+                return false;
             }
-            else
+
+            if (IGC_IS_FLAG_ENABLED(EnableRetrySnapshot) &&
+                oclContext.m_retryManager.IsFirstTry() &&
+                !oclContext.m_retryManager.IsLastTry() &&
+                IGC_IS_FLAG_DISABLED(ShaderOverride))
             {
-                SetOutputMessage(oclContext.GetError(), *pOutputArgs);
+                unifiedSnapshot.reset(new UnifiedModuleSnapshot);
+                TakeUnifiedModuleSnapshot(oclContext, *unifiedSnapshot);
             }
-            return false;
         }
 
         // Compiler Options information available after unification.
@@ -1198,16 +1411,21 @@ bool TranslateBuild(
             oclContext.m_retryManager.SetFirstStateId(oclContext.m_retryManager.GetRetryId());
         }
         // Optimize the IR. This happens once for each program, not per-kernel.
+        auto phaseStart = std::chrono::steady_clock::now();
         IGC::OptimizeIR(&oclContext);
+        telemetry.OptimizeIRTimeUs += ElapsedUs(phaseStart);
 
         // Now, perform code generation
+        phaseStart = std::chrono::steady_clock::now();
         IGC::CodeGen(&oclContext);
+        telemetry.CodeGenTimeUs += ElapsedUs(phaseStart);
 
         retry = (!oclContext.m_retryManager.kernelSet.empty() &&
                  oclContext.m_retryManager.AdvanceState());
 
         if (retry)
         {
+            telemetry.NumRetries++;
             oclContext.clear();
 
             // Create a new LLVMContext
@@ -1215,11 +1433,16 @@ bool TranslateBuild(
 
             IGC::Debug::RegisterComputeErrHandlers(*oclContext.getLLVMContext());
 
-            if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+            restoredFromSnapshot =
+                unifiedSnapshot && RestoreUnifiedModuleSnapshot(oclContext, *unifiedSnapshot);
+            if (!restoredFromSnapshot)
             {
-                return false;
+                if (!ParseInput(pKernelModule, pInputArgs, pOutputArgs, *oclContext.getLLVMContext(), inputDataFormatTemp))
+                {
+                    return false;
+                }
+                oclContext.setModule(pKernelModule);
             }
-            oclContext.setModule(pKernelModule);
         }
     } while (retry);
 
@@ -1298,6 +1521,23 @@ bool TranslateBuild(
         pOutputArgs->pDebugData = debugDataOutput;
     }
 
+    const auto codeStats = oclContext.m_programOutput.GetCodeStatistics();
+    telemetry.NumKernels = codeStats.NumKernels;
+    telemetry.NumSpilledKernels = codeStats.NumSpilledKernels;
+    telemetry.SpillSizeBytes = codeStats.SpillSizeBytes;
+    telemetry.NumInstructions = codeStats.NumInstructions;
+    telemetry.NumCycles = codeStats.NumCycles;
+    telemetry.NumGRFSpills = codeStats.NumGRFSpills;
+    telemetry.NumGRFFills = codeStats.NumGRFFills;
+    // a high-water mark shared by all compilations of the process
+    telemetry.PeakMemoryKB = IGC::SysUtils::GetPeakMemoryKB();
+    telemetry.TotalTimeUs = ElapsedUs(translateStart);
+
+    // Programs that produced warnings are not cached, since a hit would
+    // not be able to report them again.
+    if (!programCacheKey.empty() && !oclContext.HasWarning())
+        ProgramCache::Store(programCacheKey, pOutputArgs);
+
     COMPILER_TIME_END(&oclContext, TIME_TOTAL);
 
     COMPILER_TIME_PRINT(&oclContext, ShaderType::OPENCL_SHADER, oclContext.hash);
@@ -110,6 +110,46 @@ protected:
                                                   void *gtPinInput);
 };
 
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(IgcOclTranslationCtx, 4, 3) {
+  using IgcOclTranslationCtx<3>::TranslateImpl;
+  using IgcOclTranslationCtx<3>::Translate;
+  using IgcOclTranslationCtx<3>::GetSpecConstantsInfoImpl;
+
+  CIF_INHERIT_CONSTRUCTOR();
+
+  // kernelArgValues requests a variant of the kernels specialized for known
+  // values of their scalar arguments. It holds one text line per argument:
+  //     <kernel name> <argument index> <value>
+  // where the value is the bit pattern of the argument, zero-extended to 64
+  // bits, in decimal or 0x-prefixed hexadecimal. The kernel signatures are
+  // unchanged, so the runtime must only launch the variant with these values.
+  template <typename OclTranslationOutputInterface = OclTranslationOutputTagOCL>
+  CIF::RAII::UPtr_t<OclTranslationOutputInterface> Translate(CIF::Builtins::BufferSimple *src,
+                                                             CIF::Builtins::BufferSimple *specConstantsIds,
+                                                             CIF::Builtins::BufferSimple *specConstantsValues,
+                                                             CIF::Builtins::BufferSimple *kernelArgValues,
+                                                             CIF::Builtins::BufferSimple *options,
+                                                             CIF::Builtins::BufferSimple *internalOptions,
+                                                             CIF::Builtins::BufferSimple *tracingOptions,
+                                                             uint32_t tracingOptionsCount,
+                                                             void *gtPinInput) {
+      auto p = TranslateImpl(OclTranslationOutputInterface::GetVersion(), src, specConstantsIds, specConstantsValues, kernelArgValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
+      return CIF::RAII::Pack<OclTranslationOutputInterface>(p);
+  }
+
+protected:
+  virtual OclTranslationOutputBase *TranslateImpl(CIF::Version_t outVersion,
+                                                  CIF::Builtins::BufferSimple *src,
+                                                  CIF::Builtins::BufferSimple *specConstantsIds,
+                                                  CIF::Builtins::BufferSimple *specConstantsValues,
+                                                  CIF::Builtins::BufferSimple *kernelArgValues,
+                                                  CIF::Builtins::BufferSimple *options,
+                                                  CIF::Builtins::BufferSimple *internalOptions,
+                                                  CIF::Builtins::BufferSimple *tracingOptions,
+                                                  uint32_t tracingOptionsCount,
+                                                  void *gtPinInput);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(IgcOclTranslationCtx, IGC::OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(IgcOclTranslationCtxLatest, IgcOclTranslationCtx);
 using IgcOclTranslationCtxTagOCL = IgcOclTranslationCtxLatest; // Note : can tag with different version for
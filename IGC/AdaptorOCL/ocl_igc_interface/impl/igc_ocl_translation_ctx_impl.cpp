@@ -20,7 +20,7 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 1)::Tran
                                                  CIF::Builtins::BufferSimple *internalOptions,
                                                  CIF::Builtins::BufferSimple *tracingOptions,
                                                  uint32_t tracingOptionsCount) {
-    return CIF_GET_PIMPL()->Translate(outVersion, src, nullptr, nullptr, options, internalOptions, tracingOptions, tracingOptionsCount, nullptr);
+    return CIF_GET_PIMPL()->Translate(outVersion, src, nullptr, nullptr, options, internalOptions, tracingOptions, tracingOptionsCount, nullptr, nullptr);
 }
 
 OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 2)::TranslateImpl(
@@ -31,7 +31,7 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 2)::Tran
                                                  CIF::Builtins::BufferSimple *tracingOptions,
                                                  uint32_t tracingOptionsCount,
                                                  void *gtPinInput) {
-    return CIF_GET_PIMPL()->Translate(outVersion, src, nullptr, nullptr, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
+    return CIF_GET_PIMPL()->Translate(outVersion, src, nullptr, nullptr, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput, nullptr);
 }
 
 bool CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::GetSpecConstantsInfoImpl(
@@ -51,7 +51,21 @@ OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 3)::Tran
                                                  CIF::Builtins::BufferSimple *tracingOptions,
                                                  uint32_t tracingOptionsCount,
                                                  void *gtPinInput) {
-    return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput);
+    return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput, nullptr);
+}
+
+OclTranslationOutputBase *CIF_GET_INTERFACE_CLASS(IgcOclTranslationCtx, 4)::TranslateImpl(
+                                                 CIF::Version_t outVersion,
+                                                 CIF::Builtins::BufferSimple *src,
+                                                 CIF::Builtins::BufferSimple *specConstantsIds,
+                                                 CIF::Builtins::BufferSimple *specConstantsValues,
+                                                 CIF::Builtins::BufferSimple *kernelArgValues,
+                                                 CIF::Builtins::BufferSimple *options,
+                                                 CIF::Builtins::BufferSimple *internalOptions,
+                                                 CIF::Builtins::BufferSimple *tracingOptions,
+                                                 uint32_t tracingOptionsCount,
+                                                 void *gtPinInput) {
+    return CIF_GET_PIMPL()->Translate(outVersion, src, specConstantsIds, specConstantsValues, options, internalOptions, tracingOptions, tracingOptionsCount, gtPinInput, kernelArgValues);
 }
 
 }
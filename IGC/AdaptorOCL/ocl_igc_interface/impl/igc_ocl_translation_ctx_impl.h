@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include "ocl_igc_interface/impl/igc_ocl_device_ctx_impl.h"
 
 #include <memory>
+#include <sstream>
 
 #include "cif/builtins/memory/buffer/impl/buffer_impl.h"
 #include "cif/helpers/error.h"
@@ -21,6 +22,7 @@ SPDX-License-Identifier: MIT
 
 #include "AdaptorOCL/OCL/TB/igc_tb.h"
 #include "common/debug/Debug.hpp"
+#include "common/LockStats.hpp"
 
 #include "cif/macros/enable.h"
 
@@ -48,7 +50,7 @@ bool TranslateBuild(
   float profilingTimerResolution);
 
 bool ReadSpecConstantsFromSPIRV(
-    std::istream &IS,
+    llvm::StringRef SPIRVBinary,
     std::vector<std::pair<uint32_t, uint32_t>> &OutSCInfo);
 
 }
@@ -124,11 +126,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
 
         if(this->inType == CodeType::spirV){
             llvm::StringRef strInput = llvm::StringRef(pInput, inputSize);
-            std::istringstream IS(strInput.str());
 
             // vector of pairs [spec_id, spec_size]
             std::vector<std::pair<uint32_t, uint32_t>> SCInfo;
-            success = TC::ReadSpecConstantsFromSPIRV(IS, SCInfo);
+            success = TC::ReadSpecConstantsFromSPIRV(strInput, SCInfo);
 
             outSpecConstantsIds->Resize(sizeof(uint32_t) * SCInfo.size());
             outSpecConstantsSizes->Resize(sizeof(uint32_t) * SCInfo.size());
@@ -156,7 +157,8 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
                                         CIF::Builtins::BufferSimple *internalOptions,
                                         CIF::Builtins::BufferSimple *tracingOptions,
                                         uint32_t tracingOptionsCount,
-                                        void *gtPinInput) const{
+                                        void *gtPinInput,
+                                        CIF::Builtins::BufferSimple *kernelArgValues) const{
         // Create interface for return data
         auto outputInterface = CIF::RAII::UPtr(CIF::InterfaceCreator<OclTranslationOutput>::CreateInterfaceVer(outVersion, this->outType));
         if(outputInterface == nullptr){
@@ -198,6 +200,10 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
             inputArgs.SpecConstantsSize = static_cast<uint32_t>(specConstantsIds->GetSizeRaw() / sizeof(uint32_t));
             inputArgs.pSpecConstantsValues = specConstantsValues->GetMemory<uint64_t>();
         }
+        if(kernelArgValues != nullptr){
+            inputArgs.pKernelArgValues = kernelArgValues->GetMemory<char>();
+            inputArgs.KernelArgValuesSize = static_cast<uint32_t>(kernelArgValues->GetSizeRaw());
+        }
         inputArgs.GTPinInput = gtPinInput;
 
         CIF::Sanity::NotNullOrAbort(this->globalState.GetPlatformImpl());
@@ -301,6 +307,7 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
         if(success){
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->AddWarning(output.pErrorString, output.ErrorStringSize);
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->CloneDebugData(output.pDebugData, output.DebugDataSize);
+            dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetTelemetry(FormatTelemetry(output.Telemetry));
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetSuccessfulAndCloneOutput(output.pOutput, output.OutputSize);
         }else{
             dataCopiedSuccessfuly &= outputInterface->GetImpl()->SetError(TranslationErrorType::FailedCompilation, output.pErrorString);
@@ -314,6 +321,33 @@ CIF_DECLARE_INTERFACE_PIMPL(IgcOclTranslationCtx) : CIF::PimplBase
     }
 
 protected:
+    static std::string FormatTelemetry(const TC::STB_TranslateTelemetry & telemetry)
+    {
+        std::ostringstream os;
+        os << "total_us=" << telemetry.TotalTimeUs << "\n"
+           << "optimize_ir_us=" << telemetry.OptimizeIRTimeUs << "\n"
+           << "codegen_us=" << telemetry.CodeGenTimeUs << "\n"
+           << "peak_memory_kb=" << telemetry.PeakMemoryKB << "\n"
+           << "retries=" << telemetry.NumRetries << "\n"
+           << "kernels=" << telemetry.NumKernels << "\n"
+           << "spilled_kernels=" << telemetry.NumSpilledKernels << "\n"
+           << "spill_size_bytes=" << telemetry.SpillSizeBytes << "\n"
+           << "instructions=" << telemetry.NumInstructions << "\n"
+           << "cycles=" << telemetry.NumCycles << "\n"
+           << "grf_spills=" << telemetry.NumGRFSpills << "\n"
+           << "grf_fills=" << telemetry.NumGRFFills << "\n"
+           << "cache_hit=" << (telemetry.CacheHit ? 1 : 0) << "\n";
+        // Global lock counters are process-wide totals; compare two
+        // translations to get the contention in between.
+        for (const auto& lockStat : IGC::GetLockStats())
+        {
+            os << "lock." << lockStat.name << ".acquisitions=" << lockStat.acquisitions << "\n"
+               << "lock." << lockStat.name << ".contentions=" << lockStat.contentions << "\n"
+               << "lock." << lockStat.name << ".wait_us=" << lockStat.waitNs / 1000 << "\n";
+        }
+        return os.str();
+    }
+
     CIF_PIMPL(IgcOclDeviceCtx) &globalState;
     CodeType::CodeType_t inType;
     CodeType::CodeType_t outType;
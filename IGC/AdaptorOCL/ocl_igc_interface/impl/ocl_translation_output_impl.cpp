@@ -37,6 +37,10 @@ CodeType::CodeType_t CIF_GET_INTERFACE_CLASS(OclTranslationOutput, 1)::GetOutput
   return CIF_GET_PIMPL()->GetOutputType();
 }
 
+CIF::Builtins::BufferBase *CIF_GET_INTERFACE_CLASS(OclTranslationOutput, 2)::GetTelemetryImpl(CIF::Version_t bufferVersion){
+    return CIF_GET_PIMPL()->GetTelemetry(bufferVersion);
+}
+
 }
 
 #include "cif/macros/disable.h"
@@ -40,6 +40,7 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         BuildLog.CreateImpl();
         Output.CreateImpl();
         DebugData.CreateImpl();
+        Telemetry.CreateImpl();
     }
 
     bool Successful() const
@@ -67,6 +68,11 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         return DebugData.GetVersion(bufferVersion);
     }
 
+    CIF::Builtins::BufferBase * GetTelemetry(CIF::Version_t bufferVersion)
+    {
+        return Telemetry.GetVersion(bufferVersion);
+    }
+
     CodeType::CodeType_t GetOutputType() const
     {
         return OutputType;
@@ -128,10 +134,16 @@ CIF_DECLARE_INTERFACE_PIMPL(OclTranslationOutput) : CIF::PimplBase
         return DebugData->PushBackRawBytes(data, size);
     }
 
+    bool SetTelemetry(const std::string & telemetry)
+    {
+        return Telemetry->PushBackRawBytes(telemetry.c_str(), telemetry.size() + 1);
+    }
+
 protected:
     CIF::Multiversion<CIF::Builtins::Buffer> BuildLog;
     CIF::Multiversion<CIF::Builtins::Buffer> Output;
     CIF::Multiversion<CIF::Builtins::Buffer> DebugData;
+    CIF::Multiversion<CIF::Builtins::Buffer> Telemetry;
     CodeType::CodeType_t OutputType;
     TranslationErrorType::ErrorCode_t  Error;
 };
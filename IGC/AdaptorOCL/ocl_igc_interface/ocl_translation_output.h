@@ -51,6 +51,28 @@ protected:
   virtual CIF::Builtins::BufferBase *GetDebugDataImpl(CIF::Version_t bufferVersion);
 };
 
+CIF_DEFINE_INTERFACE_VER_WITH_COMPATIBILITY(OclTranslationOutput, 2, 1) {
+  CIF_INHERIT_CONSTRUCTOR();
+
+  using OclTranslationOutput<1>::Successful;
+  using OclTranslationOutput<1>::HasWarnings;
+  using OclTranslationOutput<1>::GetOutputType;
+  using OclTranslationOutput<1>::GetBuildLog;
+  using OclTranslationOutput<1>::GetOutput;
+  using OclTranslationOutput<1>::GetDebugData;
+
+  // Compile-time telemetry of this translation, as "name=value" lines
+  // (e.g. "codegen_us=1234"). Always collected; unknown names should be
+  // ignored, since new entries may be added. Empty if the translation
+  // did not report any.
+  template <typename BufferInterface = CIF::Builtins::BufferLatest>
+  BufferInterface *GetTelemetry() {
+    return static_cast<BufferInterface*>(GetTelemetryImpl(BufferInterface::GetVersion()));
+  }
+protected:
+  virtual CIF::Builtins::BufferBase *GetTelemetryImpl(CIF::Version_t bufferVersion);
+};
+
 CIF_GENERATE_VERSIONS_LIST_AND_DECLARE_INTERFACE_DEPENDENCIES(OclTranslationOutput, CIF::Builtins::Buffer);
 CIF_MARK_LATEST_VERSION(OclTranslationOutputLatest, OclTranslationOutput);
 using OclTranslationOutputTagOCL = OclTranslationOutputLatest; // Note : can tag with different version for
@@ -2171,39 +2171,63 @@ DEFN_ARITH_OPERATIONS(double)
 DEFN_ARITH_OPERATIONS(half)
 #endif // defined(cl_khr_fp16)
 
-#define DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op)                                                  \
-type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)                                             \
-{                                                                                                          \
-    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, X);     \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                             \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                          \
-    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                             \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                         \
-                                                                                                           \
-    if (sg_lid == sg_size - 1) {                                                                           \
-        scratch[sg_id] = sg_x;                                                                             \
-    }                                                                                                      \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-                                                                                                           \
-    type sg_aggregate = scratch[0];                                                                        \
-    for (int s = 1; s < num_sg; ++s) {                                                                     \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                       \
-    }                                                                                                      \
-                                                                                                           \
-    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);         \
-    return sg_aggregate;                                                                                   \
-}
-
-
-#define DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op)                                                    \
+// Work-group reductions and scans first combine values within each subgroup,
+// then exchange one partial result per subgroup through SLM. The number of
+// subgroups folds to a constant when the work-group size is known
+// (reqd_work_group_size / FoldKnownWorkGroupSizes) so that:
+//  - a work-group made of a single subgroup needs neither SLM nor barriers,
+//  - when every subgroup has at least one lane per subgroup of the work-group,
+//    the partials are combined with one more subgroup reduction instead of a
+//    serial loop over SLM.
+// The trailing barrier keeps a following collective from overwriting the
+// partials before all subgroups have read them.
+#define DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op, identity)                                             \
+type __builtin_IB_WorkGroupReduce_##func##_##type_abbr(type X)                                                  \
+{                                                                                                               \
+    type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, X);          \
+    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
+    if (num_sg == 1) {                                                                                          \
+        return sg_x;                                                                                            \
+    }                                                                                                           \
+                                                                                                                \
+    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
+    uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
+                                                                                                                \
+    if (sg_lid == 0) {                                                                                          \
+        scratch[sg_id] = sg_x;                                                                                  \
+    }                                                                                                           \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
+                                                                                                                \
+    type sg_aggregate;                                                                                          \
+    if (num_sg <= sg_size) {                                                                                    \
+        type partial = sg_lid < num_sg ? scratch[sg_lid] : (type)identity;                                      \
+        sg_aggregate =                                                                                          \
+            SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, partial);        \
+    } else {                                                                                                    \
+        sg_aggregate = scratch[0];                                                                              \
+        for (int s = 1; s < num_sg; ++s) {                                                                      \
+            sg_aggregate = op(sg_aggregate, scratch[s]);                                                        \
+        }                                                                                                       \
+    }                                                                                                           \
+                                                                                                                \
+    SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
+    return sg_aggregate;                                                                                        \
+}
+
+
+#define DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                          \
 type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)                                           \
 {                                                                                                               \
     type sg_x = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);   \
+    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
+    if (num_sg == 1) {                                                                                          \
+        return sg_x;                                                                                            \
+    }                                                                                                           \
                                                                                                                 \
     GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
     uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
-    uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
     uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
     uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
                                                                                                                 \
@@ -2213,13 +2237,18 @@ type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)
     SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
                                                                                                                 \
     type sg_prefix;                                                                                             \
-    type sg_aggregate = scratch[0];                                                                             \
-    for (int s = 1; s < num_sg; ++s) {                                                                          \
-        if (sg_id == s) {                                                                                       \
-            sg_prefix = sg_aggregate;                                                                           \
-            break;                                                                                              \
+    if (num_sg <= sg_size) {                                                                                    \
+        type partial = sg_lid < sg_id ? scratch[sg_lid] : (type)identity;                                       \
+        sg_prefix = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, partial);\
+    } else {                                                                                                    \
+        type sg_aggregate = scratch[0];                                                                         \
+        for (int s = 1; s < num_sg; ++s) {                                                                      \
+            if (sg_id == s) {                                                                                   \
+                sg_prefix = sg_aggregate;                                                                       \
+                break;                                                                                          \
+            }                                                                                                   \
+            sg_aggregate = op(sg_aggregate, scratch[s]);                                                        \
         }                                                                                                       \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                            \
     }                                                                                                           \
                                                                                                                 \
     type result;                                                                                                \
@@ -2237,31 +2266,39 @@ type __builtin_IB_WorkGroupScanInclusive_##func##_##type_abbr(type X)
 type __builtin_IB_WorkGroupScanExclusive_##func##_##type_abbr(type X)                                           \
 {                                                                                                               \
     type carry = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationInclusiveScan, X);  \
-                                                                                                                \
-    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
-    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
     uint num_sg = SPIRV_BUILTIN_NO_OP(BuiltInNumSubgroups, , )();                                               \
     uint sg_lid = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupLocalInvocationId, , )();                                  \
-    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
                                                                                                                 \
     type sg_x = intel_sub_group_shuffle_up((type)identity, carry, 1);                                           \
     if (sg_lid == 0) {                                                                                          \
         sg_x = identity;                                                                                        \
+    }                                                                                                           \
+    if (num_sg == 1) {                                                                                          \
+        return sg_x;                                                                                            \
     }                                                                                                           \
                                                                                                                 \
+    GET_MEMPOOL_PTR(scratch, type, true, 0)                                                                     \
+    uint sg_id = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupId, , )();                                                  \
+    uint sg_size = SPIRV_BUILTIN_NO_OP(BuiltInSubgroupSize, , )();                                              \
+                                                                                                                \
     if (sg_lid == sg_size - 1) {                                                                                \
         scratch[sg_id] = carry;                                                                                 \
     }                                                                                                           \
     SPIRV_BUILTIN(ControlBarrier, _i32_i32_i32, )(Workgroup, 0, AcquireRelease | WorkgroupMemory);              \
                                                                                                                 \
     type sg_prefix;                                                                                             \
-    type sg_aggregate = scratch[0];                                                                             \
-    for (int s = 1; s < num_sg; ++s) {                                                                          \
-        if (sg_id == s) {                                                                                       \
-          sg_prefix = sg_aggregate;                                                                             \
-          break;                                                                                                \
+    if (num_sg <= sg_size) {                                                                                    \
+        type partial = sg_lid < sg_id ? scratch[sg_lid] : (type)identity;                                       \
+        sg_prefix = SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(Subgroup, GroupOperationReduce, partial);\
+    } else {                                                                                                    \
+        type sg_aggregate = scratch[0];                                                                         \
+        for (int s = 1; s < num_sg; ++s) {                                                                      \
+            if (sg_id == s) {                                                                                   \
+                sg_prefix = sg_aggregate;                                                                       \
+                break;                                                                                          \
+            }                                                                                                   \
+            sg_aggregate = op(sg_aggregate, scratch[s]);                                                        \
         }                                                                                                       \
-        sg_aggregate = op(sg_aggregate, scratch[s]);                                                            \
     }                                                                                                           \
                                                                                                                 \
     type result;                                                                                                \
@@ -2395,8 +2432,8 @@ DEFN_SUB_GROUP_REDUCE(func, type_abbr, type, op, identity, signed_cast)
 DEFN_SUB_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                     \
 DEFN_SUB_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                     \
                                                                                                   \
-DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op)                                                 \
-DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op)                                              \
+DEFN_WORK_GROUP_REDUCE(func, type_abbr, type, op, identity)                                       \
+DEFN_WORK_GROUP_SCAN_INCL(func, type_abbr, type, op, identity)                                    \
 DEFN_WORK_GROUP_SCAN_EXCL(func, type_abbr, type, op, identity)                                    \
                                                                                                   \
 type  SPIRV_OVERLOADABLE SPIRV_BUILTIN(Group##func, _i32_i32_##type_abbr, )(int Execution, int Operation, type X) \
@@ -0,0 +1,202 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/CISACodeGen/AtomicAggregation.hpp"
+#include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CodeGenPublicEnums.h"
+#include "Compiler/IGCPassSupport.h"
+#include "common/igc_regkeys.hpp"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+
+namespace {
+
+    class AtomicAggregation : public FunctionPass
+    {
+    public:
+        static char ID;
+
+        AtomicAggregation() : FunctionPass(ID)
+        {
+            initializeAtomicAggregationPass(*PassRegistry::getPassRegistry());
+        }
+
+        StringRef getPassName() const override
+        {
+            return "AtomicAggregation";
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.addRequired<WIAnalysis>();
+            AU.addRequired<CodeGenContextWrapper>();
+        }
+
+        bool runOnFunction(Function& F) override;
+
+    private:
+        bool isCandidate(GenIntrinsicInst* atomic) const;
+        void aggregate(GenIntrinsicInst* atomic, unsigned maxIterations);
+
+        WIAnalysis* m_WIAnalysis = nullptr;
+    };
+
+} // namespace
+
+char AtomicAggregation::ID = 0;
+
+#define PASS_FLAG     "igc-atomic-aggregation"
+#define PASS_DESC     "Aggregate the lanes of atomics hitting the same address"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(AtomicAggregation, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(AtomicAggregation, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+FunctionPass* IGC::createAtomicAggregationPass()
+{
+    return new AtomicAggregation();
+}
+
+// Same atomics as EmitPass::IsUniformAtomic accepts, so that the copy with
+// the broadcast address is emitted by emitScalarAtomics.
+bool AtomicAggregation::isCandidate(GenIntrinsicInst* atomic) const
+{
+    GenISAIntrinsic::ID id = atomic->getIntrinsicID();
+    if (id != GenISAIntrinsic::GenISA_intatomicraw &&
+        id != GenISAIntrinsic::GenISA_intatomicrawA64)
+        return false;
+    if (atomic->getType()->getScalarSizeInBits() == 64)
+        return false;
+
+    auto* opValue = dyn_cast<ConstantInt>(atomic->getOperand(3));
+    if (!opValue)
+        return false;
+    AtomicOp atomicOp = static_cast<AtomicOp>(opValue->getZExtValue());
+    bool isAddAtomic = atomicOp == EATOMIC_IADD ||
+        atomicOp == EATOMIC_INC ||
+        atomicOp == EATOMIC_SUB;
+    bool isMinMaxAtomic = atomicOp == EATOMIC_UMAX ||
+        atomicOp == EATOMIC_UMIN ||
+        atomicOp == EATOMIC_IMIN ||
+        atomicOp == EATOMIC_IMAX;
+    if (!isAddAtomic && !(isMinMaxAtomic && atomic->use_empty()))
+        return false;
+
+    return !m_WIAnalysis->isUniform(atomic->getOperand(1));
+}
+
+//   entry:
+//     br loop
+//   loop:
+//     iter = phi [0, entry], [iter + 1, latch]
+//     br (iter < max), match, fallback
+//   match:
+//     leader = WaveShuffleIndex(addr, WaveAll(laneId, UMIN))
+//     br (addr == leader), aggregated, latch
+//   latch:
+//     br loop
+//   aggregated:
+//     atomic(leader, src)  ; uniform address
+//     br exit
+//   fallback:
+//     atomic(addr, src)
+//     br exit
+void AtomicAggregation::aggregate(GenIntrinsicInst* atomic, unsigned maxIterations)
+{
+    Function* F = atomic->getParent()->getParent();
+    Module* M = F->getParent();
+    LLVMContext& C = M->getContext();
+    const DataLayout& DL = M->getDataLayout();
+
+    BasicBlock* entryBB = atomic->getParent();
+    BasicBlock* exitBB = entryBB->splitBasicBlock(atomic, "atomic.aggr.exit");
+    BasicBlock* loopBB = BasicBlock::Create(C, "atomic.aggr.loop", F, exitBB);
+    BasicBlock* matchBB = BasicBlock::Create(C, "atomic.aggr.match", F, exitBB);
+    BasicBlock* latchBB = BasicBlock::Create(C, "atomic.aggr.latch", F, exitBB);
+    BasicBlock* aggregatedBB = BasicBlock::Create(C, "atomic.aggr.aggregated", F, exitBB);
+    BasicBlock* fallbackBB = BasicBlock::Create(C, "atomic.aggr.fallback", F, exitBB);
+    entryBB->getTerminator()->setSuccessor(0, loopBB);
+
+    IRBuilder<> IRB(loopBB);
+    IRB.SetCurrentDebugLocation(atomic->getDebugLoc());
+    PHINode* iter = IRB.CreatePHI(IRB.getInt32Ty(), 2, "atomic.aggr.iter");
+    iter->addIncoming(IRB.getInt32(0), entryBB);
+    IRB.CreateCondBr(IRB.CreateICmpULT(iter, IRB.getInt32(maxIterations)), matchBB, fallbackBB);
+
+    IRB.SetInsertPoint(matchBB);
+    Value* addr = atomic->getOperand(1);
+    Type* addrTy = addr->getType();
+    Value* addrInt = addrTy->isPointerTy() ? IRB.CreatePtrToInt(addr, DL.getIntPtrType(addrTy)) : addr;
+    Function* laneIdFunc = GenISAIntrinsic::getDeclaration(M, GenISAIntrinsic::GenISA_simdLaneId);
+    Value* laneId = IRB.CreateZExt(IRB.CreateCall(laneIdFunc), IRB.getInt32Ty());
+    Function* waveAllFunc = GenISAIntrinsic::getDeclaration(M,
+        GenISAIntrinsic::GenISA_WaveAll, IRB.getInt32Ty());
+    Value* leaderLane = IRB.CreateCall(waveAllFunc, { laneId, IRB.getInt8((uint8_t)WaveOps::UMIN) });
+    Function* shuffleFunc = GenISAIntrinsic::getDeclaration(M,
+        GenISAIntrinsic::GenISA_WaveShuffleIndex, addrInt->getType());
+    Value* leaderAddrInt = IRB.CreateCall(shuffleFunc, { addrInt, leaderLane, IRB.getInt32(0) });
+    IRB.CreateCondBr(IRB.CreateICmpEQ(addrInt, leaderAddrInt), aggregatedBB, latchBB);
+
+    IRB.SetInsertPoint(latchBB);
+    iter->addIncoming(IRB.CreateAdd(iter, IRB.getInt32(1)), latchBB);
+    IRB.CreateBr(loopBB);
+
+    IRB.SetInsertPoint(aggregatedBB);
+    Value* leaderAddr = addrTy->isPointerTy() ? IRB.CreateIntToPtr(leaderAddrInt, addrTy) : leaderAddrInt;
+    Instruction* aggregated = atomic->clone();
+    aggregated->setOperand(1, leaderAddr);
+    IRB.Insert(aggregated);
+    IRB.CreateBr(exitBB);
+
+    IRB.SetInsertPoint(fallbackBB);
+    atomic->moveBefore(IRB.CreateBr(exitBB));
+
+    if (!atomic->use_empty())
+    {
+        PHINode* result = PHINode::Create(atomic->getType(), 2, "atomic.aggr.result", &exitBB->front());
+        atomic->replaceAllUsesWith(result);
+        result->addIncoming(aggregated, aggregatedBB);
+        result->addIncoming(atomic, fallbackBB);
+    }
+}
+
+bool AtomicAggregation::runOnFunction(Function& F)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    unsigned maxIterations = IGC_GET_FLAG_VALUE(AtomicAggregationMaxIterations);
+    if (maxIterations == 0 ||
+        F.hasFnAttribute("KMPLOCK") ||
+        ctx->m_DriverInfo.WASLMPointersDwordUnit())
+        return false;
+
+    m_WIAnalysis = &getAnalysis<WIAnalysis>();
+    SmallVector<GenIntrinsicInst*, 8> candidates;
+    for (auto& I : instructions(F))
+    {
+        auto* GII = dyn_cast<GenIntrinsicInst>(&I);
+        if (GII && isCandidate(GII))
+            candidates.push_back(GII);
+    }
+
+    for (auto* atomic : candidates)
+        aggregate(atomic, maxIterations);
+    return !candidates.empty();
+}
@@ -0,0 +1,31 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    /// @brief Aggregate the lanes of an atomic that hit the same address
+    /// (EnableAtomicAggregation regkey).
+    ///
+    /// EmitPass already issues a single SIMD1 atomic when the address of an
+    /// add, sub, inc or unused min/max atomic is uniform (emitScalarAtomics).
+    /// For such atomics with a non-uniform address, this pass adds a loop
+    /// around the atomic: on each iteration the address of the first active
+    /// lane is broadcast and every lane with the same address leaves the loop
+    /// through a copy of the atomic that uses the broadcast address, which
+    /// EmitPass then emits as one scalar atomic with the subgroup reduction of
+    /// the sources. After AtomicAggregationMaxIterations iterations the
+    /// remaining lanes issue the original per-lane atomic, which bounds the
+    /// cost when addresses are mostly distinct.
+    llvm::FunctionPass* createAtomicAggregationPass();
+} // namespace IGC
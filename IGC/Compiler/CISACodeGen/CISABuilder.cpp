@@ -439,7 +439,7 @@ namespace IGC
         V(vKernel->AppendVISACFFunctionRetInst(predOpnd, emask, execSize));
     }
 
-    void CEncoder::Jump(CVariable* flag, uint label)
+    void CEncoder::Jump(CVariable* flag, uint label, int fallThroughPercent)
     {
         VISA_LabelOpnd* visaLabel = GetLabel(label);
         m_encoderState.m_flag.var = flag;
@@ -463,6 +463,10 @@ namespace IGC
             execSize = EXEC_SIZE_1;
         }
         V(vKernel->AppendVISACFGotoInst(predOpnd, emask, execSize, visaLabel));
+        if (flag != nullptr)
+        {
+            V(vKernel->SetLastGotoBranchInfo(flag->IsUniform(), fallThroughPercent));
+        }
     }
 
     void CEncoder::Label(uint label)
@@ -3757,6 +3761,16 @@ namespace IGC
             }
         }
 
+        // Trade code quality for compile time once most of the compile time
+        // budget is spent: no preRA scheduling, linear scan RA and quick SWSB
+        // token allocation.
+        bool CompileTimeBudgetLow = false;
+        if (context->type == ShaderType::OPENCL_SHADER)
+        {
+            auto ClContext = static_cast<OpenCLProgramContext*>(context);
+            CompileTimeBudgetLow = ClContext->isCompileTimeBudgetLow();
+        }
+
         bool EnableBarrierInstCounterBits = false;
         if (context->type == ShaderType::HULL_SHADER)
         {
@@ -3781,6 +3795,11 @@ namespace IGC
             SaveOption(vISA_EnableCompilerStats, true);
         }
 
+        if (IGC_IS_FLAG_ENABLED(EnablePerfModelReport))
+        {
+            SaveOption(vISA_PerfModel, true);
+        }
+
         if (m_program->m_Platform->getWATable().Wa_22011494591 && IGC_IS_FLAG_ENABLED(EnableSamplerSplit))
         {
             SaveOption(vISA_cloneSampleInst, true);
@@ -3847,7 +3866,7 @@ namespace IGC
 
         auto enableScheduler = [=]() {
             // Check if preRA scheduler is disabled from input.
-            if (isOptDisabled)
+            if (isOptDisabled || CompileTimeBudgetLow)
                 return false;
             if (context->type == ShaderType::OPENCL_SHADER) {
                 auto ClContext = static_cast<OpenCLProgramContext*>(context);
@@ -4039,6 +4058,11 @@ namespace IGC
             SaveOption(vISA_GenerateISAASM, true);
             m_enableVISAdump = true;
         }
+        if (IGC_IS_FLAG_ENABLED(EnablePressureReport) && m_enableVISAdump)
+        {
+            // written next to the .asm dump
+            SaveOption(vISA_PressureReport, true);
+        }
         if (IGC_IS_FLAG_ENABLED(EnableVISANoSchedule))
         {
             SaveOption(vISA_LocalScheduling, false);
@@ -4075,6 +4099,12 @@ namespace IGC
             SaveOption(vISA_ShaderDumpFilter, regex);
         }
 
+        const char* latencyProfile = IGC_GET_REGKEYSTRING(VISALatencyProfile);
+        if (latencyProfile && latencyProfile[0] != '\0')
+        {
+            SaveOption(vISA_LatencyProfile, latencyProfile);
+        }
+
         // In Vulkan and OGL buffer variable memory reads and writes within
         // a single shader invocation must be processed in order.
         if (m_program->m_DriverInfo->DisableDpSendReordering())
@@ -4241,7 +4271,7 @@ namespace IGC
             SaveOption(vISA_DstSrcOverlapWA, true);
         }
 
-        if (IGC_IS_FLAG_ENABLED(UseLinearScanRA))
+        if (IGC_IS_FLAG_ENABLED(UseLinearScanRA) || CompileTimeBudgetLow)
         {
             SaveOption(vISA_LinearScan, true);
         }
@@ -4251,7 +4281,7 @@ namespace IGC
             SaveOption(vISA_EnableIGASWSB, true);
         }
 
-        if (IGC_IS_FLAG_ENABLED(EnableQuickTokenAlloc))
+        if (IGC_IS_FLAG_ENABLED(EnableQuickTokenAlloc) || CompileTimeBudgetLow)
         {
             SaveOption(vISA_QuickTokenAllocation, true);
         }
@@ -4475,6 +4505,25 @@ namespace IGC
         return ss.str();
     }
 
+    // Parse the vISA text of an inline asm block into the end of the current
+    // kernel, in place of the instructions it would have been in the text.
+    void CEncoder::ParseInlineAsm(const std::string& asmStr)
+    {
+        // report the first failure only
+        if (m_inlineAsmParseError)
+            return;
+
+        if (vbuilder->ParseVISAFragment(vKernel, asmStr) != 0)
+        {
+            std::string output;
+            raw_string_ostream S(output);
+            S << "parsing vISA inline assembly failed:\n" << vbuilder->GetCriticalMsg();
+            S.flush();
+            m_program->GetContext()->EmitError(output.c_str(), nullptr);
+            m_inlineAsmParseError = true;
+        }
+    }
+
     // Creates a module/program-unique label prefix.
     // E.g. the 3rd label of the 5th function would be
     // "__4_002".  Ugly, yes, but you shouldn't see it as this is the
@@ -4574,6 +4623,7 @@ namespace IGC
         m_enableVISAdump = false;
         m_nestLevelForcedNoMaskRegion = 0;
         m_hasInlineAsm = hasInlineAsmCall;
+        m_inlineAsmParseError = false;
 
         InitLabelMap(m_program->entry);
 
@@ -4585,21 +4635,17 @@ namespace IGC
 
         llvm::SmallVector<const char*, 10> params;
         llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
-        if (!m_hasInlineAsm)
+        InitBuildParams(params2);
+        for (size_t i = 0; i < params2.size(); i++)
         {
-            // Asm text writer mode doesnt need dump params
-            InitBuildParams(params2);
-            for (size_t i = 0; i < params2.size(); i++)
-            {
-                params.push_back((params2[i].get()));
-            }
+            params.push_back((params2[i].get()));
         }
 
         COMPILER_TIME_START(m_program->GetContext(), TIME_CG_vISACompile);
         bool enableVISADump = IGC_IS_FLAG_ENABLED(EnableVISASlowpath) || IGC_IS_FLAG_ENABLED(ShaderDumpEnable);
-        auto builderMode = m_hasInlineAsm ? vISA_ASM_WRITER : vISA_DEFAULT;
+        // Inline asm is parsed directly into the kernel, which needs the vISA IR
         auto builderOpt = (enableVISADump || m_hasInlineAsm) ? VISA_BUILDER_BOTH : VISA_BUILDER_GEN;
-        V(CreateVISABuilder(vbuilder, builderMode, builderOpt, VISAPlatform, params.size(), params.data(),
+        V(CreateVISABuilder(vbuilder, vISA_DEFAULT, builderOpt, VISAPlatform, params.size(), params.data(),
             &m_vISAWaTable));
 
         if (IsCodePatchCandidate())
@@ -4610,6 +4656,13 @@ namespace IGC
 
         // Pass all build options to builder
         SetBuilderOptions(vbuilder);
+        if (m_hasInlineAsm)
+        {
+            // Keep variable names for the inline asm parser, and enable the
+            // vISA verifier to catch potential errors in user inline assembly
+            vbuilder->SetOption(vISA_ParseAsmFragment, true);
+            vbuilder->SetOption(vISA_NoVerifyvISA, false);
+        }
 
         vKernel = nullptr;
 
@@ -5263,8 +5316,15 @@ namespace IGC
             }
         }
 
-        // Compile generated VISA text string for inlineAsm
-        if (m_hasInlineAsm || visaAsmOverride)
+        // Inline asm blocks have been parsed into the kernel already
+        if (m_inlineAsmParseError)
+        {
+            COMPILER_TIME_END(m_program->GetContext(), TIME_CG_vISACompile);
+            return;
+        }
+
+        // Compile the overridden VISA text files
+        if (visaAsmOverride)
         {
             llvm::SmallVector<const char*, 10> params;
             llvm::SmallVector<std::unique_ptr< char, std::function<void(char*)>>, 10> params2;
@@ -5279,71 +5339,54 @@ namespace IGC
             V(CreateVISABuilder(vAsmTextBuilder, vISA_ASM_READER, VISA_BUILDER_BOTH, VISAPlatform,
                 params.size(), params.data(), &m_vISAWaTable));
             // Use the same build options as before, except that we enable vISA verifier to catch
-            // potential errors in user inline assembly
+            // potential errors in the overridden assembly
             SetBuilderOptions(vAsmTextBuilder);
             vAsmTextBuilder->SetOption(vISA_NoVerifyvISA, false);
 
             bool vISAAsmParseError = false;
-            // Parse the generated VISA text
-            if (visaAsmOverride)
+            // Parse the overridden VISA text
+            for (const std::string& tmpVisaFile : visaOverrideFiles)
             {
-                for (const std::string& tmpVisaFile : visaOverrideFiles)
-                {
-                    std::string asmName = GetDumpFileName("");
-                    size_t asmNamedBegin = asmName.find_last_of('\\');
-                    size_t asmNameEnd = tmpVisaFile.find_last_of('/');
-                    std::string asmPreName = asmName.substr(0, asmNamedBegin);
-                    std::string asmPostName = tmpVisaFile.substr(asmNameEnd, asmName.length());
-                    asmName = asmPreName + asmPostName;
-                    size_t asmNamed = asmName.find_last_of('.');
-                    asmName = asmName.substr(0, asmNamed);
-                    vAsmTextBuilder->SetOption(vISA_AsmFileNameOverridden, true);
-                    vAsmTextBuilder->SetOption(VISA_AsmFileName, asmName.c_str());
-                    auto result = vAsmTextBuilder->ParseVISAText(tmpVisaFile.c_str());
-                    asmName = asmName + ".visaasm";
-                    appendToShaderOverrideLogFile(asmName, "OVERRIDEN: ");
-                    vISAAsmParseError = (result != 0);
-                    if (vISAAsmParseError) {
-                        IGC_ASSERT_MESSAGE(0, "visaasm file parse error!");
-                        break;
-                    }
+                std::string asmName = GetDumpFileName("");
+                size_t asmNamedBegin = asmName.find_last_of('\\');
+                size_t asmNameEnd = tmpVisaFile.find_last_of('/');
+                std::string asmPreName = asmName.substr(0, asmNamedBegin);
+                std::string asmPostName = tmpVisaFile.substr(asmNameEnd, asmName.length());
+                asmName = asmPreName + asmPostName;
+                size_t asmNamed = asmName.find_last_of('.');
+                asmName = asmName.substr(0, asmNamed);
+                vAsmTextBuilder->SetOption(vISA_AsmFileNameOverridden, true);
+                vAsmTextBuilder->SetOption(VISA_AsmFileName, asmName.c_str());
+                auto result = vAsmTextBuilder->ParseVISAText(tmpVisaFile.c_str());
+                asmName = asmName + ".visaasm";
+                appendToShaderOverrideLogFile(asmName, "OVERRIDEN: ");
+                vISAAsmParseError = (result != 0);
+                if (vISAAsmParseError) {
+                    IGC_ASSERT_MESSAGE(0, "visaasm file parse error!");
+                    break;
                 }
+            }
 
-                // We need to update stackFuncMap for the symbol table for the overridden object,
-                // because stackFuncMap contains information about functions for original object.
-                // Only the IndirectlyCalled functions should be updated,
-                // because these functions can be used in CreateSymbolTable.
-                // Other normal stack call functions aren't used in CreateSymbolTable.
-                if (hasSymbolTable && stackFuncMap.size() > 0)
+            // We need to update stackFuncMap for the symbol table for the overridden object,
+            // because stackFuncMap contains information about functions for original object.
+            // Only the IndirectlyCalled functions should be updated,
+            // because these functions can be used in CreateSymbolTable.
+            // Other normal stack call functions aren't used in CreateSymbolTable.
+            if (hasSymbolTable && stackFuncMap.size() > 0)
+            {
+                Module* pModule = m_program->GetContext()->getModule();
+                for (auto& F : pModule->getFunctionList())
                 {
-                    Module* pModule = m_program->GetContext()->getModule();
-                    for (auto& F : pModule->getFunctionList())
+                    if (F.hasFnAttribute("referenced-indirectly") && (!F.isDeclaration() || !F.use_empty()))
                     {
-                        if (F.hasFnAttribute("referenced-indirectly") && (!F.isDeclaration() || !F.use_empty()))
-                        {
-                            auto Iter = stackFuncMap.find(&F);
-                            IGC_ASSERT_MESSAGE(Iter != stackFuncMap.end(), "vISA function not found");
+                        auto Iter = stackFuncMap.find(&F);
+                        IGC_ASSERT_MESSAGE(Iter != stackFuncMap.end(), "vISA function not found");
 
-                            VISAFunction* original = Iter->second;
-                            stackFuncMap[&F] = static_cast<VISAFunction*>(vAsmTextBuilder->GetVISAKernel(original->getFunctionName()));
-                        }
+                        VISAFunction* original = Iter->second;
+                        stackFuncMap[&F] = static_cast<VISAFunction*>(vAsmTextBuilder->GetVISAKernel(original->getFunctionName()));
                     }
                 }
             }
-            else
-            {
-                std::string parseTextFile = GetDumpFileName("inline.visaasm");
-                auto result = vAsmTextBuilder->ParseVISAText(vbuilder->GetAsmTextStream().str(), parseTextFile);
-                if (result != 0)
-                {
-                    std::string output;
-                    raw_string_ostream S(output);
-                    S << "parsing vISA inline assembly failed:\n" << vAsmTextBuilder->GetCriticalMsg();
-                    S.flush();
-                    context->EmitError(output.c_str(), nullptr);
-                    vISAAsmParseError = true;
-                }
-            }
 
             if (vISAAsmParseError)
             {
@@ -5352,11 +5395,6 @@ namespace IGC
             }
             else
             {
-                if (!visaAsmOverride)
-                {
-                    // vISA verifier is already invoked in ParseVISAText earlier
-                    vAsmTextBuilder->SetOption(vISA_NoVerifyvISA, true);
-                }
                 pMainKernel = vAsmTextBuilder->GetVISAKernel(kernelName);
                 vIsaCompile = vAsmTextBuilder->Compile(m_enableVISAdump ? GetDumpFileName("isa").c_str() : "");
             }
@@ -5398,6 +5436,18 @@ namespace IGC
             context->m_retryManager.numInstructions = jitInfo->numAsmCount;
         }
 
+        if (IGC_IS_FLAG_ENABLED(DumpSpillPrediction) && m_program->m_estimatedRegPressure != 0)
+        {
+            // Pair the pre-emit estimate with the spill size vISA reports, so
+            // that SpillPredictionThreshold can be tuned against real data.
+            errs() << "SpillPrediction : " << GetShaderName()
+                << " SIMD" << numLanes(m_program->m_dispatchSize)
+                << " estimate=" << m_program->m_estimatedRegPressure
+                << " GRFs=" << jitInfo->numGRFTotal
+                << " spill=" << (jitInfo->isSpill ? jitInfo->numGRFSpillFill : 0)
+                << "\n";
+        }
+
         if (IGC_IS_FLAG_ENABLED(DumpCompilerStats))
         {
             CompilerStats CompilerStats;
@@ -5580,6 +5630,17 @@ namespace IGC
 
         pMainKernel->GetGTPinBuffer(pOutput->m_gtpinBuffer, pOutput->m_gtpinBufferSize);
 
+        if (IGC_IS_FLAG_ENABLED(EnablePerfModelReport))
+        {
+            const char* report = nullptr;
+            unsigned int reportSize = 0;
+            pMainKernel->GetPerfModelReport(report, reportSize);
+            if (report)
+            {
+                pOutput->m_perfModelReport.assign(report, reportSize);
+            }
+        }
+
         if (hasSymbolTable)
         {
             // we can only support symbols for OPENCL_SHADER for now
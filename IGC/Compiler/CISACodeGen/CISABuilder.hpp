@@ -140,7 +140,9 @@ namespace IGC
         CEncoder();
         ~CEncoder();
         void SetProgram(CShader* program);
-        void Jump(CVariable* flag, uint label);
+        /// fallThroughPercent is the profiled percentage of channels not
+        /// taking the jump, or -1 if unknown.
+        void Jump(CVariable* flag, uint label, int fallThroughPercent = -1);
         void Label(uint label);
         uint GetNewLabelID(const CName &name);
         void DwordAtomicRaw(AtomicOp atomic_op,
@@ -438,6 +440,7 @@ namespace IGC
         void SetPayloadSectionAsSecondary() {vKernel = vKernelTmp;}
 
         std::string GetUniqueInlineAsmLabel();
+        void ParseInlineAsm(const std::string& asmStr);
 
     private:
         // helper functions
@@ -526,6 +529,10 @@ namespace IGC
 
         // Split SIMD16 message data payload(MDP) for scattered/untyped write
         // messages into two SIMD8 MDPs : V0 and V1.
+        // Both this and MergePayloadToHigherSIMD are only used for A64
+        // messages on BDW, which has no SIMD16 A64 scattered/untyped
+        // messages. The SIMD8 halves interleave per element block in the
+        // SIMD16 layout, so no raw operand can address them in place.
         void SplitPayloadToLowerSIMD(CVariable* MDP, uint32_t MDPOfst, uint32_t NumBlks, CVariable* V0, CVariable* V1, uint32_t fromSize = 16);
         // Merge two SIMD8 MDPs (V0 & V1) for scattered/untyped read messages into one SIMD16 message : MDP
         void MergePayloadToHigherSIMD(CVariable* V0, CVariable* V1, uint32_t NumBlks, CVariable* MDP, uint32_t MDPOfst, uint32_t toSize = 16);
@@ -651,6 +658,7 @@ namespace IGC
 
         bool m_enableVISAdump;
         bool m_hasInlineAsm;
+        bool m_inlineAsmParseError = false;
 
         std::vector<VISA_LabelOpnd*> labelMap;
         std::vector<CName> labelNameMap; // parallel to labelMap
@@ -2260,6 +2260,9 @@ void CShader::BeginFunction(llvm::Function* F)
     symbolMapping.clear();
     ccTupleMapping.clear();
     ConstantPool.clear();
+    // most instructions get a symbol, size the map once instead of
+    // growing it repeatedly
+    symbolMapping.reserve(F->getInstructionCount() + F->arg_size());
 
     bool useStackCall = m_FGA && m_FGA->useStackCall(F);
     if (useStackCall)
@@ -2325,11 +2328,14 @@ CVariable* CShader::getOrCreateReturnSymbol(llvm::Function* F)
         return nullptr;
 
     IGC_ASSERT(retType->isSingleValueType());
+    // The return value may be known as uniform at all call sites.
+    uint8_t dep = 0;
+    bool isUniform = m_FGA && m_FGA->getSubroutineUniformDep(F, dep);
     VISA_Type type = GetType(retType);
-    uint16_t nElts = (uint16_t)GetNumElts(retType, false);
+    uint16_t nElts = (uint16_t)GetNumElts(retType, isUniform);
     e_alignment align = getGRFAlignment();
     CVariable* var = GetNewVariable(
-        nElts, type, align, false, m_numberInstance,
+        nElts, type, align, isUniform, m_numberInstance,
         CName(F->getName(), "_RETVAL"));
     globalSymbolMapping.insert(std::make_pair(F, var));
     return var;
@@ -2435,6 +2441,11 @@ CVariable* CShader::getOrCreateArgumentSymbol(
             // Arg is for the current function and m_WI is available
             isUniform = m_WI->isUniform(&*Arg);
         }
+        else if (m_FGA) {
+            // Arg may be known as uniform at all call sites.
+            uint8_t dep = 0;
+            isUniform = m_FGA->getSubroutineUniformDep(Arg, dep);
+        }
 
         VISA_Type type = GetType(Arg->getType());
         uint16_t nElts = (uint16_t)GetNumElts(Arg->getType(), isUniform);
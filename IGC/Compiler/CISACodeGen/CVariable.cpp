@@ -16,6 +16,11 @@ using namespace IGC;
 
 const CName CName::NONE;
 
+#ifndef IGC_MAP_LLVM_NAMES_TO_VISA
+static_assert(sizeof(CVariable) <= 6 * sizeof(uint64_t),
+    "CVariable is allocated for most values of a shader, keep it compact");
+#endif
+
 
 void CVariable::ResolveAlias()
 {
@@ -49,8 +54,8 @@ CVariable::CVariable(
     m_alias(nullptr),
     m_nbElement(nbElement),
     m_aliasOffset(0),
-    m_numberOfInstance(int_cast<uint8_t>(numberOfInstance)),
     m_type(type),
+    m_numberOfInstance(int_cast<uint8_t>(numberOfInstance)),
     m_varType(varType),
     m_align(align),
     m_uniform(uniform.m_dep),
@@ -101,8 +106,8 @@ CVariable::CVariable(
     m_immediateValue(0),
     m_alias(var),
     m_aliasOffset(offset),
-    m_numberOfInstance(var->m_numberOfInstance),
     m_type(type),
+    m_numberOfInstance(var->m_numberOfInstance),
     m_varType(EVARTYPE_GENERAL),
     m_align(updateAlign(var->m_align, offset)),
     m_uniform(uniform.m_dep),
@@ -133,8 +138,8 @@ CVariable::CVariable(
     m_immediateValue(immediate),
     m_alias(nullptr),
     m_nbElement(nbElem),
-    m_numberOfInstance(1),
     m_type(type),
+    m_numberOfInstance(1),
     m_varType(EVARTYPE_GENERAL),
     m_uniform(WIBaseClass::UNIFORM_GLOBAL),
     m_isImmediate(true),
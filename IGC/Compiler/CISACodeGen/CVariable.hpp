@@ -180,8 +180,8 @@ namespace IGC {
             m_alias(nullptr),
             m_nbElement(V.m_nbElement),
             m_aliasOffset(0),
-            m_numberOfInstance(V.m_numberOfInstance),
             m_type(V.m_type),
+            m_numberOfInstance(V.m_numberOfInstance),
             m_varType(V.m_varType),
             m_align(V.m_align),
             m_uniform(V.m_uniform),
@@ -328,8 +328,10 @@ namespace IGC {
         uint16_t            m_nbElement;
         uint16_t            m_aliasOffset;
 
-        const uint8_t       m_numberOfInstance;
+        // keep the type before the byte-sized fields to avoid padding, as
+        // one CVariable is allocated for most values of the shader
         const VISA_Type     m_type;
+        const uint8_t       m_numberOfInstance;
         const e_varType     m_varType;
         e_alignment         m_align;
         const WIBaseClass::WIDependancy  m_uniform;
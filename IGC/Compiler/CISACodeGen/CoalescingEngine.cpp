@@ -29,6 +29,7 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/InstVisitor.h>
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Statistic.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/IGCPassSupport.h"
 #include "Probe/Assertion.h"
@@ -38,6 +39,10 @@ using namespace IGC;
 using namespace IGC::Debug;
 using namespace IGC::IGCMD;
 
+#define DEBUG_TYPE "payload-coalescing"
+
+STATISTIC(NumPayloadCopiesEliminated, "Number of payload element copies eliminated by coalescing");
+
 char CoalescingEngine::ID = 0;
 #define PASS_FLAG "CoalescingEngine"
 #define PASS_DESCRIPTION "coalesce moves coming payloads, insert and extract element"
@@ -150,9 +155,40 @@ namespace IGC
 
             IncrementalCoalesce(DI->getBlock());
         }
+
+        NumPayloadCopiesEliminated += CountCoalescedPayloadElements();
         return false;
     }
 
+    /// Count payload elements that live in the tuple slot of their payload,
+    /// i.e. the ones that do not need a copy when the payload is assembled.
+    uint CoalescingEngine::CountCoalescedPayloadElements()
+    {
+        uint numCoalesced = 0;
+        for (Instruction* inst : TupleInstructions)
+        {
+            for (uint numPart = 0; numPart < GetNumSplitParts(inst); numPart++)
+            {
+                SetCurrentPart(inst, numPart);
+                SmallPtrSet<Value*, 8> touchedValuesSet;
+                for (uint i = 0; i < GetNumPayloadElements(inst); i++)
+                {
+                    Value* val = GetPayloadElementToValueMapping(inst, i);
+                    if (!touchedValuesSet.insert(val).second || IsValConstOrIsolated(val))
+                    {
+                        continue;
+                    }
+                    if (GetValueCCTupleMapping(val))
+                    {
+                        numCoalesced++;
+                    }
+                }
+            }
+            SetCurrentPart(inst, 0);
+        }
+        return numCoalesced;
+    }
+
     /// Coalesce instructions within a single-BB
     void CoalescingEngine::IncrementalCoalesce(BasicBlock* MBB)
     {
@@ -249,6 +285,7 @@ namespace IGC
 
         //No result, but has side effects of updating the split mapping.
         DecideSplit(tupleGeneratingInstruction);
+        TupleInstructions.push_back(tupleGeneratingInstruction);
 
         uint numSplits = GetNumSplitParts(tupleGeneratingInstruction);
         for (uint numPart = 0; numPart < numSplits; numPart++)
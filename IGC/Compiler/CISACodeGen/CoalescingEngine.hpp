@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/PatternMatchPass.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/CISACodeGen/PayloadMapping.hpp"
+#include "common/igc_regkeys.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
 #include <llvm/ADT/DenseSet.h>
@@ -59,6 +60,7 @@ namespace IGC {
             NodeCCTupleMap.clear();
             ValueNodeMap.clear();
             BBProcessingDefs.clear();
+            TupleInstructions.clear();
             NodeOffsetMap.clear();
         }
 
@@ -345,6 +347,11 @@ namespace IGC {
             else if (llvm::dyn_cast<llvm::ExtractElementInst>(val)) {
                 return true;
             }
+            else if (m_DeSSA && IGC_IS_FLAG_DISABLED(DisablePayloadCoalescing_PhiSrc)) {
+                // val is not in a DeSSA congruence class, so phis using it get
+                // a copy at the end of the predecessor, which splits its live
+                // range from the phi's. Its liveness already covers those uses.
+            }
             else {
                 for (llvm::Value::user_iterator i = val->user_begin(), e = val->user_end(); i != e; ++i)
                 {
@@ -955,6 +962,8 @@ namespace IGC {
         CodeGenContext* m_CodeGenContext;
         //Maps a basic block to a list of instruction defs to be processed for coalescing (in dominance order)
         llvm::DenseMap<llvm::BasicBlock*, std::vector<llvm::Instruction*> > BBProcessingDefs;
+        //Tuple generating instructions that went through coalescing
+        std::vector<llvm::Instruction*> TupleInstructions;
 
 
         /* Taken from strong DE SSA */
@@ -1002,6 +1011,7 @@ namespace IGC {
         };
 
         bool isCoalescedByDeSSA(llvm::Value* V) const;
+        uint CountCoalescedPayloadElements();
     };
 
 } //namespace IGC
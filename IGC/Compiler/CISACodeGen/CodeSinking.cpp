@@ -30,6 +30,10 @@ See LICENSE.TXT for details.
   * Two tuning paramters for code-sinking:
   * - General code-sinking, enable code-sinking of step 2
   * - Register-pressure threshold, undo code-sinking when live-out pressure is high
+  *
+  * With EnableCodeSinkingRegionRollback, the motions out of a block are also
+  * checked per target block against the RegisterPressureEstimate of the target,
+  * and only the ones that make it too high are undone.
   */
 
 #include "common/debug/Debug.hpp"
@@ -42,6 +46,7 @@ See LICENSE.TXT for details.
 #include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/CFG.h"
 #include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/ADT/MapVector.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/CodeSinking.hpp"
@@ -65,6 +70,8 @@ namespace IGC {
         IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
         IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
         IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+        IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+        IGC_INITIALIZE_PASS_DEPENDENCY(RegisterPressureEstimate)
         IGC_INITIALIZE_PASS_END(CodeSinking, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
         CodeSinking::CodeSinking(bool generalSinking) : FunctionPass(ID) {
@@ -182,6 +189,20 @@ namespace IGC {
         return false;
     }
 
+    // Whether sinking from curBlk into tgtBlk lowers how often the instruction
+    // executes. Measured counts are used when both blocks are profiled,
+    // otherwise it is estimated from post-dominance.
+    bool CodeSinking::reducesExecFrequency(BasicBlock* curBlk, BasicBlock* tgtBlk, bool outerLoop) const
+    {
+        uint64_t curCount = 0, tgtCount = 0;
+        if (m_profile && m_profile->getExecCount(curBlk, curCount) &&
+            m_profile->getExecCount(tgtBlk, tgtCount))
+        {
+            return tgtCount < curCount;
+        }
+        return outerLoop || !PDT->dominates(tgtBlk, curBlk);
+    }
+
     static unsigned numInsts(const Function& F)
     {
         unsigned num = 0;
@@ -219,6 +240,23 @@ namespace IGC {
         LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
         DL = &F.getParent()->getDataLayout();
 
+        WI = nullptr;
+        m_blockPressure.clear();
+        if (generalCodeSinking && IGC_IS_FLAG_ENABLED(EnableCodeSinkingRegionRollback))
+        {
+            auto* RPE = &getAnalysis<RegisterPressureEstimate>();
+            if (RPE->isAvailable())
+            {
+                WI = &getAnalysis<WIAnalysis>();
+                for (auto& BB : F)
+                {
+                    m_blockPressure[&BB] = RPE->getMaxRegisterPressure(&BB);
+                }
+            }
+        }
+
+        m_profile = ShaderProfile::load(CTX);
+
         bool changed = hoistCongruentPhi(F);
 
         bool madeChange, everMadeChange = false;
@@ -418,6 +456,10 @@ namespace IGC {
 
         if (generalCodeSinking && registerPressureThreshold)
         {
+            if (madeChange && WI)
+            {
+                madeChange = rollbackHighPressureRegions(blk);
+            }
             if (madeChange)
             {
                 // measure the live-out register pressure again
@@ -447,6 +489,132 @@ namespace IGC {
         return madeChange;
     }
 
+    unsigned CodeSinking::getValueBytes(Value* V) const
+    {
+        if (V->getType()->isVoidTy())
+            return 0;
+        unsigned bytes = (unsigned)DL->getTypeAllocSize(V->getType());
+        return WI->isUniform(V) ? bytes : bytes * SIMD_PRESSURE_MULTIPLIER;
+    }
+
+    // Each target block of the instructions sunk out of blk is a region, which
+    // is kept or undone on its own. Sinking an instruction frees its result on
+    // the way to the target, but extends the live ranges of its operands that
+    // were not live there already.
+    bool CodeSinking::rollbackHighPressureRegions(BasicBlock& blk)
+    {
+        // RegisterPressureEstimate counts SIMD8 lanes, while shaders are usually
+        // compiled SIMD16.
+        const int limit = int(CTX->getNumGRFPerThread() * CTX->platform.getGRFSize() / 2);
+
+        DenseMap<Instruction*, unsigned> movedIdx;
+        MapVector<BasicBlock*, SmallVector<unsigned, 8>> regions;
+        for (unsigned i = 0, e = (unsigned)movedInsts.size(); i < e; ++i)
+        {
+            movedIdx[movedInsts[i]] = i;
+            regions[movedInsts[i]->getParent()].push_back(i);
+        }
+
+        DenseMap<BasicBlock*, int> deltas;
+        SmallPtrSet<BasicBlock*, 8> undone;
+        for (auto& region : regions)
+        {
+            BasicBlock* tgtBlk = region.first;
+            int delta = 0;
+            SmallPtrSet<Value*, 16> extended;
+            for (unsigned idx : region.second)
+            {
+                Instruction* inst = movedInsts[idx];
+                delta -= (int)getValueBytes(inst);
+                for (Value* op : inst->operands())
+                {
+                    if (!isa<Instruction>(op) && !isa<Argument>(op))
+                        continue;
+                    auto* opInst = dyn_cast<Instruction>(op);
+                    if (opInst && opInst->getParent() == tgtBlk)
+                        continue;
+                    if (!extended.insert(op).second)
+                        continue;
+                    bool liveInTgt = false;
+                    for (User* U : op->users())
+                    {
+                        auto* userInst = cast<Instruction>(U);
+                        if (userInst->getParent() != &blk &&
+                            !(movedIdx.count(userInst) && userInst->getParent() == tgtBlk) &&
+                            DT->dominates(tgtBlk, userInst->getParent()))
+                        {
+                            liveInTgt = true;
+                            break;
+                        }
+                    }
+                    if (!liveInTgt)
+                        delta += (int)getValueBytes(op);
+                }
+            }
+            deltas[tgtBlk] = delta;
+            if (delta > 0 && m_blockPressure[tgtBlk] + delta > limit)
+                undone.insert(tgtBlk);
+        }
+        if (undone.empty())
+        {
+            for (auto& it : deltas)
+                m_blockPressure[it.first] += it.second;
+            return true;
+        }
+
+        // instructions moving back need their operands sunk elsewhere back too
+        bool grown = true;
+        while (grown)
+        {
+            grown = false;
+            for (unsigned i = 0, e = (unsigned)movedInsts.size(); i < e; ++i)
+            {
+                if (!undone.count(movedInsts[i]->getParent()))
+                    continue;
+                for (Value* op : movedInsts[i]->operands())
+                {
+                    auto* opInst = dyn_cast<Instruction>(op);
+                    if (opInst && movedIdx.count(opInst) && opInst->getParent() != &blk)
+                        grown |= undone.insert(opInst->getParent()).second;
+                }
+            }
+        }
+
+        std::vector<Instruction*> keptInsts;
+        std::vector<Instruction*> keptLocas;
+        std::vector<bool> isUndone(movedInsts.size());
+        for (unsigned i = 0, e = (unsigned)movedInsts.size(); i < e; ++i)
+            isUndone[i] = undone.count(movedInsts[i]->getParent()) != 0;
+        for (unsigned i = 0, e = (unsigned)movedInsts.size(); i < e; ++i)
+        {
+            if (!isUndone[i])
+            {
+                keptInsts.push_back(movedInsts[i]);
+                keptLocas.push_back(undoLocas[i]);
+                continue;
+            }
+            // skip over the locations that stay sunk; the ones moved back
+            // come first in the list and are already in place
+            Instruction* undoLoca = undoLocas[i];
+            auto it = movedIdx.find(undoLoca);
+            while (it != movedIdx.end() && !isUndone[it->second])
+            {
+                undoLoca = undoLocas[it->second];
+                it = movedIdx.find(undoLoca);
+            }
+            IGC_ASSERT(undoLoca && undoLoca->getParent() == &blk);
+            movedInsts[i]->moveBefore(undoLoca);
+        }
+        for (auto& it : deltas)
+        {
+            if (!undone.count(it.first))
+                m_blockPressure[it.first] += it.second;
+        }
+        movedInsts.swap(keptInsts);
+        undoLocas.swap(keptLocas);
+        return !movedInsts.empty();
+    }
+
     static bool reduceRP(Instruction* Inst)
     {
         if (auto CI = dyn_cast<CastInst>(Inst))
@@ -632,8 +800,7 @@ namespace IGC {
             if (FindLowestSinkTarget(inst, tgtBlk, usesInBlk, outerLoop, ForceToReducePressure))
             {
                 // heuristic, avoid code-motion that does not reduce execution frequency but may increase register usage
-                if (reducePressure ||
-                    (tgtBlk && (outerLoop || !PDT->dominates(tgtBlk, inst->getParent()))))
+                if (reducePressure || (tgtBlk && reducesExecFrequency(inst->getParent(), tgtBlk, outerLoop)))
                 {
                     succToSinkTo = tgtBlk;
                 }
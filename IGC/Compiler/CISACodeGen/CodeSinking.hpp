@@ -18,6 +18,8 @@ See LICENSE.TXT for details.
 #include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/LoopInfo.h>
 #include "common/LLVMWarningsPop.hpp"
+#include "Compiler/CISACodeGen/RegisterPressureEstimate.hpp"
+#include "Compiler/ShaderProfile.hpp"
 
 namespace IGC {
 
@@ -42,6 +44,11 @@ namespace IGC {
             AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
             AU.addRequired<llvm::LoopInfoWrapperPass>();
             AU.addRequired<CodeGenContextWrapper>();
+            if (IGC_IS_FLAG_ENABLED(EnableCodeSinkingRegionRollback))
+            {
+                AU.addRequired<WIAnalysis>();
+                AU.addRequired<RegisterPressureEstimate>();
+            }
             AU.addPreserved<llvm::DominatorTreeWrapperPass>();
             AU.addPreserved<llvm::PostDominatorTreeWrapperPass>();
             AU.addPreserved<llvm::LoopInfoWrapperPass>();
@@ -58,6 +65,7 @@ namespace IGC {
             llvm::BasicBlock*& blk,
             llvm::SmallPtrSetImpl<llvm::Instruction*>& usesInBlk, bool& outerLoop,
             bool doLoopSink);
+        bool reducesExecFrequency(llvm::BasicBlock* curBlk, llvm::BasicBlock* tgtBlk, bool outerLoop) const;
         bool isSafeToMove(llvm::Instruction* inst,
             bool& reducePressure, bool& hasAliasConcern,
             llvm::SmallPtrSetImpl<llvm::Instruction*>& Stores);
@@ -70,6 +78,17 @@ namespace IGC {
         /// data members for undo
         std::vector<llvm::Instruction*> movedInsts;
         std::vector<llvm::Instruction*> undoLocas;
+
+        /// Undo the instructions sunk into the blocks whose estimated pressure
+        /// gets too high, keeping the others. Returns true if any are kept.
+        bool rollbackHighPressureRegions(llvm::BasicBlock& blk);
+        unsigned getValueBytes(llvm::Value* V) const;
+        /// per-block max pressure in bytes, estimated before sinking and updated
+        /// with the motions applied since
+        llvm::DenseMap<llvm::BasicBlock*, int> m_blockPressure;
+        WIAnalysis* WI = nullptr;
+        /// runtime-measured block frequencies, if provided
+        std::unique_ptr<ShaderProfile> m_profile;
         /// counting the number of gradient/sample operation sinked into CF
         unsigned totalGradientMoved;
         unsigned numGradientMovedOutBB;
@@ -40,6 +40,8 @@ IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
 IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
 IGC_INITIALIZE_PASS_END(ConstantCoalescing, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 ConstantCoalescing::ConstantCoalescing() : FunctionPass(ID)
@@ -97,6 +99,11 @@ void ConstantCoalescing::ProcessFunction(Function* function)
     // get the dominator-tree to traverse
     DominatorTree& dom_tree = getAnalysis<DominatorTreeWrapperPass>().getDomTree();
 
+    if (IGC_IS_FLAG_ENABLED(EnableGlobalConstantCoalescing))
+    {
+        HoistDirectCBLoads(function, dom_tree);
+    }
+
     // separate the loads into 3 streams to speed up process
     std::vector<BufChunk*> dircb_owloads;
     std::vector<BufChunk*> indcb_owloads;
@@ -391,6 +398,171 @@ bool ConstantCoalescing::isProfitableLoad(
     return true;
 }
 
+bool ConstantCoalescing::isProfitableHoist(
+    BasicBlock* dom, ArrayRef<BasicBlock*> blks, uint32_t sizeInBytes)
+{
+    if (!m_RPEComputed)
+    {
+        m_RPE->calculate();
+        m_RPEComputed = true;
+    }
+
+    // The merged chunk is live from the end of the dominator to the uses in
+    // each of the blocks, so check every block on the paths in between.
+    SmallPtrSet<BasicBlock*, 16> visited;
+    SmallVector<BasicBlock*, 16> worklist(blks.begin(), blks.end());
+    uint32_t maxPressure = m_RPE->getMaxLiveGRFAtBB(dom);
+    visited.insert(dom);
+    while (!worklist.empty())
+    {
+        BasicBlock* BB = worklist.pop_back_val();
+        if (!visited.insert(BB).second)
+            continue;
+        maxPressure = std::max(maxPressure, m_RPE->getMaxLiveGRFAtBB(BB));
+        for (BasicBlock* pred : predecessors(BB))
+            worklist.push_back(pred);
+    }
+
+    const uint32_t chunkGRFs =
+        (sizeInBytes + GRF_SIZE_IN_BYTE - 1) / GRF_SIZE_IN_BYTE;
+    return maxPressure + chunkGRFs <= IGC_GET_FLAG_VALUE(GlobalConstantCoalescingMaxGRFPressure);
+}
+
+// Direct CB loads with constant offsets are uniform and free of side effects,
+// so the ones reading the same OWord-block sized window from blocks where none
+// of them dominates the others can be hoisted to the nearest common dominator.
+// Only the load with the smallest offset is moved; the dom-scoped merging in
+// ProcessBlock then folds the others into it.
+void ConstantCoalescing::HoistDirectCBLoads(Function* function, DominatorTree& DT)
+{
+    LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+    m_RPE = &getAnalysis<RegisterEstimator>();
+    m_RPEComputed = false;
+
+    struct DirectCBLoad
+    {
+        LoadInst* load;
+        uint offsetInBytes;
+        uint sizeInBytes;
+    };
+    std::map<uint, std::vector<DirectCBLoad>> loadsPerBuffer;
+
+    for (auto& BB : *function)
+    {
+        for (auto& I : BB)
+        {
+            auto* load = dyn_cast<LoadInst>(&I);
+            if (!load || load->use_empty() || load->isVolatile() ||
+                load->getType()->isAggregateType() ||
+                load->getType()->getScalarSizeInBits() != SIZE_DWORD * 8 ||
+                load->getAlignment() % 4)
+            {
+                continue;
+            }
+            uint bufId = 0;
+            Value* elt_ptrv = nullptr;
+            BufferType bufType = BUFFER_TYPE_UNKNOWN;
+            if (!IsReadOnlyLoadDirectCB(load, bufId, elt_ptrv, bufType) ||
+                bufType != CONSTANT_BUFFER ||
+                elt_ptrv != load->getPointerOperand() ||
+                !wiAns->isUniform(load))
+            {
+                continue;
+            }
+            uint maxEltPlus = 1;
+            if (!isProfitableLoad(load, maxEltPlus))
+                continue;
+
+            uint offsetInBytes = 0;
+            if (auto* ptrToInt = dyn_cast<IntToPtrInst>(elt_ptrv))
+            {
+                auto* offsetConstant = dyn_cast<ConstantInt>(ptrToInt->getOperand(0));
+                if (!offsetConstant)
+                    continue;
+                offsetInBytes = (uint)offsetConstant->getZExtValue();
+            }
+            else if (!isa<ConstantPointerNull>(elt_ptrv))
+            {
+                continue;
+            }
+            if ((int32_t)offsetInBytes < 0 || offsetInBytes % 4)
+                continue;
+
+            const uint sizeInBytes = (uint)dataLayout->getTypeStoreSize(load->getType());
+            loadsPerBuffer[load->getPointerAddressSpace()].push_back({ load, offsetInBytes, sizeInBytes });
+        }
+    }
+
+    for (auto& it : loadsPerBuffer)
+    {
+        std::vector<DirectCBLoad>& loads = it.second;
+        std::stable_sort(loads.begin(), loads.end(),
+            [](const DirectCBLoad& a, const DirectCBLoad& b) { return a.offsetInBytes < b.offsetInBytes; });
+
+        for (size_t first = 0; first < loads.size(); )
+        {
+            // collect the window of loads fitting in a single chunk
+            size_t last = first + 1;
+            uint windowEnd = loads[first].offsetInBytes + loads[first].sizeInBytes;
+            while (last < loads.size())
+            {
+                uint end = std::max(windowEnd, loads[last].offsetInBytes + loads[last].sizeInBytes);
+                if (!profitableChunkSize(end / SIZE_DWORD, loads[first].offsetInBytes / SIZE_DWORD, SIZE_DWORD))
+                    break;
+                windowEnd = end;
+                ++last;
+            }
+
+            SmallVector<BasicBlock*, 8> blks;
+            BasicBlock* dom = nullptr;
+            for (size_t i = first; i < last; ++i)
+            {
+                BasicBlock* BB = loads[i].load->getParent();
+                if (std::find(blks.begin(), blks.end(), BB) != blks.end())
+                    continue;
+                blks.push_back(BB);
+                dom = dom ? DT.findNearestCommonDominator(dom, BB) : BB;
+            }
+
+            LoadInst* seed = loads[first].load;
+            const uint windowSize = windowEnd - loads[first].offsetInBytes;
+            first = last;
+
+            // nothing to do if one of the loads already dominates the others
+            if (blks.size() < 2 ||
+                std::find(blks.begin(), blks.end(), dom) != blks.end())
+            {
+                continue;
+            }
+            // do not hoist into a deeper loop than any of the loads
+            bool deeperLoop = false;
+            for (BasicBlock* BB : blks)
+            {
+                deeperLoop |= LI.getLoopDepth(dom) > LI.getLoopDepth(BB);
+            }
+            if (deeperLoop || !isProfitableHoist(dom, blks, windowSize))
+            {
+                continue;
+            }
+
+            Instruction* insertPt = dom->getTerminator();
+            if (auto* ptr = dyn_cast<IntToPtrInst>(seed->getPointerOperand()))
+            {
+                Instruction* newPtr = ptr->clone();
+                newPtr->insertBefore(insertPt);
+                m_TT->RegisterNewValueAndAssignID(newPtr);
+                wiAns->incUpdateDepend(newPtr, WIAnalysis::UNIFORM_GLOBAL);
+                seed->setOperand(seed->getPointerOperandIndex(), newPtr);
+                if (ptr->use_empty())
+                {
+                    ptr->eraseFromParent();
+                }
+            }
+            seed->moveBefore(insertPt);
+        }
+    }
+}
+
 void ConstantCoalescing::ProcessBlock(
     BasicBlock * blk,
     std::vector<BufChunk*> & dircb_owloads,
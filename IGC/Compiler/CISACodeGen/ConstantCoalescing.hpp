@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/TranslationTable.hpp"
 #include "Compiler/CISACodeGen/ShaderCodeGen.hpp"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/MetaDataApi/MetaDataApi.h"
 
@@ -19,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/PassManager.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/ADT/SmallBitVector.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include <llvmWrapper/Transforms/Utils.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "common/IGCIRBuilder.h"
@@ -63,7 +65,11 @@ namespace IGC
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<TranslationTable>();
             AU.addPreservedID(TranslationTable::ID);
-
+            if (IGC_IS_FLAG_ENABLED(EnableGlobalConstantCoalescing))
+            {
+                AU.addRequired<LoopInfoWrapperPass>();
+                AU.addRequired<RegisterEstimator>();
+            }
         }
 
         void ProcessBlock(llvm::BasicBlock* blk,
@@ -72,6 +78,11 @@ namespace IGC
             std::vector<BufChunk*>& indcb_gathers);
         void ProcessFunction(llvm::Function* function);
 
+        /// Hoist direct constant buffer loads from sibling blocks to their
+        /// nearest common dominator, so that the dominator-scoped merging
+        /// can combine them into a single block read.
+        void HoistDirectCBLoads(llvm::Function* function, llvm::DominatorTree& DT);
+
         void FindAllDirectCB(llvm::BasicBlock* blk,
             std::vector<BufChunk*>& dircb_owloads);
 
@@ -229,11 +240,17 @@ namespace IGC
         WIAnalysis* wiAns;
         const llvm::DataLayout* dataLayout;
         TranslationTable* m_TT;
+        // register pressure estimate for the global hoisting, computed lazily
+        RegisterEstimator* m_RPE = nullptr;
+        bool m_RPEComputed = false;
 
 
         /// Examines the uniformity of the load and the number of used elements
         /// to determine whether we should try to merge it.
         bool isProfitableLoad(const Instruction* I, uint32_t &MaxEltPlus) const;
+        /// Checks the GRF pressure on the paths from the dominator to the loads
+        /// can absorb the merged chunk of the given size.
+        bool isProfitableHoist(llvm::BasicBlock* dom, llvm::ArrayRef<llvm::BasicBlock*> blks, uint32_t sizeInBytes);
         /// Is this a chunk we should be creating?
         static bool profitableChunkSize(uint32_t ub, uint32_t lb, uint32_t eltSizeInBytes);
         static bool profitableChunkSize(uint32_t chunkSize, uint32_t eltSizeInBytes);
@@ -318,6 +318,7 @@ bool DeSSA::runOnFunction(Function& MF)
         return false;
     }
     CTX = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    COMPILER_TIME_START(CTX, TIME_CG_DeSSA);
     DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
     WIA = &getAnalysis<WIAnalysis>();
     LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
@@ -325,6 +326,10 @@ bool DeSSA::runOnFunction(Function& MF)
     DL = &MF.getParent()->getDataLayout();
     LV = &getAnalysis<LiveVarsAnalysis>().getLiveVars();
 
+    // DFS numbers give the preorder of the dominator tree used to sort
+    // congruent classes in interfere()/aliasInterfere().
+    DT->updateDFSNumbers();
+
     // make sure we do not run WIAnalysis between CodeGen and DeSSA,
     // therefore m_program's Uniform Helper is still valid, which is
     // used indirectly in DeSSA::GetPhiTemp().
@@ -568,6 +573,7 @@ bool DeSSA::runOnFunction(Function& MF)
         DumpUnlock();
     }
     m_F = nullptr;
+    COMPILER_TIME_END(CTX, TIME_CG_DeSSA);
     return false;
 }
 
@@ -1394,32 +1400,99 @@ bool DeSSA::isSingleValued(llvm::Value* V) const
 //      on Code Generation and Optimization (Seattle, Washington,
 //      March 22 - 25, 2009). CGO '09. IEEE, Washington, DC, 114-125.
 //
-// Here, we simply use a naive pair-wise comparison.
+// In SSA, two values can only interfere if the def of one dominates the
+// def of the other. Both classes are sorted in dominance preorder and
+// walked with a stack holding the dominator chain of the current value,
+// so only pairs whose defs are related by dominance are checked.
 //
-// TODO: check if using linear approach described in the paper is
-//   necessary;  To do so, it needs to get PN (preorder number of BB)
-//   and sort congruent classes before doing interference checking.
-bool DeSSA::interfere(llvm::Value* V0, llvm::Value* V1)
+// Note that only the chain is pruned, not the check itself: the paper
+// checks against the nearest dominating value only, which relies on the
+// values of a class not interfering with each other. Here a class may
+// hold aliases whose live ranges overlap, so every value of the other
+// class on the chain is checked.
+namespace {
+    struct CCValueOrder {
+        Value* V;
+        unsigned DFSIn;
+        unsigned DFSOut;
+        unsigned Dist;
+        bool InCC1;
+    };
+}
+
+bool DeSSA::interfere(Value* V0, Value* V1, Value* Skip0, Value* Skip1)
 {
     SmallVector<Value*, 8> allCC0;
     SmallVector<Value*, 8> allCC1;
     getAllValuesInCongruentClass(V0, allCC0);
     getAllValuesInCongruentClass(V1, allCC1);
 
-    for (int i0 = 0, sz0 = (int)allCC0.size(); i0 < sz0; ++i0)
+    SmallVector<CCValueOrder, 16> vals;
+    vals.reserve(allCC0.size() + allCC1.size());
+    auto addVals = [&](SmallVectorImpl<Value*>& CC, bool InCC1) {
+        for (Value* V : CC)
+        {
+            CCValueOrder O = { V, 0, ~0U, 0, InCC1 };
+            if (auto* I = dyn_cast<Instruction>(V))
+            {
+                // Values in unreachable blocks are treated like arguments,
+                // i.e. checked against everything.
+                if (DomTreeNode* N = DT->getNode(I->getParent()))
+                {
+                    O.DFSIn = N->getDFSNumIn();
+                    O.DFSOut = N->getDFSNumOut();
+                }
+                // PHIs are all defined at the beginning of the block.
+                O.Dist = isa<PHINode>(I) ? 0 : LV->getDistance(I);
+            }
+            vals.push_back(O);
+        }
+    };
+    addVals(allCC0, false);
+    addVals(allCC1, true);
+
+    // Arguments (DFSIn 0, Dist 0) come first, as they dominate all values.
+    std::sort(vals.begin(), vals.end(),
+        [](const CCValueOrder& A, const CCValueOrder& B) {
+            return A.DFSIn < B.DFSIn || (A.DFSIn == B.DFSIn && A.Dist < B.Dist);
+        });
+
+    auto dominates = [](const CCValueOrder& A, const CCValueOrder& B) {
+        // A precedes B in preorder, so it suffices to check that B's block
+        // is within A's dominator subtree.
+        return B.DFSIn <= A.DFSOut;
+    };
+
+    SmallVector<const CCValueOrder*, 16> chain;
+    for (const CCValueOrder& cur : vals)
     {
-        Value* val0 = allCC0[i0];
-        for (int i1 = 0, sz1 = (int)allCC1.size(); i1 < sz1; ++i1)
+        while (!chain.empty() && !dominates(*chain.back(), cur)) {
+            chain.pop_back();
+        }
+        for (const CCValueOrder* dom : chain)
         {
-            Value* val1 = allCC1[i1];
+            if (dom->InCC1 == cur.InCC1) {
+                continue;
+            }
+            Value* val0 = cur.InCC1 ? dom->V : cur.V;
+            Value* val1 = cur.InCC1 ? cur.V : dom->V;
+            if (val0 == Skip0 && val1 == Skip1) {
+                continue;
+            }
             if (LV->hasInterference(val0, val1)) {
                 return true;
             }
         }
+        chain.push_back(&cur);
     }
     return false;
 }
 
+bool DeSSA::interfere(llvm::Value* V0, llvm::Value* V1)
+{
+    return interfere(V0, V1, nullptr, nullptr);
+}
+
 // Alias interference checking.
 //    The caller is trying to check if V0 can alias to V1. For example,
 //      V0 = bitcast V1, or
@@ -1429,11 +1502,6 @@ bool DeSSA::interfere(llvm::Value* V0, llvm::Value* V1)
 //    with V0 and V1 interference ignored.
 bool DeSSA::aliasInterfere(llvm::Value* V0, llvm::Value* V1)
 {
-    SmallVector<Value*, 8> allCC0;
-    SmallVector<Value*, 8> allCC1;
-    getAllValuesInCongruentClass(V0, allCC0);
-    getAllValuesInCongruentClass(V1, allCC1);
-
     Value* V0_aliasee = getAliasee(V0);
     Value* V1_aliasee = getAliasee(V1);
 
@@ -1460,22 +1528,10 @@ bool DeSSA::aliasInterfere(llvm::Value* V0, llvm::Value* V1)
     bool V1_oneValue = (InsEltMap.count(V1_aliasee) == 0);
     bool both_singleValue = (V0_oneValue && V1_oneValue);
 
-    for (int i0 = 0, sz0 = (int)allCC0.size(); i0 < sz0; ++i0)
-    {
-        Value* val0 = allCC0[i0];
-        for (int i1 = 0, sz1 = (int)allCC1.size(); i1 < sz1; ++i1)
-        {
-            Value* val1 = allCC1[i1];
-            if (both_singleValue &&
-                val0 == V0_aliasee && val1 == V1_aliasee) {
-                continue;
-            }
-            if (LV->hasInterference(val0, val1)) {
-                return true;
-            }
-        }
+    if (both_singleValue) {
+        return interfere(V0, V1, V0_aliasee, V1_aliasee);
     }
-    return false;
+    return interfere(V0, V1, nullptr, nullptr);
 }
 
 // The existing code does align interference checking. Just
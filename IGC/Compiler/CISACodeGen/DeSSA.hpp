@@ -278,6 +278,9 @@ namespace IGC {
 
     private:
         void CoalesceInsertElementsForBasicBlock(llvm::BasicBlock* blk);
+        /// Check interference of the congruent classes of V0 and V1, ignoring
+        /// the pair (Skip0, Skip1).
+        bool interfere(llvm::Value* V0, llvm::Value* V1, llvm::Value* Skip0, llvm::Value* Skip1);
 
         void InsEltMapAddValue(llvm::Value* Val) {
             if (InsEltMap.find(Val) == InsEltMap.end()) {
@@ -112,6 +112,13 @@ bool DebugInfoPass::runOnModule(llvm::Module& M)
         return retUniqueFuncVec;
     };
 
+    // In deferred mode the compact vISA to Gen ISA mapping produced by the
+    // finalizer is shipped as is (2-step debug), and DWARF is built from it
+    // by the consumer when a debugger needs it. zeBinary has no place for the
+    // mapping, so there DWARF is always generated.
+    const bool deferDwarf = IGC_IS_FLAG_ENABLED(DeferDwarfEmission) &&
+        IGC_IS_FLAG_DISABLED(EnableZEBinary);
+
     for (auto& currShader : units)
     {
         // Look for the right CShaderProgram instance
@@ -121,6 +128,13 @@ bool DebugInfoPass::runOnModule(llvm::Module& M)
         if (!isEntryFunc(pMdUtils, m_currShader->entry))
             continue;
 
+        if (deferDwarf)
+        {
+            IDebugEmitter* pDebugEmitter = m_currShader->GetDebugInfoData().m_pDebugEmitter;
+            IDebugEmitter::Release(pDebugEmitter);
+            continue;
+        }
+
         bool finalize = false;
         unsigned int size = m_currShader->GetDebugInfoData().m_VISAModules.size();
         m_pDebugEmitter = m_currShader->GetDebugInfoData().m_pDebugEmitter;
@@ -39,11 +39,13 @@ SPDX-License-Identifier: MIT
 #include "llvm/Support/Path.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/IR/AssemblyAnnotationWriter.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvmWrapper/IR/Intrinsics.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
 
 #include <fstream>
+#include <functional>
 
 using namespace llvm;
 using namespace IGC;
@@ -134,6 +136,7 @@ EmitPass::EmitPass(CShaderProgram::KernelShaderMap& shaders, SIMDMode mode, bool
     initializeCoalescingEnginePass(*PassRegistry::getPassRegistry());
     initializeMetaDataUtilsWrapperPass(*PassRegistry::getPassRegistry());
     initializeSimd32ProfitabilityAnalysisPass(*PassRegistry::getPassRegistry());
+    initializeRegisterPressureEstimatePass(*PassRegistry::getPassRegistry());
     initializeVariableReuseAnalysisPass(*PassRegistry::getPassRegistry());
     initializeLiveVariablesPass(*PassRegistry::getPassRegistry());
 }
@@ -441,6 +444,46 @@ bool EmitPass::compileSymbolTableKernel(llvm::Function* F)
     return false;
 }
 
+bool EmitPass::skipOnPredictedSpill(llvm::Function* F)
+{
+    if (IGC_IS_FLAG_DISABLED(EnableSpillPrediction) &&
+        IGC_IS_FLAG_DISABLED(DumpSpillPrediction))
+    {
+        return false;
+    }
+
+    // SIMD8 is the fallback for every other width, never predict it away.
+    if (m_SimdMode == SIMDMode::SIMD8)
+    {
+        return false;
+    }
+
+    RegisterPressureEstimate& RPE = getAnalysis<RegisterPressureEstimate>();
+    if (!RPE.isAvailable())
+    {
+        return false;
+    }
+
+    // The estimate ignores coalescing and rematerialization done later, so
+    // the threshold is a percentage of the GRF file that may exceed 100.
+    unsigned estimate = RPE.getMaxRegisterPressureForSIMD(numLanes(m_SimdMode));
+    uint64_t limit = (uint64_t)m_pCtx->getNumGRFPerThread() * m_currShader->getGRFSize() *
+        IGC_GET_FLAG_VALUE(SpillPredictionThreshold) / 100;
+    m_currShader->m_estimatedRegPressure = estimate;
+
+    // Only variants that are dropped on spill anyway may be skipped.
+    bool skip = IGC_IS_FLAG_ENABLED(EnableSpillPrediction) &&
+        m_canAbortOnSpill && estimate > limit;
+    if (skip && IGC_IS_FLAG_ENABLED(DumpSpillPrediction))
+    {
+        errs() << "SpillPrediction : " << m_encoder->GetShaderName()
+            << " SIMD" << numLanes(m_SimdMode)
+            << " estimate=" << estimate << " limit=" << limit
+            << " skipped\n";
+    }
+    return skip;
+}
+
 void EmitPass::CreateKernelShaderMap(CodeGenContext* ctx, MetaDataUtils* pMdUtils, llvm::Function& F)
 {
     /* Moving CShaderProgram instantiation to EmitPass from codegen*/
@@ -609,6 +652,11 @@ bool EmitPass::runOnFunction(llvm::Function& F)
         {
             return false;
         }
+        if (skipOnPredictedSpill(&F))
+        {
+            m_pCtx->SetSIMDInfo(SIMD_SKIP_SPILL, m_SimdMode, m_ShaderDispatchMode);
+            return false;
+        }
 
         VISAKernel* prevKernel = nullptr;
 
@@ -884,6 +932,7 @@ bool EmitPass::runOnFunction(llvm::Function& F)
 
         // remove cached per lane offset variables if any.
         PerLaneOffsetVars.clear();
+        SamplePayloadBroadcasts.clear();
 
         // Variable reuse per-block states.
         VariableReuseAnalysis::EnterBlockRAII EnterBlock(m_VRA, block.bb);
@@ -7347,6 +7396,47 @@ void EmitPass::interceptSamplePayloadCoalescing(
 }
 
 
+// The source is SSA within the block, so its broadcast stays valid until the
+// block ends. A NoMask broadcast serves any sample, one made under the
+// execution mask only serves other samples that are not derivative.
+CVariable* EmitPass::getOrCreateSamplePayloadBroadcast(CVariable* src, bool noMask)
+{
+    const bool secondHalf = m_encoder->IsSecondHalf();
+    SamplePayloadBroadcast* entry = nullptr;
+    for (auto& Item : SamplePayloadBroadcasts)
+    {
+        if (Item.src == src && Item.secondHalf == secondHalf)
+        {
+            if (Item.noMask || !noMask)
+            {
+                return Item.broadcast;
+            }
+            entry = &Item;
+            break;
+        }
+    }
+
+    CVariable* srcReg = m_currShader->GetNewVariable(
+        numLanes(m_currShader->m_SIMDSize), src->GetType(), EALIGN_GRF, CName::NONE);
+    if (noMask)
+    {
+        m_encoder->SetNoMask();
+    }
+    m_encoder->Copy(srcReg, src);
+    m_encoder->Push();
+
+    if (entry)
+    {
+        entry->broadcast = srcReg;
+        entry->noMask = noMask;
+    }
+    else
+    {
+        SamplePayloadBroadcasts.push_back({ src, srcReg, secondHalf, noMask });
+    }
+    return srcReg;
+}
+
 ResourceDescriptor EmitPass::GetSampleResourceHelper(SampleIntrinsic* inst)
 {
     llvm::Value* texOp = inst->getTextureValue();
@@ -7417,15 +7507,7 @@ void EmitPass::emitSampleInstruction(SampleIntrinsic* inst)
                 CVariable* src = GetSymbol(v);
                 if (src->IsUniform())
                 {
-                    CVariable* srcReg = m_currShader->GetNewVariable(
-                        numLanes(m_currShader->m_SIMDSize), src->GetType(), EALIGN_GRF, CName::NONE);
-                    if (derivativeSample)
-                    {
-                        m_encoder->SetNoMask();
-                    }
-                    m_encoder->Copy(srcReg, src);
-                    m_encoder->Push();
-                    src = srcReg;
+                    src = getOrCreateSamplePayloadBroadcast(src, derivativeSample);
                 }
                 payload.push_back(src);
             }
@@ -9233,7 +9315,6 @@ bool EmitPass::validateInlineAsmConstraints(llvm::CallInst* inst, SmallVector<St
 // Example: "mul (M1, 16) $0(0, 0)<1> $1(0, 0)<1;1,0> $2(0, 0)<1;1,0>", "=r,r,r"(float %6, float %7)
 void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
 {
-    std::stringstream& str = m_encoder->GetVISABuilder()->GetAsmTextStream();
     InlineAsm* IA = cast<InlineAsm>(IGCLLVM::getCalledValue(inst));
     string asmStr = IA->getAsmString();
     smallvector<CVariable*, 8> opnds;
@@ -9344,7 +9425,6 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         }
     }
 
-    str << endl << "/// Inlined ASM" << endl;
     // Look for variables to replace with the VISA variable
     size_t startPos = 0;
     while (startPos < asmStr.size())
@@ -9376,9 +9456,7 @@ void EmitPass::EmitInlineAsm(llvm::CallInst* inst)
         startPos = varPos + varName.size();
     }
 
-    str << asmStr;
-    if (asmStr.back() != '\n') str << endl;
-    str << "/// End Inlined ASM" << endl << endl;
+    m_encoder->ParseInlineAsm(asmStr);
 }
 
 CVariable* EmitPass::Mul(CVariable* Src0, CVariable* Src1, const CVariable* DstPrototype)
@@ -10346,6 +10424,18 @@ void EmitPass::EmitNoModifier(llvm::Instruction* inst)
     case Instruction::ExtractElement:
         emitExtract(cast<ExtractElementInst>(inst));
         break;
+    case Instruction::FAdd:
+    case Instruction::FSub:
+    case Instruction::FMul:
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor:
+        IGC_ASSERT_MESSAGE(inst->getType()->isVectorTy(), "scalar ALU ops are matched by patterns");
+        emitVectorBinary(cast<BinaryOperator>(inst));
+        break;
     case Instruction::Unreachable:
         break;
     default:
@@ -10353,6 +10443,63 @@ void EmitPass::EmitNoModifier(llvm::Instruction* inst)
     }
 }
 
+// Emit a vector binary operator left unscalarized. Uniform vectors are packed
+// contiguously, so when everything is uniform the whole vector is computed by
+// a single instruction with the execution size set to the element count.
+// Otherwise, fall back to one instruction per element.
+void EmitPass::emitVectorBinary(BinaryOperator* BO)
+{
+    auto* VTy = cast<IGCLLVM::FixedVectorType>(BO->getType());
+    unsigned nElts = (unsigned)VTy->getNumElements();
+    unsigned width = numLanes(m_currShader->m_SIMDSize);
+
+    CVariable* srcs[2] = { GetSymbol(BO->getOperand(0)), GetSymbol(BO->getOperand(1)) };
+    bool isSub = BO->getOpcode() == Instruction::FSub || BO->getOpcode() == Instruction::Sub;
+    EOPCODE opCode = isSub ? (VTy->isFPOrFPVectorTy() ? llvm_fadd : llvm_add) : GetOpCode(BO);
+
+    bool allUniform = m_destination->IsUniform() &&
+        (srcs[0]->IsUniform() || srcs[0]->IsImmediate()) &&
+        (srcs[1]->IsUniform() || srcs[1]->IsImmediate());
+    if (allUniform && isPowerOf2_32(nElts) && nElts <= 8)
+    {
+        m_encoder->SetUniformSIMDSize(lanesToSIMDMode(nElts));
+        for (unsigned j = 0; j < 2; ++j)
+        {
+            if (!srcs[j]->IsImmediate())
+                m_encoder->SetSrcRegion(j, 1, 1, 0);
+        }
+        if (isSub)
+            m_encoder->SetSrcModifier(1, EMOD_NEG);
+        EmitSimpleAlu(opCode, m_destination, srcs[0], srcs[1]);
+        m_encoder->Push();
+        return;
+    }
+
+    bool dstUniform = m_destination->IsUniform();
+    for (unsigned i = 0; i < nElts; ++i)
+    {
+        for (unsigned j = 0; j < 2; ++j)
+        {
+            if (srcs[j]->IsImmediate())
+                continue;
+            if (srcs[j]->IsUniform())
+            {
+                m_encoder->SetSrcRegion(j, 0, 1, 0);
+                m_encoder->SetSrcSubReg(j, i);
+            }
+            else
+            {
+                m_encoder->SetSrcSubReg(j, i * width);
+            }
+        }
+        m_encoder->SetDstSubReg(dstUniform ? i : i * width);
+        if (isSub)
+            m_encoder->SetSrcModifier(1, EMOD_NEG);
+        EmitSimpleAlu(opCode, m_destination, srcs[0], srcs[1]);
+        m_encoder->Push();
+    }
+}
+
 void EmitPass::emitPairToPtr(GenIntrinsicInst* GII) {
     CVariable* Lo = GetSymbol(GII->getOperand(0));
     CVariable* Hi = GetSymbol(GII->getOperand(1));
@@ -10548,6 +10695,91 @@ void EmitPass::emitReturn(llvm::ReturnInst* inst)
     m_currShader->AddEpilogue(inst);
 }
 
+// Per-work-item stack size of the deepest call chain starting at pKernel:
+// the private memory of the kernel and of each stack-call function on the
+// chain, plus a reserve for every stack-call frame. Subroutines share the
+// frame of their caller, whose private memory already includes theirs. Indirect calls may reach any callee of their !callees
+// metadata or, without it, any function referenced indirectly. Returns false
+// if the depth is unbounded, i.e. on recursion or on calls to external
+// functions whose stack usage is unknown.
+static bool getCallGraphStackSize(Function* pKernel, const ModuleMetaData* pModuleMetadata, uint32_t& stackSize)
+{
+    const uint32_t frameReserve = IGC_GET_FLAG_VALUE(StackCallFrameReserve);
+    Module* M = pKernel->getParent();
+
+    SmallVector<Function*, 8> indirectCallees;
+    for (auto& F : *M)
+    {
+        if (F.hasFnAttribute("referenced-indirectly"))
+            indirectCallees.push_back(&F);
+    }
+
+    auto getFrameSize = [&](Function* F) -> uint32_t {
+        if (F != pKernel && !F->hasFnAttribute("visaStackCall"))
+            return 0;
+        auto it = pModuleMetadata->FuncMD.find(F);
+        uint32_t privateMem = it != pModuleMetadata->FuncMD.end() ? (uint32_t)it->second.privateMemoryPerWI : 0;
+        return F == pKernel ? privateMem : privateMem + frameReserve;
+    };
+
+    // ~0U marks a function that is on the current chain
+    const uint32_t onChain = ~0U;
+    DenseMap<Function*, uint32_t> sizes;
+    std::function<bool(Function*, uint32_t&)> visit = [&](Function* F, uint32_t& size) -> bool {
+        auto it = sizes.find(F);
+        if (it != sizes.end())
+        {
+            size = it->second;
+            return size != onChain;
+        }
+        if (F->isDeclaration())
+        {
+            size = 0;
+            return F->isIntrinsic();
+        }
+        sizes[F] = onChain;
+
+        uint32_t deepestCallee = 0;
+        for (auto& I : instructions(*F))
+        {
+            auto* CI = dyn_cast<CallInst>(&I);
+            if (!CI || isa<IntrinsicInst>(CI) || isa<GenIntrinsicInst>(CI) || CI->isInlineAsm())
+                continue;
+
+            SmallVector<Function*, 8> callees;
+            if (Function* callee = CI->getCalledFunction())
+            {
+                callees.push_back(callee);
+            }
+            else if (MDNode* calleesMD = CI->getMetadata(LLVMContext::MD_callees))
+            {
+                for (auto& op : calleesMD->operands())
+                {
+                    if (auto* callee = mdconst::dyn_extract_or_null<Function>(op))
+                        callees.push_back(callee);
+                }
+            }
+            else
+            {
+                callees.append(indirectCallees.begin(), indirectCallees.end());
+            }
+
+            for (Function* callee : callees)
+            {
+                uint32_t calleeSize = 0;
+                if (!visit(callee, calleeSize))
+                    return false;
+                deepestCallee = std::max(deepestCallee, calleeSize);
+            }
+        }
+
+        size = getFrameSize(F) + deepestCallee;
+        sizes[F] = size;
+        return true;
+    };
+    return visit(pKernel, stackSize);
+}
+
 /// Initializes the kernel for stack call by initializing the SP and FP
 void EmitPass::InitializeKernelStack(Function* pKernel)
 {
@@ -10561,11 +10793,18 @@ void EmitPass::InitializeKernelStack(Function* pKernel)
 
     CVariable* pSize = nullptr;
 
-    // Do a crude estimation of the stack size required per thread.
+    // Stack size required per work-item, from the call graph when its depth
+    // is bounded. Otherwise do a crude estimation:
     // Estimated size = PrivateMem of Kernel + PrivateMem of Largest StackCall Func in Module + 2KB (for additional nested calls and arguments)
-    // TODO: Can have a better estimate by analyzing callgraph. However, we won't know the exact value for indirect and recursive calls.
     auto GetMaxPrivateMem = [&](void)->uint32_t
     {
+        uint32_t callGraphSize = 0;
+        if (IGC_IS_FLAG_ENABLED(EnableCallGraphStackSize) &&
+            getCallGraphStackSize(pKernel, pModuleMetadata, callGraphSize))
+        {
+            return callGraphSize;
+        }
+
         uint32_t allocMemSize = 0;
         uint32_t largest = 0;
         for (auto& iter : pModuleMetadata->FuncMD)
@@ -11646,6 +11885,21 @@ void EmitPass::emitBranch(llvm::BranchInst* branch, const SSource& cond, e_predM
         m_encoder->SetPredicateMode(predMode);
         m_encoder->SetInversePredicate(inversePred);
 
+        // Profiled percentage of channels going to succ0, from the
+        // branch_weights the shader profile attached.
+        int succ0Percent = -1;
+        if (MDNode* prof = branch->getMetadata(LLVMContext::MD_prof))
+        {
+            MDString* kind = prof->getNumOperands() == 3 ? dyn_cast<MDString>(prof->getOperand(0)) : nullptr;
+            if (kind && kind->getString() == "branch_weights")
+            {
+                uint64_t weight0 = mdconst::extract<ConstantInt>(prof->getOperand(1))->getZExtValue();
+                uint64_t weight1 = mdconst::extract<ConstantInt>(prof->getOperand(2))->getZExtValue();
+                if (weight0 + weight1 != 0)
+                    succ0Percent = int(weight0 * 100 / (weight0 + weight1));
+            }
+        }
+
         if (next == NULL || (next != succ0 && next != succ1))
         {
             // Both succ0 and succ1 are not next. Thus, need one conditional jump and
@@ -11706,7 +11960,7 @@ void EmitPass::emitBranch(llvm::BranchInst* branch, const SSource& cond, e_predM
         {
             IGC_ASSERT_MESSAGE(next == succ1, "next should be succ1!");
 
-            m_encoder->Jump(flag, label0);
+            m_encoder->Jump(flag, label0, succ0Percent < 0 ? -1 : 100 - succ0Percent);
             m_encoder->Push();
         }
         else
@@ -11714,7 +11968,7 @@ void EmitPass::emitBranch(llvm::BranchInst* branch, const SSource& cond, e_predM
             IGC_ASSERT_MESSAGE(next == succ0, "next should be succ0");
 
             m_encoder->SetInversePredicate(!inversePred);
-            m_encoder->Jump(flag, label1);
+            m_encoder->Jump(flag, label1, succ0Percent);
             m_encoder->Push();
         }
     }
@@ -17389,15 +17643,14 @@ void EmitPass::emitSqrt(Instruction* inst)
 {
     GenIntrinsicInst* intrinCall = llvm::cast<GenIntrinsicInst>(inst);
     CVariable* src0 = GetSymbol(intrinCall->getArgOperand(0));
-    src0 = BroadcastIfUniform(src0);
 
+    // A uniform source is read through a scalar region; no broadcast needed.
     m_encoder->Sqrt(m_destination, src0);
 }
 
 void EmitPass::emitFrc(llvm::GenIntrinsicInst* inst)
 {
     CVariable* src0 = GetSymbol(inst->getArgOperand(0));
-    src0 = BroadcastIfUniform(src0);
 
     m_encoder->Frc(m_destination, src0);
 }
@@ -18026,7 +18279,7 @@ void EmitPass::emitWaveBallot(llvm::GenIntrinsicInst* inst)
     CVariable* destination = m_destination;
     if (!m_destination->IsUniform())
     {
-        destination = m_currShader->GetNewVariable(1, ISA_TYPE_UD, EALIGN_GRF, true, CName::NONE);
+        destination = m_currShader->GetNewVariable(1, ISA_TYPE_UD, EALIGN_DWORD, true, CName::NONE);
     }
 
     bool uniform_active_lane = false;
@@ -18060,7 +18313,7 @@ void EmitPass::emitWaveBallot(llvm::GenIntrinsicInst* inst)
             // (W)     and (1|M0)   r1.0:ud r0.0<0;1;0>:ud f0.0:uw
             CVariable* f0 = GetSymbol(inst->getOperand(0));
             CVariable* vf0 = m_currShader->GetNewVariable(
-                1, ISA_TYPE_UD, EALIGN_GRF, true, CName::NONE);
+                1, ISA_TYPE_UD, EALIGN_DWORD, true, CName::NONE);
             m_encoder->SetSimdSize(SIMDMode::SIMD1);
             m_encoder->SetNoMask();
             m_encoder->BoolToInt(vf0, f0);
@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "ShaderCodeGen.hpp"
 #include "CoalescingEngine.hpp"
 #include "Simd32Profitability.hpp"
+#include "RegisterPressureEstimate.hpp"
 #include "GenCodeGenModule.h"
 #include "VariableReuseAnalysis.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
@@ -60,6 +61,11 @@ public:
         AU.addRequired<Simd32ProfitabilityAnalysis>();
         AU.addRequired<CodeGenContextWrapper>();
         AU.addRequired<VariableReuseAnalysis>();
+        if (IGC_IS_FLAG_ENABLED(EnableSpillPrediction) ||
+            IGC_IS_FLAG_ENABLED(DumpSpillPrediction))
+        {
+            AU.addRequired<RegisterPressureEstimate>();
+        }
         AU.setPreservesAll();
     }
 
@@ -324,6 +330,7 @@ public:
     void emitcycleCounter(llvm::Instruction* inst);
     void emitSetDebugReg(llvm::Instruction* inst);
     void emitInsert(llvm::Instruction* inst);
+    void emitVectorBinary(llvm::BinaryOperator* BO);
     void emitExtract(llvm::Instruction* inst);
     void emitBitCast(llvm::BitCastInst* btCst);
     void emitPtrToInt(llvm::PtrToIntInst* p2iCst);
@@ -570,6 +577,10 @@ public:
     /// check if the dummy kernel requires compilation
     bool compileSymbolTableKernel(llvm::Function* F);
 
+    /// return true if the current SIMD variant is predicted to spill and can
+    /// be skipped before emitting any vISA.
+    bool skipOnPredictedSpill(llvm::Function* F);
+
     // Arithmetic operations with constant folding
     // Src0 and Src1 are the input operands
     // DstPrototype is a prototype of the result of operation and may be used for cloning to a new variable
@@ -699,6 +710,20 @@ private:
         return Var;
     }
 
+    // Uniform sample payload sources already broadcast in the current basic
+    // block. Filter kernels pass the same uniform coordinate, LOD or array
+    // index to many samples, which then share one broadcast register.
+    struct SamplePayloadBroadcast
+    {
+        CVariable* src;
+        CVariable* broadcast;
+        bool secondHalf;
+        bool noMask;
+    };
+    llvm::SmallVector<SamplePayloadBroadcast, 8> SamplePayloadBroadcasts;
+
+    CVariable* getOrCreateSamplePayloadBroadcast(CVariable* src, bool noMask);
+
     // Emit code in slice starting from (reverse) iterator I. Return the
     // iterator to the next pattern to emit.
     SBasicBlock::reverse_iterator emitInSlice(SBasicBlock& block,
@@ -7,12 +7,15 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "Compiler/CISACodeGen/EstimateFunctionSize.h"
+#include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "Compiler/CodeGenContextWrapper.hpp"
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/IGCPassSupport.h"
 #include "common/igc_regkeys.hpp"
+#include "common/debug/Debug.hpp"
 #include "common/LLVMWarningsPush.hpp"
+#include "llvm/Analysis/LoopInfo.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
@@ -20,7 +23,9 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
 #include <deque>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 using namespace llvm;
 using namespace IGC;
@@ -28,6 +33,8 @@ using namespace IGC;
 char EstimateFunctionSize::ID = 0;
 
 IGC_INITIALIZE_PASS_BEGIN(EstimateFunctionSize, "EstimateFunctionSize", "EstimateFunctionSize", false, true)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(RegisterEstimator)
 IGC_INITIALIZE_PASS_END(EstimateFunctionSize, "EstimateFunctionSize", "EstimateFunctionSize", false, true)
 
 llvm::ModulePass* IGC::createEstimateFunctionSizePass() {
@@ -48,6 +55,10 @@ EstimateFunctionSize::~EstimateFunctionSize() { clear(); }
 
 void EstimateFunctionSize::getAnalysisUsage(AnalysisUsage& AU) const {
     AU.setPreservesAll();
+    if (IGC_IS_FLAG_ENABLED(EnableInlineCostModel)) {
+        AU.addRequired<LoopInfoWrapperPass>();
+        AU.addRequired<RegisterEstimator>();
+    }
 }
 
 bool EstimateFunctionSize::runOnModule(Module& Mod) {
@@ -126,6 +137,10 @@ namespace {
         /// \brief A flag to indicate whether this node should be always inlined.
         bool ToBeInlined;
 
+        /// \brief Cached result of getOutlineScore, valid if HasOutlineScore.
+        int64_t OutlineScore = 0;
+        bool HasOutlineScore = false;
+
         bool HasImplicitArg;
 
         /// \brief All functions directly called in this function.
@@ -635,7 +650,21 @@ void EstimateFunctionSize::reduceKernelSize() {
         auto Cmp = [](const FunctionNode* LHS, const FunctionNode* RHS) {
             return LHS->Size > RHS->Size;
         };
-        std::sort(SortedKernelFunctions.begin(), SortedKernelFunctions.end(), Cmp);
+        if (IGC_IS_FLAG_ENABLED(EnableInlineCostModel)) {
+            for (auto Node : SortedKernelFunctions)
+                getOutlineScore(Node->F);
+            // Functions that are cheaper to call than to inline are trimmed
+            // first; size only breaks ties.
+            std::stable_sort(SortedKernelFunctions.begin(), SortedKernelFunctions.end(),
+                [&](const FunctionNode* LHS, const FunctionNode* RHS) {
+                    if (LHS->OutlineScore != RHS->OutlineScore)
+                        return LHS->OutlineScore > RHS->OutlineScore;
+                    return Cmp(LHS, RHS);
+                });
+        }
+        else {
+            std::sort(SortedKernelFunctions.begin(), SortedKernelFunctions.end(), Cmp);
+        }
 
         if( ( IGC_GET_FLAG_VALUE( PrintControlKernelTotalSize ) & 0x4 ) != 0 )
         {
@@ -649,6 +678,14 @@ void EstimateFunctionSize::reduceKernelSize() {
             SortedKernelFunctions.erase(SortedKernelFunctions.begin());
 
             FunctionToRemove->ToBeInlined = false;
+            if (IGC_IS_FLAG_ENABLED(EnableInlineCostModel) && IGC_IS_FLAG_ENABLED(DumpInlineCostModel)) {
+                std::stringstream FileName;
+                FileName << IGC::Debug::GetShaderOutputFolder() << "InlineCostModel.txt";
+                std::ofstream Dump(FileName.str(), std::ios::app);
+                Dump << "trim " << FunctionToRemove->F->getName().str()
+                     << " from " << Kernel->F->getName().str()
+                     << " kernelSize=" << KernelSize << std::endl;
+            }
             // TrimmingCandidates[FunctionToRemove->F] = true;
             if ( ( IGC_GET_FLAG_VALUE( PrintControlKernelTotalSize ) & 0x4 ) != 0 ) {
                 std::cout << "FunctionToRemove " << FunctionToRemove->F->getName().str() <<  " initSize "<< FunctionToRemove->InitialSize << " #callers " << FunctionToRemove->CallerList.size() << std::endl;
@@ -782,6 +819,77 @@ size_t EstimateFunctionSize::findKernelTotalSize(llvm::Function* Kernel, uint32_
     return k->Size;
 }
 
+// Estimate, in instructions, what is gained by keeping F as a subroutine:
+//
+//  + code footprint: every call site but one gets a copy when inlined,
+//  + callee GRF pressure: inlining a high pressure callee makes each of its
+//    callers high pressure too, beyond the GRFs available to it,
+//  - call overhead: branch, argument and return value moves, paid on every
+//    execution of the call, weighted by the loop depth of the call site,
+//  - specialization: constant arguments fold once the callee is inlined.
+//    Uniformity is not known this early, so constants stand in for the
+//    uniform arguments inlining would otherwise expose.
+int64_t EstimateFunctionSize::getOutlineScore(llvm::Function* F) {
+    FunctionNode* Node = get<FunctionNode>(F);
+    if (Node->HasOutlineScore)
+        return Node->OutlineScore;
+
+    const int64_t CallOverhead = 4;
+    const int64_t ConstArgBenefit = 2;
+    const uint32_t GRFPressureLimit = 96;
+
+    int64_t NumCallSites = 0;
+    int64_t CallCost = 0;
+    int64_t SpecCost = 0;
+    for (auto U : F->users()) {
+        auto* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != F)
+            continue;
+        ++NumCallSites;
+        Function* Caller = CI->getFunction();
+        LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>(*Caller).getLoopInfo();
+        unsigned Depth = std::min(LI.getLoopDepth(CI->getParent()), 4u);
+        int64_t Freq = int64_t(1) << (3 * Depth);
+
+        int64_t NumConstArgs = 0;
+        for (auto& Arg : CI->arg_operands()) {
+            if (isa<Constant>(Arg))
+                ++NumConstArgs;
+        }
+        CallCost += Freq * (CallOverhead + CI->getNumArgOperands());
+        SpecCost += Freq * NumConstArgs * ConstArgBenefit;
+    }
+
+    int64_t Footprint = std::max<int64_t>(NumCallSites - 1, 0) * int64_t(Node->Size);
+
+    RegisterEstimator& RPE = getAnalysis<RegisterEstimator>(*F);
+    RPE.calculate();
+    uint32_t MaxGRF = 0;
+    for (auto& BB : *F)
+        MaxGRF = std::max(MaxGRF, RPE.getMaxLiveGRFAtBB(&BB));
+    int64_t Pressure = MaxGRF > GRFPressureLimit ?
+        int64_t(MaxGRF - GRFPressureLimit) * NumCallSites : 0;
+
+    Node->OutlineScore = Footprint + Pressure - CallCost - SpecCost;
+    Node->HasOutlineScore = true;
+
+    if (IGC_IS_FLAG_ENABLED(DumpInlineCostModel)) {
+        std::stringstream FileName;
+        FileName << IGC::Debug::GetShaderOutputFolder() << "InlineCostModel.txt";
+        std::ofstream Dump(FileName.str(), std::ios::app);
+        Dump << F->getName().str()
+             << " size=" << Node->Size
+             << " callsites=" << NumCallSites
+             << " footprint=" << Footprint
+             << " maxGRF=" << MaxGRF
+             << " pressure=" << Pressure
+             << " callCost=" << CallCost
+             << " specCost=" << SpecCost
+             << " score=" << Node->OutlineScore << std::endl;
+    }
+    return Node->OutlineScore;
+}
+
 bool EstimateFunctionSize::isTrimmedFunction( llvm::Function* F) {
     return get<FunctionNode>(F)->ToBeInlined == false;
 }
@@ -63,6 +63,9 @@ namespace IGC {
         bool funcIsGoodtoTrim( llvm::Function* F );
         void reduceKernelSize();
         size_t findKernelTotalSize(llvm::Function* Kernel, uint32_t uk, uint32_t &up);
+        /// \brief Benefit of keeping F as a subroutine rather than inlining it,
+        /// in estimated instructions; higher is trimmed first.
+        int64_t getOutlineScore(llvm::Function* F);
 
         /// \brief Return the associated opaque data.
         template <typename T> T* get(llvm::Function* F) {
@@ -650,7 +650,10 @@ void GenXFunctionGroupAnalysis::addIndirectFuncsToKernelGroup(llvm::Module* pMod
 }
 
 bool GenXFunctionGroupAnalysis::rebuild(llvm::Module* Mod) {
+    // Rebuilding groups doesn't change the uniformity across call sites.
+    auto UniformDeps = std::move(SubroutineUniformDeps);
     clear();
+    SubroutineUniformDeps = std::move(UniformDeps);
     auto pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
 
     // Re-add all indirect functions to the default kernel group
@@ -751,6 +754,7 @@ void GenXFunctionGroupAnalysis::clear()
         delete* I;
     Groups.clear();
     IndirectCallGroup = nullptr;
+    SubroutineUniformDeps.clear();
     M = nullptr;
 }
 
@@ -181,6 +181,10 @@ namespace IGC {
         /// \brief Special group that contains indirect call functions and the dummy kernel
         FunctionGroup* IndirectCallGroup = nullptr;
 
+        /// \brief Uniform work-item dependency of subroutine arguments and
+        /// return values (keyed by the function), which holds at all call sites.
+        llvm::DenseMap<const llvm::Value*, uint8_t> SubroutineUniformDeps;
+
     public:
         static char ID;
         explicit GenXFunctionGroupAnalysis();
@@ -277,6 +281,22 @@ namespace IGC {
             }
         }
 
+        /// \brief Get the uniform dependency propagated into subroutine argument
+        /// V, or out of subroutine V as return value. Return false if unknown.
+        bool getSubroutineUniformDep(const llvm::Value* V, uint8_t& Dep) const {
+            auto I = SubroutineUniformDeps.find(V);
+            if (I == SubroutineUniformDeps.end())
+                return false;
+            Dep = I->second;
+            return true;
+        }
+        const llvm::DenseMap<const llvm::Value*, uint8_t>& getSubroutineUniformDeps() const {
+            return SubroutineUniformDeps;
+        }
+        void setSubroutineUniformDeps(const llvm::DenseMap<const llvm::Value*, uint8_t>& Deps) {
+            SubroutineUniformDeps = Deps;
+        }
+
         /// check if function is stack-called
         bool useStackCall(llvm::Function* F);
 
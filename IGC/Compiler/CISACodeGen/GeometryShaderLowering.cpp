@@ -21,6 +21,8 @@ SPDX-License-Identifier: MIT
 #include "Compiler/InitializePasses.h"
 #include "Probe/Assertion.h"
 
+#include <algorithm>
+
 /***********************************************************************************
 This file will lower GS input intrinsics to URBRead instructions.
 It will also lower higher-level GS output intrinsics (OUTPUTGS, GsCutControlHeader)
@@ -663,6 +665,16 @@ void GeometryShaderLowering::LowerControlHeader(llvm::Instruction* inst)
         const uint numWrites = m_gsProps->GetProperties().Output().ControlDataHeaderSize().Count();
         const uint maxWriteSize = 8;
 
+        // Only the bits of vertices that can be emitted are read, the header
+        // dwords past them need not be written, e.g. a particle GS emitting
+        // four vertices only needs the first dword of cut bits.
+        const auto& output = m_gsProps->GetProperties().Output();
+        const unsigned int numVertices = output.HasNonstaticVertexCount() ?
+            output.MaxVertexCount() : output.ActualStaticVertexCount();
+        const unsigned int bitsPerVertex =
+            (output.ControlDataFormat() == USC::GFX3DSTATE_CONTROL_DATA_FORMAT_CUT) ? 1 : 2;
+        const unsigned int numValidDwords = std::max(1u, (numVertices * bitsPerVertex + 31) / 32);
+
         // issue each of the URB writes
         for (unsigned int i = 0; i < numWrites; ++i)
         {
@@ -681,11 +693,15 @@ void GeometryShaderLowering::LowerControlHeader(llvm::Instruction* inst)
                     else
                         data[k] = undef;    // the rest left undefined and safe some 'mov' instructions
                 }
-                else
+                else if (maxWriteSize * i + k < numValidDwords)
                 {
                     // need to bitcast to float since arguments of URB write expect float data - ugly
                     data[k] = irb.CreateBitCast(inst->getOperand(maxWriteSize * i + k), irb.getFloatTy());
                 }
+                else
+                {
+                    data[k] = undef;
+                }
             }
             // issue URB write
             Value* offsetVal = irb.getInt32(offset.Count());
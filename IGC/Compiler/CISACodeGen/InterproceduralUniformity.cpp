@@ -0,0 +1,229 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/CISACodeGen/InterproceduralUniformity.hpp"
+#include "Compiler/CISACodeGen/GenCodeGenModule.h"
+#include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/helper.h"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/IGCPassSupport.h"
+#include "AdaptorCommon/ImplicitArgs.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Analysis/PostDominators.h>
+#include "common/LLVMWarningsPop.hpp"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+namespace {
+
+    class InterproceduralUniformity : public ModulePass
+    {
+    public:
+        static char ID;
+
+        InterproceduralUniformity() : ModulePass(ID)
+        {
+            initializeInterproceduralUniformityPass(*PassRegistry::getPassRegistry());
+        }
+
+        StringRef getPassName() const override
+        {
+            return "InterproceduralUniformity";
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+            AU.addRequired<DominatorTreeWrapperPass>();
+            AU.addRequired<PostDominatorTreeWrapperPass>();
+            AU.addRequired<MetaDataUtilsWrapper>();
+            AU.addRequired<CodeGenContextWrapper>();
+            AU.addRequired<GenXFunctionGroupAnalysis>();
+        }
+
+        bool runOnModule(Module& M) override;
+
+    private:
+        typedef DenseMap<const Value*, uint8_t> DepMapTy;
+
+        bool isCandidate(Function* F) const;
+        bool isAnalyzed(Function* F) const;
+        bool update(Function& F, DepMapTy& Deps);
+
+        static void lower(DepMapTy& Deps, const Value* V, WIAnalysis::WIDependancy Dep, bool& Changed);
+
+        MetaDataUtils* m_pMdUtils = nullptr;
+        GenXFunctionGroupAnalysis* m_FGA = nullptr;
+    };
+
+} // namespace
+
+char InterproceduralUniformity::ID = 0;
+
+#define PASS_FLAG     "igc-interprocedural-uniformity"
+#define PASS_DESC     "Propagate uniformity across subroutine calls"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(InterproceduralUniformity, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(GenXFunctionGroupAnalysis)
+IGC_INITIALIZE_PASS_END(InterproceduralUniformity, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+ModulePass* IGC::createInterproceduralUniformityPass()
+{
+    return new InterproceduralUniformity();
+}
+
+// Only subroutines with all call sites known and using the subroutine calling
+// convention, i.e. arguments and return value copied through dedicated
+// variables, are considered.
+bool InterproceduralUniformity::isCandidate(Function* F) const
+{
+    if (F->isDeclaration() || isEntryFunc(m_pMdUtils, F) || isNonEntryMultirateShader(F) ||
+        !isAnalyzed(F))
+        return false;
+    if (!F->hasLocalLinkage() || F->hasFnAttribute("referenced-indirectly") ||
+        m_FGA->useStackCall(F) || !m_FGA->getGroup(F))
+        return false;
+    for (auto* U : F->users())
+    {
+        auto* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != F || !isAnalyzed(CI->getFunction()))
+            return false;
+    }
+    return true;
+}
+
+// Whether WIAnalysis runs on F, so that its call sites and returns are checked.
+bool InterproceduralUniformity::isAnalyzed(Function* F) const
+{
+    return !F->isDeclaration() && m_FGA->getGroup(F) &&
+        m_pMdUtils->findFunctionsInfoItem(F) != m_pMdUtils->end_FunctionsInfo();
+}
+
+void InterproceduralUniformity::lower(
+    DepMapTy& Deps, const Value* V, WIAnalysis::WIDependancy Dep, bool& Changed)
+{
+    auto I = Deps.find(V);
+    if (I == Deps.end())
+        return;
+    // Only uniform dependencies are tracked; anything else drops the entry.
+    if (!WIAnalysis::isDepUniform(Dep))
+    {
+        Deps.erase(I);
+        Changed = true;
+        return;
+    }
+    if (Dep > I->second)
+    {
+        I->second = Dep;
+        Changed = true;
+    }
+}
+
+// Run WIAnalysis on F under the current assumption and lower the dependencies
+// of arguments passed from F, and of the value returned by F.
+bool InterproceduralUniformity::update(Function& F, DepMapTy& Deps)
+{
+    auto* DT = &getAnalysis<DominatorTreeWrapperPass>(F).getDomTree();
+    auto* PDT = &getAnalysis<PostDominatorTreeWrapperPass>(F).getPostDomTree();
+    auto* CGCtx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    auto* ModMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+
+    TranslationTable TT;
+    TT.run(F);
+    WIAnalysisRunner WI(&F, DT, PDT, m_pMdUtils, CGCtx, ModMD, &TT);
+    WI.setSubroutineUniformDeps(&Deps);
+    WI.run();
+
+    bool Changed = false;
+    for (auto& I : instructions(F))
+    {
+        if (auto* CI = dyn_cast<CallInst>(&I))
+        {
+            Function* Callee = CI->getCalledFunction();
+            if (!Callee || Callee->isDeclaration())
+                continue;
+            unsigned i = 0;
+            for (auto& Arg : Callee->args())
+            {
+                if (i >= CI->getNumArgOperands())
+                    break;
+                lower(Deps, &Arg, WI.whichDepend(CI->getArgOperand(i++)), Changed);
+            }
+        }
+        else if (auto* RI = dyn_cast<ReturnInst>(&I))
+        {
+            Value* RV = RI->getReturnValue();
+            if (!RV)
+                continue;
+            // Lanes returning from divergent control-flow may return different
+            // values even if each of them is uniform.
+            lower(Deps, &F, WI.insideDivergentCF(RI) ? WIAnalysis::RANDOM : WI.whichDepend(RV), Changed);
+        }
+    }
+    return Changed;
+}
+
+bool InterproceduralUniformity::runOnModule(Module& M)
+{
+    if (IGC_IS_FLAG_ENABLED(DisableUniformAnalysis))
+        return false;
+
+    m_pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    m_FGA = &getAnalysis<GenXFunctionGroupAnalysis>();
+    if (!m_FGA->getModule())
+        return false;
+
+    // Start from the optimistic assumption that all explicit arguments and
+    // return values of subroutines are uniform, and lower them until the
+    // fixed point is reached. Dependencies only go down, so it converges.
+    DepMapTy Deps;
+    for (auto& F : M)
+    {
+        if (!isCandidate(&F))
+            continue;
+        ImplicitArgs implicitArgs(F, m_pMdUtils);
+        unsigned numExplicitArgs = unsigned(F.arg_size() - implicitArgs.size());
+        for (auto& Arg : F.args())
+        {
+            if (Arg.getArgNo() >= numExplicitArgs)
+                break;
+            Deps[&Arg] = WIAnalysis::UNIFORM_GLOBAL;
+        }
+        if (!F.getReturnType()->isVoidTy())
+            Deps[&F] = WIAnalysis::UNIFORM_GLOBAL;
+    }
+
+    bool Changed = !Deps.empty();
+    while (Changed)
+    {
+        Changed = false;
+        for (auto& F : M)
+        {
+            if (isAnalyzed(&F))
+                Changed |= update(F, Deps);
+        }
+    }
+
+    m_FGA->setSubroutineUniformDeps(Deps);
+    return false;
+}
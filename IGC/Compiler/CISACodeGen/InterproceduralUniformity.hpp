@@ -0,0 +1,30 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC {
+
+    /// \brief Propagate uniformity of subroutine arguments and return values
+    /// across call sites.
+    ///
+    /// WIAnalysis conservatively treats explicit arguments of subroutines as
+    /// random, so uniform values passed into a subroutine are widened to
+    /// SIMD-wide registers. This pass computes a call-graph level fixed point
+    /// over all subroutines (i.e. those with only direct calls and not using
+    /// stack calls): an argument is uniform if it is uniform at all call
+    /// sites, and a return value is uniform if it is uniform at all returns.
+    /// The result is recorded into GenXFunctionGroupAnalysis, from where both
+    /// WIAnalysis and the emitter pick it up.
+    llvm::ModulePass* createInterproceduralUniformityPass();
+
+} // namespace IGC
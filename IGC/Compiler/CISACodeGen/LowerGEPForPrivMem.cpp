@@ -240,6 +240,26 @@ static void GetAllocaLiverange(Instruction* I, unsigned int& liverangeStart, uns
     }
 }
 
+// Return true if any GEP derived from I (through GEPs and bitcasts) has a
+// non-constant index.
+static bool HasDynamicIndex(Instruction* I)
+{
+    for (auto* U : I->users())
+    {
+        if (auto* GEP = dyn_cast<GetElementPtrInst>(U))
+        {
+            if (!GEP->hasAllConstantIndices() || HasDynamicIndex(GEP))
+                return true;
+        }
+        else if (auto* BC = dyn_cast<BitCastInst>(U))
+        {
+            if (HasDynamicIndex(BC))
+                return true;
+        }
+    }
+    return false;
+}
+
 bool LowerGEPForPrivMem::IsNativeType(Type* type)
 {
     if ((type->isDoubleTy() && m_ctx->platform.hasNoFP64Inst()) ||
@@ -266,13 +286,14 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     float grfRatio = m_ctx->getNumGRFPerThread() / 128.0f;
     allowedAllocaSizeInBytes = (uint32_t)(allowedAllocaSizeInBytes * grfRatio);
 
+    // Scale alloca size for the SIMD size the function will be compiled at.
+    float simdRatio = 1.0f;
     if (m_ctx->type == ShaderType::COMPUTE_SHADER)
     {
         ComputeShaderContext* ctx = static_cast<ComputeShaderContext*>(m_ctx);
         SIMDMode simdMode = ctx->GetLeastSIMDModeAllowed();
-        unsigned d = simdMode == SIMDMode::SIMD32 ? 4 : 1;
-
-        allowedAllocaSizeInBytes = allowedAllocaSizeInBytes / d;
+        if (simdMode == SIMDMode::SIMD32)
+            simdRatio = 0.25f;
     }
     else if (m_ctx->type == ShaderType::OPENCL_SHADER)
     {
@@ -281,9 +302,11 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
         if (subGroupSize->hasValue())
         {
             auto simdSize = (uint32_t)subGroupSize->getSIMD_size();
-            allowedAllocaSizeInBytes = (allowedAllocaSizeInBytes * 8) / simdSize;
+            simdRatio = 8.0f / simdSize;
         }
     }
+    allowedAllocaSizeInBytes = (uint32_t)(allowedAllocaSizeInBytes * simdRatio);
+
     Type* baseType = nullptr;
     if (!CanUseSOALayout(pAlloca, baseType))
     {
@@ -293,6 +316,19 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     {
         return false;
     }
+
+    // Small lookup tables indexed dynamically would hit scratch on every
+    // access. Keep them in GRF, accessed through indirect addressing, as long
+    // as the estimated register pressure allows, regardless of the size
+    // threshold.
+    bool isSmallIndexedArray = false;
+    if (IGC_IS_FLAG_ENABLED(EnablePromoteSmallIndexedPrivArray) &&
+        HasDynamicIndex(pAlloca))
+    {
+        unsigned int baseSize = (unsigned int)m_pDL->getTypeAllocSize(baseType);
+        isSmallIndexedArray = baseSize != 0 &&
+            allocaSize / baseSize <= IGC_GET_FLAG_VALUE(PromoteSmallIndexedPrivArrayMaxElements);
+    }
     if (isUniformAlloca)
     {
         // Heuristic: for uniform alloca we divide the size by 8 to adjust the pressure
@@ -306,7 +342,7 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     }
 
     // if alloca size exceeds alloc size threshold, return false
-    if (allocaSize > allowedAllocaSizeInBytes)
+    if (allocaSize > allowedAllocaSizeInBytes && !isSmallIndexedArray)
     {
         return false;
     }
@@ -319,6 +355,12 @@ bool LowerGEPForPrivMem::CheckIfAllocaPromotable(llvm::AllocaInst* pAlloca)
     GetAllocaLiverange(pAlloca, lowestAssignedNumber, highestAssignedNumber, m_pRegisterPressureEstimate);
 
     uint32_t maxGRFPressure = (uint32_t)(grfRatio * MAX_PRESSURE_GRF_NUM * 4);
+    if (isSmallIndexedArray)
+    {
+        // The size threshold is bypassed, so the pressure budget has to
+        // account for the SIMD size instead.
+        maxGRFPressure = (uint32_t)(maxGRFPressure * simdRatio);
+    }
 
     unsigned int pressure = 0;
     for (unsigned int i = lowestAssignedNumber; i <= highestAssignedNumber; i++)
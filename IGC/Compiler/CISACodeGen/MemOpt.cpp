@@ -13,10 +13,13 @@ SPDX-License-Identifier: MIT
 #include <llvmWrapper/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/InstructionSimplify.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/Analysis/ScalarEvolutionExpressions.h>
 #include <llvm/Analysis/ValueTracking.h>
 #include <llvm/IR/DataLayout.h>
+#include <llvm/IR/Dominators.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/GlobalAlias.h>
 #include <llvm/IR/IRBuilder.h>
@@ -57,6 +60,12 @@ namespace {
     //   the non-tailing store is merged into the tailing one, iff there's no
     //   memory dependency between them which may results in different result.
     //
+    // Optionally (EnableMemOptCrossBB), loads/stores are also merged across a
+    // pair of control-equivalent BBs, i.e. BB A and its immediate
+    // post-dominator J which is dominated by A and in the same loop. Memory
+    // references from BBs in between A and J are only checked for dependency
+    // but never merged as they are conditionally executed.
+    //
     class MemOpt : public FunctionPass {
         const DataLayout* DL;
         AliasAnalysis* AA;
@@ -65,6 +74,31 @@ namespace {
 
         CodeGenContext* CGC;
         TargetLibraryInfo* TLI;
+        DominatorTree* DT;
+        PostDominatorTree* PDT;
+        LoopInfo* LI;
+
+        // Memory references which are only checked for dependency, i.e. from
+        // BBs in between a control-equivalent BB pair.
+        SmallPtrSet<Instruction*, 32> NonMergeable;
+
+        // Index of memory references (within a list of memory references) per
+        // base pointer. Each group lists, in the program order, references to
+        // that base together with references which may alias with it, so that
+        // merge candidates are searched without scanning unrelated ones.
+        struct MemRefIndex {
+            // Group of each memory reference.
+            std::vector<unsigned> GroupOf;
+            // Position of each memory reference in its own group.
+            std::vector<unsigned> PosInGroup;
+            // Memory references relevant to each group.
+            std::vector<SmallVector<unsigned, 16> > Refs;
+        };
+        MemRefIndex* Index = nullptr;
+
+        // Maximal number of base pointers indexed. Beyond that, fall back to
+        // the window-based scan.
+        static const unsigned MaxIndexedBases = 64;
 
         bool AllowNegativeSymPtrsForLoad = false;
 
@@ -83,7 +117,8 @@ namespace {
 
         MemOpt(bool AllowNegativeSymPtrsForLoad = false) :
             FunctionPass(ID), DL(nullptr), AA(nullptr), SE(nullptr), WI(nullptr),
-            CGC(nullptr), AllowNegativeSymPtrsForLoad(AllowNegativeSymPtrsForLoad) {
+            CGC(nullptr), TLI(nullptr), DT(nullptr), PDT(nullptr), LI(nullptr),
+            AllowNegativeSymPtrsForLoad(AllowNegativeSymPtrsForLoad) {
             initializeMemOptPass(*PassRegistry::getPassRegistry());
         }
 
@@ -98,10 +133,30 @@ namespace {
             AU.addRequired<TargetLibraryInfoWrapperPass>();
             AU.addRequired<ScalarEvolutionWrapperPass>();
             AU.addRequired<WIAnalysis>();
+            if (IGC_IS_FLAG_ENABLED(EnableMemOptCrossBB)) {
+                AU.addRequired<DominatorTreeWrapperPass>();
+                AU.addRequired<PostDominatorTreeWrapperPass>();
+                AU.addRequired<LoopInfoWrapperPass>();
+            }
         }
 
         void buildProfitVectorLengths(Function& F);
 
+        bool optimizeMemRefs(MemRefListTy& MemRefs, const BasicBlock* LeadingBB);
+        bool collectCrossBBMemRefs(BasicBlock* BB, MemRefListTy& MemRefs);
+        bool buildMemRefIndex(MemRefListTy& MemRefs, MemRefIndex& Idx);
+
+        /// Return the next memory reference to be scanned after MI.
+        MemRefListTy::iterator nextMemRef(MemRefListTy& MemRefs,
+            MemRefListTy::iterator MI, unsigned Group, unsigned& Pos) const {
+            if (!Index)
+                return ++MI;
+            const auto& Refs = Index->Refs[Group];
+            if (++Pos >= Refs.size())
+                return MemRefs.end();
+            return MemRefs.begin() + Refs[Pos];
+        }
+
         bool mergeLoad(LoadInst* LeadingLoad, MemRefListTy::iterator MI,
             MemRefListTy& MemRefs, TrivialMemRefListTy& ToOpt);
         bool mergeStore(StoreInst* LeadingStore, MemRefListTy::iterator MI,
@@ -392,6 +447,9 @@ IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_DEPENDENCY(AAResultsWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(TargetLibraryInfoWrapperPass)
 IGC_INITIALIZE_PASS_DEPENDENCY(WIAnalysis)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
 IGC_INITIALIZE_PASS_END(MemOpt, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
 
 char MemOpt::ID = 0;
@@ -445,7 +503,6 @@ bool MemOpt::runOnFunction(Function& F) {
         // Find all instructions with memory reference. Remember the distance one
         // by one.
         MemRefListTy MemRefs;
-        TrivialMemRefListTy MemRefsToOptimize;
         unsigned Distance = 0;
         for (auto BI = BB->begin(), BE = BB->end(); BI != BE; ++BI, ++Distance) {
             Instruction* I = &(*BI);
@@ -459,28 +516,25 @@ bool MemOpt::runOnFunction(Function& F) {
         if (MemRefs.size() < 2)
             continue;
 
-        // Canonicalize 64-bit GEP to help SCEV find constant offset by
-        // distributing `zext`/`sext` over safe expressions.
-        for (auto& M : MemRefs)
-            Changed |= canonicalizeGEP64(M.first);
+        Changed |= optimizeMemRefs(MemRefs, nullptr);
+    }
 
-        for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
-            Instruction* I = MI->first;
+    if (IGC_IS_FLAG_ENABLED(EnableMemOptCrossBB)) {
+        DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+        PDT = &getAnalysis<PostDominatorTreeWrapperPass>().getPostDomTree();
+        LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
 
-            // Skip already merged one.
-            if (!I)
+        for (auto& BB : F) {
+            MemRefListTy MemRefs;
+            if (!collectCrossBBMemRefs(&BB, MemRefs))
                 continue;
-
-            if (LoadInst * LI = dyn_cast<LoadInst>(I))
-                Changed |= mergeLoad(LI, MI, MemRefs, MemRefsToOptimize);
-            else if (StoreInst * SI = dyn_cast<StoreInst>(I))
-                Changed |= mergeStore(SI, MI, MemRefs, MemRefsToOptimize);
+            Changed |= optimizeMemRefs(MemRefs, &BB);
+            NonMergeable.clear();
         }
 
-        // Optimize 64-bit GEP to reduce strength by factoring out `zext`/`sext`
-        // over safe expressions.
-        for (auto I : MemRefsToOptimize)
-            Changed |= optimizeGEP64(I);
+        DT = nullptr;
+        PDT = nullptr;
+        LI = nullptr;
     }
 
     DL = nullptr;
@@ -490,6 +544,192 @@ bool MemOpt::runOnFunction(Function& F) {
     return Changed;
 }
 
+/// optimizeMemRefs() - merge loads/stores in the given list of memory
+/// references. If LeadingBB is specified, only memory references from that BB
+/// are considered as the leading load or store.
+bool MemOpt::optimizeMemRefs(MemRefListTy& MemRefs, const BasicBlock* LeadingBB) {
+    bool Changed = false;
+    TrivialMemRefListTy MemRefsToOptimize;
+
+    // Canonicalize 64-bit GEP to help SCEV find constant offset by
+    // distributing `zext`/`sext` over safe expressions.
+    for (auto& M : MemRefs)
+        Changed |= canonicalizeGEP64(M.first);
+
+    MemRefIndex Idx;
+    if (IGC_IS_FLAG_ENABLED(EnableMemOptBaseIndex) && buildMemRefIndex(MemRefs, Idx))
+        Index = &Idx;
+
+    for (auto MI = MemRefs.begin(), ME = MemRefs.end(); MI != ME; ++MI) {
+        Instruction* I = MI->first;
+
+        // Skip already merged one.
+        if (!I)
+            continue;
+
+        // Memory references from the leading BB come first.
+        if (LeadingBB && I->getParent() != LeadingBB)
+            break;
+
+        if (LoadInst * LI = dyn_cast<LoadInst>(I))
+            Changed |= mergeLoad(LI, MI, MemRefs, MemRefsToOptimize);
+        else if (StoreInst * SI = dyn_cast<StoreInst>(I))
+            Changed |= mergeStore(SI, MI, MemRefs, MemRefsToOptimize);
+    }
+
+    Index = nullptr;
+
+    // Optimize 64-bit GEP to reduce strength by factoring out `zext`/`sext`
+    // over safe expressions.
+    for (auto I : MemRefsToOptimize)
+        Changed |= optimizeGEP64(I);
+
+    return Changed;
+}
+
+/// collectCrossBBMemRefs() - collect memory references from BB, BBs in
+/// between BB and its control-equivalent successor, and that successor. The
+/// distance keeps accumulating so that the window size still applies. Return
+/// false if there's no such successor or nothing to merge across BBs.
+bool MemOpt::collectCrossBBMemRefs(BasicBlock* BB, MemRefListTy& MemRefs) {
+    DomTreeNode* Node = PDT->getNode(BB);
+    if (!Node || !Node->getIDom())
+        return false;
+    BasicBlock* Join = Node->getIDom()->getBlock();
+    // Skip the virtual exit node and successors not executed the same number
+    // of times as BB.
+    if (!Join || Join == BB || !DT->dominates(BB, Join) ||
+        LI->getLoopFor(BB) != LI->getLoopFor(Join))
+        return false;
+
+    // Collect BBs in between. As their memory references are only checked
+    // for dependency, the order among them doesn't matter.
+    SmallVector<BasicBlock*, 8> Between;
+    SmallPtrSet<BasicBlock*, 8> Visited;
+    SmallVector<BasicBlock*, 8> Worklist(succ_begin(BB), succ_end(BB));
+    while (!Worklist.empty()) {
+        BasicBlock* Succ = Worklist.pop_back_val();
+        if (Succ == Join || !Visited.insert(Succ).second)
+            continue;
+        // Bail out if BB is reached again without passing the join BB.
+        if (Succ == BB)
+            return false;
+        Between.push_back(Succ);
+        Worklist.append(succ_begin(Succ), succ_end(Succ));
+    }
+
+    unsigned Distance = 0;
+    unsigned NumInBB = 0, NumInJoin = 0;
+    auto collect = [&](BasicBlock* B, bool IsMergeable) {
+        unsigned Count = 0;
+        for (auto& I : *B) {
+            ++Distance;
+            if (shouldSkip(&I))
+                continue;
+            MemRefs.push_back(std::make_pair(&I, Distance));
+            if (!IsMergeable)
+                NonMergeable.insert(&I);
+            ++Count;
+        }
+        return Count;
+    };
+
+    NumInBB = collect(BB, true);
+    for (auto* B : Between)
+        collect(B, false);
+    NumInJoin = collect(Join, true);
+
+    if (NumInBB == 0 || NumInJoin == 0) {
+        NonMergeable.clear();
+        MemRefs.clear();
+        return false;
+    }
+    return true;
+}
+
+/// buildMemRefIndex() - group memory references by their base pointers, i.e.
+/// the pointer base of their SCEVs. References not through a pointer operand
+/// (calls, intrinsics, etc.) are relevant to all groups. Return false if
+/// there are too many base pointers to be indexed.
+bool MemOpt::buildMemRefIndex(MemRefListTy& MemRefs, MemRefIndex& Idx) {
+    const unsigned Unknown = ~0U;
+    SmallVector<std::pair<Value*, unsigned>, 8> Bases;
+    DenseMap<std::pair<Value*, unsigned>, unsigned> BaseMap;
+
+    Idx.GroupOf.assign(MemRefs.size(), Unknown);
+    for (unsigned i = 0, e = MemRefs.size(); i != e; ++i) {
+        Instruction* I = MemRefs[i].first;
+        Value* Ptr = nullptr;
+        if (LoadInst* LD = dyn_cast<LoadInst>(I))
+            Ptr = LD->getPointerOperand();
+        else if (StoreInst* ST = dyn_cast<StoreInst>(I))
+            Ptr = ST->getPointerOperand();
+        if (!Ptr)
+            continue;
+
+        const SCEV* Base = SE->getPointerBase(SE->getSCEV(Ptr));
+        const SCEVUnknown* U = dyn_cast<SCEVUnknown>(Base);
+        if (!U)
+            continue;
+        // Pointers from constant addresses, e.g. SLM pointers from `inttoptr`,
+        // share one group per address space.
+        Value* BasePtr = U->getValue();
+        if (isa<Constant>(BasePtr) && !isa<GlobalValue>(BasePtr))
+            BasePtr = nullptr;
+        auto Key = std::make_pair(BasePtr, Ptr->getType()->getPointerAddressSpace());
+        auto BI = BaseMap.find(Key);
+        if (BI == BaseMap.end()) {
+            if (Bases.size() == MaxIndexedBases)
+                return false;
+            BI = BaseMap.insert(std::make_pair(Key, unsigned(Bases.size()))).first;
+            Bases.push_back(Key);
+        }
+        Idx.GroupOf[i] = BI->second;
+    }
+
+    // Check whether two groups may alias once per pair of bases.
+    unsigned NumBases = Bases.size();
+    std::vector<bool> MayAlias(NumBases * NumBases, true);
+    for (unsigned i = 0; i != NumBases; ++i) {
+        for (unsigned j = i + 1; j != NumBases; ++j) {
+            Value* A = Bases[i].first;
+            Value* B = Bases[j].first;
+            if (!A || !B)
+                continue;
+            bool R = AA->alias(MemoryLocation(A, LocationSize::unknown()),
+                MemoryLocation(B, LocationSize::unknown())) != NoAlias;
+            MayAlias[i * NumBases + j] = MayAlias[j * NumBases + i] = R;
+        }
+    }
+
+    Idx.PosInGroup.assign(MemRefs.size(), 0);
+    Idx.Refs.assign(NumBases, SmallVector<unsigned, 16>());
+    for (unsigned i = 0, e = MemRefs.size(); i != e; ++i) {
+        unsigned G = Idx.GroupOf[i];
+        if (G == Unknown) {
+            for (auto& Refs : Idx.Refs)
+                Refs.push_back(i);
+            continue;
+        }
+        for (unsigned j = 0; j != NumBases; ++j) {
+            if (j == G) {
+                Idx.PosInGroup[i] = Idx.Refs[j].size();
+                Idx.Refs[j].push_back(i);
+            }
+            else if (MayAlias[G * NumBases + j])
+                Idx.Refs[j].push_back(i);
+        }
+    }
+
+    // Only loads/stores are leading ones and have their own groups. Map the
+    // other ones to the first group; they are never scanned from.
+    for (auto& G : Idx.GroupOf)
+        if (G == Unknown)
+            G = 0;
+
+    return NumBases != 0;
+}
+
 bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     MemRefListTy::iterator aMI, MemRefListTy& MemRefs,
     TrivialMemRefListTy& ToOpt)
@@ -581,9 +821,15 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
     const unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
     // Given the Start position of the Window is MI->second,
     // the End postion of the Window is "limit + Windows' start".
-    const unsigned windowEnd = Limit + MI->second;
+    // With the base pointer index, only memory references to the same base or
+    // those which may alias with it are scanned, and no window is applied.
+    const unsigned windowEnd = Index ? UINT_MAX : Limit + MI->second;
+    const unsigned Group = Index ? Index->GroupOf[MI - MemRefs.begin()] : 0;
+    unsigned IdxPos = Index ? Index->PosInGroup[MI - MemRefs.begin()] : 0;
     auto ME = MemRefs.end();
-    for (++MI; MI != ME && MI->second <= windowEnd; ++MI) {
+    for (MI = nextMemRef(MemRefs, MI, Group, IdxPos);
+        MI != ME && MI->second <= windowEnd;
+        MI = nextMemRef(MemRefs, MI, Group, IdxPos)) {
         Instruction* NextMemRef = MI->first;
         // Skip already merged one.
         if (!NextMemRef)
@@ -591,6 +837,10 @@ bool MemOpt::mergeLoad(LoadInst* LeadingLoad,
 
         CheckList.push_back(NextMemRef);
 
+        // Only check the dependency on conditionally executed ones.
+        if (NonMergeable.count(NextMemRef))
+            continue;
+
         LoadInst* NextLoad = dyn_cast<LoadInst>(NextMemRef);
 
         // Skip non-load instruction.
@@ -1049,9 +1299,15 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
     const unsigned Limit = IGC_GET_FLAG_VALUE(MemOptWindowSize);
     // Given the Start position of the Window is MI->second,
     // the End postion of the Window is "limit + Windows' start".
-    const unsigned windowEnd = Limit + MI->second;
+    // With the base pointer index, only memory references to the same base or
+    // those which may alias with it are scanned, and no window is applied.
+    const unsigned windowEnd = Index ? UINT_MAX : Limit + MI->second;
+    const unsigned Group = Index ? Index->GroupOf[MI - MemRefs.begin()] : 0;
+    unsigned IdxPos = Index ? Index->PosInGroup[MI - MemRefs.begin()] : 0;
     auto ME = MemRefs.end();
-    for (++MI; MI != ME && MI->second <= windowEnd; ++MI) {
+    for (MI = nextMemRef(MemRefs, MI, Group, IdxPos);
+        MI != ME && MI->second <= windowEnd;
+        MI = nextMemRef(MemRefs, MI, Group, IdxPos)) {
         Instruction* NextMemRef = MI->first;
         // Skip already merged one.
         if (!NextMemRef)
@@ -1059,6 +1315,10 @@ bool MemOpt::mergeStore(StoreInst* LeadingStore,
 
         CheckList.push_back(NextMemRef);
 
+        // Only check the dependency on conditionally executed ones.
+        if (NonMergeable.count(NextMemRef))
+            continue;
+
         StoreInst* NextStore = dyn_cast<StoreInst>(NextMemRef);
         // Skip non-store instruction.
         if (!NextStore)
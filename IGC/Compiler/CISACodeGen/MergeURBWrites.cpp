@@ -11,7 +11,9 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/Pass.h>
 #include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Instruction.h>
+#include <llvm/IR/Instructions.h>
 #include <llvm/IR/IntrinsicInst.h>
 #include <llvm/IR/Constants.h>
 #include "common/LLVMWarningsPop.hpp"
@@ -20,6 +22,8 @@ SPDX-License-Identifier: MIT
 #include "Probe/Assertion.h"
 #include "IGCPassSupport.h"
 
+#include <algorithm>
+
 namespace IGC
 {
 using namespace llvm;
@@ -69,6 +73,11 @@ public:
     virtual llvm::StringRef getPassName() const { return "MergeURBWrites"; }
 
 private:
+    /// Moves constant offset writes out of the "then" block of an if-then
+    /// into its join block when the join block writes the same or an
+    /// adjacent offset, so that the per-BB merging can combine them.
+    bool SinkConditionalWrites(Function& F);
+
     /// Stores all URB write instructions in a vector.
     /// Also merges partial (channel granularity) writes to the same offset.
     void FillWriteList(BasicBlock& BB);
@@ -93,6 +102,9 @@ private:
     std::map<std::pair<Value*, unsigned int>, InstWithIndex> m_writeList;
 
     bool m_bbModified;
+    // false if the retry manager disallows 8-channel writes, which need
+    // twice the payload registers
+    bool m_allowLargeWrite = true;
 };
 
 char MergeURBWrites::ID = 0;
@@ -115,6 +127,10 @@ static unsigned int GetChannelMask(CallInst* inst)
 /// In the second phase, we go through the index list and replace two writes at adjacent
 /// locations with one.
 ///
+/// In vertex and geometry shaders, writes in the "then" block of an if-then are
+/// first sunk into the join block (see SinkConditionalWrites()) so that they
+/// can be merged with the writes there.
+///
 /// for now, we don't handle the following cases:
 /// 1) channel mask is a runtime value
 /// 2) handling of writes of size >4
@@ -123,7 +139,15 @@ static unsigned int GetChannelMask(CallInst* inst)
 ///
 bool MergeURBWrites::runOnFunction(Function& F)
 {
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    m_allowLargeWrite = ctx->m_retryManager.AllowLargeURBWrite();
+
     bool fModified = false;
+    if (ctx->type == ShaderType::VERTEX_SHADER ||
+        ctx->type == ShaderType::GEOMETRY_SHADER)
+    {
+        fModified |= SinkConditionalWrites(F);
+    }
     for (auto& BB : F)
     {
         FillWriteList(BB);
@@ -220,10 +244,128 @@ void MergeURBWrites::FillWriteList(BasicBlock& BB)
     }
 } // FillWriteList()
 
+bool MergeURBWrites::SinkConditionalWrites(Function& F)
+{
+    // Sinking a write past the branch makes it unconditional, with undef data
+    // when the "then" block is not executed. That only keeps the semantics if
+    // no other write to the same offset can be overwritten and nobody reads
+    // the outputs back, so bail out on dynamic offsets, output reads and
+    // barriers.
+    std::map<unsigned int, SmallVector<CallInst*, 2>> writesAtOffset;
+    for (auto& BB : F)
+    {
+        for (auto& I : BB)
+        {
+            auto intrinsic = dyn_cast<GenIntrinsicInst>(&I);
+            if (intrinsic == nullptr) continue;
+
+            GenISAIntrinsic::ID IID = intrinsic->getIntrinsicID();
+            if ((IID == GenISAIntrinsic::GenISA_URBReadOutput) ||
+                (IID == GenISAIntrinsic::GenISA_threadgroupbarrier))
+            {
+                return false;
+            }
+            if (IID != GenISAIntrinsic::GenISA_URBWrite)
+            {
+                continue;
+            }
+            std::pair<Value*, unsigned int> baseAndOffset =
+                GetBaseAndOffset(intrinsic->getOperand(0));
+            if (baseAndOffset.first != nullptr)
+            {
+                return false;
+            }
+            writesAtOffset[baseAndOffset.second].push_back(intrinsic);
+        }
+    }
+
+    bool changed = false;
+    for (auto& thenBB : F)
+    {
+        // match: pred -> { thenBB -> joinBB, joinBB }
+        BasicBlock* predBB = thenBB.getSinglePredecessor();
+        BasicBlock* joinBB = thenBB.getSingleSuccessor();
+        if (predBB == nullptr || joinBB == nullptr || joinBB == &thenBB ||
+            !joinBB->hasNPredecessors(2))
+        {
+            continue;
+        }
+        auto branch = dyn_cast<BranchInst>(predBB->getTerminator());
+        if (branch == nullptr || !branch->isConditional() ||
+            (branch->getSuccessor(0) != joinBB && branch->getSuccessor(1) != joinBB))
+        {
+            continue;
+        }
+
+        auto isInThenOrJoin = [&](CallInst* write)
+        {
+            return write->getParent() == &thenBB || write->getParent() == joinBB;
+        };
+        auto hasWriteInJoin = [&](unsigned int offset)
+        {
+            auto it = writesAtOffset.find(offset);
+            if (it == writesAtOffset.end()) return false;
+            for (CallInst* write : it->second)
+            {
+                if (write->getParent() == joinBB) return true;
+            }
+            return false;
+        };
+
+        SmallVector<CallInst*, 4> toSink;
+        for (auto& I : thenBB)
+        {
+            auto intrinsic = dyn_cast<GenIntrinsicInst>(&I);
+            if (intrinsic == nullptr ||
+                intrinsic->getIntrinsicID() != GenISAIntrinsic::GenISA_URBWrite ||
+                !isa<ConstantInt>(intrinsic->getOperand(1)) ||
+                GetChannelMask(intrinsic) > 0x0F)
+            {
+                continue;
+            }
+            unsigned int offset = GetBaseAndOffset(intrinsic->getOperand(0)).second;
+            auto& writes = writesAtOffset[offset];
+            if (!std::all_of(writes.begin(), writes.end(), isInThenOrJoin))
+            {
+                continue;
+            }
+            // only sink if a message is saved in the join block
+            if (hasWriteInJoin(offset) ||
+                (offset > 0 && hasWriteInJoin(offset - 1)) ||
+                hasWriteInJoin(offset + 1))
+            {
+                toSink.push_back(intrinsic);
+            }
+        }
+
+        // keep the relative order of the sunk writes, ahead of the join
+        // block's own writes
+        Instruction* insertPt = &*joinBB->getFirstInsertionPt();
+        for (CallInst* write : toSink)
+        {
+            for (unsigned int i = 2; i < write->getNumArgOperands(); ++i)
+            {
+                auto data = dyn_cast<Instruction>(write->getOperand(i));
+                if (data == nullptr || data->getParent() != &thenBB)
+                {
+                    continue;
+                }
+                PHINode* phi = PHINode::Create(data->getType(), 2, "", &joinBB->front());
+                phi->addIncoming(data, &thenBB);
+                phi->addIncoming(UndefValue::get(data->getType()), predBB);
+                write->setOperand(i, phi);
+            }
+            write->moveBefore(insertPt);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
 void MergeURBWrites::MergeInstructions()
 {
     // nothing to do for an empty list
-    if (m_writeList.size() == 0)
+    if (m_writeList.size() == 0 || !m_allowLargeWrite)
     {
         return;
     }
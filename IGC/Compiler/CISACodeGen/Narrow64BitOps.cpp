@@ -0,0 +1,271 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+//
+// On platforms without native 64-bit integer support, every i64 operation is
+// emulated by Emu64OpsPass with several 32-bit instructions, and divisions
+// with a whole subroutine. Most of these operations are address and index
+// computations whose values fit in 32 bits. This pass computes value ranges
+// of i64 integers and rewrites the operations that provably don't need the
+// high half to their 32-bit counterparts, extended back to i64:
+//
+//   %r = add i64 %a, %b   =>   %r32 = add i32 (trunc %a), (trunc %b)
+//                              %r = zext i32 %r32 to i64
+//
+// Add, sub, mul, shl and bitwise operations only depend on the low 32 bits of
+// their operands, so they are narrowed when the range of their result fits.
+// Divisions, remainders, right shifts and compares are narrowed when their
+// operands fit.
+//
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/ConstantRange.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/KnownBits.h"
+#include "common/LLVMWarningsPop.hpp"
+#include "Compiler/CISACodeGen/Narrow64BitOps.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Probe/Assertion.h"
+
+using namespace llvm;
+
+namespace {
+
+    class Narrow64BitOps : public FunctionPass {
+    public:
+        static char ID;
+
+        Narrow64BitOps() : FunctionPass(ID) {
+            initializeNarrow64BitOpsPass(*PassRegistry::getPassRegistry());
+        }
+
+        bool runOnFunction(Function& F) override;
+
+        StringRef getPassName() const override { return "Narrow64BitOps"; }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesCFG();
+        }
+
+    private:
+        ConstantRange getRange(Value* V, unsigned Depth = 0);
+        bool narrow(Instruction* I);
+        Value* getLow(IRBuilder<>& IRB, Value* V);
+
+        static bool fitsUnsigned(const ConstantRange& R) {
+            return R.getUnsignedMax().getActiveBits() <= 32;
+        }
+        static bool fitsSigned(const ConstantRange& R) {
+            return R.getSignedMin().getMinSignedBits() <= 32 &&
+                R.getSignedMax().getMinSignedBits() <= 32;
+        }
+
+        const DataLayout* DL = nullptr;
+        DenseMap<Value*, ConstantRange> Ranges;
+    };
+
+} // End anonymous namespace
+
+char Narrow64BitOps::ID = 0;
+
+#define PASS_FLAG     "igc-narrow-64bit-ops"
+#define PASS_DESC     "Narrow 64-bit integer operations to 32 bits based on value ranges"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(Narrow64BitOps, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_END(Narrow64BitOps, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+FunctionPass* createNarrow64BitOpsPass() {
+    return new Narrow64BitOps();
+}
+
+ConstantRange Narrow64BitOps::getRange(Value* V, unsigned Depth) {
+    const unsigned MaxDepth = 8;
+    unsigned BitWidth = V->getType()->getIntegerBitWidth();
+
+    if (auto* CI = dyn_cast<ConstantInt>(V))
+        return ConstantRange(CI->getValue());
+
+    auto It = Ranges.find(V);
+    if (It != Ranges.end())
+        return It->second;
+
+    KnownBits Known = computeKnownBits(V, *DL);
+    ConstantRange R = ConstantRange::fromKnownBits(Known, false)
+        .intersectWith(ConstantRange::fromKnownBits(Known, true));
+
+    auto* I = dyn_cast<Instruction>(V);
+    if (I && Depth < MaxDepth) {
+        ConstantRange OpR(BitWidth, true);
+        switch (I->getOpcode()) {
+        case Instruction::ZExt:
+            OpR = getRange(I->getOperand(0), Depth + 1).zeroExtend(BitWidth);
+            break;
+        case Instruction::SExt:
+            OpR = getRange(I->getOperand(0), Depth + 1).signExtend(BitWidth);
+            break;
+        case Instruction::Trunc:
+            OpR = getRange(I->getOperand(0), Depth + 1).truncate(BitWidth);
+            break;
+        case Instruction::Add:
+        case Instruction::Sub:
+        case Instruction::Mul:
+        case Instruction::UDiv:
+        case Instruction::Shl:
+        case Instruction::LShr:
+        case Instruction::AShr:
+        case Instruction::And:
+        case Instruction::Or:
+            OpR = getRange(I->getOperand(0), Depth + 1).binaryOp(
+                Instruction::BinaryOps(I->getOpcode()), getRange(I->getOperand(1), Depth + 1));
+            break;
+        case Instruction::Select:
+            OpR = getRange(I->getOperand(1), Depth + 1).unionWith(getRange(I->getOperand(2), Depth + 1));
+            break;
+        case Instruction::Call:
+        case Instruction::Load:
+            if (MDNode* Range = I->getMetadata(LLVMContext::MD_range))
+                OpR = getConstantRangeFromMetadata(*Range);
+            break;
+        default:
+            break;
+        }
+        R = R.intersectWith(OpR);
+    }
+
+    Ranges.insert(std::make_pair(V, R));
+    return R;
+}
+
+// Returns the low 32 bits of V, looking through extensions from i32.
+Value* Narrow64BitOps::getLow(IRBuilder<>& IRB, Value* V) {
+    if (isa<ZExtInst>(V) || isa<SExtInst>(V)) {
+        Value* Src = cast<CastInst>(V)->getOperand(0);
+        if (Src->getType()->isIntegerTy(32))
+            return Src;
+    }
+    return IRB.CreateTrunc(V, IRB.getInt32Ty());
+}
+
+bool Narrow64BitOps::narrow(Instruction* I) {
+    Value* Op0 = I->getOperand(0);
+    if (!Op0->getType()->isIntegerTy(64))
+        return false;
+
+    auto shiftAmountFits = [&]() {
+        return getRange(I->getOperand(1)).getUnsignedMax().ult(32);
+    };
+
+    bool IsSigned = false;
+    switch (I->getOpcode()) {
+    default:
+        return false;
+    case Instruction::Shl:
+        if (!shiftAmountFits())
+            return false;
+        // FALL THROUGH
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor: {
+        // The low half of the result only depends on the low halves of the
+        // operands, so it is enough that the result fits.
+        ConstantRange R = getRange(I);
+        if (fitsUnsigned(R))
+            IsSigned = false;
+        else if (fitsSigned(R))
+            IsSigned = true;
+        else
+            return false;
+        break;
+    }
+    case Instruction::LShr:
+        if (!shiftAmountFits())
+            return false;
+        // FALL THROUGH
+    case Instruction::UDiv:
+    case Instruction::URem:
+        if (!fitsUnsigned(getRange(Op0)) || !fitsUnsigned(getRange(I->getOperand(1))))
+            return false;
+        break;
+    case Instruction::AShr:
+        if (!shiftAmountFits())
+            return false;
+        // FALL THROUGH
+    case Instruction::SDiv:
+    case Instruction::SRem: {
+        ConstantRange R0 = getRange(Op0);
+        ConstantRange R1 = getRange(I->getOperand(1));
+        if (!fitsSigned(R0) || !fitsSigned(R1))
+            return false;
+        // INT32_MIN / -1 overflows in 32 bits.
+        if (I->getOpcode() != Instruction::AShr &&
+            R0.contains(APInt::getSignedMinValue(32).sext(64)) && R1.contains(APInt::getAllOnesValue(64)))
+            return false;
+        IsSigned = true;
+        break;
+    }
+    case Instruction::ICmp: {
+        auto* Cmp = cast<ICmpInst>(I);
+        ConstantRange R0 = getRange(Op0);
+        ConstantRange R1 = getRange(I->getOperand(1));
+        bool Unsigned = fitsUnsigned(R0) && fitsUnsigned(R1);
+        bool Signed = fitsSigned(R0) && fitsSigned(R1);
+        // Unsigned predicates compare the same in 32 bits if both operands
+        // are zero extended, and signed predicates if both are sign extended.
+        if (Cmp->isEquality() ? !(Unsigned || Signed) : Cmp->isSigned() ? !Signed : !Unsigned)
+            return false;
+        IRBuilder<> IRB(I);
+        Value* NewCmp = IRB.CreateICmp(Cmp->getPredicate(),
+            getLow(IRB, Op0), getLow(IRB, I->getOperand(1)));
+        NewCmp->takeName(I);
+        I->replaceAllUsesWith(NewCmp);
+        return true;
+    }
+    }
+
+    IRBuilder<> IRB(I);
+    Value* NewOp = IRB.CreateBinOp(Instruction::BinaryOps(I->getOpcode()),
+        getLow(IRB, Op0), getLow(IRB, I->getOperand(1)));
+    Value* Ext = IsSigned ? IRB.CreateSExt(NewOp, I->getType()) : IRB.CreateZExt(NewOp, I->getType());
+    Ext->takeName(I);
+    I->replaceAllUsesWith(Ext);
+    return true;
+}
+
+bool Narrow64BitOps::runOnFunction(Function& F) {
+    DL = &F.getParent()->getDataLayout();
+    Ranges.clear();
+
+    SmallVector<Instruction*, 32> Candidates;
+    for (auto& I : instructions(F)) {
+        if ((isa<BinaryOperator>(I) || isa<ICmpInst>(I)) && I.getOperand(0)->getType()->isIntegerTy(64))
+            Candidates.push_back(&I);
+    }
+
+    // Definitions are visited before their uses, so narrowed operations are
+    // seen through their extensions by the following ones.
+    bool Changed = false;
+    for (Instruction* I : Candidates) {
+        if (narrow(I)) {
+            Ranges.erase(I);
+            I->eraseFromParent();
+            Changed = true;
+        }
+    }
+    return Changed;
+}
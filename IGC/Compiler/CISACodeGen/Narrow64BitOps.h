@@ -0,0 +1,20 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef NARROW64BITOPS_H
+#define NARROW64BITOPS_H
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/Pass.h"
+#include "llvm/PassRegistry.h"
+#include "common/LLVMWarningsPop.hpp"
+
+void initializeNarrow64BitOpsPass(llvm::PassRegistry&);
+llvm::FunctionPass* createNarrow64BitOpsPass();
+
+#endif // NARROW64BITOPS_H
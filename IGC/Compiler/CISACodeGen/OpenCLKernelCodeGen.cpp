@@ -1592,6 +1592,7 @@ namespace IGC
         m_kernelInfo.m_threadPayload.HasGlobalIDOffset = false;
         m_kernelInfo.m_threadPayload.HasGroupID = false;
         m_kernelInfo.m_threadPayload.HasLocalID = false;
+        m_kernelInfo.m_threadPayload.HasInKernelLocalIDs = false;
         m_kernelInfo.m_threadPayload.UnusedPerThreadConstantPresent = false;
         m_kernelInfo.m_printfBufferAnnotation = nullptr;
         m_kernelInfo.m_syncBufferAnnotation = nullptr;
@@ -1638,8 +1639,11 @@ namespace IGC
             KernelArg arg = *i;
             prevOffset = offset;
 
-            // skip unused arguments
-            bool IsUnusedArg = (arg.getArgType() == KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET) &&
+            // skip unused arguments; the remaining implicit args are
+            // allocated back to back, so a kernel only pays for the ones it
+            // reads.
+            bool IsUnusedArg = (arg.getArgType() == KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET ||
+                (IGC_IS_FLAG_DISABLED(DisableUnusedImplicitArgSkip) && arg.isPayloadOnlyImplicitArg())) &&
                 arg.getArg()->use_empty();
 
             // Runtime Values should not be processed any further. No annotations shall be created for them.
@@ -1757,6 +1761,17 @@ namespace IGC
                 encoder.GetVISAKernel()->AddKernelAttribute("PerThreadInputSize", sizeof(uint16_t), &perThreadInputSize);
             }
         }
+        else if (IGC_IS_FLAG_ENABLED(EnableInKernelLocalIDs))
+        {
+            // WIFuncResolution computed the local ids from r0.2, which
+            // relies on the runtime numbering the work items linearly.
+            auto funcMD = m_Context->getModuleMetaData()->FuncMD.find(entry);
+            if (funcMD != m_Context->getModuleMetaData()->FuncMD.end() &&
+                funcMD->second.localIDPresent)
+            {
+                m_kernelInfo.m_threadPayload.HasInKernelLocalIDs = true;
+            }
+        }
 
         m_kernelInfo.m_threadPayload.OffsetToSkipPerThreadDataLoad = 0;
         m_kernelInfo.m_threadPayload.OffsetToSkipSetFFIDGP = 0;
@@ -2103,10 +2118,13 @@ namespace IGC
             optDisable = true;
         }
 
+        // A retry recompiles the whole program, don't start one when the
+        // compile time budget is nearly used up.
         if (pOutput->m_scratchSpaceUsedBySpills == 0 ||
             noRetry ||
             ctx->m_retryManager.IsLastTry() ||
-            optDisable)
+            optDisable ||
+            ctx->isCompileTimeBudgetLow())
         {
             // Save the shader program to the state processor to be handled later
             if (ctx->m_programOutput.m_ShaderProgramList.size() == 0 ||
@@ -25,11 +25,25 @@ SPDX-License-Identifier: MIT
 #include "Compiler/InitializePasses.h"
 #include "Compiler/DebugInfo/ScalarVISAModule.h"
 #include "Probe/Assertion.h"
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/Statistic.h>
+#include "common/LLVMWarningsPop.hpp"
 
 using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
 
+#define DEBUG_TYPE "pattern-match"
+
+STATISTIC(NumMad, "Number of mad patterns matched");
+STATISTIC(NumFMA, "Number of fma patterns matched");
+STATISTIC(NumLrp, "Number of lrp patterns matched");
+STATISTIC(NumAdd3, "Number of add3 patterns matched");
+STATISTIC(NumBfn, "Number of bfn patterns matched");
+STATISTIC(NumMulAdd16, "Number of 16-bit mul-add patterns matched");
+STATISTIC(NumCmpSelect, "Number of cmp-select patterns matched to bfn");
+STATISTIC(NumFPSatModifier, "Number of fp saturations folded into a destination modifier");
+
 char CodeGenPatternMatch::ID = 0;
 #define PASS_FLAG "CodeGenPatternMatch"
 #define PASS_DESCRIPTION "Does pattern matching"
@@ -952,6 +966,14 @@ namespace IGC
     {
 
         bool match = false;
+        // Vector ALU ops are kept by the selective scalarizer only when they
+        // are uniform; they are emitted on the packed vector as a whole.
+        if (I.getType()->isVectorTy())
+        {
+            match = MatchSingleInstruction(I);
+            IGC_ASSERT(match == true);
+            return;
+        }
         switch (I.getOpcode())
         {
         case Instruction::FSub:
@@ -966,6 +988,7 @@ namespace IGC
         case Instruction::Sub:
             match = MatchMad(I) ||
                 MatchAbsNeg(I) ||
+                MatchAdd3(I) ||
                 MatchMulAdd16(I) ||
                 MatchModifier(I);
             break;
@@ -976,6 +999,7 @@ namespace IGC
             break;
         case Instruction::Add:
             match = MatchMad(I) ||
+                MatchAdd3(I) ||
                 MatchMulAdd16(I) ||
                 MatchModifier(I);
             break;
@@ -1010,15 +1034,18 @@ namespace IGC
         case Instruction::And:
             match =
                 MatchBoolOp(I) ||
+                MatchBfn(I) ||
                 MatchLogicAlu(I);
             break;
         case Instruction::Or:
             match =
                 MatchBoolOp(I) ||
+                MatchBfn(I) ||
                 MatchLogicAlu(I);
             break;
         case Instruction::Xor:
             match =
+                MatchBfn(I) ||
                 MatchLogicAlu(I);
             break;
         default:
@@ -1825,6 +1852,7 @@ namespace IGC
             }
         }
         AddPattern(pattern);
+        ++NumFMA;
 
         return true;
     }
@@ -2280,6 +2308,7 @@ namespace IGC
                 }
             }
             AddPattern(pattern);
+            ++NumMad;
         }
         return found;
     }
@@ -2747,6 +2776,7 @@ namespace IGC
                 pattern->sources[i] = GetSource(sources[i], src_mod[i], false);
             }
             AddPattern(pattern);
+            ++NumLrp;
         }
         return found;
     }
@@ -3044,6 +3074,7 @@ namespace IGC
         }
         Pat->rootInst = &I;
         AddPattern(Pat);
+        ++NumMulAdd16;
 
         return true;
     }
@@ -3318,6 +3349,7 @@ namespace IGC
                 gatherUniformBools(source);
             }
             AddPattern(satPattern);
+            ++NumFPSatModifier;
         }
         return match;
     }
@@ -3804,10 +3836,20 @@ namespace IGC
             return false;
         }
 
+        // Patterns are matched bottom-up, so all users of an operand have
+        // been matched already. If the operand is needed by one of them, it
+        // is emitted anyway and folding it saves nothing.
+        auto getFoldableAddSub = [this](Value* V) -> Instruction* {
+            Instruction* AddSub = dyn_cast<Instruction>(V);
+            if (!AddSub || NeedInstruction(*AddSub))
+                return nullptr;
+            return AddSub;
+        };
+
         Value* s0 = I.getOperand(0);
         Value* s1 = nullptr, * s2 = nullptr;
         e_modifier Mod1 = EMOD_NONE, Mod2 = EMOD_NONE;
-        Instruction* I0 = dyn_cast<Instruction>(s0);
+        Instruction* I0 = getFoldableAddSub(s0);
         if (I0)
         {
             if (I0->getOpcode() == Instruction::Sub)
@@ -3827,7 +3869,7 @@ namespace IGC
         if (s1 == nullptr)
         {
             s1 = I.getOperand(1);
-            Instruction* I1 = dyn_cast<Instruction>(s1);
+            Instruction* I1 = getFoldableAddSub(s1);
             if (I1)
             {
                 if (I1->getOpcode() == Instruction::Sub)
@@ -3885,6 +3927,7 @@ namespace IGC
             pattern->sources[2].mod = CombineModifier(Mod2, pattern->sources[2].mod);
         }
         AddPattern(pattern);
+        ++NumAdd3;
         return true;
     }
 
@@ -3979,6 +4022,11 @@ namespace IGC
         };
 
         auto isBinaryLogic = [](Instruction::BinaryOps op) { return op == Instruction::Or || op == Instruction::And || op == Instruction::Xor; };
+        // A 'not' is folded by MatchLogicAlu as a source modifier for free.
+        auto isNot = [](BinaryOperator* BO) {
+            return BO->getOpcode() == Instruction::Xor && isa<ConstantInt>(BO->getOperand(1)) &&
+                cast<ConstantInt>(BO->getOperand(1))->isMinusOne();
+        };
         // Find BFN patterns. Matched patterns: (op0 and op1 are boolean operations)
         // s0   s1                   s1  s2
         //   \ /                      \  /
@@ -4003,7 +4051,10 @@ namespace IGC
                 // bfn is unlikely to be profitable.
                 return false;
             }
-            else if (I0->getNumUses() > I1->getNumUses())
+            // Prefer folding the operand that is not emitted for other users
+            // anyway, and then the one with fewer uses.
+            bool needI0 = NeedInstruction(*I0), needI1 = NeedInstruction(*I1);
+            if (needI0 != needI1 ? needI0 : I0->getNumUses() > I1->getNumUses())
             {
                 I.setOperand(0, I1);
                 I.setOperand(1, I0);
@@ -4016,7 +4067,7 @@ namespace IGC
         BinaryOperator* I0 = dyn_cast<BinaryOperator>(s0);
         if (I0)
         {
-            if (isBinaryLogic(I0->getOpcode()) && !I0->hasNUsesOrMore(useThreshold))
+            if (isBinaryLogic(I0->getOpcode()) && !I0->hasNUsesOrMore(useThreshold) && !isNot(I0))
             {
                 s0 = I0->getOperand(0);
                 s1 = I0->getOperand(1);
@@ -4029,7 +4080,7 @@ namespace IGC
             BinaryOperator* I1 = dyn_cast<BinaryOperator>(s1);
             if (I1)
             {
-                if (isBinaryLogic(I1->getOpcode()) && !I1->hasNUsesOrMore(useThreshold))
+                if (isBinaryLogic(I1->getOpcode()) && !I1->hasNUsesOrMore(useThreshold) && !isNot(I1))
                 {
                     s1 = I1->getOperand(0);
                     s2 = I1->getOperand(1);
@@ -4081,6 +4132,7 @@ namespace IGC
         }
 
         AddPattern(pattern);
+        ++NumBfn;
         return true;
     }
 
@@ -4164,6 +4216,7 @@ namespace IGC
             pattern->bfnSources[1] = GetSource(selSources[0], false, false);
             pattern->bfnSources[2] = GetSource(selSources[1], false, false);
             AddPattern(pattern);
+            ++NumCmpSelect;
 
             return true;
         }
@@ -29,6 +29,9 @@ SPDX-License-Identifier: MIT
 #include "Compiler/MetaDataUtilsWrapper.h"
 #include "common/debug/Debug.hpp"
 #include <list>
+#include <fstream>
+#include <sstream>
+#include <tuple>
 #include "Probe/Assertion.h"
 
 /***********************************************************************************
@@ -60,6 +63,7 @@ namespace IGC
     IGC_INITIALIZE_PASS_BEGIN(PushAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
         IGC_INITIALIZE_PASS_DEPENDENCY(PostDominatorTreeWrapperPass)
         IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+        IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
         IGC_INITIALIZE_PASS_DEPENDENCY(PullConstantHeuristics)
         IGC_INITIALIZE_PASS_END(PushAnalysis, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 
@@ -1079,23 +1083,133 @@ namespace IGC
         unsigned int sizePushed = 0;
         m_entryBB = &m_pFunction->getEntryBlock();
 
-        // Runtime values are changed to intrinsics. So we need to do it before.
-        for (auto bb = m_pFunction->begin(), be = m_pFunction->end(); bb != be; ++bb)
+        if (IGC_IS_FLAG_ENABLED(EnableWeightedPushConstantSelection))
         {
-            for (auto i = bb->begin(), ie = bb->end(); i != ie; ++i)
+            sizePushed = WeightedBlockPushConstants(cthreshold);
+        }
+        else
+        {
+            // Runtime values are changed to intrinsics. So we need to do it before.
+            for (auto bb = m_pFunction->begin(), be = m_pFunction->end(); bb != be; ++bb)
+            {
+                for (auto i = bb->begin(), ie = bb->end(); i != ie; ++i)
+                {
+                    Instruction* const instr = &(*i);
+                    SimplePushInfo info{};
+                    bool isPushable = IsPushableShaderConstant(instr, info);
+                    if(isPushable)
+                    {
+                        sizePushed += AllocatePushedConstant(
+                            instr,
+                            info,
+                            cthreshold - sizePushed); // maxSizeAllowed
+                    }
+                }
+            }
+        }
+
+        if (IGC_IS_FLAG_ENABLED(DumpPushConstantLayout))
+        {
+            DumpPushConstantLayout(cthreshold, sizePushed);
+        }
+    }
+
+    unsigned int PushAnalysis::WeightedBlockPushConstants(const unsigned int maxSizeAllowed)
+    {
+        // Each GRF worth of a push region is worth the sum of the estimated
+        // execution counts of the loads reading from it. Fill the budget with
+        // the most valuable GRFs first; this is the usual greedy approximation
+        // of the knapsack problem, as all the items have the same size.
+        struct PushSlot
+        {
+            uint64_t weight = 0;
+            unsigned int order = 0;
+            std::vector<std::pair<Instruction*, SimplePushInfo>> loads;
+        };
+        typedef std::tuple<unsigned int, int, int, bool, bool, unsigned int> SlotKey;
+        std::map<SlotKey, PushSlot> slots;
+
+        LoopInfo& LI = getAnalysis<LoopInfoWrapperPass>(*m_pFunction).getLoopInfo();
+        const unsigned int maxLoopDepth = 5;
+        for (auto& BB : *m_pFunction)
+        {
+            const uint64_t weight = 1ULL << (3 * std::min(LI.getLoopDepth(&BB), maxLoopDepth));
+            for (auto& I : BB)
             {
-                Instruction* const instr = &(*i);
                 SimplePushInfo info{};
-                bool isPushable = IsPushableShaderConstant(instr, info);
-                if(isPushable)
+                if (I.use_empty() || !IsPushableShaderConstant(&I, info))
                 {
-                    sizePushed += AllocatePushedConstant(
-                        instr,
-                        info,
-                        cthreshold - sizePushed); // maxSizeAllowed
+                    continue;
                 }
+                SlotKey key(info.cbIdx, info.pushableAddressGrfOffset, info.pushableOffsetGrfOffset,
+                    info.isStateless, info.isBindless, info.offset / getGRFSize());
+                auto it = slots.find(key);
+                if (it == slots.end())
+                {
+                    it = slots.emplace(key, PushSlot()).first;
+                    it->second.order = (unsigned int)slots.size();
+                }
+                it->second.weight += weight;
+                it->second.loads.emplace_back(&I, info);
             }
         }
+
+        std::vector<PushSlot*> sortedSlots;
+        sortedSlots.reserve(slots.size());
+        for (auto& it : slots)
+        {
+            sortedSlots.push_back(&it.second);
+        }
+        std::sort(sortedSlots.begin(), sortedSlots.end(), [](const PushSlot* a, const PushSlot* b)
+            {
+                return a->weight > b->weight || (a->weight == b->weight && a->order < b->order);
+            });
+
+        unsigned int sizePushed = 0;
+        for (PushSlot* slot : sortedSlots)
+        {
+            for (auto& load : slot->loads)
+            {
+                sizePushed += AllocatePushedConstant(load.first, load.second, maxSizeAllowed - sizePushed);
+            }
+        }
+        return sizePushed;
+    }
+
+    void PushAnalysis::DumpPushConstantLayout(const unsigned int maxSizeAllowed, const unsigned int sizePushed) const
+    {
+        const PushInfo& pushInfo = m_context->getModuleMetaData()->pushInfo;
+        std::stringstream layout;
+        layout << "{\"function\":\"" << m_pFunction->getName().str() << "\""
+            << ",\"budget\":" << maxSizeAllowed
+            << ",\"pushed\":" << sizePushed
+            << ",\"buffers\":[";
+        for (unsigned int i = 0; i < pushInfo.simplePushBufferUsed; i++)
+        {
+            const SimplePushInfo& info = pushInfo.simplePushInfoArr[i];
+            layout << (i ? "," : "")
+                << "{\"cbIdx\":" << info.cbIdx
+                << ",\"stateless\":" << (info.isStateless ? "true" : "false")
+                << ",\"bindless\":" << (info.isBindless ? "true" : "false")
+                << ",\"addressGrfOffset\":" << info.pushableAddressGrfOffset
+                << ",\"offsetGrfOffset\":" << info.pushableOffsetGrfOffset
+                << ",\"offset\":" << info.offset
+                << ",\"size\":" << info.size
+                << ",\"constants\":[";
+            bool first = true;
+            for (auto& it : info.simplePushLoads)
+            {
+                layout << (first ? "" : ",") << "[" << it.first << "," << it.second << "]";
+                first = false;
+            }
+            layout << "]}";
+        }
+        layout << "]}" << std::endl;
+
+        std::stringstream layoutFile;
+        layoutFile << IGC::Debug::GetShaderOutputFolder() << "PushConstantLayout.json";
+        std::ofstream layoutStream(layoutFile.str(), std::ios::app);
+        layoutStream << layout.str();
     }
 
     PushConstantMode PushAnalysis::GetPushConstantMode()
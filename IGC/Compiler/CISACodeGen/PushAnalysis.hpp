@@ -18,6 +18,7 @@ SPDX-License-Identifier: MIT
 #include "ShaderCodeGen.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/DataLayout.h>
+#include <llvm/Analysis/LoopInfo.h>
 #include <llvm/IR/PassManager.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "FunctionUpgrader.h"
@@ -95,6 +96,13 @@ namespace IGC
         /// process simple push for the function
         void BlockPushConstants();
 
+        /// push the constants with the highest estimated dynamic use frequency
+        /// per GRF first, returns the number of bytes pushed
+        unsigned int WeightedBlockPushConstants(const unsigned int maxSizeAllowed);
+
+        /// append the simple push layout of the function to a JSON lines dump
+        void DumpPushConstantLayout(const unsigned int maxSizeAllowed, const unsigned int sizePushed) const;
+
         /// Try to push allocate space for the constant to be pushed
         unsigned int AllocatePushedConstant(
             llvm::Instruction* load,
@@ -152,6 +160,7 @@ namespace IGC
             AU.addRequired<CodeGenContextWrapper>();
             AU.addRequired<llvm::PostDominatorTreeWrapperPass>();
             AU.addRequired<llvm::DominatorTreeWrapperPass>();
+            AU.addRequired<llvm::LoopInfoWrapperPass>();
             AU.addRequired<PullConstantHeuristics>();
         }
 
@@ -572,6 +572,31 @@ namespace IGC
         return RP;
     }
 
+    unsigned RegisterPressureEstimate::getMaxRegisterPressureForSIMD(unsigned NumLanes) const
+    {
+        // Record pressure changes at segment boundaries and sweep them once,
+        // instead of testing every live range at every instruction.
+        std::vector<int64_t> Delta(MaxAssignedNumber + 2, 0);
+        for (auto I = m_pLiveRanges.begin(), E = m_pLiveRanges.end(); I != E; ++I)
+        {
+            unsigned Bytes = getValueBytes(I->first, NumLanes);
+            for (auto& Seg : I->second->Segments)
+            {
+                Delta[std::min(Seg.Begin, MaxAssignedNumber + 1)] += Bytes;
+                Delta[std::min(Seg.End, MaxAssignedNumber + 1)] -= Bytes;
+            }
+        }
+
+        int64_t Pressure = 0;
+        int64_t MaxPressure = 0;
+        for (int64_t D : Delta)
+        {
+            Pressure += D;
+            MaxPressure = std::max(MaxPressure, Pressure);
+        }
+        return int_cast<unsigned>(MaxPressure);
+    }
+
     void RegisterPressureEstimate::printRegisterPressureInfo
     (bool Detailed,
         const char* msg) const
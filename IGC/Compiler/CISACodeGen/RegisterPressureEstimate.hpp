@@ -193,6 +193,10 @@ namespace IGC
         /// \brief Return the register pressure for a basic block.
         unsigned getMaxRegisterPressure(llvm::BasicBlock* BB) const;
 
+        /// \brief Return the peak number of bytes live at any point of the
+        /// function when non-uniform values occupy NumLanes lanes each.
+        unsigned getMaxRegisterPressureForSIMD(unsigned NumLanes) const;
+
         void printRegisterPressureInfo(bool Detailed = false,
             const char* msg = "") const;
 
@@ -217,7 +221,8 @@ namespace IGC
         /// \brief Return the register pressure at location specified by Inst.
         unsigned getRegisterPressure(llvm::Instruction* Inst) const;
 
-        unsigned getValueBytes(llvm::Value* V) const
+        unsigned getValueBytes(llvm::Value* V,
+            unsigned NumLanes = SIMD_PRESSURE_MULTIPLIER) const
         {
             auto Ty = V->getType();
             if (Ty->isVoidTy())
@@ -228,7 +233,7 @@ namespace IGC
             uint32_t eltBits = (uint32_t)m_DL->getTypeSizeInBits(eltTy);
             uint32_t nBytes = nelts * ((eltBits + 7) / 8);
             unsigned int simdness =
-                (WI && WI->isUniform(V)) ? 1 : SIMD_PRESSURE_MULTIPLIER;
+                (WI && WI->isUniform(V)) ? 1 : NumLanes;
             return simdness * nBytes;
         }
 
@@ -0,0 +1,104 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/CISACodeGen/RemoveUnusedOutputs.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CodeGenPublicEnums.h"
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/Pass.h"
+#include "llvm/IR/InstIterator.h"
+#include "common/LLVMWarningsPop.hpp"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+
+using namespace llvm;
+using namespace IGC;
+
+namespace
+{
+    class RemoveUnusedOutputs : public FunctionPass
+    {
+    public:
+        static char ID; // Pass identification, replacement for typeid
+
+        RemoveUnusedOutputs();
+
+        bool runOnFunction(Function& F) override;
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.addRequired<CodeGenContextWrapper>();
+            AU.setPreservesCFG();
+        }
+
+        StringRef getPassName() const override
+        {
+            return "remove outputs unused by the next stage";
+        }
+    };
+}  // namespace
+
+#define PASS_FLAG "igc-remove-unused-outputs"
+#define PASS_DESCRIPTION "Remove outputs not read by the next pipeline stage"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(RemoveUnusedOutputs, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(RemoveUnusedOutputs, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+char RemoveUnusedOutputs::ID = 0;
+
+RemoveUnusedOutputs::RemoveUnusedOutputs() : FunctionPass(ID)
+{
+    initializeRemoveUnusedOutputsPass(*PassRegistry::getPassRegistry());
+}
+
+FunctionPass* IGC::createRemoveUnusedOutputsPass()
+{
+    return new RemoveUnusedOutputs();
+}
+
+bool RemoveUnusedOutputs::runOnFunction(Function& F)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    const std::vector<int>& inputMask = ctx->getModuleMetaData()->URBInfo.nextStageInputMask;
+    if (inputMask.empty())
+    {
+        return false;
+    }
+
+    SmallVector<Instruction*, 10> instructionToRemove;
+    for (inst_iterator II = inst_begin(F), E = inst_end(F); II != E; ++II)
+    {
+        GenIntrinsicInst* inst = dyn_cast<GenIntrinsicInst>(&*II);
+        if (!inst || inst->getIntrinsicID() != GenISAIntrinsic::GenISA_OUTPUT)
+        {
+            continue;
+        }
+        // Only generic attributes are matched to the next stage inputs; the
+        // vertex header and clip distances are consumed by fixed functions.
+        const ShaderOutputType usage = static_cast<ShaderOutputType>(
+            cast<ConstantInt>(inst->getOperand(4))->getZExtValue());
+        ConstantInt* attribute = dyn_cast<ConstantInt>(inst->getOperand(5));
+        if (usage != SHADER_OUTPUT_TYPE_DEFAULT || !attribute)
+        {
+            continue;
+        }
+        uint64_t index = attribute->getZExtValue();
+        if (index < inputMask.size() && inputMask[index] == 0)
+        {
+            instructionToRemove.push_back(inst);
+        }
+    }
+
+    for (auto inst : instructionToRemove)
+    {
+        inst->eraseFromParent();
+    }
+    return !instructionToRemove.empty();
+}
@@ -0,0 +1,21 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+namespace llvm
+{
+    class FunctionPass;
+}
+
+namespace IGC
+{
+    // Removes vertex/domain shader attribute outputs that the next pipeline
+    // stage does not read, as given by URBInfo.nextStageInputMask.
+    llvm::FunctionPass* createRemoveUnusedOutputsPass();
+}  // namespace IGC
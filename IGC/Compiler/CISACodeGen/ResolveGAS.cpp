@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Support/Debug.h"
 #include "llvmWrapper/IR/Constant.h"
+#include "llvmWrapper/Transforms/Utils/Cloning.h"
 #include "LLVM3DBuilder/MetadataBuilder.h"
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/ADT/DenseSet.h>
@@ -906,6 +907,14 @@ namespace IGC
     //   Once (1) is done. Do further check if there is a cast from local to GAS or
     //   a cast from private to GAS. If there is no such cast, GAS inst (such as
     //   ld/st, etc, can be converted safely to ld/st on globals.
+    //
+    // With EnableGASCallSpecialization, functions whose call sites pass generic
+    // pointers of different origin address spaces are cloned per combination of
+    // known origin address spaces, and call sites are redirected to the clones.
+    // (1) then lowers the arguments of each clone. Only call sites with unknown
+    // origin keep calling the generic version, which needs dynamic resolution.
+    // This is repeated, as lowering a clone gives known origins to the calls it
+    // makes in turn.
     class LowerGPCallArg : public ModulePass
     {
     public:
@@ -954,7 +963,10 @@ namespace IGC
         void updateFunctionArgs(Function* oldFunc, Function* newFunc, GenericPointerArgs& newArgs);
         void updateAllUsesWithNewFunction(FuncToUpdate& f);
         void FixAddressSpaceInAllUses(Value* ptr, uint newAS, uint oldAS, AddrSpaceCastInst* recoverASC);
-        bool processCallArg(Module& M);
+        bool processCallArg(Module& M, CallGraph& CG);
+
+        bool specializeCallArgs(Module& M, CallGraph& CG);
+        Function* cloneForSpecialization(Function* F);
 
         void checkCastToGAS(Module& M);
         bool processGASInst(Module& M);
@@ -1042,19 +1054,33 @@ bool LowerGPCallArg::runOnModule(llvm::Module& M)
     bool changed = false;
 
     // (1) main work
-    if (processCallArg(M))
+    if (processCallArg(M, getAnalysis<CallGraphWrapperPass>().getCallGraph()))
         changed = true;
 
+    if (IGC_IS_FLAG_ENABLED(EnableGASCallSpecialization))
+    {
+        // Bound the depth of call chains specialized.
+        const unsigned maxSpecializationRounds = 4;
+        for (unsigned i = 0; i < maxSpecializationRounds; ++i)
+        {
+            // Functions are replaced at each step, so the call graph is rebuilt.
+            CallGraph specializeCG(M);
+            if (!specializeCallArgs(M, specializeCG))
+                break;
+            CallGraph lowerCG(M);
+            processCallArg(M, lowerCG);
+            changed = true;
+        }
+    }
+
     // (2) further static resolution
     if (processGASInst(M))
         changed = true;
     return changed;
 }
 
-bool LowerGPCallArg::processCallArg(Module& M)
+bool LowerGPCallArg::processCallArg(Module& M, CallGraph& CG)
 {
-    CallGraph& CG = getAnalysis<CallGraphWrapperPass>().getCallGraph();
-
     std::vector<FuncToUpdate> funcsToUpdate;
 
     auto skip = [](Function* F)
@@ -1241,6 +1267,122 @@ bool LowerGPCallArg::processCallArg(Module& M)
     return true;
 }
 
+Function* LowerGPCallArg::cloneForSpecialization(Function* F)
+{
+    ValueToValueMapTy VMap;
+    Function* clonedF = CloneFunction(F, VMap);
+    if (!F->getParent()->getFunction(clonedF->getName()))
+        F->getParent()->getFunctionList().push_back(clonedF);
+
+    auto FII = m_mdUtils->findFunctionsInfoItem(F);
+    if (FII != m_mdUtils->end_FunctionsInfo())
+    {
+        FunctionInfoMetaDataHandle info = FII->second;
+        FunctionInfoMetaDataHandle newInfo = FunctionInfoMetaDataHandle(FunctionInfoMetaData::get());
+        if (info->isTypeHasValue())
+            newInfo->setType(info->getType());
+        for (unsigned i = 0, e = info->size_ArgInfoList(); i != e; ++i)
+            newInfo->addArgInfoListItem(info->getArgInfoListItem(i));
+        for (unsigned i = 0, e = info->size_ImplicitArgInfoList(); i != e; ++i)
+            newInfo->addImplicitArgInfoListItem(info->getImplicitArgInfoListItem(i));
+        m_mdUtils->setFunctionsInfoItem(clonedF, newInfo);
+    }
+
+    auto& FuncMD = m_ctx->getModuleMetaData()->FuncMD;
+    auto loc = FuncMD.find(F);
+    if (loc != FuncMD.end())
+    {
+        auto funcInfo = loc->second;
+        FuncMD[clonedF] = funcInfo;
+    }
+    return clonedF;
+}
+
+bool LowerGPCallArg::specializeCallArgs(Module& M, CallGraph& CG)
+{
+    // Collect the candidates top-down, so that callers are specialized first.
+    std::vector<Function*> candidates;
+    for (auto I = po_begin(CG.getExternalCallingNode()), E = po_end(CG.getExternalCallingNode()); I != E; ++I)
+    {
+        Function* F = (*I)->getFunction();
+        if (!F || F->isVarArg() || F->isDeclaration() || F->isIntrinsic() ||
+            F->hasFnAttribute("referenced-indirectly") || isEntryFunc(m_mdUtils, F))
+            continue;
+        PointerType* returnPointerType = dyn_cast<PointerType>(F->getReturnType());
+        if (returnPointerType && returnPointerType->getAddressSpace() == ADDRESS_SPACE_GENERIC)
+            continue;
+        candidates.push_back(F);
+    }
+
+    bool changed = false;
+    for (auto I = candidates.rbegin(), E = candidates.rend(); I != E; ++I)
+    {
+        Function* F = *I;
+
+        std::vector<unsigned> genericArgs;
+        for (auto& arg : F->args())
+        {
+            PointerType* argPointerType = dyn_cast<PointerType>(arg.getType());
+            if (!arg.use_empty() && argPointerType &&
+                argPointerType->getAddressSpace() == ADDRESS_SPACE_GENERIC)
+                genericArgs.push_back(arg.getArgNo());
+        }
+        if (genericArgs.empty())
+            continue;
+
+        // Group call sites by the origin address spaces of their generic
+        // pointer arguments, ADDRESS_SPACE_GENERIC standing for unknown.
+        std::map<std::vector<unsigned>, SmallVector<CallInst*, 4>> groups;
+        bool allDirectCalls = true;
+        for (auto U : F->users())
+        {
+            CallInst* CI = dyn_cast<CallInst>(U);
+            if (!CI || CI->getCalledFunction() != F)
+            {
+                allDirectCalls = false;
+                break;
+            }
+            std::vector<unsigned> origins;
+            for (unsigned argNo : genericArgs)
+            {
+                AddrSpaceCastInst* ASC = dyn_cast<AddrSpaceCastInst>(CI->getArgOperand(argNo));
+                origins.push_back(ASC ? ASC->getSrcAddressSpace() : (unsigned)ADDRESS_SPACE_GENERIC);
+            }
+            groups[origins].push_back(CI);
+        }
+        if (!allDirectCalls || groups.size() < 2)
+            continue;
+
+        // The generic version keeps the call sites with unknown origins, or
+        // the largest group if there is no such call site.
+        std::vector<unsigned> allGeneric(genericArgs.size(), ADDRESS_SPACE_GENERIC);
+        auto kept = groups.find(allGeneric);
+        if (kept == groups.end())
+        {
+            kept = std::max_element(groups.begin(), groups.end(),
+                [](const decltype(groups)::value_type& A, const decltype(groups)::value_type& B) {
+                    return A.second.size() < B.second.size();
+                });
+        }
+        if (groups.size() - 1 > IGC_GET_FLAG_VALUE(GASCallSpecializationMaxClones))
+            continue;
+
+        for (auto GI = groups.begin(), GE = groups.end(); GI != GE; ++GI)
+        {
+            if (GI == kept)
+                continue;
+            Function* clonedF = cloneForSpecialization(F);
+            for (CallInst* CI : GI->second)
+                CI->setCalledFunction(clonedF);
+        }
+        changed = true;
+    }
+
+    if (changed)
+        m_mdUtils->save(M.getContext());
+    return changed;
+}
+
 bool LowerGPCallArg::processGASInst(Module& M)
 {
     checkCastToGAS(M);
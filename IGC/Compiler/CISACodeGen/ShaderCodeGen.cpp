@@ -21,6 +21,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/AdvCodeMotion.h"
 #include "Compiler/CISACodeGen/AdvMemOpt.h"
 #include "Compiler/CISACodeGen/Emu64OpsPass.h"
+#include "Compiler/CISACodeGen/Narrow64BitOps.h"
 #include "Compiler/CISACodeGen/PullConstantHeuristics.hpp"
 #include "Compiler/CISACodeGen/PushAnalysis.hpp"
 #include "Compiler/CISACodeGen/ScalarizerCodeGen.hpp"
@@ -34,6 +35,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/FixupExtractValuePair.h"
 #include "Compiler/CISACodeGen/GenIRLowering.h"
 #include "Compiler/CISACodeGen/GenSimplification.h"
+#include "Compiler/CISACodeGen/InterproceduralUniformity.hpp"
 #include "Compiler/CISACodeGen/LoopDCE.h"
 #include "Compiler/CISACodeGen/LowerGSInterface.h"
 #include "Compiler/CISACodeGen/LdShrink.h"
@@ -49,6 +51,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/TimeStatsCounter.h"
 #include "Compiler/CISACodeGen/TypeDemote.h"
 #include "Compiler/CISACodeGen/UniformAssumptions.hpp"
+#include "Compiler/CISACodeGen/AtomicAggregation.hpp"
 #include "Compiler/Optimizer/LinkMultiRateShaders.hpp"
 #include "Compiler/CISACodeGen/MergeURBWrites.hpp"
 #include "Compiler/CISACodeGen/VectorProcess.hpp"
@@ -57,6 +60,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CISACodeGen/RegisterEstimator.hpp"
 #include "Compiler/CISACodeGen/ComputeShaderLowering.hpp"
 #include "Compiler/CISACodeGen/CrossPhaseConstProp.hpp"
+#include "Compiler/CISACodeGen/RemoveUnusedOutputs.hpp"
 
 #include "Compiler/CISACodeGen/SLMConstProp.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/DebuggerSupport/ImplicitGIDPass.hpp"
@@ -80,6 +84,9 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/GatingSimilarSamples.hpp"
 #include "Compiler/Optimizer/IntDivConstantReduction.hpp"
 #include "Compiler/Optimizer/IntDivRemCombine.hpp"
+#include "Compiler/Optimizer/IntDivInvariantReduction.hpp"
+#include "Compiler/Optimizer/LoopInvariantLoadMotion.hpp"
+#include "Compiler/Optimizer/ShaderProfileLoader.hpp"
 #include "Compiler/Optimizer/SynchronizationObjectCoalescing.hpp"
 #include "Compiler/MetaDataApi/PurgeMetaDataUtils.hpp"
 #include "Compiler/HandleLoadStoreInstructions.hpp"
@@ -320,6 +327,14 @@ static void AddAnalysisPasses(CodeGenContext& ctx, IGCPassManager& mpm)
     mpm.add(new Layout());
     mpm.add(createFixInvalidFuncNamePass());
 
+    // Propagate uniformity across subroutine calls, right before codegen so
+    // that no transformation invalidates it.
+    if (ctx.m_enableSubroutine &&
+        IGC_IS_FLAG_ENABLED(EnableInterproceduralUniformity))
+    {
+        mpm.add(createInterproceduralUniformityPass());
+    }
+
     mpm.add(createTimeStatsCounterPass(&ctx, TIME_CG_Analysis, STATS_COUNTER_END));
 
     COMPILER_TIME_END(&ctx, TIME_CG_Add_Analysis_Passes);
@@ -746,6 +761,13 @@ static void AddLegalizationPasses(CodeGenContext& ctx, IGCPassManager& mpm, PSSi
         mpm.add(new UniformAssumptions());
     }
 
+    if (ctx.m_instrTypes.hasAtomics && !isOptDisabled &&
+        IGC_IS_FLAG_ENABLED(EnableAtomicAggregation) &&
+        IGC_IS_FLAG_DISABLED(DisableScalarAtomics))
+    {
+        mpm.add(createAtomicAggregationPass());
+    }
+
     // NanHandlingPass need to be before Legalization since it might make
     // some changes and require Legalization to "legalize"
     if (IGC_IS_FLAG_DISABLED(DisableBranchSwaping) && ctx.m_DriverInfo.BranchSwapping())
@@ -798,6 +820,10 @@ static void AddLegalizationPasses(CodeGenContext& ctx, IGCPassManager& mpm, PSSi
         // as legalization passes do not always clear unused (operating
         // on illegal types) instructions.
         mpm.add(llvm::createDeadCodeEliminationPass());
+        if (!isOptDisabled && IGC_IS_FLAG_ENABLED(EnableNarrow64BitOps))
+        {
+            mpm.add(createNarrow64BitOpsPass());
+        }
         mpm.add(createEmu64OpsPass());
         ctx.m_hasEmu64BitInsts = true;
         if (!isOptDisabled)
@@ -834,10 +860,20 @@ static void AddLegalizationPasses(CodeGenContext& ctx, IGCPassManager& mpm, PSSi
     case ShaderType::HULL_SHADER:
         mpm.add(createHullShaderLoweringPass());
         mpm.add(new GenSpecificPattern());
+        if (!isOptDisabled)
+        {
+            // The control point and patch constant phases are lowered separately,
+            // share the URB reads and offset computations they have in common.
+            mpm.add(createEarlyCSEPass());
+        }
         break;
 
     case ShaderType::DOMAIN_SHADER:
         mpm.add(createDomainShaderLoweringPass());
+        if (!isOptDisabled)
+        {
+            mpm.add(createEarlyCSEPass());
+        }
         break;
     case ShaderType::COMPUTE_SHADER:
         mpm.add(CreateComputeShaderLowering());
@@ -1226,6 +1262,14 @@ void CodeGen(ContextType* ctx, CShaderProgram::KernelShaderMap& shaders)
 }
 
 
+// All kernels of the program are code generated by one pass manager on the
+// shared module and LLVMContext, so EmitVISAPass runs for one function group
+// at a time. Running function groups on separate threads would require
+// cloning each group into its own LLVMContext (LLVM IR is not thread-safe)
+// and splitting the per-program state in OpenCLProgramContext (retry
+// manager, SIMD decisions, metadata), which CodeGen does not support today.
+// The LLVM-free vISA finalization can be parallelized per builder with the
+// vISA -parallelCompileThreads option (see VISAOptions regkey).
 template<>
 void CodeGen(OpenCLProgramContext* ctx, CShaderProgram::KernelShaderMap& kernels)
 {
@@ -1419,6 +1463,12 @@ void unify_opt_PreProcess(CodeGenContext* pContext)
     {
         mpm.add(createRemoveNonPositionOutputPass());
     }
+    else if ((pContext->type == ShaderType::VERTEX_SHADER ||
+              pContext->type == ShaderType::DOMAIN_SHADER) &&
+             !pContext->getModuleMetaData()->URBInfo.nextStageInputMask.empty())
+    {
+        mpm.add(IGC::createRemoveUnusedOutputsPass());
+    }
 
     mpm.run(*pContext->getModule());
 
@@ -1540,6 +1590,13 @@ void OptimizeIR(CodeGenContext* const pContext)
         mpm.add(new llvm::TargetLibraryInfoWrapperPass(TLI));
         initializeWIAnalysisPass(*PassRegistry::getPassRegistry());
 
+        // Number blocks before any CFG change so that profile ids are stable.
+        if (IGC_IS_FLAG_ENABLED(DumpShaderProfileIds) ||
+            IGC_GET_REGKEYSTRING(ShaderProfileDir)[0] != '\0')
+        {
+            mpm.add(createShaderProfileLoaderPass());
+        }
+
         // Do inter-procedural constant propagation early.
         if (pContext->m_enableSubroutine)
         {
@@ -1568,7 +1625,9 @@ void OptimizeIR(CodeGenContext* const pContext)
             mpm.add(createPromoteMemoryToRegisterPass());
         }
 
-        if ((!IGC_IS_FLAG_ENABLED(DisableDynamicTextureFolding) && pContext->getModuleMetaData()->inlineDynTextures.size() > 0) ||
+        if ((!IGC_IS_FLAG_ENABLED(DisableDynamicTextureFolding) &&
+             (pContext->getModuleMetaData()->inlineDynTextures.size() > 0 ||
+              pContext->getModuleMetaData()->inlineResourceFacts.size() > 0)) ||
             (!IGC_IS_FLAG_ENABLED(DisableDynamicResInfoFolding)))
         {
             mpm.add(new DynamicTextureFolding());
@@ -1661,6 +1720,11 @@ void OptimizeIR(CodeGenContext* const pContext)
                     mpm.add(new InstrStatistic(pContext, LICM_STAT, InstrStatStage::END, licmTh));
                 }
 
+                if (IGC_IS_FLAG_ENABLED(EnableLoopInvariantLoadMotion))
+                {
+                    mpm.add(createLoopInvariantLoadMotionPass());
+                }
+
                 mpm.add(CreateHoistFMulInLoopPass());
 
                 if (!pContext->m_retryManager.IsFirstTry())
@@ -1873,7 +1937,8 @@ void OptimizeIR(CodeGenContext* const pContext)
 #endif
         if (
             pContext->type == ShaderType::HULL_SHADER ||
-            pContext->type == ShaderType::COMPUTE_SHADER)
+            pContext->type == ShaderType::COMPUTE_SHADER ||
+            (pContext->type == ShaderType::OPENCL_SHADER && IGC_IS_FLAG_ENABLED(EnableRedundantBarrierRemoval)))
         {
             mpm.add(new SynchronizationObjectCoalescing);
         }
@@ -1907,6 +1972,11 @@ void OptimizeIR(CodeGenContext* const pContext)
             // more efficient sequences of multiplies, shifts, and adds
             mpm.add(createIntDivConstantReductionPass());
         }
+        if (IGC_IS_FLAG_ENABLED(EnableInvariantIntDivReduction)) {
+            // reduce division/remainder by loop-invariant divisors to a
+            // multiply by a reciprocal computed in the loop preheader
+            mpm.add(createIntDivInvariantReductionPass());
+        }
 
         mpm.add(CreateMCSOptimization());
 
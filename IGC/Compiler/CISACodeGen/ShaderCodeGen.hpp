@@ -329,6 +329,7 @@ public:
     uint m_staticCycle;
     unsigned m_spillSize = 0;
     float m_spillCost = 0;          // num weighted spill inst / total inst
+    unsigned m_estimatedRegPressure = 0; // estimated peak bytes live, 0 if not estimated
 
     std::vector<llvm::Value*> m_argListCache;
 
@@ -558,7 +559,9 @@ protected:
 #if defined(_DEBUG) || defined(_INTERNAL)
     llvm::SpecificBumpPtrAllocator<CVariable> Allocator;
 #else
-    llvm::BumpPtrAllocator Allocator;
+    // All CVariables of the shader are released at once with it; use larger
+    // slabs so that big kernels don't go to malloc every few variables.
+    llvm::BumpPtrAllocatorImpl<llvm::MallocAllocator, 64 * 1024> Allocator;
 #endif
 
     // Mapping from formal argument to its variable or from function to its
@@ -523,10 +523,13 @@ void VariableReuseAnalysis::visitExtractElementInst(ExtractElementInst& I)
     // skip it for now (implementation choice).
     // Note that payload-coalescing does not use node value yet.
     if (hasBeenPayloadCoalesced(EEI) ||
-        hasAnotherInDCCAsAliasee(vec_nv) ||
         hasAnyOfDCCAsAliaser(EEI_nv)) {
         return;
     }
+    vec_nv = getDCCAliasBase(vec_nv);
+    if (!vec_nv) {
+        return;
+    }
 
     // Can only do alias if idx is a known constant.
     Value* IdxVal = EEI->getIndexOperand();
@@ -722,6 +725,22 @@ bool VariableReuseAnalysis::hasAnotherInDCCAsAliasee(Value* V) const
     return false;
 }
 
+// Values in a DCC share the same storage. If another value in V's DCC is
+// an aliasee already, e.g. V is a vector passed through a phi whose other
+// incoming value is a base vector, aliasing to that aliasee is the same as
+// aliasing to V. Use it as the base so that the DCC keeps a single root in
+// the alias map.
+Value* VariableReuseAnalysis::getDCCAliasBase(Value* V) const
+{
+    if (!hasAnotherInDCCAsAliasee(V)) {
+        return V;
+    }
+    Value* rv = m_DeSSA->getRootValue(V);
+    Value* aV = m_root2AliasMap.find(rv)->second;
+    // Alias offsets are in the unit of the base's element type.
+    return aV->getType() == V->getType() ? aV : nullptr;
+}
+
 // A chain of IEIs is used to define a vector. If all elements of this vector
 // are inserted via this chain IEI that has a constant index, populate AllIEIs.
 //   input:  FirstIEI (first IEI, usually with index = 0)
@@ -988,8 +1007,11 @@ bool VariableReuseAnalysis::processExtractFrom(VecInsEltInfoTy& AllIEIs)
     }
 
     // Implementation restriction
-    if (hasAnyOfDCCAsAliaser(Sub_nv) ||
-        hasAnotherInDCCAsAliasee(Base_nv)) {
+    if (hasAnyOfDCCAsAliaser(Sub_nv)) {
+        return false;
+    }
+    Base_nv = getDCCAliasBase(Base_nv);
+    if (!Base_nv) {
         return false;
     }
 
@@ -1038,7 +1060,8 @@ bool VariableReuseAnalysis::processInsertTo(VecInsEltInfoTy& AllIEIs)
     InsertElementInst* FirstIEI = AllIEIs[0].IEI;
     Value* Base_nv = m_DeSSA->getNodeValue(FirstIEI);
     // Early check to see if Base_nv could be used as Base.
-    if (hasAnotherInDCCAsAliasee(Base_nv)) {
+    Base_nv = getDCCAliasBase(Base_nv);
+    if (!Base_nv) {
         return false;
     }
 
@@ -418,6 +418,10 @@ namespace IGC {
         // If any of V's DCC is an aliaser, return true.
         bool hasAnyOfDCCAsAliaser(llvm::Value* V) const;
         bool hasAnotherInDCCAsAliasee(llvm::Value* V) const;
+        // Return the value to be used as V's alias base: V itself, or the
+        // aliasee already in V's DCC if it has V's type. Return nullptr if
+        // V cannot be used as a base.
+        llvm::Value* getDCCAliasBase(llvm::Value* V) const;
         bool isAliased(llvm::Value* V) const;
 
         // Returns true for the following pattern:
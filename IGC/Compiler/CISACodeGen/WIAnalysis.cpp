@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "AdaptorCommon/ImplicitArgs.hpp"
 #include "Compiler/CISACodeGen/WIAnalysis.hpp"
+#include "Compiler/CISACodeGen/GenCodeGenModule.h"
 #include "Compiler/CISACodeGen/helper.h"
 #include "Compiler/CodeGenContextWrapper.hpp"
 #include "Compiler/CodeGenPublic.h"
@@ -384,6 +385,8 @@ bool WIAnalysis::runOnFunction(Function& F)
     auto* pTT = &getAnalysis<TranslationTable>();
 
     Runner.init(&F, DT, PDT, MDUtils, CGCtx, ModMD, pTT);
+    auto* FGA = getAnalysisIfAvailable<GenXFunctionGroupAnalysis>();
+    Runner.setSubroutineUniformDeps(FGA ? &FGA->getSubroutineUniformDeps() : nullptr);
     return Runner.run();
 }
 
@@ -502,11 +505,13 @@ void WIAnalysisRunner::updateArgsDependency(llvm::Function* pF)
     ae = pF->arg_end();
 
     // 1. add all kernel function args as uniform, or
-    //    add all subroutine function args as random
+    //    add all subroutine function args as random unless they are known
+    //    to be uniform at all call sites
     for (int i = 0; i < implicitArgStart; ++i, ++ai)
     {
         IGC_ASSERT(ai != ae);
-        incUpdateDepend(&(*ai), IsSubroutine ? WIAnalysis::RANDOM : WIAnalysis::UNIFORM_GLOBAL);
+        incUpdateDepend(&(*ai), IsSubroutine ?
+            getSubroutineDep(&(*ai), WIAnalysis::RANDOM) : WIAnalysis::UNIFORM_GLOBAL);
     }
 
     // 2. add implicit args
@@ -1439,9 +1444,26 @@ WIAnalysis::WIDependancy WIAnalysisRunner::calculate_dep(const CallInst* inst)
         }
         return dep;
     }
+
+    // The return value of a subroutine may be known to be uniform.
+    if (const Function* Callee = inst->getCalledFunction())
+    {
+        return getSubroutineDep(Callee, WIAnalysis::RANDOM);
+    }
     return WIAnalysis::RANDOM;
 }
 
+WIAnalysis::WIDependancy WIAnalysisRunner::getSubroutineDep(
+    const Value* V, WIAnalysis::WIDependancy Dflt) const
+{
+    if (!m_subroutineDeps)
+        return Dflt;
+    auto I = m_subroutineDeps->find(V);
+    if (I == m_subroutineDeps->end())
+        return Dflt;
+    return static_cast<WIAnalysis::WIDependancy>(I->second);
+}
+
 WIAnalysis::WIDependancy WIAnalysisRunner::calculate_dep(
     const GetElementPtrInst* inst)
 {
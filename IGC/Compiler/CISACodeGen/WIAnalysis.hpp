@@ -152,9 +152,20 @@ namespace IGC
         // helper for dumping WI info into files with lock
         void lock_print();
 
+        /// Set the uniform dependencies of subroutine arguments and return
+        /// values which hold at all call sites, or nullptr to assume none.
+        void setSubroutineUniformDeps(const llvm::DenseMap<const llvm::Value*, uint8_t>* Deps)
+        {
+            m_subroutineDeps = Deps;
+        }
+
     private:
         WIBaseClass::WIDependancy getCFDependency(const llvm::BasicBlock* BB) const;
 
+        /// @brief return the dependency of a subroutine argument (or of the
+        /// return value of a subroutine) propagated across call sites, or Dflt
+        WIBaseClass::WIDependancy getSubroutineDep(const llvm::Value* V, WIBaseClass::WIDependancy Dflt) const;
+
         struct AllocaDep
         {
             std::vector<const llvm::StoreInst*> stores;
@@ -280,6 +291,7 @@ namespace IGC
         IGC::CodeGenContext* m_CGCtx;
         IGC::ModuleMetaData* m_ModMD;
         IGC::TranslationTable* m_TT;
+        const llvm::DenseMap<const llvm::Value*, uint8_t>* m_subroutineDeps = nullptr;
 
         // Allow access to all the store into an alloca if we were able to track it
         llvm::DenseMap<const llvm::AllocaInst*, AllocaDep> m_allocaDepMap;
@@ -440,6 +440,52 @@ namespace IGC
         }
     }
 
+    namespace
+    {
+        // Context kept alive across compilations on one thread. The pool holds
+        // one reference, so refCount == 1 means no compilation is using it.
+        struct LLVMContextPool
+        {
+            LLVMContextWrapper* context = nullptr;
+            unsigned uses = 0;
+
+            ~LLVMContextPool()
+            {
+                if (context)
+                {
+                    context->Release();
+                }
+            }
+        };
+        thread_local LLVMContextPool s_LLVMContextPool;
+    }
+
+    LLVMContextWrapper* LLVMContextWrapper::getPooledContext()
+    {
+        if (IGC_IS_FLAG_DISABLED(EnableLLVMContextReuse))
+        {
+            return new LLVMContextWrapper;
+        }
+
+        // Uniqued constants and types are only freed with the context, so a
+        // context is replaced after a fixed number of compilations to bound
+        // its growth.
+        LLVMContextPool& pool = s_LLVMContextPool;
+        bool isIdle = pool.context && pool.context->refCount == 1;
+        if (!isIdle || pool.uses >= IGC_GET_FLAG_VALUE(LLVMContextReuseLimit))
+        {
+            if (pool.context)
+            {
+                pool.context->Release();
+            }
+            pool.context = new LLVMContextWrapper;
+            pool.context->AddRef();
+            pool.uses = 0;
+        }
+        pool.uses++;
+        return pool.context;
+    }
+
     /** get shader's thread group size */
     unsigned ComputeShaderContext::GetThreadGroupSize()
     {
@@ -508,6 +554,40 @@ namespace IGC
         return m_slmSize ? spillThresholdSLM : spillThresholdNoSLM;
     }
 
+    OpenCLProgramContext::KernelArgValues::KernelArgValues(const TC::STB_TranslateInputArgs* pInputArgs)
+    {
+        if (pInputArgs == nullptr || pInputArgs->pKernelArgValues == nullptr)
+            return;
+
+        std::istringstream lines(std::string(pInputArgs->pKernelArgValues, pInputArgs->KernelArgValuesSize));
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            std::istringstream fields(line);
+            std::string kernel, value;
+            unsigned argNo = 0;
+            if (!(fields >> kernel >> argNo >> value))
+                continue;
+            char* end = nullptr;
+            uint64_t bits = strtoull(value.c_str(), &end, 0);
+            if (end == value.c_str() || *end != '\0')
+                continue;
+            m_values[kernel][argNo] = bits;
+        }
+    }
+
+    bool OpenCLProgramContext::KernelArgValues::getValue(llvm::StringRef kernel, unsigned argNo, uint64_t& value) const
+    {
+        auto KI = m_values.find(kernel.str());
+        if (KI == m_values.end())
+            return false;
+        auto AI = KI->second.find(argNo);
+        if (AI == KI->second.end())
+            return false;
+        value = AI->second;
+        return true;
+    }
+
     bool OpenCLProgramContext::isSPIRV() const
     {
         return isSpirV;
@@ -552,6 +632,29 @@ namespace IGC
         return CodeGenContext::getNumGRFPerThread();
     }
 
+    bool OpenCLProgramContext::isCompileTimeBudgetLow() const
+    {
+        if (m_InternalOptions.CompileTimeBudgetMs == 0)
+        {
+            return false;
+        }
+
+        // The budget is given per kernel, so scale it by the number of
+        // kernels in the program.
+        uint64_t numKernels = 0;
+        for (const auto& it : getModuleMetaData()->FuncMD)
+        {
+            if (it.second.functionType == KernelFunction)
+            {
+                ++numKernels;
+            }
+        }
+        uint64_t budgetMs = m_InternalOptions.CompileTimeBudgetMs * std::max<uint64_t>(numKernels, 1);
+        uint64_t elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - m_compileStartTime).count();
+        return elapsedMs * 100 >= budgetMs * IGC_GET_FLAG_VALUE(CompileTimeBudgetLowPercent);
+    }
+
     bool OpenCLProgramContext::forceGlobalMemoryAllocation() const
     {
         return m_Options.ForceGlobalMemoryAllocation;
@@ -616,6 +719,10 @@ namespace IGC
     {
         module = (IGCLLVM::Module*)m;
         m_pMdUtils = new IGC::IGCMD::MetaDataUtils(m);
+        // The context owns the only MetaDataUtils of the module, so the
+        // metadata only has to reach the module when it is dumped or
+        // serialized.
+        m_pMdUtils->setDeferSaves(IGC_IS_FLAG_DISABLED(DisableDeferredMetaDataSave));
         modMD = new IGC::ModuleMetaData();
         initCompOptionFromRegkey(this);
     }
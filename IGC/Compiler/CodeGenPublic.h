@@ -19,6 +19,8 @@ SPDX-License-Identifier: MIT
 // hack
 #include "common/debug/Debug.hpp"
 #include "common/debug/Dump.hpp"
+#include <chrono>
+#include <map>
 #include <set>
 #include <string.h>
 #include <sstream>
@@ -103,6 +105,7 @@ namespace IGC
         unsigned int    m_BasicBlockCount = 0;
         void* m_gtpinBuffer = nullptr;              // Will be populated by VISA only when special switch is passed by gtpin
         unsigned int    m_gtpinBufferSize = 0;
+        std::string     m_perfModelReport;          // Populated by VISA only when EnablePerfModelReport is set
         void* m_funcSymbolTable = nullptr;
         unsigned int    m_funcSymbolTableSize = 0;
         unsigned int    m_funcSymbolTableEntries = 0;
@@ -848,6 +851,13 @@ namespace IGC
         SafeIntrinsicIDCacheTy m_SafeIntrinsicIDCache;
         void AddRef();
         void Release();
+
+        /// Returns a context for a new compilation on the calling thread. With
+        /// EnableLLVMContextReuse the context of the previous, finished compilation
+        /// is handed out again, so the types, constants and metadata strings it
+        /// already interned do not have to be rebuilt. As with a new context, the
+        /// caller does not own a reference.
+        static LLVMContextWrapper* getPooledContext();
     };
 
 
@@ -1374,6 +1384,33 @@ namespace IGC
                     // atoi(..) ignores leading white spaces and characters after the actual number
                     numThreadsPerEU = atoi(op + strlen(IGC_MANGLE("-intel-num-thread-per-eu")));
                 }
+                if (const char* op = strstr(options, "-intel-compile-time-budget="))
+                {
+                    // -cl-intel-compile-time-budget=<ms>, -ze-opt-compile-time-budget=<ms>
+                    // Wall-clock budget per kernel in milliseconds.
+                    CompileTimeBudgetMs = (uint32_t)atoi(op + strlen("-intel-compile-time-budget="));
+                }
+                if (const char* op = strstr(options, "-intel-specialize-local-size="))
+                {
+                    // -cl-intel-specialize-local-size=<x>,<y>,<z>, -ze-opt-specialize-local-size=<x>,<y>,<z>
+                    // Local size the kernels are going to be enqueued with. Used by the runtime
+                    // to rebuild a kernel once its launch size is known.
+                    const char* optionVal = op + strlen("-intel-specialize-local-size=");
+                    uint32_t dims[3] = { 0, 0, 0 };
+                    unsigned i = 0;
+                    for (; i < 3 && isdigit(*optionVal); ++i)
+                    {
+                        char* end = nullptr;
+                        dims[i] = (uint32_t)strtoul(optionVal, &end, 10);
+                        optionVal = (i < 2 && *end == ',') ? end + 1 : end;
+                    }
+                    if (i == 3 && dims[0] && dims[1] && dims[2])
+                    {
+                        SpecializedLocalSize[0] = dims[0];
+                        SpecializedLocalSize[1] = dims[1];
+                        SpecializedLocalSize[2] = dims[2];
+                    }
+                }
                 if (strstr(options, "-intel-use-bindless-buffers"))
                 {
                     PromoteStatelessToBindless = true;
@@ -1449,6 +1486,8 @@ namespace IGC
                  // for historical reason, we have this.
 
             bool replaceGlobalOffsetsByZero = false;
+            // Zero unless the local size is specialized.
+            uint32_t SpecializedLocalSize[3] = { 0, 0, 0 };
             bool IntelEnablePreRAScheduling = true;
             bool PromoteStatelessToBindless = false;
             bool PreferBindlessImages = false;
@@ -1466,6 +1505,9 @@ namespace IGC
             bool Intel256GRFPerThread = false;
             bool IntelNumThreadPerEU = false;
             uint32_t numThreadsPerEU = 0;
+
+            // 0 means no compile time budget.
+            uint32_t CompileTimeBudgetMs = 0;
         };
 
         class Options
@@ -1563,11 +1605,27 @@ namespace IGC
             uint32_t requiredEUThreadCount = 0;
         };
 
+        // Known values of scalar kernel arguments requested by the runtime
+        // for a specialized variant of the kernels.
+        class KernelArgValues
+        {
+        public:
+            KernelArgValues(const TC::STB_TranslateInputArgs* pInputArgs);
+
+            bool empty() const { return m_values.empty(); }
+            // Returns the bit pattern of argument argNo of kernel, if known.
+            bool getValue(llvm::StringRef kernel, unsigned argNo, uint64_t& value) const;
+
+        private:
+            std::map<std::string, std::map<unsigned, uint64_t>> m_values;
+        };
+
         // output: shader information
         iOpenCL::CGen8OpenCLProgram m_programOutput;
         SOpenCLProgramInfo m_programInfo;
         const InternalOptions m_InternalOptions;
         const Options m_Options;
+        const KernelArgValues m_KernelArgValues;
         bool isSpirV;
         float m_ProfilingTimerResolution;
         bool m_ShouldUseNonCoherentStatelessBTI;
@@ -1585,8 +1643,10 @@ namespace IGC
             m_programOutput(platform.getPlatformInfo(), *this),
             m_InternalOptions(pInputArgs),
             m_Options(pInputArgs),
+            m_KernelArgValues(pInputArgs),
             isSpirV(false),
-            m_ShouldUseNonCoherentStatelessBTI(shouldUseNonCoherentStatelessBTI)
+            m_ShouldUseNonCoherentStatelessBTI(shouldUseNonCoherentStatelessBTI),
+            m_compileStartTime(std::chrono::steady_clock::now())
         {
         }
         bool isSPIRV() const;
@@ -1599,8 +1659,12 @@ namespace IGC
         bool hasNoLocalToGenericCast() const override;
         bool hasNoPrivateToGenericCast() const override;
         int16_t getVectorCoalescingControl() const override;
+        // Returns true when a compile time budget is set and most of it has
+        // been used, so that cheaper compilation strategies should be taken.
+        bool isCompileTimeBudgetLow() const;
     private:
         llvm::DenseMap<llvm::Function*, std::string> m_hashes_per_kernel;
+        const std::chrono::steady_clock::time_point m_compileStartTime;
     };
 
     void CodeGen(PixelShaderContext* ctx);
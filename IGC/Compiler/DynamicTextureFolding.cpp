@@ -78,6 +78,87 @@ void DynamicTextureFolding::FoldSingleTextureValue(CallInst& I)
         }
     }
 }
+
+void DynamicTextureFolding::FoldResourceFacts(GenIntrinsicInst* pCall)
+{
+    ModuleMetaData* modMD = m_context->getModuleMetaData();
+
+    SampleIntrinsic* sInst = dyn_cast<SampleIntrinsic>(pCall);
+    Value* texOp = nullptr;
+    if (sInst)
+    {
+        texOp = sInst->getTextureValue();
+    }
+    else if (SamplerLoadIntrinsic* lInst = dyn_cast<SamplerLoadIntrinsic>(pCall))
+    {
+        texOp = lInst->getTextureValue();
+    }
+    else
+    {
+        return;
+    }
+
+    bool directIdx = false;
+    uint textureIndex = 0;
+    BufferType bufType = DecodeAS4GFXResource(texOp->getType()->getPointerAddressSpace(), directIdx, textureIndex);
+    if (!directIdx || bufType != RESOURCE)
+        return;
+    auto it = modMD->inlineResourceFacts.find(textureIndex);
+    if (it == modMD->inlineResourceFacts.end())
+        return;
+    const InlineResourceFacts& facts = it->second;
+
+    // Channels the surface format does not store read as (0, 0, 1), so their
+    // extracts fold and the sampler only has to return the stored ones.
+    Type* eltTy = pCall->getType()->getScalarType();
+    bool formatMatches = facts.isIntegerFormat ? eltTy->isIntegerTy() : eltTy->isFloatingPointTy();
+    if (facts.numChannels > 0 && facts.numChannels < 4 && formatMatches)
+    {
+        for (auto iter = pCall->user_begin(); iter != pCall->user_end(); iter++)
+        {
+            if (llvm::ExtractElementInst* pExtract = llvm::dyn_cast<llvm::ExtractElementInst>(*iter))
+            {
+                llvm::ConstantInt* pIdx = llvm::dyn_cast<llvm::ConstantInt>(pExtract->getIndexOperand());
+                if (!pIdx || pIdx->getZExtValue() < facts.numChannels || pIdx->getZExtValue() > 3)
+                    continue;
+                uint64_t value = (pIdx->getZExtValue() == 3) ? 1 : 0;
+                if (facts.isIntegerFormat)
+                {
+                    pExtract->replaceAllUsesWith(ConstantInt::get(eltTy, value));
+                }
+                else
+                {
+                    pExtract->replaceAllUsesWith(ConstantFP::get(eltTy, (double)value));
+                }
+            }
+        }
+    }
+
+    // Every coordinate of a single texel surface addresses the same texel
+    // unless the sampler can return the border color, so the sample does not
+    // depend on its coordinates, gradients or LOD.
+    if (facts.isSingleTexel && sInst)
+    {
+        bool samplerDirectIdx = false;
+        uint samplerIndex = 0;
+        BufferType samplerType = DecodeAS4GFXResource(
+            sInst->getSamplerValue()->getType()->getPointerAddressSpace(), samplerDirectIdx, samplerIndex);
+        auto samplerIt = modMD->inlineSamplerFacts.find(samplerIndex);
+        if (samplerType == SAMPLER && samplerDirectIdx &&
+            samplerIt != modMD->inlineSamplerFacts.end() && samplerIt->second.noBorderAddressing)
+        {
+            for (unsigned int i = 0; i < sInst->getTextureIndex(); i++)
+            {
+                Value* op = sInst->getOperand(i);
+                if (op->getType()->isFloatingPointTy() && !isa<Constant>(op))
+                {
+                    sInst->setOperand(i, ConstantFP::get(op->getType(), 0.0));
+                }
+            }
+        }
+    }
+}
+
 Value* DynamicTextureFolding::ShiftByLOD(Instruction* pCall, unsigned int dimension, Value* val)
 {
     IRBuilder<> builder(pCall);
@@ -249,6 +330,17 @@ void DynamicTextureFolding::visitCallInst(CallInst& I)
                 FoldSingleTextureValue(I);
             }
         }
+        if (!IGC_IS_FLAG_ENABLED(DisableDynamicTextureFolding) && modMD->inlineResourceFacts.size() != 0)
+        {
+            if (ID == GenISAIntrinsic::GenISA_sampleptr ||
+                ID == GenISAIntrinsic::GenISA_sampleLptr ||
+                ID == GenISAIntrinsic::GenISA_sampleBptr ||
+                ID == GenISAIntrinsic::GenISA_sampleDptr ||
+                ID == GenISAIntrinsic::GenISA_ldptr)
+            {
+                FoldResourceFacts(pCall);
+            }
+        }
         if (!IGC_IS_FLAG_ENABLED(DisableDynamicResInfoFolding) && ID == GenISAIntrinsic::GenISA_resinfoptr)
         {
             if ( modMD->inlineResInfoData.size() > 0)
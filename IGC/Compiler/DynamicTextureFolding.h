@@ -55,6 +55,7 @@ namespace IGC
         CodeGenContext* m_context = nullptr;
         std::unordered_map<unsigned, SResInfoFoldingOutput> m_ResInfoFoldingOutput;
         void FoldSingleTextureValue(llvm::CallInst& I);
+        void FoldResourceFacts(llvm::GenIntrinsicInst* pCall);
         template<typename ContextT>
         void copyResInfoData(ContextT* pShaderCtx);
         void FoldResInfoValue(llvm::GenIntrinsicInst* pCall);
@@ -20,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include "llvm/Analysis/CodeMetrics.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Support/raw_ostream.h"
 #include "common/LLVMWarningsPop.hpp"
 
@@ -108,6 +109,198 @@ namespace llvm {
     void GenIntrinsicsTTIImpl::getUnrollingPreferences(Loop* L,
 #if LLVM_VERSION_MAJOR >= 7
         ScalarEvolution & SE,
+#endif
+        TTI::UnrollingPreferences & UP)
+    {
+#if LLVM_VERSION_MAJOR >= 7
+        getBaseUnrollingPreferences(L, SE, UP);
+        ScalarEvolution* pSE = &SE;
+#else
+        getBaseUnrollingPreferences(L, UP);
+        ScalarEvolution* pSE = nullptr;
+#endif
+        if (IGC_IS_FLAG_ENABLED(EnablePressureAwareLoopUnroll))
+        {
+            limitUnrollingForPressure(L, pSE, UP);
+        }
+    }
+
+    // Per-lane bytes of the registers holding V, ignoring predicates.
+    static unsigned getRegBytes(const Value* V, const DataLayout& DL)
+    {
+        Type* Ty = V->getType();
+        if (Ty->isVoidTy() || Ty->isLabelTy() || Ty->isMetadataTy() ||
+            Ty->getScalarType()->isIntegerTy(1))
+        {
+            return 0;
+        }
+        return (unsigned)DL.getTypeAllocSize(Ty);
+    }
+
+    void GenIntrinsicsTTIImpl::limitUnrollingForPressure(Loop* L, ScalarEvolution* SE,
+        TTI::UnrollingPreferences& UP)
+    {
+        // Leave loops with unroll pragmas to the user.
+        if (MDNode* LoopID = L->getLoopID())
+        {
+            for (unsigned i = 1; i < LoopID->getNumOperands(); ++i)
+            {
+                if (MDNode* MD = dyn_cast<MDNode>(LoopID->getOperand(i)))
+                {
+                    if (MDString* S = dyn_cast_or_null<MDString>(MD->getOperand(0)))
+                    {
+                        if (S->getString().startswith("llvm.loop.unroll."))
+                            return;
+                    }
+                }
+            }
+        }
+
+        const DataLayout& DL = L->getHeader()->getModule()->getDataLayout();
+
+        // Values live across the whole loop are not duplicated by unrolling:
+        // loop invariants and the loop-carried header PHIs.
+        SmallPtrSet<const Value*, 32> liveIns;
+        unsigned baseBytes = 0;
+        for (auto& I : *L->getHeader())
+        {
+            if (!isa<PHINode>(&I))
+                break;
+            baseBytes += getRegBytes(&I, DL);
+        }
+
+        // Values an iteration defines are duplicated for every unrolled
+        // copy, so take the peak of those that are live at once. Liveness is
+        // tracked within each block; values used in another block are
+        // considered live to its end.
+        unsigned iterBytes = 0;
+        unsigned numMergeableMemOps = 0;
+        for (BasicBlock* BB : L->blocks())
+        {
+            DenseMap<const Instruction*, unsigned> lastUse;
+            unsigned pos = 0;
+            for (auto& I : *BB)
+            {
+                for (const Value* Op : I.operands())
+                {
+                    auto* OpI = dyn_cast<Instruction>(Op);
+                    if ((OpI && !L->contains(OpI)) || isa<Argument>(Op))
+                    {
+                        if (liveIns.insert(Op).second)
+                            baseBytes += getRegBytes(Op, DL);
+                    }
+                    else if (OpI && OpI->getParent() == BB && !isa<PHINode>(&I))
+                    {
+                        lastUse[OpI] = pos;
+                    }
+                }
+                ++pos;
+            }
+
+            // number of bytes live after each position
+            SmallVector<int, 64> delta(pos + 1, 0);
+            pos = 0;
+            for (auto& I : *BB)
+            {
+                unsigned bytes = isa<PHINode>(&I) && BB == L->getHeader() ? 0 : getRegBytes(&I, DL);
+                if (bytes != 0)
+                {
+                    bool usedElsewhere = llvm::any_of(I.users(), [BB](const User* U) {
+                        auto* UI = dyn_cast<Instruction>(U);
+                        return !UI || UI->getParent() != BB || isa<PHINode>(UI);
+                    });
+                    auto it = lastUse.find(&I);
+                    if (usedElsewhere || it != lastUse.end())
+                    {
+                        delta[pos] += bytes;
+                        delta[usedElsewhere ? delta.size() - 1 : it->second] -= bytes;
+                    }
+                }
+
+                if (SE && L->empty())
+                {
+                    // Loads and stores walking memory by their own size
+                    // become adjacent once unrolled, which MemOpt merges.
+                    Value* Ptr = nullptr;
+                    Type* AccessTy = nullptr;
+                    if (auto* LI = dyn_cast<LoadInst>(&I))
+                    {
+                        Ptr = LI->getPointerOperand();
+                        AccessTy = LI->getType();
+                    }
+                    else if (auto* SI = dyn_cast<StoreInst>(&I))
+                    {
+                        Ptr = SI->getPointerOperand();
+                        AccessTy = SI->getValueOperand()->getType();
+                    }
+                    if (Ptr && AccessTy->isSingleValueType() && DL.getTypeStoreSize(AccessTy) <= 4)
+                    {
+                        auto* AR = dyn_cast<SCEVAddRecExpr>(SE->getSCEV(Ptr));
+                        if (AR && AR->getLoop() == L && AR->isAffine())
+                        {
+                            auto* Step = dyn_cast<SCEVConstant>(AR->getStepRecurrence(*SE));
+                            if (Step && Step->getAPInt() == DL.getTypeStoreSize(AccessTy))
+                                numMergeableMemOps++;
+                        }
+                    }
+                }
+                ++pos;
+            }
+
+            int live = 0;
+            for (int d : delta)
+            {
+                live += d;
+                iterBytes = std::max(iterBytes, (unsigned)std::max(live, 0));
+            }
+        }
+
+        if (iterBytes == 0)
+            return;
+
+        // Registers of a SIMD16 thread, in per-lane bytes
+        const unsigned simdLanes = 16;
+        unsigned budget = ctx->getNumGRFPerThread() * ctx->platform.getGRFSize() / simdLanes;
+        budget = budget * IGC_GET_FLAG_VALUE(LoopUnrollGRFBudgetPercent) / 100;
+        unsigned maxFactor = budget > baseBytes ? (budget - baseBytes) / iterBytes : 0;
+        maxFactor = std::max(maxFactor, 1u);
+
+        UP.MaxCount = std::min(UP.MaxCount, maxFactor);
+        if (UP.Count > maxFactor)
+            UP.Count = maxFactor;
+#if LLVM_VERSION_MAJOR >= 7
+        UP.FullUnrollMaxCount = std::min(UP.FullUnrollMaxCount, maxFactor);
+#endif
+
+        // Partially unroll small loops whose accesses can then be merged, up
+        // to a vector of four.
+        unsigned TripCount = 0;
+        if (SE)
+        {
+            BasicBlock* ExitingBlock = L->getLoopLatch();
+            if (!ExitingBlock || !L->isLoopExiting(ExitingBlock))
+                ExitingBlock = L->getExitingBlock();
+            if (ExitingBlock)
+                TripCount = SE->getSmallConstantTripCount(L, ExitingBlock);
+        }
+        if (numMergeableMemOps != 0 && UP.Count == 0 && !UP.Partial &&
+            TripCount > maxFactor && maxFactor >= 2)
+        {
+            unsigned count = maxFactor >= 4 ? 4 : 2;
+            while (count > 1 && TripCount % count != 0)
+                count /= 2;
+            if (count > 1)
+            {
+                UP.Partial = true;
+                UP.Count = count;
+                UP.MaxCount = count;
+            }
+        }
+    }
+
+    void GenIntrinsicsTTIImpl::getBaseUnrollingPreferences(Loop* L,
+#if LLVM_VERSION_MAJOR >= 7
+        ScalarEvolution & SE,
 #endif
         TTI::UnrollingPreferences & UP)
     {
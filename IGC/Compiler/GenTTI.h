@@ -34,6 +34,18 @@ namespace llvm
         friend BaseT;
         IGC::CodeGenContext* ctx;
         DummyPass* dummyPass;
+
+        void getBaseUnrollingPreferences(Loop* L,
+#if LLVM_VERSION_MAJOR >= 7
+            ScalarEvolution & SE,
+#endif
+            TTI::UnrollingPreferences & UP);
+
+        // Cap the unroll factor of L to what its estimated register pressure
+        // allows. SE may be null.
+        void limitUnrollingForPressure(Loop* L, ScalarEvolution* SE,
+            TTI::UnrollingPreferences & UP);
+
     public:
         GenIntrinsicsTTIImpl(IGC::CodeGenContext* pCtx, DummyPass* pDummyPass) :
             BaseT(pCtx->getModule()->getDataLayout()), ctx(pCtx) {
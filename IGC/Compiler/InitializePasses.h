@@ -20,6 +20,7 @@ void initializeAddressSpaceAliasAnalysisPass(llvm::PassRegistry&);
 void initializeAnnotateUniformAllocasPass(llvm::PassRegistry&);
 void initializeAggregateArgumentsAnalysisPass(llvm::PassRegistry&);
 void initializeAlignmentAnalysisPass(llvm::PassRegistry&);
+void initializeAtomicAggregationPass(llvm::PassRegistry&);
 void initializePreBIImportAnalysisPass(llvm::PassRegistry&);
 void initializeBIImportPass(llvm::PassRegistry&);
 void initializeBlockCoalescingPass(llvm::PassRegistry&);
@@ -61,6 +62,7 @@ void initializeSplitIndirectEEtoSelPass(llvm::PassRegistry&);
 void initializeGenXFunctionGroupAnalysisPass(llvm::PassRegistry&);
 void initializeGenXCodeGenModulePass(llvm::PassRegistry&);
 void initializeEstimateFunctionSizePass(llvm::PassRegistry&);
+void initializeInterproceduralUniformityPass(llvm::PassRegistry&);
 void initializeSubroutineInlinerPass(llvm::PassRegistry&);
 void initializeHandleLoadStoreInstructionsPass(llvm::PassRegistry&);
 void initializeIGCConstPropPass(llvm::PassRegistry&);
@@ -151,8 +153,12 @@ void initializeCodeAssumptionPass(llvm::PassRegistry&);
 void initializeIGCInstructionCombiningPassPass(llvm::PassRegistry&);
 void initializeIntDivConstantReductionPass(llvm::PassRegistry&);
 void initializeIntDivRemCombinePass(llvm::PassRegistry&);
+void initializeIntDivInvariantReductionPass(llvm::PassRegistry&);
 void initializeGenRotatePass(llvm::PassRegistry&);
 void initializeSynchronizationObjectCoalescingPass(llvm::PassRegistry&);
+void initializeLoopInvariantLoadMotionPass(llvm::PassRegistry&);
+void initializeShaderProfileLoaderPass(llvm::PassRegistry&);
+void initializeShaderProfileInstrumentationPass(llvm::PassRegistry&);
 void initializeMoveStaticAllocasPass(llvm::PassRegistry&);
 void initializeNamedBarriersResolutionPass(llvm::PassRegistry&);
 void initializeUndefinedReferencesPassPass(llvm::PassRegistry&);
@@ -192,15 +192,8 @@ void PeepholeTypeLegalizer::legalizeExtractElement(Instruction& I)
     //%61 = extractelement <2 x i128> %60, i<anysize> 0
     // ->
     //%157 = bitcast <2 x i128> %60 to <8 x i32>
-    //%165 = extractelement <8 x i32> %157, i32 0
-    //%166 = insertelement <4 x i32> undef, i32 %165, i32 0
-    //%167 = extractelement <8 x i32> %157, i32 1
-    //%168 = insertelement <4 x i32> %166, i32 %167, i32 1
-    //%169 = extractelement <8 x i32> %157, i32 2
-    //%170 = insertelement <4 x i32> %168, i32 %169, i32 2
-    //%171 = extractelement <8 x i32> %157, i32 3
-    //%172 = insertelement <4 x i32> %170, i32 %171, i32 3
-    //%173 = bitcast <4 x i32> %172 to i128
+    //%158 = shufflevector <8 x i32> %157, <8 x i32> undef, <4 x i32> <i32 0, i32 1, i32 2, i32 3>
+    //%159 = bitcast <4 x i32> %158 to i128
 
     ExtractElementInst* extract = cast<ExtractElementInst>(&I);
 
@@ -218,15 +211,15 @@ void PeepholeTypeLegalizer::legalizeExtractElement(Instruction& I)
         Value* legalVector = m_builder->CreateBitCast(extract->getOperand(0), newVecTy);
 
         unsigned extractIndex = (unsigned)cast<ConstantInt>(extract->getOperand(1))->getZExtValue();
-        Value* extractedVec = UndefValue::get(IGCLLVM::FixedVectorType::get(Type::getIntNTy(I.getContext(), promoteToInt), quotient));
-
+        std::vector<Constant*> Vals;
         for (unsigned i = 0; i < quotient; i++)
         {
             unsigned index = extractIndex * quotient + i;
             IGC_ASSERT(index < quotient * numElements);
-            Value* extractedVal = m_builder->CreateExtractElement(legalVector, m_builder->getInt32(index));
-            extractedVec = m_builder->CreateInsertElement(extractedVec, extractedVal, m_builder->getInt32(i));
+            Vals.push_back(m_builder->getInt32(index));
         }
+        Value* extractedVec = m_builder->CreateShuffleVector(legalVector,
+            UndefValue::get(newVecTy), ConstantVector::get(Vals));
 
         // Bitcast legal value back to original type. Will be removed in a later pass to cleanup bitcasts
         Value* revBitcast = m_builder->CreateBitCast(extractedVec, extract->getType());
@@ -321,65 +314,54 @@ void PeepholeTypeLegalizer::legalizeBinaryOperator(Instruction& I) {
             IGCLLVM::FixedVectorType::get(llvm::Type::getIntNTy(I.getContext(), promoteToInt), quotient));
         Value* NewLargeSrc2VecForm = m_builder->CreateBitCast(NewLargeSrc2,
             IGCLLVM::FixedVectorType::get(llvm::Type::getIntNTy(I.getContext(), promoteToInt), quotient));
-        Value* NewLargeResVecForm = UndefValue::get(IGCLLVM::FixedVectorType::get(llvm::Type::getIntNTy(I.getContext(), promoteToInt), quotient));
-
-        bool instSupported = true;
-        for (unsigned Idx = 0; Idx < quotient; Idx++)
+        // The supported operations work on all lanes of the legal vector at
+        // once, there is no need to go through each element.
+        Value* NewLargeResVecForm = nullptr;
+        switch (I.getOpcode()) {
+        case Instruction::And:
+            NewLargeResVecForm = m_builder->CreateAnd(NewLargeSrc1VecForm, NewLargeSrc2VecForm);
+            break;
+        case Instruction::Or:
+            NewLargeResVecForm = m_builder->CreateOr(NewLargeSrc1VecForm, NewLargeSrc2VecForm);
+            break;
+        case Instruction::Xor:
+            NewLargeResVecForm = m_builder->CreateXor(NewLargeSrc1VecForm, NewLargeSrc2VecForm);
+            break;
+        case Instruction::LShr:
         {
-            Value* NewInst = NULL;
-            switch (I.getOpcode()) {
-            case Instruction::And:
-                NewInst = m_builder->CreateAnd(m_builder->CreateExtractElement(NewLargeSrc1VecForm, Idx),
-                    m_builder->CreateExtractElement(NewLargeSrc2VecForm, Idx));
-                break;
-            case Instruction::Or:
-                NewInst = m_builder->CreateOr(m_builder->CreateExtractElement(NewLargeSrc1VecForm, Idx),
-                    m_builder->CreateExtractElement(NewLargeSrc2VecForm, Idx));
-                break;
-            case Instruction::Xor:
-                NewInst = m_builder->CreateXor(m_builder->CreateExtractElement(NewLargeSrc1VecForm, Idx),
-                    m_builder->CreateExtractElement(NewLargeSrc2VecForm, Idx));
-                break;
-            case Instruction::LShr:
-            {
-                if (auto val = dyn_cast<ConstantInt>(Src2)) {
-                    unsigned offset = (unsigned)val->getSExtValue() / promoteToInt;
+            if (auto val = dyn_cast<ConstantInt>(Src2)) {
+                // Lanes shifted in from beyond the vector are taken from the
+                // zero vector.
+                unsigned offset = (unsigned)val->getSExtValue() / promoteToInt;
+                std::vector<Constant*> Vals;
+                for (unsigned Idx = 0; Idx < quotient; Idx++)
+                {
                     unsigned elementToMove = Idx + offset;
-
-                    if (elementToMove < quotient)
-                        NewInst = m_builder->CreateExtractElement(NewLargeSrc1VecForm, elementToMove);
-                    else
-                        NewInst = ConstantInt::get(IntegerType::get(I.getContext(), promoteToInt), 0, true);
-                }
-                else {
-                    instSupported = false;
-                    IGC_ASSERT_MESSAGE(0, "Shift by amount is not a constant.");
+                    Vals.push_back(m_builder->getInt32(elementToMove < quotient ? elementToMove : quotient));
                 }
-                break;
+                NewLargeResVecForm = m_builder->CreateShuffleVector(NewLargeSrc1VecForm,
+                    Constant::getNullValue(NewLargeSrc1VecForm->getType()), ConstantVector::get(Vals));
             }
-            case Instruction::Add:
-                instSupported = false;
-                IGC_ASSERT_MESSAGE(0, "Add Instruction seen with 'large' illegal int type. Legalization support missing.");
-                break;
-            case Instruction::ICmp:
-                instSupported = false;
-                IGC_ASSERT_MESSAGE(0, "ICmp Instruction seen with 'large' illegal int type. Legalization support missing.");
-                break;
-            case Instruction::Select:
-                instSupported = false;
-                IGC_ASSERT_MESSAGE(0, "Select Instruction seen with 'large' illegal int type. Legalization support missing.");
-                break;
-            default:
-                printf("Binary Instruction seen with illegal int type. Legalization support missing. Inst opcode:%d", I.getOpcode());
-                IGC_ASSERT_MESSAGE(0, "Binary Instruction seen with illegal int type. Legalization support missing.");
-                break;
+            else {
+                IGC_ASSERT_MESSAGE(0, "Shift by amount is not a constant.");
             }
-            if (instSupported)
-                NewLargeResVecForm = m_builder->CreateInsertElement(NewLargeResVecForm, NewInst, Idx);
-            else
-                break;
+            break;
+        }
+        case Instruction::Add:
+            IGC_ASSERT_MESSAGE(0, "Add Instruction seen with 'large' illegal int type. Legalization support missing.");
+            break;
+        case Instruction::ICmp:
+            IGC_ASSERT_MESSAGE(0, "ICmp Instruction seen with 'large' illegal int type. Legalization support missing.");
+            break;
+        case Instruction::Select:
+            IGC_ASSERT_MESSAGE(0, "Select Instruction seen with 'large' illegal int type. Legalization support missing.");
+            break;
+        default:
+            printf("Binary Instruction seen with illegal int type. Legalization support missing. Inst opcode:%d", I.getOpcode());
+            IGC_ASSERT_MESSAGE(0, "Binary Instruction seen with illegal int type. Legalization support missing.");
+            break;
         }
-        if (instSupported) {
+        if (NewLargeResVecForm) {
             // Re-bitcast vector into Large illegal type which is to be in turn trunc'ed to original illegal type
             NewLargeSrc1 = m_builder->CreateBitCast(NewLargeResVecForm, NewLargeSrc1->getType());
             Value* NewIllegal = m_builder->CreateTrunc(NewLargeSrc1, Src1->getType());
@@ -633,11 +615,8 @@ void PeepholeTypeLegalizer::legalizeUnaryInstruction(Instruction& I) {
         // %1 = trunc i192 %0 to i128
         // -->
         // %1 = bitcast i192 %0 to <3 x i64>
-        // %2 = extractelement %1, 0
-        // %3 = insertelement %undef, %2, 0
-        // %4 = extractelement %1, 1
-        // %5 = insertelement %3, %4, 1
-        // %6 = bitcast <2 x i64> %5 to i128
+        // %2 = shufflevector <3 x i64> %1, <3 x i64> undef, <2 x i32> <i32 0, i32 1>
+        // %3 = bitcast <2 x i64> %2 to i128
         unsigned dstSize = I.getType()->getScalarSizeInBits();
         unsigned srcSize = I.getOperand(0)->getType()->getScalarSizeInBits();
 
@@ -667,13 +646,12 @@ void PeepholeTypeLegalizer::legalizeUnaryInstruction(Instruction& I) {
 
         // Bitcast the illegal src type to a legal vector
         Value* srcVec = m_builder->CreateBitCast(I.getOperand(0), srcVecTy);
-        Value* dstVec = UndefValue::get(dstVecTy);
-
+        std::vector<Constant*> Vals;
         for (unsigned i = 0; i < numDstElements; i++)
-        {
-            Value* v = m_builder->CreateExtractElement(srcVec, m_builder->getInt32(i));
-            dstVec = m_builder->CreateInsertElement(dstVec, v, m_builder->getInt32(i));
-        }
+            Vals.push_back(m_builder->getInt32(i));
+        Value* dstVec = m_builder->CreateShuffleVector(srcVec,
+            UndefValue::get(srcVecTy), ConstantVector::get(Vals));
+        IGC_ASSERT(dstVec->getType() == dstVecTy);
         // Cast back to original dst type
         Value* result = m_builder->CreateBitCast(dstVec, I.getType());
         I.replaceAllUsesWith(result);
@@ -749,17 +727,14 @@ void PeepholeTypeLegalizer::cleanupZExtInst(Instruction& I) {
                 if ((promoteToInt * quotient) == I.getType()->getScalarSizeInBits()) { // rhis is the case for all trunc-zext pairs generated by first step of this legalization pass
                     Value* truncSrcAsVec = m_builder->CreateBitCast(prevInst->getOperand(0),
                         IGCLLVM::FixedVectorType::get(llvm::Type::getIntNTy(I.getContext(), promoteToInt), quotient));
-                    Value* vecRes = UndefValue::get(IGCLLVM::FixedVectorType::get(llvm::Type::getIntNTy(I.getContext(), promoteToInt), quotient));
-                    Value* Elmt;
-                    Value* maskedElmt;
-
+                    // Mask all lanes with a single vector and.
+                    std::vector<Constant*> Masks;
                     for (unsigned Idx = 0; Idx < quotient; ++Idx) {
-                        Elmt = m_builder->CreateExtractElement(truncSrcAsVec, Idx);
                         mask >>= 64 - std::min(64, activeBits);
-                        maskedElmt = m_builder->CreateAnd(Elmt, mask);
-                        m_builder->CreateInsertElement(vecRes, maskedElmt, Idx);
+                        Masks.push_back(ConstantInt::get(IntegerType::get(I.getContext(), promoteToInt), mask));
                         activeBits -= std::min(64, activeBits);
                     }
+                    Value* vecRes = m_builder->CreateAnd(truncSrcAsVec, ConstantVector::get(Masks));
                     Value* bitcastBackToScalar = m_builder->CreateBitCast(vecRes, prevInst->getType());
 
                     I.replaceAllUsesWith(bitcastBackToScalar);
@@ -17,6 +17,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/Support/CommandLine.h>
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/InstIterator.h>
+#include <llvm/Transforms/Utils/Local.h>
 #include "common/LLVMWarningsPop.hpp"
 
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
@@ -63,6 +64,7 @@ bool LowPrecisionOpt::runOnFunction(Function& F)
     m_builder = &builder;
     m_currFunction = &F;
     shdrType = ctx->type;
+    m_supportFP16 = ctx->platform.supportFP16();
     bundles.clear();
     m_simplifyAlu = true;
     m_changeSample = false;
@@ -137,6 +139,20 @@ void LowPrecisionOpt::visitFPTruncInst(llvm::FPTruncInst& I)
     {
         return;
     }
+    if (m_supportFP16 && IGC_IS_FLAG_ENABLED(EnableNativeHalfArithmetic) &&
+        I.getType()->getScalarType()->isHalfTy() &&
+        canComputeInHalf(I.getOperand(0), true))
+    {
+        m_builder->SetInsertPoint(&I);
+        Value* halfResult = computeInHalf(I.getOperand(0));
+        Value* floatResult = I.getOperand(0);
+        I.replaceAllUsesWith(halfResult);
+        I.eraseFromParent();
+        RecursivelyDeleteTriviallyDeadInstructions(floatResult);
+        m_changed = true;
+        return;
+    }
+
     llvm::GenIntrinsicInst* cInst = llvm::dyn_cast<llvm::GenIntrinsicInst>(I.getOperand(0));
 
     if (cInst &&
@@ -153,6 +169,89 @@ void LowPrecisionOpt::visitFPTruncInst(llvm::FPTruncInst& I)
     }
 }
 
+// Float add, sub, mul and div of two values extended from half and rounded
+// back to half give the correctly rounded half result, since float has more
+// than 2 * 11 + 2 bits of mantissa, so the operation can be done natively on
+// halves. Operations feeding another one round only once in float, so they
+// go to half too only with fast math or ForceNativeHalfArithmetic.
+bool LowPrecisionOpt::canComputeInHalf(Value* V, bool isRoot) const
+{
+    if (auto* ext = dyn_cast<FPExtInst>(V))
+    {
+        return ext->getSrcTy()->getScalarType()->isHalfTy();
+    }
+    if (auto* C = dyn_cast<ConstantFP>(V))
+    {
+        bool losesInfo = false;
+        APFloat value = C->getValueAPF();
+        value.convert(APFloat::IEEEhalf(), APFloat::rmNearestTiesToEven, &losesInfo);
+        return !losesInfo;
+    }
+
+    auto* inst = dyn_cast<Instruction>(V);
+    if (!inst || !inst->hasOneUse() || !inst->getType()->getScalarType()->isFloatTy())
+    {
+        return false;
+    }
+    if (inst->getOpcode() == Instruction::FNeg)
+    {
+        return canComputeInHalf(inst->getOperand(0), isRoot);
+    }
+    switch (inst->getOpcode())
+    {
+    case Instruction::FAdd:
+    case Instruction::FSub:
+    case Instruction::FMul:
+    case Instruction::FDiv:
+        break;
+    default:
+        return false;
+    }
+    if (!isRoot && !inst->isFast() && IGC_IS_FLAG_DISABLED(ForceNativeHalfArithmetic))
+    {
+        return false;
+    }
+    return canComputeInHalf(inst->getOperand(0), false) &&
+        canComputeInHalf(inst->getOperand(1), false);
+}
+
+Value* LowPrecisionOpt::computeInHalf(Value* V)
+{
+    if (auto* ext = dyn_cast<FPExtInst>(V))
+    {
+        return ext->getOperand(0);
+    }
+    if (auto* C = dyn_cast<ConstantFP>(V))
+    {
+        bool losesInfo = false;
+        APFloat value = C->getValueAPF();
+        value.convert(APFloat::IEEEhalf(), APFloat::rmNearestTiesToEven, &losesInfo);
+        return ConstantFP::get(m_builder->getContext(), value);
+    }
+
+    auto* inst = cast<Instruction>(V);
+    Value* result = nullptr;
+    if (inst->getOpcode() == Instruction::FNeg)
+    {
+        result = m_builder->CreateFNeg(computeInHalf(inst->getOperand(0)));
+    }
+    else
+    {
+        Value* src0 = computeInHalf(inst->getOperand(0));
+        Value* src1 = computeInHalf(inst->getOperand(1));
+        result = m_builder->CreateBinOp(
+            cast<BinaryOperator>(inst)->getOpcode(), src0, src1);
+    }
+    if (auto* resultInst = dyn_cast<Instruction>(result))
+    {
+        resultInst->copyFastMathFlags(inst);
+    }
+#if VALUE_NAME_ENABLE
+    result->setName(inst->getName());
+#endif
+    return result;
+}
+
 // If all the uses of a sampler instruction are converted to a different floating point type
 // try to propagate the type in the sampler
 bool LowPrecisionOpt::propagateSamplerType(llvm::GenIntrinsicInst& I)
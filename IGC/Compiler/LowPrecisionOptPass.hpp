@@ -80,5 +80,12 @@ namespace IGC
         void visitIntrinsicInst(llvm::IntrinsicInst& I);
         void visitCallInst(llvm::CallInst& I);
         bool propagateSamplerType(llvm::GenIntrinsicInst& I);
+
+        /// Native packed half arithmetic: rewrite float math whose inputs
+        /// are halves and whose result is truncated back to half as half
+        /// math.
+        bool canComputeInHalf(llvm::Value* V, bool isRoot) const;
+        llvm::Value* computeInHalf(llvm::Value* V);
+        bool m_supportFP16 = false;
     };
 } // namespace IGC
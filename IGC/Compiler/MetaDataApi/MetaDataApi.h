@@ -1070,7 +1070,18 @@ namespace IGC {
                 m_FunctionsInfo.erase(it);
             }
 
+            /// Commit the changes made through this object. When saves are
+            /// deferred the metadata is only kept in memory until flush().
             void save(llvm::LLVMContext& context)
+            {
+                if (!m_deferSaves)
+                {
+                    flush(context);
+                }
+            }
+
+            /// Write the pending changes into the module metadata.
+            void flush(llvm::LLVMContext& context)
             {
                 if (m_FunctionsInfo.dirty())
                 {
@@ -1087,6 +1098,15 @@ namespace IGC {
                 discardChanges();
             }
 
+            /// With deferred saves, passes only update this object and the
+            /// module metadata is rewritten by flush(), when the module is
+            /// dumped or serialized. Only valid when nothing reads
+            /// "igc.functions" from the module in between.
+            void setDeferSaves(bool defer)
+            {
+                m_deferSaves = defer;
+            }
+
             void discardChanges()
             {
                 m_FunctionsInfo.discardChanges();
@@ -1107,6 +1127,7 @@ namespace IGC {
             NamedMetaDataMap<llvm::Function, FunctionInfoMetaDataHandle> m_FunctionsInfo;
             llvm::Module* m_pModule;
             std::vector<llvm::NamedMDNode*> m_nodesToDelete;
+            bool m_deferSaves = false;
         };
 
 
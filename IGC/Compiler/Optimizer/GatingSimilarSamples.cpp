@@ -7,6 +7,7 @@ SPDX-License-Identifier: MIT
 ============================= end_copyright_notice ===========================*/
 
 #include "GatingSimilarSamples.hpp"
+#include "Compiler/ShaderProfile.hpp"
 #include "common/IGCIRBuilder.h"
 #include "common/igc_regkeys.hpp"
 #include "GenISAIntrinsics/GenIntrinsics.h"
@@ -402,6 +403,13 @@ bool GatingSimilarSamples::runOnFunction(llvm::Function& F)
         return false;
     BB = &*F.getBasicBlockList().begin();
 
+    // The gate only saves the similar samples when the motion is zero on all
+    // lanes; skip it if the runtime measured the shader as divergent.
+    std::unique_ptr<ShaderProfile> profile =
+        ShaderProfile::load(getAnalysis<CodeGenContextWrapper>().getCodeGenContext());
+    if (profile && profile->isDivergent(BB))
+        return false;
+
     if (!checkAndSaveSimilarSampleInsts())
         return false;
 
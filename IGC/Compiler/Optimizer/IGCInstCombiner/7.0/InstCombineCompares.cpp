@@ -4704,8 +4704,9 @@ Instruction* InstCombiner::visitICmpInst(ICmpInst& I) {
     if (Instruction * Res = foldICmpWithConstant(I))
         return Res;
 
-    if (Instruction * Res = foldICmpUsingKnownBits(I))
-        return Res;
+    if (!FastMode)
+        if (Instruction * Res = foldICmpUsingKnownBits(I))
+            return Res;
 
     // Test if the ICmpInst instruction is used exclusively by a select as
     // part of a minimum or maximum operation. If so, refrain from doing
@@ -702,6 +702,14 @@ namespace IGCombiner {
         /// Maximum size of array considered when transforming.
         uint64_t MaxArraySizeForCombine;
 
+        /// Set on functions too big for the full combiner; skips the folds
+        /// that are costly and rarely pay off there.
+        bool FastMode = false;
+
+        /// Maximum number of instructions run() takes off the worklist, 0
+        /// for no limit. The rest of the worklist is dropped once reached.
+        uint64_t MaxVisits = 0;
+
     private:
         /// Performs a few simplifications for operators which are associative
         /// or commutative.
@@ -51,6 +51,7 @@ See LICENSE.TXT for details.
 //===----------------------------------------------------------------------===//
 
 #include "Compiler/IGCPassSupport.h"
+#include "common/igc_regkeys.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include "../IGCInstructionCombining.hpp"
 #include "InstCombineInternal.h"
@@ -2990,7 +2991,15 @@ static bool TryToSinkInstruction(Instruction* I, BasicBlock* DestBlock) {
 }
 
 bool InstCombiner::run() {
+    uint64_t NumVisits = 0;
     while (!Worklist.isEmpty()) {
+        if (MaxVisits && ++NumVisits > MaxVisits) {
+            LLVM_DEBUG(dbgs() << "IC: worklist budget exhausted\n");
+            while (!Worklist.isEmpty())
+                Worklist.RemoveOne();
+            break;
+        }
+
         Instruction* I = Worklist.RemoveOne();
         if (I == nullptr) continue;  // skip null values.
 
@@ -3318,6 +3327,16 @@ static bool combineInstructionsOverFunction(
     if (ShouldLowerDbgDeclare)
         MadeIRChange = LowerDbgDeclare(F);
 
+    // Big functions get a bounded number of iterations and worklist visits,
+    // and none of the combines that are only worth it on small ones.
+    uint64_t NumInsts = 0;
+    for (auto& BB : F)
+        NumInsts += BB.size();
+    const unsigned FastModeThreshold = IGC_GET_FLAG_VALUE(InstCombineFastModeThreshold);
+    const bool FastMode = FastModeThreshold != 0 && NumInsts >= FastModeThreshold;
+    if (FastMode)
+        ExpensiveCombines = false;
+
     // Iterate while there is work to do.
     int Iteration = 0;
     while (true) {
@@ -3330,9 +3349,15 @@ static bool combineInstructionsOverFunction(
         InstCombiner IC(Worklist, Builder, F.optForMinSize(), ExpensiveCombines, AA,
             AC, TLI, DT, ORE, DL, LI);
         IC.MaxArraySizeForCombine = MaxArraySize;
+        if (FastMode) {
+            IC.FastMode = true;
+            IC.MaxVisits = NumInsts * IGC_GET_FLAG_VALUE(InstCombineFastModeVisitsPerInst);
+        }
 
         if (!IC.run())
             break;
+        if (FastMode && Iteration >= (int)IGC_GET_FLAG_VALUE(InstCombineFastModeMaxIterations))
+            break;
     }
 
     return MadeIRChange || Iteration > 1;
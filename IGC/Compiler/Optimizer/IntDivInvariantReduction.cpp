@@ -0,0 +1,232 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "GenISAIntrinsics/GenIntrinsics.h"
+#include "Compiler/Optimizer/IntDivInvariantReduction.hpp"
+#include "Compiler/IGCPassSupport.h"
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Intrinsics.h"
+#include "llvm/Pass.h"
+#include "common/LLVMWarningsPop.hpp"
+#include "Probe/Assertion.h"
+#include "Compiler/CISACodeGen/helper.h"
+
+using namespace llvm;
+
+// This pass reduces 32b division and remainder instructions whose divisor is
+// a loop-invariant runtime value, e.g. a tensor dimension passed as a kernel
+// argument, which are otherwise expanded to the division emulation in each
+// iteration.
+//
+// The approximate reciprocal is computed once in the preheader of the
+// outermost loop the divisor is invariant in, using the branch-free unsigned
+// algorithm of libdivide (c.f. also Hacker's Delight 10-9):
+//
+//   l     = floor(log2(d))
+//   m     = floor(2^(32+l) / d), r = 2^(32+l) - m*d
+//   magic = 2*m + 1 + (2*r >= d), shift = l    (d not a power of two)
+//   magic = 0,                    shift = l-1  (d a power of two)
+//
+// and each division in the loop becomes
+//
+//   %q = mulh %n, magic
+//   %t = add (lshr (sub %n, %q), 1), %q
+//   %q = lshr %t, shift
+//
+// selecting %n itself when d is 1. Signed divisions go through the absolute
+// values and fix up the sign of the quotient; remainders are recomputed from
+// the quotient.
+struct IntDivInvariantReduction : public FunctionPass
+{
+    static char ID;
+
+    IntDivInvariantReduction();
+
+    /// @brief  Provides name of pass
+    virtual StringRef getPassName() const override {
+        return "IntDivInvariantReductionPass";
+    }
+
+    virtual void getAnalysisUsage(AnalysisUsage& AU) const override {
+        AU.setPreservesCFG();
+        AU.addRequired<LoopInfoWrapperPass>();
+        AU.addPreserved<LoopInfoWrapperPass>();
+    }
+
+    virtual bool runOnFunction(Function& F) override {
+        LoopInfo &LI = getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+        SmallVector<std::pair<BinaryOperator*, Loop*>, 4> divRems;
+
+        for (auto ii = inst_begin(F), ie = inst_end(F); ii != ie; ii++) {
+            Instruction *I = &*ii;
+            switch (I->getOpcode()) {
+            case Instruction::SDiv:
+            case Instruction::UDiv:
+            case Instruction::SRem:
+            case Instruction::URem:
+                if (!I->getType()->isIntegerTy(32) ||
+                    isa<Constant>(I->getOperand(1)))
+                    break;
+                if (Loop *L = getHoistingLoop(LI, I))
+                    divRems.push_back(std::make_pair(cast<BinaryOperator>(I), L));
+                break;
+            default: break;
+            }
+        }
+
+        for (auto &R : reciprocals)
+            R.clear();
+        for (auto &DL : divRems) {
+            expandDivRemByInvariant(F, DL.first, DL.second);
+        }
+        for (auto &R : reciprocals)
+            R.clear();
+
+        return !divRems.empty();
+    } // runOnFunction
+
+private:
+    struct Reciprocal {
+        Value *divisor = nullptr; // |d| for signed divisions
+        Value *magic = nullptr;
+        Value *shift = nullptr;
+        Value *isOne = nullptr;
+    };
+
+    // keyed by the divisor, preheader and signedness
+    DenseMap<std::pair<Value*, BasicBlock*>, Reciprocal> reciprocals[2];
+
+    // outermost loop with a preheader the divisor is invariant in
+    Loop *getHoistingLoop(LoopInfo &LI, Instruction *divRem) const {
+        Value *divisor = divRem->getOperand(1);
+        Loop *hoistLoop = nullptr;
+        for (Loop *L = LI.getLoopFor(divRem->getParent());
+             L && L->isLoopInvariant(divisor) && L->getLoopPreheader();
+             L = L->getParentLoop())
+        {
+            hoistLoop = L;
+        }
+        return hoistLoop;
+    }
+
+    static Value *createAbs(IRBuilder<> &B, Value *x) {
+        //   %s = ashr %x, 31
+        //   %a = sub (xor %x, %s), %s
+        Value *sign = B.CreateAShr(x, 31);
+        return B.CreateSub(B.CreateXor(x, sign), sign);
+    }
+
+    const Reciprocal &getReciprocal(
+        Function &F, Value *divisor, BasicBlock *preheader, bool isSigned)
+    {
+        Reciprocal &R = reciprocals[isSigned][std::make_pair(divisor, preheader)];
+        if (R.magic)
+            return R;
+
+        IRBuilder<> B(preheader->getTerminator());
+        Value *d = isSigned ? createAbs(B, divisor) : divisor;
+
+        Function *ctlz = Intrinsic::getDeclaration(
+            F.getParent(), Intrinsic::ctlz, B.getInt32Ty());
+        Value *log2d = B.CreateSub(B.getInt32(31),
+            B.CreateCall(ctlz, { d, B.getFalse() }), "log2d");
+        Value *isPow2 = B.CreateICmpEQ(
+            B.CreateAnd(d, B.CreateSub(d, B.getInt32(1))), B.getInt32(0));
+        R.isOne = B.CreateICmpEQ(d, B.getInt32(1), "d_is_one");
+
+        // m = 2^(32+l) / d; the divisor is not guaranteed to be non-zero
+        // before the loop, so avoid introducing a division by zero here.
+        Value *isZero = B.CreateICmpEQ(d, B.getInt32(0));
+        Value *safeD = B.CreateSelect(isZero, B.getInt32(1), d);
+        Value *num = B.CreateShl(B.getInt64(1),
+            B.CreateZExt(B.CreateAdd(log2d, B.getInt32(32)), B.getInt64Ty()));
+        Value *m = B.CreateTrunc(
+            B.CreateUDiv(num, B.CreateZExt(safeD, B.getInt64Ty())), B.getInt32Ty());
+        // the low half of 2^(32+l) is zero
+        Value *rem = B.CreateNeg(B.CreateMul(m, safeD));
+        Value *twiceRem = B.CreateAdd(rem, rem);
+        Value *roundUp = B.CreateOr(
+            B.CreateICmpUGE(twiceRem, safeD), B.CreateICmpULT(twiceRem, rem));
+        Value *magic = B.CreateAdd(B.CreateAdd(m, m),
+            B.CreateAdd(B.CreateZExt(roundUp, B.getInt32Ty()), B.getInt32(1)));
+
+        R.divisor = d;
+        R.magic = B.CreateSelect(isPow2, B.getInt32(0), magic, "d_magic");
+        // powers of two shift by l-1 after halving; 1 is selected away
+        Value *pow2Shift = B.CreateSelect(R.isOne, B.getInt32(0),
+            B.CreateSub(log2d, B.getInt32(1)));
+        R.shift = B.CreateSelect(isPow2, pow2Shift, log2d, "d_shift");
+        return R;
+    }
+
+    void expandDivRemByInvariant(Function &F, BinaryOperator *divRem, Loop *L) {
+        bool isMod =
+            divRem->getOpcode() == Instruction::SRem ||
+            divRem->getOpcode() == Instruction::URem;
+        bool isSigned =
+            divRem->getOpcode() == Instruction::SDiv ||
+            divRem->getOpcode() == Instruction::SRem;
+        Value *dividend = divRem->getOperand(0);
+        Value *divisor = divRem->getOperand(1);
+
+        const Reciprocal &R = getReciprocal(F, divisor, L->getLoopPreheader(), isSigned);
+
+        IRBuilder<> B(divRem);
+        Value *n = isSigned ? createAbs(B, dividend) : dividend;
+        Value *q = IGC::CreateMulh(F, B, false, n, R.magic);
+        Value *t = B.CreateAdd(B.CreateLShr(B.CreateSub(n, q), 1), q);
+        q = B.CreateLShr(t, R.shift);
+        q = B.CreateSelect(R.isOne, n, q, "q");
+        if (isSigned) {
+            //   %s = ashr (xor %n, %d), 31
+            //   %q = sub (xor %q, %s), %s
+            Value *sign = B.CreateAShr(B.CreateXor(dividend, divisor), 31);
+            q = B.CreateSub(B.CreateXor(q, sign), sign, "q");
+        }
+
+        Value *result = q;
+        if (isMod) {
+            //   r = n - (n/d)*d
+            Value *qd = B.CreateMul(q, divisor, "q_times_d");
+            result = B.CreateSub(dividend, qd, "rem");
+        }
+
+        divRem->replaceAllUsesWith(result);
+        result->takeName(divRem);
+        divRem->eraseFromParent();
+    }
+};
+
+char IntDivInvariantReduction::ID = 0;
+
+// Register pass to igc-opt
+#define PASS_FLAG "igc-intdiv-invariant-red"
+#define PASS_DESCRIPTION "Integer Division Loop-Invariant Reduction"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(IntDivInvariantReduction,
+    PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_END(IntDivInvariantReduction,
+        PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+IntDivInvariantReduction::IntDivInvariantReduction() : FunctionPass(ID) {
+    initializeIntDivInvariantReductionPass(*PassRegistry::getPassRegistry());
+}
+
+llvm::FunctionPass* IGC::createIntDivInvariantReductionPass()
+{
+    return new IntDivInvariantReduction();
+}
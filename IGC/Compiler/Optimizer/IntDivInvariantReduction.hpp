@@ -0,0 +1,23 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "Compiler/IGCPassSupport.h"
+#include "IGC/common/Types.hpp"
+
+#include <llvm/Pass.h>
+
+
+namespace llvm {class FunctionPass;}
+namespace IGC
+{
+  // replace 32b div and rem by loop-invariant divisors with
+  // a multiply by a reciprocal computed in the loop preheader
+  llvm::FunctionPass* createIntDivInvariantReductionPass();
+} // namespace IGC
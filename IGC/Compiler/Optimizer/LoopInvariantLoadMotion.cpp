@@ -0,0 +1,258 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/Optimizer/LoopInvariantLoadMotion.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/IGCPassSupport.h"
+#include "GenISAIntrinsics/GenIntrinsicInst.h"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/IR/Instructions.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <set>
+
+using namespace llvm;
+using namespace IGC;
+
+namespace {
+
+    class LoopInvariantLoadMotion : public FunctionPass
+    {
+    public:
+        static char ID;
+
+        LoopInvariantLoadMotion() : FunctionPass(ID)
+        {
+            initializeLoopInvariantLoadMotionPass(*PassRegistry::getPassRegistry());
+        }
+
+        StringRef getPassName() const override
+        {
+            return "LoopInvariantLoadMotion";
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesCFG();
+            AU.addRequired<DominatorTreeWrapperPass>();
+            AU.addRequired<LoopInfoWrapperPass>();
+            AU.addPreserved<DominatorTreeWrapperPass>();
+            AU.addPreserved<LoopInfoWrapperPass>();
+        }
+
+        bool runOnFunction(Function& F) override;
+
+    private:
+        // Address spaces which may be written, or made visible to, by the loop.
+        struct LoopClobbers
+        {
+            bool all = false;
+            bool local = false;
+            bool global = false;
+            std::set<unsigned> addrSpaces;
+        };
+
+        bool processLoop(Loop* L);
+        void collectClobbers(Loop* L, LoopClobbers& clobbers) const;
+        bool isClobbered(const LoadInst* LI, const LoopClobbers& clobbers) const;
+        bool isGuaranteedToExecute(const Instruction* I, const Loop* L) const;
+
+        DominatorTree* m_DT = nullptr;
+        LoopInfo* m_LI = nullptr;
+    };
+
+} // namespace
+
+char LoopInvariantLoadMotion::ID = 0;
+
+#define PASS_FLAG     "igc-loop-invariant-load-motion"
+#define PASS_DESC     "Hoist loop-invariant loads across synchronization"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(LoopInvariantLoadMotion, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(DominatorTreeWrapperPass)
+IGC_INITIALIZE_PASS_DEPENDENCY(LoopInfoWrapperPass)
+IGC_INITIALIZE_PASS_END(LoopInvariantLoadMotion, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+FunctionPass* IGC::createLoopInvariantLoadMotionPass()
+{
+    return new LoopInvariantLoadMotion();
+}
+
+bool LoopInvariantLoadMotion::runOnFunction(Function& F)
+{
+    m_DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
+    m_LI = &getAnalysis<LoopInfoWrapperPass>().getLoopInfo();
+
+    // Innermost loops first, so that loads hoisted into the preheader of an
+    // inner loop can then move out of the outer one.
+    bool changed = false;
+    SmallVector<Loop*, 8> loops = m_LI->getLoopsInPreorder();
+    for (auto I = loops.rbegin(), E = loops.rend(); I != E; ++I)
+    {
+        changed |= processLoop(*I);
+    }
+    return changed;
+}
+
+void LoopInvariantLoadMotion::collectClobbers(Loop* L, LoopClobbers& clobbers) const
+{
+    // GenISA_memoryfence operand telling whether global memory is fenced,
+    // SLM is always.
+    const unsigned globalMemFenceArg = 5;
+
+    for (BasicBlock* BB : L->blocks())
+    {
+        for (auto& I : *BB)
+        {
+            if (!I.mayWriteToMemory())
+                continue;
+
+            if (auto* SI = dyn_cast<StoreInst>(&I))
+            {
+                clobbers.addrSpaces.insert(SI->getPointerAddressSpace());
+            }
+            else if (auto* RMW = dyn_cast<AtomicRMWInst>(&I))
+            {
+                clobbers.addrSpaces.insert(RMW->getPointerAddressSpace());
+            }
+            else if (auto* CmpXchg = dyn_cast<AtomicCmpXchgInst>(&I))
+            {
+                clobbers.addrSpaces.insert(CmpXchg->getPointerAddressSpace());
+            }
+            else if (auto* GII = dyn_cast<GenIntrinsicInst>(&I))
+            {
+                switch (GII->getIntrinsicID())
+                {
+                case GenISAIntrinsic::GenISA_threadgroupbarrier:
+                    // other threads' SLM writes become visible
+                    clobbers.local = true;
+                    break;
+                case GenISAIntrinsic::GenISA_memoryfence:
+                    clobbers.local = true;
+                    if (auto* isGlobal = dyn_cast<ConstantInt>(GII->getOperand(globalMemFenceArg)))
+                    {
+                        clobbers.global |= isGlobal->isOne();
+                    }
+                    else
+                    {
+                        clobbers.global = true;
+                    }
+                    break;
+                default:
+                {
+                    // typed writes, atomics and the like; look at where they point
+                    bool hasPtrArg = false;
+                    for (Value* arg : GII->arg_operands())
+                    {
+                        if (arg->getType()->isPointerTy())
+                        {
+                            clobbers.addrSpaces.insert(arg->getType()->getPointerAddressSpace());
+                            hasPtrArg = true;
+                        }
+                    }
+                    clobbers.all |= !hasPtrArg;
+                    break;
+                }
+                }
+            }
+            else
+            {
+                clobbers.all = true;
+            }
+        }
+    }
+}
+
+bool LoopInvariantLoadMotion::isClobbered(const LoadInst* LI, const LoopClobbers& clobbers) const
+{
+    // constant and read-only (see MarkReadOnlyLoad) memory never changes
+    const unsigned AS = LI->getPointerAddressSpace();
+    if (AS == ADDRESS_SPACE_CONSTANT || LI->getMetadata(LLVMContext::MD_invariant_load))
+        return false;
+    if (clobbers.all || clobbers.addrSpaces.count(ADDRESS_SPACE_GENERIC))
+        return true;
+
+    switch (AS)
+    {
+    case ADDRESS_SPACE_LOCAL:
+        return clobbers.local || clobbers.addrSpaces.count(ADDRESS_SPACE_LOCAL);
+    case ADDRESS_SPACE_PRIVATE:
+        return clobbers.addrSpaces.count(ADDRESS_SPACE_PRIVATE);
+    default:
+        // global memory may also be accessed through stateful resources
+        if (clobbers.global)
+            return true;
+        for (unsigned clobberedAS : clobbers.addrSpaces)
+        {
+            if (clobberedAS != ADDRESS_SPACE_LOCAL && clobberedAS != ADDRESS_SPACE_PRIVATE)
+                return true;
+        }
+        return false;
+    }
+}
+
+// A load executes at least once whenever the loop is entered if it
+// dominates all the exiting blocks, so hoisting it cannot add a fault.
+bool LoopInvariantLoadMotion::isGuaranteedToExecute(const Instruction* I, const Loop* L) const
+{
+    SmallVector<BasicBlock*, 4> exitingBlocks;
+    L->getExitingBlocks(exitingBlocks);
+    if (exitingBlocks.empty())
+        return false;
+    for (BasicBlock* BB : exitingBlocks)
+    {
+        if (!m_DT->dominates(I->getParent(), BB))
+            return false;
+    }
+    return true;
+}
+
+bool LoopInvariantLoadMotion::processLoop(Loop* L)
+{
+    BasicBlock* preheader = L->getLoopPreheader();
+    if (!preheader)
+        return false;
+
+    LoopClobbers clobbers;
+    collectClobbers(L, clobbers);
+
+    SmallVector<LoadInst*, 16> candidates;
+    for (BasicBlock* BB : L->blocks())
+    {
+        // loads of inner loops were handled with them
+        if (m_LI->getLoopFor(BB) != L)
+            continue;
+        for (auto& I : *BB)
+        {
+            auto* LI = dyn_cast<LoadInst>(&I);
+            if (LI && LI->isUnordered() && !LI->isVolatile())
+                candidates.push_back(LI);
+        }
+    }
+
+    bool changed = false;
+    for (LoadInst* LI : candidates)
+    {
+        if (isClobbered(LI, clobbers) || !isGuaranteedToExecute(LI, L))
+            continue;
+        bool hoisted = false;
+        if (!L->makeLoopInvariant(LI->getPointerOperand(), hoisted, preheader->getTerminator()))
+        {
+            changed |= hoisted;
+            continue;
+        }
+        LI->moveBefore(preheader->getTerminator());
+        changed = true;
+    }
+    return changed;
+}
@@ -0,0 +1,27 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    /// @brief Hoist loop-invariant loads from constant, read-only, SLM and
+    /// global memory out of loops.
+    ///
+    /// LICM gives up on such loads as soon as the loop contains a barrier, a
+    /// fence or an atomic, as all of them are opaque memory writes to alias
+    /// analysis. This pass knows which address spaces these can make writes
+    /// visible in: a thread group barrier or a fence only invalidates loads
+    /// from the address spaces it synchronizes, so e.g. a loop with an SLM
+    /// only fence keeps its global loads invariant.
+    llvm::FunctionPass* createLoopInvariantLoadMotionPass();
+} // namespace IGC
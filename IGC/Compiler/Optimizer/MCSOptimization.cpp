@@ -62,6 +62,7 @@ private:
         }
         return false;
     }
+    LdmsInstrinsic* CreateSharedSampleLoad(LdmcsInstrinsic* ldMcs, ExtractElementInst* mcsLow, LdmsInstrinsic* refUse);
 protected:
 };
 
@@ -79,6 +80,63 @@ bool MCSOptimization::runOnFunction(Function& F)
     return m_changed;
 }
 
+// Creates a load of sample 0 at the pixel read by refUse, placed right after both mcs
+// channels are available. Returns nullptr if the pixel is not known at that point,
+// that is if refUse reads it using values other than the operands of the ldmcs.
+LdmsInstrinsic* MCSOptimization::CreateSharedSampleLoad(
+    LdmcsInstrinsic* ldMcs, ExtractElementInst* mcsLow, LdmsInstrinsic* refUse)
+{
+    if (IGC_IS_FLAG_ENABLED(DisableMCSOptSharedFetch))
+    {
+        return nullptr;
+    }
+
+    Instruction* insertAfter = mcsLow;
+    Value* mcsHigh = refUse->getMcsOperand(1);
+    if (ExtractElementInst* mcsHighInst = dyn_cast<ExtractElementInst>(mcsHigh))
+    {
+        if (mcsHighInst->getVectorOperand() != ldMcs || mcsHighInst->getParent() != mcsLow->getParent())
+        {
+            return nullptr;
+        }
+        for (auto it = mcsLow->getIterator(); it != mcsLow->getParent()->end(); ++it)
+        {
+            if (&*it == mcsHighInst)
+            {
+                insertAfter = mcsHighInst;
+                break;
+            }
+        }
+    }
+    else if (!isa<Constant>(mcsHigh))
+    {
+        return nullptr;
+    }
+
+    for (unsigned int i = 3; i < refUse->getNumArgOperands(); i++)
+    {
+        Value* op = refUse->getOperand(i);
+        if (isa<Constant>(op) || isa<Argument>(op))
+        {
+            continue;
+        }
+        bool isLdmcsOperand = false;
+        for (unsigned int j = 0; j < ldMcs->getNumArgOperands(); j++)
+        {
+            isLdmcsOperand |= (ldMcs->getOperand(j) == op);
+        }
+        if (!isLdmcsOperand)
+        {
+            return nullptr;
+        }
+    }
+
+    Instruction* sharedLoad = refUse->clone();
+    sharedLoad->setOperand(0, ConstantInt::get(refUse->getOperand(0)->getType(), 0));
+    sharedLoad->insertAfter(insertAfter);
+    return cast<LdmsInstrinsic>(sharedLoad);
+}
+
 void MCSOptimization::visitCallInst(llvm::CallInst& I)
 {
     Function* F = I.getParent()->getParent();
@@ -138,8 +196,8 @@ void MCSOptimization::visitCallInst(llvm::CallInst& I)
 
         if (EEI != nullptr)
         {
-            if (EEI->hasOneUse())
-                return; //only one use of EEI -- noOptimization
+            if (EEI->hasOneUse() && isa<ConstantInt>(EEI->user_back()->getOperand(0)))
+                return; //only one use of EEI with a known sample -- noOptimization
 
             LdmsInstrinsic* firstUse = nullptr;
 
@@ -156,25 +214,32 @@ void MCSOptimization::visitCallInst(llvm::CallInst& I)
                 }
             }
 
-            if (!firstUse)
-                return;
-
             //collect all blocks where this EEI insts is getting used
+            //all of them must read the same pixel, the sample index may be dynamic (e.g. a loop over samples)
             std::set<BasicBlock*> useBlocks;
+            LdmsInstrinsic* refUse = nullptr;
             for (auto BitcastUses = EEI->user_begin(); BitcastUses != EEI->user_end(); BitcastUses++)
             {
-                Instruction* ldmsInst = dyn_cast<Instruction>(*BitcastUses);
-                if (ldmsInst)
+                LdmsInstrinsic* ldmsInst = dyn_cast<LdmsInstrinsic>(*BitcastUses);
+                if (!ldmsInst || ldmsInst->getOperand(1) != EEI)
+                    return;
+                if (!refUse)
+                    refUse = ldmsInst;
+                for (unsigned int i = 2; i < ldmsInst->getNumArgOperands(); i++)
                 {
-                    if (dyn_cast<ConstantInt>(ldmsInst->getOperand(0)))
-                    {
-                        useBlocks.insert(ldmsInst->getParent());
-                    }
-                    else
-                    {
+                    if (ldmsInst->getOperand(i) != refUse->getOperand(i))
                         return;
-                    }
                 }
+                useBlocks.insert(ldmsInst->getParent());
+            }
+
+            if (!firstUse)
+            {
+                //No load in the def's BB to fall back to: fetch sample 0 right after the mcs is known,
+                //so that loads in later blocks and loop iterations can skip their own fetch.
+                firstUse = CreateSharedSampleLoad(ldMcs, EEI, refUse);
+                if (!firstUse)
+                    return;
             }
 
             //iterate over useBlocks.
@@ -0,0 +1,117 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+#include "Compiler/Optimizer/OpenCLPasses/KernelArgSpecialization.h"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+
+using namespace llvm;
+using namespace IGC;
+using namespace IGC::IGCMD;
+
+// The runtime may request a variant of the kernels for known values of some
+// of their scalar arguments (e.g. strides or tile sizes that never change
+// between launches). The uses of these arguments are replaced by constants,
+// which the following optimizations fold through address computations and
+// loop bounds. The arguments stay in the kernel signature so that the payload
+// layout is the same as for the generic kernel.
+//
+// This runs after KernelFunctionCloning, so kernels that are also called as
+// user functions are specialized only in their entry point version.
+
+namespace {
+    class KernelArgSpecialization : public ModulePass {
+    public:
+        static char ID;
+
+        KernelArgSpecialization() : ModulePass(ID) {}
+
+        bool runOnModule(Module&) override;
+
+        llvm::StringRef getPassName() const override {
+            return "KernelArgSpecialization";
+        }
+
+    private:
+        void getAnalysisUsage(AnalysisUsage& AU) const override {
+            AU.setPreservesCFG();
+            AU.addRequired<CodeGenContextWrapper>();
+            AU.addRequired<MetaDataUtilsWrapper>();
+        }
+
+        static Constant* getArgConstant(Type* Ty, uint64_t Bits);
+    };
+
+} // End anonymous namespace
+
+namespace IGC {
+
+    ModulePass* createKernelArgSpecializationPass() {
+        return new KernelArgSpecialization();
+    }
+
+#define PASS_FLAG "igc-kernel-arg-specialization"
+#define PASS_DESC "Specialize kernels for known scalar argument values"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+    IGC_INITIALIZE_PASS_BEGIN(KernelArgSpecialization, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+        IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+        IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
+        IGC_INITIALIZE_PASS_END(KernelArgSpecialization, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+} // End IGC namespace
+
+char KernelArgSpecialization::ID = 0;
+
+// Only integer and floating point scalars are specialized; pointers, images
+// and aggregates are left alone.
+Constant* KernelArgSpecialization::getArgConstant(Type* Ty, uint64_t Bits) {
+    if (auto* ITy = dyn_cast<IntegerType>(Ty)) {
+        if (ITy->getBitWidth() > 64)
+            return nullptr;
+        return ConstantInt::get(ITy, Bits);
+    }
+    if (Ty->isHalfTy() || Ty->isFloatTy() || Ty->isDoubleTy()) {
+        unsigned Width = Ty->getPrimitiveSizeInBits();
+        APInt Int(Width, Width < 64 ? Bits & ((uint64_t(1) << Width) - 1) : Bits);
+        return ConstantFP::get(Ty->getContext(), APFloat(Ty->getFltSemantics(), Int));
+    }
+    return nullptr;
+}
+
+bool KernelArgSpecialization::runOnModule(Module& M) {
+    CodeGenContext* Ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    if (Ctx->type != ShaderType::OPENCL_SHADER)
+        return false;
+    auto& ArgValues = static_cast<OpenCLProgramContext*>(Ctx)->m_KernelArgValues;
+    if (ArgValues.empty())
+        return false;
+
+    MetaDataUtils* MDU = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    bool Changed = false;
+    for (auto& F : M) {
+        if (F.isDeclaration() || MDU->findFunctionsInfoItem(&F) == MDU->end_FunctionsInfo())
+            continue;
+        for (auto& Arg : F.args()) {
+            uint64_t Bits = 0;
+            if (Arg.use_empty() || !ArgValues.getValue(F.getName(), Arg.getArgNo(), Bits))
+                continue;
+            if (Constant* C = getArgConstant(Arg.getType(), Bits)) {
+                Arg.replaceAllUsesWith(C);
+                Changed = true;
+            }
+        }
+    }
+    return Changed;
+}
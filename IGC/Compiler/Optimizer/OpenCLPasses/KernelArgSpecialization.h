@@ -0,0 +1,24 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef _OPENCL_KERNELARGSPECIALIZATION_H_
+#define _OPENCL_KERNELARGSPECIALIZATION_H_
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include <llvm/PassRegistry.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC {
+
+    void initializeKernelArgSpecializationPass(llvm::PassRegistry&);
+    llvm::ModulePass* createKernelArgSpecializationPass();
+
+} // End IGC namespace
+
+#endif // _OPENCL_KERNELARGSPECIALIZATION_H_
@@ -407,6 +407,45 @@ bool KernelArg::typeAlwaysNeedsAllocation() const
     return m_argType < KernelArg::ArgType::NOT_TO_ALLOCATE;
 }
 
+bool KernelArg::isPayloadOnlyImplicitArg() const
+{
+    // Buffers the runtime allocates or sets up because the kernel has the
+    // argument (private memory, printf, sync buffer, device enqueue) are not
+    // payload only.
+    switch (m_argType)
+    {
+    case KernelArg::ArgType::IMPLICIT_BUFFER_OFFSET:
+    case KernelArg::ArgType::IMPLICIT_WORK_DIM:
+    case KernelArg::ArgType::IMPLICIT_NUM_GROUPS:
+    case KernelArg::ArgType::IMPLICIT_GLOBAL_SIZE:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_SIZE:
+    case KernelArg::ArgType::IMPLICIT_ENQUEUED_LOCAL_WORK_SIZE:
+    case KernelArg::ArgType::IMPLICIT_STAGE_IN_GRID_ORIGIN:
+    case KernelArg::ArgType::IMPLICIT_STAGE_IN_GRID_SIZE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_HEIGHT:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_WIDTH:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_DEPTH:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_NUM_MIP_LEVELS:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_CHANNEL_DATA_TYPE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_CHANNEL_ORDER:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_SRGB_CHANNEL_ORDER:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_ARRAY_SIZE:
+    case KernelArg::ArgType::IMPLICIT_IMAGE_NUM_SAMPLES:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_ADDRESS:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_NORMALIZED:
+    case KernelArg::ArgType::IMPLICIT_SAMPLER_SNAP_WA:
+    case KernelArg::ArgType::IMPLICIT_FLAT_IMAGE_BASEOFFSET:
+    case KernelArg::ArgType::IMPLICIT_FLAT_IMAGE_HEIGHT:
+    case KernelArg::ArgType::IMPLICIT_FLAT_IMAGE_WIDTH:
+    case KernelArg::ArgType::IMPLICIT_FLAT_IMAGE_PITCH:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_START_ADDRESS:
+    case KernelArg::ArgType::IMPLICIT_LOCAL_MEMORY_STATELESS_WINDOW_SIZE:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool KernelArg::needsAllocation() const
 {
     return m_needsAllocation;
@@ -213,6 +213,9 @@ namespace IGC
         unsigned int                    getLocationCount()      const;
         iOpenCL::DATA_PARAMETER_TOKEN   getDataParamToken()     const;
         bool                            typeAlwaysNeedsAllocation() const;
+        /// @brief  Whether the runtime only writes the argument to the payload, so that an unused
+        ///         argument can be left out of the payload without any other effect
+        bool                            isPayloadOnlyImplicitArg() const;
         bool                            getImgAccessedFloatCoords() const { return m_imageInfo.accessedByFloatCoord; }
         bool                            getImgAccessedIntCoords()   const { return m_imageInfo.accessedByIntCoord; }
         bool                            isImplicitArg() const { return m_implicitArgument; }
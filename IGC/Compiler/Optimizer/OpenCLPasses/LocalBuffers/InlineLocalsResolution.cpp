@@ -15,10 +15,16 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Dominators.h>
+#include <llvm/Analysis/LoopInfo.h>
+#include <llvm/Analysis/PostDominators.h>
 #include <llvmWrapper/Support/Alignment.h>
 #include "common/LLVMWarningsPop.hpp"
 #include "Probe/Assertion.h"
+#include "common/debug/Debug.hpp"
 
+#include <fstream>
 #include <unordered_set>
 
 using namespace llvm;
@@ -94,12 +100,162 @@ static bool useAsPointerOnly(Value* V) {
     return true;
 }
 
+static bool isWorkGroupBarrier(const Instruction* I)
+{
+    auto* CI = dyn_cast<CallInst>(I);
+    Function* Callee = CI ? CI->getCalledFunction() : nullptr;
+    return Callee && Callee->getName() == "__builtin_IB_thread_group_barrier";
+}
+
+static bool isMemFence(const Instruction* I)
+{
+    auto* CI = dyn_cast<CallInst>(I);
+    Function* Callee = CI ? CI->getCalledFunction() : nullptr;
+    return Callee &&
+        (Callee->getName() == "__builtin_IB_memfence" || Callee->getName() == "__intel_memfence_handler");
+}
+
+// Collects the instructions through which the local variable G is accessed.
+// Fails if G is used outside of F or its address escapes.
+static bool collectAccesses(GlobalVariable* G, Function* F, SmallVectorImpl<Instruction*>& Accesses)
+{
+    SmallPtrSet<Value*, 16> Visited;
+    SmallVector<Value*, 16> WorkList;
+    WorkList.push_back(G);
+
+    while (!WorkList.empty()) {
+        Value* V = WorkList.pop_back_val();
+        for (auto* U : V->users()) {
+            if (!Visited.insert(U).second)
+                continue;
+            if (auto* CE = dyn_cast<ConstantExpr>(U)) {
+                if (!CE->isCast() && CE->getOpcode() != Instruction::GetElementPtr)
+                    return false;
+                WorkList.push_back(CE);
+                continue;
+            }
+            auto* I = dyn_cast<Instruction>(U);
+            if (!I || I->getFunction() != F)
+                return false;
+            switch (I->getOpcode()) {
+            default:
+                return false;
+            case Instruction::Store:
+                // Bail out if it's used as the value operand.
+                if (cast<StoreInst>(I)->getValueOperand() == V)
+                    return false;
+                break;
+            case Instruction::Load:
+                break;
+            case Instruction::Call:
+                // Builtins and intrinsics may only access memory through a
+                // pointer argument, not pass it on.
+                if (!cast<CallInst>(I)->getCalledFunction() ||
+                    !cast<CallInst>(I)->getCalledFunction()->isDeclaration() ||
+                    I->getType()->isPointerTy())
+                    return false;
+                break;
+            case Instruction::GetElementPtr:
+            case Instruction::BitCast:
+            case Instruction::AddrSpaceCast:
+            case Instruction::PHI:
+            case Instruction::Select:
+                WorkList.push_back(I);
+                break;
+            }
+            Accesses.push_back(I);
+        }
+    }
+    return true;
+}
+
+// Rows of 2D local arrays of dwords that span a multiple of the SLM banks map
+// a column to the same bank, so lanes walking a column, e.g. tile[lid][k] in
+// transpose or GEMM kernels, conflict. Pad the rows by one dword to spread
+// the columns across the banks.
+void InlineLocalsResolution::padLocalArrays(Module& M)
+{
+    const unsigned SLMBankCount = 16;
+
+    SmallVector<GlobalVariable*, 4> Candidates;
+    for (GlobalVariable& G : M.globals())
+    {
+        if (G.getType()->getAddressSpace() != ADDRESS_SPACE_LOCAL ||
+            !G.hasInitializer() || !isa<UndefValue>(G.getInitializer()) ||
+            G.getMetadata(LLVMContext::MD_dbg))
+        {
+            continue;
+        }
+
+        auto* ArrTy = dyn_cast<ArrayType>(G.getValueType());
+        auto* RowTy = ArrTy ? dyn_cast<ArrayType>(ArrTy->getElementType()) : nullptr;
+        if (!RowTy || ArrTy->getNumElements() < 2 || RowTy->getNumElements() % SLMBankCount != 0)
+        {
+            continue;
+        }
+        Type* EltTy = RowTy->getElementType();
+        if (!EltTy->isFloatTy() && !EltTy->isIntegerTy(32))
+        {
+            continue;
+        }
+
+        // Only rewrite arrays accessed through fully indexed GEPs, of which at
+        // least one walks a column.
+        bool HasColumnWalk = false;
+        bool AllIndexed = true;
+        for (auto* U : G.users())
+        {
+            auto* GEP = dyn_cast<GetElementPtrInst>(U);
+            if (!GEP || GEP->getPointerOperand() != &G || GEP->getNumIndices() != 3 ||
+                !isa<ConstantInt>(GEP->getOperand(1)) || !cast<ConstantInt>(GEP->getOperand(1))->isZero())
+            {
+                AllIndexed = false;
+                break;
+            }
+            HasColumnWalk |= !isa<Constant>(GEP->getOperand(2));
+        }
+        if (AllIndexed && HasColumnWalk)
+        {
+            Candidates.push_back(&G);
+        }
+    }
+
+    for (GlobalVariable* G : Candidates)
+    {
+        auto* ArrTy = cast<ArrayType>(G->getValueType());
+        auto* RowTy = cast<ArrayType>(ArrTy->getElementType());
+        Type* PaddedTy = ArrayType::get(
+            ArrayType::get(RowTy->getElementType(), RowTy->getNumElements() + 1), ArrTy->getNumElements());
+
+        auto* Padded = new GlobalVariable(M, PaddedTy, false, G->getLinkage(), UndefValue::get(PaddedTy),
+            "", G, GlobalVariable::ThreadLocalMode::NotThreadLocal, ADDRESS_SPACE_LOCAL);
+        Padded->setAlignment(IGCLLVM::getCorrectAlign(G->getAlignment()));
+        Padded->takeName(G);
+
+        SmallVector<User*, 8> Users(G->user_begin(), G->user_end());
+        for (auto* U : Users)
+        {
+            auto* GEP = cast<GetElementPtrInst>(U);
+            SmallVector<Value*, 3> Indices(GEP->idx_begin(), GEP->idx_end());
+            auto* NewGEP = GetElementPtrInst::Create(PaddedTy, Padded, Indices, "", GEP);
+            NewGEP->setIsInBounds(GEP->isInBounds());
+            NewGEP->setDebugLoc(GEP->getDebugLoc());
+            NewGEP->takeName(GEP);
+            GEP->replaceAllUsesWith(NewGEP);
+            GEP->eraseFromParent();
+        }
+        G->eraseFromParent();
+    }
+}
+
 bool InlineLocalsResolution::runOnModule(Module& M)
 {
     MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
     ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
     if (!modMD->compOpt.OptDisable)
       filterGlobals(M);
+    if (!modMD->compOpt.OptDisable && IGC_IS_FLAG_ENABLED(EnableSLMLayoutOpt))
+      padLocalArrays(M);
     // Compute the offset of each inline local in the kernel,
     // and their total size.
     llvm::MapVector<Function*, unsigned int> sizeMap;
@@ -489,6 +645,13 @@ void InlineLocalsResolution::computeOffsetList(Module& M, llvm::MapVector<Functi
     {
         Function* F = I.first;
 
+        if (IGC_IS_FLAG_ENABLED(EnableSLMLayoutOpt) && !modMD->compOpt.OptDisable &&
+            isEntryFunc(pMdUtils, F))
+        {
+            computeSharedOffsets(F, I.second, DL, offsetMap[F], sizeMap[F]);
+            continue;
+        }
+
         // loop through all global variables
         for (auto G : I.second)
         {
@@ -556,10 +719,123 @@ void InlineLocalsResolution::computeOffsetList(Module& M, llvm::MapVector<Functi
             localOffset.m_Offset = Offset;
             modMD->FuncMD[iter.first].localOffsets.push_back(localOffset);
         }
+
+        if (IGC_IS_FLAG_ENABLED(DumpSLMLayout))
+        {
+            std::stringstream FileName;
+            FileName << IGC::Debug::GetShaderOutputFolder() << "SLMLayout.txt";
+            std::ofstream Dump(FileName.str(), std::ios::app);
+            Dump << iter.first->getName().str() << " localSize=" << iter.second << std::endl;
+            for (const auto& offsetIter : offsetMap[iter.first])
+            {
+                Dump << "  " << offsetIter.first->getName().str() << " offset=" << offsetIter.second << std::endl;
+            }
+        }
     }
     pMdUtils->save(M.getContext());
 }
 
+// Lays out the local variables of kernel F, letting variables whose accesses
+// are separated by a work-group barrier share the same memory: once all work
+// items passed the barrier, none of them reads the first variable anymore.
+// A barrier only separates accesses if it is preceded by a memory fence and
+// executed once per work item, i.e. it is outside of any loop.
+void InlineLocalsResolution::computeSharedOffsets(Function* F, const GlobalVariableSet& Vars,
+    const DataLayout& DL, MapVector<GlobalVariable*, unsigned int>& Offsets, unsigned int& Size)
+{
+    DominatorTree DT(*F);
+    PostDominatorTree PDT(*F);
+    LoopInfo LI(DT);
+
+    SmallVector<Instruction*, 8> Barriers;
+    for (BasicBlock& BB : *F)
+    {
+        if (LI.getLoopFor(&BB))
+            continue;
+        bool Fenced = false;
+        for (Instruction& I : BB)
+        {
+            if (isMemFence(&I))
+                Fenced = true;
+            else if (isWorkGroupBarrier(&I) && Fenced)
+                Barriers.push_back(&I);
+            else if (I.mayReadOrWriteMemory())
+                Fenced = false;
+        }
+    }
+
+    const unsigned NumVars = Vars.size();
+    std::vector<SmallVector<Instruction*, 16>> Accesses(NumVars);
+    std::vector<bool> Shareable(NumVars, false);
+    for (unsigned i = 0; i < NumVars; ++i)
+    {
+        Shareable[i] = !Barriers.empty() && Vars[i] != m_pGV && collectAccesses(Vars[i], F, Accesses[i]);
+    }
+
+    auto executesBefore = [&](const SmallVectorImpl<Instruction*>& Acc, Instruction* Bar) {
+        return llvm::all_of(Acc, [&](Instruction* I) {
+            return I->getParent() == Bar->getParent() ?
+                DT.dominates(I, Bar) : PDT.dominates(Bar->getParent(), I->getParent());
+        });
+    };
+    auto executesAfter = [&](const SmallVectorImpl<Instruction*>& Acc, Instruction* Bar) {
+        return llvm::all_of(Acc, [&](Instruction* I) { return DT.dominates(Bar, I); });
+    };
+    auto separated = [&](unsigned A, unsigned B) {
+        return llvm::any_of(Barriers, [&](Instruction* Bar) {
+            return (executesBefore(Accesses[A], Bar) && executesAfter(Accesses[B], Bar)) ||
+                (executesBefore(Accesses[B], Bar) && executesAfter(Accesses[A], Bar));
+        });
+    };
+
+    struct Slot
+    {
+        SmallVector<unsigned, 4> Members;
+        unsigned int Size = 0;
+        unsigned int Align = 1;
+    };
+    std::vector<Slot> Slots;
+    for (unsigned i = 0; i < NumVars; ++i)
+    {
+        GlobalVariable* G = Vars[i];
+#if LLVM_VERSION_MAJOR < 11
+        unsigned int Align = DL.getPreferredAlignment(G);
+#else
+        unsigned int Align = (unsigned int)DL.getPreferredAlign(G).value();
+#endif
+        unsigned int VarSize = (G == m_pGV) ?
+            m_FuncToMemPoolSizeMap[F] : (unsigned int)DL.getTypeAllocSize(G->getValueType());
+
+        auto SI = Slots.end();
+        if (Shareable[i])
+        {
+            SI = std::find_if(Slots.begin(), Slots.end(), [&](const Slot& S) {
+                return llvm::all_of(S.Members, [&](unsigned j) { return Shareable[j] && separated(i, j); });
+            });
+        }
+        if (SI == Slots.end())
+        {
+            Slots.emplace_back();
+            SI = std::prev(Slots.end());
+        }
+        SI->Members.push_back(i);
+        SI->Size = std::max(SI->Size, VarSize);
+        SI->Align = std::max(SI->Align, Align);
+    }
+
+    unsigned int offset = 0;
+    for (const Slot& S : Slots)
+    {
+        offset = iSTD::Align(offset, S.Align);
+        for (unsigned i : S.Members)
+        {
+            Offsets[Vars[i]] = (offset & 0xFFFF);
+        }
+        offset += S.Size;
+    }
+    Size = offset;
+}
+
 void InlineLocalsResolution::traverseCGN(const llvm::CallGraphNode& CGN)
 {
     Function* f = CGN.getFunction();
@@ -73,6 +73,9 @@ namespace IGC
         void collectInfoOnSharedLocalMem(llvm::Module&);
         void computeOffsetList(llvm::Module&, llvm::MapVector<llvm::Function*, unsigned int>&);
         void traverseCGN(const llvm::CallGraphNode&);
+        void padLocalArrays(llvm::Module&);
+        void computeSharedOffsets(llvm::Function*, const GlobalVariableSet&, const llvm::DataLayout&,
+            llvm::MapVector<llvm::GlobalVariable*, unsigned int>&, unsigned int&);
 
     private:
 
@@ -10,8 +10,11 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/OpenCLPasses/OpenCLPrintf/OpenCLPrintfResolution.hpp"
 #include "Compiler/Optimizer/OpenCLPasses/OpenCLPrintf/OpenCLPrintfAnalysis.hpp"
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/CISACodeGen/helper.h"
+#include "GenISAIntrinsics/GenIntrinsics.h"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/IR/Attributes.h"
+#include <llvm/IR/IRBuilder.h>
 #include "llvmWrapper/IR/DerivedTypes.h"
 #include "llvmWrapper/IR/Intrinsics.h"
 #include "llvmWrapper/Support/Alignment.h"
@@ -497,6 +500,14 @@ void OpenCLPrintfResolution::expandPrintfCall(CallInst& printfCall, Function& F)
 
     // writeOffset = atomic_add(bufferPtr, dataSize)
     Value* basebufferPtr = implicitArgs.getArgInFunc(F, ImplicitArg::PRINTF_BUFFER);
+    if (!isEntryFunc(MdUtils, &F))
+    {
+        // In a function the buffer pointer is an argument WIAnalysis can't
+        // prove uniform, which makes the reservation a per-lane atomic. With
+        // a uniform pointer and size, EmitPass issues one atomic per subgroup
+        // and gives each lane its offset from a prefix sum (emitScalarAtomics).
+        basebufferPtr = genUniformBufferPtr(basebufferPtr, printfCall);
+    }
     Value* dataSizeVal = ConstantInt::get(m_int32Type, getTotalDataSize());
     Instruction* writeOffsetStart = genAtomicAdd(basebufferPtr, dataSizeVal, printfCall, "write_offset");
     writeOffsetStart->setDebugLoc(m_DL);
@@ -760,6 +771,29 @@ void OpenCLPrintfResolution::preprocessPrintfArgs(CallInst& printfCall)
     }
 }
 
+Value* OpenCLPrintfResolution::genUniformBufferPtr(Value* outputBufferPtr, CallInst& printfCall)
+{
+    // All lanes get the same printf buffer, so any active lane will do.
+    //
+    //   %lane = zext i16 @GenISA_simdLaneId() to i32
+    //   %leader = @GenISA_WaveAll(i32 %lane, UMIN)
+    //   %ptr = inttoptr (@GenISA_WaveShuffleIndex(ptrtoint <outputBufferPtr>, %leader, 0))
+    //
+    IRBuilder<> builder(&printfCall);
+    builder.SetCurrentDebugLocation(m_DL);
+    Value* bufferInt = builder.CreatePtrToInt(outputBufferPtr, m_ptrSizeIntType);
+
+    Function* laneIdFunc = GenISAIntrinsic::getDeclaration(m_module, GenISAIntrinsic::GenISA_simdLaneId);
+    Value* laneId = builder.CreateZExt(builder.CreateCall(laneIdFunc), m_int32Type);
+    Function* waveAllFunc = GenISAIntrinsic::getDeclaration(m_module,
+        GenISAIntrinsic::GenISA_WaveAll, m_int32Type);
+    Value* leaderLane = builder.CreateCall(waveAllFunc, { laneId, builder.getInt8((uint8_t)WaveOps::UMIN) });
+    Function* shuffleFunc = GenISAIntrinsic::getDeclaration(m_module,
+        GenISAIntrinsic::GenISA_WaveShuffleIndex, m_ptrSizeIntType);
+    Value* uniformBufferInt = builder.CreateCall(shuffleFunc, { bufferInt, leaderLane, builder.getInt32(0) });
+    return builder.CreateIntToPtr(uniformBufferInt, outputBufferPtr->getType(), "uniform_buffer_ptr");
+}
+
 CallInst* OpenCLPrintfResolution::genAtomicAdd(Value* outputBufferPtr,
     Value* dataSize,
     CallInst& printfCall,
@@ -106,6 +106,9 @@ namespace IGC
         // Generates atomic_add function call:
         //   ret_val = atomic_add(output_buffer_ptr, data_size)
         // Returns the ret_val.
+        // Broadcast the printf buffer pointer from one lane.
+        llvm::Value* genUniformBufferPtr(llvm::Value* outputBufferPtr, llvm::CallInst& printfCall);
+
         llvm::CallInst* genAtomicAdd(llvm::Value* outputBufferPtr, llvm::Value* dataSize,
             llvm::CallInst& printfCall, llvm::StringRef name);
 
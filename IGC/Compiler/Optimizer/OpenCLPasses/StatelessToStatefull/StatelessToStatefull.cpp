@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/Optimizer/OpenCLPasses/StatelessToStatefull/StatelessToStatefull.hpp"
 #include "common/Stats.hpp"
 #include "common/secure_string.h"
+#include "common/debug/Debug.hpp"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/Instructions.h"
 #include "llvmWrapper/Support/Alignment.h"
@@ -20,12 +21,15 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/GetElementPtrTypeIterator.h>
 #include <llvm/Analysis/ValueTracking.h>
 #include "common/LLVMWarningsPop.hpp"
+#include <fstream>
+#include <sstream>
 #include <string>
 #include "Probe/Assertion.h"
 
 using namespace llvm;
 using namespace IGC;
 using namespace IGC::IGCMD;
+using namespace IGC::Debug;
 
 // Register pass to igc-opt
 #define PASS_FLAG "igc-stateless-to-statefull-resolution"
@@ -111,6 +115,17 @@ IGC_INITIALIZE_PASS_END(StatelessToStatefull, PASS_FLAG, PASS_DESCRIPTION, PASS_
 //                 To assume all offsets are positive (all BUFFER_OFFSET = 0). Thus, no need to
 //                 have implicit BUFFER_OFFSET arguments at all.
 //
+//  Merged addresses and subroutines
+//    With StatelessToStatefullThroughSelectPhi, an address traced through selects and phis
+//    back to a single kernel argument (e.g. a pointer induction variable) is promoted, with
+//    its offset rebuilt from the same selects and phis. Addresses merging different kernel
+//    arguments are not, as a message takes a single binding table index.
+//    With StatelessToStatefullInSubroutines, a pointer argument of a subroutine called only
+//    from one kernel, and being the same kernel argument at all call sites, is resolved against
+//    that kernel's binding table. This is done only when buffer offsets are not in use.
+//    The surfaces promoted by a kernel and its subroutines count against maxPromotionCount
+//    together. EnableOptReportStatelessToStatefull reports every access kept stateless and why.
+//
 
 // Future things to look out for:
 //  - This transformation cannot be done if a pointer is stored to or loaded from memory
@@ -149,24 +164,11 @@ bool StatelessToStatefull::runOnFunction(llvm::Function& F)
 
     // skip device enqueue tests for now to avoid tracking binding tables acorss
     // enqueued blocks.
-    if ((F.getParent()->getNamedMetadata("igc.device.enqueue") != nullptr) ||
-        !isEntryFunc(pMdUtils, &F))
+    if (F.getParent()->getNamedMetadata("igc.device.enqueue") != nullptr)
     {
         return false;
     }
 
-    if (IGC_IS_FLAG_ENABLED(EnableCodeAssumption))
-    {
-        // Use assumption cache
-        m_ACT = &getAnalysis<AssumptionCacheTracker>();
-        AssumptionCache& AC = m_ACT->getAssumptionCache(F);
-        CodeAssumption::addAssumption(&F, &AC);
-    }
-    else
-    {
-        m_ACT = nullptr;
-    }
-
     // Caching arguments during the transformation
     m_hasOptionalBufferOffsetArg = (m_hasBufferOffsetArg &&
         (IGC_IS_FLAG_ENABLED(EnableOptionalBufferOffset) || modMD->compOpt.BufferOffsetArgOptional));
@@ -175,19 +177,171 @@ bool StatelessToStatefull::runOnFunction(llvm::Function& F)
 
     m_hasPositivePointerOffset = (IGC_IS_FLAG_ENABLED(SToSProducesPositivePointer) || modMD->compOpt.HasPositivePointerOffset);
 
-    m_pImplicitArgs = new ImplicitArgs(F, pMdUtils);
+    m_kernel = &F;
+    if (!isEntryFunc(pMdUtils, &F))
+    {
+        m_kernel = getCallingKernel(F, pMdUtils);
+        if (m_kernel == nullptr)
+        {
+            return false;
+        }
+        // Subroutines don't see the kernel's buffer offsets, so they are
+        // never used in there.
+        m_hasOptionalBufferOffsetArg = false;
+    }
+
+    m_pImplicitArgs = new ImplicitArgs(*m_kernel, pMdUtils);
     CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
-    m_pKernelArgs = new KernelArgs(F, &(F.getParent()->getDataLayout()), pMdUtils, modMD, ctx->platform.getGRFSize());
+    m_pKernelArgs = new KernelArgs(*m_kernel, &(F.getParent()->getDataLayout()), pMdUtils, modMD, ctx->platform.getGRFSize());
 
-    visit(F);
+    if (m_kernel == &F || mapSubroutineArgs(F))
+    {
+        if (IGC_IS_FLAG_ENABLED(EnableCodeAssumption))
+        {
+            // Use assumption cache
+            m_ACT = &getAnalysis<AssumptionCacheTracker>();
+            AssumptionCache& AC = m_ACT->getAssumptionCache(F);
+            CodeAssumption::addAssumption(&F, &AC);
+        }
+        else
+        {
+            m_ACT = nullptr;
+        }
+
+        visit(F);
 
-    finalizeArgInitialValue(&F);
+        finalizeArgInitialValue(&F);
+    }
     delete m_pImplicitArgs;
     delete m_pKernelArgs;
-    m_promotedKernelArgs.clear();
+    m_subroutineArgs.clear();
+    m_mergedOffsets.clear();
     return m_changed;
 }
 
+Function* StatelessToStatefull::getCallingKernel(Function& F, MetaDataUtils* pMdUtils)
+{
+    if (IGC_IS_FLAG_DISABLED(StatelessToStatefullInSubroutines) ||
+        F.isDeclaration() || !F.hasLocalLinkage() || F.hasFnAttribute("referenced-indirectly"))
+    {
+        return nullptr;
+    }
+
+    // Offsets in the subroutine are relative to the pointer it is passed, so
+    // they are only valid if the surface base is that pointer, i.e. buffer
+    // offsets are not in use.
+    if (m_hasBufferOffsetArg && !m_hasPositivePointerOffset)
+    {
+        return nullptr;
+    }
+
+    // Binding tables are per kernel, so all calls must come from the same one.
+    Function* kernel = nullptr;
+    for (auto* U : F.users())
+    {
+        auto* CI = dyn_cast<CallInst>(U);
+        if (!CI || CI->getCalledFunction() != &F)
+        {
+            return nullptr;
+        }
+        Function* caller = CI->getFunction();
+        if (!isEntryFunc(pMdUtils, caller) || (kernel && kernel != caller))
+        {
+            return nullptr;
+        }
+        kernel = caller;
+    }
+    return kernel;
+}
+
+bool StatelessToStatefull::mapSubroutineArgs(Function& F)
+{
+    for (auto& Arg : F.args())
+    {
+        PointerType* ptrTy = dyn_cast<PointerType>(Arg.getType());
+        if (!ptrTy || (ptrTy->getAddressSpace() != ADDRESS_SPACE_GLOBAL &&
+            ptrTy->getAddressSpace() != ADDRESS_SPACE_CONSTANT))
+        {
+            continue;
+        }
+
+        const KernelArg* kernelArg = nullptr;
+        for (auto* U : F.users())
+        {
+            Value* actual = cast<CallInst>(U)->getArgOperand(Arg.getArgNo())->stripPointerCasts();
+            const KernelArg* KA = getKernelArgFromPtr(*ptrTy, actual);
+            if (!KA || (kernelArg && kernelArg != KA))
+            {
+                kernelArg = nullptr;
+                break;
+            }
+            kernelArg = KA;
+        }
+        if (kernelArg)
+        {
+            m_subroutineArgs[&Arg] = kernelArg;
+        }
+    }
+    return !m_subroutineArgs.empty();
+}
+
+bool StatelessToStatefull::hasSurfaceBudget()
+{
+    if (m_promotedKernelArgs[m_kernel].size() < maxPromotionCount)
+    {
+        return true;
+    }
+    m_giveUpReason = "surface state budget of the kernel is exhausted";
+    return false;
+}
+
+void StatelessToStatefull::reportGiveUp(const Instruction& I, const Value* ptr)
+{
+    const char* reason = m_giveUpReason;
+    m_giveUpReason = nullptr;
+    if (IGC_IS_FLAG_DISABLED(EnableOptReportStatelessToStatefull) || reason == nullptr)
+    {
+        return;
+    }
+    unsigned AS = ptr->getType()->getPointerAddressSpace();
+    if (AS != ADDRESS_SPACE_GLOBAL && AS != ADDRESS_SPACE_CONSTANT)
+    {
+        return;
+    }
+
+    std::stringstream report;
+    report << "Function " << I.getFunction()->getName().str()
+        << ": kept stateless access";
+    if (const DebugLoc& DL = I.getDebugLoc())
+    {
+        report << " at line " << DL.getLine();
+    }
+    report << ", " << reason
+        << " (" << m_promotedKernelArgs[m_kernel].size() << " of " << maxPromotionCount
+        << " surfaces used)" << std::endl;
+
+    ods() << report.str();
+
+    std::stringstream optReportFile;
+    optReportFile << IGC::Debug::GetShaderOutputFolder() << "StatelessToStatefull.opt";
+    std::ofstream optReportStream(optReportFile.str(), std::ios::app);
+    optReportStream << report.str();
+}
+
+unsigned StatelessToStatefull::getStatefulAddrSpace(unsigned int argNumber, Module* M)
+{
+    ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
+    FunctionMetaData* funcMD = &modMD->FuncMD[m_kernel];
+    ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
+    IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
+    ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[argNumber];
+
+    Constant* resourceNumber = ConstantInt::get(Type::getInt32Ty(M->getContext()), argAlloc->indexType);
+    unsigned addrSpace = EncodeAS4GFXResource(*resourceNumber, BufferType::UAV);
+    setPointerSizeTo32bit(addrSpace, M);
+    return addrSpace;
+}
+
 Argument* StatelessToStatefull::getBufferOffsetArg(Function* F, uint32_t ArgNumber)
 {
     uint32_t nImplicitArgs = m_pImplicitArgs->size();
@@ -220,26 +374,11 @@ bool StatelessToStatefull::getOffsetFromGEP(
     Function* F, SmallVector<GetElementPtrInst*, 4> GEPs,
     uint32_t argNumber, bool isImplicitArg, Value*& offset)
 {
-    Module* M = F->getParent();
-    const DataLayout* DL = &M->getDataLayout();
-    Type* int32Ty = Type::getInt32Ty(M->getContext());
-
-    Value* PointerValue;
-    // If m_hasPositivePointerOffset is true, BUFFER_OFFSET are assumed to be zero,
-    // so is that for any implicit argument
-    if (m_hasBufferOffsetArg && !isImplicitArg && !m_hasPositivePointerOffset)
-    {
-        PointerValue = getBufferOffsetArg(F, argNumber);
-        if (PointerValue == nullptr)
-        {
-            // Sanity check
-            return false;
-        }
-    }
-    else
+    Value* PointerValue = getBaseOffset(F, argNumber, isImplicitArg);
+    if (PointerValue == nullptr)
     {
-        // BUFFER_OFFSET are zero.
-        PointerValue = ConstantInt::get(int32Ty, 0);
+        // Sanity check
+        return false;
     }
 
     const int nGEPs = GEPs.size();
@@ -256,66 +395,90 @@ bool StatelessToStatefull::getOffsetFromGEP(
     //
     for (int i = nGEPs; i > 0; --i)
     {
-        GetElementPtrInst* GEP = GEPs[i - 1];
-        Value* PtrOp = GEP->getPointerOperand();
-        PointerType* PtrTy = dyn_cast<PointerType>(PtrOp->getType());
+        PointerValue = addGEPOffset(GEPs[i - 1], PointerValue);
+    }
+    offset = PointerValue;
+    return true;
+}
 
-        IGC_ASSERT_MESSAGE(PtrTy, "Only accept scalar pointer!");
+// Returns the offset of the kernel argument from its surface base, that is
+// its BUFFER_OFFSET if it is used and 0 otherwise.
+Value* StatelessToStatefull::getBaseOffset(Function* F, uint32_t argNumber, bool isImplicitArg)
+{
+    // If m_hasPositivePointerOffset is true, BUFFER_OFFSET are assumed to be zero,
+    // so is that for any implicit argument
+    if (m_hasBufferOffsetArg && !isImplicitArg && !m_hasPositivePointerOffset)
+    {
+        return getBufferOffsetArg(F, argNumber);
+    }
+    // BUFFER_OFFSET are zero.
+    return ConstantInt::get(Type::getInt32Ty(F->getContext()), 0);
+}
+
+// Adds the byte offset computed by GEP to PointerValue, the offset of the GEP's
+// pointer operand. The new instructions are inserted before GEP.
+Value* StatelessToStatefull::addGEPOffset(GetElementPtrInst* GEP, Value* PointerValue)
+{
+    const DataLayout* DL = &GEP->getModule()->getDataLayout();
+    Type* int32Ty = Type::getInt32Ty(GEP->getContext());
 
-        Type* Ty = PtrTy;
-        gep_type_iterator GTI = gep_type_begin(GEP);
-        for (auto OI = GEP->op_begin() + 1, E = GEP->op_end(); OI != E; ++OI, ++GTI)
+    Value* PtrOp = GEP->getPointerOperand();
+    PointerType* PtrTy = dyn_cast<PointerType>(PtrOp->getType());
+
+    IGC_ASSERT_MESSAGE(PtrTy, "Only accept scalar pointer!");
+
+    Type* Ty = PtrTy;
+    gep_type_iterator GTI = gep_type_begin(GEP);
+    for (auto OI = GEP->op_begin() + 1, E = GEP->op_end(); OI != E; ++OI, ++GTI)
+    {
+        Value* Idx = *OI;
+        if (StructType * StTy = GTI.getStructTypeOrNull())
         {
-            Value* Idx = *OI;
-            if (StructType * StTy = GTI.getStructTypeOrNull())
+            unsigned Field = int_cast<unsigned>(cast<ConstantInt>(Idx)->getZExtValue());
+            if (Field)
             {
-                unsigned Field = int_cast<unsigned>(cast<ConstantInt>(Idx)->getZExtValue());
-                if (Field)
-                {
-                    uint64_t Offset = DL->getStructLayout(StTy)->getElementOffset(Field);
+                uint64_t Offset = DL->getStructLayout(StTy)->getElementOffset(Field);
 
+                Value* OffsetValue = ConstantInt::get(int32Ty, Offset);
+
+                PointerValue = BinaryOperator::CreateAdd(PointerValue, OffsetValue, "", GEP);
+                cast<llvm::Instruction>(PointerValue)->setDebugLoc(GEP->getDebugLoc());
+            }
+            Ty = StTy->getElementType(Field);
+        }
+        else
+        {
+            Ty = GTI.getIndexedType();
+            if (const ConstantInt * CI = dyn_cast<ConstantInt>(Idx))
+            {
+                if (!CI->isZero())
+                {
+                    uint64_t Offset = DL->getTypeAllocSize(Ty) * CI->getSExtValue();
                     Value* OffsetValue = ConstantInt::get(int32Ty, Offset);
 
                     PointerValue = BinaryOperator::CreateAdd(PointerValue, OffsetValue, "", GEP);
                     cast<llvm::Instruction>(PointerValue)->setDebugLoc(GEP->getDebugLoc());
                 }
-                Ty = StTy->getElementType(Field);
             }
             else
             {
-                Ty = GTI.getIndexedType();
-                if (const ConstantInt * CI = dyn_cast<ConstantInt>(Idx))
-                {
-                    if (!CI->isZero())
-                    {
-                        uint64_t Offset = DL->getTypeAllocSize(Ty) * CI->getSExtValue();
-                        Value* OffsetValue = ConstantInt::get(int32Ty, Offset);
+                Value* NewIdx = CastInst::CreateTruncOrBitCast(Idx, int32Ty, "", GEP);
+                cast<llvm::Instruction>(NewIdx)->setDebugLoc(GEP->getDebugLoc());
 
-                        PointerValue = BinaryOperator::CreateAdd(PointerValue, OffsetValue, "", GEP);
-                        cast<llvm::Instruction>(PointerValue)->setDebugLoc(GEP->getDebugLoc());
-                    }
-                }
-                else
+                APInt ElementSize = APInt((unsigned int)int32Ty->getPrimitiveSizeInBits(), DL->getTypeAllocSize(Ty));
+
+                if (ElementSize != 1)
                 {
-                    Value* NewIdx = CastInst::CreateTruncOrBitCast(Idx, int32Ty, "", GEP);
+                    NewIdx = BinaryOperator::CreateMul(NewIdx, ConstantInt::get(int32Ty, ElementSize), "", GEP);
                     cast<llvm::Instruction>(NewIdx)->setDebugLoc(GEP->getDebugLoc());
-
-                    APInt ElementSize = APInt((unsigned int)int32Ty->getPrimitiveSizeInBits(), DL->getTypeAllocSize(Ty));
-
-                    if (ElementSize != 1)
-                    {
-                        NewIdx = BinaryOperator::CreateMul(NewIdx, ConstantInt::get(int32Ty, ElementSize), "", GEP);
-                        cast<llvm::Instruction>(NewIdx)->setDebugLoc(GEP->getDebugLoc());
-                    }
-
-                    PointerValue = BinaryOperator::CreateAdd(PointerValue, NewIdx, "", GEP);
-                    cast<llvm::Instruction>(PointerValue)->setDebugLoc(GEP->getDebugLoc());
                 }
+
+                PointerValue = BinaryOperator::CreateAdd(PointerValue, NewIdx, "", GEP);
+                cast<llvm::Instruction>(PointerValue)->setDebugLoc(GEP->getDebugLoc());
             }
         }
     }
-    offset = PointerValue;
-    return true;
+    return PointerValue;
 }
 
 const KernelArg* StatelessToStatefull::getKernelArgFromPtr(const PointerType& ptrType, Value* pVal)
@@ -354,21 +517,22 @@ bool StatelessToStatefull::pointerIsFromKernelArgument(Value& ptr)
     return false;
 }
 
-bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
-    Function* F, Value* V, Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg)
+static unsigned getPointeeAlign(const DataLayout* DL, Value* ptrVal)
 {
-    auto getPointeeAlign = [](const DataLayout* DL, Value* ptrVal)-> unsigned {
-        if (PointerType* PTy = dyn_cast<PointerType>(ptrVal->getType()))
-        {
-            Type* pointeeTy = PTy->getElementType();
-            if (!pointeeTy->isSized()) {
-                return 0;
-            }
-            return DL->getABITypeAlignment(pointeeTy);
+    if (PointerType* PTy = dyn_cast<PointerType>(ptrVal->getType()))
+    {
+        Type* pointeeTy = PTy->getElementType();
+        if (!pointeeTy->isSized()) {
+            return 0;
         }
-        return 0;
-    };
+        return DL->getABITypeAlignment(pointeeTy);
+    }
+    return 0;
+}
 
+bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
+    Function* F, Value* V, Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg)
+{
     const DataLayout* DL = &F->getParent()->getDataLayout();
 
     AssumptionCache* AC = getAC(F);
@@ -378,6 +542,7 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
     if (!ptrType || (ptrType->getAddressSpace() != ADDRESS_SPACE_GLOBAL &&
         ptrType->getAddressSpace() != ADDRESS_SPACE_CONSTANT))
     {
+        m_giveUpReason = nullptr;
         return false;
     }
 
@@ -391,8 +556,15 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
         base = gep->getPointerOperand()->stripPointerCasts();
     }
 
+    if (IGC_IS_FLAG_ENABLED(StatelessToStatefullThroughSelectPhi) &&
+        (isa<SelectInst>(base) || isa<PHINode>(base)))
+    {
+        return pointerIsPositiveOffsetFromMergedKernelArgument(F, V, offset, argNumber, kernelArg);
+    }
+
     if (!m_supportNonGEPPtr && gep == nullptr)
     {
+        m_giveUpReason = "address is not computed by a GEP";
         return false;
     }
 
@@ -467,11 +639,184 @@ bool StatelessToStatefull::pointerIsPositiveOffsetFromKernelArgument(
             kernelArg = arg;
             return true;
         }
+        m_giveUpReason = m_hasBufferOffsetArg ? "buffer offset of kernel argument is not found"
+            : !isAlignedPointee ? "kernel argument may not be DW-aligned"
+            : "offset from kernel argument is not provably positive";
+        return false;
     }
 
+    m_giveUpReason = "address is not traced back to a kernel argument";
     return false;
 }
 
+// For an address derived through selects and phis, e.g. a pointer induction
+// variable or a conditionally chosen element, the offset from the kernel
+// argument is rebuilt with the same selects and phis over 32-bit offsets.
+// All the values merged must come from the same kernel argument, as a message
+// uses a single binding table index.
+bool StatelessToStatefull::pointerIsPositiveOffsetFromMergedKernelArgument(
+    Function* F, Value* V, Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg)
+{
+    // Bound the size of the address computation traced.
+    const unsigned maxMergedPtrNodes = 64;
+
+    const DataLayout* DL = &F->getParent()->getDataLayout();
+    AssumptionCache* AC = getAC(F);
+    PointerType* ptrType = cast<PointerType>(V->getType());
+
+    const KernelArg* arg = nullptr;
+    Value* base = nullptr;
+    SmallVector<GetElementPtrInst*, 8> GEPs;
+    SmallPtrSet<Value*, 16> visited;
+    SmallVector<Value*, 16> worklist;
+    worklist.push_back(V);
+    while (!worklist.empty())
+    {
+        Value* P = worklist.pop_back_val()->stripPointerCasts();
+        if (!visited.insert(P).second)
+        {
+            continue;
+        }
+        if (visited.size() > maxMergedPtrNodes)
+        {
+            m_giveUpReason = "address computation is too large to trace";
+            return false;
+        }
+        if (P->getType()->getPointerAddressSpace() != ptrType->getAddressSpace())
+        {
+            m_giveUpReason = "address is not traced back to a kernel argument";
+            return false;
+        }
+
+        if (auto* GEP = dyn_cast<GetElementPtrInst>(P))
+        {
+            GEPs.push_back(GEP);
+            worklist.push_back(GEP->getPointerOperand());
+        }
+        else if (auto* SI = dyn_cast<SelectInst>(P))
+        {
+            worklist.push_back(SI->getTrueValue());
+            worklist.push_back(SI->getFalseValue());
+        }
+        else if (auto* PN = dyn_cast<PHINode>(P))
+        {
+            for (Value* In : PN->incoming_values())
+            {
+                worklist.push_back(In);
+            }
+        }
+        else
+        {
+            const KernelArg* leafArg = getKernelArgFromPtr(*ptrType, P);
+            if (leafArg == nullptr)
+            {
+                m_giveUpReason = "address is not traced back to a kernel argument";
+                return false;
+            }
+            if (arg != nullptr && arg != leafArg)
+            {
+                m_giveUpReason = "address merges different kernel arguments";
+                return false;
+            }
+            arg = leafArg;
+            base = P;
+        }
+    }
+    if (arg == nullptr)
+    {
+        m_giveUpReason = "address is not traced back to a kernel argument";
+        return false;
+    }
+
+    // See pointerIsPositiveOffsetFromKernelArgument on alignment and positive offsets.
+    argNumber = arg->getAssociatedArgNo();
+    bool isAlignedPointee = !m_hasSubDWAlignedPtrArg || arg->isImplicitArg() ||
+        getPointeeAlign(DL, base) >= 4;
+    bool gepProducesPositivePointer = true;
+    if (!arg->isImplicitArg() &&
+        isAlignedPointee &&
+        (!m_hasBufferOffsetArg || m_hasOptionalBufferOffsetArg) &&
+        !m_hasPositivePointerOffset)
+    {
+        // With all indices positive, any offset reached through the merges is
+        // positive too, including those around loops.
+        for (GetElementPtrInst* tgep : GEPs)
+        {
+            for (auto U = tgep->idx_begin(), E = tgep->idx_end(); U != E; ++U)
+            {
+                gepProducesPositivePointer &= valueIsPositive(U->get(), DL, AC);
+            }
+        }
+
+        if (m_hasOptionalBufferOffsetArg)
+        {
+            updateArgInfo(arg, gepProducesPositivePointer);
+        }
+    }
+    if (!m_hasBufferOffsetArg && !(gepProducesPositivePointer && isAlignedPointee))
+    {
+        m_giveUpReason = !isAlignedPointee ? "kernel argument may not be DW-aligned"
+            : "offset from kernel argument is not provably positive";
+        return false;
+    }
+
+    if (m_mergedOffsets.find(base) == m_mergedOffsets.end())
+    {
+        Value* baseOffset = getBaseOffset(F, argNumber, arg->isImplicitArg());
+        if (baseOffset == nullptr)
+        {
+            m_giveUpReason = "buffer offset of kernel argument is not found";
+            return false;
+        }
+        m_mergedOffsets[base] = baseOffset;
+    }
+    offset = getMergedOffset(V);
+    kernelArg = arg;
+    return true;
+}
+
+// Returns the 32-bit offset of the pointer V, as traced by
+// pointerIsPositiveOffsetFromMergedKernelArgument, from its surface base.
+Value* StatelessToStatefull::getMergedOffset(Value* V)
+{
+    Value* P = V->stripPointerCasts();
+    auto OI = m_mergedOffsets.find(P);
+    if (OI != m_mergedOffsets.end())
+    {
+        return OI->second;
+    }
+
+    Value* Offset = nullptr;
+    if (auto* GEP = dyn_cast<GetElementPtrInst>(P))
+    {
+        Offset = addGEPOffset(GEP, getMergedOffset(GEP->getPointerOperand()));
+    }
+    else if (auto* SI = dyn_cast<SelectInst>(P))
+    {
+        Value* TrueOffset = getMergedOffset(SI->getTrueValue());
+        Value* FalseOffset = getMergedOffset(SI->getFalseValue());
+        Instruction* NewSI = SelectInst::Create(SI->getCondition(), TrueOffset, FalseOffset, "", SI);
+        NewSI->setDebugLoc(SI->getDebugLoc());
+        Offset = NewSI;
+    }
+    else
+    {
+        PHINode* PN = cast<PHINode>(P);
+        PHINode* NewPN = PHINode::Create(
+            Type::getInt32Ty(PN->getContext()), PN->getNumIncomingValues(), "", PN);
+        NewPN->setDebugLoc(PN->getDebugLoc());
+        // Register it before the incoming values, which may depend on the phi.
+        m_mergedOffsets[P] = NewPN;
+        for (unsigned i = 0, e = PN->getNumIncomingValues(); i != e; ++i)
+        {
+            NewPN->addIncoming(getMergedOffset(PN->getIncomingValue(i)), PN->getIncomingBlock(i));
+        }
+        return NewPN;
+    }
+    m_mergedOffsets[P] = Offset;
+    return Offset;
+}
+
 void StatelessToStatefull::visitCallInst(CallInst& I)
 {
     auto doPromoteUntypedAtomics = [](const GenISAIntrinsic::ID intrinID, const GenIntrinsicInst* Inst)-> bool
@@ -521,7 +866,6 @@ void StatelessToStatefull::visitCallInst(CallInst& I)
             Module* M = Inst->getParent()->getParent()->getParent();
             Function* F = Inst->getParent()->getParent();
             const DebugLoc& DL = Inst->getDebugLoc();
-            Type* int32Ty = Type::getInt32Ty(M->getContext());
             Value* ptr = Inst->getOperand(0);
             PointerType* ptrTy = dyn_cast<PointerType>(ptr->getType());
             // If not global/constant, skip.
@@ -533,17 +877,9 @@ void StatelessToStatefull::visitCallInst(CallInst& I)
             Value* offset = nullptr;
             unsigned int baseArgNumber  = 0;
             const KernelArg* kernelArg = nullptr;
-            if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+            if (hasSurfaceBudget() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
             {
-                ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-                FunctionMetaData* funcMD = &modMD->FuncMD[F];
-                ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
-                IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
-                ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
-
-                Constant* resourceNumber = ConstantInt::get(int32Ty, argAlloc->indexType);
-                unsigned addrSpace = EncodeAS4GFXResource(*resourceNumber, BufferType::UAV);
-                setPointerSizeTo32bit(addrSpace, I.getParent()->getParent()->getParent());
+                unsigned addrSpace = getStatefulAddrSpace(baseArgNumber, M);
 
                 if (intrinID == GenISAIntrinsic::GenISA_simdBlockRead)
                 {
@@ -607,7 +943,11 @@ void StatelessToStatefull::visitCallInst(CallInst& I)
                 }
 
                 m_changed = true;
-                m_promotedKernelArgs.insert(kernelArg);
+                m_promotedKernelArgs[m_kernel].insert(kernelArg->getArg());
+            }
+            else
+            {
+                reportGiveUp(*Inst, ptr);
             }
         }
 
@@ -664,24 +1004,14 @@ void StatelessToStatefull::visitLoadInst(LoadInst& I)
     Module* M = I.getParent()->getParent()->getParent();
     Function* F = I.getParent()->getParent();
     const DebugLoc& DL = I.getDebugLoc();
-    Type* int32Ty = Type::getInt32Ty(M->getContext());
     Value* ptr = I.getPointerOperand();
 
     Value* offset = nullptr;
     unsigned int baseArgNumber = 0;
     const KernelArg* kernelArg = nullptr;
-    if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+    if (hasSurfaceBudget() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
     {
-        ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-        FunctionMetaData* funcMD = &modMD->FuncMD[F];
-        ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
-        IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
-        ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
-
-        Constant* resourceNumber = ConstantInt::get(int32Ty, argAlloc->indexType);
-
-        unsigned addrSpace = EncodeAS4GFXResource(*resourceNumber, BufferType::UAV);
-        setPointerSizeTo32bit(addrSpace, I.getParent()->getParent()->getParent());
+        unsigned addrSpace = getStatefulAddrSpace(baseArgNumber, M);
 
         PointerType* pTy = PointerType::get(I.getType(), addrSpace);
 
@@ -704,7 +1034,11 @@ void StatelessToStatefull::visitLoadInst(LoadInst& I)
         I.eraseFromParent();
 
         m_changed = true;
-        m_promotedKernelArgs.insert(kernelArg);
+        m_promotedKernelArgs[m_kernel].insert(kernelArg->getArg());
+    }
+    else
+    {
+        reportGiveUp(I, ptr);
     }
 
     // check if there's non-kernel-arg load/store
@@ -721,27 +1055,18 @@ void StatelessToStatefull::visitStoreInst(StoreInst& I)
     Module* M = I.getParent()->getParent()->getParent();
     Function* F = I.getParent()->getParent();
     const DebugLoc& DL = I.getDebugLoc();
-    Type* int32Ty = Type::getInt32Ty(M->getContext());
     Value* ptr = I.getPointerOperand();
 
     Value* offset = nullptr;
     unsigned int baseArgNumber = 0;
     const KernelArg* kernelArg = nullptr;
-    if (m_promotedKernelArgs.size() < maxPromotionCount && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
+    if (hasSurfaceBudget() && pointerIsPositiveOffsetFromKernelArgument(F, ptr, offset, baseArgNumber, kernelArg))
     {
         Value* dataVal = I.getOperand(0);
 
         if (dataVal != nullptr)
         {
-            ModuleMetaData* modMD = getAnalysis<MetaDataUtilsWrapper>().getModuleMetaData();
-            FunctionMetaData* funcMD = &modMD->FuncMD[F];
-            ResourceAllocMD* resAllocMD = &funcMD->resAllocMD;
-            IGC_ASSERT_MESSAGE(resAllocMD->argAllocMDList.size() > 0, "ArgAllocMDList is empty.");
-            ArgAllocMD* argAlloc = &resAllocMD->argAllocMDList[baseArgNumber];
-            Constant* resourceNumber = ConstantInt::get(int32Ty, argAlloc->indexType);
-
-            unsigned addrSpace = EncodeAS4GFXResource(*resourceNumber, BufferType::UAV);
-            setPointerSizeTo32bit(addrSpace, I.getParent()->getParent()->getParent());
+            unsigned addrSpace = getStatefulAddrSpace(baseArgNumber, M);
 
             PointerType* pTy = PointerType::get(dataVal->getType(), addrSpace);
 
@@ -754,9 +1079,13 @@ void StatelessToStatefull::visitStoreInst(StoreInst& I)
             I.eraseFromParent();
 
             m_changed = true;
-            m_promotedKernelArgs.insert(kernelArg);
+            m_promotedKernelArgs[m_kernel].insert(kernelArg->getArg());
         }
     }
+    else
+    {
+        reportGiveUp(I, ptr);
+    }
 
     if (IGC_IS_FLAG_ENABLED(DumpHasNonKernelArgLdSt) &&
         ptr != nullptr && !pointerIsFromKernelArgument(*ptr)) {
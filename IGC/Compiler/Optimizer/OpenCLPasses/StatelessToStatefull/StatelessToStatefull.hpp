@@ -52,6 +52,12 @@ namespace IGC
 
         virtual bool runOnFunction(llvm::Function& F) override;
 
+        virtual bool doFinalization(llvm::Module& M) override
+        {
+            m_promotedKernelArgs.clear();
+            return false;
+        }
+
         void visitLoadInst(llvm::LoadInst& I);
         void visitStoreInst(llvm::StoreInst& I);
         void visitCallInst(llvm::CallInst& I);
@@ -62,6 +68,12 @@ namespace IGC
         bool pointerIsPositiveOffsetFromKernelArgument(
             llvm::Function* F, llvm::Value* V, llvm::Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg);
 
+        // Same as above, for an address derived through selects and phis whose
+        // incoming values all come from the same kernel argument.
+        bool pointerIsPositiveOffsetFromMergedKernelArgument(
+            llvm::Function* F, llvm::Value* V, llvm::Value*& offset, unsigned int& argNumber, const KernelArg*& kernelArg);
+        llvm::Value* getMergedOffset(llvm::Value* V);
+
         // Check if the given pointer value can be traced back to any kernel argument.
         // return the kernel argument if found, otherwise return nullptr.
         const KernelArg* getKernelArgFromPtr(const llvm::PointerType& ptrType, llvm::Value* pVal);
@@ -72,15 +84,35 @@ namespace IGC
         bool getOffsetFromGEP(
             llvm::Function* F, llvm::SmallVector<llvm::GetElementPtrInst*, 4> GEPs,
             uint32_t argNumber, bool isImplicitArg, llvm::Value*& offset);
+        llvm::Value* getBaseOffset(llvm::Function* F, uint32_t argNumber, bool isImplicitArg);
+        llvm::Value* addGEPOffset(llvm::GetElementPtrInst* GEP, llvm::Value* PointerValue);
         llvm::Argument* getBufferOffsetArg(llvm::Function* F, uint32_t ArgNumber);
         void setPointerSizeTo32bit(int32_t AddrSpace, llvm::Module* M);
 
+        // Returns the stateful address space of the surface assigned to the
+        // given kernel argument of m_kernel.
+        unsigned getStatefulAddrSpace(unsigned int argNumber, llvm::Module* M);
+
+        // Subroutines whose pointer arguments are kernel arguments of a single
+        // kernel at all call sites can use that kernel's binding table.
+        llvm::Function* getCallingKernel(llvm::Function& F, IGCMD::MetaDataUtils* pMdUtils);
+        bool mapSubroutineArgs(llvm::Function& F);
+
+        // Surface state usage: promotion of a new argument is given up once the
+        // kernel, including its subroutines, uses maxPromotionCount surfaces.
+        bool hasSurfaceBudget();
+        void reportGiveUp(const llvm::Instruction& I, const llvm::Value* ptr);
+
         void updateArgInfo(const KernelArg* KA, bool IsPositive);
         void finalizeArgInitialValue(llvm::Function* F);
 
         const KernelArg* getKernelArg(llvm::Value* Arg)
         {
             IGC_ASSERT_MESSAGE(m_pKernelArgs, "Should initialize it before use!");
+            auto SI = m_subroutineArgs.find(Arg);
+            if (SI != m_subroutineArgs.end()) {
+                return SI->second;
+            }
             for (const KernelArg& arg : *m_pKernelArgs) {
                 if (arg.getArg() == Arg) {
                     return &arg;
@@ -133,7 +165,23 @@ namespace IGC
         KernelArgs* m_pKernelArgs;
         ArgInfoMap   m_argsInfo;
         bool m_changed;
-        std::unordered_set<const KernelArg*> m_promotedKernelArgs; // ptr args which have been promoted to stateful
+
+        // Kernel whose binding table the accesses of the current function use.
+        // It is the function itself unless that is a subroutine.
+        llvm::Function* m_kernel = nullptr;
+
+        // Pointer arguments of the current subroutine and the kernel arguments
+        // they are at all call sites.
+        llvm::DenseMap<const llvm::Value*, const KernelArg*> m_subroutineArgs;
+
+        // 32-bit offsets rebuilt for merged addresses in the current function.
+        llvm::DenseMap<llvm::Value*, llvm::Value*> m_mergedOffsets;
+
+        // Why the last access could not be promoted, for the opt report.
+        const char* m_giveUpReason = nullptr;
+
+        // ptr args which have been promoted to stateful, per kernel
+        llvm::DenseMap<const llvm::Function*, std::unordered_set<const llvm::Argument*>> m_promotedKernelArgs;
     };
 
 }
@@ -394,12 +394,70 @@ Value* WIFuncResolution::getLocalId(CallInst& CI, ImplicitArg::ArgType argType)
         auto Trunc = Builder.CreateZExtOrBitCast(LoadInst, CI.getType());
         V = Trunc;
     }
-    else
+    else if (m_implicitArgs.isImplicitArgExist(argType))
     {
         Argument* localId = getImplicitArg(CI, argType);
         V = localId;
     }
+    else
+    {
+        V = getInKernelLocalId(CI, argType);
+    }
+
+    return V;
+}
+
+Value* WIFuncResolution::getInKernelLocalId(CallInst& CI, ImplicitArg::ArgType argType)
+{
+    // Receives:
+    // call i32 @__builtin_IB_get_local_id_x()
+
+    // Creates, without any per-thread payload (EnableInKernelLocalIDs):
+    // LocalThreadId = r0.2[7:0]
+    // LinearId = LocalThreadId * SimdSize + SimdLaneId
+    // LocalIdX = LinearId % LocalSizeX
+    // LocalIdY = (LinearId / LocalSizeX) % LocalSizeY
+    // LocalIdZ = LinearId / (LocalSizeX * LocalSizeY)
+    // which is the order the work items of a group are given to its threads
+    // when the runtime does not provide the local ids.
+    auto F = CI.getFunction();
+    llvm::IRBuilder<> Builder(&CI);
+    Type* Int32Ty = Builder.getInt32Ty();
+
+    Value* R0 = getImplicitArg(CI, ImplicitArg::R0);
+    Value* LocalThreadId = Builder.CreateExtractElement(R0, Builder.getInt32(2));
+    LocalThreadId = Builder.CreateAnd(LocalThreadId, Builder.getInt32(0xFF));
 
+    Function* SimdSizeDcl = GenISAIntrinsic::getDeclaration(F->getParent(), GenISAIntrinsic::GenISA_simdSize, Int32Ty);
+    Value* SimdSize = Builder.CreateCall(SimdSizeDcl);
+    Function* SimdLaneIdDcl = GenISAIntrinsic::getDeclaration(F->getParent(), GenISAIntrinsic::GenISA_simdLaneId, Builder.getInt16Ty());
+    Value* SimdLaneId = Builder.CreateZExt(Builder.CreateCall(SimdLaneIdDcl), Int32Ty);
+    Value* LinearId = Builder.CreateAdd(Builder.CreateMul(LocalThreadId, SimdSize), SimdLaneId, "linearLocalId");
+
+    Value* LocalSize = getKnownWorkGroupSize(getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils(), *F);
+    if (!LocalSize)
+    {
+        LocalSize = getImplicitArg(CI, ImplicitArg::LOCAL_SIZE);
+    }
+    Value* LocalSizeX = Builder.CreateExtractElement(LocalSize, Builder.getInt32(0));
+
+    Value* V = nullptr;
+    if (argType == ImplicitArg::LOCAL_ID_X)
+    {
+        V = Builder.CreateURem(LinearId, LocalSizeX);
+    }
+    else
+    {
+        Value* LocalSizeY = Builder.CreateExtractElement(LocalSize, Builder.getInt32(1));
+        if (argType == ImplicitArg::LOCAL_ID_Y)
+        {
+            V = Builder.CreateURem(Builder.CreateUDiv(LinearId, LocalSizeX), LocalSizeY);
+        }
+        else
+        {
+            V = Builder.CreateUDiv(LinearId, Builder.CreateMul(LocalSizeX, LocalSizeY));
+        }
+    }
     return V;
 }
 
@@ -66,6 +66,13 @@ namespace IGC
         /// @return A value representing the local id
         llvm::Value* getLocalId(llvm::CallInst& CI, ImplicitArg::ArgType argType);
 
+        /// @brief  Computes get_local_id(dim) from the local thread id and the local size
+        ///         when the local ids are not passed as implicit args.
+        /// @param  CI The call instruction.
+        /// @param  argType The type of the appropriate implicit arg.
+        /// @return A value representing the local id
+        llvm::Value* getInKernelLocalId(llvm::CallInst& CI, ImplicitArg::ArgType argType);
+
         /// @brief  Resolves get_group_id(dim).
         ///         Adds the appropriate sequence of code before the given call instruction
         /// @param  CI The call instruction.
@@ -10,6 +10,8 @@ SPDX-License-Identifier: MIT
 #include "AdaptorCommon/ImplicitArgs.hpp"
 #include "AdaptorCommon/AddImplicitArgs.hpp"
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataApi/IGCMetaDataHelper.h"
+#include "common/igc_regkeys.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include <llvm/IR/Module.h>
@@ -148,7 +150,21 @@ bool WIFuncsAnalysis::runOnFunction(Function& F)
     {
         implicitArgs.push_back(ImplicitArg::LOCAL_SIZE);
     }
-    if (m_hasLocalID)
+    if (m_hasLocalID && useInKernelLocalIDs(F))
+    {
+        // Local ids are computed from the local thread id in r0 and the
+        // local size, so the runtime does not push any per-thread payload.
+        if (!isEntryFunc(m_pMDUtils, &F) && !m_hasGroupID && !m_hasLocalThreadID)
+        {
+            implicitArgs.push_back(ImplicitArg::R0);
+        }
+        if (!m_hasLocalSize &&
+            !IGCMD::IGCMetaDataHelper::getThreadGroupDims(*m_pMDUtils, &F))
+        {
+            implicitArgs.push_back(ImplicitArg::LOCAL_SIZE);
+        }
+    }
+    else if (m_hasLocalID)
     {
         implicitArgs.push_back(ImplicitArg::LOCAL_ID_X);
         implicitArgs.push_back(ImplicitArg::LOCAL_ID_Y);
@@ -177,6 +193,18 @@ bool WIFuncsAnalysis::runOnFunction(Function& F)
     return true;
 }
 
+bool WIFuncsAnalysis::useInKernelLocalIDs(const Function& F) const
+{
+    // r0.2[7:0] only holds the local thread id with the thread payload
+    // loaded by the kernel itself, and stack calls read local ids from the
+    // implicit arg buffer instead.
+    return IGC_IS_FLAG_ENABLED(EnableInKernelLocalIDs) &&
+        m_ctx->type == ShaderType::OPENCL_SHADER &&
+        m_ctx->platform.supportLoadThreadPayloadForCompute() &&
+        !F.hasFnAttribute("visaStackCall") &&
+        !m_hasStackCalls;
+}
+
 void WIFuncsAnalysis::visitCallInst(CallInst& CI)
 {
     if (!CI.getCalledFunction())
@@ -82,6 +82,11 @@ namespace IGC
         /// @param  F The destination function.
         bool runOnFunction(llvm::Function& F);
 
+        /// @brief  Checks whether the local ids of the current function are computed in the kernel
+        ///         instead of being passed as implicit arguments (EnableInKernelLocalIDs regkey)
+        /// @param  F The destination function.
+        bool useInKernelLocalIDs(const llvm::Function& F) const;
+
         /// @brief  Marks whether group id is needed by the current function
         bool m_hasGroupID = false;
         /// @brief  Marks whether local thread id is needed by the current function
@@ -21,6 +21,8 @@ SPDX-License-Identifier: MIT
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/IRReader/IRReader.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "AdaptorCommon/ImplicitArgs.hpp"
 #include "Compiler/Optimizer/PreCompiledFuncImport.hpp"
@@ -424,6 +426,9 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
         m_libModuleAlreadyImported[i] = false;
     }
     m_allNewCallInsts.clear();
+    m_DPFastPathCalls.clear();
+    m_DPFastPathFuncs.clear();
+    m_DPSlowPathFuncs.clear();
 
     SmallSet<Function*, 32> origFunctions;
     for (auto II = M.begin(), IE = M.end(); II != IE; ++II)
@@ -598,6 +603,8 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
         }
     }
 
+    addDPFastPaths();
+
     unsigned totalNumberOfInlinedInst = 0;
 
     // Post processing, set those imported functions as internal linkage
@@ -624,10 +631,24 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
                 continue;
             }
 
+            // The slow path copies are always subroutines.
+            if (m_DPSlowPathFuncs.count(Func))
+            {
+                Func->removeFnAttr(llvm::Attribute::AlwaysInline);
+                continue;
+            }
+
             // Remove noinline/AlwaysInline attr if present.
             Func->removeFnAttr(llvm::Attribute::NoInline);
             Func->removeFnAttr(llvm::Attribute::AlwaysInline);
 
+            // Fast paths are inlined, their rare inputs go to the slow path.
+            if (m_DPFastPathFuncs.count(Func))
+            {
+                Func->addFnAttr(llvm::Attribute::AlwaysInline);
+                continue;
+            }
+
             if (m_enableSubroutineCallForEmulation &&
                 (IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation)))
             {
@@ -682,9 +703,10 @@ bool PreCompiledFuncImport::runOnModule(Module& M)
             // Use subroutine if ForceSubroutineForEmulation is set or
             // use subroutines if total number of instructions added when
             // all emulated functions are inlined exceed InlinedEmulationThreshold.
-            if (m_enableSubroutineCallForEmulation &&
+            if (m_DPSlowPathFuncs.count(Func) ||
+                (m_enableSubroutineCallForEmulation &&
                 (IGC_IS_FLAG_ENABLED(ForceSubroutineForEmulation) ||
-                    totalNumberOfInlinedInst > (unsigned)IGC_GET_FLAG_VALUE(InlinedEmulationThreshold)))
+                    totalNumberOfInlinedInst > (unsigned)IGC_GET_FLAG_VALUE(InlinedEmulationThreshold))))
             {
                 Func->addFnAttr(llvm::Attribute::NoInline);
 
@@ -1201,6 +1223,16 @@ void PreCompiledFuncImport::processFPBinaryOperator(Instruction& I, FunctionIDs
         addCallInst(funcCall);
         funcCall->setDebugLoc(I.getDebugLoc());
 
+        // With denormals retained, the routine is mostly spent on inputs
+        // that normal finite code never sees; see addDPFastPaths.
+        if (isDPEmu() && !m_flushDenorm &&
+            m_enableSubroutineCallForEmulation &&
+            IGC_IS_FLAG_DISABLED(ForceSubroutineForEmulation) &&
+            IGC_IS_FLAG_ENABLED(EnableDPEmulationFastPath))
+        {
+            m_DPFastPathCalls.push_back(funcCall);
+        }
+
         I.replaceAllUsesWith(funcCall);
         I.eraseFromParent();
 
@@ -1208,6 +1240,80 @@ void PreCompiledFuncImport::processFPBinaryOperator(Instruction& I, FunctionIDs
     }
 }
 
+// For each call in m_DPFastPathCalls
+//   %r = call @__igcbuiltin_dp_add(%a, %b, rm, ftz, daz = 0, flag)
+// creates
+//   if (isDenorm(%a) || isDenorm(%b))
+//     %slow = call @__igcbuiltin_dp_add_slowpath(%a, %b, rm, ftz, 0, flag)
+//   else
+//     %fast = call @__igcbuiltin_dp_add(%a, %b, rm, ftz, 1, flag)
+//   %r = phi %slow, %fast
+// Treating denormal inputs as zero does not change the result for other
+// inputs, and the denormal handling folds away once the fast path with a
+// constant daz is inlined. The slow path copy is kept as a subroutine so
+// the kernel contains the full routine only once.
+void PreCompiledFuncImport::addDPFastPaths()
+{
+    DenseMap<Function*, Function*> slowPathFuncs;
+    Type* intTy = Type::getInt32Ty(m_pModule->getContext());
+    VectorType* vec2Ty = IGCLLVM::FixedVectorType::get(intTy, 2);
+
+    for (CallInst* CI : m_DPFastPathCalls)
+    {
+        Function* func = CI->getCalledFunction();
+        if (!func || func->isDeclaration())
+        {
+            continue;
+        }
+
+        Function*& slowFunc = slowPathFuncs[func];
+        if (!slowFunc)
+        {
+            ValueToValueMapTy VMap;
+            slowFunc = CloneFunction(func, VMap);
+            slowFunc->setName(func->getName() + "_slowpath");
+            m_DPSlowPathFuncs.insert(slowFunc);
+            m_DPFastPathFuncs.insert(func);
+        }
+
+        // A double is denormal if its exponent is zero and it is not zero.
+        IRBuilder<> builder(CI);
+        auto isDenorm = [&](Value* V) {
+            Value* twoI32 = builder.CreateBitCast(V, vec2Ty);
+            Value* lo = builder.CreateExtractElement(twoI32, builder.getInt32(0));
+            Value* hi = builder.CreateExtractElement(twoI32, builder.getInt32(1));
+            Value* expIsZero = builder.CreateICmpEQ(
+                builder.CreateAnd(hi, builder.getInt32(0x7FF00000)), builder.getInt32(0));
+            Value* isNonZero = builder.CreateICmpNE(
+                builder.CreateOr(builder.CreateAnd(hi, builder.getInt32(0x7FFFFFFF)), lo),
+                builder.getInt32(0));
+            return builder.CreateAnd(expIsZero, isNonZero);
+        };
+        Value* isSlow = builder.CreateOr(
+            isDenorm(CI->getArgOperand(0)), isDenorm(CI->getArgOperand(1)), "DPEmuSlowPath");
+
+        Instruction* slowTerm = nullptr;
+        Instruction* fastTerm = nullptr;
+        SplitBlockAndInsertIfThenElse(isSlow, CI, &slowTerm, &fastTerm);
+
+        CallInst* slowCall = cast<CallInst>(CI->clone());
+        slowCall->setCalledFunction(slowFunc);
+        slowCall->insertBefore(slowTerm);
+
+        CallInst* fastCall = cast<CallInst>(CI->clone());
+        fastCall->setArgOperand(4, ConstantInt::get(intTy, 1)); // denorm as zero
+        fastCall->insertBefore(fastTerm);
+
+        PHINode* result = PHINode::Create(CI->getType(), 2, CI->getName(), CI);
+        result->addIncoming(slowCall, slowCall->getParent());
+        result->addIncoming(fastCall, fastCall->getParent());
+        result->setDebugLoc(CI->getDebugLoc());
+        CI->replaceAllUsesWith(result);
+        CI->eraseFromParent();
+    }
+    m_DPFastPathCalls.clear();
+}
+
 Function* PreCompiledFuncImport::getOrCreateFunction(FunctionIDs FID)
 {
     // Common arguments for DP emulation functions
@@ -157,6 +157,15 @@ namespace IGC
         void processInt32Divide(llvm::BinaryOperator& inst, Int32EmulatedFunctions function);
 
         void processFPBinaryOperator(llvm::Instruction& I, FunctionIDs FID);
+
+        // DP emulation fast path: calls in m_DPFastPathCalls are split into
+        // an inlined call with denormal inputs treated as zero, taken when
+        // no input is denormal, and a call to an out-of-line copy of the
+        // emulation function otherwise.
+        void addDPFastPaths();
+        llvm::SmallVector<llvm::CallInst*, 16> m_DPFastPathCalls;
+        llvm::SmallPtrSet<llvm::Function*, 8> m_DPFastPathFuncs;
+        llvm::SmallPtrSet<llvm::Function*, 8> m_DPSlowPathFuncs;
         llvm::Function* getOrCreateFunction(FunctionIDs FID);
         llvm::Value* createFlagValue(llvm::Function* F);
         uint32_t getFCmpMask(llvm::CmpInst::Predicate Pred);
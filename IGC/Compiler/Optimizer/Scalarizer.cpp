@@ -8,6 +8,8 @@ SPDX-License-Identifier: MIT
 
 #include "Compiler/Optimizer/Scalarizer.h"
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "AdaptorCommon/ImplicitArgs.hpp"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
 #include "common/LLVMWarningsPush.hpp"
 #include "llvmWrapper/IR/DerivedTypes.h"
@@ -22,6 +24,7 @@ SPDX-License-Identifier: MIT
 #include "common/igc_regkeys.hpp"
 #include "common/Types.hpp"
 #include <iostream>
+#include <algorithm>
 #include "Probe/Assertion.h"
 
 using namespace llvm;
@@ -112,6 +115,10 @@ bool ScalarizeFunction::runOnFunction(Function& F)
     if (m_SelectiveScalarization)
     {
         buildExclusiveSet();
+        if (IGC_IS_FLAG_ENABLED(EnableUniformVectorALU))
+        {
+            buildUniformVectorALUSet();
+        }
     }
 
     // Scalarization. Iterate over all the instructions
@@ -282,6 +289,94 @@ void ScalarizeFunction::buildExclusiveSet()
     }
 }
 
+/// <summary>
+/// @brief Scalarizing a vector operation whose operands are the same across all
+/// lanes turns one SIMD1 instruction on a packed vector into one instruction per
+/// element. WIAnalysis is not available at this point, so uniformity is
+/// approximated conservatively: constants and kernel arguments are uniform, and
+/// so is any non-PHI, non-call instruction whose operands are all uniform.
+/// Only the ALU opcodes and vector shapes the emitter handles are excluded.
+/// </summary>
+void ScalarizeFunction::buildUniformVectorALUSet()
+{
+    DenseSet<const Value*> uniform;
+    // Explicit kernel arguments are uniform; implicit ones (e.g. local ids) are not.
+    auto* MdWrapper = getAnalysisIfAvailable<MetaDataUtilsWrapper>();
+    if (MdWrapper && m_currFunc->getCallingConv() == CallingConv::SPIR_KERNEL)
+    {
+        ImplicitArgs implicitArgs(*m_currFunc, MdWrapper->getMetaDataUtils());
+        unsigned numExplicitArgs = unsigned(m_currFunc->arg_size() - implicitArgs.size());
+        for (auto& Arg : m_currFunc->args())
+        {
+            if (Arg.getArgNo() >= numExplicitArgs)
+                break;
+            uniform.insert(&Arg);
+        }
+    }
+    auto isUniform = [&uniform](const Value* V) {
+        return isa<Constant>(V) || uniform.count(V);
+    };
+
+    // Uniformity only grows and PHIs never join the set, so this terminates
+    // regardless of the block layout.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto& I : instructions(m_currFunc))
+        {
+            if (uniform.count(&I))
+                continue;
+            if (auto* LI = dyn_cast<LoadInst>(&I))
+            {
+                if (LI->isVolatile())
+                    continue;
+            }
+            else if (!isa<BinaryOperator>(&I) && !isa<CastInst>(&I) && !isa<CmpInst>(&I) &&
+                !isa<SelectInst>(&I) && !isa<ExtractElementInst>(&I) &&
+                !isa<InsertElementInst>(&I) && !isa<ShuffleVectorInst>(&I) &&
+                !isa<GetElementPtrInst>(&I))
+            {
+                continue;
+            }
+            if (std::all_of(I.op_begin(), I.op_end(), [&](const Use& U) { return isUniform(U.get()); }))
+            {
+                uniform.insert(&I);
+                changed = true;
+            }
+        }
+    }
+
+    for (auto& I : instructions(m_currFunc))
+    {
+        auto* BO = dyn_cast<BinaryOperator>(&I);
+        if (!BO || !uniform.count(BO))
+            continue;
+        auto* VTy = dyn_cast<IGCLLVM::FixedVectorType>(BO->getType());
+        if (!VTy || VTy->getScalarSizeInBits() != 32)
+            continue;
+        unsigned numElts = (unsigned)VTy->getNumElements();
+        if (numElts != 2 && numElts != 4 && numElts != 8)
+            continue;
+        switch (BO->getOpcode())
+        {
+        case Instruction::FAdd:
+        case Instruction::FSub:
+        case Instruction::FMul:
+        case Instruction::Add:
+        case Instruction::Sub:
+        case Instruction::Mul:
+        case Instruction::And:
+        case Instruction::Or:
+        case Instruction::Xor:
+            m_Excludes.insert(BO);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
 void ScalarizeFunction::dispatchInstructionToScalarize(Instruction* I)
 {
     V_PRINT(scalarizer, "\tScalarizing Instruction: " << *I << "\n");
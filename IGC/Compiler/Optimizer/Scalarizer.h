@@ -72,6 +72,9 @@ namespace IGC
 
         /// @brief select an exclusive set that would not be scalarized
         void buildExclusiveSet();
+        /// @brief exclude uniform vector ALU operations, which are emitted as a
+        ///  single SIMD1 instruction on the packed vector instead of per-element
+        void buildUniformVectorALUSet();
         /// @brief main Method for dispatching instructions (according to inst type) for scalarization
         /// @param I instruction to dispatch
         void dispatchInstructionToScalarize(llvm::Instruction* I);
@@ -0,0 +1,178 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/Optimizer/ShaderProfileInstrumentation.hpp"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/CodeGenPublicEnums.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/ShaderProfile.hpp"
+#include "common/debug/Debug.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace llvm;
+using namespace IGC;
+
+namespace {
+
+    class ShaderProfileInstrumentation : public ModulePass
+    {
+    public:
+        static char ID;
+
+        ShaderProfileInstrumentation() : ModulePass(ID)
+        {
+            initializeShaderProfileInstrumentationPass(*PassRegistry::getPassRegistry());
+        }
+
+        StringRef getPassName() const override
+        {
+            return "ShaderProfileInstrumentation";
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesCFG();
+            AU.addRequired<CodeGenContextWrapper>();
+        }
+
+        bool runOnModule(Module& M) override;
+
+    private:
+        struct BlockCounters
+        {
+            BasicBlock* BB;
+            unsigned execSlot;
+            // -1 unless the block ends with a conditional branch
+            int takenSlot;
+        };
+
+        void instrument(Module& M, const std::vector<BlockCounters>& counters, unsigned numSlots);
+        void dumpLayout(const std::vector<BlockCounters>& counters, const CodeGenContext* ctx) const;
+    };
+
+} // namespace
+
+char ShaderProfileInstrumentation::ID = 0;
+
+#define PASS_FLAG     "igc-shader-profile-instrumentation"
+#define PASS_DESC     "Assign stable block ids and count block executions"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(ShaderProfileInstrumentation, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(ShaderProfileInstrumentation, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+ModulePass* IGC::createShaderProfileInstrumentationPass()
+{
+    return new ShaderProfileInstrumentation();
+}
+
+// The counters are added with the OpenCL builtin, which ResolveOCLAtomics
+// lowers to the GenISA atomic like any other global atomic.
+void ShaderProfileInstrumentation::instrument(
+    Module& M, const std::vector<BlockCounters>& counters, unsigned numSlots)
+{
+    LLVMContext& C = M.getContext();
+    Type* int32Ty = Type::getInt32Ty(C);
+    ArrayType* bufferTy = ArrayType::get(int32Ty, numSlots);
+    GlobalVariable* buffer = new GlobalVariable(M, bufferTy, false,
+        GlobalValue::ExternalLinkage, ConstantAggregateZero::get(bufferTy),
+        "__igc_block_profile", nullptr, GlobalValue::NotThreadLocal, ADDRESS_SPACE_GLOBAL);
+
+    PointerType* counterPtrTy = PointerType::get(int32Ty, ADDRESS_SPACE_GLOBAL);
+    FunctionType* atomicAddTy = FunctionType::get(int32Ty, { counterPtrTy, int32Ty }, false);
+    auto atomicAdd = M.getOrInsertFunction("__builtin_IB_atomic_add_global_i32", atomicAddTy);
+
+    IRBuilder<> builder(C);
+    auto addToCounter = [&](unsigned slot, Value* value) {
+        Value* indices[] = { builder.getInt32(0), builder.getInt32(slot) };
+        Value* counter = builder.CreateInBoundsGEP(bufferTy, buffer, indices);
+        builder.CreateCall(atomicAdd, { counter, value });
+    };
+
+    for (const auto& BC : counters)
+    {
+        builder.SetInsertPoint(&*BC.BB->getFirstInsertionPt());
+        addToCounter(BC.execSlot, builder.getInt32(1));
+        if (BC.takenSlot >= 0)
+        {
+            auto* BI = cast<BranchInst>(BC.BB->getTerminator());
+            builder.SetInsertPoint(BI);
+            addToCounter(BC.takenSlot, builder.CreateZExt(BI->getCondition(), int32Ty));
+        }
+    }
+}
+
+// One line per block: its profile key, then the index of its execution
+// counter and of its taken counter (-1 if none) in __igc_block_profile.
+void ShaderProfileInstrumentation::dumpLayout(
+    const std::vector<BlockCounters>& counters, const CodeGenContext* ctx) const
+{
+    char hashName[32];
+    snprintf(hashName, sizeof(hashName), "%016llx.proflayout", (unsigned long long)ctx->hash.getAsmHash());
+    std::stringstream fileName;
+    fileName << IGC::Debug::GetShaderOutputFolder() << hashName;
+    std::ofstream output(fileName.str());
+    output << "# <function> <block> <exec counter> <taken counter>" << std::endl;
+    for (const auto& BC : counters)
+    {
+        output << ShaderProfile::getBlockKey(BC.BB) << " "
+            << BC.execSlot << " " << BC.takenSlot << std::endl;
+    }
+}
+
+bool ShaderProfileInstrumentation::runOnModule(Module& M)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+
+    bool changed = false;
+    for (auto& F : M)
+    {
+        if (!F.isDeclaration())
+            changed |= ShaderProfile::assignBlockIds(F);
+    }
+
+    if (IGC_IS_FLAG_DISABLED(ShaderProfileInstrumentation))
+        return changed;
+
+    std::vector<BlockCounters> counters;
+    unsigned numSlots = 0;
+    for (auto& F : M)
+    {
+        if (F.isDeclaration())
+            continue;
+        for (auto& BB : F)
+        {
+            BlockCounters BC = { &BB, numSlots++, -1 };
+            auto* BI = dyn_cast<BranchInst>(BB.getTerminator());
+            if (BI && BI->isConditional())
+                BC.takenSlot = int(numSlots++);
+            counters.push_back(BC);
+        }
+    }
+    if (counters.empty())
+        return changed;
+
+    instrument(M, counters, numSlots);
+    dumpLayout(counters, ctx);
+    return true;
+}
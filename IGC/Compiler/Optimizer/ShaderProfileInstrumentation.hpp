@@ -0,0 +1,34 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    /// @brief Give each basic block of an OpenCL module its stable profile id
+    /// and, with the ShaderProfileInstrumentation regkey, count block
+    /// executions into a program scope buffer the runtime can read back.
+    ///
+    /// It runs during unification, before atomics are resolved and program
+    /// scope globals are laid out, so blocks are numbered at the same point
+    /// whether the shader is instrumented or compiled with its profile; the
+    /// ShaderProfileLoader pass keeps these ids.
+    ///
+    /// Each block atomically adds one to its counter in the
+    /// __igc_block_profile global on entry, and each conditional branch adds
+    /// its condition to a second counter, so that counts are per work item.
+    /// The counter of every block is written to <asm hash>.proflayout in the
+    /// shader dump folder; IGC/Scripts/decode_block_profile.py turns that
+    /// layout and the buffer contents into a <asm hash>.prof file for
+    /// ShaderProfileDir.
+    llvm::ModulePass* createShaderProfileInstrumentationPass();
+} // namespace IGC
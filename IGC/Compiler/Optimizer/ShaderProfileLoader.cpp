@@ -0,0 +1,149 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/Optimizer/ShaderProfileLoader.hpp"
+#include "Compiler/CodeGenContextWrapper.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "Compiler/IGCPassSupport.h"
+#include "Compiler/ShaderProfile.hpp"
+#include "common/debug/Debug.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+#include <llvm/IR/Module.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace llvm;
+using namespace IGC;
+
+namespace {
+
+    class ShaderProfileLoader : public ModulePass
+    {
+    public:
+        static char ID;
+
+        ShaderProfileLoader() : ModulePass(ID)
+        {
+            initializeShaderProfileLoaderPass(*PassRegistry::getPassRegistry());
+        }
+
+        StringRef getPassName() const override
+        {
+            return "ShaderProfileLoader";
+        }
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesCFG();
+            AU.addRequired<CodeGenContextWrapper>();
+        }
+
+        bool runOnModule(Module& M) override;
+
+    private:
+        bool attachProfile(Function& F, const ShaderProfile& profile);
+        void dumpBlockIds(Module& M, const CodeGenContext* ctx) const;
+    };
+
+} // namespace
+
+char ShaderProfileLoader::ID = 0;
+
+#define PASS_FLAG     "igc-shader-profile-loader"
+#define PASS_DESC     "Assign stable block ids and attach the runtime shader profile"
+#define PASS_CFG_ONLY false
+#define PASS_ANALYSIS false
+IGC_INITIALIZE_PASS_BEGIN(ShaderProfileLoader, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_END(ShaderProfileLoader, PASS_FLAG, PASS_DESC, PASS_CFG_ONLY, PASS_ANALYSIS)
+
+ModulePass* IGC::createShaderProfileLoaderPass()
+{
+    return new ShaderProfileLoader();
+}
+
+bool ShaderProfileLoader::attachProfile(Function& F, const ShaderProfile& profile)
+{
+    bool changed = false;
+    uint64_t entryCount = 0;
+    if (profile.getExecCount(&F.getEntryBlock(), entryCount))
+    {
+        F.setEntryCount(Function::ProfileCount(entryCount, Function::PCT_Real));
+        changed = true;
+    }
+
+    // Ratios are scaled to integer weights; keep every edge possible so that
+    // a branch never seen taken is still laid out as reachable.
+    const uint32_t scale = 1 << 20;
+    MDBuilder MDB(F.getContext());
+    for (auto& BB : F)
+    {
+        auto* BI = dyn_cast<BranchInst>(BB.getTerminator());
+        float ratio = 0.0f;
+        if (!BI || !BI->isConditional() || !profile.getTakenRatio(&BB, ratio))
+            continue;
+        uint32_t taken = std::max(1u, uint32_t(ratio * scale));
+        uint32_t notTaken = std::max(1u, scale - std::min(scale, taken));
+        BI->setMetadata(LLVMContext::MD_prof, MDB.createBranchWeights(taken, notTaken));
+        changed = true;
+    }
+    return changed;
+}
+
+void ShaderProfileLoader::dumpBlockIds(Module& M, const CodeGenContext* ctx) const
+{
+    char hashName[32];
+    snprintf(hashName, sizeof(hashName), "%016llx.profids", (unsigned long long)ctx->hash.getAsmHash());
+    std::stringstream fileName;
+    fileName << IGC::Debug::GetShaderOutputFolder() << hashName;
+    std::ofstream output(fileName.str());
+    for (auto& F : M)
+    {
+        for (auto& BB : F)
+        {
+            if (!BB.getTerminator()->getMetadata(ShaderProfile::BlockIdMDName))
+                continue;
+            output << ShaderProfile::getBlockKey(&BB) << " "
+                << (BB.hasName() ? BB.getName().str() : std::string("-")) << std::endl;
+        }
+    }
+}
+
+bool ShaderProfileLoader::runOnModule(Module& M)
+{
+    CodeGenContext* ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+
+    bool changed = false;
+    for (auto& F : M)
+    {
+        if (!F.isDeclaration())
+            changed |= ShaderProfile::assignBlockIds(F);
+    }
+
+    if (IGC_IS_FLAG_ENABLED(DumpShaderProfileIds))
+        dumpBlockIds(M, ctx);
+
+    std::unique_ptr<ShaderProfile> profile = ShaderProfile::load(ctx);
+    if (!profile)
+        return changed;
+    for (auto& F : M)
+    {
+        if (!F.isDeclaration())
+            changed |= attachProfile(F, *profile);
+    }
+    return changed;
+}
@@ -0,0 +1,32 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Pass.h>
+#include "common/LLVMWarningsPop.hpp"
+
+namespace IGC
+{
+    /// @brief Give each basic block a stable id and attach the runtime profile
+    /// of the shader, if any, as LLVM profile metadata.
+    ///
+    /// Ids are assigned in layout order right after unification and kept on
+    /// block terminators, so they survive later CFG changes and identify the
+    /// same blocks on every compilation of the same shader. OpenCL blocks are
+    /// already numbered during unification by ShaderProfileInstrumentation and
+    /// keep those ids. With the
+    /// DumpShaderProfileIds regkey they are written to <asm hash>.profids in
+    /// the shader dump folder next to the binary, for the runtime to key its
+    /// counters by. When ShaderProfile finds a profile, its branch taken ratios
+    /// become !prof branch weights and the entry block count the function
+    /// entry count, which the LLVM inliner, unroller and block frequency based
+    /// heuristics consume.
+    llvm::ModulePass* createShaderProfileLoaderPass();
+} // namespace IGC
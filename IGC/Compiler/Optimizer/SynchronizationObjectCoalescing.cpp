@@ -9,11 +9,14 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/PassInfo.h"
 #include "llvm/PassRegistry.h"
+#include "llvm/IR/CFG.h"
 #include "common/LLVMWarningsPop.hpp"
 #include "GenISAIntrinsics/GenIntrinsicInst.h"
 #include "IGC/Compiler/CodeGenPublic.h"
 #include "Probe/Assertion.h"
 #include "Compiler/IGCPassSupport.h"
+#include "Compiler/MetaDataUtilsWrapper.h"
+#include "Compiler/CISACodeGen/helper.h"
 #include "SynchronizationObjectCoalescing.hpp"
 
 namespace IGC
@@ -45,6 +48,223 @@ bool SynchronizationObjectCoalescing::runOnFunction(llvm::Function& F)
     {
         I->eraseFromParent();
     }
+    if (IGC_IS_FLAG_ENABLED(EnableRedundantBarrierRemoval))
+    {
+        isModified |= RemoveRedundantSynchronization(F);
+    }
+    return isModified;
+}
+
+////////////////////////////////////////////////////////////////////////
+static bool IsSynchronizationInst(const llvm::Instruction* inst, llvm::GenISAIntrinsic::ID id)
+{
+    const llvm::GenIntrinsicInst* genIntrinsicInst = llvm::dyn_cast<llvm::GenIntrinsicInst>(inst);
+    return genIntrinsicInst && genIntrinsicInst->getIntrinsicID() == id;
+}
+
+////////////////////////////////////////////////////////////////////////
+static bool IsSharedMemoryAccess(const llvm::Instruction* inst)
+{
+    if (!inst->mayReadOrWriteMemory())
+    {
+        return false;
+    }
+    // Private memory is not visible to other work items.
+    if (const llvm::LoadInst* loadInst = llvm::dyn_cast<llvm::LoadInst>(inst))
+    {
+        return loadInst->getPointerAddressSpace() != ADDRESS_SPACE_PRIVATE;
+    }
+    if (const llvm::StoreInst* storeInst = llvm::dyn_cast<llvm::StoreInst>(inst))
+    {
+        return storeInst->getPointerAddressSpace() != ADDRESS_SPACE_PRIVATE;
+    }
+    // Calls, atomics and intrinsics accessing memory are assumed to access
+    // shared memory.
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+bool SynchronizationObjectCoalescing::IsRegionFreeOfSharedAccesses(
+    llvm::Instruction* inst,
+    bool forward,
+    const std::function<bool(const llvm::Instruction*)>& isBoundary) const
+{
+    enum class ScanResult { Continue, Boundary, Conflict };
+    auto scan = [&](const llvm::Instruction* I)
+    {
+        if (I == inst)
+        {
+            return ScanResult::Continue;
+        }
+        if (isBoundary(I))
+        {
+            return ScanResult::Boundary;
+        }
+        if (IsSynchronizationInst(I, llvm::GenISAIntrinsic::GenISA_threadgroupbarrier) ||
+            IsSynchronizationInst(I, llvm::GenISAIntrinsic::GenISA_memoryfence))
+        {
+            return ScanResult::Continue;
+        }
+        return IsSharedMemoryAccess(I) ? ScanResult::Conflict : ScanResult::Continue;
+    };
+
+    // Scans the instructions of a block in the walk direction starting at the
+    // given one. Returns false on a conflicting access, and sets reachedEnd
+    // when no boundary was met.
+    auto scanBlock = [&](llvm::BasicBlock* BB, llvm::Instruction* start, bool& reachedEnd)
+    {
+        reachedEnd = false;
+        if (forward)
+        {
+            for (auto it = start ? start->getIterator() : BB->begin(); it != BB->end(); ++it)
+            {
+                ScanResult result = scan(&*it);
+                if (result != ScanResult::Continue)
+                {
+                    return result == ScanResult::Boundary;
+                }
+            }
+        }
+        else
+        {
+            for (auto it = start ? start->getReverseIterator() : BB->rbegin(); it != BB->rend(); ++it)
+            {
+                ScanResult result = scan(&*it);
+                if (result != ScanResult::Continue)
+                {
+                    return result == ScanResult::Boundary;
+                }
+            }
+        }
+        reachedEnd = true;
+        return true;
+    };
+
+    llvm::SmallVector<llvm::BasicBlock*, 16> workList;
+    llvm::SmallPtrSet<llvm::BasicBlock*, 16> visited;
+    // Outside of the entry point, accesses of the caller are unknown.
+    auto pushNext = [&](llvm::BasicBlock* BB)
+    {
+        if (forward)
+        {
+            if (llvm::succ_empty(BB))
+            {
+                return m_IsEntry;
+            }
+            workList.append(llvm::succ_begin(BB), llvm::succ_end(BB));
+        }
+        else
+        {
+            if (BB == &BB->getParent()->getEntryBlock())
+            {
+                return m_IsEntry;
+            }
+            workList.append(llvm::pred_begin(BB), llvm::pred_end(BB));
+        }
+        return true;
+    };
+
+    bool reachedEnd = false;
+    llvm::BasicBlock* BB = inst->getParent();
+    if (!scanBlock(BB, inst, reachedEnd) || (reachedEnd && !pushNext(BB)))
+    {
+        return false;
+    }
+    while (!workList.empty())
+    {
+        BB = workList.pop_back_val();
+        if (!visited.insert(BB).second)
+        {
+            continue;
+        }
+        if (!scanBlock(BB, nullptr, reachedEnd) || (reachedEnd && !pushNext(BB)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////
+/// A barrier orders the shared memory accesses executed before it against
+/// the ones executed after it. If no access executes between the barrier and
+/// the previous one (or the entry), or between the barrier and the next one
+/// (or the end of the thread), the neighbouring barrier already provides this
+/// ordering. Likewise, a memory fence is a no-op if no access executed since
+/// the previous fence covering the same memory.
+bool SynchronizationObjectCoalescing::RemoveRedundantSynchronization(llvm::Function& F)
+{
+    const CodeGenContext* const ctx = getAnalysis<CodeGenContextWrapper>().getCodeGenContext();
+    IGCMD::MetaDataUtils* pMdUtils = getAnalysis<MetaDataUtilsWrapper>().getMetaDataUtils();
+    m_IsEntry = isEntryFunc(pMdUtils, &F);
+
+    const uint32_t L3FlushRWDataArg = 1;
+    const uint32_t L3FlushInstructionsArg = 4;
+    const uint32_t globalMemFenceArg = 5;
+    const uint32_t L1CacheInvalidateArg = 6;
+    auto getBoolArg = [](const llvm::Instruction* inst, uint32_t arg)
+    {
+        return llvm::cast<llvm::ConstantInt>(inst->getOperand(arg))->getValue().getBoolValue();
+    };
+
+    std::vector<llvm::Instruction*> barriers;
+    std::vector<llvm::Instruction*> fences;
+    for (llvm::BasicBlock& BB : F)
+    {
+        for (llvm::Instruction& I : BB)
+        {
+            if (IsSynchronizationInst(&I, llvm::GenISAIntrinsic::GenISA_threadgroupbarrier))
+            {
+                barriers.push_back(&I);
+            }
+            else if (IsSynchronizationInst(&I, llvm::GenISAIntrinsic::GenISA_memoryfence))
+            {
+                fences.push_back(&I);
+            }
+        }
+    }
+
+    bool isModified = false;
+    auto isBarrier = [](const llvm::Instruction* I)
+    {
+        return IsSynchronizationInst(I, llvm::GenISAIntrinsic::GenISA_threadgroupbarrier);
+    };
+    for (llvm::Instruction* barrier : barriers)
+    {
+        if (IsRegionFreeOfSharedAccesses(barrier, false, isBarrier) ||
+            IsRegionFreeOfSharedAccesses(barrier, true, isBarrier))
+        {
+            barrier->eraseFromParent();
+            isModified = true;
+        }
+    }
+
+    for (llvm::Instruction* fence : fences)
+    {
+        // Flushes and invalidations also affect the following accesses.
+        bool hasCacheControl = getBoolArg(fence, L1CacheInvalidateArg);
+        for (uint32_t arg = L3FlushRWDataArg; arg <= L3FlushInstructionsArg; ++arg)
+        {
+            hasCacheControl |= getBoolArg(fence, arg);
+        }
+        if (hasCacheControl)
+        {
+            continue;
+        }
+        // On platforms with a separate SLM fence, an SLM fence doesn't commit
+        // global memory accesses.
+        const bool isGlobal = getBoolArg(fence, globalMemFenceArg);
+        auto isCoveringFence = [&](const llvm::Instruction* I)
+        {
+            return IsSynchronizationInst(I, llvm::GenISAIntrinsic::GenISA_memoryfence) &&
+                (!ctx->platform.hasSLMFence() || !isGlobal || getBoolArg(I, globalMemFenceArg));
+        };
+        if (IsRegionFreeOfSharedAccesses(fence, false, isCoveringFence))
+        {
+            fence->eraseFromParent();
+            isModified = true;
+        }
+    }
     return isModified;
 }
 
@@ -200,6 +420,10 @@ void SynchronizationObjectCoalescing::getAnalysisUsage(llvm::AnalysisUsage& AU)
     AU.setPreservesCFG();
     AU.addRequired<CodeGenContextWrapper>();
     AU.addPreserved<CodeGenContextWrapper>();
+    if (IGC_IS_FLAG_ENABLED(EnableRedundantBarrierRemoval))
+    {
+        AU.addRequired<MetaDataUtilsWrapper>();
+    }
 }
 
 }
@@ -212,4 +436,5 @@ using namespace IGC;
 #define PASS_ANALYSIS false
 IGC_INITIALIZE_PASS_BEGIN(SynchronizationObjectCoalescing, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
 IGC_INITIALIZE_PASS_DEPENDENCY(CodeGenContextWrapper)
+IGC_INITIALIZE_PASS_DEPENDENCY(MetaDataUtilsWrapper)
 IGC_INITIALIZE_PASS_END(SynchronizationObjectCoalescing, PASS_FLAG, PASS_DESCRIPTION, PASS_CFG_ONLY, PASS_ANALYSIS)
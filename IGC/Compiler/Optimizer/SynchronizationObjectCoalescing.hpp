@@ -13,6 +13,8 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPop.hpp"
 #include "Types.hpp"
 
+#include <functional>
+
 namespace llvm
 {
 class GenIntrinsicInst;
@@ -63,11 +65,31 @@ public:
     /// @param  container
     bool CompareAndMergeMemoryFenceWithContainerContent(const llvm::GenIntrinsicInst* inst, const std::vector<llvm::GenIntrinsicInst*>& container);
 
+    ////////////////////////////////////////////////////////////////////////
+    /// @brief Removes thread group barriers which don't order any shared
+    /// memory access, and memory fences with no shared memory access to
+    /// commit.
+    /// @param  F
+    bool RemoveRedundantSynchronization(llvm::Function& F);
+
+    ////////////////////////////////////////////////////////////////////////
+    /// @brief Checks that no shared memory access may execute between the
+    /// synchronization instruction and the closest preceding (or following)
+    /// instruction accepted by isBoundary, on any path.
+    /// @param  inst
+    /// @param  forward
+    /// @param  isBoundary
+    bool IsRegionFreeOfSharedAccesses(
+        llvm::Instruction* inst,
+        bool forward,
+        const std::function<bool(const llvm::Instruction*)>& isBoundary) const;
+
     ////////////////////////////////////////////////////////////////////////
     virtual void getAnalysisUsage(llvm::AnalysisUsage& AU) const;
 
 private:
     std::vector<llvm::Instruction*> m_RepeatedBarrierCalls;
+    bool m_IsEntry = false;
 };
 
 } // namespace IGC
@@ -16,6 +16,7 @@ SPDX-License-Identifier: MIT
 #include "common/IGCIRBuilder.h"
 #include "Compiler/CISACodeGen/helper.h"
 #include "Probe/Assertion.h"
+#include <map>
 using namespace IGC::IGCMD;
 
 using namespace llvm;
@@ -183,6 +184,12 @@ void PromoteStatelessToBindless::PromoteStatelessToBindlessBuffers(Function& F)
         }
     }
 
+    // The base bindless pointer of each buffer is created once at the function
+    // entry and shared by all of its accesses, so that the surface state offset
+    // stays in one uniform variable instead of being recomputed per message.
+    std::map<std::pair<Value*, Type*>, Value*> basePointers;
+    IGCIRBuilder<> entryBuilder(&*F.getEntryBlock().getFirstInsertionPt());
+
     for (auto inst : m_AccessToSrcPtrMap)
     {
         Instruction* accessInst = cast<Instruction>(inst.first);
@@ -198,7 +205,11 @@ void PromoteStatelessToBindless::PromoteStatelessToBindlessBuffers(Function& F)
         Value* resourcePtr = IGC::GetBufferOperand(accessInst);
         unsigned bindlessAS = IGC::EncodeAS4GFXResource(*UndefValue::get(builder.getInt32Ty()), IGC::BINDLESS);
         PointerType* basePointerType = PointerType::get(resourcePtr->getType()->getPointerElementType(), bindlessAS);
-        Value* basePointer = builder.CreatePointerCast(srcPtr, basePointerType);
+        Value*& basePointer = basePointers[std::make_pair(srcPtr, basePointerType)];
+        if (!basePointer)
+        {
+            basePointer = entryBuilder.CreatePointerCast(srcPtr, basePointerType);
+        }
         Value* bufferOffset = builder.CreatePtrToInt(resourcePtr, builder.getInt32Ty());
 
         if (LoadInst * load = dyn_cast<LoadInst>(accessInst))
@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CodeGenPublicEnums.h"
 #include "Compiler/IGCPassSupport.h"
 #include "Compiler/InitializePasses.h"
+#include "Compiler/ShaderProfile.hpp"
 #include "common/secure_mem.h"
 #include "Probe/Assertion.h"
 
@@ -159,6 +160,36 @@ bool SampleMultiversioning::isOnlyMultipliedAfterSample(Instruction* Val,
     return true;
 };
 
+// Samples from a texture the driver reported as constant are folded by
+// DynamicTextureFolding, branching around them only adds code.
+bool SampleMultiversioning::isFoldedByResourceFacts(Instruction* Sample)
+{
+    if (!pContext || pContext->getModuleMetaData()->inlineDynTextures.empty())
+    {
+        return false;
+    }
+
+    Value* texture = nullptr;
+    if (auto * SI = dyn_cast<SampleIntrinsic>(Sample))
+    {
+        texture = SI->getTextureValue();
+    }
+    else if (auto * LI = dyn_cast<SamplerLoadIntrinsic>(Sample))
+    {
+        texture = LI->getTextureValue();
+    }
+    else
+    {
+        return false;
+    }
+
+    bool directIdx = false;
+    unsigned textureIndex = 0;
+    DecodeAS4GFXResource(texture->getType()->getPointerAddressSpace(), directIdx, textureIndex);
+    return directIdx &&
+        pContext->getModuleMetaData()->inlineDynTextures.count(textureIndex) != 0;
+}
+
 bool SampleMultiversioning::runOnFunction(Function& F)
 {
     DT = &getAnalysis<DominatorTreeWrapperPass>().getDomTree();
@@ -179,7 +210,9 @@ bool SampleMultiversioning::runOnFunction(Function& F)
             if (isSampleLoadGather4InfoInstruction(&Inst) ||
                 isa<LdRawIntrinsic>(Inst))
             {
-                if (isOnlyMultipliedAfterSample(&Inst, TmpMulVals))
+                if (!isFoldedByResourceFacts(&Inst) &&
+                    isOnlyMultipliedAfterSample(&Inst, TmpMulVals) &&
+                    !TmpMulVals.empty())
                 {
                     for (auto Val : TmpMulVals)
                     {
@@ -195,6 +228,7 @@ bool SampleMultiversioning::runOnFunction(Function& F)
 
     if (SampleInsts.size() < 4)
     {
+        std::unique_ptr<ShaderProfile> profile = ShaderProfile::load(pContext);
         // @TODO
         // bitcast after sample
         // And instead of Mul
@@ -205,6 +239,16 @@ bool SampleMultiversioning::runOnFunction(Function& F)
             BasicBlock* Parent = Sample->getParent();
             IGC_ASSERT(SI.MulVals.size());
 
+            // The new branch only skips the sample when all lanes see a zero
+            // multiplier. Lanes of a block measured as divergent are unlikely
+            // to agree, and a block never executed is not worth the extra code.
+            uint64_t execCount = 0;
+            if (profile && (profile->isDivergent(Parent) ||
+                (profile->getExecCount(Parent, execCount) && execCount == 0)))
+            {
+                continue;
+            }
+
             // Check if some multipliers are redundant or duplicated
             SmallSet<Instruction*, 4> ToRemove;
             for (auto CurrMulVal : SI.MulVals)
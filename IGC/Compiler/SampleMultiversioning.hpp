@@ -50,5 +50,6 @@ namespace IGC {
         bool isOnlyMultiplied(Instruction* Sample, Instruction* Val, SmallSet<Instruction*, 4> & MulVals);
         Instruction* getPureFunction(Value* Val);
         bool isOnlyMultipliedAfterSample(Instruction* Val, SmallSet<Instruction*, 4> & MulVals);
+        bool isFoldedByResourceFacts(Instruction* Sample);
     };
 } // namespace IGC
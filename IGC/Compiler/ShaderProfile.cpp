@@ -0,0 +1,156 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "Compiler/ShaderProfile.hpp"
+#include "Compiler/CodeGenPublic.h"
+#include "common/igc_regkeys.hpp"
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Metadata.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+using namespace llvm;
+using namespace IGC;
+
+constexpr const char* ShaderProfile::BlockIdMDName;
+
+std::unique_ptr<ShaderProfile> ShaderProfile::load(const CodeGenContext* ctx)
+{
+    if (!ctx)
+        return nullptr;
+    std::string dir(IGC_GET_REGKEYSTRING(ShaderProfileDir));
+    if (dir.empty())
+        return nullptr;
+
+    char hashName[32];
+    snprintf(hashName, sizeof(hashName), "%016llx.prof", (unsigned long long)ctx->hash.getAsmHash());
+    if (dir.back() != '/' && dir.back() != '\\')
+        dir += '/';
+    std::ifstream input(dir + hashName);
+    if (!input.is_open())
+        return nullptr;
+
+    std::unique_ptr<ShaderProfile> profile(new ShaderProfile());
+    std::string line;
+    while (std::getline(input, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream fields(line);
+        std::string func, block;
+        BlockProfile BP = {};
+        if (!(fields >> func >> block >> BP.execCount >> BP.divergentCount))
+            continue;
+        if (!(fields >> BP.takenRatio) || BP.takenRatio < 0.0f || BP.takenRatio > 1.0f)
+            BP.takenRatio = -1.0f;
+        if (BP.divergentCount > BP.execCount)
+            BP.divergentCount = BP.execCount;
+        profile->m_blocks[func + " " + block] = BP;
+    }
+    if (profile->m_blocks.empty())
+        return nullptr;
+    return profile;
+}
+
+std::string ShaderProfile::getBlockKey(const BasicBlock* BB)
+{
+    std::string key = BB->getParent()->getName().str() + " ";
+    if (const Instruction* term = BB->getTerminator())
+    {
+        if (MDNode* id = term->getMetadata(BlockIdMDName))
+        {
+            uint64_t value = mdconst::extract<ConstantInt>(id->getOperand(0))->getZExtValue();
+            return key + "@" + std::to_string(value);
+        }
+    }
+    if (BB->hasName())
+        return key + BB->getName().str();
+    unsigned index = 0;
+    for (auto& B : *BB->getParent())
+    {
+        if (&B == BB)
+            break;
+        ++index;
+    }
+    return key + "#" + std::to_string(index);
+}
+
+// Running again once blocks have been added only numbers the new ones, after
+// the highest existing id.
+bool ShaderProfile::assignBlockIds(Function& F)
+{
+    uint64_t nextId = 0;
+    for (auto& BB : F)
+    {
+        if (MDNode* id = BB.getTerminator()->getMetadata(BlockIdMDName))
+        {
+            uint64_t value = mdconst::extract<ConstantInt>(id->getOperand(0))->getZExtValue();
+            nextId = std::max(nextId, value + 1);
+        }
+    }
+
+    bool changed = false;
+    Type* int32Ty = Type::getInt32Ty(F.getContext());
+    for (auto& BB : F)
+    {
+        Instruction* term = BB.getTerminator();
+        if (term->getMetadata(BlockIdMDName))
+            continue;
+        MDNode* id = MDNode::get(F.getContext(),
+            ConstantAsMetadata::get(ConstantInt::get(int32Ty, nextId++)));
+        term->setMetadata(BlockIdMDName, id);
+        changed = true;
+    }
+    return changed;
+}
+
+const ShaderProfile::BlockProfile* ShaderProfile::lookup(const BasicBlock* BB) const
+{
+    auto it = m_blocks.find(getBlockKey(BB));
+    return it == m_blocks.end() ? nullptr : &it->second;
+}
+
+bool ShaderProfile::getExecCount(const BasicBlock* BB, uint64_t& count) const
+{
+    const BlockProfile* BP = lookup(BB);
+    if (!BP)
+        return false;
+    count = BP->execCount;
+    return true;
+}
+
+bool ShaderProfile::getDivergence(const BasicBlock* BB, float& divergence) const
+{
+    const BlockProfile* BP = lookup(BB);
+    if (!BP || BP->execCount == 0)
+        return false;
+    divergence = float(BP->divergentCount) / float(BP->execCount);
+    return true;
+}
+
+bool ShaderProfile::isDivergent(const BasicBlock* BB) const
+{
+    float divergence = 0.0f;
+    return getDivergence(BB, divergence) &&
+        divergence * 100.0f >= float(IGC_GET_FLAG_VALUE(ProfileDivergenceThreshold));
+}
+
+bool ShaderProfile::getTakenRatio(const BasicBlock* BB, float& ratio) const
+{
+    const BlockProfile* BP = lookup(BB);
+    if (!BP || BP->takenRatio < 0.0f)
+        return false;
+    ratio = BP->takenRatio;
+    return true;
+}
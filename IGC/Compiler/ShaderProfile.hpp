@@ -0,0 +1,88 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/StringMap.h>
+#include <llvm/IR/BasicBlock.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace IGC
+{
+    class CodeGenContext;
+
+    /// @brief Execution profile of a shader measured by the runtime and fed back
+    /// to the compiler through a sidecar file. The file is looked up as
+    /// <ShaderProfileDir>/<asm hash, 16 hex digits>.prof and holds one line per
+    /// basic block:
+    ///
+    ///     <function name> <block> <execution count> <divergent count> [<taken ratio>]
+    ///
+    /// where the divergent count is the number of executions with only part of
+    /// the lanes enabled, and the optional taken ratio is the fraction of
+    /// executions of a conditional branch that go to its first successor.
+    /// Blocks numbered by the ShaderProfileLoader pass are keyed by their stable
+    /// id, written as @<id>; other blocks by their name, or by their position in
+    /// the function written as #<index>. Lines starting with '#' are comments.
+    ///
+    /// Passes use it to weight static heuristics with measured frequencies;
+    /// blocks missing from the profile keep the static decision.
+    class ShaderProfile
+    {
+    public:
+        /// @brief Load the profile of the shader being compiled by ctx.
+        /// Returns nullptr if no profile directory is set or there is no
+        /// profile for this shader.
+        static std::unique_ptr<ShaderProfile> load(const CodeGenContext* ctx);
+
+        /// @brief Number of times BB was executed, if profiled.
+        bool getExecCount(const llvm::BasicBlock* BB, uint64_t& count) const;
+
+        /// @brief Fraction of the executions of BB with only part of the lanes
+        /// enabled, in [0, 1], if profiled.
+        bool getDivergence(const llvm::BasicBlock* BB, float& divergence) const;
+
+        /// @brief Whether BB was profiled with a divergence at or above the
+        /// ProfileDivergenceThreshold regkey.
+        bool isDivergent(const llvm::BasicBlock* BB) const;
+
+        /// @brief Fraction of the executions of the conditional branch ending
+        /// BB that go to its first successor, in [0, 1], if profiled.
+        bool getTakenRatio(const llvm::BasicBlock* BB, float& ratio) const;
+
+        /// @brief Metadata kind holding the stable id of a block, attached to
+        /// its terminator.
+        static constexpr const char* BlockIdMDName = "igc.profile.id";
+
+        /// @brief Key the block is looked up by in the profile file.
+        static std::string getBlockKey(const llvm::BasicBlock* BB);
+
+        /// @brief Give every block of F without a stable id the next free one.
+        /// Blocks already numbered keep their id. Returns true if any block
+        /// was numbered.
+        static bool assignBlockIds(llvm::Function& F);
+
+    private:
+        struct BlockProfile
+        {
+            uint64_t execCount;
+            uint64_t divergentCount;
+            float takenRatio;
+        };
+
+        const BlockProfile* lookup(const llvm::BasicBlock* BB) const;
+
+        llvm::StringMap<BlockProfile> m_blocks;
+    };
+
+} // namespace IGC
@@ -743,6 +743,26 @@ bool ThreadCombining::runOnModule(llvm::Module& M)
         minTGSizeHeuristic = 256;
     }
 
+    // The combined kernel runs each barrier-separated section in a loop over
+    // the merged logical threads, storing and reloading every value live
+    // across a barrier and paying the loop control per iteration. Estimate
+    // that as a fraction of the kernel's own instructions; combining must
+    // gain more occupancy than this costs.
+    unsigned int numInsts = 0;
+    for (auto& BB : *m_kernel)
+    {
+        numInsts += BB.size();
+    }
+    const unsigned int numBarriers = m_barriers.size();
+    const unsigned int numLiveAcrossBarriers = m_aliveAcrossBarrier.size();
+    const unsigned int loopOverheadPerIteration = 4;
+    float combiningCost = 1.0f;
+    if (IGC_IS_FLAG_DISABLED(DisableThreadCombiningCostModel) && numInsts > 0)
+    {
+        combiningCost += float(2 * numBarriers * numLiveAcrossBarriers +
+            (numBarriers + 1) * loopOverheadPerIteration) / float(numInsts);
+    }
+
     float currentThreadOccupancy = csCtx->GetThreadOccupancy(simdMode);
     unsigned x = (threadGroupSize_X % 2 == 0) ? threadGroupSize_X / 2 : threadGroupSize_X;
     unsigned y = (threadGroupSize_Y % 2 == 0) ? threadGroupSize_Y / 2 : threadGroupSize_Y;
@@ -760,10 +780,11 @@ bool ThreadCombining::runOnModule(llvm::Module& M)
         newSizeX = IGC_GET_FLAG_VALUE(ForceGroupSizeX);
         newSizeY = IGC_GET_FLAG_VALUE(ForceGroupSizeY);
     }
-    else if (x * y >= minTGSizeHeuristic && newThreadOccupancy > currentThreadOccupancy)
+    else if (x * y >= minTGSizeHeuristic &&
+             newThreadOccupancy > currentThreadOccupancy * combiningCost)
     {
         // Heuristic for Threadcombining based on EU Occupancy, if EU occupancy increases with the new
-        // size then combine threads, otherwise skip it
+        // size by more than the combining overhead then combine threads, otherwise skip it
         newSizeX = x;
         newSizeY = y;
         currentThreadOccupancy = newThreadOccupancy;
@@ -774,10 +795,15 @@ bool ThreadCombining::runOnModule(llvm::Module& M)
         {
             newSizeX = x;
             newSizeY = y;
+            currentThreadOccupancy = newThreadOccupancy;
         }
     }
     else
     {
+        if (x * y >= minTGSizeHeuristic && newThreadOccupancy > currentThreadOccupancy)
+        {
+            context->Stats().SetFlag("ThreadCombiningRejectedByCost");
+        }
         return false;
     }
 
@@ -792,6 +818,11 @@ bool ThreadCombining::runOnModule(llvm::Module& M)
     SetthreadGroupSize(M, builder.getInt32(newSizeX), ThreadGroupSize_X);
     SetthreadGroupSize(M, builder.getInt32(newSizeY), ThreadGroupSize_Y);
 
+    context->Stats().SetI64("ThreadCombiningFactor",
+        (threadGroupSize_X / newSizeX) * (threadGroupSize_Y / newSizeY));
+    context->Stats().SetF64("ThreadCombiningCost", combiningCost);
+    context->Stats().SetF64("ThreadCombiningOccupancy", currentThreadOccupancy);
+
     if (IGC_IS_FLAG_ENABLED(EnableForceGroupSize))
     {
         // Don't perform thread combining, just remap threads as if thread group size hasn't been changed
@@ -0,0 +1,69 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-loop-invariant-load-motion -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; An SLM only fence keeps the global load invariant, but not the SLM one.
+
+; CHECK-LABEL: define spir_kernel void @slm_fence
+; CHECK: entry:
+; CHECK: %g = load float, float addrspace(1)* %gptr
+; CHECK: loop:
+; CHECK: %l = load float, float addrspace(3)* %lptr
+; CHECK: call void @llvm.genx.GenISA.memoryfence
+
+define spir_kernel void @slm_fence(float addrspace(1)* %gptr, float addrspace(3)* %lptr, float addrspace(1)* %out, i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %acc = phi float [ 0.0, %entry ], [ %acc.next, %loop ]
+  %g = load float, float addrspace(1)* %gptr, align 4
+  %l = load float, float addrspace(3)* %lptr, align 4
+  %sum = fadd float %g, %l
+  %acc.next = fadd float %acc, %sum
+  call void @llvm.genx.GenISA.memoryfence(i1 true, i1 false, i1 false, i1 false, i1 false, i1 false, i1 false)
+  call void @llvm.genx.GenISA.threadgroupbarrier()
+  %i.next = add i32 %i, 1
+  %cond = icmp slt i32 %i.next, %n
+  br i1 %cond, label %loop, label %exit
+
+exit:
+  store float %acc.next, float addrspace(1)* %out, align 4
+  ret void
+}
+
+; A global fence keeps the global load in the loop.
+
+; CHECK-LABEL: define spir_kernel void @global_fence
+; CHECK: loop:
+; CHECK: %g = load float, float addrspace(1)* %gptr
+
+define spir_kernel void @global_fence(float addrspace(1)* %gptr, float addrspace(1)* %out, i32 %n) {
+entry:
+  br label %loop
+
+loop:
+  %i = phi i32 [ 0, %entry ], [ %i.next, %loop ]
+  %acc = phi float [ 0.0, %entry ], [ %acc.next, %loop ]
+  %g = load float, float addrspace(1)* %gptr, align 4
+  %acc.next = fadd float %acc, %g
+  call void @llvm.genx.GenISA.memoryfence(i1 true, i1 false, i1 false, i1 false, i1 false, i1 true, i1 false)
+  %i.next = add i32 %i, 1
+  %cond = icmp slt i32 %i.next, %n
+  br i1 %cond, label %loop, label %exit
+
+exit:
+  store float %acc.next, float addrspace(1)* %out, align 4
+  ret void
+}
+
+declare void @llvm.genx.GenISA.memoryfence(i1, i1, i1, i1, i1, i1, i1)
+declare void @llvm.genx.GenISA.threadgroupbarrier()
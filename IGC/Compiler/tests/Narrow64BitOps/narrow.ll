@@ -0,0 +1,39 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-narrow-64bit-ops -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; The sum of two 16-bit values and the division of two 32-bit values fit in
+; 32 bits; the product of two 32-bit values doesn't.
+
+; CHECK-LABEL: define i64 @test
+; CHECK: [[ADD:%.*]] = add i32 %a, %b
+; CHECK: %add = zext i32 [[ADD]] to i64
+; CHECK: [[DIV:%.*]] = udiv i32 %c, %d
+; CHECK: %div = zext i32 [[DIV]] to i64
+; CHECK: %mul = mul i64 %zc, %zd
+; CHECK: [[CMP:%.*]] = icmp ult i32 [[ADD]], %c
+; CHECK-NOT: icmp ult i64
+
+define i64 @test(i16 %x, i16 %y, i32 %c, i32 %d) {
+  %za = zext i16 %x to i64
+  %zb = zext i16 %y to i64
+  %a = trunc i64 %za to i32
+  %b = trunc i64 %zb to i32
+  %zza = zext i32 %a to i64
+  %zzb = zext i32 %b to i64
+  %add = add i64 %zza, %zzb
+  %zc = zext i32 %c to i64
+  %zd = zext i32 %d to i64
+  %div = udiv i64 %zc, %zd
+  %mul = mul i64 %zc, %zd
+  %cmp = icmp ult i64 %add, %zc
+  %s = select i1 %cmp, i64 %div, i64 %mul
+  ret i64 %s
+}
@@ -0,0 +1,38 @@
+;=========================== begin_copyright_notice ============================
+;
+; Copyright (C) 2021 Intel Corporation
+;
+; SPDX-License-Identifier: MIT
+;
+;============================ end_copyright_notice =============================
+
+; RUN: igc_opt -igc-shader-profile-loader -S %s -o %t.ll
+; RUN: FileCheck %s --input-file=%t.ll
+
+; Blocks are numbered in layout order, after the highest id already assigned;
+; an already numbered block keeps its id.
+
+; CHECK-LABEL: define spir_kernel void @test
+; CHECK: entry:
+; CHECK: br i1 %c, label %then, label %exit, !igc.profile.id [[ID6:![0-9]+]]
+; CHECK: then:
+; CHECK: br label %exit, !igc.profile.id [[ID5:![0-9]+]]
+; CHECK: exit:
+; CHECK: ret void, !igc.profile.id [[ID7:![0-9]+]]
+; CHECK-DAG: [[ID5]] = !{i32 5}
+; CHECK-DAG: [[ID6]] = !{i32 6}
+; CHECK-DAG: [[ID7]] = !{i32 7}
+
+define spir_kernel void @test(i1 %c, float addrspace(1)* %p) {
+entry:
+  br i1 %c, label %then, label %exit
+
+then:
+  store float 1.000000e+00, float addrspace(1)* %p
+  br label %exit, !igc.profile.id !0
+
+exit:
+  ret void
+}
+
+!0 = !{i32 5}
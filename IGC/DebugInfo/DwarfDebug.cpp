@@ -540,18 +540,8 @@ void DwarfDebug::encodeRange(CompileUnit* TheCU, DIE* ScopeDIE, const llvm::Smal
         }
         else
         {
-            auto GetDebugRangeSize = [&]()
-            {
-                size_t TotalSize = 0;
-                for (auto& Entry : GenISADebugRangeSymbols)
-                {
-                    TotalSize += Entry.second.size();
-                }
-                return TotalSize;
-            };
-
             TheCU->addUInt(ScopeDIE, dwarf::DW_AT_ranges, dwarf::DW_FORM_sec_offset,
-                GetDebugRangeSize() * Asm->GetPointerSize());
+                GenISADebugRangeSize * Asm->GetPointerSize());
         }
 
         llvm::SmallVector<unsigned int, 8> Data;
@@ -566,6 +556,7 @@ void DwarfDebug::encodeRange(CompileUnit* TheCU, DIE* ScopeDIE, const llvm::Smal
         Data.push_back(0);
         Data.push_back(0);
 
+        GenISADebugRangeSize += Data.size();
         GenISADebugRangeSymbols.emplace_back(std::make_pair(NewLabel, Data));
     }
 }
@@ -309,6 +309,9 @@ namespace IGC
         // Store vector of MCSymbol->Raw .debug_ranges data.
         // MCSymbol* is nullptr when not using relocatable elf.
         std::vector<std::pair<llvm::MCSymbol*, llvm::SmallVector<unsigned int, 8>>> GenISADebugRangeSymbols;
+        // Total number of entries in GenISADebugRangeSymbols, i.e. the offset
+        // of the next range list in .debug_ranges in units of pointer size.
+        size_t GenISADebugRangeSize = 0;
 
         // Previous instruction's location information. This is used to determine
         // label location to indicate scope boundries in llvm::dwarf debug info.
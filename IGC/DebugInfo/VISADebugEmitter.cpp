@@ -34,6 +34,8 @@ See LICENSE.TXT for details.
 
 #include "CLElfLib/CLElfTypes.h"
 
+#include <algorithm>
+
 #define DEBUG_TYPE "GENX_DEBUG_INFO"
 
 using namespace llvm;
@@ -135,14 +137,23 @@ void DebugEmitter::processCurrentFunction(bool finalize, DbgDecoder* decodedDbg)
     }
     else
     {
-        for (auto item : m_pVISAModule->GenISAToVISAIndex)
+        // GenISAToVISAIndex is sorted by Gen offset, so skip straight to the
+        // current subroutine instead of rescanning the entries of all the
+        // previous ones.
+        const auto& AllGenISAToVISAIndex = m_pVISAModule->GenISAToVISAIndex;
+        auto firstIt = std::lower_bound(AllGenISAToVISAIndex.begin(), AllGenISAToVISAIndex.end(),
+            lastGenOff, [](const VISAModule::IDX_Gen2Visa& item, unsigned int off)
+            {
+                return item.GenOffset < off;
+            });
+        for (auto item : llvm::make_range(firstIt, AllGenISAToVISAIndex.end()))
         {
             if ((item.GenOffset >= lastGenOff) || ((item.GenOffset | lastGenOff) == 0))
             {
                 if (item.VisaOffset <= subEnd || item.VisaOffset == 0xffffffff)
                 {
                     GenISAToVISAIndex.push_back(item);
-                    auto size = m_pVISAModule->GenISAInstSizeBytes[item.GenOffset];
+                    auto size = m_pVISAModule->GenISAInstSizeBytes.lookup(item.GenOffset);
                     lastGenOff = item.GenOffset + size;
                     continue;
                 }
@@ -517,7 +517,7 @@ std::vector<std::pair<unsigned int, unsigned int>> VISAModule::getGenISARange(co
                 int lastEnd = -1;
                 for (const auto& genInst : it->second)
                 {
-                    unsigned int sizeGenInst = GenISAInstSizeBytes[genInst];
+                    unsigned int sizeGenInst = GenISAInstSizeBytes.lookup(genInst);
 
                     if (GenISARange.size() > 0)
                         lastEnd = GenISARange.back().second;
@@ -549,7 +549,7 @@ std::vector<std::pair<unsigned int, unsigned int>> VISAModule::getGenISARange(co
         {
             for (const auto& genInst : it->second)
             {
-                unsigned int sizeGenInst = GenISAInstSizeBytes[genInst];
+                unsigned int sizeGenInst = GenISAInstSizeBytes.lookup(genInst);
                 unassignedGenOffset[genInst] = sizeGenInst;
             }
         }
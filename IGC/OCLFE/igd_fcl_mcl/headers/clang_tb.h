@@ -173,6 +173,8 @@ namespace FCL {
   bool GetFCLShaderDumpPidDisable();
   bool GetFCLDumpToCurrentDir();
   bool GetFCLDumpToCustomDir();
+  // number of front end results kept by the in-process compile cache
+  unsigned int GetFCLCompileCacheSize();
 } // namespace FCL
 
 // convenient macro to check FCL flags
@@ -22,10 +22,12 @@ SPDX-License-Identifier: MIT
 #include "secure_string.h"
 #include "AdaptorCommon/customApi.hpp"
 
+#include <list>
 #include <sstream>
 #include <stdlib.h>
 #include <string>
 #include <iomanip>
+#include <unordered_map>
 
 #include "3d/common/iStdLib/File.h"
 #include "Probe/Assertion.h"
@@ -222,6 +224,19 @@ namespace FCL
         return FCLDumpToCustomDir;
     }
 
+    unsigned int GetFCLCompileCacheSize()
+    {
+        static const unsigned int cacheSize = []() {
+            unsigned int value = 64;
+            if (!FCLReadIGCRegistry("FCLCompileCacheSize", &value, sizeof(value)))
+            {
+                value = 64;
+            }
+            return value;
+        }();
+        return cacheSize;
+    }
+
     OutputFolderName  GetBaseIGCOutputFolder()
     {
 #if defined(IGC_DEBUG_VARIABLES)
@@ -527,6 +542,96 @@ namespace TC
                     pFEBinaryResult->GetIRSize());
             }
         }
+
+        // In-process cache of successful front end compilations.
+        //
+        // Runtime-generated kernels are often built many times with the same
+        // source and options, and most of each build is spent parsing the
+        // OpenCL headers. opencl-clang's Compile entry point cannot keep the
+        // parsed headers between calls, so the whole result is reused: the
+        // key is everything passed to Compile, and the IR and build log are
+        // replayed on a hit. Entries are evicted least recently used first;
+        // the FCLCompileCacheSize key sets the number of entries (0 disables
+        // the cache).
+        class CompileCache
+        {
+        public:
+            static CompileCache& get()
+            {
+                static CompileCache cache;
+                return cache;
+            }
+
+            bool enabled() const { return m_capacity > 0; }
+
+            bool lookup(const std::string& key, STB_TranslateOutputArgs* pOutputArgs, std::string& exceptString)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto it = m_entries.find(key);
+                if (it == m_entries.end())
+                {
+                    return false;
+                }
+                m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+
+                const Entry& entry = it->second;
+                if (!entry.log.empty())
+                {
+                    TC::CClangTranslationBlock::SetErrorString(entry.log.c_str(), pOutputArgs);
+                }
+                else
+                {
+                    pOutputArgs->pErrorString = NULL;
+                    pOutputArgs->ErrorStringSize = 0;
+                }
+                pOutputArgs->OutputSize = (uint32_t)entry.ir.size();
+                if (pOutputArgs->OutputSize > 0)
+                {
+                    pOutputArgs->pOutput = (char*)malloc(entry.ir.size());
+                    if (!pOutputArgs->pOutput)
+                    {
+                        exceptString = "bad_alloc";
+                        return true;
+                    }
+                    memcpy_s(pOutputArgs->pOutput, entry.ir.size(), entry.ir.data(), entry.ir.size());
+                }
+                return true;
+            }
+
+            void insert(const std::string& key, IOCLFEBinaryResult* pResult)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_entries.count(key))
+                {
+                    return;
+                }
+                while (m_entries.size() >= m_capacity)
+                {
+                    m_entries.erase(m_lru.back());
+                    m_lru.pop_back();
+                }
+                m_lru.push_front(key);
+                Entry& entry = m_entries[key];
+                entry.ir.assign((const char*)pResult->GetIR(), pResult->GetIRSize());
+                entry.log = pResult->GetErrorLog() ? pResult->GetErrorLog() : "";
+                entry.lruPos = m_lru.begin();
+            }
+
+        private:
+            CompileCache() : m_capacity(FCL::GetFCLCompileCacheSize()) {}
+
+            struct Entry
+            {
+                std::string ir;
+                std::string log;
+                std::list<std::string>::iterator lruPos;
+            };
+
+            const size_t m_capacity;
+            std::mutex m_mutex;
+            std::list<std::string> m_lru;
+            std::unordered_map<std::string, Entry> m_entries;
+        };
     }//namespace Utils
 
 
@@ -1498,27 +1603,67 @@ namespace TC
             optionsEx += " -U__IMAGE_SUPPORT__";
         }
 
+        Utils::CompileCache& cache = Utils::CompileCache::get();
+        std::string cacheKey;
+        if (cache.enabled())
+        {
+            // Fields are length-prefixed so that they cannot run into each
+            // other. The CT header is a fixed resource, so its name is enough.
+            auto addToKey = [&cacheKey](const char* data, size_t size) {
+                cacheKey += std::to_string(size);
+                cacheKey += ':';
+                cacheKey.append(data, size);
+            };
+            const char* source = pInputArgs->pszProgramSource ? pInputArgs->pszProgramSource : "";
+            addToKey(source, strlen(source));
+            for (size_t i = 0; i < pInputArgs->inputHeaders.size(); i++)
+            {
+                const char* name = pInputArgs->inputHeadersNames[i];
+                const char* header = pInputArgs->inputHeaders[i];
+                addToKey(name, strlen(name));
+                if (header == m_cthBuffer)
+                    addToKey("", 0);
+                else
+                    addToKey(header, strlen(header));
+            }
+            addToKey(options.data(), options.size());
+            addToKey(optionsEx.data(), optionsEx.size());
+            addToKey(pInputArgs->oclVersion.data(), pInputArgs->oclVersion.size());
+        }
+
         IOCLFEBinaryResult *pResultPtr = NULL;
+        int res = 0;
+        if (!cache.enabled() || !cache.lookup(cacheKey, pOutputArgs, exceptString))
+        {
 #ifdef _WIN32
-        int res = m_CCModule.pCompile(
+            res = m_CCModule.pCompile(
 #else
-        int res = Compile(
+            res = Compile(
 #endif
-            pInputArgs->pszProgramSource,
-            (const char**)pInputArgs->inputHeaders.data(),
-            (unsigned int)pInputArgs->inputHeaders.size(),
-            (const char**)pInputArgs->inputHeadersNames.data(),
-            NULL,
-            0,
-            options.c_str(),
-            optionsEx.c_str(),
-            pInputArgs->oclVersion.c_str(),
-            &pResultPtr);
+                pInputArgs->pszProgramSource,
+                (const char**)pInputArgs->inputHeaders.data(),
+                (unsigned int)pInputArgs->inputHeaders.size(),
+                (const char**)pInputArgs->inputHeadersNames.data(),
+                NULL,
+                0,
+                options.c_str(),
+                optionsEx.c_str(),
+                pInputArgs->oclVersion.c_str(),
+                &pResultPtr);
+            if (0 == res && cache.enabled())
+            {
+                cache.insert(cacheKey, pResultPtr);
+            }
+            Utils::FillOutputArgs(pResultPtr, pOutputArgs, exceptString);
+        }
         if (0 != BuildOptionsAreValid(options, exceptString)) res = -43;
 
-        Utils::FillOutputArgs(pResultPtr, pOutputArgs, exceptString);
         if (!exceptString.empty()) // str != "" => there was an exception. skip further code and return.
         {
+            if (pResultPtr)
+            {
+                pResultPtr->Release();
+            }
             return false;
         }
 
@@ -1547,7 +1692,10 @@ namespace TC
             }
         }
 
-        pResultPtr->Release();
+        if (pResultPtr)
+        {
+            pResultPtr->Release();
+        }
 
         return (0 == res);
     }
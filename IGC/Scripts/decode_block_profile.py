@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+#
+#========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+#=========================== end_copyright_notice =============================
+
+"""Decode the __igc_block_profile buffer of an instrumented shader.
+
+A shader compiled with the ShaderProfileInstrumentation regkey counts block
+executions into the __igc_block_profile program scope global, an array of
+32-bit little-endian counters, and IGC writes where each block's counters
+live to <asm hash>.proflayout in the shader dump folder. After running the
+workload, copy the buffer contents to a file (e.g. with
+clGetDeviceGlobalVariablePointerINTEL or zeModuleGetGlobalPointer) and run
+
+    decode_block_profile.py <asm hash>.proflayout <buffer file> -o <asm hash>.prof
+
+to get a profile that ShaderProfileDir picks up. Counts are per work item.
+Partial-lane executions are not measured, so divergent counts are 0.
+"""
+
+import argparse
+import struct
+import sys
+
+
+def read_layout(path):
+    blocks = []
+    with open(path) as layout:
+        for line in layout:
+            line = line.strip()
+            if not line or line.startswith('#'):
+                continue
+            func, block, exec_slot, taken_slot = line.split()
+            blocks.append((func, block, int(exec_slot), int(taken_slot)))
+    return blocks
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('layout', help='<asm hash>.proflayout written by IGC')
+    parser.add_argument('buffer', help='raw contents of __igc_block_profile')
+    parser.add_argument('-o', '--output', help='profile to write (default: stdout)')
+    parser.add_argument('--merge', action='append', default=[],
+                        help='buffer of another run of the same shader to add in')
+    args = parser.parse_args()
+
+    blocks = read_layout(args.layout)
+    num_slots = 1 + max([max(b[2], b[3]) for b in blocks], default=-1)
+    counters = [0] * num_slots
+    for path in [args.buffer] + args.merge:
+        with open(path, 'rb') as buffer:
+            data = buffer.read()
+        if len(data) < 4 * num_slots:
+            sys.exit('%s: expected %d counters, got %d' % (path, num_slots, len(data) // 4))
+        for i, value in enumerate(struct.unpack_from('<%dI' % num_slots, data)):
+            counters[i] += value
+
+    output = open(args.output, 'w') if args.output else sys.stdout
+    output.write('# <function name> <block> <execution count> <divergent count> [<taken ratio>]\n')
+    for func, block, exec_slot, taken_slot in blocks:
+        count = counters[exec_slot]
+        line = '%s %s %d 0' % (func, block, count)
+        if taken_slot >= 0 and count > 0:
+            line += ' %.6f' % min(1.0, counters[taken_slot] / count)
+        output.write(line + '\n')
+    if output is not sys.stdout:
+        output.close()
+
+
+if __name__ == '__main__':
+    main()
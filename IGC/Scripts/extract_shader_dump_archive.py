@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#
+#========================== begin_copyright_notice ============================
+#
+# Copyright (C) 2021 Intel Corporation
+#
+# SPDX-License-Identifier: MIT
+#
+#=========================== end_copyright_notice =============================
+
+"""Unpack the shader_dump.igcarchive written with the ShaderDumpArchive regkey.
+
+    extract_shader_dump_archive.py shader_dump.igcarchive -o <folder>
+
+recreates the files IGC would have dumped in <folder>, or lists them with
+--list. Paths that were outside the dump folder are stored absolute and are
+extracted under <folder> as well.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b'IGCDUMP1'
+RECORD_HEADER = struct.Struct('<IIQQ')
+FLAG_APPEND = 1 << 0
+FLAG_COMPRESSED = 1 << 1
+
+
+def read_records(path):
+    with open(path, 'rb') as archive:
+        if archive.read(len(MAGIC)) != MAGIC:
+            sys.exit('%s: not a shader dump archive' % path)
+        while True:
+            header = archive.read(RECORD_HEADER.size)
+            if not header:
+                return
+            if len(header) < RECORD_HEADER.size:
+                sys.exit('%s: truncated record' % path)
+            path_size, flags, size, stored_size = RECORD_HEADER.unpack(header)
+            name = archive.read(path_size).decode('utf-8', 'replace')
+            data = archive.read(stored_size)
+            if len(data) < stored_size:
+                sys.exit('%s: truncated record for %s' % (path, name))
+            if flags & FLAG_COMPRESSED:
+                data = zlib.decompress(data)
+            if len(data) != size:
+                sys.exit('%s: bad size for %s' % (path, name))
+            yield name, flags, data
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('archive')
+    parser.add_argument('-o', '--output', default='.', help='folder to extract to')
+    parser.add_argument('--list', action='store_true', help='only list the files')
+    args = parser.parse_args()
+
+    for name, flags, data in read_records(args.archive):
+        if args.list:
+            print('%10d %s%s' % (len(data), name, ' (append)' if flags & FLAG_APPEND else ''))
+            continue
+        out_path = os.path.join(args.output, name.lstrip('/\\').replace(':', ''))
+        folder = os.path.dirname(out_path)
+        if folder:
+            os.makedirs(folder, exist_ok=True)
+        with open(out_path, 'ab' if flags & FLAG_APPEND else 'wb') as out:
+            out.write(data)
+
+
+if __name__ == '__main__':
+    main()
@@ -418,7 +418,12 @@ std::error_code vc::translateBuild(const TC::STB_TranslateInputArgs *InputArgs,
 
   llvm::ArrayRef<char> Input{InputArgs->pInput, InputArgs->InputSize};
 
-  const ShaderHash Hash = getShaderHash(Input);
+  // The hash only names dumps and overrides, so do not hash the input when
+  // neither is requested.
+  ShaderHash Hash;
+  if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable) ||
+      IGC_IS_FLAG_ENABLED(ShaderOverride))
+    Hash = getShaderHash(Input);
   std::unique_ptr<vc::ShaderDumper> Dumper;
   if (IGC_IS_FLAG_ENABLED(ShaderDumpEnable)) {
     Dumper = vc::createVC_IGCFileDumper(Hash);
@@ -110,11 +110,15 @@ getModuleFromLLVMBinary(ArrayRef<char> Input, LLVMContext& C) {
 static Expected<std::unique_ptr<llvm::Module>>
 getModuleFromSPIRV(ArrayRef<char> Input, ArrayRef<uint32_t> SpecConstIds,
                    ArrayRef<uint64_t> SpecConstValues, LLVMContext &Ctx) {
+#ifdef IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
+  return vc::translateSPIRVToModule(Input, SpecConstIds, SpecConstValues, Ctx);
+#else
   auto ExpIR = vc::translateSPIRVToIR(Input, SpecConstIds, SpecConstValues);
   if (!ExpIR)
     return ExpIR.takeError();
 
   return getModuleFromLLVMBinary(ExpIR.get(), Ctx);
+#endif // IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
 }
 
 static Expected<std::unique_ptr<llvm::Module>>
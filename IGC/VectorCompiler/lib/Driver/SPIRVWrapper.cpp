@@ -53,6 +53,49 @@ using SpirvReadVerifyType = int(
 
 #ifdef IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
 
+// Reads SPIR-V into a module owned by Context. Returns null and sets ErrMsg
+// on failure.
+std::unique_ptr<llvm::Module>
+readSpirvModule(llvm::LLVMContext &Context, const char *pIn, size_t InSz,
+                const uint32_t *SpecConstIds, const uint64_t *SpecConstVals,
+                unsigned SpecConstSz, std::string &ErrMsg) {
+  llvm::StringRef SpirvInput = llvm::StringRef(pIn, InSz);
+  std::istringstream IS(SpirvInput.str());
+  llvm::Module *SpirM;
+  std::string ReadErrMsg;
+#if LLVM_VERSION_MAJOR > 7
+  SPIRV::TranslatorOpts Opts;
+  Opts.enableAllExtensions();
+  Opts.setFPContractMode(SPIRV::FPContractMode::On);
+  Opts.setDesiredBIsRepresentation(SPIRV::BIsRepresentation::SPIRVFriendlyIR);
+  // Add specialization constants
+  for (unsigned i = 0; i < SpecConstSz; ++i)
+    Opts.setSpecConst(SpecConstIds[i], SpecConstVals[i]);
+
+  // This returns true on success...
+  bool Status = llvm::readSpirv(Context, Opts, IS, SpirM, ReadErrMsg);
+#else
+  if (SpecConstSz != 0) {
+    ErrMsg = "spirv_read_verify: Specialization constants are not supported "
+             "in this translator version (700) ";
+    return nullptr;
+  }
+  // This returns true on success...
+  bool Status = llvm::readSpirv(Context, IS, SpirM, ReadErrMsg);
+#endif
+  if (!Status) {
+    ErrMsg = "spirv_read_verify: readSpirv failed: " + ReadErrMsg;
+    return nullptr;
+  }
+  std::unique_ptr<llvm::Module> M{SpirM};
+  Status = llvm::verifyModule(*M);
+  if (Status) {
+    ErrMsg = "spirv_read_verify: verify Module failed";
+    return nullptr;
+  }
+  return M;
+}
+
 int spirvReadVerify(const char *pIn, size_t InSz, const uint32_t *SpecConstIds,
                     const uint64_t *SpecConstVals, unsigned SpecConstSz,
                     void (*OutSaver)(const char *pOut, size_t OutSize,
@@ -61,47 +104,12 @@ int spirvReadVerify(const char *pIn, size_t InSz, const uint32_t *SpecConstIds,
                     void (*ErrSaver)(const char *pErrMsg, void *ErrUserData),
                     void *ErrUserData) {
   llvm::LLVMContext Context;
-  llvm::StringRef SpirvInput = llvm::StringRef(pIn, InSz);
-  std::istringstream IS(SpirvInput.str());
-  std::unique_ptr<llvm::Module> M;
-  {
-    llvm::Module *SpirM;
-    std::string ErrMsg;
-#if LLVM_VERSION_MAJOR > 7
-    SPIRV::TranslatorOpts Opts;
-    Opts.enableAllExtensions();
-    Opts.setFPContractMode(SPIRV::FPContractMode::On);
-    Opts.setDesiredBIsRepresentation(SPIRV::BIsRepresentation::SPIRVFriendlyIR);
-    // Add specialization constants
-    for (unsigned i = 0; i < SpecConstSz; ++i)
-      Opts.setSpecConst(SpecConstIds[i], SpecConstVals[i]);
-
-    // This returns true on success...
-    bool Status = llvm::readSpirv(Context, Opts, IS, SpirM, ErrMsg);
-#else
-    if (SpecConstSz != 0) {
-      std::ostringstream OSS;
-      OSS << "spirv_read_verify: Specialization constants are not supported in "
-             "this translator version (700) "
-          << ErrMsg;
-      ErrSaver(OSS.str().c_str(), ErrUserData);
-      return -1;
-    }
-    // This returns true on success...
-    bool Status = llvm::readSpirv(Context, IS, SpirM, ErrMsg);
-#endif
-    if (!Status) {
-      std::ostringstream OSS;
-      OSS << "spirv_read_verify: readSpirv failed: " << ErrMsg;
-      ErrSaver(OSS.str().c_str(), ErrUserData);
-      return -1;
-    }
-    Status = llvm::verifyModule(*SpirM);
-    if (Status) {
-      ErrSaver("spirv_read_verify: verify Module failed", ErrUserData);
-      return -1;
-    }
-    M.reset(SpirM);
+  std::string ErrMsg;
+  std::unique_ptr<llvm::Module> M = readSpirvModule(
+      Context, pIn, InSz, SpecConstIds, SpecConstVals, SpecConstSz, ErrMsg);
+  if (!M) {
+    ErrSaver(ErrMsg.c_str(), ErrUserData);
+    return -1;
   }
 
   llvm::SmallVector<char, 16> CloneBuffer;
@@ -205,3 +213,20 @@ vc::translateSPIRVToIR(ArrayRef<char> Input, ArrayRef<uint32_t> SpecConstIds,
     return make_error<vc::BadSpirvError>(ErrMsg);
   return {std::move(Result)};
 }
+
+#ifdef IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
+Expected<std::unique_ptr<Module>>
+vc::translateSPIRVToModule(ArrayRef<char> Input,
+                           ArrayRef<uint32_t> SpecConstIds,
+                           ArrayRef<uint64_t> SpecConstValues,
+                           LLVMContext &Ctx) {
+  IGC_ASSERT(SpecConstIds.size() == SpecConstValues.size());
+  std::string ErrMsg;
+  std::unique_ptr<Module> M =
+      readSpirvModule(Ctx, Input.data(), Input.size(), SpecConstIds.data(),
+                      SpecConstValues.data(), SpecConstValues.size(), ErrMsg);
+  if (!M)
+    return make_error<vc::BadSpirvError>(ErrMsg);
+  return {std::move(M)};
+}
+#endif // IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
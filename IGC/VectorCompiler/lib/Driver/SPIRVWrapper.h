@@ -20,6 +20,8 @@ SPDX-License-Identifier: MIT
 #define SPIRV_WRAPPER_H
 
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
 #include "llvm/Support/Error.h"
 
 namespace vc {
@@ -27,6 +29,16 @@ llvm::Expected<std::vector<char>>
 translateSPIRVToIR(llvm::ArrayRef<char> Input,
                    llvm::ArrayRef<uint32_t> SpecConstIds,
                    llvm::ArrayRef<uint64_t> SpecConstValues);
+
+#ifdef IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
+// The translator is linked in, so SPIR-V can be read straight into the
+// context used for codegen instead of going through serialized bitcode.
+llvm::Expected<std::unique_ptr<llvm::Module>>
+translateSPIRVToModule(llvm::ArrayRef<char> Input,
+                       llvm::ArrayRef<uint32_t> SpecConstIds,
+                       llvm::ArrayRef<uint64_t> SpecConstValues,
+                       llvm::LLVMContext &Ctx);
+#endif // IGC_VECTOR_USE_KHRONOS_SPIRV_TRANSLATOR
 }
 
 #endif // SPIRV_WRAPPER_H
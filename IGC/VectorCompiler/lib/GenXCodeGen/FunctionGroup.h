@@ -27,6 +27,7 @@ SPDX-License-Identifier: MIT
 #ifndef FUNCTIONGROUP_H
 #define FUNCTIONGROUP_H
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/ValueHandle.h"
@@ -112,7 +113,8 @@ private:
   SmallVector<FunctionGroup *, 8> NonMainGroups;
 
   class FGMap {
-    using ElementType = std::map<const Function *, FunctionGroup *>;
+    // getGroup() is queried by every FunctionGroupPass for every function
+    using ElementType = DenseMap<const Function *, FunctionGroup *>;
     std::array<ElementType, static_cast<size_t>(FGType::MAX)> data = {};
   public:
     ElementType &operator[](FGType type) {
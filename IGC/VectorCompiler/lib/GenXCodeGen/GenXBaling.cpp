@@ -21,6 +21,7 @@ SPDX-License-Identifier: MIT
 #include "GenXUtil.h"
 #include "Probe/Assertion.h"
 #include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/CFG.h"
 #include "llvm/Analysis/InstructionSimplify.h"
 #include "llvm/Analysis/ValueTracking.h"
@@ -68,6 +69,11 @@ static cl::opt<bool>
 DisableMemOrderCheck("dbgonly-disable-mem-order-check", cl::init(false),
                      cl::Hidden, cl::desc("Disable checking of memory ordering"));
 
+// Region reads and writes left as bale heads on their own are emitted as
+// separate region moves; these count them for the final (codegen) baling.
+STATISTIC(NumRdRegionMoves, "Number of rdregions emitted as separate moves");
+STATISTIC(NumWrRegionMoves, "Number of wrregions emitted as separate moves");
+
 //----------------------------------------------------------------------
 // Administrivia for GenXFuncBaling pass
 //
@@ -179,9 +185,28 @@ bool GenXBaling::processFunction(Function *F)
     doClones();
     Changed = true;
   }
+  if (AreStatisticsEnabled() && Kind == BalingKind::BK_CodeGen)
+    countRegionMoves(*F);
   return Changed;
 }
 
+/***********************************************************************
+ * countRegionMoves : count the region accesses that did not bale into or
+ *    out of a main instruction, so each becomes a move of its own
+ */
+void GenXBaling::countRegionMoves(Function &F) {
+  for (Instruction &Inst : instructions(F)) {
+    if (GenXIntrinsic::isRdRegion(&Inst)) {
+      if (!isBaled(&Inst))
+        ++NumRdRegionMoves;
+    } else if (GenXIntrinsic::isWrRegion(&Inst)) {
+      if (!getBaleInfo(&Inst).isOperandBaled(
+              GenXIntrinsic::GenXRegion::NewValueOperandNum))
+        ++NumWrRegionMoves;
+    }
+  }
+}
+
 /***********************************************************************
  * processInst : calculate baling for an instruction
  *
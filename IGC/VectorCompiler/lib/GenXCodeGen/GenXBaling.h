@@ -467,6 +467,7 @@ private:
   void processTwoAddrSend(CallInst *CI);
   void setOperandBaled(Instruction *Inst, unsigned OperandNum, genx::BaleInfo *BI);
   void doClones();
+  void countRegionMoves(Function &F);
   Instruction *getOrUnbaleExtend(Instruction *Inst, genx::BaleInfo *BI,
                                  unsigned OperandNum, bool Unbale);
   int getAddrOperandNum(unsigned IID) const;
@@ -66,8 +66,10 @@ SPDX-License-Identifier: MIT
 #include "llvmWrapper/IR/DerivedTypes.h"
 
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 using namespace llvm;
@@ -572,6 +574,12 @@ class GenXKernelBuilder {
   std::map<Value *, Register *> LastUsedAliasMap;
   unsigned CurrentPadding = 0;
 
+  // vISA immediate operands are never modified once created (the underlying
+  // G4_Imm is already shared), so one operand per kernel, value and type is
+  // enough for all constant sources.
+  using ImmKey = std::tuple<VISAKernel *, uint64_t, VISA_Type>;
+  std::map<ImmKey, VISA_VectorOpnd *> ImmOperands;
+
 public:
   FunctionGroup *FG = nullptr;
   GenXLiveness *Liveness = nullptr;
@@ -724,6 +732,8 @@ private:
                                                 const DstOpndDesc &DstDesc);
 
   VISA_VectorOpnd *createImmediateOperand(Constant *V, genx::Signedness Signed);
+  template <typename T>
+  VISA_VectorOpnd *getOrCreateImmediate(T Val, VISA_Type ImmTy);
 
   VISA_PredVar *createPredicateDeclFromSelect(Instruction *SI,
                                               genx::BaleInfo BI,
@@ -1877,9 +1887,7 @@ VISA_VectorOpnd *GenXKernelBuilder::createImmediateOperand(Constant *V,
         auto ImmTy =
             static_cast<uint8_t>(Signed == UNSIGNED ? ISA_TYPE_UV : ISA_TYPE_V);
         auto VISAImmTy = getVISAImmTy(ImmTy);
-        VISA_VectorOpnd *ImmOp = nullptr;
-        CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Packed, VISAImmTy));
-        return ImmOp;
+        return getOrCreateImmediate(Packed, VISAImmTy);
       }
       // Packed float vector.
       IGC_ASSERT(VT->getElementType()->isFloatTy());
@@ -1894,9 +1902,7 @@ VISA_VectorOpnd *GenXKernelBuilder::createImmediateOperand(Constant *V,
         Packed |= get8bitPackedFloat(FP.convertToFloat()) << (i * 8);
       }
       auto VISAImmTy = getVISAImmTy(ISA_TYPE_VF);
-      VISA_VectorOpnd *ImmOp = nullptr;
-      CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Packed, VISAImmTy));
-      return ImmOp;
+      return getOrCreateImmediate(Packed, VISAImmTy);
     }
     // Splatted (or single element) vector. Use the scalar value.
     T = VT->getElementType();
@@ -1918,15 +1924,11 @@ VISA_VectorOpnd *GenXKernelBuilder::createImmediateOperand(Constant *V,
     // getSExtValue to avoid an assertion failure on very large 64 bit values...
     int64_t Val = Signed == UNSIGNED ? CI->getZExtValue() : CI->getSExtValue();
     visa::TypeDetails TD(Func->getParent()->getDataLayout(), IT, Signed);
-    VISA_VectorOpnd *ImmOp = nullptr;
-    CISA_CALL(
-        Kernel->CreateVISAImmediate(ImmOp, &Val, getVISAImmTy(TD.VisaType)));
-    return ImmOp;
+    return getOrCreateImmediate(Val, getVISAImmTy(TD.VisaType));
   } if (isa<Function>(V)) {
     IGC_ASSERT_MESSAGE(0, "Not baled function address");
     return nullptr;
   } else {
-    VISA_VectorOpnd *ImmOp = nullptr;
     ConstantFP *CF = cast<ConstantFP>(V);
     if (T->isFloatTy()) {
       union {
@@ -1934,26 +1936,33 @@ VISA_VectorOpnd *GenXKernelBuilder::createImmediateOperand(Constant *V,
         uint32_t i;
       } Val;
       Val.f = CF->getValueAPF().convertToFloat();
-      auto VISAImmTy = getVISAImmTy(ISA_TYPE_F);
-      CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Val.i, VISAImmTy));
+      return getOrCreateImmediate(Val.i, getVISAImmTy(ISA_TYPE_F));
     } else if (T->isHalfTy()) {
       uint16_t Val(
           (uint16_t)(CF->getValueAPF().bitcastToAPInt().getZExtValue()));
-      auto VISAImmTy = getVISAImmTy(ISA_TYPE_HF);
       auto Val32 = static_cast<uint32_t>(Val);
-      CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Val32, VISAImmTy));
-    } else {
-      IGC_ASSERT(T->isDoubleTy());
-      union {
-        double f;
-        uint64_t i;
-      } Val;
-      Val.f = CF->getValueAPF().convertToDouble();
-      auto VISAImmTy = getVISAImmTy(ISA_TYPE_DF);
-      CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Val.i, VISAImmTy));
+      return getOrCreateImmediate(Val32, getVISAImmTy(ISA_TYPE_HF));
     }
-    return ImmOp;
-  }
+    IGC_ASSERT(T->isDoubleTy());
+    union {
+      double f;
+      uint64_t i;
+    } Val;
+    Val.f = CF->getValueAPF().convertToDouble();
+    return getOrCreateImmediate(Val.i, getVISAImmTy(ISA_TYPE_DF));
+  }
+}
+
+template <typename T>
+VISA_VectorOpnd *GenXKernelBuilder::getOrCreateImmediate(T Val,
+                                                         VISA_Type ImmTy) {
+  static_assert(sizeof(T) <= sizeof(uint64_t), "unexpected immediate size");
+  uint64_t Bits = 0;
+  std::memcpy(&Bits, &Val, sizeof(T));
+  VISA_VectorOpnd *&ImmOp = ImmOperands[ImmKey{Kernel, Bits, ImmTy}];
+  if (!ImmOp)
+    CISA_CALL(Kernel->CreateVISAImmediate(ImmOp, &Val, ImmTy));
+  return ImmOp;
 }
 
 /***********************************************************************
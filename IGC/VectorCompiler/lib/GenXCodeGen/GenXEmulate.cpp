@@ -1874,7 +1874,10 @@ private:
     if (!EmulationBiFBuffer.getBufferSize())
       return nullptr;
 
-    auto BiFModule = vc::getBiFModuleOrReportError(EmulationBiFBuffer, Ctx);
+    // Load lazily: routines erased before linking (see Purge32BitFunctions)
+    // never have their bodies parsed.
+    auto BiFModule =
+        vc::getLazyBiFModuleOrReportError(EmulationBiFBuffer, Ctx);
 
     BiFModule->setDataLayout(DL);
     BiFModule->setTargetTriple(Triple);
@@ -160,6 +160,7 @@ SPDX-License-Identifier: MIT
 #include "GenXUtil.h"
 #include "llvm/ADT/PostOrderIterator.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Analysis/CFG.h"
 #include "llvm/Analysis/ConstantFolding.h"
 #include "llvm/Analysis/ScalarEvolution.h"
@@ -184,6 +185,11 @@ SPDX-License-Identifier: MIT
 using namespace llvm;
 using namespace genx;
 
+STATISTIC(NumSplitBales, "Number of bales split to legal widths");
+STATISTIC(NumSplitPieces, "Number of pieces created by splitting bales");
+STATISTIC(NumUnevenSplits,
+          "Number of split bales whose pieces do not all have the same width");
+
 namespace {
 
 // Information on a part of a predicate.
@@ -781,6 +787,9 @@ bool GenXLegalization::processBale(Instruction *InsertBefore) {
     Joined = UndefValue::get(B.getHeadIgnoreGStore()->Inst->getType());
 
   // Do the splits.
+  unsigned NumPieces = 0;
+  unsigned FirstWidth = 0;
+  bool Uneven = false;
   for (unsigned StartIdx = 0; StartIdx != WholeWidth;) {
     // Determine the width of the next split.
     unsigned Width = determineWidth(WholeWidth, StartIdx);
@@ -804,6 +813,16 @@ bool GenXLegalization::processBale(Instruction *InsertBefore) {
     // Create the next split.
     Joined = splitBale(Joined, StartIdx, Width, InsertBefore);
     StartIdx += Width;
+    if (!NumPieces++)
+      FirstWidth = Width;
+    else if (Width != FirstWidth)
+      Uneven = true;
+  }
+  if (NumPieces > 1) {
+    ++NumSplitBales;
+    NumSplitPieces += NumPieces;
+    if (Uneven)
+      ++NumUnevenSplits;
   }
   if (!B.endsWithGStore())
     B.getHead()->Inst->replaceAllUsesWith(Joined);
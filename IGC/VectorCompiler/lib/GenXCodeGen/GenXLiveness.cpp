@@ -974,6 +974,18 @@ bool GenXLiveness::getSingleInterferenceSites(LiveRange *LR1, LiveRange *LR2,
   if (LR1->size() < LR2->size())
     std::swap(LR1, LR2);
   auto Idx2 = LR2->begin(), End2 = LR2->end();
+  // Quick reject when the overall extents of the two live ranges are
+  // disjoint, which is the common case for pairwise coalescing queries.
+  if (std::prev(End2)->getEnd() <= LR1->begin()->getStart())
+    return false;
+  // Skip the segments in [I, E) that end before Pos. They cannot overlap
+  // the segment starting at Pos, and the merge below would only step over
+  // them one by one.
+  auto skipTo = [](Segment *I, Segment *E, unsigned Pos) {
+    return std::lower_bound(I, E, Pos, [](const Segment &S, unsigned P) {
+      return S.getEnd() < P;
+    });
+  };
   // Find segment in LR1 that contains or is the next after the start
   // of the first segment in LR2, including the case that the start of
   // the LR2 segment abuts the end of the LR1 segment.
@@ -1003,10 +1015,12 @@ bool GenXLiveness::getSingleInterferenceSites(LiveRange *LR1, LiveRange *LR2,
     }
     // Advance whichever one has the lowest End.
     if (Idx1->getEnd() < Idx2->getEnd()) {
-      if (++Idx1 == End1)
+      Idx1 = skipTo(Idx1 + 1, End1, Idx2->getStart());
+      if (Idx1 == End1)
         return false;
     } else {
-      if (++Idx2 == End2)
+      Idx2 = skipTo(Idx2 + 1, End2, Idx1->getStart());
+      if (Idx2 == End2)
         return false;
     }
   }
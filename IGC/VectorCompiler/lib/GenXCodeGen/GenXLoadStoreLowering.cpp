@@ -40,6 +40,7 @@ SPDX-License-Identifier: MIT
 #include "llvmWrapper/Support/Alignment.h"
 
 #include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Statistic.h>
 #include <llvm/Analysis/CallGraph.h>
 #include <llvm/Analysis/CallGraphSCCPass.h>
 #include <llvm/CodeGen/TargetPassConfig.h>
@@ -63,6 +64,13 @@ SPDX-License-Identifier: MIT
 using namespace llvm;
 using namespace genx;
 
+// Every lowered access is stateless today, so these show how much address
+// payload would be saved by moving buffer accesses to 32-bit offsets.
+STATISTIC(NumSVMGathers, "Number of loads lowered to svm gathers");
+STATISTIC(NumSVMScatters, "Number of stores lowered to svm scatters");
+STATISTIC(NumA64AddrBytes, "Bytes of 64-bit address payload in lowered "
+                           "svm gathers and scatters");
+
 static cl::opt<bool> EnableLL("enable-ldst-lowering", cl::init(false),
                               cl::Hidden,
                               cl::desc("Enable Load-Store lowering pass"));
@@ -457,6 +465,8 @@ Instruction *GenXLoadStoreLowering::createLoad(LoadInst &LdI,
       {NormalizedOldVal.getType(), Pred->getType(), Offset->getType()});
   CallInst *Gather = IntrinsicInst::Create(
       F, {Pred, logNumBlocks, Offset, &NormalizedOldVal}, LdI.getName());
+  ++NumSVMGathers;
+  NumA64AddrBytes += NumEltsToLoad * genx::QWordBytes;
 
   LLVM_DEBUG(dbgs() << "Created: " << *Gather << "\n");
   return Gather;
@@ -560,6 +570,8 @@ Instruction *GenXLoadStoreLowering::createStore(StoreInst &StI,
   Value *logNumBlocks = Builder.getInt32(0);
   auto *Scatter = IntrinsicInst::Create(
       F, {Pred, logNumBlocks, Offset, &NormalizedOldVal}, StI.getName());
+  ++NumSVMScatters;
+  NumA64AddrBytes += ValueNumElts * genx::QWordBytes;
   return Scatter;
 }
 
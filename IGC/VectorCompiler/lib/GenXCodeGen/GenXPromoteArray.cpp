@@ -44,6 +44,7 @@ SPDX-License-Identifier: MIT
 
 #include <algorithm>
 #include <queue>
+#include <unordered_map>
 #include <vector>
 
 using namespace llvm;
@@ -59,6 +60,13 @@ static cl::opt<std::size_t>
                         cl::desc("max total size of promoted allocas in bytes"),
                         cl::init(256 * defaultGRFWidth), cl::Hidden);
 
+static cl::opt<unsigned> GRFBudgetPercentOpt(
+    "vc-promote-array-grf-budget-percent",
+    cl::desc("percentage of the GRF file that promoted allocas and the "
+             "estimated peak of other live values may use together; 0 to "
+             "only apply vc-promote-array-total-alloca-limit"),
+    cl::init(90), cl::Hidden);
+
 namespace {
 
 // The class preserves index into a vector and the size of an element
@@ -180,6 +188,7 @@ private:
   LLVMContext *m_ctx = nullptr;
   std::vector<llvm::AllocaInst *> m_allocasToPrivMem;
   llvm::Function *m_pFunc = nullptr;
+  std::size_t TotalAllocaLimit = 0;
   bool ForcePromotion = false;
   bool LargeAllocasWereLeft = false;
 };
@@ -317,14 +326,81 @@ static void WarnLargeAllocas(Function &F) {
   F.getContext().diagnose(Warn);
 }
 
+// Peak number of bytes of SSA values live at once in F. Liveness is only
+// tracked within each block: values used in another block are considered
+// live from their definition to the end of their block.
+static std::size_t estimatePeakLiveBytes(Function &F, const DataLayout &DL) {
+  auto getBytes = [&DL](const Value &V) -> std::size_t {
+    Type *Ty = V.getType();
+    // predicates live in flag registers
+    if (!Ty->isSized() || Ty->getScalarType()->isIntegerTy(1))
+      return 0;
+    return DL.getTypeAllocSize(Ty);
+  };
+
+  std::size_t Peak = 0;
+  for (BasicBlock &BB : F) {
+    std::size_t Live = 0;
+    if (&BB == &F.getEntryBlock())
+      for (Argument &Arg : F.args())
+        Live += getBytes(Arg);
+    std::unordered_map<const Instruction *, unsigned> LastUse;
+    unsigned Pos = 0;
+    for (Instruction &I : BB) {
+      for (Value *Op : I.operands())
+        if (auto *OpI = dyn_cast<Instruction>(Op))
+          if (OpI->getParent() == &BB && !isa<PHINode>(&I))
+            LastUse[OpI] = Pos;
+      ++Pos;
+    }
+
+    std::vector<std::size_t> Dead(Pos + 1, 0);
+    Pos = 0;
+    for (Instruction &I : BB) {
+      Live -= Dead[Pos];
+      std::size_t Bytes = getBytes(I);
+      if (Bytes) {
+        bool UsedElsewhere = llvm::any_of(I.users(), [&BB](const User *U) {
+          auto *UI = dyn_cast<Instruction>(U);
+          return !UI || UI->getParent() != &BB || isa<PHINode>(UI);
+        });
+        auto It = LastUse.find(&I);
+        if (UsedElsewhere || It != LastUse.end()) {
+          Live += Bytes;
+          if (!UsedElsewhere)
+            Dead[It->second] += Bytes;
+        }
+      }
+      Peak = std::max(Peak, Live);
+      ++Pos;
+    }
+  }
+  return Peak;
+}
+
 bool TransformPrivMem::runOnFunction(llvm::Function &F) {
   m_pFunc = &F;
   m_ctx = &(m_pFunc->getContext());
 
   m_pDL = &F.getParent()->getDataLayout();
-  ForcePromotion = getAnalysis<GenXBackendConfig>().isArrayPromotionForced() &&
+  const auto &BC = getAnalysis<GenXBackendConfig>();
+  ForcePromotion = BC.isArrayPromotionForced() &&
                    TotalAllocaLimitOpt.getNumOccurrences() == 0 &&
                    SingleAllocaLimitOpt.getNumOccurrences() == 0;
+
+  // Promoted arrays stay in registers, so they must fit next to the rest of
+  // the function: an alloca that would make the kernel spill is better left
+  // in private memory.
+  TotalAllocaLimit = TotalAllocaLimitOpt.getValue();
+  if (TotalAllocaLimitOpt.getNumOccurrences() == 0 &&
+      GRFBudgetPercentOpt.getValue() != 0) {
+    std::size_t NumGRFs = BC.isLargeGRFMode() ? 256 : 128;
+    std::size_t Budget =
+        NumGRFs * defaultGRFWidth * GRFBudgetPercentOpt.getValue() / 100;
+    std::size_t PeakLive = estimatePeakLiveBytes(F, *m_pDL);
+    TotalAllocaLimit =
+        std::min(TotalAllocaLimit, Budget > PeakLive ? Budget - PeakLive : 0);
+  }
   LargeAllocasWereLeft = false;
   m_allocasToPrivMem.clear();
 
@@ -611,7 +687,7 @@ void TransformPrivMem::selectAllocasToHandle() {
             });
   auto LastIt = vc::upper_partial_sum_bound(
       m_allocasToPrivMem.begin(), m_allocasToPrivMem.end(),
-      TotalAllocaLimitOpt.getValue(),
+      TotalAllocaLimit,
       [this](std::size_t PrevSum, const AllocaInst *CurAlloca) {
         return PrevSum + CurAlloca->getAllocationSizeInBits(*m_pDL).getValue() /
                              genx::ByteBits;
@@ -12,6 +12,11 @@ SPDX-License-Identifier: MIT
 ///
 /// This pass performs rematerialization to reduce register pressure.
 ///
+/// The candidates are widening casts (int to fp, and integer or fp
+/// extensions) with several uses in one block. Where the range from the cast
+/// to a use crosses a high pressure region, the cast is cloned next to that
+/// use, so only the narrower source stays live across the region.
+///
 //===----------------------------------------------------------------------===//
 #include "GenX.h"
 #include "GenXBaling.h"
@@ -20,12 +25,17 @@ SPDX-License-Identifier: MIT
 #include "GenXNumbering.h"
 #include "GenXPressureTracker.h"
 #include "GenXUtil.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Pass.h"
 #include "Probe/Assertion.h"
 
 using namespace llvm;
 using namespace genx;
 
+#define DEBUG_TYPE "GENX_REMAT"
+
+STATISTIC(NumRematerialized, "Number of rematerialized instructions");
+
 namespace {
 
 class GenXRematerialization : public FunctionGroupPass {
@@ -94,14 +104,24 @@ void GenXRematerialization::remat(Function *F, PressureTracker &RP) {
     for (auto &Inst : BB.getInstList()) {
       // (1) upward cast
       if (auto CI = dyn_cast<CastInst>(&Inst)) {
-        if (CI->getOpcode() != Instruction::UIToFP &&
-            CI->getOpcode() != Instruction::SIToFP)
+        switch (CI->getOpcode()) {
+        case Instruction::UIToFP:
+        case Instruction::SIToFP:
+        case Instruction::ZExt:
+        case Instruction::SExt:
+        case Instruction::FPExt:
+          break;
+        default:
           continue;
+        }
         if (!CI->getType()->isVectorTy())
           continue;
         if (CI->getSrcTy()->getScalarSizeInBits() >=
             CI->getDestTy()->getScalarSizeInBits())
           continue;
+        // keep predicates out of this: flag registers are scarcer than GRFs
+        if (CI->getSrcTy()->isIntOrIntVectorTy(1))
+          continue;
         if (Inst.isUsedOutsideOfBlock(&BB) || Inst.getNumUses() <= 2)
           continue;
         LiveRange *LR = Liveness->getLiveRangeOrNull(CI);
@@ -111,6 +131,9 @@ void GenXRematerialization::remat(Function *F, PressureTracker &RP) {
         unsigned B = Numbering->getNumber(CI);
         for (auto &U : CI->uses()) {
           auto UI = U.getUser();
+          // a clone cannot be placed in front of a phi
+          if (isa<PHINode>(UI))
+            continue;
           unsigned E = Numbering->getNumber(UI);
           if (E > B && RP.intersectWithRedRegion(B, E))
             Candidates.push_back(&U);
@@ -126,6 +149,7 @@ void GenXRematerialization::remat(Function *F, PressureTracker &RP) {
     Instruction *Clone = Inst->clone();
     Clone->insertBefore(UI);
     U->set(Clone);
+    ++NumRematerialized;
     Modified = true;
   }
 }
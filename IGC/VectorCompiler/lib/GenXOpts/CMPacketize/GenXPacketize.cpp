@@ -853,8 +853,13 @@ Value *GenXPacketize::packetizeLLVMInstruction(Instruction *pInst) {
       }
       pReplacedInst = CallInst::Create(VF, ArgOps, CI->getName(), CI);
       return pReplacedInst;
-    } else
-      IGC_ASSERT(0);
+    }
+    // Only direct calls to functions that findFunctionVectorizationOrder
+    // scheduled for this width can be packetized; anything else would be
+    // left as a scalar call inside a SIMD function.
+    report_fatal_error(
+        "Cannot packetize call: callee has no packetized version for SIMD" +
+        Twine(B->mVWidth));
   }
   uint32_t opcode = pInst->getOpcode();
 
@@ -176,7 +176,9 @@ std::unique_ptr<Module> GenXPrintfResolution::getBiFModule(LLVMContext &Ctx) {
         "printf bif module can be empty only if vc bif was disabled");
     report_fatal_error("printf implementation module is absent");
   }
-  return vc::getBiFModuleOrReportError(PrintfBiFModuleBuffer, Ctx);
+  // Only the implementation functions we reference get materialized by the
+  // LinkOnlyNeeded link below.
+  return vc::getLazyBiFModuleOrReportError(PrintfBiFModuleBuffer, Ctx);
 }
 
 static void assertPrintfCall(const CallInst &CI) {
@@ -14,8 +14,11 @@ SPDX-License-Identifier: MIT
 #include "common/LLVMWarningsPush.hpp"
 #endif
 
+#include "llvm/ADT/Hashing.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -52,6 +55,7 @@ private:
     struct SectionHdrEntry {
         uint32_t name    = 0;
         unsigned type    = 0;
+        uint64_t flags   = 0;
         uint64_t offset  = 0;
         uint64_t size    = 0;
         uint32_t link    = 0;
@@ -72,6 +76,15 @@ private:
     void writeSections();
     // write a raw section
     uint64_t writeSectionData(const uint8_t* data, uint64_t size, uint32_t padding);
+    // check if the section should be written compressed
+    bool isCompressible(const StandardSection& sect);
+    // find an already written text section with the same contents as sect,
+    // and record sect as written if there is none
+    const SectionHdrEntry* findIdenticalTextSection(const StandardSection& sect,
+        const SectionHdrEntry& entry);
+    // write a zlib compressed section with its compression header, return
+    // false without writing anything if compression does not pay off
+    bool writeCompressedSectionData(const StandardSection& sect, uint64_t& size);
     // write symbol table section, return section size
     uint64_t writeSymTab();
     // write rel or rela relocation table section
@@ -139,6 +152,10 @@ private:
     // section information for constructing section header
     SectionHdrListTy m_SectionHdrEntries;
 
+    // written text sections by content hash, as indices into
+    // m_SectionHdrEntries
+    std::multimap<llvm::hash_code, size_t> m_WrittenTextSections;
+
 };
 
 } // namespace zebin
@@ -401,6 +418,72 @@ uint64_t ELFWriter::writeSectionData(const uint8_t* data, uint64_t size, uint32_
     return m_W.OS.tell() - start_off;
 }
 
+bool ELFWriter::isCompressible(const StandardSection& sect)
+{
+    if (!m_ObjBuilder.m_compressNonLoadableSections ||
+        sect.m_data == nullptr || sect.m_padding != 0)
+        return false;
+    if (sect.m_type == SHT_ZEBIN_SPIRV || sect.m_type == SHT_ZEBIN_VISAASM)
+        return true;
+    // debug sections are added as SHT_PROGBITS
+    return sect.m_type == ELF::SHT_PROGBITS &&
+        StringRef(sect.m_sectName).startswith(".debug");
+}
+
+const ELFWriter::SectionHdrEntry* ELFWriter::findIdenticalTextSection(
+    const StandardSection& sect, const SectionHdrEntry& entry)
+{
+    if (!m_ObjBuilder.m_shareIdenticalTextSections ||
+        sect.m_type != ELF::SHT_PROGBITS || sect.m_data == nullptr ||
+        !StringRef(sect.m_sectName).startswith(m_ObjBuilder.m_TextName))
+        return nullptr;
+
+    StringRef code(reinterpret_cast<const char*>(sect.m_data), sect.m_size);
+    hash_code hash = hash_combine(code, sect.m_padding);
+    auto range = m_WrittenTextSections.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        const SectionHdrEntry& other = m_SectionHdrEntries[it->second];
+        const StandardSection* const otherSect =
+            static_cast<const StandardSection*>(other.section);
+        if (otherSect->m_size == sect.m_size &&
+            otherSect->m_padding == sect.m_padding &&
+            code == StringRef(reinterpret_cast<const char*>(otherSect->m_data),
+                otherSect->m_size))
+            return &other;
+    }
+    m_WrittenTextSections.emplace(hash, &entry - m_SectionHdrEntries.data());
+    return nullptr;
+}
+
+bool ELFWriter::writeCompressedSectionData(const StandardSection& sect, uint64_t& size)
+{
+    if (!zlib::isAvailable())
+        return false;
+
+    SmallVector<char, 0> compressed;
+    StringRef input(reinterpret_cast<const char*>(sect.m_data), sect.m_size);
+    if (Error err = zlib::compress(input, compressed)) {
+        consumeError(std::move(err));
+        return false;
+    }
+    uint64_t hdrSize =
+        is64Bit() ? sizeof(ELF::Elf64_Chdr) : sizeof(ELF::Elf32_Chdr);
+    if (hdrSize + compressed.size() >= sect.m_size)
+        return false;
+
+    uint64_t start_off = m_W.OS.tell();
+    m_W.write<uint32_t>(ELF::ELFCOMPRESS_ZLIB); // ch_type
+    if (is64Bit())
+        m_W.write<uint32_t>(0);                 // ch_reserved
+    writeWord(sect.m_size);                     // ch_size
+    writeWord(1);                               // ch_addralign
+    m_W.OS.write(compressed.data(), compressed.size());
+
+    size = m_W.OS.tell() - start_off;
+    IGC_ASSERT(size == hdrSize + compressed.size());
+    return true;
+}
+
 void ELFWriter::writePadding(uint32_t size)
 {
     for (uint32_t i = 0; i < size; ++i)
@@ -624,7 +707,7 @@ void ELFWriter::writeSectionHeader()
     // createSectionHdrEntries or writeSections
     for (SectionHdrEntry& entry : m_SectionHdrEntries) {
         writeSecHdrEntry(
-            entry.name, entry.type, 0, 0, entry.offset, entry.size, entry.link,
+            entry.name, entry.type, entry.flags, 0, entry.offset, entry.size, entry.link,
             entry.info, 0, entry.entsize);
     }
 }
@@ -636,13 +719,27 @@ void ELFWriter::writeSections()
 
         switch(entry.type) {
         case ELF::SHT_PROGBITS:
-        case SHT_ZEBIN_SPIRV: {
+        case SHT_ZEBIN_SPIRV:
+        case SHT_ZEBIN_GTPIN_INFO:
+        case SHT_ZEBIN_VISAASM:
+        case SHT_ZEBIN_MISC: {
             IGC_ASSERT(nullptr != entry.section);
             IGC_ASSERT(entry.section->getKind() == Section::STANDARD);
             const StandardSection* const stdsect =
                 static_cast<const StandardSection*>(entry.section);
             IGC_ASSERT(nullptr != stdsect);
             IGC_ASSERT(stdsect->m_size + stdsect->m_padding);
+            if (const SectionHdrEntry* same =
+                    findIdenticalTextSection(*stdsect, entry)) {
+                entry.offset = same->offset;
+                entry.size = same->size;
+                break;
+            }
+            if (isCompressible(*stdsect) &&
+                writeCompressedSectionData(*stdsect, entry.size)) {
+                entry.flags |= ELF::SHF_COMPRESSED;
+                break;
+            }
             entry.size = writeSectionData(
                 stdsect->m_data, stdsect->m_size, stdsect->m_padding);
             break;
@@ -65,6 +65,18 @@ public:
     void setTargetMetadata(TargetMetadata metadata) { m_metadata = metadata; }
     TargetMetadata getTargetMetadata() const { return m_metadata; }
 
+    // compress .debug*, .visaasm and .spv sections with zlib and mark them
+    // SHF_COMPRESSED. These sections are never loaded for execution, so only
+    // the tools reading them have to handle compressed sections.
+    void setCompressNonLoadableSections(bool compress)
+    { m_compressNonLoadableSections = compress; }
+
+    // write byte-identical .text sections (same code and padding) only once
+    // and have all of their section headers point at the same file data.
+    // Each kernel keeps its own section, symbols and relocations.
+    void setShareIdenticalTextSections(bool share)
+    { m_shareIdenticalTextSections = share; }
+
     // add a text section contains gen binary
     // - name: section name. This is usually the kernel or function name of
     //         this text section. Do not includes leading .text in given
@@ -361,6 +373,9 @@ private:
     GFXCORE_FAMILY m_gfxCoreFamily = IGFX_UNKNOWN_CORE;
     TargetMetadata m_metadata;
 
+    bool m_compressNonLoadableSections = false;
+    bool m_shareIdenticalTextSections = false;
+
     StandardSectionListTy m_textSections;
     StandardSectionListTy m_dataAndbssSections; // data and bss sections
     StandardSectionListTy m_otherStdSections;
@@ -38,6 +38,7 @@ struct zeInfoExecutionEnv
     zeinfo_bool_t has_dpas = false;
     zeinfo_bool_t has_fence_for_image_access = false;
     zeinfo_bool_t has_global_atomics = false;
+    zeinfo_bool_t has_in_kernel_local_ids = false;
     zeinfo_bool_t has_multi_scratch_spaces = false;
     zeinfo_bool_t has_no_stateless_write = false;
     zeinfo_int32_t offset_to_skip_per_thread_data_load = 0;
@@ -107,7 +108,7 @@ struct zeInfoContainer
     KernelsTy kernels;
 };
 struct PreDefinedAttrGetter{
-    static zeinfo_str_t getVersionNumber() { return "1.6"; }
+    static zeinfo_str_t getVersionNumber() { return "1.7"; }
 
     enum class ArgType {
         packed_local_ids,
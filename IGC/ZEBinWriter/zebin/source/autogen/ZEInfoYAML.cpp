@@ -44,6 +44,7 @@ void MappingTraits<zeInfoExecutionEnv>::mapping(IO& io, zeInfoExecutionEnv& info
     io.mapOptional("has_dpas", info.has_dpas, false);
     io.mapOptional("has_fence_for_image_access", info.has_fence_for_image_access, false);
     io.mapOptional("has_global_atomics", info.has_global_atomics, false);
+    io.mapOptional("has_in_kernel_local_ids", info.has_in_kernel_local_ids, false);
     io.mapOptional("has_multi_scratch_spaces", info.has_multi_scratch_spaces, false);
     io.mapOptional("has_no_stateless_write", info.has_no_stateless_write, false);
     io.mapOptional("offset_to_skip_per_thread_data_load", info.offset_to_skip_per_thread_data_load, 0);
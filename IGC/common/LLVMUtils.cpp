@@ -9,7 +9,9 @@ SPDX-License-Identifier: MIT
 #include "Compiler/CodeGenPublic.h"
 #include "Compiler/CISACodeGen/PassTimer.hpp"
 #include "Compiler/CISACodeGen/TimeStatsCounter.h"
+#include "common/PassStats.hpp"
 #include "common/Stats.hpp"
+#include "common/SysUtils.hpp"
 #include "common/debug/Dump.hpp"
 #include "common/shaderOverride.hpp"
 #include "common/IntrinsicAnnotator.hpp"
@@ -20,6 +22,8 @@ SPDX-License-Identifier: MIT
 #include <llvm/Support/SourceMgr.h>
 #include "common/LLVMWarningsPop.hpp"
 
+#include <chrono>
+
 using namespace IGC;
 using namespace IGC::Debug;
 using namespace llvm;
@@ -71,6 +75,144 @@ llvm::Pass* createFlushPass(llvm::Pass* pass, Dump& dump)
     return nullptr;
 }
 
+namespace {
+    // Starts or ends the measurement of the pass it is added next to.
+    template<typename PassT>
+    class CommonPassStatsPass : public PassT
+    {
+    public:
+        CommonPassStatsPass(PassStats::Scope& scope, bool isStart, const CodeGenContext* ctx, char& pid)
+            : PassT(pid), m_scope(scope), m_isStart(isStart), m_pContext(ctx) {}
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
+        StringRef getPassName() const override
+        {
+            return "Pass Stats";
+        }
+
+    protected:
+        void mark()
+        {
+            uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+            uint64_t peakKB = SysUtils::GetPeakMemoryKB();
+            if (m_isStart)
+            {
+                m_scope.startNs = now;
+                m_scope.startPeakKB = peakKB;
+            }
+            else
+            {
+                PassStats::get().record(m_scope.passName, now - m_scope.startNs,
+                    peakKB > m_scope.startPeakKB ? peakKB - m_scope.startPeakKB : 0,
+                    m_pContext->hash.getAsmHash());
+            }
+        }
+
+    private:
+        PassStats::Scope& m_scope;
+        const bool m_isStart;
+        const CodeGenContext* const m_pContext;
+    };
+
+    class ModulePassStatsPass : public CommonPassStatsPass<ModulePass>
+    {
+    public:
+        static char ID;
+
+        ModulePassStatsPass(PassStats::Scope& scope, bool isStart, const CodeGenContext* ctx)
+            : CommonPassStatsPass(scope, isStart, ctx, ID) {}
+
+        bool runOnModule(Module&) override
+        {
+            mark();
+            return false;
+        }
+    };
+
+    class FunctionPassStatsPass : public CommonPassStatsPass<FunctionPass>
+    {
+    public:
+        static char ID;
+
+        FunctionPassStatsPass(PassStats::Scope& scope, bool isStart, const CodeGenContext* ctx)
+            : CommonPassStatsPass(scope, isStart, ctx, ID) {}
+
+        bool runOnFunction(Function&) override
+        {
+            mark();
+            return false;
+        }
+    };
+
+    char ModulePassStatsPass::ID = 0;
+    char FunctionPassStatsPass::ID = 0;
+
+    // Writes the in-memory metadata into the module before it is printed.
+    class FlushMetaDataPass : public ModulePass
+    {
+    public:
+        static char ID;
+
+        FlushMetaDataPass(CodeGenContext* ctx) : ModulePass(ID), m_pContext(ctx) {}
+
+        void getAnalysisUsage(AnalysisUsage& AU) const override
+        {
+            AU.setPreservesAll();
+        }
+
+        StringRef getPassName() const override
+        {
+            return "Flush MetaData";
+        }
+
+        bool runOnModule(Module& M) override
+        {
+            m_pContext->getMetaDataUtils()->flush(M.getContext());
+            serialize(*m_pContext->getModuleMetaData(), &M);
+            return false;
+        }
+
+    private:
+        CodeGenContext* const m_pContext;
+    };
+
+    char FlushMetaDataPass::ID = 0;
+} // namespace
+
+// The measuring passes must be of the same kind as P so that they run in the
+// same pass manager: a module pass next to a function pass would split the
+// function pass pipeline. Loop and region passes are not measured, only the
+// function passes around them.
+bool IGCPassManager::addPassStatsPass(Pass* P, bool isStart)
+{
+    if (isStart)
+    {
+        m_passStatsScopes.emplace_front();
+        m_passStatsScopes.front().passName = m_name + '_' + std::string(P->getPassName());
+    }
+    PassStats::Scope& scope = m_passStatsScopes.front();
+
+    switch (P->getPassKind())
+    {
+    case PT_Module:
+    case PT_CallGraphSCC:
+        PassManager::add(new ModulePassStatsPass(scope, isStart, m_pContext));
+        return true;
+    case PT_Function:
+        PassManager::add(new FunctionPassStatsPass(scope, isStart, m_pContext));
+        return true;
+    default:
+        if (isStart)
+            m_passStatsScopes.pop_front();
+        return false;
+    }
+}
+
 void IGCPassManager::add(Pass *P)
 {
     //check only once
@@ -107,8 +249,15 @@ void IGCPassManager::add(Pass *P)
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_START));
     }
 
+    const bool measurePass = IGC_IS_FLAG_ENABLED(DumpPassStats) && addPassStatsPass(P, true);
+
     PassManager::add(P);
 
+    if (measurePass)
+    {
+        addPassStatsPass(P, false);
+    }
+
     if (IGC_REGKEY_OR_FLAG_ENABLED(DumpTimeStatsPerPass, TIME_STATS_PER_PASS))
     {
         PassManager::add(createTimeStatsIGCPass(m_pContext, m_name + '_' + std::string(P->getPassName()), STATS_COUNTER_END));
@@ -200,6 +349,12 @@ void IGCPassManager::addPrintPass(Pass* P, bool isBefore)
     if (!name.allow())
         return;
 
+    // Function printers don't print the module metadata
+    if (P->getPassKind() == PT_Module)
+    {
+        PassManager::add(new FlushMetaDataPass(m_pContext));
+    }
+
     // The dump object needs to be on the Heap because it owns the stream, and the stream
     // is taken by reference into the printer pass. If the Dump object had been on the
     // stack, then that reference would go bad as soon as we exit this scope, and then
@@ -220,7 +375,7 @@ void DumpLLVMIR(IGC::CodeGenContext* pContext, const char* dumpName)
 
     if (IGC_IS_FLAG_ENABLED(DumpLLVMIR))
     {
-        pContext->getMetaDataUtils()->save(*pContext->getLLVMContext());
+        pContext->getMetaDataUtils()->flush(*pContext->getLLVMContext());
         serialize(*(pContext->getModuleMetaData()), pContext->getModule());
         using namespace IGC::Debug;
         auto name =
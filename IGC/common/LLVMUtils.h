@@ -12,6 +12,7 @@ SPDX-License-Identifier: MIT
 #include <llvm/IR/LegacyPassManager.h>
 #include "common/LLVMWarningsPop.hpp"
 #include <list>
+#include "PassStats.hpp"
 #include "Stats.hpp"
 #include <string.h>
 
@@ -34,8 +35,11 @@ namespace IGC
         CodeGenContext* const m_pContext;
         const std::string m_name;
         std::list<Debug::Dump> m_irDumps;
+        std::list<PassStats::Scope> m_passStatsScopes;
 
         void addPrintPass(llvm::Pass* P, bool isBefore);
+        // Returns false if P is of a kind that cannot be measured on its own.
+        bool addPassStatsPass(llvm::Pass* P, bool isStart);
         bool isPrintBefore(llvm::Pass* P);
         bool isPrintAfter(llvm::Pass* P);
 
@@ -0,0 +1,65 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/LockStats.hpp"
+
+#include <chrono>
+
+using namespace IGC;
+
+// Mutexes are only ever added, so readers can walk the list without a lock.
+static std::atomic<ProfiledMutex*>& registeredMutexes()
+{
+    static std::atomic<ProfiledMutex*> head{ nullptr };
+    return head;
+}
+
+ProfiledMutex::ProfiledMutex(const char* name)
+    : m_name(name)
+{
+    auto& head = registeredMutexes();
+    m_next = head.load(std::memory_order_relaxed);
+    while (!head.compare_exchange_weak(m_next, this, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+void ProfiledMutex::lock()
+{
+    if (!m_mutex.try_lock())
+    {
+        auto start = std::chrono::steady_clock::now();
+        m_mutex.lock();
+        auto waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        m_contentions.fetch_add(1, std::memory_order_relaxed);
+        m_waitNs.fetch_add(uint64_t(waitNs), std::memory_order_relaxed);
+    }
+    m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ProfiledMutex::try_lock()
+{
+    if (!m_mutex.try_lock())
+        return false;
+    m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+std::vector<LockStat> IGC::GetLockStats()
+{
+    std::vector<LockStat> stats;
+    for (ProfiledMutex* m = registeredMutexes().load(std::memory_order_acquire); m; m = m->m_next)
+    {
+        stats.push_back({ m->m_name,
+            m->m_acquisitions.load(std::memory_order_relaxed),
+            m->m_contentions.load(std::memory_order_relaxed),
+            m->m_waitNs.load(std::memory_order_relaxed) });
+    }
+    return stats;
+}
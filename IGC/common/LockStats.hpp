@@ -0,0 +1,61 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace IGC
+{
+    struct LockStat
+    {
+        const char* name;
+        uint64_t acquisitions;
+        /// acquisitions that found the lock held
+        uint64_t contentions;
+        uint64_t waitNs;
+    };
+
+    /// Counters of every ProfiledMutex constructed so far, accumulated since
+    /// process start.
+    std::vector<LockStat> GetLockStats();
+
+    /// A std::mutex that counts how often it is taken and how long threads
+    /// wait for it, to find the global locks that limit parallel compiles.
+    ///
+    /// An uncontended lock only costs a try_lock and a relaxed increment over
+    /// std::mutex; the clock is only read when the lock is already held.
+    /// Every ProfiledMutex must have static storage duration: it registers
+    /// itself in a process-wide list read by GetLockStats().
+    class ProfiledMutex
+    {
+    public:
+        explicit ProfiledMutex(const char* name);
+        ProfiledMutex(const ProfiledMutex&) = delete;
+        ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+        void lock();
+        bool try_lock();
+        void unlock() { m_mutex.unlock(); }
+
+        const char* name() const { return m_name; }
+
+    private:
+        friend std::vector<LockStat> GetLockStats();
+
+        std::mutex m_mutex;
+        const char* m_name;
+        std::atomic<uint64_t> m_acquisitions{ 0 };
+        std::atomic<uint64_t> m_contentions{ 0 };
+        std::atomic<uint64_t> m_waitNs{ 0 };
+        ProfiledMutex* m_next;
+    };
+} // namespace IGC
@@ -106,6 +106,25 @@ namespace IGC
         unsigned int MipCount = 0;
     };
 
+    // Runtime state of a bound texture known to the driver when it compiles
+    // the shader. The compiled code is only valid for that state.
+    struct InlineResourceFacts
+    {
+        // Number of channels stored by the surface format, 0 if unknown.
+        // Missing green/blue channels read as 0 and missing alpha as 1.
+        unsigned int numChannels = 0;
+        bool isIntegerFormat = false;
+        // 1x1 surface with a single mip level and array slice.
+        bool isSingleTexel = false;
+    };
+
+    // Runtime state of a bound sampler known to the driver.
+    struct InlineSamplerFacts
+    {
+        // None of the address modes is border/clamp-to-border.
+        bool noBorderAddressing = false;
+    };
+
     struct ArgDependencyInfoMD
     {
         int argDependency = 0;
@@ -438,6 +457,9 @@ namespace IGC
         bool has64BVertexHeaderInput = false;
         bool has64BVertexHeaderOutput = false;
         bool hasVertexHeader = true;
+        // Set when the driver links the pipeline: entry i is non-zero if the
+        // next stage reads output attribute i. Empty if unknown.
+        std::vector<int> nextStageInputMask;
     };
 
     //metadata for the entire module
@@ -452,6 +474,9 @@ namespace IGC
         uint32_t CurUniqueIndirectIdx = DefaultIndirectIdx;
         std::map<uint32_t, std::array<uint32_t, 4>> inlineDynTextures;
         std::vector<InlineResInfo> inlineResInfoData;
+        // keyed by texture and sampler index respectively
+        std::map<uint32_t, InlineResourceFacts> inlineResourceFacts;
+        std::map<uint32_t, InlineSamplerFacts> inlineSamplerFacts;
         ImmConstantInfo immConstant;
         std::vector<InlineProgramScopeBuffer> inlineConstantBuffers;
         std::vector<InlineProgramScopeBuffer> inlineGlobalBuffers;
@@ -0,0 +1,85 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/PassStats.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/Support/Format.h>
+#include <llvm/Support/raw_ostream.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace IGC;
+
+PassStats& PassStats::get()
+{
+    static PassStats stats;
+    return stats;
+}
+
+PassStats::~PassStats()
+{
+    if (IGC_IS_FLAG_ENABLED(DumpPassStats) && !m_entries.empty())
+    {
+        // stderr rather than dbgs(), which may already be destroyed
+        llvm::raw_fd_ostream OS(2, false, true);
+        print(OS);
+    }
+}
+
+void PassStats::record(const std::string& passName, uint64_t ns, uint64_t peakGrowthKB, uint64_t shaderHash)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    Entry& entry = m_entries[passName];
+    entry.runs++;
+    entry.totalNs += ns;
+    entry.peakGrowthKB += peakGrowthKB;
+    if (ns > entry.maxNs)
+    {
+        entry.maxNs = ns;
+        entry.maxNsShaderHash = shaderHash;
+    }
+}
+
+std::map<std::string, PassStats::Entry> PassStats::getEntries() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_entries;
+}
+
+void PassStats::print(llvm::raw_ostream& OS) const
+{
+    std::map<std::string, Entry> entries = getEntries();
+    std::vector<std::pair<std::string, Entry>> sorted(entries.begin(), entries.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.totalNs > b.second.totalNs;
+    });
+
+    uint64_t totalNs = 0;
+    for (const auto& it : sorted)
+        totalNs += it.second.totalNs;
+
+    OS << "===== IGC pass statistics =====\n";
+    OS << "    total ms      %       runs       max ms     peak +KB       max shader  pass\n";
+    for (const auto& it : sorted)
+    {
+        const Entry& entry = it.second;
+        OS << llvm::format("%12.3f %6.2f %10llu %12.3f %12llu %016llx  %s\n",
+            entry.totalNs / 1e6,
+            totalNs ? 100.0 * entry.totalNs / totalNs : 0.0,
+            (unsigned long long)entry.runs,
+            entry.maxNs / 1e6,
+            (unsigned long long)entry.peakGrowthKB,
+            (unsigned long long)entry.maxNsShaderHash,
+            it.first.c_str());
+    }
+    OS.flush();
+}
@@ -0,0 +1,71 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace llvm
+{
+    class raw_ostream;
+}
+
+namespace IGC
+{
+    /// Compile time and memory growth of every pass added through
+    /// IGCPassManager, aggregated over all compilations of the process
+    /// (DumpPassStats regkey).
+    ///
+    /// Passes are keyed by "<pass manager name>_<pass name>". A function pass
+    /// is measured on each function separately, and its time includes the
+    /// analyses scheduled right before it. Memory is the growth of the peak
+    /// resident set size while the pass runs, so only passes that raise the
+    /// process high-water mark show any. The summary is printed to stderr at
+    /// process exit and can be queried at any time with print().
+    class PassStats
+    {
+    public:
+        struct Entry
+        {
+            uint64_t runs = 0;
+            uint64_t totalNs = 0;
+            uint64_t maxNs = 0;
+            uint64_t peakGrowthKB = 0;
+            /// asm hash of the shader of the slowest run
+            uint64_t maxNsShaderHash = 0;
+        };
+
+        /// Start of one measurement, shared by the two passes IGCPassManager
+        /// adds around the measured one.
+        struct Scope
+        {
+            std::string passName;
+            uint64_t startNs = 0;
+            uint64_t startPeakKB = 0;
+        };
+
+        static PassStats& get();
+
+        void record(const std::string& passName, uint64_t ns, uint64_t peakGrowthKB, uint64_t shaderHash);
+
+        /// Passes sorted by decreasing total time.
+        void print(llvm::raw_ostream& OS) const;
+
+        std::map<std::string, Entry> getEntries() const;
+
+    private:
+        PassStats() = default;
+        ~PassStats();
+
+        mutable std::mutex m_lock;
+        std::map<std::string, Entry> m_entries;
+    };
+} // namespace IGC
@@ -129,5 +129,17 @@ namespace IGC
 
             return true;
         }
+
+        uint64_t GetPeakMemoryKB()
+        {
+#if !defined(_WIN32)
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0)
+            {
+                return static_cast<uint64_t>(usage.ru_maxrss);
+            }
+#endif
+            return 0;
+        }
     }
 }
@@ -8,12 +8,14 @@ SPDX-License-Identifier: MIT
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 #if defined _WIN32
 #include <Windows.h>
 #include <cfgmgr32.h>
 #else
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #endif
@@ -64,5 +66,8 @@ namespace IGC
         //If full_path != nullptr and function success, path to directory is copied to pointed string,
         // if function fails, full_path remains unaffected
         bool CreateDir(std::string basedir, bool append_processdir = false, bool add_pid = false, std::string* full_path = nullptr);
+
+        //Returns the peak resident set size of the process in KB, or 0 if it cannot be queried
+        uint64_t GetPeakMemoryKB();
     }
 }
\ No newline at end of file
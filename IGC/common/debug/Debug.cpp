@@ -11,6 +11,7 @@ SPDX-License-Identifier: MIT
 #include "common/debug/TeeOutputStream.hpp"
 
 #include "AdaptorCommon/customApi.hpp"
+#include "common/LockStats.hpp"
 
 #include "common/LLVMWarningsPush.hpp"
 #include "llvm/Config/llvm-config.h"
@@ -281,7 +282,7 @@ void ReleaseErrHandlers()
     // do nothing
 }
 
-static std::mutex stream_mutex;
+static ProfiledMutex stream_mutex("stream_mutex");
 
 void DumpLock()
 {
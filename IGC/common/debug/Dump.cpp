@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "common/debug/Dump.hpp"
 
+#include "common/debug/DumpWriter.hpp"
 #include "common/debug/TeeOutputStream.hpp"
 
 #include "AdaptorCommon/customApi.hpp"
@@ -180,7 +181,7 @@ DumpName DumpName::Pass(std::string const& name, llvm::Optional<unsigned int> in
 }
 
 std::unordered_map<QWORD, unsigned int> shaderHashMap;
-std::mutex DumpName::hashMapLock;
+ProfiledMutex DumpName::hashMapLock("hashMapLock");
 unsigned int DumpName::shaderNum = 1;
 
 std::string DumpName::AbsolutePath(OutputFolderName folder) const
@@ -237,13 +238,17 @@ std::string DumpName::AbsolutePath(OutputFolderName folder) const
     {
 
         if (m_type.hasValue() && IGC_IS_FLAG_ENABLED(EnableShaderNumbering)) {
-            bool increment = shaderHashMap.insert({ m_hash->asmHash, shaderNum }).second;
-            //Need to serialize access to the shaderNum counter in case different threads need to dump the same shader at once.
-            hashMapLock.lock();
-            if (increment) shaderNum++;
-            hashMapLock.unlock();
+            unsigned int number = 0;
+            {
+                // Need to serialize access to the map and the shaderNum counter in case different
+                // threads need to dump the same shader at once.
+                std::lock_guard<ProfiledMutex> lock(hashMapLock);
+                auto inserted = shaderHashMap.insert({ m_hash->asmHash, shaderNum });
+                if (inserted.second) shaderNum++;
+                number = inserted.first->second;
+            }
             ss << "_"
-               << shaderHashMap[m_hash->asmHash]
+               << number
                << "_";
         }
 
@@ -622,20 +627,9 @@ void Dump::flush()
     {
         return;
     }
-    std::ios_base::openmode mode = std::ios_base::out;
-    if (m_ClearFile)
-    {
-        m_ClearFile = false;
-    }
-    else
-    {
-        mode |= std::ios_base::app;
-    }
-    if (!isText(m_type))
-        mode |= std::ios_base::binary;
-    std::ofstream asmFile(m_name.str(), mode);
-    asmFile << m_string;
-    asmFile.close();
+    bool append = !m_ClearFile;
+    m_ClearFile = false;
+    IGC::Debug::WriteDumpFile(m_name.str(), std::move(m_string), append, !isText(m_type));
     m_string.clear();
 }
 
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #pragma once
 
+#include "common/LockStats.hpp"
 #include "common/Types.hpp"
 
 #include "AdaptorCommon/customApi.hpp"
@@ -58,7 +59,7 @@ public:
     DumpName();
 
     //Needs to be static so that all objects of the class share it and public so that all derived classes have access to it.
-    static std::mutex hashMapLock;
+    static ProfiledMutex hashMapLock;
     static unsigned int shaderNum;
 
     DumpName ShaderName(std::string const& name) const;
@@ -0,0 +1,247 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "common/debug/DumpWriter.hpp"
+
+#include "AdaptorCommon/customApi.hpp"
+#include "common/igc_regkeys.hpp"
+
+#include "common/LLVMWarningsPush.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Support/Compression.h>
+#include <llvm/Support/Error.h>
+#include "common/LLVMWarningsPop.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+using namespace IGC;
+
+namespace
+{
+    struct DumpRequest
+    {
+        std::string path;
+        std::string data;
+        bool append;
+        bool binary;
+    };
+
+    // Archive layout: the 8 byte magic, then for each file a record of
+    //   uint32 path size, uint32 flags, uint64 file size, uint64 stored size,
+    //   path, stored data
+    // with every integer little-endian. The stored data is the file contents,
+    // zlib compressed if ArchiveCompressed is set. ArchiveAppend records
+    // extend the file written by the previous records of the same path.
+    const char ArchiveMagic[8] = { 'I', 'G', 'C', 'D', 'U', 'M', 'P', '1' };
+    enum ArchiveFlags : uint32_t
+    {
+        ArchiveAppend     = 1 << 0,
+        ArchiveCompressed = 1 << 1,
+    };
+
+    class DumpWriter
+    {
+    public:
+        static DumpWriter& get()
+        {
+            static DumpWriter writer;
+            return writer;
+        }
+
+        void write(DumpRequest&& request);
+        void flush();
+
+    private:
+        DumpWriter();
+        ~DumpWriter();
+
+        void run();
+        void output(const DumpRequest& request);
+        void writeFile(const DumpRequest& request);
+        void writeArchive(const DumpRequest& request);
+
+        const bool m_async;
+        const bool m_archive;
+        const size_t m_queueLimit;
+
+        std::mutex m_lock;
+        std::condition_variable m_queued;
+        std::condition_variable m_written;
+        std::deque<DumpRequest> m_queue;
+        size_t m_queuedBytes = 0;
+        bool m_writing = false;
+        bool m_done = false;
+        std::thread m_thread;
+
+        std::mutex m_archiveLock;
+        std::ofstream m_archiveFile;
+        std::string m_archiveFolder;
+    };
+} // namespace
+
+DumpWriter::DumpWriter()
+    : m_async(IGC_IS_FLAG_ENABLED(AsyncShaderDump))
+    , m_archive(IGC_IS_FLAG_ENABLED(ShaderDumpArchive))
+    , m_queueLimit(size_t(IGC_GET_FLAG_VALUE(AsyncShaderDumpQueueMB)) << 20)
+{
+    if (m_async)
+    {
+        m_thread = std::thread(&DumpWriter::run, this);
+    }
+}
+
+DumpWriter::~DumpWriter()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_done = true;
+        }
+        m_queued.notify_one();
+        m_thread.join();
+    }
+    if (m_archiveFile.is_open())
+    {
+        m_archiveFile.close();
+    }
+}
+
+void DumpWriter::write(DumpRequest&& request)
+{
+    if (!m_async)
+    {
+        output(request);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_lock);
+    // a dump larger than the whole queue still goes through once it is empty
+    m_written.wait(lock, [&]() {
+        return m_queuedBytes == 0 || m_queuedBytes + request.data.size() <= m_queueLimit;
+    });
+    m_queuedBytes += request.data.size();
+    m_queue.push_back(std::move(request));
+    lock.unlock();
+    m_queued.notify_one();
+}
+
+void DumpWriter::flush()
+{
+    if (!m_async)
+        return;
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_written.wait(lock, [&]() { return m_queue.empty() && !m_writing; });
+}
+
+void DumpWriter::run()
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    while (true)
+    {
+        m_queued.wait(lock, [&]() { return m_done || !m_queue.empty(); });
+        if (m_queue.empty())
+            break;
+
+        DumpRequest request = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+        lock.unlock();
+
+        output(request);
+
+        lock.lock();
+        m_writing = false;
+        m_queuedBytes -= request.data.size();
+        m_written.notify_all();
+    }
+}
+
+void DumpWriter::output(const DumpRequest& request)
+{
+    if (m_archive)
+        writeArchive(request);
+    else
+        writeFile(request);
+}
+
+void DumpWriter::writeFile(const DumpRequest& request)
+{
+    std::ios_base::openmode mode = std::ios_base::out;
+    if (request.append)
+        mode |= std::ios_base::app;
+    if (request.binary)
+        mode |= std::ios_base::binary;
+    std::ofstream file(request.path, mode);
+    file.write(request.data.data(), request.data.size());
+}
+
+void DumpWriter::writeArchive(const DumpRequest& request)
+{
+    auto writeInt = [this](uint64_t value, unsigned size) {
+        char bytes[8];
+        for (unsigned i = 0; i < size; ++i)
+            bytes[i] = char((value >> (8 * i)) & 0xff);
+        m_archiveFile.write(bytes, size);
+    };
+
+    llvm::SmallVector<char, 0> compressed;
+    uint32_t flags = request.append ? ArchiveAppend : 0;
+    if (llvm::zlib::isAvailable())
+    {
+        if (llvm::Error err = llvm::zlib::compress(request.data, compressed))
+        {
+            llvm::consumeError(std::move(err));
+        }
+        else if (compressed.size() < request.data.size())
+        {
+            flags |= ArchiveCompressed;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_archiveLock);
+    if (!m_archiveFile.is_open())
+    {
+        m_archiveFolder = IGC::Debug::GetShaderOutputFolder();
+        m_archiveFile.open(m_archiveFolder + "shader_dump.igcarchive",
+            std::ios_base::out | std::ios_base::binary);
+        m_archiveFile.write(ArchiveMagic, sizeof(ArchiveMagic));
+    }
+
+    // paths are stored relative to the dump folder where possible
+    std::string path = request.path;
+    if (!m_archiveFolder.empty() && path.compare(0, m_archiveFolder.size(), m_archiveFolder) == 0)
+        path = path.substr(m_archiveFolder.size());
+
+    const bool isCompressed = (flags & ArchiveCompressed) != 0;
+    writeInt(path.size(), 4);
+    writeInt(flags, 4);
+    writeInt(request.data.size(), 8);
+    writeInt(isCompressed ? compressed.size() : request.data.size(), 8);
+    m_archiveFile.write(path.data(), path.size());
+    if (isCompressed)
+        m_archiveFile.write(compressed.data(), compressed.size());
+    else
+        m_archiveFile.write(request.data.data(), request.data.size());
+    m_archiveFile.flush();
+}
+
+void IGC::Debug::WriteDumpFile(const std::string& path, std::string data, bool append, bool binary)
+{
+    DumpWriter::get().write({ path, std::move(data), append, binary });
+}
+
+void IGC::Debug::FlushDumpFiles()
+{
+    DumpWriter::get().flush();
+}
@@ -0,0 +1,34 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#pragma once
+
+#include <string>
+
+namespace IGC
+{
+    namespace Debug
+    {
+        /// Write a shader dump file.
+        ///
+        /// With the AsyncShaderDump regkey the file is queued and a background
+        /// thread writes it, so that dumping does not stall the compile
+        /// thread. Files are written in the order they are queued. The queue
+        /// holds at most AsyncShaderDumpQueueMB of data; when it is full the
+        /// caller waits for the writer to catch up.
+        ///
+        /// With the ShaderDumpArchive regkey files are not created; each one
+        /// is appended as a record to shader_dump.igcarchive in the shader
+        /// dump folder instead, zlib compressed when it helps.
+        /// IGC/Scripts/extract_shader_dump_archive.py unpacks the archive.
+        void WriteDumpFile(const std::string& path, std::string data, bool append, bool binary);
+
+        /// Wait until every queued dump has been written.
+        void FlushDumpFiles();
+    } // namespace Debug
+} // namespace IGC
@@ -47,6 +47,7 @@ DECLARE_IGC_REGKEY(DWORD,UnifiedSendCycle,              0,     "Using unified se
 DECLARE_IGC_REGKEY(DWORD,DisableMixMode,                0,     "Disables mix mode in vISA BE.", false)
 DECLARE_IGC_REGKEY(DWORD,DisableHFMath,                 0,     "Disables HF math instructions.", false)
 DECLARE_IGC_REGKEY(debugString, VISAOptions,            0,     "Options to vISA. Space-separated options.", true)
+DECLARE_IGC_REGKEY(debugString, VISALatencyProfile,     0,     "Latency and occupancy profile file used by the vISA schedulers and SWSB instead of the built-in tables", true)
 DECLARE_IGC_REGKEY(DWORD,disableIGASyntax,              false, "Disables GEN isa text output using IGA and new syntax.", false)
 DECLARE_IGC_REGKEY(DWORD,disableCompaction,             false, "Disables compaction.", true)
 DECLARE_IGC_REGKEY(DWORD,TotalGRFNum,                   0,     "Total GRF used for register allocation.", false)
@@ -94,6 +95,7 @@ DECLARE_IGC_REGKEY(bool, DisableCodeSinking,            false, "Setting this to
 DECLARE_IGC_REGKEY(bool, DisableCodeSinkingInputVec,    false, "Setting this to 1/true disable sinking inputVec inst (test)", false)
 DECLARE_IGC_REGKEY(DWORD, LoopSinkMinSave,              5,  "If loop sink can have save more than this Minimum, do it; otherwise, skip", false)
 DECLARE_IGC_REGKEY(DWORD, LoopSinkThresholdDelta,       50,  "Do loop sink If the estimated register pressure is higher than this + #avaialble registers", false)
+DECLARE_IGC_REGKEY(bool, EnableCodeSinkingRegionRollback, false, "Undo code-sinking per target block when its estimated register pressure gets too high, instead of per source block", false)
 DECLARE_IGC_REGKEY(bool, DisableCodeHoisting,           false, "Setting this to 1/true adds a compiler switch to disable code-hoisting", false)
 DECLARE_IGC_REGKEY(bool, DisableDeSSA,                  false, "Setting this to 1/true adds a compiler switch to disable optimized De-SSA", false)
 DECLARE_IGC_REGKEY(bool, EnableDeSSAWA,                 true,  "[tmp]Keep some piece of code to avoid perf regression", false)
@@ -102,11 +104,15 @@ DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing,      false, "Setting this to
 DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_RT,   false, "Setting this to 1/true adds a compiler switch to disable payload coalescing optimization for RT only", false)
 DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_Sample, false, "Setting this to 1/true adds a compiler switch to disable payload coalescing optimization for Samplers only", false)
 DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_URB,  false, "Setting this to 1/true adds a compiler switch to disable payload coalescing optimization for URB writes only", false)
+DECLARE_IGC_REGKEY(bool, DisablePayloadCoalescing_PhiSrc, false, "Setting this to 1/true isolates payload values used by phis from payload coalescing even if DeSSA copies them into the phi", false)
 DECLARE_IGC_REGKEY(bool, DisableUniformAnalysis,        false, "Setting this to 1/true adds a compiler switch to disable uniform_analysis", false)
+DECLARE_IGC_REGKEY(bool, EnableInterproceduralUniformity, false, "Propagate uniformity of subroutine arguments and return values across call sites", false)
 DECLARE_IGC_REGKEY(bool, EnableWorkGroupUniformGoto,    false, "Setting to 1 enables generating uniform goto for work group uniform [eu fusion only]", false)
 DECLARE_IGC_REGKEY(DWORD, DisablePushConstant,           0, "Bit mask to disable push constant per shader stages. bit0 = All, Bit 1 = VS, Bit 2 = HS, Bit 3 = DS, Bit 4 = GS, Bit 5 = PS", false)
 DECLARE_IGC_REGKEY(DWORD, DisableAttributePush,          0, "Bit mask to disable push Attribute per shader stages. bit0 = All, Bit 1 = VS, Bit 2 = HS, Bit 3 = DS, Bit 4 = GS", false)
 DECLARE_IGC_REGKEY(bool, DisableSimplePushWithDynamicUniformBuffers, false,"Disable Simple Push Constants Optimization for dynamic uniform buffers.", false)
+DECLARE_IGC_REGKEY(bool, EnableWeightedPushConstantSelection, false, "Select the simple push constants by their loop-depth weighted use count per GRF instead of in program order", false)
+DECLARE_IGC_REGKEY(bool, DumpPushConstantLayout, false, "Append the selected simple push constant layout of each shader to PushConstantLayout.json in the dump folder", false)
 DECLARE_IGC_REGKEY(bool, DisableStaticCheck,            false, "Disable static check to push constants.", false)
 DECLARE_IGC_REGKEY(bool, DisableStaticCheckForConstantFolding,  true, "Disable static check to fold constants.", false)
 DECLARE_IGC_REGKEY(int, forcePushConstantMode,  0, "set the push constant mode, 0 is default behavior, 1 is simple push, 2 is gather constant, 3 is none/pull constants", false)
@@ -114,6 +120,8 @@ DECLARE_IGC_REGKEY(bool, DisableConstantCoalescing,     false, "Setting this to
 DECLARE_IGC_REGKEY(bool, DisableConstantCoalescingOutOfBoundsCheck,     false, "Setting this to 1/true adds a compiler switch to disable constant coalesing out of bounds check", false)
 DECLARE_IGC_REGKEY(bool, DisableConstantCoalescingOfStatefulNonUniformLoads, false, "Disable merging non-uniform loads from stateful buffers. Note: does not affect merging to sampler loads", false)
 DECLARE_IGC_REGKEY(bool, EnableTextureLoadCoalescing, false, "Enable merging non-uniform loads from bindless textures", false)
+DECLARE_IGC_REGKEY(bool, EnableGlobalConstantCoalescing, false, "Enable hoisting direct constant buffer loads from sibling blocks to their common dominator so they are coalesced", false)
+DECLARE_IGC_REGKEY(DWORD, GlobalConstantCoalescingMaxGRFPressure, 96, "Max estimated GRF pressure (in GRFs) allowed along the extended live range of a hoisted constant buffer chunk", false)
 DECLARE_IGC_REGKEY(bool, UseHDCTypedReadForAllTextures, false, "Setting this to use HDC message rather than sampler ld for texture read", false)
 DECLARE_IGC_REGKEY(bool, UseHDCTypedReadForAllTypedBuffers,  false, "Setting this to use HDC message rather than sampler ld for buffer read", false)
 DECLARE_IGC_REGKEY(bool, DisableUniformTypedAccess,     false, "Setting this will disable uniform typed access handling", false)
@@ -133,6 +141,8 @@ DECLARE_IGC_REGKEY(bool, DisableBranchSwaping,          false, "Setting this to
 DECLARE_IGC_REGKEY(DWORD,SetLoopUnrollThreshold,        0,     "Set the loop unroll threshold. Value 0 will use the default threshold.", false)
 DECLARE_IGC_REGKEY(DWORD,SetLoopUnrollThresholdForHighRegPressure,        0,     "Set the loop unroll threshold for shaders with high reg pressure. Value 0 will use the default threshold.", false)
 DECLARE_IGC_REGKEY(DWORD,SetRegisterPressureThresholdForLoopUnroll,       64,     "Set the register pressure threshold for limiting the loop unroll to smaller loops", false)
+DECLARE_IGC_REGKEY(bool, EnablePressureAwareLoopUnroll, true,  "Cap the unroll factor of each loop to what its estimated register pressure allows, and partially unroll small loops whose memory accesses MemOpt can then merge", false)
+DECLARE_IGC_REGKEY(DWORD,LoopUnrollGRFBudgetPercent,    80,    "Percentage of the GRF file an unrolled loop may be estimated to use with EnablePressureAwareLoopUnroll", false)
 DECLARE_IGC_REGKEY(DWORD,SetBranchSwapThreshold,        400,   "Set the branch swaping threshold.", false)
 DECLARE_IGC_REGKEY(debugString, LLVMCommandLine,        0,     "applies LLVM command line", false)
 DECLARE_IGC_REGKEY(bool, DisableDX9LowPrecision,        true,  "Disables HF in DX9.", false)
@@ -150,6 +160,7 @@ DECLARE_IGC_REGKEY(bool, DisableImmConstantOpt,         false, "Disable IGC Indi
 DECLARE_IGC_REGKEY(DWORD,MaxImmConstantSizePushed,      256,   "Set the max size of immediate constant buffer pushed", false)
 DECLARE_IGC_REGKEY(bool, EnableCustomLoopVersioning,    true,  "Enable IGC to do custom loop versioning", false)
 DECLARE_IGC_REGKEY(bool, DisableMCSOpt,                 false,  "Disable IGC to run MCS optimization", false)
+DECLARE_IGC_REGKEY(bool, DisableMCSOptSharedFetch,      false,  "Disable fetching sample 0 next to the MCS read so loads in other blocks or sample loops can share it", false)
 DECLARE_IGC_REGKEY(bool, DisableGatingSimilarSamples,   false,  "Disable Gating of similar sample instructions", false)
 DECLARE_IGC_REGKEY(bool, EnableSoftwareVertexFetch,     false, "Enable software vertex fetch for VS.", false)
 DECLARE_IGC_REGKEY(bool, EnableSoftwareStencil,         false, "Enable software stencil for PS.", false)
@@ -170,6 +181,9 @@ DECLARE_IGC_REGKEY(bool, UseTiledCSThreadOrder,         true,  "Use 4x4 disaptch
 DECLARE_IGC_REGKEY(bool, EnableWaveForce32,             false, "Force Wave to use simd32", false)
 DECLARE_IGC_REGKEY(bool, EnableMergeTransposeSLM,       false, "Transpose SLM float3 storage from 3 separate x,y,z buffers to 1 big buffer with xyz consecutively", false)
 DECLARE_IGC_REGKEY(bool, EnableSLMConstProp,            true,   "Enable SLM constant propagation (compute shader only).", false)
+DECLARE_IGC_REGKEY(bool, EnableSLMLayoutOpt,            false, "Share SLM between __local arrays separated by a barrier and pad 2D arrays against bank conflicts (OpenCL only)", false)
+DECLARE_IGC_REGKEY(bool, DumpSLMLayout,                 false, "Dump the offsets and total SLM size of each kernel to SLMLayout.txt in the shader dump folder", false)
+DECLARE_IGC_REGKEY(bool, EnableRedundantBarrierRemoval, false, "Remove thread group barriers and memory fences that no shared memory access crosses, and run synchronization coalescing for OpenCL kernels", false)
 DECLARE_IGC_REGKEY(bool, EnableStatelessToStatefull,    true,  "Enable Stateless To Statefull transformation for global and constant address space in OpenCL kernels", false)
 DECLARE_IGC_REGKEY(bool, EnableStatefulToken,           true,  "Enable generating patch token to indicate a ptr argument is fully converted to stateful (temporary)", false)
 DECLARE_IGC_REGKEY(bool, EnableGenUpdateCB,             false, "Enable derived constant optimization.", false)
@@ -200,6 +214,9 @@ DECLARE_IGC_REGKEY(bool, DisableFDivReassociation,      false,   "Disable reasso
 DECLARE_IGC_REGKEY(bool, EnableTrigFuncRangeReduction,    false,    "reduce the sin and cosing function domain range", true)
 DECLARE_IGC_REGKEY(bool, EnableUnmaskedFunctions,    true,    "Enable unmaksed functions SYCL feature.", true)
 DECLARE_IGC_REGKEY(bool, EnableStatefulAtomic,       false,   "Enable promoting stateless atomic to stateful atomic.", false)
+DECLARE_IGC_REGKEY(bool, StatelessToStatefullThroughSelectPhi, false, "Promote stateless accesses whose address is derived through select/phi of the same kernel argument", false)
+DECLARE_IGC_REGKEY(bool, StatelessToStatefullInSubroutines, false, "Promote stateless accesses in subroutines through pointer arguments that are the same kernel argument at all call sites", false)
+DECLARE_IGC_REGKEY(bool, EnableOptReportStatelessToStatefull, false, "Generate opt report file for stateless accesses StatelessToStatefull gives up on, and why", false)
 
 DECLARE_IGC_GROUP("Shader debugging")
 DECLARE_IGC_REGKEY(bool, ForceDisableShaderDebugHashCodeInKernel,   false,  "Disable hash code addition to the binary after EOT", false)
@@ -246,6 +263,7 @@ DECLARE_IGC_GROUP("Shader dumping")
 DECLARE_IGC_REGKEY(bool, EnableCosDump, false, "Enable cos dump", true)
 DECLARE_IGC_REGKEY(bool, EnableCisDump, false, "Enable cis dump", true)
 DECLARE_IGC_REGKEY(bool, DumpLLVMIR,                    false, "dump LLVM IR", true)
+DECLARE_IGC_REGKEY(bool, DisableDeferredMetaDataSave,   false, "Rewrite the igc.functions module metadata on every MetaDataUtils::save instead of only before IR dumps and module serialization", true)
 DECLARE_IGC_REGKEY(bool, QualityMetricsEnable,          false, "Enable Quality Metrics for IGC", true)
 DECLARE_IGC_REGKEY(bool, ShaderDumpEnable,              false, "dump LLVM IR, visaasm, and GenISA", true)
 DECLARE_IGC_REGKEY(bool, ShaderDumpEnableAll,           false, "dump all LLVM IR passes, visaasm, and GenISA", true)
@@ -257,12 +275,17 @@ DECLARE_IGC_REGKEY(bool, ShowFullVectorsInShaderDumps,  false, "print all elemen
 DECLARE_IGC_REGKEY(debugString, PrintAfter,             0,     "Take either all or comma/semicolon-separated list of pass names. If set, enable print LLVM IR after the given pass is done (mimic llvm print-after)", true)
 DECLARE_IGC_REGKEY(debugString, PrintBefore,            0,     "Take either all or comma/semicolon-separated list of pass names. If set, enable print LLVM IR before the given pass is done (mimic llvm print-before)", true)
 DECLARE_IGC_REGKEY(bool, InterleaveSourceShader,        true, "Interleave the source shader in asm dump", true)
+DECLARE_IGC_REGKEY(bool, AsyncShaderDump,               false, "Write shader dumps from a background thread instead of the compile thread", true)
+DECLARE_IGC_REGKEY(DWORD, AsyncShaderDumpQueueMB,       256,   "Most MB of dumps AsyncShaderDump queues before the compile thread waits for them to be written", true)
+DECLARE_IGC_REGKEY(bool, ShaderDumpArchive,             false, "Write all shader dumps, zlib compressed, into shader_dump.igcarchive in the dump folder; unpack with IGC/Scripts/extract_shader_dump_archive.py", true)
 DECLARE_IGC_REGKEY(bool, ShaderDumpPidDisable,          false, "disabled adding PID to the name of shader dump directory", true)
 DECLARE_IGC_REGKEY(bool, DumpToCurrentDir,              false, "dump shaders to the current directory", true)
 DECLARE_IGC_REGKEY(debugString, DumpToCustomDir,        0,     "Dump shaders to custom directory. Parent directory must exist.", true)
 DECLARE_IGC_REGKEY(bool, EnableShaderNumbering,         false, "Number shaders in the order they are dumped based on their hashes", true)
 DECLARE_IGC_REGKEY(bool, PrintToConsole,                false, "dump to console", true)
 DECLARE_IGC_REGKEY(bool, DumpCompilerStats,             false, "dump compiler statistics", true)
+DECLARE_IGC_REGKEY(bool, EnablePressureReport,          false, "With shader dumps, write a per-kernel register pressure and spill report (<asm name>_pressure.txt) from vISA GRF RA", true)
+DECLARE_IGC_REGKEY(bool, EnablePerfModelReport,         false, "Run the vISA static performance model and emit its per-kernel report into a .misc.perf_model section of zebin", true)
 DECLARE_IGC_REGKEY(bool, EnableCapsDump,                false, "Enable hardware caps dump", true)
 DECLARE_IGC_REGKEY(bool, EnableLivenessDump,            false, "Enable dumping out liveness info on stderr.", true)
 DECLARE_IGC_REGKEY(DWORD, ForceRPE,                     0,     "Force RPE (RegisterEstimator) computation if > 0. If 2, force RPE per inst.", true)
@@ -276,6 +299,7 @@ DECLARE_IGC_REGKEY(bool, EnableScalarizerDebugLog,      false, "print step by st
 DECLARE_IGC_REGKEY(bool, DumpTimeStats,                 false, "Timing of translation, code generation, finalizer, etc", true)
 DECLARE_IGC_REGKEY(bool, DumpTimeStatsCoarse,           false, "Only collect/dump coarse level time stats, i.e. skip opt detail timer for now", true)
 DECLARE_IGC_REGKEY(bool, DumpTimeStatsPerPass,          false, "Collect Timing of IGC/LLVM passes", true)
+DECLARE_IGC_REGKEY(bool, DumpPassStats,                 false, "Measure time and peak memory growth of every IGCPassManager pass and print a summary over all compilations at process exit", true)
 DECLARE_IGC_REGKEY(bool, DumpHasNonKernelArgLdSt,       false, "Print if hasNonKernelArg load/store to stderr", true)
 
 DECLARE_IGC_GROUP("Debugging features")
@@ -289,6 +313,7 @@ DECLARE_IGC_REGKEY(bool, EnableRelocations,             false, "Setting this to
 DECLARE_IGC_REGKEY(bool, EnableWriteOldFPToStack,       true,  "Setting this to 1 (true) writes the caller frame's frame-pointer to the start of callee's frame on stack, to support stack walk", false)
 DECLARE_IGC_REGKEY(bool, ZeBinCompatibleDebugging,      true,  "Setting this to 1 (true) enables embed debug info in zeBinary", true)
 DECLARE_IGC_REGKEY(bool, DebugInfoEnforceAmd64EM,       false, "Enforces elf file with the debug infomation to have eMachine set to AMD64", false)
+DECLARE_IGC_REGKEY(bool, DeferDwarfEmission,            false, "Setting this to 1 (true) skips DWARF generation and ships the vISA to Gen ISA debug mapping instead (patch token binaries only)", true)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLOptions,        0,     "Extra options for OpenCL", true)
 DECLARE_IGC_REGKEY(debugString, ExtraOCLInternalOptions, 0,    "Extra internal options for OpenCL", true)
 DECLARE_IGC_REGKEY(bool, UseVISAVarNames,               false, "Make VISA generate names for virtual variables so they match with dbg file", true)
@@ -302,27 +327,45 @@ DECLARE_IGC_REGKEY(bool, SendMultipleSIMDModesCS,       true,  "Send multiple SI
 DECLARE_IGC_REGKEY(DWORD, OCLSIMD16SelectionMask,       6,     "Select SIMD 16 heuristics. Valid values are 0, 1, 2 and 3", false)
 DECLARE_IGC_REGKEY(bool, EnableHSSinglePatchDispatch,   false, "Setting this to 1/true enables SIMD8 single-patch dispatch in HullShader. Default is either SIMD8 single patch/dual patch dispatch based on control point count", false)
 DECLARE_IGC_REGKEY(bool, DisableGPGPUIndirectPayload,   false, "Disable OCL indirect GPGPU payload", false)
+DECLARE_IGC_REGKEY(bool, DisableUnusedImplicitArgSkip,  false, "Allocate unused OCL implicit args such as local size or image width in the cross-thread payload", true)
+DECLARE_IGC_REGKEY(bool, EnableInKernelLocalIDs,        false, "Compute OCL local ids from the local thread id in r0.2 instead of loading them from the per-thread payload", true)
 DECLARE_IGC_REGKEY(bool, DisableDSDualPatch,            false, "Setting it to true with enable Single and Dual Patch dispatch mode for Domain Shader", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt,                 false, "Disable MemOpt, merging load/store", false)
 DECLARE_IGC_REGKEY(bool, DisableMemOpt2,                false, "Disable MemOpt2", false)
 DECLARE_IGC_REGKEY(bool, DisablePreRAScheduler,         false, "Disable Pre RA Scheduling", false)
 DECLARE_IGC_REGKEY(DWORD,MaxLiveOutThreshold,           0,     "Max LiveOut Threshold in MemOpt2", false)
 DECLARE_IGC_REGKEY(bool, DisableScalarAtomics,          false, "Disable the Scalar Atomics optimization", false)
+DECLARE_IGC_REGKEY(bool, EnableAtomicAggregation,       false, "Issue one atomic per distinct address for add/min/max atomics with a non-uniform address", true)
+DECLARE_IGC_REGKEY(DWORD,AtomicAggregationMaxIterations, 4,    "Number of distinct addresses aggregated by EnableAtomicAggregation before falling back to per-lane atomics", true)
 DECLARE_IGC_REGKEY(bool, EnableSelectiveScalarizer,     false,  "enable selective scalarizer on GPGPU path", true)
+DECLARE_IGC_REGKEY(bool, EnableUniformVectorALU,       false,  "With selective scalarizer, keep uniform 32-bit vector ALU ops packed and emit them as one SIMD1 instruction", false)
 DECLARE_IGC_REGKEY(bool, HoistPSConstBufferValues,      true,  "Hoists up down converts for contant buffer accesses, so they an be vectorized more easily.", false)
 DECLARE_IGC_REGKEY(bool, EnableSingleVertexDispatch,    false, "Vertex Shader Single Patch Dispatch Regkey", false)
 DECLARE_IGC_REGKEY(bool, allowLICM,                     true,  "Enable LICM in IGC.", false)
 DECLARE_IGC_REGKEY(DWORD, CSSpillThresholdSLM,          9,    "Spill Threshold for CS SIMD16 with SLM", false)
 DECLARE_IGC_REGKEY(DWORD, CSSpillThresholdNoSLM,        5,     "Spill Threshold for CS SIMD16 without SLM", false)
 DECLARE_IGC_REGKEY(DWORD, AllowedSpillRegCount,         0,     "Max allowed spill size without recompile", false)
+DECLARE_IGC_REGKEY(bool, EnableSpillPrediction,         false, "Skip SIMD variants that may be dropped on spill when the estimated register pressure predicts a spill", false)
+DECLARE_IGC_REGKEY(DWORD, SpillPredictionThreshold,     150,   "Estimated register pressure, in percent of the GRF file, above which a SIMD variant is predicted to spill", false)
+DECLARE_IGC_REGKEY(bool, DumpSpillPrediction,           false, "Print the spill prediction of every SIMD variant along with the spill size reported by vISA", false)
 DECLARE_IGC_REGKEY(DWORD, LICMStatThreshold,            70,    "LICM stat threshold to avoid retry SIMD16 for CS", false)
 DECLARE_IGC_REGKEY(bool, EnableTypeDemotion,            true,  "Enable Type Demotion", false)
 DECLARE_IGC_REGKEY(bool, EnablePreRARematFlag,          true,  "Enable PreRA Rematerialization of Flag", false)
 DECLARE_IGC_REGKEY(bool, EnableGASResolver,             true,  "Enable GAS Resolver", false)
 DECLARE_IGC_REGKEY(bool, EnableLowerGPCallArg,          true,  "Enable pass to lower generic pointers in function arguments", false)
+DECLARE_IGC_REGKEY(bool, EnableGASCallSpecialization,   false, "Clone functions with generic pointer arguments per origin address space of their call sites", false)
+DECLARE_IGC_REGKEY(DWORD, GASCallSpecializationMaxClones, 4,   "Maximum number of address space specialized clones of a function", false)
 DECLARE_IGC_REGKEY(bool, DisableRecompilation,          false, "Disable recompilation", false)
+DECLARE_IGC_REGKEY(bool, EnableRetrySnapshot,           true,  "Restart OCL recompilation from a bitcode snapshot of the unified module instead of re-parsing the input and re-linking builtins", false)
+DECLARE_IGC_REGKEY(DWORD, CompileTimeBudgetLowPercent,  50,    "Percentage of the -intel-compile-time-budget after which OCL compilation switches to cheaper strategies", false)
+DECLARE_IGC_REGKEY(bool, EnableLLVMContextReuse,        false, "Reuse the LLVM context of the previous OCL compilation on the same thread", false)
+DECLARE_IGC_REGKEY(DWORD, LLVMContextReuseLimit,        32,    "Number of OCL compilations after which a reused LLVM context is replaced by a new one", false)
 DECLARE_IGC_REGKEY(bool, SampleMultiversioning,         false, "Create branches aroung samplers which can be redundant with some values", false)
 DECLARE_IGC_REGKEY(bool, EnableSMRescheduling,          false, "Change instruction order to enable extra Sample Multiversioning cases", false)
+DECLARE_IGC_REGKEY(debugString, ShaderProfileDir,       0,     "Directory with runtime-measured block profiles (<asm hash>.prof) used to weight sample multiversioning, sample gating and code sinking", false)
+DECLARE_IGC_REGKEY(DWORD, ProfileDivergenceThreshold,    50,    "Percentage of partial-lane executions from which a profiled block is treated as divergent", false)
+DECLARE_IGC_REGKEY(bool, DumpShaderProfileIds,          false, "Dump the stable block ids profiles are keyed by to <asm hash>.profids in the shader dump folder", false)
+DECLARE_IGC_REGKEY(bool, ShaderProfileInstrumentation,  false, "Count OpenCL block executions into the __igc_block_profile program scope buffer and dump its layout to <asm hash>.proflayout in the shader dump folder", false)
 DECLARE_IGC_REGKEY(bool, DisableEarlyOutPatterns,       false, "Disable optimization trying to create an early out after sampleC messages", false)
 DECLARE_IGC_REGKEY(DWORD, EarlyOutPatternSelectPS,      0xff,  "Each bit selects a pattern match to enable/disable.", false)
 DECLARE_IGC_REGKEY(DWORD, EarlyOutPatternSelectCS,      0x8,   "Each bit selects a pattern match to enable/disable.", false)
@@ -331,8 +374,13 @@ DECLARE_IGC_REGKEY(bool, EnableOCLScratchPrivateMemory, true,  "Enable the use o
 DECLARE_IGC_REGKEY(bool, EnableMaxWGSizeCalculation,    true,  "Enable max work group size calculation [OCL only]", true)
 DECLARE_IGC_REGKEY(bool, Enable64BitEmulation,          false, "Enable 64-bit emulation", false)
 DECLARE_IGC_REGKEY(bool, Enable64BitEmulationOnSelectedPlatform, true, "Enable 64-bit emulation on selected platforms", false)
+DECLARE_IGC_REGKEY(bool, EnableNarrow64BitOps,          true, "Narrow 64-bit integer operations whose value ranges fit in 32 bits before 64-bit emulation", false)
+DECLARE_IGC_REGKEY(bool, EnableInvariantIntDivReduction, true, "Enables strength reduction on 32-bit integer division/remainder by loop-invariant divisors", false)
 DECLARE_IGC_REGKEY(DWORD, EnableConstIntDivReduction,   0x1,   "Enables strength reduction on integer division/remainder with constant divisors/moduli", true)
 DECLARE_IGC_REGKEY(DWORD, EnableIntDivRemCombine,       0x0,   "Given div/rem pairs with same operands merged; replace rem with mul+sub on quotient; 0x3 (set bit[1]) forces this on constant power of two divisors as well", true)
+DECLARE_IGC_REGKEY(DWORD, InstCombineFastModeThreshold, 20000, "IGCInstCombiner runs in fast mode on functions with at least this many instructions: no expensive or deep compare combines, bounded iterations and worklist visits. 0 disables fast mode", false)
+DECLARE_IGC_REGKEY(DWORD, InstCombineFastModeMaxIterations, 2, "Maximum number of IGCInstCombiner iterations over a function in fast mode", false)
+DECLARE_IGC_REGKEY(DWORD, InstCombineFastModeVisitsPerInst, 4, "Worklist visit budget of one IGCInstCombiner iteration in fast mode, per instruction of the function", false)
 DECLARE_IGC_REGKEY(bool, EnableRecursionOpenCL,         true,  "Enable recursion with OpenCL user functions", false)
 DECLARE_IGC_REGKEY(bool, ForceDPEmulation,              false, "Force double emulation for testing purpose", false)
 DECLARE_IGC_REGKEY(bool, EnableDPEmulation,             false, "Enforce double precision floating point operations emulation on platforms that do not support it natively", true)
@@ -343,6 +391,7 @@ DECLARE_IGC_REGKEY(bool, EnableFallbackToBindless,      true,  "This key enables
 DECLARE_IGC_REGKEY(bool, EnableFallbackToStateless,     true,  "This key enables fallback to stateless mode on all shaders", false)
 DECLARE_IGC_REGKEY(bool, DisablePromoteToDirectAS,      false, "This key disables the PromoteResourceToDirectAS pass", false)
 DECLARE_IGC_REGKEY(bool, EnableAdvCodeMotion,           true,  "Enable advanced code motion", false)
+DECLARE_IGC_REGKEY(bool, EnableLoopInvariantLoadMotion, false, "Hoist loop-invariant loads out of loops with barriers, fences or atomics not synchronizing their address space", false)
 DECLARE_IGC_REGKEY(bool, AdvCodeMotionControl,          true,  "Control bits to fine-tune advanced code motion", false)
 DECLARE_IGC_REGKEY(bool, EnableAdvRuntimeUnroll,        true,  "Enable advanced runtime unroll", false)
 DECLARE_IGC_REGKEY(bool, AdvRuntimeUnrollCount,         false, "Advanced runtime unroll count", false)
@@ -353,6 +402,8 @@ DECLARE_IGC_REGKEY(bool, EnableIndirectCallOptimization, true, "Enables inlining
 DECLARE_IGC_REGKEY(bool, ForceFFIDOverwrite,            false, "Force overwriting ffid in sr0.0", false)
 DECLARE_IGC_REGKEY(bool, EnableReadGTPinInput,          true,  "Enables setting GTPin context flags by reading the input to the compiler adapters", false)
 DECLARE_IGC_REGKEY(bool, EnableRuntimeFuncAttributePatching, false,  "Creates a relocation entry to let runtime calculate the max call depth and patch required scratch space usage", true)
+DECLARE_IGC_REGKEY(bool, EnableCallGraphStackSize,      true,   "Size the per-work-item stack of kernels with stack calls from the deepest call chain instead of the largest stack-call function of the module", false)
+DECLARE_IGC_REGKEY(DWORD, StackCallFrameReserve,        2048,   "Per-work-item bytes reserved in each stack-call frame for arguments, return values and register saves and spills", false)
 DECLARE_IGC_REGKEY(bool, ForceStaticToDynamic,          false,  "Force write of vertex count in GS", false)
 DECLARE_IGC_REGKEY(bool, DisableWaSampleLZ,             false,  "Disable The Sample Lz workaround and generate Sample LZ", false)
 DECLARE_IGC_REGKEY(DWORD, OverrideRevIdForWA,           0xff,   "Enable this to override the stepping/RevId, default is a0 = 0, b0 = 1, c0 = 2, so on...", false)
@@ -362,6 +413,10 @@ DECLARE_IGC_REGKEY(DWORD, OverrideProductFamilyForWA,     0,   "Enable this to o
 
 DECLARE_IGC_REGKEY(bool, EnableGlobalStateBuffer,              false, "This key allows stack calls to read implicit args from side buffer. It also emits a relocatable add in VISA.", true)
 DECLARE_IGC_REGKEY(bool, LateInlineUnmaskedFunc,        false, "Postpone inlining of Unmasked functions till end of CG to avoid code movement inside/outside of unmasked region", false)
+DECLARE_IGC_REGKEY(bool, EnableProgramCache,            false, "Enable the persistent on-disk cache of OpenCL program binaries, keyed by a hash of the input, options, spec constants, platform and IGC build", true)
+DECLARE_IGC_REGKEY(debugString, ProgramCacheDir,        0,     "Directory used by EnableProgramCache. Parent directory must exist. Defaults to igc_cache in the system temp directory.", true)
+DECLARE_IGC_REGKEY(DWORD, SPIRVParallelTranslationThreads, 0,  "Number of threads translating SPIR-V function bodies into separate LLVM modules that are then linked in module order. 0 or 1 translates on the compiling thread", false)
+DECLARE_IGC_REGKEY(DWORD, SPIRVParallelTranslationMinFunctions, 64, "Minimum number of SPIR-V functions for SPIRVParallelTranslationThreads to take effect", false)
 
 DECLARE_IGC_GROUP("Performance experiments")
 DECLARE_IGC_REGKEY(bool, ForceNonCoherentStatelessBTI,  false, "Enable gneeration of non cache coherent stateless messages", false)
@@ -389,6 +444,7 @@ DECLARE_IGC_REGKEY(DWORD, ForceGroupSizeShaderHash,     0, "Shader hash for forc
 DECLARE_IGC_REGKEY(DWORD, ForceGroupSizeX,              8, "force group size along X", false)
 DECLARE_IGC_REGKEY(DWORD, ForceGroupSizeY,              8, "force group size along Y", false)
 DECLARE_IGC_REGKEY(bool, EnableThreadCombiningWithNoSLM, false, "Enable thread combining opt for shader without SLM", false)
+DECLARE_IGC_REGKEY(bool, DisableThreadCombiningCostModel, false, "Combine threads on occupancy gain alone, ignoring the barrier and loop overhead of the combined kernel", false)
 DECLARE_IGC_REGKEY(DWORD, SubroutineThreshold,          110000, "Minimal kernel size to enable subroutines", false)
 DECLARE_IGC_REGKEY(DWORD, SubroutineInlinerThreshold,   3000, "Subroutine inliner threshold", false)
 DECLARE_IGC_REGKEY(bool, ControlKernelTotalSize,        true, "Control kernel total size", true)
@@ -397,6 +453,8 @@ DECLARE_IGC_REGKEY(DWORD, ControlInlineTinySize,        200, "Tiny function size
 DECLARE_IGC_REGKEY(DWORD, PrintControlKernelTotalSize,  0, "Print Control kernel total size", true)
 DECLARE_IGC_REGKEY(bool, AddNoInlineToTrimmedFunctions, false, "Tell late passes not to inline trimmed functions", false)
 DECLARE_IGC_REGKEY(DWORD, KernelTotalSizeThreshold,     50000, "Trimming target of kernel total size", true)
+DECLARE_IGC_REGKEY(bool, EnableInlineCostModel,         false, "Order kernel size trimming by a cost model of call-site frequency, callee GRF pressure, constant arguments and code footprint instead of size only", false)
+DECLARE_IGC_REGKEY(bool, DumpInlineCostModel,           false, "Dump inline cost model decisions to InlineCostModel.txt in the shader dump folder", false)
 DECLARE_IGC_REGKEY(bool, EnableConstantPromotion,       true, "Enable global constant data to register promotion", false)
 DECLARE_IGC_REGKEY(bool, AllowNonLoopConstantPromotion, false, "Allows promotion for constants not in loop (e.g. used once)", false)
 DECLARE_IGC_REGKEY(DWORD, ConstantPromotionSize,        2, "Threshold in number of GRFs", false)
@@ -449,6 +507,8 @@ DECLARE_IGC_REGKEY(bool, ForceSWCoalescingOfAtomicCounter, false, "Force softwar
 DECLARE_IGC_REGKEY(bool, ForceMixMode, false, "force enable mix mode even on platforms that do not support it", false)
 DECLARE_IGC_REGKEY(bool, DisableFDIV, false, "Disable fdiv support", false)
 DECLARE_IGC_REGKEY(bool, EmulateFDIV, false, "Emulate fdiv instructions", false)
+DECLARE_IGC_REGKEY(bool, EnableNativeHalfArithmetic, true, "Do float math on halves extended from half and truncated back to half natively in half", false)
+DECLARE_IGC_REGKEY(bool, ForceNativeHalfArithmetic, false, "Also do chains of such float math in half without fast math, rounding each operation to half", false)
 DECLARE_IGC_REGKEY(bool, UpConvertF16Sampler, true, "up-convert fp16 sampler mesasge to return fp32", false)
 DECLARE_IGC_REGKEY(bool, FuseTypedWrite, true, "Enable fusing of simd8 typed write", false)
 DECLARE_IGC_REGKEY(bool, EnableUndefAlphaOutputAsRed, true, "Output red for undefined alpha output", false)
@@ -462,9 +522,14 @@ DECLARE_IGC_REGKEY(bool, EnableTEFactorsPadding, true,  "Enable padding of the T
 DECLARE_IGC_REGKEY(bool, EnableTEFactorsClear, true,  "Enable clearing of tessellation factors.", false)
 DECLARE_IGC_REGKEY(bool, EnableSubroutineForEmulation,  true,  "Enable subroutine call support when emulation(double) is on. Heuristic decides which use subroutine calls.", false)
 DECLARE_IGC_REGKEY(bool, ForceSubroutineForEmulation,   false,  "Force subroutine call for all emulation functions if emulation(double) is on.", false)
+DECLARE_IGC_REGKEY(bool, EnableDPEmulationFastPath,     true,  "Inline double emulation add/sub/mul/div for non-denormal inputs and call a subroutine only for denormal inputs", false)
 DECLARE_IGC_REGKEY(DWORD, InlinedEmulationThreshold,    125000, "Inlined instruction threshold for enabling subroutines", false)
 DECLARE_IGC_REGKEY(int, ByPassAllocaSizeHeuristic,   0,  "Force some Alloca to pass the pressure heuristic until the given size", false)
+DECLARE_IGC_REGKEY(bool, EnablePromoteSmallIndexedPrivArray, false, "Promote small dynamically indexed private arrays to GRF regardless of the alloca size threshold, subject to register pressure", false)
+DECLARE_IGC_REGKEY(DWORD, PromoteSmallIndexedPrivArrayMaxElements, 64, "Maximum number of elements of a dynamically indexed private array promoted by EnablePromoteSmallIndexedPrivArray", false)
 DECLARE_IGC_REGKEY(DWORD, MemOptWindowSize,   150,  "Size of the window in unit of instructions in which load/stores are allowed to be coalesced. Keep it limited in order to avoid creating long liveranges. Default value is 150", false)
+DECLARE_IGC_REGKEY(bool, EnableMemOptCrossBB, false, "Enable MemOpt to merge loads/stores across control-equivalent basic blocks", false)
+DECLARE_IGC_REGKEY(bool, EnableMemOptBaseIndex, false, "Enable MemOpt to search merge candidates through an index of memory references per base pointer instead of a fixed window", false)
 DECLARE_IGC_REGKEY(bool, ForceNoFP64bRegioning, false, "force regioning rules for FP and 64b FPU instructions", false)
 DECLARE_IGC_REGKEY(bool, EmitDebugRanges, true, "Emit .debug_ranges section when instructions in a block are non-consecutive", false)
 DECLARE_IGC_REGKEY(bool, EmitDebugLoc, true, "Enable generation of .debug_loc section", false)
@@ -485,6 +550,8 @@ DECLARE_IGC_REGKEY(bool, EmitPreDefinedForAllFunctions, false, "When enabled, pr
 
 DECLARE_IGC_REGKEY(bool, EnableZEBinary, false,  "Enable output in ZE binary format", true)
 DECLARE_IGC_REGKEY(bool, AllocateZeroInitializedVarsInBss, false,  "Allocate zero initialized global variables in .bss section in ZEBinary", true)
+DECLARE_IGC_REGKEY(bool, ZeBinCompressSections, false,  "Compress debug, vISA asm and SPIR-V sections in ZEBinary with zlib (SHF_COMPRESSED)", true)
+DECLARE_IGC_REGKEY(bool, ZeBinShareIdenticalKernels, false,  "Store byte-identical kernel .text sections in ZEBinary once, with all their section headers pointing at the same data", true)
 DECLARE_IGC_REGKEY(DWORD, OverrideOCLMaxParamSize, 0,  "Override the value imposed on the kernel by CL_DEVICE_MAX_PARAMETER_SIZE. Value in bytes, if value==0 no override happens.", true)
 
 DECLARE_IGC_REGKEY(bool, EnableOptReportPrivateMemoryToSLM, false, "[POC] Generate opt report file for moving private memory allocations to SLM.", false)
@@ -33,6 +33,7 @@ SPDX-License-Identifier: MIT
 #include <utility>
 #include <fstream>
 #include <sstream>
+#include <atomic>
 #include <mutex>
 #include "Probe/Assertion.h"
 
@@ -820,7 +821,13 @@ void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
 {
     // only load the debug flags once before compiling to avoid any multi-threading issue
     static std::mutex loadFlags;
-    static volatile bool flagsSet = false;
+    static std::atomic<bool> flagsLoaded(false);
+    static bool flagsSet = false;
+    // every compilation calls this; skip the lock once the flags are loaded
+    if (flagsLoaded.load(std::memory_order_acquire))
+    {
+        return;
+    }
     loadFlags.lock();
     if(!flagsSet)
     {
@@ -921,6 +928,7 @@ void LoadRegistryKeys(const std::string& options, bool *RegFlagNameError)
             // Non-valid value is ignored (using default).
             IGC_SET_FLAG_VALUE(ForceOCLSIMDWidth, 0);
         }
+        flagsLoaded.store(true, std::memory_order_release);
     }
     loadFlags.unlock();
 }
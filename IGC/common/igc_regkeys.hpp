@@ -72,7 +72,7 @@ struct SRegKeyVariableMetaData_##regkeyName : public SRegKeyVariableMetaData \
     {                                               \
         return #regkeyName;                         \
     }                                               \
-    unsigned GetDefault() const                     \
+    unsigned GetDefault() const final               \
     {                                               \
         return (unsigned)defaultValue;              \
     }                                               \
@@ -84,7 +84,7 @@ struct SRegKeyVariableMetaData_##regkeyName : public SRegKeyVariableMetaData \
     {                                               \
         m_isSetToNonDefaultValue = true;            \
     }                                               \
-    bool IsReleaseMode() const                      \
+    static constexpr bool IsReleaseMode()           \
     {                                               \
         return releaseMode;                         \
     }                                               \
@@ -100,22 +100,29 @@ struct SRegKeysList
 #undef DECLARE_IGC_REGKEY
 bool CheckHashRange(const std::vector<HashRange>&);
 extern SRegKeysList g_RegKeyList;
+// Regkeys are read on hot paths, and hash ranges are rarely given: only call
+// CheckHashRange, which compares with the thread local hash of the current
+// shader, when the key has some.
+#define IGC_REGKEY_IN_HASH_RANGE(name)           \
+  (g_RegKeyList.name.hashes.empty() || CheckHashRange(g_RegKeyList.name.hashes))
 #if defined(LINUX_RELEASE_MODE)
+// IsReleaseMode() is checked first so that keys not available in release
+// fold to their default value at compile time.
 #define IGC_GET_FLAG_VALUE(name)                 \
-  ((CheckHashRange(g_RegKeyList.name.hashes) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+  ((g_RegKeyList.name.IsReleaseMode() && IGC_REGKEY_IN_HASH_RANGE(name)) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
 #define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  ((CheckHashRange(g_RegKeyList.name.hashes) && g_RegKeyList.name.IsReleaseMode()) ? g_RegKeyList.name.m_string : "")
+  ((g_RegKeyList.name.IsReleaseMode() && IGC_REGKEY_IN_HASH_RANGE(name)) ? g_RegKeyList.name.m_string : "")
 #else
 #define IGC_GET_FLAG_VALUE(name)                 \
-  (CheckHashRange(g_RegKeyList.name.hashes) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
+  (IGC_REGKEY_IN_HASH_RANGE(name) ? g_RegKeyList.name.m_Value : g_RegKeyList.name.GetDefault())
 #define IGC_IS_FLAG_ENABLED(name)                (IGC_GET_FLAG_VALUE(name) != 0)
 #define IGC_IS_FLAG_DISABLED(name)               (!IGC_IS_FLAG_ENABLED(name))
 #define IGC_SET_FLAG_VALUE(name, regkeyValue)    (g_RegKeyList.name.m_Value = regkeyValue)
 #define IGC_GET_REGKEYSTRING(name)               \
-  (CheckHashRange(g_RegKeyList.name.hashes) ? g_RegKeyList.name.m_string : "")
+  (IGC_REGKEY_IN_HASH_RANGE(name) ? g_RegKeyList.name.m_string : "")
 #endif
 
 #define IGC_REGKEY_OR_FLAG_ENABLED(name, flag) (IGC_IS_FLAG_ENABLED(name) || IGC::Debug::GetDebugFlag(IGC::Debug::DebugFlag::flag))
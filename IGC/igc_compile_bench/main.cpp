@@ -0,0 +1,584 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+// igc_compile_bench - replays a corpus of SPIR-V / LLVM inputs through the
+// IGC shared library with fixed options and reports compile time and code
+// quality per input as CSV, optionally compared against a previous report.
+//
+// Every input is compiled -repeat times through the same CIF entry points
+// the OpenCL runtime uses. Times are the median over the runs, code quality
+// metrics come from the translation telemetry of the last run.
+//
+// With -threads N it instead measures how compilation scales: the whole
+// corpus is compiled -repeat times by each of 1, 2, 4, ... N threads at once,
+// and every binary must be identical to the one of a first single-threaded
+// compile. The report has one row per thread count with the throughput and
+// the contention on every IGC global lock over that step.
+
+#include "common/LLVMWarningsPush.hpp"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "common/LLVMWarningsPop.hpp"
+
+#include "cif/common/cif_main.h"
+#include "cif/common/library_handle.h"
+#include "cif/import/cif_main.h"
+#include "cif/builtins/memory/buffer/buffer.h"
+#include "ocl_igc_interface/igc_ocl_device_ctx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string>
+    InputFilenames(cl::Positional, cl::desc("<input .spv/.bc/.ll files>"), cl::OneOrMore);
+static cl::opt<std::string>
+    LibraryPath("lib", cl::desc("IGC shared library to benchmark"), cl::init(IGC_COMPILE_BENCH_DEFAULT_LIBRARY));
+static cl::opt<std::string>
+    Options("options", cl::desc("build options passed with every input"), cl::init(""));
+static cl::opt<std::string>
+    InternalOptions("internal_options", cl::desc("internal options passed with every input"), cl::init(""));
+static cl::opt<std::string>
+    Device("device", cl::desc("<productFamily>.<deviceId>.<revId> of the target, in hex"), cl::Required);
+static cl::opt<unsigned>
+    RenderCore("core", cl::desc("GFXCORE_FAMILY of the target"), cl::Required);
+static cl::opt<unsigned>
+    Repeat("repeat", cl::desc("number of compilations of each input"), cl::init(5));
+static cl::opt<std::string>
+    OutputFilename("o", cl::desc("write the CSV report to this file instead of stdout"), cl::init("-"));
+static cl::opt<std::string>
+    BaselineFilename("baseline", cl::desc("CSV report to compare against"), cl::init(""));
+static cl::opt<double>
+    TimeThreshold("time-threshold", cl::desc("time increase, in percent, reported as a regression"), cl::init(5.0));
+static cl::opt<unsigned>
+    Threads("threads", cl::desc("measure scaling by compiling the corpus from 1 up to this many threads at once"), cl::init(0));
+
+// Columns of the report after the input name. "wall_us" is measured here,
+// the others are the names of the translation telemetry entries.
+static const char* const Metrics[] = {
+    "wall_us", "total_us", "optimize_ir_us", "codegen_us", "peak_memory_kb",
+    "retries", "kernels", "spilled_kernels", "spill_size_bytes",
+    "instructions", "cycles", "grf_spills", "grf_fills",
+};
+static const size_t NumMetrics = sizeof(Metrics) / sizeof(Metrics[0]);
+
+using MetricValues = std::vector<uint64_t>;
+using Report = std::map<std::string, MetricValues>;
+
+static bool isTimeMetric(StringRef name)
+{
+    return name.endswith("_us");
+}
+
+static int findMetric(StringRef name)
+{
+    for (size_t i = 0; i < NumMetrics; i++)
+    {
+        if (name == Metrics[i])
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+static bool getCodeType(StringRef filename, IGC::CodeType::CodeType_t& codeType)
+{
+    StringRef ext = sys::path::extension(filename);
+    if (ext == ".spv")
+        codeType = IGC::CodeType::spirV;
+    else if (ext == ".bc")
+        codeType = IGC::CodeType::llvmBc;
+    else if (ext == ".ll")
+        codeType = IGC::CodeType::llvmLl;
+    else
+        return false;
+    return true;
+}
+
+// Parses the "name=value" lines of the translation telemetry into values.
+static void parseTelemetry(StringRef telemetry, MetricValues& values)
+{
+    SmallVector<StringRef, 16> lines;
+    telemetry.split(lines, '\n', -1, false);
+    for (StringRef line : lines)
+    {
+        auto nameAndValue = line.split('=');
+        int idx = findMetric(nameAndValue.first);
+        uint64_t value = 0;
+        if (idx >= 0 && !nameAndValue.second.getAsInteger(10, value))
+            values[idx] = value;
+    }
+}
+
+static uint64_t median(std::vector<uint64_t> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static bool setupDevice(IGC::IgcOclDeviceCtxTagOCL& deviceCtx)
+{
+    unsigned productFamily = 0, deviceId = 0, revId = 0;
+    if (sscanf(Device.c_str(), "%x.%x.%x", &productFamily, &deviceId, &revId) != 3)
+    {
+        errs() << "invalid -device, expected <productFamily>.<deviceId>.<revId>\n";
+        return false;
+    }
+
+    auto platform = deviceCtx.GetPlatformHandle();
+    auto gtSystemInfo = deviceCtx.GetGTSystemInfoHandle();
+    if (!platform || !gtSystemInfo)
+        return false;
+    platform->SetProductFamily(productFamily);
+    platform->SetRenderCoreFamily(RenderCore);
+    platform->SetDeviceID(static_cast<unsigned short>(deviceId));
+    platform->SetRevId(static_cast<unsigned short>(revId));
+
+    // Code generation only depends on the topology for a few heuristics;
+    // use a fixed mid-size configuration so reports stay comparable.
+    gtSystemInfo->SetEUCount(96);
+    gtSystemInfo->SetThreadCount(96 * 7);
+    gtSystemInfo->SetSliceCount(1);
+    gtSystemInfo->SetSubSliceCount(6);
+    gtSystemInfo->SetMaxEuPerSubSlice(16);
+    gtSystemInfo->SetMaxSlicesSupported(1);
+    gtSystemInfo->SetMaxSubSlicesSupported(6);
+    return true;
+}
+
+static std::unique_ptr<MemoryBuffer> loadInput(const std::string& filename, IGC::CodeType::CodeType_t& inType)
+{
+    if (!getCodeType(filename, inType))
+    {
+        errs() << filename << ": unknown input type\n";
+        return nullptr;
+    }
+
+    auto fileOrErr = MemoryBuffer::getFile(filename);
+    if (!fileOrErr)
+    {
+        errs() << filename << ": " << fileOrErr.getError().message() << "\n";
+        return nullptr;
+    }
+    return std::move(*fileOrErr);
+}
+
+static bool compileInput(CIF::CIFMain& cifMain, IGC::IgcOclDeviceCtxTagOCL& deviceCtx,
+    const std::string& filename, MetricValues& values)
+{
+    IGC::CodeType::CodeType_t inType;
+    auto inputBuffer = loadInput(filename, inType);
+    if (!inputBuffer)
+        return false;
+    const MemoryBuffer& input = *inputBuffer;
+
+    auto translationCtx = deviceCtx.CreateTranslationCtx(inType, IGC::CodeType::oclGenBin);
+    if (!translationCtx)
+    {
+        errs() << filename << ": could not create translation context\n";
+        return false;
+    }
+
+    std::vector<uint64_t> samples[NumMetrics];
+    for (unsigned run = 0; run < Repeat; run++)
+    {
+        auto src = CIF::Builtins::CreateConstBuffer(&cifMain, input.getBufferStart(), input.getBufferSize());
+        auto options = CIF::Builtins::CreateConstBuffer(&cifMain, Options.c_str(), Options.size());
+        auto internalOptions = CIF::Builtins::CreateConstBuffer(&cifMain, InternalOptions.c_str(), InternalOptions.size());
+
+        const auto start = std::chrono::steady_clock::now();
+        auto output = translationCtx->Translate(src.get(), options.get(), internalOptions.get(), nullptr, 0);
+        const auto wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        if (!output || !output->Successful())
+        {
+            errs() << filename << ": compilation failed\n";
+            if (output && output->GetBuildLog()->GetSizeRaw() > 0)
+                errs() << output->GetBuildLog()->GetMemory<char>() << "\n";
+            return false;
+        }
+
+        MetricValues runValues(NumMetrics, 0);
+        runValues[0] = static_cast<uint64_t>(wallUs);
+        auto telemetry = output->GetTelemetry();
+        if (telemetry->GetSizeRaw() > 0)
+            parseTelemetry(StringRef(telemetry->GetMemory<char>(), telemetry->GetSizeRaw() - 1), runValues);
+
+        for (size_t i = 0; i < NumMetrics; i++)
+        {
+            samples[i].push_back(runValues[i]);
+        }
+    }
+
+    values.assign(NumMetrics, 0);
+    for (size_t i = 0; i < NumMetrics; i++)
+    {
+        values[i] = isTimeMetric(Metrics[i]) ? median(samples[i]) : samples[i].back();
+    }
+    return true;
+}
+
+static void writeReport(raw_ostream& os, const std::vector<std::pair<std::string, MetricValues>>& rows)
+{
+    os << "input";
+    for (auto metric : Metrics)
+    {
+        os << "," << metric;
+    }
+    os << "\n";
+    for (auto& row : rows)
+    {
+        os << row.first;
+        for (auto value : row.second)
+        {
+            os << "," << value;
+        }
+        os << "\n";
+    }
+}
+
+// Reads a report written by writeReport. Columns are matched by name, so
+// reports from older versions of the tool can still be compared.
+static bool readReport(const std::string& filename, Report& report)
+{
+    std::ifstream is(filename);
+    if (!is)
+        return false;
+
+    std::string line;
+    std::vector<int> columns;
+    if (std::getline(is, line))
+    {
+        SmallVector<StringRef, 16> names;
+        StringRef(line).split(names, ',');
+        for (size_t i = 1; i < names.size(); i++)
+        {
+            columns.push_back(findMetric(names[i]));
+        }
+    }
+    while (std::getline(is, line))
+    {
+        SmallVector<StringRef, 16> fields;
+        StringRef(line).split(fields, ',');
+        if (fields.empty() || fields[0].empty())
+            continue;
+        MetricValues values(NumMetrics, 0);
+        for (size_t i = 1; i < fields.size() && i - 1 < columns.size(); i++)
+        {
+            uint64_t value = 0;
+            if (columns[i - 1] >= 0 && !fields[i].getAsInteger(10, value))
+                values[columns[i - 1]] = value;
+        }
+        report[fields[0].str()] = values;
+    }
+    return true;
+}
+
+// Prints the metrics that got worse compared to the baseline and returns
+// the number of regressions. Times regress when they grow by more than
+// -time-threshold percent; code quality metrics regress on any increase.
+static unsigned compareReports(const std::vector<std::pair<std::string, MetricValues>>& rows, const Report& baseline)
+{
+    unsigned numRegressions = 0;
+    for (auto& row : rows)
+    {
+        auto it = baseline.find(row.first);
+        if (it == baseline.end())
+        {
+            errs() << row.first << ": not in baseline\n";
+            continue;
+        }
+        for (size_t i = 0; i < NumMetrics; i++)
+        {
+            uint64_t base = it->second[i];
+            uint64_t cur = row.second[i];
+            // Peak memory is a process high-water mark and retries follow
+            // the kernels' spill decisions; neither is a regression by itself.
+            if (StringRef(Metrics[i]) == "peak_memory_kb" || StringRef(Metrics[i]) == "retries")
+                continue;
+            bool regressed = isTimeMetric(Metrics[i]) ?
+                cur > base * (1.0 + TimeThreshold / 100.0) : cur > base;
+            if (!regressed)
+                continue;
+            double change = base ? 100.0 * (double(cur) - double(base)) / double(base) : 100.0;
+            errs() << row.first << ": " << Metrics[i] << " " << base << " -> " << cur
+                   << " (+" << format("%.1f", change) << "%)\n";
+            numRegressions++;
+        }
+    }
+    return numRegressions;
+}
+
+struct CorpusEntry
+{
+    std::string filename;
+    IGC::CodeType::CodeType_t inType;
+    std::unique_ptr<MemoryBuffer> input;
+    // binary of the first compilation, which every later one must match
+    std::string reference;
+};
+
+// "<lock name>.<counter>" -> value, from the "lock." telemetry entries.
+// The counters are process-wide totals, so the largest value seen is the
+// most recent one.
+using LockCounters = std::map<std::string, uint64_t>;
+
+struct WorkerResult
+{
+    bool failed = false;
+    std::set<std::string> mismatches;
+    LockCounters locks;
+};
+
+static void parseLockCounters(StringRef telemetry, LockCounters& counters)
+{
+    SmallVector<StringRef, 64> lines;
+    telemetry.split(lines, '\n', -1, false);
+    for (StringRef line : lines)
+    {
+        if (!line.startswith("lock."))
+            continue;
+        auto nameAndValue = line.drop_front(5).split('=');
+        uint64_t value = 0;
+        if (nameAndValue.second.getAsInteger(10, value))
+            continue;
+        uint64_t& counter = counters[nameAndValue.first.str()];
+        counter = std::max(counter, value);
+    }
+}
+
+static bool translate(CIF::CIFMain& cifMain, IGC::IgcOclDeviceCtxTagOCL& deviceCtx,
+    const CorpusEntry& entry, std::string& binary, LockCounters& locks)
+{
+    auto translationCtx = deviceCtx.CreateTranslationCtx(entry.inType, IGC::CodeType::oclGenBin);
+    if (!translationCtx)
+        return false;
+
+    auto src = CIF::Builtins::CreateConstBuffer(&cifMain, entry.input->getBufferStart(), entry.input->getBufferSize());
+    auto options = CIF::Builtins::CreateConstBuffer(&cifMain, Options.c_str(), Options.size());
+    auto internalOptions = CIF::Builtins::CreateConstBuffer(&cifMain, InternalOptions.c_str(), InternalOptions.size());
+    auto output = translationCtx->Translate(src.get(), options.get(), internalOptions.get(), nullptr, 0);
+    if (!output || !output->Successful())
+        return false;
+
+    auto outputBuffer = output->GetOutput();
+    binary.assign(outputBuffer->GetMemory<char>(), outputBuffer->GetSizeRaw());
+    auto telemetry = output->GetTelemetry();
+    if (telemetry->GetSizeRaw() > 0)
+        parseLockCounters(StringRef(telemetry->GetMemory<char>(), telemetry->GetSizeRaw() - 1), locks);
+    return true;
+}
+
+static void compileCorpus(CIF::CIFMain& cifMain, IGC::IgcOclDeviceCtxTagOCL& deviceCtx,
+    const std::vector<CorpusEntry>& corpus, WorkerResult& result)
+{
+    std::string binary;
+    for (unsigned run = 0; run < Repeat; run++)
+    {
+        for (auto& entry : corpus)
+        {
+            if (!translate(cifMain, deviceCtx, entry, binary, result.locks))
+            {
+                result.failed = true;
+                continue;
+            }
+            if (binary != entry.reference)
+                result.mismatches.insert(entry.filename);
+        }
+    }
+}
+
+// Returns false if a compilation failed or produced a different binary.
+static bool runScaling(CIF::CIFMain& cifMain, IGC::IgcOclDeviceCtxTagOCL& deviceCtx, raw_ostream& os)
+{
+    std::vector<CorpusEntry> corpus;
+    LockCounters previousLocks;
+    for (auto& filename : InputFilenames)
+    {
+        CorpusEntry entry;
+        entry.filename = sys::path::filename(filename).str();
+        entry.input = loadInput(filename, entry.inType);
+        if (!entry.input)
+            return false;
+        if (!translate(cifMain, deviceCtx, entry, entry.reference, previousLocks))
+        {
+            errs() << filename << ": compilation failed\n";
+            return false;
+        }
+        corpus.push_back(std::move(entry));
+    }
+
+    std::vector<unsigned> threadCounts;
+    for (unsigned numThreads = 1; numThreads < Threads; numThreads *= 2)
+        threadCounts.push_back(numThreads);
+    threadCounts.push_back(Threads);
+
+    struct Step
+    {
+        unsigned numThreads;
+        uint64_t compiles;
+        uint64_t wallUs;
+        size_t mismatches;
+        LockCounters lockDeltas;
+    };
+    std::vector<Step> steps;
+    std::set<std::string> lockColumns;
+    std::set<std::string> mismatches;
+    bool failed = false;
+    for (unsigned numThreads : threadCounts)
+    {
+        std::vector<WorkerResult> results(numThreads);
+        std::vector<std::thread> workers;
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < numThreads; i++)
+        {
+            workers.emplace_back(compileCorpus, std::ref(cifMain), std::ref(deviceCtx),
+                std::cref(corpus), std::ref(results[i]));
+        }
+        for (auto& worker : workers)
+            worker.join();
+        const auto wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        Step step = { numThreads, uint64_t(numThreads) * Repeat * corpus.size(), uint64_t(wallUs), 0, {} };
+        LockCounters locks = previousLocks;
+        std::set<std::string> stepMismatches;
+        for (auto& result : results)
+        {
+            failed |= result.failed;
+            stepMismatches.insert(result.mismatches.begin(), result.mismatches.end());
+            for (auto& counter : result.locks)
+                locks[counter.first] = std::max(locks[counter.first], counter.second);
+        }
+        for (auto& counter : locks)
+        {
+            step.lockDeltas[counter.first] = counter.second - previousLocks[counter.first];
+            lockColumns.insert(counter.first);
+        }
+        step.mismatches = stepMismatches.size();
+        mismatches.insert(stepMismatches.begin(), stepMismatches.end());
+        previousLocks = locks;
+        steps.push_back(step);
+    }
+
+    os << "threads,compiles,wall_us,compiles_per_s,speedup,efficiency_pct,mismatches";
+    for (auto& column : lockColumns)
+        os << "," << column;
+    os << "\n";
+    const double baseThroughput = double(steps.front().compiles) / std::max<uint64_t>(steps.front().wallUs, 1);
+    for (auto& step : steps)
+    {
+        const double throughput = double(step.compiles) / std::max<uint64_t>(step.wallUs, 1);
+        const double speedup = throughput / baseThroughput;
+        os << step.numThreads << "," << step.compiles << "," << step.wallUs << ","
+           << format("%.2f", throughput * 1e6) << "," << format("%.2f", speedup) << ","
+           << format("%.1f", 100.0 * speedup / step.numThreads) << "," << step.mismatches;
+        for (auto& column : lockColumns)
+        {
+            auto it = step.lockDeltas.find(column);
+            os << "," << (it != step.lockDeltas.end() ? it->second : 0);
+        }
+        os << "\n";
+    }
+
+    for (auto& filename : mismatches)
+        errs() << filename << ": output differs between compilations\n";
+    if (failed)
+        errs() << "some compilations failed\n";
+    return !failed && mismatches.empty();
+}
+
+int main(int argc, char* argv[])
+{
+    cl::ParseCommandLineOptions(argc, argv, "IGC compile-time benchmark\n");
+    if (Repeat == 0)
+        Repeat = 1;
+
+    auto library = CIF::OpenLibrary(LibraryPath, false);
+    auto cifMain = CIF::OpenLibraryInterface(std::move(library));
+    if (!cifMain || !cifMain->IsValid())
+    {
+        errs() << "could not load " << LibraryPath << "\n";
+        return EXIT_FAILURE;
+    }
+
+    auto deviceCtx = cifMain->GetCIFMain()->CreateInterface<IGC::IgcOclDeviceCtxTagOCL>();
+    if (!deviceCtx || !setupDevice(*deviceCtx))
+    {
+        errs() << "could not create the device context\n";
+        return EXIT_FAILURE;
+    }
+
+    if (Threads > 0)
+    {
+        if (!BaselineFilename.empty())
+        {
+            errs() << "-baseline cannot be used with -threads\n";
+            return EXIT_FAILURE;
+        }
+        std::error_code EC;
+        raw_fd_ostream os(OutputFilename, EC);
+        if (EC)
+        {
+            errs() << OutputFilename << ": " << EC.message() << "\n";
+            return EXIT_FAILURE;
+        }
+        return runScaling(*cifMain->GetCIFMain(), *deviceCtx, os) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    std::vector<std::pair<std::string, MetricValues>> rows;
+    bool failed = false;
+    for (auto& filename : InputFilenames)
+    {
+        MetricValues values;
+        if (!compileInput(*cifMain->GetCIFMain(), *deviceCtx, filename, values))
+        {
+            failed = true;
+            continue;
+        }
+        rows.emplace_back(sys::path::filename(filename).str(), values);
+    }
+
+    std::error_code EC;
+    raw_fd_ostream os(OutputFilename, EC);
+    if (EC)
+    {
+        errs() << OutputFilename << ": " << EC.message() << "\n";
+        return EXIT_FAILURE;
+    }
+    writeReport(os, rows);
+
+    if (!BaselineFilename.empty())
+    {
+        Report baseline;
+        if (!readReport(BaselineFilename, baseline))
+        {
+            errs() << "could not read " << BaselineFilename << "\n";
+            return EXIT_FAILURE;
+        }
+        if (compareReports(rows, baseline) > 0)
+            failed = true;
+    }
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -19,6 +19,46 @@ int currentMallocSize = 0;
 #endif
 using namespace vISA;
 
+const std::shared_ptr<ArenaStats::Counters>& ArenaStats::getThreadCounters()
+{
+    thread_local std::shared_ptr<Counters> counters = std::make_shared<Counters>();
+    return counters;
+}
+
+size_t ArenaStats::getCurrentBytes() { return getThreadCounters()->currentBytes; }
+size_t ArenaStats::getPeakBytes() { return getThreadCounters()->peakBytes; }
+void ArenaStats::resetPeak()
+{
+    Counters& counters = *getThreadCounters();
+    counters.peakBytes = counters.currentBytes.load();
+}
+
+static void updatePeak(ArenaStats::Counters& counters, size_t bytes)
+{
+    size_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peak &&
+        !counters.peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed))
+    {
+    }
+}
+
+void ArenaStats::updatePeak(size_t bytes)
+{
+    ::updatePeak(*getThreadCounters(), bytes);
+}
+
+void ArenaStats::onArenaCreated(Counters& counters, size_t bytes)
+{
+    size_t current = counters.currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    ::updatePeak(counters, current);
+}
+
+void ArenaStats::onArenaFreed(Counters& counters, size_t bytes)
+{
+    assert(counters.currentBytes >= bytes);
+    counters.currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
 void*
 ArenaHeader::AllocSpace(size_t size, size_t al)
 {
@@ -54,6 +94,8 @@ ArenaManager::FreeArenas()
 #ifdef COLLECT_ALLOCATION_STATS
         currentMallocSize -= _arenas->size;
 #endif
+        _reservedBytes -= _arenas->size;
+        ArenaStats::onArenaFreed(*_stats, _arenas->size);
         unsigned char* killed = (unsigned char*) _arenas;
         _arenas = _arenas->_nextArena;
         delete [] killed;
@@ -61,3 +103,34 @@ ArenaManager::FreeArenas()
 
     _arenas = 0;
 }
+
+void
+ArenaManager::ResetToMark(const ArenaMark& mark)
+{
+#if !defined(NDEBUG) && defined(vISA_DEBUG_MEM_ALLOC)
+    // allocations are not from the arenas
+    return;
+#endif
+    // arenas created after the mark are at the head of the list
+    while (_arenas && _arenas != mark.arena)
+    {
+#ifdef COLLECT_ALLOCATION_STATS
+        currentMallocSize -= _arenas->size;
+#endif
+        _reservedBytes -= _arenas->size;
+        ArenaStats::onArenaFreed(*_stats, _arenas->size);
+        unsigned char* killed = (unsigned char*) _arenas;
+        _arenas = _arenas->_nextArena;
+        delete [] killed;
+    }
+    assert(_arenas == mark.arena && "mark does not belong to this manager");
+    if (_arenas)
+    {
+        assert(mark.nextByte >= _arenas->GetArenaData() && mark.nextByte <= _arenas->_nextByte);
+        _arenas->_nextByte = mark.nextByte;
+    }
+    else
+    {
+        CreateArena(_defaultArenaSize);
+    }
+}
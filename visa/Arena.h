@@ -17,6 +17,8 @@ SPDX-License-Identifier: MIT
 #include <stdlib.h>
 #include <iostream>
 #include <cstddef>
+#include <atomic>
+#include <memory>
 
 #include "Option.h"
 
@@ -34,6 +36,55 @@ extern int currentMallocSize;
 
 namespace vISA
 {
+    // Bytes of arena memory held by all ArenaManagers created by the current
+    // thread. This is always tracked as it only costs an update per arena
+    // created or freed, and lets the memory used by each phase be reported
+    // in release builds. A manager keeps updating the counters of the thread
+    // that created it, even when a helper thread grows it.
+    class ArenaStats
+    {
+    public:
+        struct Counters
+        {
+            std::atomic<size_t> currentBytes{0};
+            std::atomic<size_t> peakBytes{0};
+        };
+        // shared, as a manager may outlive the thread that created it
+        static const std::shared_ptr<Counters>& getThreadCounters();
+
+        static size_t getCurrentBytes();
+        static size_t getPeakBytes();
+        // Start a new peak measurement from the current footprint. A phase
+        // peak helper should restore the enclosing peak with updatePeak().
+        static void resetPeak();
+        static void updatePeak(size_t bytes);
+
+        static void onArenaCreated(Counters& counters, size_t bytes);
+        static void onArenaFreed(Counters& counters, size_t bytes);
+    };
+
+    // Measures the peak arena growth while it is alive, without losing the
+    // peak of any enclosing measurement.
+    class ArenaPeakScope
+    {
+        const size_t startBytes;
+        const size_t outerPeak;
+    public:
+        ArenaPeakScope() :
+            startBytes(ArenaStats::getCurrentBytes()), outerPeak(ArenaStats::getPeakBytes())
+        {
+            ArenaStats::resetPeak();
+        }
+        ~ArenaPeakScope() { ArenaStats::updatePeak(outerPeak); }
+
+        // peak bytes allocated on top of the footprint at scope entry
+        size_t getPeakGrowth() const
+        {
+            size_t peak = ArenaStats::getPeakBytes();
+            return peak > startBytes ? peak - startBytes : 0;
+        }
+    };
+
     class Mem_Manager;
     class ArenaHeader
     {
@@ -104,6 +155,14 @@ namespace vISA
         size_t size;
     };
 
+    // A position in an ArenaManager's allocation sequence. Resetting the
+    // manager to a mark releases everything allocated after it was taken.
+    struct ArenaMark
+    {
+        ArenaHeader*   arena = nullptr;
+        unsigned char* nextByte = nullptr;
+    };
+
     class ArenaManager
     {
         friend class Mem_Manager;
@@ -169,6 +228,8 @@ namespace vISA
             }
 
             _arenas = newArena;
+            _reservedBytes += arenaDataSize;
+            ArenaStats::onArenaCreated(*_stats, arenaDataSize);
 
 #ifdef COLLECT_ALLOCATION_STATS
             numMallocCalls++;
@@ -194,10 +255,22 @@ namespace vISA
 
         void FreeArenas();
 
+        ArenaMark GetMark() const
+        {
+            ArenaMark mark;
+            mark.arena = _arenas;
+            mark.nextByte = _arenas ? _arenas->_nextByte : nullptr;
+            return mark;
+        }
+
+        void ResetToMark(const ArenaMark& mark);
+
         // Data
 
         ArenaHeader * _arenas;
         const size_t  _defaultArenaSize;
+        size_t        _reservedBytes = 0;
+        const std::shared_ptr<ArenaStats::Counters> _stats = ArenaStats::getThreadCounters();
     };
 }
 #endif
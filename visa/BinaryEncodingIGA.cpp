@@ -14,6 +14,7 @@ SPDX-License-Identifier: MIT
 #include "Common_ISA_framework.h"
 
 #include <map>
+#include <unordered_map>
 #include <utility>
 
 
@@ -54,13 +55,14 @@ public:
     void translateInstructionSrcs(G4_INST *g4inst, Instruction *igaInst);
 
     void FixInst();
+    void removeNoopSyncs();
     void *EmitBinary(size_t& binarySize);
 
 private:
     BinaryEncodingIGA(const BinaryEncodingIGA& other);
     BinaryEncodingIGA& operator=(const BinaryEncodingIGA& other);
 
-    std::map<G4_Label*, Block*> labelToBlockMap;
+    std::unordered_map<G4_Label*, Block*> labelToBlockMap;
 
 public:
     static ExecSize       getIGAExecSize(int execSize);
@@ -448,6 +450,45 @@ void BinaryEncodingIGA::FixInst()
     }
 }
 
+// Drop sync.nop instructions that carry no SWSB annotation. They wait on
+// nothing, so they only cost an instruction slot (and I-cache). This runs
+// before the first BB is padded for the per-thread payload, so that padding
+// still sees the final instruction count.
+void BinaryEncodingIGA::removeNoopSyncs()
+{
+    if (getPlatformGeneration(platform) < PlatformGen::XE ||
+        !kernel.getOption(vISA_RemoveNoopSync) ||
+        kernel.getOption(vISA_EnableIGASWSB))
+    {
+        // with IGA's SWSB the annotations are only computed at encoding time
+        return;
+    }
+
+    for (auto bb : kernel.fg)
+    {
+        for (auto iter = bb->begin(); iter != bb->end();)
+        {
+            G4_INST* inst = *iter;
+            // explicitly (no)compacted syncs are counted by code that
+            // hardcodes IP-relative offsets (e.g. indirect call sequences)
+            if (inst->opcode() != G4_sync_nop || inst->getPredicate() ||
+                inst->isCompactedInst() || inst->isNoCompactedInst())
+            {
+                ++iter;
+                continue;
+            }
+            SWSB sw;
+            SetSWSB(inst, sw);
+            if (sw.hasSWSB())
+            {
+                ++iter;
+                continue;
+            }
+            iter = bb->erase(iter);
+        }
+    }
+}
+
 iga::SFID BinaryEncodingIGA::getSFID(const G4_INST *inst)
 {
     ASSERT_USER(inst->isSend(), "Only send has SFID");
@@ -808,6 +849,7 @@ void BinaryEncodingIGA::getIGAFlagInfo(
 void BinaryEncodingIGA::Encode()
 {
     FixInst();
+    removeNoopSyncs();
     Block* currBB = nullptr;
 
     auto isFirstInstLabel = [this]()
@@ -853,7 +895,13 @@ void BinaryEncodingIGA::Encode()
         IGAKernel->appendBlock(currBB);
     }
 
-    std::list<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    size_t numInsts = 0;
+    for (auto bb : kernel.fg)
+    {
+        numInsts += bb->size();
+    }
+    std::vector<std::pair<Instruction*, G4_INST*>> encodedInsts;
+    encodedInsts.reserve(numInsts);
     Block *bbNew = nullptr;
     for (auto bb : this->kernel.fg)
     {
@@ -914,7 +962,7 @@ void BinaryEncodingIGA::Encode()
             // for a single G4_INST, then it should be safe to
             // make pair between the G4_INST and first encoded
             // binary inst.
-            encodedInsts.push_back(std::make_pair(igaInst, inst));
+            encodedInsts.emplace_back(igaInst, inst);
         }
     }
 
@@ -939,6 +987,8 @@ void BinaryEncodingIGA::Encode()
         {
             encoder.enableIGAAutoDeps();
         }
+        encoder.forceGEDEncoder(!kernel.getOption(vISA_IGANativeEncoder));
+        encoder.verifyWithGED(kernel.getOption(vISA_IGAVerifyNativeEncoder));
 
         encoder.encode();
 
@@ -952,6 +1002,13 @@ void BinaryEncodingIGA::Encode()
     {
         inst.second->setGenOffset(inst.first->getPC());
     }
+    // The IGA IR is only a staging copy for the encoder; release it now
+    // rather than keeping a third copy of the kernel alive until the
+    // encoder object goes away.
+    encodedInsts.clear();
+    labelToBlockMap.clear();
+    delete IGAKernel;
+    IGAKernel = nullptr;
     if (kernel.hasPerThreadPayloadBB())
     {
         kernel.fg.builder->getJitInfo()->offsetToSkipPerThreadDataLoad =
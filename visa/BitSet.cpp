@@ -8,6 +8,11 @@ SPDX-License-Identifier: MIT
 
 #include "BitSet.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BITSET_USE_SSE2
+#endif
+
 void BitSet::create(unsigned size)
 {
     const unsigned newArraySize = (size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
@@ -108,33 +113,138 @@ void BitSet::invert(void)
     }
 }
 
-template <typename T>
-void vector_and(T *__restrict__ p1, const T *const p2, unsigned n)
+// The bulk operations below are done 128 bits at a time when SSE2 is
+// available (it is always there on x86-64), with a scalar loop for the
+// remaining elements.
+#ifdef BITSET_USE_SSE2
+#define NUM_ELTS_PER_VEC (sizeof(__m128i) / sizeof(BITSET_ARRAY_TYPE))
+#endif
+
+static void vector_and(BITSET_ARRAY_TYPE *__restrict__ p1, const BITSET_ARRAY_TYPE *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#ifdef BITSET_USE_SSE2
+    for (; i + NUM_ELTS_PER_VEC <= n; i += NUM_ELTS_PER_VEC)
+    {
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        _mm_storeu_si128((__m128i*)(p1 + i), _mm_and_si128(v1, v2));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] &= p2[i];
     }
 }
 
-template <typename T>
-void vector_or(T *__restrict__ p1, const T *const p2, unsigned n)
+static void vector_or(BITSET_ARRAY_TYPE *__restrict__ p1, const BITSET_ARRAY_TYPE *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#ifdef BITSET_USE_SSE2
+    for (; i + NUM_ELTS_PER_VEC <= n; i += NUM_ELTS_PER_VEC)
+    {
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        _mm_storeu_si128((__m128i*)(p1 + i), _mm_or_si128(v1, v2));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] |= p2[i];
     }
 }
 
-template <typename T>
-void vector_minus(T *__restrict__ p1, const T *const p2, unsigned n)
+static void vector_minus(BITSET_ARRAY_TYPE *__restrict__ p1, const BITSET_ARRAY_TYPE *const p2, unsigned n)
 {
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+#ifdef BITSET_USE_SSE2
+    for (; i + NUM_ELTS_PER_VEC <= n; i += NUM_ELTS_PER_VEC)
+    {
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        _mm_storeu_si128((__m128i*)(p1 + i), _mm_andnot_si128(v2, v1));
+    }
+#endif
+    for (; i < n; ++i)
     {
         p1[i] &= ~p2[i];
     }
 }
 
+// p1 |= p2, returns true if any bit of p1 changed
+static bool vector_or_changed(BITSET_ARRAY_TYPE *__restrict__ p1, const BITSET_ARRAY_TYPE *const p2, unsigned n)
+{
+    unsigned i = 0;
+    BITSET_ARRAY_TYPE changed = 0;
+#ifdef BITSET_USE_SSE2
+    __m128i vChanged = _mm_setzero_si128();
+    for (; i + NUM_ELTS_PER_VEC <= n; i += NUM_ELTS_PER_VEC)
+    {
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        vChanged = _mm_or_si128(vChanged, _mm_andnot_si128(v1, v2));
+        _mm_storeu_si128((__m128i*)(p1 + i), _mm_or_si128(v1, v2));
+    }
+    changed = _mm_movemask_epi8(_mm_cmpeq_epi8(vChanged, _mm_setzero_si128())) != 0xFFFF;
+#endif
+    for (; i < n; ++i)
+    {
+        changed |= p2[i] & ~p1[i];
+        p1[i] |= p2[i];
+    }
+    return changed != 0;
+}
+
+// p = p1 + (p2 - p3)
+static void vector_or_minus(BITSET_ARRAY_TYPE *p, const BITSET_ARRAY_TYPE *const p1,
+    const BITSET_ARRAY_TYPE *const p2, const BITSET_ARRAY_TYPE *const p3, unsigned n)
+{
+    unsigned i = 0;
+#ifdef BITSET_USE_SSE2
+    for (; i + NUM_ELTS_PER_VEC <= n; i += NUM_ELTS_PER_VEC)
+    {
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p1 + i));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p2 + i));
+        __m128i v3 = _mm_loadu_si128((const __m128i*)(p3 + i));
+        _mm_storeu_si128((__m128i*)(p + i), _mm_or_si128(v1, _mm_andnot_si128(v3, v2)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        p[i] = p1[i] | (p2[i] & ~p3[i]);
+    }
+}
+
+bool BitSet::unionChanged(const BitSet& other)
+{
+    if (m_Size < other.m_Size)
+    {
+        create(other.m_Size);
+    }
+
+    unsigned arraySize = (other.m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    return vector_or_changed(m_BitSetArray, other.m_BitSetArray, arraySize);
+}
+
+void BitSet::assignUnionDiff(const BitSet& gen, const BitSet& out, const BitSet& kill)
+{
+    if (gen.m_Size != out.m_Size || gen.m_Size != kill.m_Size)
+    {
+        *this = out;
+        *this -= kill;
+        *this |= gen;
+        return;
+    }
+
+    if (m_Size != gen.m_Size)
+    {
+        create(gen.m_Size);
+    }
+
+    unsigned arraySize = (m_Size + NUM_BITS_PER_ELT - 1) / NUM_BITS_PER_ELT;
+    vector_or_minus(m_BitSetArray, gen.m_BitSetArray, out.m_BitSetArray, kill.m_BitSetArray, arraySize);
+}
+
 BitSet& BitSet::operator|=(const BitSet& other)
 {
     unsigned size = other.m_Size;
@@ -332,6 +332,11 @@ public:
     BitSet &operator&=(const BitSet &other);
     BitSet &operator-=(const BitSet &other);
 
+    // *this |= other, returns true if any bit of *this changed
+    bool unionChanged(const BitSet &other);
+    // *this = gen + (out - kill)
+    void assignUnionDiff(const BitSet &gen, const BitSet &out, const BitSet &kill);
+
     void *operator new(size_t sz, vISA::
         Mem_Manager &m) { return m.alloc(sz); }
 
@@ -73,6 +73,7 @@ public:
     // Used for inline asm code generation
     VISA_BUILDER_API int ParseVISAText(const std::string& visaText, const std::string& visaTextFile) override;
     VISA_BUILDER_API int ParseVISAText(const std::string& visaFile) override;
+    VISA_BUILDER_API int ParseVISAFragment(VISAKernel* kernel, const std::string& visaText) override;
     VISA_BUILDER_API std::stringstream& GetAsmTextStream() override { return m_ssIsaAsm; }
     VISA_BUILDER_API VISAKernel* GetVISAKernel(const std::string& kernelName) override;
     VISA_BUILDER_API int ClearAsmTextStreams() override;
@@ -100,6 +101,14 @@ public:
 
     bool debugParse() const {return m_options.getOption(vISA_DebugParse);}
 
+    // The lexer returns FRAGMENT_START once at the beginning of a fragment parse
+    bool takeFragmentStart()
+    {
+        bool start = m_fragmentStart;
+        m_fragmentStart = false;
+        return start;
+    }
+
     int verifyVISAIR();
 
 
@@ -881,6 +890,11 @@ private:
     vISA::G4_Kernel* GetCallerKernel(vISA::G4_INST*);
     vISA::G4_Kernel* GetCalleeKernel(vISA::G4_INST*);
 
+    // Functions compiled so far, with the GRFs they clobber recorded for IPRA
+    std::map<std::string, vISA::G4_Kernel*> compiledFunctions;
+    // Compile kernels and functions with callees ahead of their callers.
+    int compileCalleesFirst(const std::vector<VISAKernelImpl*>& kernels);
+
     // To collect call related info for LinkTimeOptimization
     void CollectCallSites(
             std::list<VISAKernelImpl *>& functions,
@@ -914,6 +928,7 @@ private:
     // important messages that we should relay to the user
     // (things like if RA is spilling, etc.)
     std::stringstream criticalMsg;
+    bool m_fragmentStart = false;
 };
 
 #endif
@@ -33,6 +33,8 @@ SPDX-License-Identifier: MIT
 #include <string>
 #include <sstream>
 #include <functional>
+#include <atomic>
+#include <thread>
 
 using namespace vISA;
 extern "C" int64_t getTimerTicks(unsigned int idx);
@@ -503,6 +505,58 @@ void CISA_IR_Builder::CheckHazardFeatures(
 
 }
 
+int CISA_IR_Builder::compileCalleesFirst(const std::vector<VISAKernelImpl*>& kernels)
+{
+    std::map<std::string, VISAKernelImpl*> nameToFunc;
+    for (auto kernel : kernels)
+    {
+        if (!kernel->getIsKernel())
+        {
+            nameToFunc[kernel->getName()] = kernel;
+        }
+    }
+
+    // post-order over direct calls; a function on a call cycle is compiled
+    // before its callers on the cycle are done and so is treated as unknown
+    std::vector<VISAKernelImpl*> order;
+    std::set<VISAKernelImpl*> visited;
+    std::function<void(VISAKernelImpl*)> visit = [&](VISAKernelImpl* kernel)
+    {
+        if (!visited.insert(kernel).second)
+            return;
+        for (G4_INST* inst : kernel->getIRBuilder()->instList)
+        {
+            if (inst->opcode() != G4_pseudo_fcall || !inst->getSrc(0) || !inst->getSrc(0)->isLabel())
+                continue;
+            auto iter = nameToFunc.find(inst->getSrc(0)->asLabel()->getLabel());
+            if (iter != nameToFunc.end())
+            {
+                visit(iter->second);
+            }
+        }
+        order.push_back(kernel);
+    };
+    for (auto kernel : kernels)
+    {
+        visit(kernel);
+    }
+
+    for (auto kernel : order)
+    {
+        kernel->getKernel()->setCompiledFunctions(&compiledFunctions);
+        int status = kernel->compileFastPath();
+        if (status != VISA_SUCCESS)
+        {
+            return status;
+        }
+        if (!kernel->getIsKernel())
+        {
+            compiledFunctions[kernel->getName()] = kernel->getKernel();
+        }
+    }
+    return VISA_SUCCESS;
+}
+
 void CISA_IR_Builder::CollectCallSites(
     std::list<VISAKernelImpl *>& functions,
     std::unordered_map<G4_Kernel*, std::list<std::list<G4_INST*>::iterator>>& callSites)
@@ -645,6 +699,52 @@ void CISA_IR_Builder::LinkTimeOptimization(
 
 }
 
+// With -noStitchExternFunc, external functions are compiled and encoded once
+// as separate units instead of being cloned into every caller. Direct calls to
+// them are turned into indirect calls through the callee's relocated address,
+// so the callers can be linked against the single copy and never need the
+// callee's IR at stitching time.
+static void LinkExternFunctionCalls(std::list<VISAKernelImpl*>& kernelsAndFunctions)
+{
+    std::set<std::string> externFuncs;
+    for (auto func : kernelsAndFunctions)
+    {
+        if (!func->getIsKernel() && func->getKernel()->getBoolKernelAttr(Attributes::ATTR_Extern))
+        {
+            externFuncs.insert(func->getName());
+        }
+    }
+    if (externFuncs.empty())
+    {
+        return;
+    }
+
+    for (auto func : kernelsAndFunctions)
+    {
+        IR_Builder* builder = func->getIRBuilder();
+        auto& instList = builder->instList;
+        for (auto it = instList.begin(), ie = instList.end(); it != ie; ++it)
+        {
+            G4_INST* fcall = *it;
+            if (!fcall->isFCall() || fcall->asCFInst()->isIndirectCall() ||
+                !externFuncs.count(fcall->getSrc(0)->asLabel()->getLabel()))
+            {
+                continue;
+            }
+            // only the low 32 bits are needed, as the call target is IP-relative
+            G4_Declare* funcAddr = builder->createTempVar(1, Type_UD, Any);
+            G4_INST* mov = builder->createMov(g4::SIMD1, builder->createDstRegRegion(funcAddr, 1),
+                builder->createRelocImm(Type_UD), InstOpt_WriteEnable, false);
+            mov->inheritDIFrom(fcall);
+            RelocationEntry::createRelocation(builder->kernel, *mov, 0,
+                fcall->getSrc(0)->asLabel()->getLabel(), GenRelocType::R_SYM_ADDR_32);
+            instList.insert(it, mov);
+            fcall->setSrc(builder->createSrcRegRegion(funcAddr, builder->getRegionScalar()), 0);
+            builder->kernel.setHasIndirectCall();
+        }
+    }
+}
+
 // Stitch the FG of subFunctions to mainFunc
 // mainFunc could be a kernel or a non-kernel function.
 // It also modifies pseudo_fcall/fret in to call/ret opcodes.
@@ -768,6 +868,7 @@ static void Stitch_Compiled_Units(
 
 typedef struct yy_buffer_state * YY_BUFFER_STATE;
 extern int CISAparse(CISA_IR_Builder *builder);
+extern int CISAlineno;
 extern YY_BUFFER_STATE CISA_scan_string(const char* yy_str);
 extern void CISA_delete_buffer(YY_BUFFER_STATE buf);
 
@@ -862,8 +963,94 @@ int CISA_IR_Builder::ParseVISAText(const std::string& visaFile)
 #endif
 }
 
+// Parses an inline asm fragment directly into the given kernel, so that
+// kernels with inline asm don't need to be printed and reparsed as a whole.
+int CISA_IR_Builder::ParseVISAFragment(VISAKernel* kernel, const std::string& visaText)
+{
+#if defined(__linux__) || defined(_WIN64) || defined(_WIN32)
+    assert(m_options.getOption(vISA_ParseAsmFragment) &&
+        "variable names are not recorded without vISA_ParseAsmFragment");
+#if defined(_WIN64) || defined(_WIN32)
+    CISAout = fopen("nul", "w");
+#else
+    CISAout = fopen("/dev/null", "w");
+#endif
+
+    int status = VISA_SUCCESS;
+
+    // the parser appends to m_kernel, and declarations made by the fragment
+    // are created in parse mode
+    VISAKernelImpl* savedKernel = m_kernel;
+    m_kernel = static_cast<VISAKernelImpl*>(kernel);
+    m_options.setOptionInternally(vISA_isParseMode, true);
+    m_fragmentStart = true;
+    CISAlineno = 1;
+
+    YY_BUFFER_STATE visaBuf = CISA_scan_string(visaText.c_str());
+    if (CISAparse(this) != 0)
+    {
+#ifndef DLL_MODE
+        std::cerr << "Parsing visa fragment failed.\n" << criticalMsg.str();
+#endif //DLL_MODE
+        status = VISA_FAILURE;
+    }
+    CISA_delete_buffer(visaBuf);
+
+    m_fragmentStart = false;
+    m_options.setOptionInternally(vISA_isParseMode, false);
+    m_kernel = savedKernel;
+
+    if (CISAout)
+    {
+        fclose(CISAout);
+    }
+    return status;
+#else
+    assert(0 && "vISA asm parsing not supported on this platform");
+    return VISA_FAILURE;
+#endif
+}
+
 // default size of the kernel mem manager in bytes
 #define KERNEL_MEM_SIZE    (4*1024*1024)
+// Runs task(0) ... task(numTasks - 1) on up to numThreads worker threads and
+// joins them before returning. Tasks are handed out in order, but results
+// must be consumed by the caller in index order to stay deterministic.
+static void runTasksInParallel(
+    unsigned numThreads, size_t numTasks, const std::function<void(size_t)>& task)
+{
+    numThreads = (unsigned)std::min<size_t>(numThreads, numTasks);
+    if (numThreads <= 1)
+    {
+        for (size_t i = 0; i < numTasks; ++i)
+        {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextTask(0);
+    auto worker = [&]() {
+        // Timers are thread local; give each worker its own set.
+        initTimer();
+        for (size_t i = nextTask++; i < numTasks; i = nextTask++)
+        {
+            task(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i)
+    {
+        workers.emplace_back(worker);
+    }
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+}
+
 int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_visa_only)
 {
     stopTimer(TimerID::BUILDER);   // TIMER_BUILDER is started when builder is created
@@ -995,7 +1182,21 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
         int i;
         unsigned int k = 0;
         bool isInPatchingMode = m_options.getuInt32Option(vISA_CodePatch) >= CodePatch_Enable_NoLTO && m_prevKernel;
+        // Kernels and functions are independent until stitching, so they may be
+        // optimized concurrently. Payload sections borrow the main kernel's
+        // declarations and are therefore always compiled serially.
+        unsigned numCompileThreads = m_options.getuInt32Option(vISA_ParallelCompileThreads);
+        bool compileInParallel = numCompileThreads > 1 && !m_options.getuInt32Option(vISA_CodePatch);
+        // With IPRA, callees are compiled before their callers so that callers
+        // only save the registers their callees actually clobber.
+        bool useIPRA = m_options.getOption(vISA_IPRA) && !compileInParallel &&
+            !m_options.getuInt32Option(vISA_CodePatch);
+        std::vector<VISAKernelImpl*> kernelsToCompile;
         VISAKernelImpl* mainKernel = nullptr;
+        if (m_options.getOption(vISA_noStitchExternFunc) && !m_options.getuInt32Option(vISA_CodePatch))
+        {
+            LinkExternFunctionCalls(m_kernelsAndFunctions);
+        }
         std::list<VISAKernelImpl*>::iterator iter = m_kernelsAndFunctions.begin();
         std::list<VISAKernelImpl*>::iterator end = m_kernelsAndFunctions.end();
         for (i = 0; iter != end; iter++, i++)
@@ -1050,6 +1251,11 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
             {
                 continue;
             }
+            if (compileInParallel || useIPRA)
+            {
+                kernelsToCompile.push_back(kernel);
+                continue;
+            }
             int status =  kernel->compileFastPath();
             if (status != VISA_SUCCESS)
             {
@@ -1072,6 +1278,31 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
                 }
             }
         }
+        if (compileInParallel)
+        {
+            std::vector<int> results(kernelsToCompile.size(), VISA_SUCCESS);
+            runTasksInParallel(numCompileThreads, kernelsToCompile.size(),
+                [&](size_t i) { results[i] = kernelsToCompile[i]->compileFastPath(); });
+            // report the first failure in program order
+            for (int result : results)
+            {
+                if (result != VISA_SUCCESS)
+                {
+                    stopTimer(TimerID::TOTAL);
+                    return result;
+                }
+            }
+        }
+        else if (useIPRA)
+        {
+            int status = compileCalleesFirst(kernelsToCompile);
+            if (status != VISA_SUCCESS)
+            {
+                stopTimer(TimerID::TOTAL);
+                return status;
+            }
+        }
+
         // Here we change the payload section as the main kernel in m_kernelsAndFunctions
         // During stitching, all functions will be cloned and stitched to the main kernel.
         // Demoting the shader body to a function type makes it intact
@@ -1126,6 +1357,8 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
         //    Stitch all non-kernel functions to all kernels
         // 2. vISA_noStitchExternFunc == true
         //    Stitch only non-external functions. Stich them to all kernels and external functions
+        //    External functions are encoded once; calls to them were made relocatable by
+        //    LinkExternFunctionCalls
 
         // mainFunctions: functions or kernels those will be stiched by others
         // Thses functions/kernels will be the unit of compilePostOptimize
@@ -1172,7 +1405,7 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
 
         bool hasPayloadPrologue = m_options.getuInt32Option(vISA_CodePatch) >= CodePatch_Payload_Prologue;
         // stitch functions and compile to gen binary
-        for (auto func : mainFunctions)
+        auto compileMainFunction = [&](VISAKernelImpl* func)
         {
             unsigned int genxBufferSize = 0;
 
@@ -1209,11 +1442,25 @@ int CISA_IR_Builder::Compile(const char* nameInput, std::ostream* os, bool emit_
                 func->computeAndEmitDebugInfo(subFunctions);
             }
             restoreFCallState(func->getKernel(), origFCallFRet);
+        };
 
-
+        // Without anything to stitch, every main function owns its G4 IR
+        // exclusively and RA/scheduling/encoding can run concurrently.
+        // Each function keeps its own binary buffer, so the output does not
+        // depend on the order in which the workers finish.
+        if (compileInParallel && subFunctions.empty() && !hasPayloadPrologue)
+        {
+            std::vector<VISAKernelImpl*> funcs(mainFunctions.begin(), mainFunctions.end());
+            runTasksInParallel(numCompileThreads, funcs.size(),
+                [&](size_t i) { compileMainFunction(funcs[i]); });
+        }
+        else
+        {
+            for (auto func : mainFunctions)
+            {
+                compileMainFunction(func);
+            }
         }
-
-
     }
 
     if (IS_VISA_BOTH_PATH && m_options.getOption(vISA_DumpvISA))
@@ -148,9 +148,9 @@ public:
     std::list<RegAccess> RegFirstAccessList;
     std::list<RegAccess> RegLastAccessList;
     // Per GRF, the first access.
-    std::map<unsigned, RegAccess *> RegFirstAccessMap;
+    std::unordered_map<unsigned, RegAccess *> RegFirstAccessMap;
     // Per GRF, the last access.
-    std::map<unsigned, RegAccess *> RegLastAccessMap;
+    std::unordered_map<unsigned, RegAccess *> RegLastAccessMap;
     // Note that tokens recorded are tokens allocated but not used in last
     // access list.
     std::set<unsigned> AllocatedToken;  // Allocated token.
@@ -167,38 +167,26 @@ class OperandHashTable
 {
     Mem_Manager& mem;
 
-    struct ImmKey
-    {
-        int64_t val;
-        G4_Type valType;
-        ImmKey(int64_t imm, G4_Type type) : val(imm), valType(type) {}
-        bool operator==(const ImmKey& imm) const
-        {
-            return val == imm.val && valType == imm.valType;
-        }
-    };
+    // Open addressing (linear probing) table of all immediates created so
+    // far. A G4_Imm holds its own value and type, so each slot is just a
+    // pointer and no key is stored separately.
+    std::vector<G4_Imm*> immSlots;
+    size_t numImms = 0;
 
-    struct ImmKeyHash
-    {
-        std::size_t operator()(const ImmKey& imm) const
-        {
-            return (std::size_t) (imm.val ^ imm.valType);
-        }
-    };
+    static const size_t initialImmSlots = 256;
 
-    struct stringCompare
+    static size_t hashImm(int64_t imm, G4_Type ty)
     {
-        bool operator() (const char* s1, const char* s2) const
-        {
-            return strcmp(s1, s2) == 0;
-        }
-    };
-
-    std::unordered_map<ImmKey, G4_Imm*, ImmKeyHash> immTable;
-    std::unordered_map<const char *, G4_Label*, std::hash<const char*>, stringCompare> labelTable;
+        uint64_t h = ((uint64_t)imm ^ ((uint64_t)ty << 56)) * 0x9E3779B97F4A7C15ULL;
+        return (size_t)(h ^ (h >> 32));
+    }
+    // Returns the slot holding (imm, ty), or the empty slot where it
+    // should be inserted.
+    size_t findImmSlot(int64_t imm, G4_Type ty) const;
+    void growImmTable();
 
 public:
-    OperandHashTable(Mem_Manager& m) : mem(m)
+    OperandHashTable(Mem_Manager& m) : mem(m), immSlots(initialImmSlots, nullptr)
     {
     }
 
@@ -377,7 +365,7 @@ private:
     const WA_TABLE *m_pWaTable;
     Options *m_options = nullptr;
 
-    std::map<const G4_INST*, G4_FCALL*> m_fcallInfo;
+    std::unordered_map<const G4_INST*, G4_FCALL*> m_fcallInfo;
 
     // Basic region descriptors.
     RegionDesc CanonicalRegionStride0, // <0; 1, 0>
@@ -386,18 +374,16 @@ private:
                CanonicalRegionStride4; // <4; 1, 0>
 
     // map of all stack functioncs ever invoked by this builder's kernel/function
-    std::map<std::string, G4_Label*> m_fcallLabels;
+    std::unordered_map<std::string, G4_Label*> m_fcallLabels;
 
     G4_Label* getFcallLabel(const std::string &str)
     {
-        auto it = m_fcallLabels.find(str);
-        if (it == m_fcallLabels.end())
+        auto it = m_fcallLabels.emplace(str, nullptr);
+        if (it.second)
         {
-            auto label = createLabel(str, LABEL_FUNCTION);
-            m_fcallLabels[str] = label;
-            return label;
+            it.first->second = createLabel(str, LABEL_FUNCTION);
         }
-        return it->second;
+        return it.first->second;
     }
 
     class PreDefinedVars
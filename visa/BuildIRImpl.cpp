@@ -1259,22 +1259,57 @@ G4_Type IR_Builder::getNewType(int64_t imm, G4_Type ty)
 //
 G4_Imm* OperandHashTable::lookupImm(int64_t imm, G4_Type ty)
 {
-    ImmKey key(imm, ty);
-    auto iter = immTable.find(key);
-    return iter != immTable.end() ? iter->second : nullptr;
+    return immSlots[findImmSlot(imm, ty)];
 }
 
 //
-// create a dst reg region
+// create an imm operand
 //
 G4_Imm* OperandHashTable::createImm(int64_t imm, G4_Type ty)
 {
+    // keep the load factor at or below 1/2
+    if ((numImms + 1) * 2 > immSlots.size())
+    {
+        growImmTable();
+    }
     G4_Imm* i = new (mem)G4_Imm(imm, ty);
-    ImmKey key(imm, ty);
-    immTable[key] = i;
+    G4_Imm*& slot = immSlots[findImmSlot(imm, ty)];
+    if (!slot)
+    {
+        numImms++;
+    }
+    slot = i;
     return i;
 }
 
+size_t OperandHashTable::findImmSlot(int64_t imm, G4_Type ty) const
+{
+    size_t mask = immSlots.size() - 1;
+    size_t idx = hashImm(imm, ty) & mask;
+    while (G4_Imm* slot = immSlots[idx])
+    {
+        if (slot->getImm() == imm && slot->getType() == ty)
+        {
+            break;
+        }
+        idx = (idx + 1) & mask;
+    }
+    return idx;
+}
+
+void OperandHashTable::growImmTable()
+{
+    std::vector<G4_Imm*> oldSlots(immSlots.size() * 2, nullptr);
+    oldSlots.swap(immSlots);
+    for (G4_Imm* imm : oldSlots)
+    {
+        if (imm)
+        {
+            immSlots[findImmSlot(imm->getImm(), imm->getType())] = imm;
+        }
+    }
+}
+
 
 //
 // create the region <vstride; width, hstride> if not yet created
@@ -2240,17 +2240,15 @@ static void readRoutineNG(unsigned& bytePos, const char* buf, vISA::Mem_Manager&
     container.stringPool.resize(header.string_count);
     for (unsigned i = 0; i < header.string_count; i++)
     {
-        char* str = (char*)mem.alloc(STRING_LEN);
-        unsigned j = 0;
-        while (buf[bytePos] != '\0' && j < STRING_LEN)
-        {
-            str[j++] = buf[bytePos++];
-        }
-        ASSERT_USER(j < STRING_LEN, "string exceeds the maximum length allowed");
-        str[j] = '\0';
-        bytePos++;
+        // copy each string in one go, and only allocate what it needs
+        const char* src = &buf[bytePos];
+        size_t len = strnlen(src, STRING_LEN);
+        ASSERT_USER(len < STRING_LEN, "string exceeds the maximum length allowed");
+        char* str = (char*)mem.alloc(len + 1);
+        memcpy_s(str, len + 1, src, len + 1);
+        bytePos += (unsigned)len + 1;
         header.strings[i] = str;
-        container.stringPool[i] = str;
+        container.stringPool[i].assign(str, len);
     }
     readVarBytes(majorVersion, minorVersion, header.name_index, bytePos, buf);
 
@@ -3276,6 +3276,8 @@ void CFGStructurizer::convertIf(ANodeHG *node, G4_BB *nextJoinBB)
         ifInst->inheritDIFrom(endifInst);
         begin->pop_back();
         begin->push_back(ifInst);
+        ifInst->asCFInst()->setThreadUniformCond(gotoInst->asCFInst()->isThreadUniformCond());
+        ifInst->asCFInst()->setFallThroughPercent(gotoInst->asCFInst()->getFallThroughPercent());
         if (isUniform)
         {
             ifInst->asCFInst()->setUniform(true);
@@ -3385,6 +3387,8 @@ void CFGStructurizer::convertIf(ANodeHG *node, G4_BB *nextJoinBB)
         ifInst->inheritDIFrom(endifInst);
         begin->pop_back();
         begin->push_back(ifInst);
+        ifInst->asCFInst()->setThreadUniformCond(gotoInst->asCFInst()->isThreadUniformCond());
+        ifInst->asCFInst()->setFallThroughPercent(gotoInst->asCFInst()->getFallThroughPercent());
 
         // else instruction: jip = uip = endif
         G4_BB *newThenLastBB = thenLastBB;
@@ -211,7 +211,7 @@ std::vector<attr_gen_struct*> AttrOptVar;
     CISA_GEN_VAR*          vISADecl;
 } // end of possible token types
 
-%start Listing
+%start Input
 
 %type <intval> ScopeStart
 
@@ -231,6 +231,9 @@ std::vector<attr_gen_struct*> AttrOptVar;
 %token          DIRECTIVE_PARAMETER   // .parameter
 %token          DIRECTIVE_VERSION     // .verions
 
+// never lexed from the text, returned first when parsing a fragment
+%token          FRAGMENT_START
+
 // tokens to support .decl and .input
 %token ALIAS_EQ             // .decl ... alias=...
 %token ALIGN_EQ             // .decl ... align=...
@@ -516,6 +519,13 @@ std::vector<attr_gen_struct*> AttrOptVar;
 
 
 %%
+Input: Listing | Fragment
+
+// a sequence of statements appended to an existing kernel (e.g. inline asm)
+Fragment:
+      FRAGMENT_START NewlinesOpt
+    | FRAGMENT_START NewlinesOpt Statements NewlinesOpt
+
 Listing: NewlinesOpt ListingHeader NewlinesOpt Statements NewlinesOpt {
         TRACE("** Listing Complete\n");
         pBuilder->CISA_post_file_parse();
@@ -9,10 +9,14 @@ SPDX-License-Identifier: MIT
 // PatchInfo linker.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "cm_fc_ld.h"
 
@@ -198,27 +202,37 @@ bool PatchInfoLinker::link(cm::patch::Collection &C) {
     Bin->sortSyncPoints();
     unsigned Start = 0;
     unsigned Inserted = 0;
+    // Offsets of the insert points and the bytes inserted up to and
+    // including each of them, so that relocations are adjusted in one pass
+    // instead of rescanning all of them for every insert point.
+    std::vector<std::pair<unsigned, unsigned>> InsertPoints;
     for (auto SI = Bin->sp_begin(), SE = Bin->sp_end(); SI != SE; ++SI) {
       auto Node = *SI;
       unsigned Offset = Node->getOffset();
       assert(Start <= Offset && "Invalid insert point!");
-      if (Start < Offset) {
+      if (Start < Offset)
         Linked.append(Bin->getData() + Start, Offset - Start);
-        // Adjust relocation in this range.
-        for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
-          unsigned RelOff = RI->getOffset();
-          if (Start <= RelOff && RelOff < Offset)
-            RI->setOffset(RelOff + Inserted);
-        }
-      }
       Start = Offset;
       Inserted += writeSync(Node->getRdTokenMask(), Node->getWrTokenMask());
+      InsertPoints.push_back(std::make_pair(Offset, Inserted));
     }
     Linked.append(Bin->getData() + Start, Bin->getSize() - Start);
-    for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
-      unsigned RelOff = RI->getOffset();
-      if (Start <= RelOff && RelOff < Bin->getSize())
-        RI->setOffset(RelOff + Inserted);
+    // Adjust relocations by the bytes inserted at or before them. They are
+    // looked up by their original offset, so a relocation is never shifted
+    // twice.
+    if (!InsertPoints.empty()) {
+      for (auto RI = Bin->rel_begin(), RE = Bin->rel_end(); RI != RE; ++RI) {
+        unsigned RelOff = RI->getOffset();
+        if (RelOff >= Bin->getSize())
+          continue;
+        auto IP = std::upper_bound(
+            InsertPoints.begin(), InsertPoints.end(), RelOff,
+            [](unsigned Off, const std::pair<unsigned, unsigned> &P) {
+              return Off < P.first;
+            });
+        if (IP != InsertPoints.begin())
+          RI->setOffset(RelOff + std::prev(IP)->second);
+      }
     }
     if (Bin == LastTopBin)
       writeEOT();
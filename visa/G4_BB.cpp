@@ -10,6 +10,7 @@ SPDX-License-Identifier: MIT
 #include "BuildIR.h"
 #include "LocalRA.h" // SECOND_HALF_BANK_START_GRF
 
+#include <atomic>
 #include <ostream>
 
 using namespace vISA;
@@ -1416,6 +1417,7 @@ void G4_BB::addEOTSend(G4_INST* lastInst)
     {
         movInst->inheritDIFrom(lastInst);
     }
+    invalidateOrdinals();
     instList.push_back(movInst);
 
     auto EOT_SFID = builder->getEOTSFID();
@@ -1548,7 +1550,37 @@ void G4_BB::resetLocalIds()
     }
 }
 
+void G4_BB::computeOrdinals()
+{
+    // Epochs are drawn from a global counter so that an ordinal stamped by
+    // another BB, or by an earlier numbering of this one, is never mistaken
+    // for a current one.
+    static std::atomic<uint32_t> nextEpoch(1);
+    ordinalEpoch = nextEpoch++;
+    if (ordinalEpoch == 0)
+    {
+        ordinalEpoch = nextEpoch++;
+    }
+    uint32_t i = 0;
+    for (G4_INST* inst : instList)
+    {
+        inst->setOrdinal(i++, ordinalEpoch);
+    }
+}
+
+bool G4_BB::comesBefore(const G4_INST* a, const G4_INST* b)
+{
+    if (ordinalEpoch == 0 || !a->hasOrdinal(ordinalEpoch) || !b->hasOrdinal(ordinalEpoch))
+    {
+        computeOrdinals();
+    }
+    MUST_BE_TRUE(a->hasOrdinal(ordinalEpoch) && b->hasOrdinal(ordinalEpoch),
+        "comesBefore: instruction is not in this BB");
+    return a->getOrdinal() < b->getOrdinal();
+}
+
 void G4_BB::removeIntrinsics(Intrinsic intrinId) {
+    invalidateOrdinals();
     instList.remove_if([=](G4_INST* inst) {
         return inst->isIntrinsic() &&
             inst->asIntrinsicInst()->getIntrinsicId() == intrinId;
@@ -101,8 +101,15 @@ class G4_BB
 
     INST_LIST instList;
 
+    // Epoch of the current instruction ordinals used by comesBefore(), 0 if
+    // they need to be recomputed. Any change to instList invalidates them.
+    uint32_t ordinalEpoch = 0;
+    void invalidateOrdinals() { ordinalEpoch = 0; }
+    void computeOrdinals();
+
     INST_LIST_ITER insert(INST_LIST::iterator iter, G4_INST* inst)
     {
+        invalidateOrdinals();
         return instList.insert(iter, inst);
     }
 public:
@@ -111,11 +118,13 @@ public:
     INST_LIST_ITER end() { return instList.end(); }
     INST_LIST::reverse_iterator rbegin() { return instList.rbegin(); }
     INST_LIST::reverse_iterator rend() { return instList.rend(); }
-    INST_LIST& getInstList() { return instList; }
+    // callers may modify the list through this reference
+    INST_LIST& getInstList() { invalidateOrdinals(); return instList; }
 
     template <class InputIt>
     INST_LIST_ITER insert(INST_LIST::iterator iter, InputIt first, InputIt last)
     {
+        invalidateOrdinals();
         return instList.insert(iter, first, last);
     }
 
@@ -123,6 +132,7 @@ public:
     {
         if (iter != instList.end() && !inst->isCISAOffValid())
             inst->inheritDIFrom(*iter);
+        invalidateOrdinals();
         return instList.insert(iter, inst);
     }
 
@@ -137,19 +147,22 @@ public:
             // we're processing iter and not ++iter
             inst->inheritDIFrom(*iter);
         }
+        invalidateOrdinals();
         return instList.insert(next, inst);
     }
 
     INST_LIST_ITER erase(INST_LIST::iterator iter) {
+        invalidateOrdinals();
         return instList.erase(iter);
     }
     INST_LIST_ITER erase(INST_LIST::iterator first, INST_LIST::iterator last) {
+        invalidateOrdinals();
         return instList.erase(first, last);
     }
-    void remove(G4_INST* inst) { instList.remove(inst); }
-    void clear() { instList.clear(); }
-    void pop_back() { instList.pop_back(); }
-    void pop_front() { instList.pop_front(); }
+    void remove(G4_INST* inst) { invalidateOrdinals(); instList.remove(inst); }
+    void clear() { invalidateOrdinals(); instList.clear(); }
+    void pop_back() { invalidateOrdinals(); instList.pop_back(); }
+    void pop_front() { invalidateOrdinals(); instList.pop_front(); }
     void push_back(G4_INST* inst) {insertBefore(instList.end(), inst);}
     void push_front(G4_INST* inst) {insertBefore(instList.begin(), inst);}
 
@@ -165,28 +178,34 @@ public:
     // preserve debug info links.
     void splice(INST_LIST::iterator pos, INST_LIST& other)
     {
+        invalidateOrdinals();
         instList.splice(pos, other);
     }
     void splice(INST_LIST::iterator pos, G4_BB* otherBB)
     {
+        invalidateOrdinals();
         instList.splice(pos, otherBB->getInstList());
     }
     void splice(INST_LIST::iterator pos, INST_LIST& other, INST_LIST::iterator it)
     {
+        invalidateOrdinals();
         instList.splice(pos, other, it);
     }
     void splice(INST_LIST::iterator pos, G4_BB* otherBB, INST_LIST::iterator it)
     {
+        invalidateOrdinals();
         instList.splice(pos, otherBB->getInstList(), it);
     }
     void splice(INST_LIST::iterator pos, INST_LIST& other,
         INST_LIST::iterator first, INST_LIST::iterator last)
     {
+        invalidateOrdinals();
         instList.splice(pos, other, first, last);
     }
     void splice(INST_LIST::iterator pos, G4_BB* otherBB,
         INST_LIST::iterator first, INST_LIST::iterator last)
     {
+        invalidateOrdinals();
         instList.splice(pos, otherBB->getInstList(), first, last);
     }
 
@@ -316,6 +335,11 @@ public:
     // reset this BB's instruction's local id so they are [0,..#BBInst-1]
     void resetLocalIds();
 
+    // Returns true if a precedes b in this BB. Both must be in this BB.
+    // Ordinals are computed lazily and kept until the instruction list
+    // changes, so repeated queries without intervening edits are O(1).
+    bool comesBefore(const G4_INST* a, const G4_INST* b);
+
     void removeIntrinsics(Intrinsic intrinId);
 
     void addSamplerFlushBeforeEOT();
@@ -613,10 +613,13 @@ void G4_INST::removeDefUse(Gen4_Operand_Number opndNum)
         if ((*iter).second == opndNum)
         {
             auto defInst = (*iter).first;
-            defInst->useInstList.remove_if(
-                [&](USE_DEF_NODE node) { return node.first == this && node.second == opndNum; });
-            DEF_EDGE_LIST_ITER curr_iter = iter++;
-            defInstList.erase(curr_iter);
+            auto useIt = std::find_if(defInst->useInstList.begin(), defInst->useInstList.end(),
+                [&](const USE_DEF_NODE& node) { return node.first == this && node.second == opndNum; });
+            if (useIt != defInst->useInstList.end())
+            {
+                defInst->useInstList.erase(useIt);
+            }
+            iter = defInstList.erase(iter);
         }
         else
         {
@@ -713,10 +716,9 @@ void G4_INST::copyDef(
                     continue;
                 }
             }
-            I->first->addDefUse(inst2, opndNum2);
+            I->first->addDefUseUnique(inst2, opndNum2);
         }
     }
-    inst2->defInstList.unique();
 }
 
 /// Copy this instruction's defs to inst2.
@@ -1324,6 +1326,46 @@ void G4_INST::addDefUse(G4_INST* inst, Gen4_Operand_Number srcPos)
     inst->defInstList.emplace_back(this, srcPos);
 }
 
+void G4_INST::addDefUseUnique(G4_INST* inst, Gen4_Operand_Number srcPos)
+{
+    if (!hasDefUse(inst, srcPos))
+    {
+        addDefUse(inst, srcPos);
+    }
+}
+
+bool G4_INST::hasDefUse(const G4_INST* inst, Gen4_Operand_Number srcPos) const
+{
+    // the def list of a source is normally much shorter than the use list
+    // of a definition, so look at the use side
+    for (auto&& node : inst->defInstList)
+    {
+        if (node.first == this && node.second == srcPos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool G4_INST::removeDefUse(G4_INST* inst, Gen4_Operand_Number srcPos)
+{
+    // there are no duplicate edges, so stop at the first match on each side
+    auto matches = [&](const G4_INST* other) {
+        return [=](const USE_DEF_NODE& node) { return node.first == other && node.second == srcPos; };
+    };
+    auto useIt = std::find_if(useInstList.begin(), useInstList.end(), matches(inst));
+    if (useIt == useInstList.end())
+    {
+        return false;
+    }
+    useInstList.erase(useIt);
+    auto defIt = std::find_if(inst->defInstList.begin(), inst->defInstList.end(), matches(this));
+    MUST_BE_TRUE(defIt != inst->defInstList.end(), "def-use edge is not symmetric");
+    inst->defInstList.erase(defIt);
+    return true;
+}
+
 // exchange def/use info of src0 and src1 after they are swapped.
 void G4_INST::swapDefUse(Gen4_Operand_Number srcIxA, Gen4_Operand_Number srcIxB)
 {
@@ -301,6 +301,11 @@ protected:
     // instruction's id in BB. Each optimization should re-initialize before using
     int32_t   localId;
 
+    // position in the parent BB, valid only if ordinalEpoch matches the BB's
+    // current epoch (see G4_BB::comesBefore)
+    uint32_t ordinal = 0;
+    uint32_t ordinalEpoch = 0;
+
     static const int UndefinedCisaOffset = -1;
     int srcCISAoff = UndefinedCisaOffset; // record CISA inst offset that resulted in this instruction
 
@@ -759,6 +764,10 @@ public:
     void setLocalId(int32_t lid)  { localId = lid; }
     int32_t getLocalId() const { return localId; }
 
+    void setOrdinal(uint32_t ord, uint32_t epoch) { ordinal = ord; ordinalEpoch = epoch; }
+    bool hasOrdinal(uint32_t epoch) const { return ordinalEpoch == epoch; }
+    uint32_t getOrdinal() const { return ordinal; }
+
     void setEvenlySplitInst(bool val) { evenlySplitInst = val; }
     bool getEvenlySplitInst() { return evenlySplitInst; }
 
@@ -857,6 +866,14 @@ public:
         Gen4_Operand_Number srcIxA = Opnd_src0,
         Gen4_Operand_Number srcIxB = Opnd_src1);
     void addDefUse(G4_INST* use, Gen4_Operand_Number usePos);
+    /// Same as addDefUse, but does nothing if the edge already exists. Use
+    /// this instead of adding edges and calling uniqueDefUse afterwards.
+    void addDefUseUnique(G4_INST* use, Gen4_Operand_Number usePos);
+    /// Returns true if use[usePos] is recorded as a use of this instruction.
+    bool hasDefUse(const G4_INST* use, Gen4_Operand_Number usePos) const;
+    /// Remove the def-use edge this -> use[usePos] from both instructions.
+    /// Returns false if there is no such edge.
+    bool removeDefUse(G4_INST* use, Gen4_Operand_Number usePos);
     void uniqueDefUse()
     {
         useInstList.unique();
@@ -1268,6 +1285,14 @@ class G4_InstCF : public G4_INST
     // branch could be subset of all active lanes on entry to shader/kernel.
     bool isUniformBr;
 
+    // Hints from the front end for goto, kept on the if/else it is
+    // structurized into: whether the condition is uniform within the thread
+    // even though the branch is not, and the profiled percentage of the
+    // channels reaching the branch that execute its fall-through side (-1 if
+    // unknown).
+    bool isThreadUniformCondBr = false;
+    int fallThroughPercent = -1;
+
 public:
 
     static const uint32_t unknownCallee = 0xFFFF;
@@ -1334,6 +1359,12 @@ public:
     void setUniform(bool val) { isUniformBr = val; }
     bool isUniform() const { return isUniformBr; }
 
+    void setThreadUniformCond(bool val) { isThreadUniformCondBr = val; }
+    bool isThreadUniformCond() const { return isThreadUniformCondBr; }
+
+    void setFallThroughPercent(int val) { fallThroughPercent = val; }
+    int getFallThroughPercent() const { return fallThroughPercent; }
+
     bool isIndirectJmp() const;
 
     bool isUniformGoto(unsigned KernelSimdSize) const;
@@ -561,6 +561,104 @@ void G4_Kernel::updateKernelByNumThreads(int nThreads)
     fg.builder->rebuildPhyRegPool(getNumRegTotal());
 }
 
+const std::vector<bool>* G4_Kernel::getCalleeClobberedGRFs(const G4_INST* fcall) const
+{
+    if (!compiledFunctions || fcall->asCFInst()->isIndirectCall() ||
+        !fcall->getSrc(0) || !fcall->getSrc(0)->isLabel())
+    {
+        return nullptr;
+    }
+    auto it = compiledFunctions->find(fcall->getSrc(0)->asLabel()->getLabel());
+    if (it == compiledFunctions->end() || it->second->getClobberedGRFs().size() != numRegTotal)
+    {
+        return nullptr;
+    }
+    return &it->second->getClobberedGRFs();
+}
+
+//
+// Record the GRFs written by the final code of this function, including the
+// GRFs written by its callees. Anything that cannot be bounded (indirect GRF
+// writes, calls to unknown functions) marks the whole register file.
+//
+void G4_Kernel::computeClobberedGRFs()
+{
+    clobberedGRFs.assign(numRegTotal, false);
+    auto markRows = [this](unsigned start, unsigned rows)
+    {
+        for (unsigned i = start; i < start + rows && i < numRegTotal; i++)
+        {
+            clobberedGRFs[i] = true;
+        }
+    };
+
+    for (G4_BB* bb : fg)
+    {
+        for (G4_INST* inst : *bb)
+        {
+            if (inst->isFCall())
+            {
+                const std::vector<bool>* calleeClobbers = getCalleeClobberedGRFs(inst);
+                if (!calleeClobbers)
+                {
+                    clobberedGRFs.assign(numRegTotal, true);
+                    return;
+                }
+                for (unsigned i = 0; i < numRegTotal; i++)
+                {
+                    clobberedGRFs[i] = clobberedGRFs[i] || (*calleeClobbers)[i];
+                }
+            }
+
+            G4_DstRegRegion* dst = inst->getDst();
+            if (!dst || dst->isNullReg())
+            {
+                continue;
+            }
+            if (dst->getRegAccess() != Direct)
+            {
+                clobberedGRFs.assign(numRegTotal, true);
+                return;
+            }
+
+            G4_VarBase* base = dst->getBase();
+            if (base->isRegVar())
+            {
+                G4_Declare* rootDcl = base->asRegVar()->getDeclare()->getRootDeclare();
+                if (rootDcl->getRegFile() != G4_GRF && rootDcl->getRegFile() != G4_INPUT)
+                {
+                    continue;
+                }
+                G4_RegVar* rootVar = rootDcl->getRegVar();
+                if (!rootVar->isPhyRegAssigned())
+                {
+                    clobberedGRFs.assign(numRegTotal, true);
+                    return;
+                }
+                if (!rootVar->getPhyReg()->isGreg())
+                {
+                    continue;
+                }
+                // the whole variable, plus one row if it doesn't start at a
+                // GRF boundary
+                markRows(rootVar->getPhyReg()->asGreg()->getRegNum(),
+                    rootDcl->getNumRows() + (rootVar->getPhyRegOff() ? 1 : 0));
+            }
+            else if (base->isGreg())
+            {
+                unsigned bytes = dst->getSubRegOff() * dst->getTypeSize() +
+                    ((inst->getExecSize() - 1) * dst->getHorzStride() + 1) * dst->getTypeSize();
+                unsigned rows = (bytes + getGRFSize() - 1) / getGRFSize();
+                if (inst->isSend())
+                {
+                    rows = std::max(rows, (unsigned)inst->asSendInst()->getMsgDesc()->getDstLenRegs());
+                }
+                markRows(base->asGreg()->getRegNum() + dst->getRegOff(), rows);
+            }
+        }
+    }
+}
+
 //
 // Evaluate AddrExp/AddrExpList to Imm
 //
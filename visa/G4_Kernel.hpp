@@ -154,6 +154,12 @@ private:
 
     bool m_hasIndirectCall = false;
 
+    // GRFs written by this function or any function it calls, computed once
+    // compilation is done; empty if not computed
+    std::vector<bool> clobberedGRFs;
+    // functions of the same compilation unit compiled before this one
+    const std::map<std::string, G4_Kernel*>* compiledFunctions = nullptr;
+
     VarSplitPass* varSplitPass = nullptr;
 
     // map key is filename string with complete path.
@@ -172,6 +178,9 @@ private:
     std::string            lastG4Asm;
     int                    nextDumpIndex = 0;
 
+    // report of the static performance model (-perfModel)
+    std::string            perfModelReport;
+
     bool sharedDebugInfo = false;
     bool sharedGTPinInfo = false;
 
@@ -296,6 +305,14 @@ public:
     bool hasIndirectCall() const {return m_hasIndirectCall;}
     void setHasIndirectCall() {m_hasIndirectCall = true;}
 
+    // Inter-procedural RA: callers save only the caller-save GRFs that the
+    // callee of a direct call may write.
+    void setCompiledFunctions(const std::map<std::string, G4_Kernel*>* funcs) { compiledFunctions = funcs; }
+    void computeClobberedGRFs();
+    const std::vector<bool>& getClobberedGRFs() const { return clobberedGRFs; }
+    // returns nullptr if the GRFs written by the callee of fcall are not known
+    const std::vector<bool>* getCalleeClobberedGRFs(const G4_INST* fcall) const;
+
     RelocationTableTy& getRelocationTable() {
         return relocationTable;
     }
@@ -312,6 +329,9 @@ public:
 
     VarSplitPass* getVarSplitPass();
 
+    void setPerfModelReport(std::string report) { perfModelReport = std::move(report); }
+    const std::string& getPerfModelReport() const { return perfModelReport; }
+
     VISATarget getKernelType() const { return kernelType; }
     void setKernelType(VISATarget t) { kernelType = t; }
 
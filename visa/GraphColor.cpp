@@ -26,6 +26,7 @@ SPDX-License-Identifier: MIT
 #include <iostream>
 #include <list>
 #include <sstream>
+#include <thread>
 #include "SplitAlignedScalars.h"
 
 using namespace vISA;
@@ -1185,6 +1186,42 @@ void BankConflictPass::setupBankConflictsForBBTGL(
     }
 }
 
+// Record the sources of three source instructions as bank conflict partners
+// of each other, so that register selection can place them in different
+// banks based on the partners' actual assignment.
+void BankConflictPass::setupBankConflictPartners(G4_INST* inst)
+{
+    // bound the work done per register selection for hot variables
+    const unsigned maxPartners = 32;
+
+    G4_Declare* dcls[3];
+    int offset[3];
+    for (int i = 0; i < 3; i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        if (!src || !src->isSrcRegRegion() || src->isAccReg() ||
+            !(dcls[i] = GetTopDclFromRegRegion(src)) ||
+            dcls[i]->getRegFile() != G4_GRF)
+        {
+            return;
+        }
+        G4_Declare* opndDcl = src->getBase()->asRegVar()->getDeclare();
+        offset[i] = (int)((opndDcl->getOffsetFromBase() + src->getLeftBound()) / numEltPerGRF<Type_UB>());
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            if (i != j && dcls[i] != dcls[j] &&
+                gra.getBankConflictDcls(dcls[i]).size() < maxPartners)
+            {
+                gra.addBankConflictDcl(dcls[i], dcls[j], offset[j] - offset[i]);
+            }
+        }
+    }
+}
+
 //Use for BB sorting according to the loop nest level and the BB size.
 bool compareBBLoopLevel(G4_BB* bb1, G4_BB* bb2)
 {
@@ -1215,6 +1252,24 @@ bool BankConflictPass::setupBankConflictsForKernel(bool doLocalRR, bool &threeSo
     std::vector<G4_BB *> orderedBBs(gra.kernel.fg.cbegin(), gra.kernel.fg.cend());
     std::sort(orderedBBs.begin(), orderedBBs.end(), compareBBLoopLevel);
 
+    if (gra.kernel.getOption(vISA_DynamicBankConflictReduction))
+    {
+        for (auto dcl : gra.kernel.Declares)
+        {
+            gra.clearBankConflictDcl(dcl);
+        }
+        for (auto bb : orderedBBs)
+        {
+            for (auto inst : *bb)
+            {
+                if (inst->getNumSrc() == 3 && !inst->isSend() && !inst->isDpas())
+                {
+                    setupBankConflictPartners(inst);
+                }
+            }
+        }
+    }
+
     for (auto bb : orderedBBs)
     {
         unsigned instNum = 0;
@@ -1692,8 +1747,7 @@ bool Interference::interfereBetween(unsigned v1, unsigned v2) const
     }
     else
     {
-        auto&& set = sparseMatrix[v1];
-        return set.find(v2) != set.end();
+        return sparseMatrix[v1].isSet(v2);
     }
 }
 
@@ -2321,7 +2375,7 @@ void Interference::buildInterferenceForFcall(G4_BB* bb, BitSet& live, G4_INST* i
     if (regVar->isRegAllocPartaker())
     {
         unsigned id = static_cast<const G4_RegVar*>(regVar)->getId();
-        lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);
+        addRefCount(id, refCount);
 
         buildInterferenceWithLive(live, id);
         updateLiveness(live, id, false);
@@ -2357,7 +2411,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
         if (!inst->isPseudoKill() &&
             !inst->isLifeTimeEnd())
         {
-            lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);  // update reference count
+            addRefCount(id, refCount);  // update reference count
 
             buildInterferenceWithLive(live, id);
             if (lrs[id]->getIsSplittedDcl())
@@ -2387,7 +2441,7 @@ void Interference::buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* ins
         }
 
         // Indirect defs are actually uses of address reg
-        lrs[id]->checkForInfiniteSpillCost(bb, i);
+        checkForInfiniteSpillCost(id, bb, i);
     }
     else if (dst->isIndirect() && liveAnalysis->livenessClass(G4_GRF))
     {
@@ -2475,7 +2529,9 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 if (dst->getBase()->isRegAllocPartaker() && !dst->getBase()->asRegVar()->isPhyRegAssigned())
                 {
                     int dstId = dst->getBase()->asRegVar()->getId();
-                    lrs[dstId]->markForbidden(kernel.getNumRegTotal() - 1, 1);
+                    LiveRange* lr = lrs[dstId];
+                    unsigned numRegTotal = kernel.getNumRegTotal();
+                    updateLR([lr, numRegTotal]() { lr->markForbidden(numRegTotal - 1, 1); });
                 }
             }
         }
@@ -2529,7 +2585,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 if (srcRegion->getBase()->isRegAllocPartaker())
                 {
                     unsigned id = ((G4_RegVar*)(srcRegion)->getBase())->getId();
-                    lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    addRefCount(id, refCount); // update reference count
 
                     if (!inst->isLifeTimeEnd())
                     {
@@ -2543,16 +2599,23 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                     if (inst->isEOT() && liveAnalysis->livenessClass(G4_GRF))
                     {
                         //mark the liveRange as the EOT source
-                        lrs[id]->setEOTSrc();
-                        if (builder.hasEOTGRFBinding())
+                        LiveRange* lr = lrs[id];
+                        bool bindEOTGRF = builder.hasEOTGRFBinding();
+                        unsigned numRegTotal = kernel.getNumRegTotal();
+                        updateLR([lr, bindEOTGRF, numRegTotal]()
                         {
-                            lrs[id]->markForbidden(0, kernel.getNumRegTotal() - 16);
-                        }
+                            lr->setEOTSrc();
+                            if (bindEOTGRF)
+                            {
+                                lr->markForbidden(0, numRegTotal - 16);
+                            }
+                        });
                     }
 
                     if (inst->isReturn())
                     {
-                        lrs[id]->setRetIp();
+                        LiveRange* lr = lrs[id];
+                        updateLR([lr]() { lr->setRetIp(); });
                     }
                 }
                 else if (srcRegion->isIndirect() && liveAnalysis->livenessClass(G4_GRF))
@@ -2591,7 +2654,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                 unsigned id = flagReg->asRegVar()->getId();
                 if (flagReg->asRegVar()->isRegAllocPartaker())
                 {
-                    lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                    addRefCount(id, refCount); // update reference count
                     buildInterferenceWithLive(live, id);
 
                     if (liveAnalysis->writeWholeRegion(bb, inst, flagReg))
@@ -2599,7 +2662,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
                         updateLiveness(live, id, false);
                     }
 
-                    lrs[id]->checkForInfiniteSpillCost(bb, i);
+                    checkForInfiniteSpillCost(id, bb, i);
                 }
             }
             else
@@ -2620,7 +2683,7 @@ void Interference::buildInterferenceWithinBB(G4_BB* bb, BitSet& live)
             unsigned id = flagReg->asRegVar()->getId();
             if (flagReg->asRegVar()->isRegAllocPartaker())
             {
-                lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount); // update reference count
+                addRefCount(id, refCount); // update reference count
                 live.set(id, true);
             }
         }
@@ -2658,31 +2721,151 @@ void Interference::applyPartitionBias()
     }
 }
 
+thread_local IntfBuildWorker* Interference::worker = nullptr;
+
+void Interference::addRefCount(unsigned id, unsigned refCount)
+{
+    if (worker && !gra.isBlockLocal(lrs[id]->getDcl()))
+    {
+        worker->refCounts.emplace_back(id, refCount);
+        return;
+    }
+    lrs[id]->setRefCount(lrs[id]->getRefCount() + refCount);
+}
+
+void Interference::checkForInfiniteSpillCost(unsigned id, G4_BB* bb, std::list<G4_INST*>::reverse_iterator& it)
+{
+    if (worker && !gra.isBlockLocal(lrs[id]->getDcl()))
+    {
+        // this only resets the candidate state of a global range
+        LiveRange* lr = lrs[id];
+        auto lrIt = it;
+        worker->lrUpdates.emplace_back([lr, bb, lrIt]() mutable { lr->checkForInfiniteSpillCost(bb, lrIt); });
+        return;
+    }
+    lrs[id]->checkForInfiniteSpillCost(bb, it);
+}
+
+bool Interference::useParallelBuild(unsigned numThreads) const
+{
+    // Debug info and stack call handling update shared state while walking
+    // the instructions, so they always use the serial build.
+    return numThreads > 1 &&
+        kernel.fg.size() >= 2 * numThreads &&
+        !builder.getOption(vISA_GenerateDebugInfo) &&
+        !kernel.fg.getHasStackCalls() &&
+        !kernel.fg.getIsStackCallFunc();
+}
+
+//
+// Build the per-BB interferences with numThreads workers, each owning a
+// contiguous range of BBs with about the same number of instructions. Workers
+// record matrix updates and updates to global live ranges, which are merged
+// in BB order once all of them are done.
+//
+void Interference::buildInterferenceParallel(unsigned numThreads)
+{
+    std::vector<G4_BB*> bbs(kernel.fg.begin(), kernel.fg.end());
+    size_t numInsts = 0;
+    for (auto bb : bbs)
+    {
+        numInsts += bb->size();
+    }
+
+    std::vector<size_t> rangeStart;
+    size_t instsPerThread = numInsts / numThreads + 1;
+    size_t curInsts = 0;
+    rangeStart.push_back(0);
+    for (size_t i = 0; i < bbs.size(); ++i)
+    {
+        if (curInsts >= instsPerThread && rangeStart.size() < numThreads)
+        {
+            rangeStart.push_back(i);
+            curInsts = 0;
+        }
+        curInsts += bbs[i]->size();
+    }
+    rangeStart.push_back(bbs.size());
+
+    size_t numRanges = rangeStart.size() - 1;
+    std::vector<IntfBuildWorker> workers(numRanges);
+    std::vector<std::thread> threads;
+    threads.reserve(numRanges);
+    for (size_t r = 0; r < numRanges; ++r)
+    {
+        threads.emplace_back([&, r]()
+        {
+            worker = &workers[r];
+            BitSet live(maxId, false);
+            for (size_t i = rangeStart[r]; i < rangeStart[r + 1]; ++i)
+            {
+                live.clear();
+                buildInterferenceAtBBExit(bbs[i], live);
+                buildInterferenceWithinBB(bbs[i], live);
+            }
+            worker = nullptr;
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    for (auto& w : workers)
+    {
+        for (auto& edge : w.edges)
+        {
+            safeSetInterference(edge.first, edge.second);
+        }
+        for (auto& block : w.blocks)
+        {
+            setBlockInterferencesOneWay(std::get<0>(block), std::get<1>(block), std::get<2>(block));
+        }
+        for (auto& ref : w.refCounts)
+        {
+            lrs[ref.first]->setRefCount(lrs[ref.first]->getRefCount() + ref.second);
+        }
+        for (auto& update : w.lrUpdates)
+        {
+            update();
+        }
+    }
+}
+
 void Interference::computeInterference()
 {
     startTimer(TimerID::INTERFERENCE);
-    //
-    // create bool vector, live, to track live ranges that are currently live
-    //
-    BitSet live(maxId, false);
 
     buildInterferenceAmongLiveOuts();
 
-    for (G4_BB *bb : kernel.fg)
+    unsigned numThreads = builder.getOptions()->getuInt32Option(vISA_IntfBuildThreads);
+    if (useParallelBuild(numThreads))
+    {
+        buildInterferenceParallel(numThreads);
+    }
+    else
     {
         //
-        // mark all live ranges dead
-        //
-        live.clear();
-        //
-        // start with all live ranges that are live at the exit of BB
-        //
-        buildInterferenceAtBBExit(bb, live);
-        //
-        // traverse inst in the reverse order
+        // create bool vector, live, to track live ranges that are currently live
         //
+        BitSet live(maxId, false);
 
-        buildInterferenceWithinBB(bb, live);
+        for (G4_BB *bb : kernel.fg)
+        {
+            //
+            // mark all live ranges dead
+            //
+            live.clear();
+            //
+            // start with all live ranges that are live at the exit of BB
+            //
+            buildInterferenceAtBBExit(bb, live);
+            //
+            // traverse inst in the reverse order
+            //
+
+            buildInterferenceWithinBB(bb, live);
+        }
     }
 
     buildInterferenceAmongLiveIns();
@@ -2727,13 +2910,13 @@ void Interference::generateSparseIntfGraph()
 
     sparseIntf.resize(numVars);
 
-    for (unsigned row = 0; row < numVars; row++)
-    {
-        sparseIntf[row].reserve(SPARSE_INTF_VEC_SIZE);
-    }
-
     if (useDenseMatrix())
     {
+        for (unsigned row = 0; row < numVars; row++)
+        {
+            sparseIntf[row].reserve(SPARSE_INTF_VEC_SIZE);
+        }
+
         // Iterate over intf graph matrix
         for (unsigned row = 0; row < numVars; row++)
         {
@@ -2762,14 +2945,29 @@ void Interference::generateSparseIntfGraph()
     }
     else
     {
+        // reserve the exact degree of each var, as the default reservation
+        // is too much for the number of vars that uses the sparse matrix
+        std::vector<uint32_t> degree(numVars, 0);
+        for (uint32_t v1 = 0; v1 < maxId; ++v1)
+        {
+            sparseMatrix[v1].forEach([&](uint32_t v2)
+            {
+                ++degree[v1];
+                ++degree[v2];
+            });
+        }
+        for (uint32_t v = 0; v < numVars; ++v)
+        {
+            sparseIntf[v].reserve(degree[v]);
+        }
+
         for (uint32_t v1 = 0; v1 < maxId; ++v1)
         {
-            auto&& intfSet = sparseMatrix[v1];
-            for (uint32_t v2 : intfSet)
+            sparseMatrix[v1].forEach([&](uint32_t v2)
             {
                 sparseIntf[v1].emplace_back(v2);
                 sparseIntf[v2].emplace_back(v1);
-            }
+            });
         }
     }
 
@@ -5777,11 +5975,81 @@ void GraphColor::computeDegreeForARF()
     }
 }
 
+//
+// For each variable, compute the nesting level of the innermost loop it is live
+// through without being referenced in it (0 if there is no such loop). Spilling
+// such a variable relieves the register pressure of the whole loop, while the
+// spill/fill code is only inserted at its references outside of the loop.
+//
+void GraphColor::computeLoopThroughLevels(std::vector<unsigned>& levels)
+{
+    levels.assign(numVar, 0);
+
+    std::vector<std::pair<Loop*, unsigned>> worklist;
+    for (auto loop : builder.kernel.fg.getLoops().getTopLoops())
+    {
+        worklist.emplace_back(loop, 1);
+    }
+
+    while (!worklist.empty())
+    {
+        Loop* loop = worklist.back().first;
+        unsigned level = worklist.back().second;
+        worklist.pop_back();
+        for (auto nested : loop->immNested)
+        {
+            worklist.emplace_back(nested, level + 1);
+        }
+
+        BitSet referenced(numVar, false);
+        auto markRef = [&referenced](G4_Operand* opnd)
+        {
+            if (opnd && opnd->getBase() && opnd->getBase()->isRegAllocPartaker())
+            {
+                referenced.set(opnd->getBase()->asRegVar()->getId(), true);
+            }
+        };
+        for (auto bb : loop->getBBs())
+        {
+            for (auto inst : *bb)
+            {
+                markRef(inst->getDst());
+                for (unsigned i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+                {
+                    markRef(inst->getSrc(i));
+                }
+            }
+        }
+
+        G4_BB* header = loop->getHeader();
+        BitSet liveThrough = liveAnalysis.use_in[header->getId()];
+        liveThrough &= liveAnalysis.def_in[header->getId()];
+        liveThrough -= referenced;
+        // indirect references are not tracked above
+        liveThrough -= liveAnalysis.addr_taken;
+        for (unsigned i = 0; i < numVar; i++)
+        {
+            if (liveThrough.isSet(i))
+            {
+                levels[i] = std::max(levels[i], level);
+            }
+        }
+    }
+}
+
 void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
 {
     std::vector <LiveRange *> addressSensitiveVars;
     float maxNormalCost = 0.0f;
 
+    std::vector<unsigned> loopThroughLevels;
+    if (liveAnalysis.livenessClass(G4_GRF) &&
+        m_options->getOption(vISA_ConsiderLoopInfoInRA) &&
+        m_options->getOption(vISA_LoopThroughSpillCost))
+    {
+        computeLoopThroughLevels(loopThroughLevels);
+    }
+
     for (unsigned i = 0; i < numVar; i++)
     {
         G4_Declare* dcl = lrs[i]->getDcl();
@@ -5867,6 +6135,20 @@ void GraphColor::computeSpillCosts(bool useSplitLLRHeuristic)
                     lrs[i]->getDegree() : 1.0f*lrs[i]->getRefCount()*lrs[i]->getRefCount() / (lrs[i]->getDegree() + 1);
             }
 
+            // Prefer spilling ranges that are live through a loop but not used in it,
+            // scaled the same way as references in loops.
+            if (!loopThroughLevels.empty() && loopThroughLevels[i] > 0)
+            {
+                spillCost /= GlobalRA::getRefCount(loopThroughLevels[i]);
+            }
+
+            // A flag that can be recomputed costs one cmp per use instead of
+            // a fill per use plus a store, so prefer it when spilling flags.
+            if (dcl->getRegFile() == G4_FLAG && gra.getFlagRematInst(dcl))
+            {
+                spillCost /= 2;
+            }
+
             lrs[i]->setSpillCost(spillCost);
 
             // Track address sensitive live range.
@@ -6171,6 +6453,55 @@ void PhyRegUsage::updateRegUsage(LiveRange* lr)
     }
 }
 
+// Partition the LRs to color into connected components of the interference
+// graph. Returns the number of components, or 0 if some LR takes part in
+// assignment logic that reaches beyond its neighbors (split variables,
+// allocation hints and weak edges), in which case coloring must be serial.
+unsigned GraphColor::computeColoringComponents(std::vector<unsigned>& componentOf) const
+{
+    std::vector<unsigned> parent(numVar);
+    for (unsigned i = 0; i < numVar; i++)
+        parent[i] = i;
+    auto find = [&](unsigned i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    auto& varSplitPass = *gra.getVarSplitPass();
+    for (auto lr : colorOrder)
+    {
+        auto dcl = lr->getDcl();
+        if (lr->hasAllocHint() || varSplitPass.isSplitDcl(dcl) || varSplitPass.isPartialDcl(dcl) ||
+            intf.getCompatibleSparseIntf(lr->getVar()->getDeclare()->getRootDeclare()))
+            return 0;
+
+        unsigned id = lr->getVar()->getId();
+        for (auto it : intf.getSparseIntfForVar(id))
+        {
+            // partial dcls are assigned through their parent LR
+            unsigned other = lrs[it]->getIsPartialDcl() ? lrs[it]->getParentLRID() : it;
+            parent[find(id)] = find(other);
+        }
+    }
+
+    componentOf.assign(numVar, UINT_MAX);
+    unsigned numComponents = 0;
+    std::vector<unsigned> rootToComponent(numVar, UINT_MAX);
+    for (auto lr : colorOrder)
+    {
+        unsigned root = find(lr->getVar()->getId());
+        if (rootToComponent[root] == UINT_MAX)
+            rootToComponent[root] = numComponents++;
+        componentOf[lr->getVar()->getId()] = rootToComponent[root];
+    }
+    return numComponents;
+}
+
 bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConflict, bool highInternalConflict, bool honorHints)
 {
     if (builder.getOption(vISA_RATrace))
@@ -6208,6 +6539,9 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
         bank2_end = bank1_end + 1;
     }
 
+    // the register usage arrays are only needed during this attempt, and
+    // assignColors may be retried several times on the same GraphColor
+    ScopedMemMark attemptMark(mem);
     bool* availableGregs = (bool *)mem.alloc(sizeof(bool)* totalGRFNum);
     uint32_t* availableSubRegs = (uint32_t *)mem.alloc(sizeof(uint32_t)* totalGRFNum);
     bool* availableAddrs = (bool *)mem.alloc(sizeof(bool)* getNumAddrRegisters());
@@ -6237,7 +6571,10 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
     // and we want to get fully coalesceable assignment for parent. In such circumstance, we
     // dont want to account for interference between parent/child since doing so cannot result
     // in a coalesceable assignment.
-    auto assignColor = [&](LiveRange* lr, bool ignoreChildrenIntf = false, bool spillAllowed = true, bool returnFalseOnFail = false)
+    // parms and spilled are passed in so that independent components can be
+    // colored concurrently, each with its own register usage state.
+    auto assignColorWithParms = [&](PhyRegUsageParms& parms, LIVERANGE_LIST& spilled, LiveRange* lr,
+        bool ignoreChildrenIntf, bool spillAllowed, bool returnFalseOnFail)
     {
         auto lrVar = lr->getVar();
 
@@ -6430,7 +6767,7 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
                     {
                         // When retrying a coalesceable assignment, dont spill
                         // if there is no GRF available.
-                        spilledLRs.push_back(lr);
+                        spilled.push_back(lr);
                         lr->setSpilled(true);
                     }
                 }
@@ -6457,8 +6794,115 @@ bool GraphColor::assignColors(ColorHeuristic colorHeuristicGRF, bool doBankConfl
         return true;
     };
 
+    auto assignColor = [&](LiveRange* lr, bool ignoreChildrenIntf = false, bool spillAllowed = true, bool returnFalseOnFail = false)
+    {
+        return assignColorWithParms(parms, spilledLRs, lr, ignoreChildrenIntf, spillAllowed, returnFalseOnFail);
+    };
+
+    // Color connected components of the interference graph concurrently. Each
+    // worker colors its components in colorOrder with private register usage
+    // state, so the assignment is the same as a serial run where each
+    // component starts with fresh round-robin state. Physical register
+    // constraints shared across components (callee-save, stack call frame
+    // and reserved GRFs) are already encoded in each LR's forbidden set, so
+    // only the spill lists need merging, in colorOrder.
+    unsigned numThreads = builder.getOptions()->getuInt32Option(vISA_ColoringThreads);
+    std::vector<unsigned> componentOf;
+    unsigned numComponents = numThreads > 1 && colorOrder.size() >= 2 * numThreads ?
+        computeColoringComponents(componentOf) : 0;
+    if (numComponents >= 2)
+    {
+        numThreads = std::min(numThreads, numComponents);
+
+        // balance workers by number of LRs, largest components first
+        std::vector<unsigned> componentSize(numComponents, 0);
+        for (auto lr : colorOrder)
+            componentSize[componentOf[lr->getVar()->getId()]]++;
+        std::vector<unsigned> byDecreasingSize(numComponents);
+        for (unsigned i = 0; i < numComponents; i++)
+            byDecreasingSize[i] = i;
+        std::stable_sort(byDecreasingSize.begin(), byDecreasingSize.end(),
+            [&](unsigned c1, unsigned c2) { return componentSize[c1] > componentSize[c2]; });
+        std::vector<unsigned> workerOf(numComponents), workerLoad(numThreads, 0);
+        for (auto c : byDecreasingSize)
+        {
+            unsigned w = (unsigned)(std::min_element(workerLoad.begin(), workerLoad.end()) - workerLoad.begin());
+            workerOf[c] = w;
+            workerLoad[w] += componentSize[c];
+        }
+
+        std::vector<std::vector<LiveRange*>> workerOrder(numThreads);
+        for (auto iter = colorOrder.rbegin(), iterEnd = colorOrder.rend(); iter != iterEnd; ++iter)
+            workerOrder[workerOf[componentOf[(*iter)->getVar()->getId()]]].push_back(*iter);
+
+        std::vector<LIVERANGE_LIST> workerSpills(numThreads);
+        std::vector<char> workerFailed(numThreads, 0);
+        auto colorWorker = [&](unsigned w)
+        {
+            unsigned wStartARFReg = startARFReg, wStartFLAGReg = startFLAGReg, wStartGRFReg = startGRFReg;
+            unsigned wBank1Start = bank1_start, wBank1End = bank1_end, wBank2Start = bank2_start, wBank2End = bank2_end;
+            std::unique_ptr<bool[]> wGregs(new bool[totalGRFNum]);
+            std::unique_ptr<uint32_t[]> wSubRegs(new uint32_t[totalGRFNum]);
+            std::unique_ptr<bool[]> wAddrs(new bool[getNumAddrRegisters()]);
+            std::unique_ptr<bool[]> wFlags(new bool[builder.getNumFlagRegisters()]);
+            std::unique_ptr<uint8_t[]> wWeakEdges(new uint8_t[totalGRFNum]);
+            PhyRegUsageParms wParms(gra, lrs, rFile, maxGRFCanBeUsed, wStartARFReg, wStartFLAGReg, wStartGRFReg,
+                wBank1Start, wBank1End, wBank2Start, wBank2End, doBankConflict,
+                wGregs.get(), wSubRegs.get(), wAddrs.get(), wFlags.get(), wWeakEdges.get());
+            for (auto lr : workerOrder[w])
+            {
+                if (lr->isSpilled())
+                    continue;
+                if (!assignColorWithParms(wParms, workerSpills[w], lr, false, true, false))
+                {
+                    workerFailed[w] = 1;
+                    return;
+                }
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (unsigned w = 1; w < numThreads; w++)
+            workers.emplace_back(colorWorker, w);
+        colorWorker(0);
+        for (auto& t : workers)
+            t.join();
+
+        // early exit
+        if (std::find(workerFailed.begin(), workerFailed.end(), 1) != workerFailed.end())
+            return false;
+
+        std::unordered_map<LiveRange*, unsigned> orderIdx;
+        for (unsigned i = 0; i < colorOrder.size(); i++)
+            orderIdx[colorOrder[i]] = i;
+        std::vector<LiveRange*> spills;
+        for (auto& ws : workerSpills)
+            spills.insert(spills.end(), ws.begin(), ws.end());
+        std::sort(spills.begin(), spills.end(),
+            [&](LiveRange* lr1, LiveRange* lr2) { return orderIdx[lr1] > orderIdx[lr2]; });
+        bool infiniteCostSpilled = false;
+        for (auto lr : spills)
+        {
+            spilledLRs.push_back(lr);
+            infiniteCostSpilled |= lr->getSpillCost() == MAXSPILLCOST;
+        }
+
+        if (infiniteCostSpilled && honorHints)
+        {
+            resetTemporaryRegisterAssignments();
+            return assignColors(colorHeuristicGRF, doBankConflict, highInternalConflict, false);
+        }
+
+        if (builder.getOption(vISA_RATrace))
+        {
+            std::cout << "\t--colored " << numComponents << " interference graph components on "
+                << numThreads << " threads\n";
+        }
+    }
+
     // colorOrder is in reverse order (unconstrained at front)
-    for (auto iter = colorOrder.rbegin(), iterEnd = colorOrder.rend(); iter != iterEnd; ++iter)
+    for (auto iter = colorOrder.rbegin(), iterEnd = colorOrder.rend();
+        numComponents < 2 && iter != iterEnd; ++iter)
     {
         auto lr = (*iter);
 
@@ -7189,6 +7633,247 @@ void GraphColor::cleanupRedundantARFFillCode()
     }
 }
 
+//
+// Assign the address/flag temps created by SpillManager without another round
+// of liveness and coloring. The temps are block local and short, so each block
+// is scanned backward to find the units occupied by the live ranges colored in
+// this round, and the temps are then assigned as intervals over that linear
+// order. Returns false, with no temp assigned, if any temp does not fit; the
+// caller then falls back to a new RA iteration.
+//
+bool GraphColor::assignARFSpillTemps()
+{
+    const G4_RegFileKind kind = liveAnalysis.livenessClass(G4_FLAG) ? G4_FLAG : G4_ADDRESS;
+    const unsigned numUnits =
+        kind == G4_FLAG ? builder.getNumFlagRegisters() : getNumAddrRegisters();
+    if (numUnits > 64)
+    {
+        return false;
+    }
+
+    auto getUnitMask = [kind](const G4_Declare* dcl, const G4_VarBase* phyReg, unsigned off)
+    {
+        unsigned start = kind == G4_FLAG ?
+            phyReg->asAreg()->getFlagNum() * 2 + off : off * dcl->getElemSize() / G4_WSIZE;
+        unsigned num = PhyRegUsage::numAllocUnit(dcl->getNumElems(), dcl->getElemType());
+        return ((num >= 64 ? ~0ULL : (1ULL << num) - 1)) << start;
+    };
+
+    struct TempInterval
+    {
+        G4_Declare* dcl;
+        unsigned bbId;
+        unsigned first;
+        unsigned last;
+        uint64_t mask;
+    };
+    std::vector<TempInterval> temps;
+    std::unordered_map<const G4_Declare*, unsigned> tempIdx;
+
+    std::vector<unsigned> unitRefs(numUnits, 0);
+    std::vector<bool> live(numVar, false);
+    std::vector<uint64_t> occupied;
+    std::vector<G4_INST*> insts;
+
+    for (G4_BB* bb : kernel.fg)
+    {
+        insts.assign(bb->begin(), bb->end());
+        occupied.assign(insts.size(), 0);
+        std::fill(unitRefs.begin(), unitRefs.end(), 0);
+        std::fill(live.begin(), live.end(), false);
+        uint64_t liveMask = 0;
+
+        auto setLive = [&](unsigned id, bool isLive)
+        {
+            if (live[id] == isLive)
+            {
+                return;
+            }
+            live[id] = isLive;
+            uint64_t mask = getUnitMask(lrs[id]->getDcl(), lrs[id]->getPhyReg(), lrs[id]->getPhyRegOff());
+            for (unsigned i = 0; i < numUnits; i++)
+            {
+                if (mask & (1ULL << i))
+                {
+                    isLive ? unitRefs[i]++ : unitRefs[i]--;
+                    liveMask = unitRefs[i] ? liveMask | (1ULL << i) : liveMask & ~(1ULL << i);
+                }
+            }
+        };
+
+        for (unsigned id = 0; id < numVar; id++)
+        {
+            if (lrs[id]->getPhyReg() && liveAnalysis.isLiveAtExit(bb, id))
+            {
+                setLive(id, true);
+            }
+        }
+
+        for (unsigned idx = (unsigned)insts.size(); idx-- > 0;)
+        {
+            G4_INST* inst = insts[idx];
+            unsigned defId = UINT_MAX, condModId = UINT_MAX;
+            std::vector<unsigned> useIds;
+            uint64_t refMask = 0;
+
+            for (unsigned i = 0; i < Opnd_implAccSrc; i++)
+            {
+                auto opndNum = static_cast<Gen4_Operand_Number>(i);
+                G4_Operand* opnd = inst->getOperand(opndNum);
+                G4_VarBase* base = opnd ? opnd->getBase() : nullptr;
+                if (!base)
+                {
+                    continue;
+                }
+                if (base->isPhyAreg())
+                {
+                    if ((kind == G4_FLAG && base->isFlag()) || (kind == G4_ADDRESS && base->isA0()))
+                    {
+                        // hard coded register, whose live range is not known
+                        return false;
+                    }
+                    continue;
+                }
+                if (!base->isRegVar() || base->asRegVar()->getDeclare()->getRegFile() != kind)
+                {
+                    continue;
+                }
+
+                G4_Declare* dcl = base->asRegVar()->getDeclare()->getRootDeclare();
+                G4_RegVar* var = dcl->getRegVar();
+                if (var->isRegAllocPartaker())
+                {
+                    unsigned id = var->getId();
+                    if (!lrs[id]->getPhyReg())
+                    {
+                        return false;
+                    }
+                    refMask |= getUnitMask(dcl, lrs[id]->getPhyReg(), lrs[id]->getPhyRegOff());
+                    if (opndNum == Opnd_dst && opnd->asDstRegRegion()->getRegAccess() == Direct)
+                    {
+                        defId = id;
+                    }
+                    else if (opndNum == Opnd_condMod)
+                    {
+                        condModId = id;
+                    }
+                    else
+                    {
+                        useIds.push_back(id);
+                    }
+                }
+                else if (gra.isAddrFlagSpillDcl(dcl) && !var->isPhyRegAssigned())
+                {
+                    auto it = tempIdx.find(dcl);
+                    if (it == tempIdx.end())
+                    {
+                        tempIdx[dcl] = (unsigned)temps.size();
+                        temps.push_back({ dcl, bb->getId(), idx, idx, 0 });
+                    }
+                    else if (temps[it->second].bbId != bb->getId())
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        temps[it->second].first = idx;
+                    }
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            occupied[idx] = liveMask | refMask;
+
+            if (defId != UINT_MAX &&
+                liveAnalysis.writeWholeRegion(bb, inst, inst->getDst(), builder.getOptions()))
+            {
+                setLive(defId, false);
+            }
+            if (condModId != UINT_MAX &&
+                liveAnalysis.writeWholeRegion(bb, inst, inst->getCondMod()->getBase()))
+            {
+                setLive(condModId, false);
+            }
+            for (unsigned id : useIds)
+            {
+                setLive(id, true);
+            }
+        }
+
+        // interval coloring of the temps of this block in order of their start
+        std::vector<TempInterval*> bbTemps;
+        for (auto& temp : temps)
+        {
+            if (temp.bbId == bb->getId())
+            {
+                bbTemps.push_back(&temp);
+            }
+        }
+        std::sort(bbTemps.begin(), bbTemps.end(),
+            [](const TempInterval* t1, const TempInterval* t2) { return t1->first < t2->first; });
+
+        for (unsigned i = 0; i < bbTemps.size(); i++)
+        {
+            TempInterval* temp = bbTemps[i];
+            uint64_t busy = 0;
+            for (unsigned idx = temp->first; idx <= temp->last; idx++)
+            {
+                busy |= occupied[idx];
+            }
+            for (unsigned j = 0; j < i; j++)
+            {
+                if (bbTemps[j]->last >= temp->first)
+                {
+                    busy |= bbTemps[j]->mask;
+                }
+            }
+
+            unsigned num = PhyRegUsage::numAllocUnit(temp->dcl->getNumElems(), temp->dcl->getElemType());
+            unsigned align = std::max<unsigned>(static_cast<unsigned>(gra.getSubRegAlign(temp->dcl)),
+                kind == G4_ADDRESS ? temp->dcl->getElemSize() / G4_WSIZE : 1);
+            uint64_t tempMask = (num >= 64 ? ~0ULL : (1ULL << num) - 1);
+            for (unsigned start = 0; start + num <= numUnits; start += align)
+            {
+                if (!(busy & (tempMask << start)))
+                {
+                    temp->mask = tempMask << start;
+                    break;
+                }
+            }
+            if (!temp->mask)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (auto& temp : temps)
+    {
+        unsigned start = 0;
+        while (!(temp.mask & (1ULL << start)))
+        {
+            start++;
+        }
+        if (kind == G4_FLAG)
+        {
+            temp.dcl->getRegVar()->setPhyReg(regPool.getFlagAreg(start / 2), start & 1);
+        }
+        else
+        {
+            temp.dcl->getRegVar()->setPhyReg(regPool.getAddrReg(), start * G4_WSIZE / temp.dcl->getElemSize());
+        }
+        if (builder.getOption(vISA_RATrace))
+        {
+            std::cout << "\t--" << temp.dcl->getName() << " assigned without RA iteration\n";
+        }
+    }
+
+    return true;
+}
+
 void GraphColor::pruneActiveSpillAddrLocs(G4_DstRegRegion* dstRegion, unsigned exec_size, G4_Type exec_type)
 {
     if (dstRegion->getBase()->asRegVar()->isRegVarAddrSpillLoc()) {
@@ -7649,6 +8334,27 @@ void GlobalRA::OptimizeActiveRegsFootprint(std::vector<bool>& saveRegs, std::vec
     }
 }
 
+void GlobalRA::pruneCallerSaveRegsByCallee(G4_BB* bb)
+{
+    if (!kernel.getOption(vISA_IPRA))
+    {
+        return;
+    }
+    const std::vector<bool>* calleeClobbers = kernel.getCalleeClobberedGRFs(bb->back());
+    if (!calleeClobbers)
+    {
+        return;
+    }
+    auto& csrs = callerSaveRegsMap[bb];
+    unsigned count = 0;
+    for (unsigned i = 0, e = (unsigned)csrs.size(); i < e; i++)
+    {
+        csrs[i] = csrs[i] && (*calleeClobbers)[i];
+        count += csrs[i] ? 1 : 0;
+    }
+    callerSaveRegCountMap[bb] = count;
+}
+
 void GraphColor::getCallerSaveRegisters()
 {
     unsigned callerSaveNumGRF = builder.kernel.getCallerSaveLastGRF() + 1;
@@ -7706,6 +8412,8 @@ void GraphColor::getCallerSaveRegisters()
             }
 
             gra.callerSaveRegCountMap[(*it)] = callerSaveRegCount;
+            gra.pruneCallerSaveRegsByCallee(*it);
+            callerSaveRegCount = gra.callerSaveRegCountMap[(*it)];
 
             if (builder.kernel.getOption(vISA_OptReport))
             {
@@ -9402,6 +10110,8 @@ void GlobalRA::addrRegAlloc()
     uint32_t addrSpillId = 0;
     unsigned maxRAIterations = 10;
     unsigned iterationNo = 0;
+    bool assignSpillTemps = builder.getOption(vISA_ARFSpillTempAssignment) &&
+        !builder.kernel.fg.getHasStackCalls() && !builder.kernel.fg.getIsStackCallFunc();
 
     while (iterationNo < maxRAIterations)
     {
@@ -9431,9 +10141,11 @@ void GlobalRA::addrRegAlloc()
 
                 //
                 // if new addr temps are created, we need to do RA again so that newly created temps
-                // can get registers. If there are no more newly created temps, we then commit reg assignments
+                // can get registers, unless they all fit around the assignments of this iteration.
+                // If there are no more newly created temps, we then commit reg assignments
                 //
-                if (spillARF.isAnyNewTempCreated() == false)
+                if (spillARF.isAnyNewTempCreated() == false ||
+                    (assignSpillTemps && coloring.assignARFSpillTemps()))
                 {
                     coloring.confirmRegisterAssignments();
                     coloring.cleanupRedundantARFFillCode();
@@ -9472,12 +10184,152 @@ void GlobalRA::addrRegAlloc()
     MUST_BE_TRUE(iterationNo < maxRAIterations, "Address RA has failed.");
 }
 
+//
+// A flag whose only definition is a plain cmp, with all uses being predicates
+// later in the same block and no source of the cmp redefined in between, can
+// be recomputed at each use instead of being spilled. Record that cmp as the
+// flag's remat recipe for the flag spill manager.
+//
+void GlobalRA::computeFlagRematRecipes()
+{
+    struct FlagRefs
+    {
+        G4_INST* def = nullptr;
+        G4_BB* defBB = nullptr;
+        INST_LIST_ITER defIt;
+        unsigned numDefs = 0;
+        bool hasOtherRef = false;
+        std::vector<G4_INST*> uses;
+    };
+    std::unordered_map<G4_Declare*, FlagRefs> flagRefs;
+    auto getFlagDcl = [](G4_Operand* opnd) -> G4_Declare*
+    {
+        if (!opnd || !opnd->getBase() || !opnd->getBase()->isRegVar() ||
+            !opnd->getBase()->asRegVar()->isRegAllocPartaker())
+        {
+            return nullptr;
+        }
+        G4_Declare* dcl = opnd->getTopDcl();
+        return (dcl && dcl->getRegFile() == G4_FLAG) ? dcl : nullptr;
+    };
+
+    for (G4_BB* bb : kernel.fg)
+    {
+        for (auto it = bb->begin(), ie = bb->end(); it != ie; ++it)
+        {
+            G4_INST* inst = *it;
+            if (G4_Declare* dcl = getFlagDcl(inst->getCondMod()))
+            {
+                auto& refs = flagRefs[dcl];
+                refs.numDefs++;
+                refs.def = inst;
+                refs.defBB = bb;
+                refs.defIt = it;
+            }
+            if (G4_Declare* dcl = getFlagDcl(inst->getPredicate()))
+            {
+                flagRefs[dcl].uses.push_back(inst);
+            }
+            if (G4_Declare* dcl = getFlagDcl(inst->getDst()))
+            {
+                flagRefs[dcl].hasOtherRef = true;
+            }
+            for (unsigned i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+            {
+                if (G4_Declare* dcl = getFlagDcl(inst->getSrc(i)))
+                {
+                    flagRefs[dcl].hasOtherRef = true;
+                }
+            }
+        }
+    }
+    for (G4_Declare* dcl : kernel.Declares)
+    {
+        if (dcl->getAliasDeclare() && flagRefs.count(dcl->getRootDeclare()))
+        {
+            flagRefs[dcl->getRootDeclare()].hasOtherRef = true;
+        }
+    }
+
+    for (auto& entry : flagRefs)
+    {
+        G4_Declare* dcl = entry.first;
+        FlagRefs& refs = entry.second;
+        G4_INST* def = refs.def;
+        if (refs.numDefs != 1 || refs.hasOtherRef || refs.uses.empty() || dcl->getAliasDeclare() ||
+            def->opcode() != G4_cmp || def->getPredicate() || !def->getDst()->isNullReg() ||
+            def->getCondMod()->getSubRegOff() != 0 ||
+            def->getExecSize() < dcl->getNumberFlagElements() ||
+            def->getImplAccSrc() || def->getImplAccDst())
+        {
+            continue;
+        }
+
+        std::vector<G4_Declare*> srcDcls;
+        bool validSrcs = true;
+        for (unsigned i = 0, numSrc = def->getNumSrc(); i < numSrc && validSrcs; i++)
+        {
+            G4_Operand* src = def->getSrc(i);
+            if (src->isImm())
+            {
+                continue;
+            }
+            validSrcs = src->isSrcRegRegion() && src->asSrcRegRegion()->getRegAccess() == Direct &&
+                src->getBase()->isRegVar() && src->getTopDcl() &&
+                (src->getTopDcl()->getRegFile() == G4_GRF || src->getTopDcl()->getRegFile() == G4_INPUT);
+            if (validSrcs)
+            {
+                srcDcls.push_back(src->getTopDcl()->getRootDeclare());
+            }
+        }
+        if (!validSrcs)
+        {
+            continue;
+        }
+
+        // walk the block from the def; all uses must be seen before any
+        // source of the cmp is redefined
+        std::unordered_set<G4_INST*> pendingUses(refs.uses.begin(), refs.uses.end());
+        for (auto it = std::next(refs.defIt), ie = refs.defBB->end(); it != ie && !pendingUses.empty(); ++it)
+        {
+            G4_INST* inst = *it;
+            if (pendingUses.erase(inst))
+            {
+                // a NoMask use may read lanes the cmp clone wouldn't write
+                if (inst->isWriteEnableInst() && !def->isWriteEnableInst())
+                {
+                    break;
+                }
+                continue;
+            }
+            G4_DstRegRegion* dst = inst->getDst();
+            G4_Declare* dstDcl = dst ? dst->getTopDcl() : nullptr;
+            if (inst->isCall() || inst->isFCall() ||
+                (dstDcl && std::find(srcDcls.begin(), srcDcls.end(), dstDcl->getRootDeclare()) != srcDcls.end()))
+            {
+                break;
+            }
+        }
+        if (pendingUses.empty())
+        {
+            setFlagRematInst(dcl, def);
+        }
+    }
+}
+
 void GlobalRA::flagRegAlloc()
 {
     uint32_t flagSpillId = 0;
     unsigned maxRAIterations = 10;
     uint32_t iterationNo = 0;
     bool spillingFlag = false;
+    bool assignSpillTemps = builder.getOption(vISA_ARFSpillTempAssignment) &&
+        !builder.kernel.fg.getHasStackCalls() && !builder.kernel.fg.getIsStackCallFunc();
+
+    if (builder.getOption(vISA_FlagRemat))
+    {
+        computeFlagRematRecipes();
+    }
 
     while (iterationNo < maxRAIterations)
     {
@@ -9504,6 +10356,10 @@ void GlobalRA::flagRegAlloc()
             {
                 SpillManager spillFlag(*this, coloring.getSpilledLiveRanges(), flagSpillId);
                 spillFlag.insertSpillCode();
+                if (builder.getOption(vISA_RATrace) && spillFlag.getNumFlagRemat())
+                {
+                    std::cout << "\t--rematerialized " << spillFlag.getNumFlagRemat() << " flag uses\n";
+                }
 #ifdef DEBUG_VERBOSE_ON
                 printf("FLAG Spill inst count: %d\n", spillFlag.getNumFlagSpillStore());
                 printf("FLAG Fill inst count: %d\n", spillFlag.getNumFlagSpillLoad());
@@ -9512,8 +10368,11 @@ void GlobalRA::flagRegAlloc()
                 flagSpillId = spillFlag.getNextTempDclId();
 
                 spillingFlag = true;
-                if (spillFlag.isAnyNewTempCreated() == false)
+                if (spillFlag.isAnyNewTempCreated() == false ||
+                    (assignSpillTemps && coloring.assignARFSpillTemps()))
                 {
+                    builder.getJitInfo()->numFlagSpillStore = spillFlag.getNumFlagSpillStore();
+                    builder.getJitInfo()->numFlagSpillLoad = spillFlag.getNumFlagSpillLoad();
                     coloring.confirmRegisterAssignments();
 
                     if ((builder.kernel.fg.getHasStackCalls() || builder.kernel.fg.getIsStackCallFunc()))
@@ -9733,6 +10592,34 @@ bool canDoHRA(G4_Kernel& kernel)
 //
 // graph coloring entry point.  returns nonzero if RA fails
 //
+// Spilling is the last resort when the platform offers a GRF mode with more
+// registers, and the kernel is moved to it when, per GRFMode's occupancy
+// model, the scratch traffic costs more than the latency hiding lost with
+// fewer threads.
+bool GlobalRA::switchToLargerGRFMode(unsigned spillRefCount, unsigned instNum)
+{
+    GRFMode grfMode;
+    unsigned curThreads = kernel.getNumThreads();
+    unsigned newThreads = grfMode.getNumThreadsForLargerGRF(kernel.getNumRegTotal());
+    if (newThreads == 0 || curThreads == 0 || newThreads >= curThreads)
+        return false;
+
+    if (grfMode.estimateCost(curThreads, spillRefCount, instNum) <=
+        grfMode.estimateCost(newThreads, 0, instNum))
+        return false;
+
+    unsigned oldNumGRF = kernel.getNumRegTotal();
+    kernel.updateKernelByNumThreads(newThreads);
+    if (builder.getOption(vISA_RATrace))
+    {
+        std::cout << "\t--switching GRF mode on spill: " << oldNumGRF << " -> "
+            << kernel.getNumRegTotal() << " GRFs, " << curThreads << " -> "
+            << newThreads << " threads\n";
+    }
+    builder.getcompilerStats().SetI64("AutoGRFSelection", kernel.getNumRegTotal(), kernel.getSimdSize());
+    return kernel.getNumRegTotal() > oldNumGRF;
+}
+
 int GlobalRA::coloringRegAlloc()
 {
     if (kernel.getOption(vISA_OptReport))
@@ -9806,21 +10693,75 @@ int GlobalRA::coloringRegAlloc()
 
     if (!isReRAPass())
     {
+        // Stack call save/restore code is derived from the coloring, so a
+        // saved assignment alone is not enough to replay those.
+        const char* replayPrefix = builder.getOptions()->getOptionCstr(vISA_RAReplay);
+        if (replayPrefix && !hasStackCall &&
+            RADecisionLog::replay(kernel, RADecisionLog::getLogFileName(kernel, replayPrefix)))
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "--replayed GRF assignment from " << replayPrefix << "\n";
+            }
+            assignRegForAliasDcl();
+            computePhyReg();
+            return VISA_SUCCESS;
+        }
+        if (builder.getOptions()->getOptionCstr(vISA_RALog))
+        {
+            raLog = std::make_unique<RADecisionLog>(kernel);
+            raLog->begin();
+        }
+        if (builder.getOption(vISA_PressureReport))
+        {
+            pressureReport = std::make_unique<PressureReport>(kernel);
+        }
+
+        // Tiered RA: for huge kernels, try the fast linear scan allocator
+        // first and escalate to graph coloring only if it would spill.
+        bool tieredLinearScan = false;
+        if (!builder.getOption(vISA_LinearScan) && !builder.getOption(vISA_Debug))
+        {
+            unsigned threshold = builder.getOptions()->getuInt32Option(vISA_TieredRAInstThreshold);
+            if (threshold)
+            {
+                unsigned instNum = 0;
+                for (auto bb : kernel.fg)
+                {
+                    instNum += (unsigned)bb->size();
+                }
+                tieredLinearScan = instNum >= threshold;
+                if (tieredLinearScan && builder.getOption(vISA_RATrace))
+                {
+                    std::cout << "--tiered RA: " << instNum << " instructions, trying linear scan first\n";
+                }
+            }
+        }
+
         //Global linear scan RA
-        if (builder.getOption(vISA_LinearScan))
+        if (builder.getOption(vISA_LinearScan) || tieredLinearScan)
         {
             copyMissingAlignment();
             BankConflictPass bc(*this, false);
             LivenessAnalysis liveAnalysis(*this, G4_GRF | G4_INPUT);
             liveAnalysis.computeLiveness();
+            if (pressureReport)
+            {
+                pressureReport->recordPressure(*this, liveAnalysis);
+            }
 
             TIME_SCOPE(LINEARSCAN_RA);
             LinearScanRA lra(bc, *this, liveAnalysis);
+            lra.setFallbackOnSpill(tieredLinearScan);
             int success = lra.doLinearScanRA();
             if (success == VISA_SUCCESS)
             {
                 // TODO: Get correct spillSize from LinearScanRA
                 unsigned spillSize = 0;
+                if (pressureReport)
+                {
+                    pressureReport->recordSpillCode();
+                }
                 expandSpillFillIntrinsics(spillSize);
                 assignRegForAliasDcl();
                 computePhyReg();
@@ -9850,7 +10791,8 @@ int GlobalRA::coloringRegAlloc()
                 return VISA_SPILL;
             }
         }
-        else if (builder.getOption(vISA_LocalRA) && !hasStackCall)
+
+        if (!builder.getOption(vISA_LinearScan) && builder.getOption(vISA_LocalRA) && !hasStackCall)
         {
             copyMissingAlignment();
             BankConflictPass bc(*this, false);
@@ -9992,7 +10934,18 @@ int GlobalRA::coloringRegAlloc()
         }
 
         LivenessAnalysis liveAnalysis(*this, G4_GRF | G4_INPUT);
-        liveAnalysis.computeLiveness();
+        liveAnalysis.computeLiveness(
+            builder.getOption(vISA_ReuseGRFLiveness) ? &grfLivenessHistory : nullptr);
+        if (builder.getOption(vISA_RATrace))
+        {
+            if (liveAnalysis.getNumSeededVar() > 0)
+            {
+                std::cout << "\t--reused liveness of " << liveAnalysis.getNumSeededVar() << " out of "
+                    << liveAnalysis.getNumSelectedVar() << " variables\n";
+            }
+            std::cout << "\t--liveness BB visits: use " << liveAnalysis.getNumUseVisits()
+                << ", def " << liveAnalysis.getNumDefVisits() << "\n";
+        }
         if (builder.getOption(vISA_dumpLiveness))
         {
             liveAnalysis.dump();
@@ -10015,6 +10968,11 @@ int GlobalRA::coloringRegAlloc()
             }
             GraphColor coloring(liveAnalysis, kernel.getNumRegTotal(), false, forceSpill);
 
+            if (pressureReport && iterationNo == 0 && !rematDone)
+            {
+                pressureReport->recordPressure(*this, liveAnalysis);
+            }
+
             if (builder.getOption(vISA_dumpRPE) && iterationNo == 0 && !rematDone)
             {
                 // dump pressure the first time we enter global RA
@@ -10025,6 +10983,10 @@ int GlobalRA::coloringRegAlloc()
             unsigned indrSpillRegSize = 0;
             bool isColoringGood =
                 coloring.regAlloc(doBankConflictReduction, highInternalConflict, reserveSpillReg, spillRegSize, indrSpillRegSize, &rpe);
+            if (raLog)
+            {
+                raLog->recordIteration(iterationNo, isColoringGood, coloring.getSpilledLiveRanges());
+            }
             if (!isColoringGood)
             {
                 if (isReRAPass())
@@ -10158,6 +11120,17 @@ int GlobalRA::coloringRegAlloc()
                     return VISA_SPILL;
                 }
 
+                if (iterationNo == 0 && !hasStackCall &&
+                    builder.getOption(vISA_AutoGRFSelectionOnSpill) &&
+                    !builder.getOptions()->getuInt32Option(vISA_ForceHWThreadNumberPerEU) &&
+                    switchToLargerGRFMode(GRFSpillFillCount, instNum))
+                {
+                    // Retry allocation with the larger register file instead of
+                    // going to scratch.
+                    GRFSpillFillCount = 0;
+                    continue;
+                }
+
                 if (iterationNo == 0 &&
                     enableSpillSpaceCompression &&
                     kernel.getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D &&
@@ -10284,6 +11257,10 @@ int GlobalRA::coloringRegAlloc()
                     regChart->dumpRegChart(std::cerr);
                 }
 
+                if (pressureReport)
+                {
+                    pressureReport->recordSpillCode();
+                }
                 expandSpillFillIntrinsics(nextSpillOffset);
 
                 if (builder.getOption(vISA_OptReport))
@@ -11,15 +11,20 @@ SPDX-License-Identifier: MIT
 
 #include "BitSet.h"
 #include "G4_IR.hpp"
+#include "PressureReport.h"
+#include "RADecisionLog.h"
 #include "RegAlloc.h"
 #include "RPE.h"
 #include "SpillManagerGMRF.h"
 #include "VarSplit.h"
 
+#include <algorithm>
+#include <functional>
 #include <list>
 #include <limits>
 #include <memory>
 #include <map>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
@@ -47,6 +52,7 @@ namespace vISA
 
         void setupBankConflictsforTwoGRFs(G4_INST* inst);
         void setupBankConflictsforMad(G4_INST* inst);
+        void setupBankConflictPartners(G4_INST* inst);
         void setupBankConflictsForBB(G4_BB* bb, unsigned &threeSourceInstNum, unsigned &sendInstNum,
             unsigned numRegLRA, unsigned & internalConflict);
         void setupBankConflictsForBBTGL(G4_BB* bb, unsigned& threeSourceInstNum, unsigned& sendInstNum, unsigned numRegLRA, unsigned& internalConflict);
@@ -329,10 +335,119 @@ namespace vISA
         void augmentIntfGraph();
     };
 
+    //
+    // One row of the sparse interference matrix. Neighbors are stored as sorted
+    // (tile, bits) pairs, where each tile covers BITS_DWORD consecutive ids and
+    // only non-empty tiles are kept. Once a row has enough tiles that a bitmap
+    // over all ids would be smaller, it switches to the bitmap. Both forms are
+    // scanned linearly and in increasing id order.
+    //
+    class SparseIntfRow
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> tiles;
+        std::vector<uint32_t> dense;
+
+    public:
+        // numTiles is the number of tiles of a full row
+        void setBlock(uint32_t tile, uint32_t bits, uint32_t numTiles)
+        {
+            if (!dense.empty())
+            {
+                dense[tile] |= bits;
+                return;
+            }
+
+            auto it = std::lower_bound(tiles.begin(), tiles.end(), tile,
+                [](const std::pair<uint32_t, uint32_t>& elt, uint32_t t) { return elt.first < t; });
+            if (it != tiles.end() && it->first == tile)
+            {
+                it->second |= bits;
+                return;
+            }
+
+            if ((tiles.size() + 1) * sizeof(tiles[0]) > numTiles * sizeof(dense[0]))
+            {
+                dense.resize(numTiles, 0);
+                for (auto& elt : tiles)
+                {
+                    dense[elt.first] = elt.second;
+                }
+                dense[tile] |= bits;
+                std::vector<std::pair<uint32_t, uint32_t>>().swap(tiles);
+                return;
+            }
+            tiles.insert(it, std::make_pair(tile, bits));
+        }
+
+        void set(uint32_t id, uint32_t numTiles)
+        {
+            setBlock(id / BITS_DWORD, 1u << (id % BITS_DWORD), numTiles);
+        }
+
+        bool isSet(uint32_t id) const
+        {
+            uint32_t tile = id / BITS_DWORD;
+            uint32_t bit = 1u << (id % BITS_DWORD);
+            if (!dense.empty())
+            {
+                return (dense[tile] & bit) != 0;
+            }
+            auto it = std::lower_bound(tiles.begin(), tiles.end(), tile,
+                [](const std::pair<uint32_t, uint32_t>& elt, uint32_t t) { return elt.first < t; });
+            return it != tiles.end() && it->first == tile && (it->second & bit) != 0;
+        }
+
+        template <typename F>
+        void forEach(F f) const
+        {
+            auto visitTile = [&f](uint32_t tile, uint32_t bits)
+            {
+                for (uint32_t k = 0; bits != 0; ++k, bits >>= 1)
+                {
+                    if (bits & 1)
+                    {
+                        f(tile * BITS_DWORD + k);
+                    }
+                }
+            };
+
+            if (!dense.empty())
+            {
+                for (uint32_t tile = 0, size = (uint32_t)dense.size(); tile < size; ++tile)
+                {
+                    if (dense[tile] != 0)
+                    {
+                        visitTile(tile, dense[tile]);
+                    }
+                }
+                return;
+            }
+            for (auto& elt : tiles)
+            {
+                visitTile(elt.first, elt.second);
+            }
+        }
+    };
+
+    //
+    // Updates recorded by one worker of the parallel interference build; they
+    // are merged into the matrix and live ranges once all workers are done.
+    //
+    struct IntfBuildWorker
+    {
+        std::vector<std::pair<unsigned, unsigned>> edges;                  // (v1, v2)
+        std::vector<std::tuple<unsigned, unsigned, unsigned>> blocks;      // (v1, col, block)
+        std::vector<std::pair<unsigned, unsigned>> refCounts;              // (id, count) of global ranges
+        std::vector<std::function<void()>> lrUpdates;
+    };
+
     class Interference
     {
         friend class Augmentation;
 
+        // set while running a worker of the parallel interference build
+        static thread_local IntfBuildWorker* worker;
+
         // This stores compatible ranges for each variable. Such
         // compatible ranges will not be present in sparseIntf set.
         // We store G4_Declare* instead of id is because variables
@@ -356,7 +471,7 @@ namespace vISA
         // we don't directly update sparseIntf to ensure uniqueness
         // like dense matrix, interference is not symmetric (that is, if v1 and v2 interfere and v1 < v2,
         // we insert (v1, v2) but not (v2, v1)) for better cache behavior
-        std::vector<std::unordered_set<uint32_t> > sparseMatrix;
+        std::vector<SparseIntfRow> sparseMatrix;
         static const uint32_t denseMatrixLimit = 0x80000;
 
         static void updateLiveness(BitSet& live, uint32_t id, bool val)
@@ -375,20 +490,28 @@ namespace vISA
         inline void safeSetInterference(unsigned v1, unsigned v2)
         {
             // Assume v1 < v2
-            if (useDenseMatrix())
+            if (worker)
+            {
+                worker->edges.emplace_back(v1, v2);
+            }
+            else if (useDenseMatrix())
             {
                 unsigned col = v2 / BITS_DWORD;
                 matrix[v1 * rowSize + col] |= 1 << (v2 % BITS_DWORD);
             }
             else
             {
-                sparseMatrix[v1].emplace(v2);
+                sparseMatrix[v1].set(v2, rowSize);
             }
         }
 
         inline void setBlockInterferencesOneWay(unsigned v1, unsigned col, unsigned block)
         {
-            if (useDenseMatrix())
+            if (worker)
+            {
+                worker->blocks.emplace_back(v1, col, block);
+            }
+            else if (useDenseMatrix())
             {
 #ifdef _DEBUG
                 MUST_BE_TRUE(sparseIntf.size() == 0, "Updating intf graph matrix after populating sparse intf graph");
@@ -398,15 +521,7 @@ namespace vISA
             }
             else
             {
-                auto&& intfSet = sparseMatrix[v1];
-                for (int i = 0; i < BITS_DWORD; ++i)
-                {
-                    if (block & (1 << i))
-                    {
-                        uint32_t v2 = col * BITS_DWORD + i;
-                        intfSet.emplace(v2);
-                    }
-                }
+                sparseMatrix[v1].setBlock(col, block, rowSize);
             }
         }
 
@@ -418,6 +533,25 @@ namespace vISA
 
         void addCalleeSaveBias(const BitSet& live);
 
+        // Block local ranges are only referenced by one BB, so the worker
+        // building that BB updates them directly. Other updates to live ranges
+        // are deferred to the merge.
+        void addRefCount(unsigned id, unsigned refCount);
+        void checkForInfiniteSpillCost(unsigned id, G4_BB* bb, std::list<G4_INST*>::reverse_iterator& it);
+        template <typename F>
+        void updateLR(F f)
+        {
+            if (worker)
+            {
+                worker->lrUpdates.emplace_back(f);
+                return;
+            }
+            f();
+        }
+
+        bool useParallelBuild(unsigned numThreads) const;
+        void buildInterferenceParallel(unsigned numThreads);
+
         void buildInterferenceAtBBExit(const G4_BB* bb, BitSet& live);
         void buildInterferenceWithinBB(G4_BB* bb, BitSet& live);
         void buildInterferenceForDst(G4_BB* bb, BitSet& live, G4_INST* inst, std::list<G4_INST*>::reverse_iterator i, G4_DstRegRegion* dst);
@@ -562,11 +696,13 @@ namespace vISA
         void computeDegreeForGRF();
         void computeDegreeForARF();
         void computeSpillCosts(bool useSplitLLRHeuristic);
+        void computeLoopThroughLevels(std::vector<unsigned>& levels);
         void determineColorOrdering();
         void removeConstrained();
         void relaxNeighborDegreeGRF(LiveRange* lr);
         void relaxNeighborDegreeARF(LiveRange* lr);
         bool assignColors(ColorHeuristic heuristicGRF, bool doBankConflict, bool highInternalConflict, bool honorHints = true);
+        unsigned computeColoringComponents(std::vector<unsigned>& componentOf) const;
 
         void clearSpillAddrLocSignature()
         {
@@ -593,6 +729,7 @@ namespace vISA
         void confirmRegisterAssignments();
         void resetTemporaryRegisterAssignments();
         void cleanupRedundantARFFillCode();
+        bool assignARFSpillTemps();
         void getCalleeSaveRegisters();
         void addA0SaveRestoreCode();
         void addFlagSaveRestoreCode();
@@ -626,8 +763,13 @@ namespace vISA
         std::vector<const G4_Declare*> subDclList;
         unsigned subOff = 0;
         std::vector<BundleConflict> bundleConflicts;
+        // three source partners, offset is partner's operand row minus ours
+        std::vector<BundleConflict> bankConflicts;
         G4_SubReg_Align subAlign = G4_SubReg_Align::Any;
         bool isEvenAlign = false;
+        // for a flag, the cmp that can recompute it at each use instead of
+        // spilling it
+        G4_INST* flagRematInst = nullptr;
     };
 
     class VerifyAugmentation
@@ -689,6 +831,8 @@ namespace vISA
     public:
         std::unique_ptr<VerifyAugmentation> verifyAugmentation;
         std::unique_ptr<RegChartDump> regChart;
+        std::unique_ptr<RADecisionLog> raLog;
+        std::unique_ptr<PressureReport> pressureReport;
         static bool useGenericAugAlign()
         {
             auto gen = getPlatformGeneration(getGenxPlatform());
@@ -771,6 +915,9 @@ namespace vISA
         // store iteration number for GRA loop
         unsigned iterNo = 0;
 
+        // GRF liveness of the previous GRA loop iteration
+        LivenessHistory grfLivenessHistory;
+
         uint32_t numGRFSpill = 0;
         uint32_t numGRFFill = 0;
 
@@ -790,6 +937,8 @@ namespace vISA
         std::unordered_map<G4_BB*, std::vector<bool>> callerSaveRegsMap;
         std::unordered_map<G4_BB*, unsigned> callerSaveRegCountMap;
         std::unordered_map<G4_BB*, std::vector<bool>> retRegsMap;
+        // drop caller-save GRFs of fcall bb that its callee is known not to write
+        void pruneCallerSaveRegsByCallee(G4_BB* bb);
         std::vector<bool> calleeSaveRegs;
         unsigned calleeSaveRegCount = 0;
 
@@ -895,6 +1044,16 @@ namespace vISA
             return getVar(dcl).bb_id;
         }
 
+        G4_INST* getFlagRematInst(const G4_Declare* dcl) const
+        {
+            return getVar(dcl).flagRematInst;
+        }
+
+        void setFlagRematInst(const G4_Declare* dcl, G4_INST* inst)
+        {
+            allocVar(dcl).flagRematInst = inst;
+        }
+
         void setBBId(const G4_Declare* dcl, unsigned id)
         {
             allocVar(dcl).bb_id = id;
@@ -1075,6 +1234,28 @@ namespace vISA
             return getVar(dcl).bundleConflicts;
         }
 
+        void addBankConflictDcl(const G4_Declare* dcl, const G4_Declare* partnerDcl, int offset)
+        {
+            allocVar(dcl).bankConflicts.emplace_back(partnerDcl, offset);
+        }
+
+        void clearBankConflictDcl(const G4_Declare* dcl)
+        {
+            allocVar(dcl).bankConflicts.clear();
+        }
+
+        const std::vector<BundleConflict>& getBankConflictDcls(const G4_Declare* dcl) const
+        {
+            return getVar(dcl).bankConflicts;
+        }
+
+        // Bank of a GRF: platforms with one-GRF bank division alternate banks
+        // every GRF, the others every two GRFs.
+        unsigned getGRFBank(unsigned reg) const
+        {
+            return kernel.fg.builder->oneGRFBankDivision() ? reg % 2 : (reg / 2) % 2;
+        }
+
         unsigned get_bundle(unsigned baseReg, int offset) const
         {
             return (((baseReg + offset) % 64) / 4);
@@ -1185,11 +1366,13 @@ namespace vISA
         void emitVarLiveIntervals();
 
         void determineSpillRegSize(unsigned& spillRegSize, unsigned& indrSpillRegSize);
+        bool switchToLargerGRFMode(unsigned spillRefCount, unsigned instNum);
         G4_Imm* createMsgDesc(unsigned owordSize, bool writeType, bool isSplitSend);
         void stackCallProlog();
         void saveRegs(unsigned startReg, unsigned owordSize, G4_Declare* scratchRegDcl, G4_Declare* framePtr, unsigned frameOwordOffset, G4_BB* bb, INST_LIST_ITER insertIt, std::unordered_set<G4_INST*>& group);
         void saveActiveRegs(std::vector<bool>& saveRegs, unsigned startReg, unsigned frameOffset, G4_BB* bb, INST_LIST_ITER insertIt, std::unordered_set<G4_INST*>& group);
         void addrRegAlloc();
+        void computeFlagRematRecipes();
         void flagRegAlloc();
         bool hybridRA(bool doBankConflictReduction, bool highInternalConflict, LocalRA& lra);
         void assignRegForAliasDcl();
@@ -5325,6 +5325,60 @@ void HWConformity::replaceHFBFwithFloat(INST_LIST_ITER it, G4_BB* bb)
 }
 
 
+void HWConformity::initRuleTable()
+{
+    for (int op = 0; op < G4_NUM_OPCODE; op++)
+    {
+        ruleTable[op] = 0;
+    }
+    ruleTable[G4_pseudo_fcall] |= RULE_CALLA;
+    ruleTable[G4_sel] |= RULE_SEL_CSEL;
+    ruleTable[G4_csel] |= RULE_SEL_CSEL;
+    ruleTable[G4_math] |= RULE_MATH;
+    ruleTable[G4_mul] |= RULE_MUL;
+    ruleTable[G4_mulh] |= RULE_MULH;
+    ruleTable[G4_madw] |= RULE_MADW;
+    ruleTable[G4_cmp] |= RULE_CMP;
+    ruleTable[G4_cmpn] |= RULE_CMP;
+    ruleTable[G4_pln] |= RULE_PLANE;
+    ruleTable[G4_line] |= RULE_LINE;
+    ruleTable[G4_rol] |= RULE_ROTATE;
+    ruleTable[G4_ror] |= RULE_ROTATE;
+    ruleTable[G4_mov] |= RULE_BF_MOV;
+
+    // rules that may apply to any opcode, but only on some platforms
+    uint32_t anyOpRules = 0;
+    if (builder.getOption(vISA_InsertDummyMovForHWRSWA) &&
+        (VISA_WA_CHECK(builder.getPWaTable(), Wa_16012061344) ||
+         VISA_WA_CHECK(builder.getPWaTable(), Wa_16012292205)))
+    {
+        anyOpRules |= RULE_PRED_INDIRECT_WA;
+    }
+    if (!builder.hasVxHFloat64b())
+    {
+        anyOpRules |= RULE_VXH_FLOAT64B;
+    }
+    if (builder.no64bitRegioning())
+    {
+        anyOpRules |= RULE_64B_REGION;
+    }
+    if (builder.getPlatform() == GENX_BDW)
+    {
+        anyOpRules |= RULE_PACKED_HF_CONV;
+    }
+
+    uint32_t platformMask = anyOpRules | ~(RULE_PRED_INDIRECT_WA | RULE_VXH_FLOAT64B |
+        RULE_64B_REGION | RULE_PACKED_HF_CONV);
+    if (!builder.supportCallaRegSrc())
+    {
+        platformMask &= ~RULE_CALLA;
+    }
+    for (int op = 0; op < G4_NUM_OPCODE; op++)
+    {
+        ruleTable[op] = (ruleTable[op] | anyOpRules) & platformMask;
+    }
+}
+
 void HWConformity::conformBB(G4_BB* bb)
 {
     INST_LIST_ITER i = bb->begin(), iEnd = bb->end();
@@ -5339,7 +5393,7 @@ void HWConformity::conformBB(G4_BB* bb)
         G4_opcode opcode = inst->opcode();
 
 
-        if (inst->isFCall() && builder.supportCallaRegSrc())
+        if (ruleApplies(inst, RULE_CALLA))
             fixCalla(i, bb);
 
         if ((inst->mayExceedTwoGRF() && !inst->isSend()) ||
@@ -5349,9 +5403,7 @@ void HWConformity::conformBB(G4_BB* bb)
             continue;
         }
 
-        if (builder.getOption(vISA_InsertDummyMovForHWRSWA) &&
-            (VISA_WA_CHECK(builder.getPWaTable(), Wa_16012061344) ||
-             VISA_WA_CHECK(builder.getPWaTable(), Wa_16012292205)))
+        if (ruleApplies(inst, RULE_PRED_INDIRECT_WA))
         {
             fixPredicateIndirectInst(i, bb);
         }
@@ -5368,13 +5420,16 @@ void HWConformity::conformBB(G4_BB* bb)
 
         fixOpndType(i, bb);
 
-        fixSelCsel(i, bb);
+        if (ruleApplies(inst, RULE_SEL_CSEL))
+        {
+            fixSelCsel(i, bb);
+        }
 
         fixPredCtrl(i, bb);
 
-        if (inst->getExecSize() > builder.getNativeExecSize())
+        if (ruleApplies(inst, RULE_MATH) && inst->getExecSize() > builder.getNativeExecSize())
         {
-            if (inst->opcode() == G4_math &&
+            if (inst->getDst()->getType() == Type_HF &&
                 inst->getDst()->getType() == Type_HF &&
                 inst->getSrc(0)->getType() == Type_HF &&
                 (!inst->getSrc(1) || inst->getSrc(1)->getType() == Type_HF))
@@ -5391,7 +5446,7 @@ void HWConformity::conformBB(G4_BB* bb)
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        if (inst->isMath())
+        if (ruleApplies(inst, RULE_MATH))
         {
             if (fixMathInst(i, bb))
             {
@@ -5407,7 +5462,7 @@ void HWConformity::conformBB(G4_BB* bb)
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        if (inst->opcode() == G4_mul)
+        if (ruleApplies(inst, RULE_MUL))
         {
             if (fixMULInst(i, bb))
             {
@@ -5422,7 +5477,7 @@ void HWConformity::conformBB(G4_BB* bb)
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        if (inst->opcode() == G4_mulh)
+        if (ruleApplies(inst, RULE_MULH))
         {
             fixMULHInst(i, bb);
             next_iter = i;
@@ -5433,7 +5488,7 @@ void HWConformity::conformBB(G4_BB* bb)
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        if (inst->opcode() == G4_madw)
+        if (ruleApplies(inst, RULE_MADW))
         {
             next_iter = fixMadwInst(i, bb);
             continue;
@@ -5455,9 +5510,8 @@ void HWConformity::conformBB(G4_BB* bb)
          * intermediate type conversion to D.
          */
         inst = *i;
-        opcode = inst->opcode();
 
-        if (opcode == G4_cmp || opcode == G4_cmpn)
+        if (ruleApplies(inst, RULE_CMP))
         {
             dst = inst->getDst();
             int dst_elsize = 0;
@@ -5511,21 +5565,27 @@ void HWConformity::conformBB(G4_BB* bb)
         verifyG4Kernel(kernel, Optimizer::PI_HWConformityChk, false);
 #endif
 
-        bool planeDeleted = fixPlaneInst(i, bb);
-        if (planeDeleted)
+        if (ruleApplies(*i, RULE_PLANE) && fixPlaneInst(i, bb))
         {
+            // plane was expanded and deleted
             continue;
         }
 
-        fixLine(i, bb);
-        fixRotate(i, bb);
+        if (ruleApplies(*i, RULE_LINE))
+        {
+            fixLine(i, bb);
+        }
+        if (ruleApplies(*i, RULE_ROTATE))
+        {
+            fixRotate(i, bb);
+        }
 
-        if (!builder.hasVxHFloat64b())
+        if (ruleApplies(*i, RULE_VXH_FLOAT64B))
         {
             fixVxHFloat64b(i, bb);
         }
 
-        if (fix64bInst(i, bb))
+        if (ruleApplies(*i, RULE_64B_REGION) && fix64bInst(i, bb))
         {
             continue;
         }
@@ -5535,7 +5595,7 @@ void HWConformity::conformBB(G4_BB* bb)
 #endif
         fixImm64(i, bb); // fixed immediates for DF4 in fixImm64()
 
-        if ((*i)->opcode() == G4_mov)
+        if (ruleApplies(*i, RULE_BF_MOV))
         {
             if (fixBFMove(i, bb))
             {
@@ -5543,7 +5603,7 @@ void HWConformity::conformBB(G4_BB* bb)
             }
         }
 
-        if (builder.getPlatform() == GENX_BDW)
+        if (ruleApplies(*i, RULE_PACKED_HF_CONV))
         {
             fixPackedHFConversions(i, bb);
         }
@@ -5714,6 +5774,11 @@ void HWConformity::chkHWConformity()
 {
     fixDataLayout();
 
+    if (!builder.supportFloatOr64bRegioning() && builder.getOption(vISA_PreAlignUnalignedRegions))
+    {
+        requestAlignmentForUnalignedRegions();
+    }
+
     for (auto bb : kernel.fg)
     {
         curBB = bb;
@@ -7519,6 +7584,119 @@ void HWConformity::change64bStride2CopyToUD(INST_LIST_ITER it, G4_BB* bb)
 // for all float/64b inst (packed HF is ok in mixed mode inst)
 // For all violating instructions, we align each operand to the execution type
 // for float copy moves we could directly convert their type to int
+// fixUnalignedRegions() asks for GRF alignment of each operand as it gets to
+// it, and the first query pins the alignment of a declare. Earlier fixes (or
+// a previous operand of a smaller alignment) may then leave a declare that RA
+// could have aligned unaligned, which costs a split or an extra move. Before
+// any fix runs, request GRF alignment on the declares of float/64b regions
+// that would become legal with it. An instruction is only considered if all
+// of its operands can be aligned, as otherwise it needs fixing anyway and the
+// extra alignment would only constrain RA.
+void HWConformity::requestAlignmentForUnalignedRegions()
+{
+    const unsigned grfSize = getGRFSize();
+
+    // root declare of a direct GRF operand and the operand's byte offset in
+    // it; nullptr if the operand can't be aligned by RA
+    auto getRootAndOffset = [grfSize](G4_Operand* opnd, unsigned& offset) -> G4_Declare* {
+        if (!opnd->getBase() || !opnd->getBase()->isRegVar())
+        {
+            return nullptr;
+        }
+        unsigned short subRegOff = 0;
+        if (opnd->isDstRegRegion())
+        {
+            auto dst = opnd->asDstRegRegion();
+            if (dst->getRegAccess() != Direct)
+            {
+                return nullptr;
+            }
+            offset = dst->getRegOff() * grfSize;
+            subRegOff = dst->getSubRegOff();
+        }
+        else
+        {
+            auto src = opnd->asSrcRegRegion();
+            if (src->getRegAccess() != Direct)
+            {
+                return nullptr;
+            }
+            offset = src->getRegOff() * grfSize;
+            subRegOff = src->getSubRegOff();
+        }
+        offset += subRegOff * opnd->getTypeSize();
+        G4_Declare* dcl = opnd->getBase()->asRegVar()->getDeclare();
+        while (dcl && dcl->getAliasDeclare())
+        {
+            offset += dcl->getAliasOffset();
+            dcl = dcl->getAliasDeclare();
+        }
+        if (!dcl || dcl->getRegFile() != G4_GRF || dcl->getRegVar()->isPhyRegAssigned())
+        {
+            return nullptr;
+        }
+        return dcl;
+    };
+
+    int64_t numAvoided = 0;
+    std::vector<G4_Declare*> toAlign;
+    for (auto bb : kernel.fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (!inst->getDst() || inst->isSend() || inst->isDpas() ||
+                hasDedicateAlignRegionConformity(inst) ||
+                inst->getExecSize() == g4::SIMD1 || inst->isRawMov() ||
+                !isFloatOr64b(inst))
+            {
+                // raw moves are fixed by changing their type
+                continue;
+            }
+
+            toAlign.clear();
+            bool canAlign = true;
+            auto checkOpnd = [&](G4_Operand* opnd) {
+                if (opnd->isNullReg())
+                {
+                    return;
+                }
+                unsigned offset = 0;
+                G4_Declare* root = getRootAndOffset(opnd, offset);
+                if (!root || offset % grfSize != 0 ||
+                    (root->getSubRegAlign() != Any && root->getSubRegAlign() != GRFALIGN))
+                {
+                    canAlign = false;
+                }
+                else if (root->getSubRegAlign() == Any)
+                {
+                    toAlign.push_back(root);
+                }
+            };
+
+            checkOpnd(inst->getDst());
+            for (int i = 0, numSrc = inst->getNumSrc(); canAlign && i < numSrc; ++i)
+            {
+                G4_Operand* src = inst->getSrc(i);
+                if (src->isSrcRegRegion() && !src->asSrcRegRegion()->isScalar())
+                {
+                    checkOpnd(src);
+                }
+            }
+
+            if (canAlign && !toAlign.empty())
+            {
+                for (auto dcl : toAlign)
+                {
+                    dcl->setSubRegAlign(GRFALIGN);
+                }
+                numAvoided++;
+            }
+        }
+    }
+
+    builder.getcompilerStats().SetI64("NumRegionFixesAvoided", numAvoided, kernel.getSimdSize());
+}
+
 void HWConformity::fixUnalignedRegions(INST_LIST_ITER it, G4_BB* bb)
 {
     G4_INST* inst = *it;
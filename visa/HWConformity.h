@@ -28,6 +28,35 @@ namespace vISA
         // this must be set before calling the individual fix functions
         G4_BB* curBB = nullptr;
 
+        // Rule groups of conformBB() that only some opcodes or platforms can
+        // hit. ruleTable[op] has the groups that may apply to op on this
+        // platform; it is computed once in initRuleTable() so that conformBB()
+        // does not go through every opcode and platform check per instruction.
+        enum ConformRule : uint32_t
+        {
+            RULE_CALLA = 1u << 0,
+            RULE_PRED_INDIRECT_WA = 1u << 1,
+            RULE_SEL_CSEL = 1u << 2,
+            RULE_MATH = 1u << 3,
+            RULE_MUL = 1u << 4,
+            RULE_MULH = 1u << 5,
+            RULE_MADW = 1u << 6,
+            RULE_CMP = 1u << 7,
+            RULE_PLANE = 1u << 8,
+            RULE_LINE = 1u << 9,
+            RULE_ROTATE = 1u << 10,
+            RULE_VXH_FLOAT64B = 1u << 11,
+            RULE_64B_REGION = 1u << 12,
+            RULE_BF_MOV = 1u << 13,
+            RULE_PACKED_HF_CONV = 1u << 14
+        };
+        uint32_t ruleTable[G4_NUM_OPCODE];
+        void initRuleTable();
+        bool ruleApplies(const G4_INST* inst, ConformRule rule) const
+        {
+            return (ruleTable[inst->opcode()] & rule) != 0;
+        }
+
         // This is added for data layout optimization.
         // Currently it only targets packed-byte pattern.
         // Can be extended later for other patterns.
@@ -150,6 +179,7 @@ namespace vISA
         void change64bStride2CopyToUD(INST_LIST_ITER it, G4_BB* bb);
         bool fixBFMove(INST_LIST_ITER i, G4_BB* bb);
         void fixUnalignedRegions(INST_LIST_ITER it, G4_BB* bb);
+        void requestAlignmentForUnalignedRegions();
 
         void helperGenerateTempDst(
             G4_BB *bb,
@@ -233,6 +263,7 @@ namespace vISA
         HWConformity(IR_Builder& b, G4_Kernel &k, vISA::Mem_Manager& m) :
             builder(b), kernel(k), mem(m)
         {
+            initRuleTable();
         }
         void chkHWConformity();
         static void tryEliminateMadSrcModifier(IR_Builder &builder, G4_INST *inst);
@@ -797,6 +797,7 @@ void LinearScanRA::getCallerSaveRegisters()
             }
 
             gra.callerSaveRegCountMap[(*it)] = callerSaveRegCount;
+            gra.pruneCallerSaveRegsByCallee(*it);
         }
     }
 }
@@ -941,6 +942,17 @@ int LinearScanRA::linearScanRA()
             return VISA_FAILURE;
         }
 
+        if (spillLRs.size() && fallbackOnSpill)
+        {
+            if (builder.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--linear scan spilled " << spillLRs.size()
+                    << " variables, falling back to graph coloring\n";
+            }
+            undoLinearScanRAAssignments();
+            return VISA_FAILURE;
+        }
+
         if (spillLRs.size())
         {
             if (iterator == 0 &&
@@ -100,6 +100,8 @@ namespace vISA
         unsigned int funcCnt = 0;
         unsigned int lastInstLexID = 0;
         std::vector<unsigned int> funcLastLexID;
+        // give up, undoing all assignments, instead of inserting spill code
+        bool fallbackOnSpill = false;
 
         LSLiveRange* GetOrCreateLocalLiveRange(G4_Declare* topdcl);
         LSLiveRange* CreateLocalLiveRange(G4_Declare* topdcl);
@@ -148,6 +150,7 @@ namespace vISA
         void undoLinearScanRAAssignments();
         bool hasHighInternalBC() const { return highInternalConflict; }
         uint32_t getSpillSize() { return nextSpillOffset; }
+        void setFallbackOnSpill(bool val) { fallbackOnSpill = val; }
     };
 
 class LSLiveRange
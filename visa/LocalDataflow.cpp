@@ -11,6 +11,8 @@ SPDX-License-Identifier: MIT
 #include "BuildIR.h"
 #include "LocalDataflow.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -130,8 +132,10 @@ struct LocalLivenessInfo {
     {
     }
 
-    // Populate global operands.
-    void populateGlobals(GlobalOpndHashTable &globalOpndHT)
+    // Populate global operands. The operands are appended to globals
+    // rather than added to the global operand table directly, so that
+    // blocks may be analyzed concurrently.
+    void populateGlobals(std::vector<G4_Operand*>& globals)
     {
         for (auto& Nodes : LiveNodes) {
             for (auto &LN : Nodes.second) {
@@ -146,7 +150,7 @@ struct LocalLivenessInfo {
                      I != E; ++I)
                     I->first->addDefUse(LN.Inst, LN.OpNum);
 
-                globalOpndHT.addGlobalOpnd(Opnd);
+                globals.push_back(Opnd);
             }
             Nodes.second.clear();
         }
@@ -477,52 +481,93 @@ static void processWriteOpnds(G4_BB *BB, G4_INST *Inst, LocalLivenessInfo &LLI)
     }
 }
 
-void FlowGraph::localDataFlowAnalysis()
+// Build the def-use chains local to BB. This only touches the instructions
+// of BB, and the operands that are live across its boundaries are appended
+// to globals.
+static void localDataFlowAnalysisBB(G4_BB* BB, std::vector<G4_Operand*>& globals)
 {
-    for (auto BB : BBs) {
-        LocalLivenessInfo LLI(!BB->isAllLaneActive());
-        for (auto I = BB->rbegin(), E = BB->rend(); I != E; ++I) {
-            G4_INST* Inst = *I;
-            G4_opcode Op = Inst->opcode();
-            if (Op == G4_opcode::G4_return || Op == G4_opcode::G4_label)
-                continue;
-            if (Inst->isOptBarrier()) {
-                // Do not try to build def-use accross an optimization barrier,
-                // and this effectively disables optimizations across it.
-                LLI.populateGlobals(globalOpndHT);
+    LocalLivenessInfo LLI(!BB->isAllLaneActive());
+    for (auto I = BB->rbegin(), E = BB->rend(); I != E; ++I) {
+        G4_INST* Inst = *I;
+        G4_opcode Op = Inst->opcode();
+        if (Op == G4_opcode::G4_return || Op == G4_opcode::G4_label)
+            continue;
+        if (Inst->isOptBarrier()) {
+            // Do not try to build def-use accross an optimization barrier,
+            // and this effectively disables optimizations across it.
+            LLI.populateGlobals(globals);
 
-                // A barrier does not kill, but may introduce uses.
-                processReadOpnds(BB, Inst, LLI);
-                continue;
-            }
-            processWriteOpnds(BB, Inst, LLI);
+            // A barrier does not kill, but may introduce uses.
             processReadOpnds(BB, Inst, LLI);
+            continue;
         }
+        processWriteOpnds(BB, Inst, LLI);
+        processReadOpnds(BB, Inst, LLI);
+    }
 
-        // All left over live nodes are global.
-        LLI.populateGlobals(globalOpndHT);
-
-        // Sort use lists according to their local ids.
-        // This matches the use list order produced by forward
-        // reaching definition based analysis. It is better for
-        // optimizations not to rely on this order.
-        BB->resetLocalIds();
-        for (auto Inst : *BB) {
-            if (Inst->use_size() > 1) {
-                using Ty = std::pair<vISA::G4_INST *, Gen4_Operand_Number>;
-                auto Cmp = [](const Ty &lhs, const Ty &rhs) -> bool {
-                    int lhsID = lhs.first->getLocalId();
-                    int rhsID = rhs.first->getLocalId();
-                    if (lhsID < rhsID)
-                        return true;
-                    else if (lhsID > rhsID)
-                        return false;
-                    return lhs.second < rhs.second;
-                };
-                Inst->sortUses(Cmp);
-            }
+    // All left over live nodes are global.
+    LLI.populateGlobals(globals);
+
+    // Sort use lists according to their local ids.
+    // This matches the use list order produced by forward
+    // reaching definition based analysis. It is better for
+    // optimizations not to rely on this order.
+    BB->resetLocalIds();
+    for (auto Inst : *BB) {
+        if (Inst->use_size() > 1) {
+            using Ty = std::pair<vISA::G4_INST *, Gen4_Operand_Number>;
+            auto Cmp = [](const Ty &lhs, const Ty &rhs) -> bool {
+                int lhsID = lhs.first->getLocalId();
+                int rhsID = rhs.first->getLocalId();
+                if (lhsID < rhsID)
+                    return true;
+                else if (lhsID > rhsID)
+                    return false;
+                return lhs.second < rhs.second;
+            };
+            Inst->sortUses(Cmp);
+        }
+    }
+}
+
+void FlowGraph::localDataFlowAnalysis()
+{
+    unsigned numThreads = builder->getOptions()->getuInt32Option(vISA_LocalDataflowThreads);
+    if (numThreads <= 1 || BBs.size() < 2)
+    {
+        std::vector<G4_Operand*> globals;
+        for (auto BB : BBs) {
+            localDataFlowAnalysisBB(BB, globals);
+            for (auto Opnd : globals)
+                globalOpndHT.addGlobalOpnd(Opnd);
+            globals.clear();
         }
+        return;
     }
+
+    // Blocks are independent here: def-use edges are only added between
+    // instructions of the same block, and each edge list has its own
+    // arena. The global operands are merged afterwards in block order so
+    // the result does not depend on scheduling.
+    std::vector<G4_BB*> blocks(BBs.begin(), BBs.end());
+    std::vector<std::vector<G4_Operand*>> globals(blocks.size());
+    std::atomic<size_t> nextBB(0);
+    auto worker = [&]() {
+        for (size_t i = nextBB++; i < blocks.size(); i = nextBB++)
+            localDataFlowAnalysisBB(blocks[i], globals[i]);
+    };
+
+    numThreads = std::min<unsigned>(numThreads, (unsigned)blocks.size());
+    std::vector<std::thread> helpers;
+    for (unsigned i = 1; i < numThreads; ++i)
+        helpers.emplace_back(worker);
+    worker();
+    for (auto& helper : helpers)
+        helper.join();
+
+    for (auto& bbGlobals : globals)
+        for (auto Opnd : bbGlobals)
+            globalOpndHT.addGlobalOpnd(Opnd);
 }
 
 // Reset existing def-use
@@ -2140,7 +2140,7 @@ bool PhyRegsLocalRA::findFreeMultipleRegsForward(int regIdx, BankAlign align, in
     {
         if (isGRFAvailable(i) && forbidden.find(i) == forbidden.end() &&
             regBusyVector[i] == 0 &&
-            (!isHybridAlloc || (((instID - regLastUse[i]) / 2 >= LraFFWindowSize) || (regLastUse[i] == 0)) || hintSet))
+            (isReusable(i, instID, isHybridAlloc) || hintSet))
         {
             foundItem++;
         }
@@ -2166,7 +2166,7 @@ bool PhyRegsLocalRA::findFreeMultipleRegsForward(int regIdx, BankAlign align, in
                 if (i + 1 <= endReg + nrows - 1 &&
                     isGRFAvailable(i + 1) && forbidden.find(i+1) == forbidden.end() &&
                     (isWordBusy(i + 1, 0, lastRowSize) == false) &&
-                    (!isHybridAlloc || (((instID - regLastUse[i + 1]) / 2 >= LraFFWindowSize) || (regLastUse[i + 1] == 0))))
+                    isReusable(i + 1, instID, isHybridAlloc))
                 {
                     regnum = startReg;
                     return true;
@@ -2214,7 +2214,7 @@ bool PhyRegsLocalRA::findFreeMultipleRegsBackward(int regIdx, BankAlign align, i
     {
         if (isGRFAvailable(i) && forbidden.find(i) == forbidden.end() &&
             regBusyVector[i] == 0 &&
-            (!isHybridAlloc || (((instID - regLastUse[i]) / 2 >= LraFFWindowSize) || (regLastUse[i] == 0))))
+            isReusable(i, instID, isHybridAlloc))
         {
             foundItem++;
         }
@@ -2240,7 +2240,7 @@ bool PhyRegsLocalRA::findFreeMultipleRegsBackward(int regIdx, BankAlign align, i
                 if (i + 1 <= endReg &&
                     isGRFAvailable(i + 1) && forbidden.find(i+1) ==forbidden.end() &&
                     (isWordBusy(i + 1, 0, lastRowSize) == false) &&
-                    (!isHybridAlloc || (((instID - regLastUse[i + 1]) / 2 >= LraFFWindowSize) || (regLastUse[i + 1] == 0))))
+                    isReusable(i + 1, instID, isHybridAlloc))
                 {
                     regnum = startReg;
                     return true;
@@ -2304,7 +2304,7 @@ bool PhyRegsLocalRA::findFreeSingleReg(int regIdx, int size, BankAlign align, G4
         }
 
         if (isGRFAvailable(i, 1) && forbidden.find(i) ==forbidden.end() &&
-            (!isHybridAlloc || (((instID - regLastUse[i]) / 2 >= LraFFWindowSize) || (regLastUse[i] == 0))))
+            isReusable(i, instID, isHybridAlloc))
         {
             found = findFreeSingleReg(i, subalign, regnum, subregnum, size);
             if (found)
@@ -2545,6 +2545,8 @@ LinearScan::LinearScan(GlobalRA& g, std::vector<LocalLiveRange*>& localLiveInter
     , doBankConflict(bankConflict)
     , highInternalConflict(internalConflict)
     , doSplitLLR(splitLLR)
+    , avoidHazards(roundRobin && g.builder.getOption(vISA_LocalRAHazardAware))
+    , LT(&g.builder)
 {
 
     // FIXME: this entire class is a mess, whole thing needs a rewrite
@@ -2834,19 +2836,42 @@ bool LinearScan::allocateRegs(LocalLiveRange* lr, G4_BB* bb, IR_Builder& builder
 
     if (useRoundRobin)
     {
-        nrows = pregManager.findFreeRegs(size,
-            bankAlign,
-            subalign,
-            regnum,
-            subregnum,
-            *startGRFReg,
-            localRABound,
-            occupiedBundles,
-            instID,
-            false,
-            lr->getForbidden(),
-            lr->hasHint(),
-            lr->getHint());
+        if (avoidHazards && !lr->hasHint())
+        {
+            // first try to skip the registers still being read by a long
+            // latency instruction, so that the new def doesn't wait on it
+            pregManager.getAvaialableRegs()->setAvoidHazards(true);
+            nrows = pregManager.findFreeRegs(size,
+                bankAlign,
+                subalign,
+                regnum,
+                subregnum,
+                *startGRFReg,
+                localRABound,
+                occupiedBundles,
+                instID,
+                false,
+                lr->getForbidden(),
+                false,
+                0);
+            pregManager.getAvaialableRegs()->setAvoidHazards(false);
+        }
+        if (!nrows)
+        {
+            nrows = pregManager.findFreeRegs(size,
+                bankAlign,
+                subalign,
+                regnum,
+                subregnum,
+                *startGRFReg,
+                localRABound,
+                occupiedBundles,
+                instID,
+                false,
+                lr->getForbidden(),
+                lr->hasHint(),
+                lr->getHint());
+        }
     }
     else
     {
@@ -3468,6 +3493,23 @@ void LinearScan::freeAllocedRegs(LocalLiveRange* lr, bool setInstID)
             sregnum,
             lr->getSizeInWords(),
             idx);
+
+        G4_INST* lastRef = setInstID && avoidHazards ? lr->getLastRef(idx) : nullptr;
+        if (lastRef && (lastRef->isSend() || lastRef->isMath()))
+        {
+            // ids advance by 2 per instruction, about the issue latency of an
+            // uncompressed instruction, so the latency in cycles is used as
+            // the distance in ids
+            int hazardLatency = lastRef->isSend() ?
+                (int)LegacyLatencies::EDGE_LATENCY_SEND_WAR : (int)LT.getOccupancy(lastRef);
+            unsigned numRows = (sregnum + lr->getSizeInWords() + numEltPerGRF<Type_UW>() - 1) /
+                numEltPerGRF<Type_UW>();
+            for (unsigned i = 0; i < numRows; i++)
+            {
+                pregManager.getAvaialableRegs()->setRegHazardEnd(
+                    preg->asGreg()->getRegNum() + i, idx + hazardLatency);
+            }
+        }
     }
 }
 
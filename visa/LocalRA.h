@@ -13,6 +13,7 @@ SPDX-License-Identifier: MIT
 #include "G4_Opcode.h"
 #include "FlowGraph.h"
 #include "BuildIR.h"
+#include "LocalScheduler/LatencyTable.h"
 #include "BitSet.h"
 
 // Forward decls
@@ -271,6 +272,20 @@ private:
 
     int LraFFWindowSize;
 
+    // instID until which a register is still read by the long latency
+    // instruction that last referenced it
+    std::vector<int32_t> regHazardEnd;
+    bool avoidHazards = false;
+
+    bool isReusable(int reg, int instID, bool isHybridAlloc) const
+    {
+        if (avoidHazards && regHazardEnd[reg] > instID)
+        {
+            return false;
+        }
+        return !isHybridAlloc || ((instID - regLastUse[reg]) / 2 >= LraFFWindowSize) || (regLastUse[reg] == 0);
+    }
+
 public:
     PhyRegsLocalRA(IR_Builder* _builder, uint32_t nregs) : builder(_builder), numRegs(nregs)
     {
@@ -278,6 +293,7 @@ public:
 
         regBusyVector.resize(numRegs);
         regLastUse.resize(numRegs);
+        regHazardEnd.resize(numRegs, 0);
         grfAvialable.resize(numRegs);
 
         for (int i = 0; i < (int) nregs; i++)
@@ -423,6 +439,8 @@ public:
 
     void printBusyRegs();
     int getRegLastUse(int reg) {return regLastUse[reg];}
+    void setRegHazardEnd(int reg, int instID) { regHazardEnd[reg] = std::max(regHazardEnd[reg], instID); }
+    void setAvoidHazards(bool avoid) { avoidHazards = avoid; }
 
     int getLastUseSum1() {return lastUseSum1;}
     int getLastUseSum2() {return lastUseSum2;}
@@ -509,6 +527,8 @@ private:
     bool doBankConflict;
     bool highInternalConflict;
     bool doSplitLLR;
+    bool avoidHazards;
+    LatencyTable LT;
 
 public:
     LinearScan(GlobalRA& g, std::vector<LocalLiveRange*>& localLiveIntervals,
@@ -25,6 +25,8 @@ static const unsigned PRESSURE_HIGH_THRESHOLD = 120;
 static const unsigned PRESSURE_LOW_THRESHOLD = 60;
 static const unsigned PRESSURE_REDUCTION_THRESHOLD_SIMD32 = 120;
 static const unsigned LATENCY_PRESSURE_THRESHOLD = 100;
+static const unsigned BALANCED_PRESSURE_WEIGHT = 8;
+static const unsigned BALANCED_MAX_BACKTRACKS = 3;
 
 namespace {
 
@@ -175,6 +177,7 @@ private:
     friend class BB_Scheduler;
     friend class SethiUllmanQueue;
     friend class LatencyQueue;
+    friend class BalancedQueue;
 };
 
 // The dependency graph for a basic block.
@@ -346,6 +349,12 @@ struct RegisterPressure
         rpe->run();
     }
 
+    bool isLiveIn(G4_BB* bb, G4_Declare* Dcl) const
+    {
+        G4_RegVar *V = Dcl->getRegVar();
+        return liveness->isLiveAtEntry(bb, V->getId());
+    }
+
     bool isLiveOut(G4_BB* bb, G4_Declare* Dcl) const
     {
         G4_RegVar *V = Dcl->getRegVar();
@@ -423,17 +432,20 @@ struct SchedConfig
         MASK_LATENCY      = 1U << 1,
         MASK_SETHI_ULLMAN = 1U << 2,
         MASK_CLUSTTERING  = 1U << 3,
+        MASK_BALANCED     = 1U << 4,
     };
     unsigned Dump : 1;
     unsigned UseLatency : 1;
     unsigned UseSethiUllman : 1;
     unsigned DoClustering : 1;
+    unsigned UseBalanced : 1;
 
     explicit SchedConfig(unsigned Config)
         : Dump((Config & MASK_DUMP) != 0)
         , UseLatency((Config & MASK_LATENCY) != 0)
         , UseSethiUllman((Config & MASK_SETHI_ULLMAN) != 0)
         , DoClustering((Config & MASK_CLUSTTERING) != 0)
+        , UseBalanced((Config & MASK_BALANCED) != 0)
     {
     }
 };
@@ -484,13 +496,18 @@ public:
     // Run list scheduling.
     void scheduleBlockForPressure() { SethiUllmanScheduling(); }
     void scheduleBlockForLatency() { LatencyScheduling(); }
+    void scheduleBlockForBalance(unsigned PressureWeight) { BalancedScheduling(PressureWeight); }
 
     // Commit this scheduling if it reduces register pressure.
     bool commitIfBeneficial(unsigned &MaxRPE, bool IsTopDown);
 
+    // Commit a balanced scheduling if its pressure stays within RPELimit.
+    bool commitIfBalanced(unsigned &MaxRPE, unsigned RPELimit);
+
 private:
     void SethiUllmanScheduling();
     void LatencyScheduling();
+    void BalancedScheduling(unsigned PressureWeight);
     bool verifyScheduling();
 
     // Relocate pseudo-kills right before its successors.
@@ -602,6 +619,29 @@ bool preRA_Scheduler::run()
         preDDD ddd(mem, kernel, bb);
         BB_Scheduler S(kernel, ddd, rp, config, LT);
 
+        // Optimize latency and pressure together. When the result goes over
+        // the pressure limit, back off and retry with a larger pressure
+        // weight, a bounded number of times, before falling back to pressure
+        // or latency only scheduling below.
+        if (config.UseBalanced) {
+            unsigned RPELimit = std::max(MaxPressure, getLatencyHidingThreshold(kernel));
+            RPELimit = std::min(RPELimit, std::max(Threshold, MaxPressure));
+            bool Committed = false;
+            unsigned Weight = BALANCED_PRESSURE_WEIGHT;
+            for (unsigned i = 0; i <= BALANCED_MAX_BACKTRACKS && !Committed; ++i, Weight *= 4) {
+                ddd.reset();
+                S.scheduleBlockForBalance(Weight);
+                Committed = S.commitIfBalanced(MaxPressure, RPELimit);
+            }
+            if (Committed) {
+                SCHED_DUMP(rp.dump(bb, "After balanced scheduling, "));
+                Changed = true;
+                kernel.fg.builder->getcompilerStats().SetFlag("PreRASchedulerBalanced",
+                                                              this->kernel.getSimdSize());
+                continue;
+            }
+        }
+
         auto tryRPReduction = [=]() {
             if (!config.UseSethiUllman)
                  return false;
@@ -609,7 +649,7 @@ bool preRA_Scheduler::run()
         };
 
         if (tryRPReduction()) {
-            ddd.buildGraph();
+            ddd.reset();
             S.scheduleBlockForPressure();
             if (S.commitIfBeneficial(MaxPressure, /*IsTopDown*/ false)) {
                 SCHED_DUMP(rp.dump(bb, "After scheduling for presssure, "));
@@ -669,6 +709,422 @@ GRFMode::GRFMode()
     currentMode = 0;
 }
 
+float GRFMode::estimateCost(unsigned numThreads, unsigned spillRefCount, unsigned instNum) const
+{
+    // Each spill/fill is a scratch message whose issue and latency is only
+    // partly hidden; fewer threads lose latency hiding over the whole kernel
+    // in proportion to the thread count.
+    const float spillFillIssueCost = 8.0f;
+    float occupancyLoss = 1.0f - (float)numThreads / getMaxNumThreads();
+    return spillRefCount * spillFillIssueCost + instNum * occupancyLoss;
+}
+
+// Pick the GRF mode with the lowest estimated cost, where the spill
+// references of a mode are estimated from the register pressure of each BB in
+// excess of the mode's GRFs, weighted by loop nesting.
+static unsigned selectNumThreadsByOccupancy(
+    G4_Kernel& kernel, const GRFMode& grfMode,
+    const std::unordered_map<G4_BB*, unsigned int>& rpBB)
+{
+    unsigned instNum = 0;
+    for (auto bb : kernel.fg)
+        instNum += (unsigned)bb->size();
+
+    unsigned reservedGRFs = kernel.getOptions()->getuInt32Option(vISA_ReservedGRFNum);
+    unsigned bestThreads = kernel.getNumThreads();
+    float bestCost = 0.0f;
+    for (unsigned mode = 0; mode < grfMode.getNumModes(); mode++)
+    {
+        unsigned numGRF = grfMode.getMode(mode).first;
+        unsigned numThreads = grfMode.getMode(mode).second;
+        unsigned usableGRF = numGRF > reservedGRFs ? numGRF - reservedGRFs : 0;
+
+        unsigned spillRefCount = 0;
+        for (auto& bbRP : rpBB)
+        {
+            if (bbRP.second <= usableGRF)
+                continue;
+            // a spill and a fill of every excess GRF
+            unsigned loopWeight = 1u << (2 * std::min(bbRP.first->getNestLevel(), 4u));
+            spillRefCount += 2 * (bbRP.second - usableGRF) * loopWeight;
+        }
+
+        float cost = grfMode.estimateCost(numThreads, spillRefCount, instNum);
+        if (mode == 0 || cost < bestCost)
+        {
+            bestCost = cost;
+            bestThreads = numThreads;
+        }
+    }
+    return bestThreads;
+}
+
+namespace {
+
+// Root declares defined and used at each position of a loop block.
+struct LoopDefUse
+{
+    std::map<const G4_Declare*, std::vector<unsigned>> defs;
+    std::map<const G4_Declare*, std::vector<unsigned>> uses;
+    bool hasIndirect = false;
+
+    explicit LoopDefUse(const std::vector<G4_INST*>& insts)
+    {
+        for (unsigned pos = 0; pos < insts.size(); pos++)
+        {
+            G4_INST* inst = insts[pos];
+            for (Gen4_Operand_Number opndNum
+                : {Opnd_dst, Opnd_condMod, Opnd_implAccDst,
+                Opnd_src0, Opnd_src1, Opnd_src2, Opnd_src3, Opnd_pred, Opnd_implAccSrc})
+            {
+                G4_Operand* opnd = inst->getOperand(opndNum);
+                if (!opnd)
+                {
+                    continue;
+                }
+                if ((opnd->isDstRegRegion() && opnd->asDstRegRegion()->isIndirect()) ||
+                    (opnd->isSrcRegRegion() && opnd->asSrcRegRegion()->isIndirect()))
+                {
+                    hasIndirect = true;
+                }
+                if (const G4_Declare* dcl = getRootDcl(opnd))
+                {
+                    bool isDef = opndNum == Opnd_dst || opndNum == Opnd_condMod || opndNum == Opnd_implAccDst;
+                    (isDef ? defs : uses)[dcl].push_back(pos);
+                }
+            }
+        }
+    }
+
+    static const G4_Declare* getRootDcl(G4_Operand* opnd)
+    {
+        G4_Declare* dcl = opnd ? opnd->getTopDcl() : nullptr;
+        return dcl ? dcl->getRootDeclare() : nullptr;
+    }
+
+    const std::vector<unsigned>& getDefs(const G4_Declare* dcl) const
+    {
+        static const std::vector<unsigned> none;
+        auto it = defs.find(dcl);
+        return it == defs.end() ? none : it->second;
+    }
+
+    const std::vector<unsigned>& getUses(const G4_Declare* dcl) const
+    {
+        static const std::vector<unsigned> none;
+        auto it = uses.find(dcl);
+        return it == uses.end() ? none : it->second;
+    }
+};
+
+bool isPipelinableSend(G4_INST* inst)
+{
+    if (!inst->isSend() || inst->isEOT() || inst->getPredicate())
+    {
+        return false;
+    }
+    G4_SendDesc* msgDesc = inst->getMsgDesc();
+    return msgDesc->isRaw() && (msgDesc->isSampler() || msgDesc->isHDC()) &&
+        msgDesc->isRead() && !msgDesc->isWrite() && !msgDesc->isAtomic() &&
+        !msgDesc->isFence() && !msgDesc->isBarrier();
+}
+
+// All operands are direct accesses of non-precolored GRF variables.
+bool hasOnlyGRFOperands(G4_INST* inst)
+{
+    if (inst->getPredicate() || inst->getCondMod() || inst->getImplAccSrc() || inst->getImplAccDst())
+    {
+        return false;
+    }
+    G4_DstRegRegion* dst = inst->getDst();
+    if (!dst || dst->isNullReg() || dst->isIndirect())
+    {
+        return false;
+    }
+    G4_Declare* dstDcl = dst->getTopDcl();
+    if (!dstDcl || dstDcl->getRootDeclare()->getRegFile() != G4_GRF ||
+        dstDcl->getRootDeclare()->getRegVar()->isPhyRegAssigned())
+    {
+        return false;
+    }
+    for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        if (!src || src->isImm() || src->isNullReg())
+        {
+            continue;
+        }
+        G4_Declare* srcDcl = src->getTopDcl();
+        if (!src->isSrcRegRegion() || src->asSrcRegRegion()->isIndirect() || !srcDcl ||
+            (srcDcl->getRootDeclare()->getRegFile() != G4_GRF && srcDcl->getRootDeclare()->getRegFile() != G4_INPUT))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Instructions that a pipelined send cannot be moved across.
+bool isPipeliningBarrier(G4_INST* inst)
+{
+    return (inst->isSend() && !isPipelinableSend(inst) &&
+        (inst->getMsgDesc()->isWrite() || inst->getMsgDesc()->isFence() ||
+            inst->getMsgDesc()->isBarrier() || inst->getMsgDesc()->isAtomic())) ||
+        inst->isWait() || inst->isCall() || inst->isFCall() || inst->isReturn() || inst->isFReturn();
+}
+
+// Returns the preheader if bb is a loop made of a single block, ending with a
+// conditional jmpi back to itself.
+G4_BB* getSingleBlockLoopPreheader(G4_BB* bb)
+{
+    if (bb->size() < 3 || !bb->front()->isLabel())
+    {
+        return nullptr;
+    }
+    G4_INST* branch = bb->back();
+    if (branch->opcode() != G4_jmpi || !branch->getPredicate() ||
+        !branch->getSrc(0) || branch->getSrc(0) != bb->getLabel())
+    {
+        return nullptr;
+    }
+
+    G4_BB* preheader = nullptr;
+    for (G4_BB* pred : bb->Preds)
+    {
+        if (pred != bb)
+        {
+            if (preheader && preheader != pred)
+            {
+                return nullptr;
+            }
+            preheader = pred;
+        }
+    }
+    if (!preheader || preheader->Succs.size() != 1 || bb->Succs.size() != 2)
+    {
+        return nullptr;
+    }
+    if (!preheader->empty() && preheader->back()->isFlowControl() &&
+        (preheader->back()->opcode() != G4_jmpi || preheader->back()->getPredicate()))
+    {
+        return nullptr;
+    }
+    return preheader;
+}
+
+} // namespace
+
+//
+// For a single block loop
+//
+//     L:  ... x = f(v) ... d = send(x) ... use(d) ... v = v + 1 ... (p) jmpi L
+//
+// a read-only send and the instructions computing its payload (its slice)
+// are moved to a new latch block that runs only when the loop is taken, and
+// a copy of them is put into the preheader for the first iteration:
+//
+//     PH: ... x = f(v); d = send(x); jmpi L
+//     LATCH: x = f(v); d = send(x)
+//     L:  ... use(d) ... v = v + 1 ... (p) jmpi LATCH
+//
+// The send of the next iteration thus overlaps with the loop branch and the
+// code ahead of the first use of d. This is valid if
+//  - the slice values read from outside the slice are not redefined in the
+//    loop ahead of their readers, so they have the same value at the end of
+//    the previous iteration, and
+//  - the variables defined by the slice are not otherwise accessed in the
+//    loop, and d is read only after the send.
+// Since the latch is skipped on loop exit, the values live out of the loop
+// are unchanged. The number of pipelined sends is limited by the register
+// pressure headroom, as d is now live across the back edge, and by half of
+// the SWSB tokens, as the sends are in flight across the back edge.
+//
+unsigned preRA_LoopPipeliner::run()
+{
+    FlowGraph& fg = kernel.fg;
+    const unsigned threshold = getRPReductionThreshold(kernel.getNumRegTotal(), kernel.getSimdSize());
+    const unsigned maxSendsPerLoop = std::max(1u, kernel.getNumSWSBTokens() / 2);
+    std::unique_ptr<RegisterPressure> rp;
+    unsigned numPipelined = 0;
+
+    for (auto bbIt = fg.begin(); bbIt != fg.end(); ++bbIt)
+    {
+        G4_BB* bb = *bbIt;
+        G4_BB* preheader = getSingleBlockLoopPreheader(bb);
+        if (!preheader)
+        {
+            continue;
+        }
+
+        std::vector<G4_INST*> insts(bb->begin(), bb->end());
+        LoopDefUse du(insts);
+        if (du.hasIndirect)
+        {
+            continue;
+        }
+
+        if (!rp)
+        {
+            rp.reset(new RegisterPressure(kernel, mem, nullptr));
+        }
+        unsigned pressure = rp->getPressure(bb);
+
+        std::vector<bool> moved(insts.size(), false);
+        std::set<const G4_Declare*> extendedDcls;
+        unsigned numSends = 0;
+        unsigned firstBarrier = (unsigned)insts.size();
+        for (unsigned pos = 0; pos < insts.size(); pos++)
+        {
+            if (isPipeliningBarrier(insts[pos]))
+            {
+                firstBarrier = pos;
+                break;
+            }
+        }
+
+        for (unsigned sendPos = 0; sendPos < firstBarrier && numSends < maxSendsPerLoop; sendPos++)
+        {
+            G4_INST* send = insts[sendPos];
+            if (!isPipelinableSend(send) || moved[sendPos] || !hasOnlyGRFOperands(send))
+            {
+                continue;
+            }
+            const G4_Declare* resp = LoopDefUse::getRootDcl(send->getDst());
+
+            // Build the slice: a variable read by the slice and defined ahead
+            // of its reader belongs to the slice together with all its defs.
+            std::set<unsigned> slice = { sendPos };
+            std::set<const G4_Declare*> sliceDcls;
+            std::vector<unsigned> worklist = { sendPos };
+            bool legal = true;
+            for (unsigned def : du.getDefs(resp))
+            {
+                legal &= def == sendPos || (def < sendPos && insts[def]->isPseudoKill());
+                slice.insert(def);
+            }
+            while (legal && !worklist.empty())
+            {
+                unsigned pos = worklist.back();
+                worklist.pop_back();
+                G4_INST* inst = insts[pos];
+                for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+                {
+                    const G4_Declare* src = LoopDefUse::getRootDcl(inst->getSrc(i));
+                    const std::vector<unsigned>& defs = du.getDefs(src);
+                    if (!src || src == resp || sliceDcls.count(src) ||
+                        std::none_of(defs.begin(), defs.end(), [&](unsigned def) { return def < pos; }))
+                    {
+                        legal &= src != resp;
+                        continue;
+                    }
+                    sliceDcls.insert(src);
+                    for (unsigned def : defs)
+                    {
+                        G4_INST* defInst = insts[def];
+                        if (def > sendPos || moved[def] ||
+                            !(defInst->isPseudoKill() || (defInst->isBaseInst() && !defInst->isSend() &&
+                                !defInst->isFlowControl() && hasOnlyGRFOperands(defInst))))
+                        {
+                            legal = false;
+                            break;
+                        }
+                        if (slice.insert(def).second)
+                        {
+                            worklist.push_back(def);
+                        }
+                    }
+                }
+            }
+
+            // The slice variables are private to the slice, and the response
+            // is read only after the send.
+            for (const G4_Declare* dcl : sliceDcls)
+            {
+                for (unsigned use : du.getUses(dcl))
+                {
+                    legal &= slice.count(use) != 0;
+                }
+            }
+            for (unsigned use : du.getUses(resp))
+            {
+                legal &= use > sendPos && !slice.count(use);
+            }
+            if (!legal)
+            {
+                continue;
+            }
+
+            unsigned extraPressure = 0;
+            sliceDcls.insert(resp);
+            for (const G4_Declare* dcl : sliceDcls)
+            {
+                if (extendedDcls.insert(dcl).second)
+                {
+                    extraPressure += (dcl->getByteSize() + numEltPerGRF<Type_UB>() - 1) / numEltPerGRF<Type_UB>();
+                }
+            }
+            if (pressure + extraPressure > threshold)
+            {
+                for (const G4_Declare* dcl : sliceDcls)
+                {
+                    extendedDcls.erase(dcl);
+                }
+                continue;
+            }
+            pressure += extraPressure;
+
+            for (unsigned pos : slice)
+            {
+                moved[pos] = true;
+            }
+            numSends++;
+        }
+
+        if (numSends == 0)
+        {
+            continue;
+        }
+
+        // PH falls through into L: make the jump explicit, the latch goes in between.
+        G4_Label* loopLabel = bb->getLabel();
+        if (preheader->empty() || preheader->back()->opcode() != G4_jmpi)
+        {
+            preheader->push_back(fg.builder->createJmp(nullptr, loopLabel, InstOpt_NoOpt, false));
+        }
+        auto insertPos = std::prev(preheader->end());
+
+        G4_BB* latch = fg.createNewBBWithLabel("Pipelined_latch_");
+        for (unsigned i = 0; i < bb->getNestLevel(); i++)
+        {
+            latch->setNestLevel();
+        }
+        for (auto it = bb->begin(); it != bb->end();)
+        {
+            unsigned pos = (unsigned)(std::find(insts.begin(), insts.end(), *it) - insts.begin());
+            if (moved[pos])
+            {
+                preheader->insertBefore(insertPos, (*it)->cloneInst());
+                latch->push_back(*it);
+                it = bb->erase(it);
+                continue;
+            }
+            ++it;
+        }
+        fg.insert(bbIt, latch);
+
+        // L -> LATCH -> L replaces the L -> L back edge.
+        bb->back()->setSrc(latch->getLabel(), 0);
+        std::replace(bb->Succs.begin(), bb->Succs.end(), bb, latch);
+        std::replace(bb->Preds.begin(), bb->Preds.end(), bb, latch);
+        latch->Preds.push_back(bb);
+        latch->Succs.push_back(bb);
+        fg.markStale();
+
+        numPipelined += numSends;
+    }
+    return numPipelined;
+}
+
 preRA_RegSharing::preRA_RegSharing(G4_Kernel& k, Mem_Manager& m, RPE* rpe)
     : kernel(k)
     , mem(m)
@@ -727,11 +1183,20 @@ bool preRA_RegSharing::run()
         }
     }
 
-    if (!kernel.getOptions()->getuInt32Option(vISA_ForceHWThreadNumberPerEU) &&
-        (maxPressure > getRPThresholdHigh(kernel.getNumRegTotal() - kernel.getOptions()->getuInt32Option(vISA_ReservedGRFNum), kernel.getSimdSize())))
+    if (!kernel.getOptions()->getuInt32Option(vISA_ForceHWThreadNumberPerEU))
     {
-        // Update number of threads, GRF, Acc and SWSB
-        kernel.updateKernelByNumThreads(GrfMode.getMinNumThreads());
+        if (kernel.getOptions()->getOption(vISA_OccupancyGRFSelection))
+        {
+            // Update number of threads, GRF, Acc and SWSB
+            kernel.updateKernelByNumThreads(selectNumThreadsByOccupancy(kernel, GrfMode, rpBB));
+            kernel.fg.builder->getcompilerStats().SetI64("AutoGRFSelection",
+                kernel.getNumRegTotal(), kernel.getSimdSize());
+        }
+        else if (maxPressure > getRPThresholdHigh(kernel.getNumRegTotal() - kernel.getOptions()->getuInt32Option(vISA_ReservedGRFNum), kernel.getSimdSize()))
+        {
+            // Update number of threads, GRF, Acc and SWSB
+            kernel.updateKernelByNumThreads(GrfMode.getMinNumThreads());
+        }
     }
 
     unsigned Threshold = getRPReductionThreshold(kernel.getNumRegTotal(), kernel.getSimdSize());
@@ -1294,6 +1759,7 @@ namespace {
 
 // Queue for scheduling to hide latency.
 class LatencyQueue : public QueueBase {
+protected:
     // Assign a priority to each node.
     std::vector<unsigned> Priorities;
 
@@ -1339,7 +1805,7 @@ public:
         return pseudoKills.empty() && Q.empty();
     }
 
-private:
+protected:
     void init();
     unsigned calculatePriority(preNode *N);
 
@@ -1347,12 +1813,58 @@ private:
 
     // Compare two ready nodes and decide which one should be scheduled first.
     // Return true if N2 has a higher priority than N1, false otherwise.
-    bool compare(preNode* N1, preNode* N2);
+    virtual bool compare(preNode* N1, preNode* N2);
 
     // The ready pseudo kills.
     std::vector<preNode *> pseudoKills;
 };
 
+// Queue for scheduling with a weighted sum of latency and pressure. The
+// latency priority of a node is offset by its estimated pressure change,
+// scaled by PressureWeight, once the estimated pressure goes over the
+// latency hiding threshold.
+class BalancedQueue : public LatencyQueue {
+    struct NodeRegs {
+        // Root variable defined, or -1.
+        int Def = -1;
+        // Root variables read, with the number of reads.
+        std::vector<std::pair<unsigned, unsigned>> Uses;
+    };
+    std::vector<NodeRegs> Regs;
+
+    // Size in GRFs, remaining reads, and liveness of each variable.
+    std::vector<unsigned> Sizes;
+    std::vector<unsigned> UsesLeft;
+    std::vector<bool> IsLive;
+    std::vector<bool> IsLiveOut;
+
+    // Estimated current pressure in GRFs.
+    unsigned CurPressure = 0;
+    unsigned SoftLimit;
+    unsigned PressureWeight;
+
+public:
+    BalancedQueue(preDDD& ddd, RegisterPressure& rp, SchedConfig config,
+        const LatencyTable& LT, unsigned PressureWeight)
+        : LatencyQueue(ddd, rp, config, LT)
+        , SoftLimit(getLatencyHidingThreshold(ddd.getKernel()))
+        , PressureWeight(PressureWeight)
+    {
+        initPressure();
+    }
+
+    // Update the pressure estimate after N is scheduled.
+    void scheduled(preNode* N);
+
+private:
+    void initPressure();
+
+    // Estimated pressure change in GRFs if N is scheduled next.
+    int getPressureDelta(preNode* N) const;
+
+    bool compare(preNode* N1, preNode* N2) override;
+};
+
 } // namespace
 
 // Scheduling block to hide latency (top down).
@@ -1384,6 +1896,36 @@ void BB_Scheduler::LatencyScheduling()
     assert(verifyScheduling());
 }
 
+// Scheduling block for both latency and pressure (top down).
+//
+void BB_Scheduler::BalancedScheduling(unsigned PressureWeight)
+{
+    schedule.clear();
+    BalancedQueue Q(ddd, rp, config, LT, PressureWeight);
+    Q.push(ddd.getEntryNode());
+
+    while (!Q.empty()) {
+        preNode *N = Q.pop();
+        assert(N->NumPredsLeft == 0);
+        if (N->getInst() != nullptr) {
+            schedule.push_back(N->getInst());
+            N->isScheduled = true;
+            Q.scheduled(N);
+        }
+
+        for (auto I = N->succ_begin(), E = N->succ_end(); I != E; ++I) {
+            preNode *Node = I->getNode();
+            assert(!Node->isScheduled && Node->NumPredsLeft);
+            --Node->NumPredsLeft;
+            if (Node->NumPredsLeft == 0)
+                Q.push(Node);
+        }
+    }
+
+    relocatePseudoKills();
+    assert(verifyScheduling());
+}
+
 static void mergeSegments(const std::vector<unsigned>& RPtrace,
                           const std::vector<unsigned>& Max,
                           const std::vector<unsigned>& Min,
@@ -1669,6 +2211,127 @@ bool LatencyQueue::compare(preNode* N1, preNode* N2)
     return N2->getID() > N1->getID();
 }
 
+void BalancedQueue::initPressure()
+{
+    G4_BB* BB = ddd.getBB();
+    std::map<G4_Declare*, unsigned> VarIds;
+    auto getVar = [&](G4_Operand* Opnd) -> int {
+        G4_Declare* Dcl = Opnd ? Opnd->getTopDcl() : nullptr;
+        if (!Dcl)
+            return -1;
+        Dcl = Dcl->getRootDeclare();
+        if (Dcl->getRegFile() != G4_GRF && Dcl->getRegFile() != G4_INPUT)
+            return -1;
+        auto Res = VarIds.insert(std::make_pair(Dcl, (unsigned)Sizes.size()));
+        if (Res.second) {
+            Sizes.push_back((Dcl->getByteSize() + numEltPerGRF<Type_UB>() - 1) / numEltPerGRF<Type_UB>());
+            UsesLeft.push_back(0);
+            IsLive.push_back(rp.isLiveIn(BB, Dcl));
+            IsLiveOut.push_back(rp.isLiveOut(BB, Dcl));
+        }
+        return (int)Res.first->second;
+    };
+
+    auto& Nodes = ddd.getNodes();
+    Regs.resize(Nodes.size());
+    for (auto N : Nodes) {
+        G4_INST* Inst = N->getInst();
+        if (!Inst || Inst->isPseudoKill())
+            continue;
+        NodeRegs& R = Regs[N->getID()];
+        R.Def = getVar(Inst->getDst());
+        for (int i = 0, NumSrc = Inst->getNumSrc(); i < NumSrc; ++i) {
+            int V = getVar(Inst->getSrc(i));
+            if (V < 0)
+                continue;
+            UsesLeft[V]++;
+            auto It = std::find_if(R.Uses.begin(), R.Uses.end(),
+                [=](const std::pair<unsigned, unsigned>& U) { return U.first == (unsigned)V; });
+            if (It == R.Uses.end())
+                R.Uses.push_back(std::make_pair((unsigned)V, 1U));
+            else
+                It->second++;
+        }
+    }
+
+    // Variables live through the block are not referenced, account them
+    // with the pressure at block entry.
+    unsigned LiveInPressure = 0;
+    for (unsigned V = 0; V < Sizes.size(); ++V)
+        if (IsLive[V])
+            LiveInPressure += Sizes[V];
+    unsigned EntryPressure = BB->empty() ? 0 : rp.getPressure(BB->front());
+    CurPressure = std::max(LiveInPressure, EntryPressure);
+}
+
+int BalancedQueue::getPressureDelta(preNode* N) const
+{
+    if (!N->getInst() || N->getInst()->isPseudoKill())
+        return 0;
+    const NodeRegs& R = Regs[N->getID()];
+    int Delta = 0;
+    if (R.Def >= 0 && !IsLive[R.Def])
+        Delta += Sizes[R.Def];
+    for (auto& U : R.Uses) {
+        if (IsLive[U.first] && !IsLiveOut[U.first] && UsesLeft[U.first] == U.second &&
+            (int)U.first != R.Def)
+            Delta -= Sizes[U.first];
+    }
+    return Delta;
+}
+
+void BalancedQueue::scheduled(preNode* N)
+{
+    if (N->getInst()->isPseudoKill())
+        return;
+    int Delta = getPressureDelta(N);
+    NodeRegs& R = Regs[N->getID()];
+    for (auto& U : R.Uses) {
+        UsesLeft[U.first] -= U.second;
+        if (UsesLeft[U.first] == 0 && !IsLiveOut[U.first] && (int)U.first != R.Def)
+            IsLive[U.first] = false;
+    }
+    if (R.Def >= 0)
+        IsLive[R.Def] = true;
+    CurPressure = (unsigned)std::max(0, (int)CurPressure + Delta);
+}
+
+bool BalancedQueue::compare(preNode* N1, preNode* N2)
+{
+    assert(N1->getID() != N2->getID());
+    int D1 = getPressureDelta(N1);
+    int D2 = getPressureDelta(N2);
+
+    // Below the soft limit only latency matters; above it, each GRF of
+    // pressure increase costs PressureWeight cycles.
+    auto getScore = [=](preNode* N, int Delta) {
+        int64_t Score = Priorities[N->getID()];
+        if ((int)CurPressure + Delta > (int)SoftLimit)
+            Score -= (int64_t)PressureWeight * Delta;
+        return Score;
+    };
+    int64_t S1 = getScore(N1, D1);
+    int64_t S2 = getScore(N2, D2);
+    if (S2 > S1)
+        return true;
+    if (S1 > S2)
+        return false;
+
+    // Favor the node reducing pressure.
+    if (D1 != D2)
+        return D2 < D1;
+
+    // Favor sends.
+    G4_INST* Inst1 = N1->getInst();
+    G4_INST* Inst2 = N2->getInst();
+    if (Inst1->isSend() != Inst2->isSend())
+        return Inst2->isSend();
+
+    // Otherwise, break tie on ID.
+    // Larger ID means higher priority.
+    return N2->getID() > N1->getID();
+}
+
 // Find the edge with smallest ID.
 static preNode* minElt(const std::vector<preEdge>& Elts)
 {
@@ -1820,6 +2483,39 @@ bool BB_Scheduler::commitIfBeneficial(unsigned& MaxRPE, bool IsTopDown)
     return false;
 }
 
+// Commit a balanced scheduling if its pressure is within the limit.
+bool BB_Scheduler::commitIfBalanced(unsigned& MaxRPE, unsigned RPELimit)
+{
+    INST_LIST& CurInsts = getBB()->getInstList();
+    if (schedule.size() != CurInsts.size()) {
+        SCHED_DUMP(std::cerr << "schedule reverted due to mischeduling.\n\n");
+        return false;
+    }
+    if (std::equal(CurInsts.begin(), CurInsts.end(), schedule.begin())) {
+        SCHED_DUMP(std::cerr << "schedule not committed due to no change.\n\n");
+        return false;
+    }
+
+    INST_LIST TempInsts;
+    TempInsts.splice(TempInsts.begin(), CurInsts, CurInsts.begin(), CurInsts.end());
+    for (auto Inst : schedule)
+        CurInsts.push_back(Inst);
+
+    rp.recompute(getBB());
+    unsigned NewRPE = rp.getPressure(getBB());
+    if (NewRPE <= RPELimit) {
+        SCHED_DUMP(std::cerr << "balanced schedule committed with pressure " << NewRPE << ".\n\n");
+        MaxRPE = NewRPE;
+        return true;
+    }
+
+    SCHED_DUMP(std::cerr << "the pressure is increased to " << NewRPE << ", backtracking\n");
+    CurInsts.clear();
+    CurInsts.splice(CurInsts.begin(), TempInsts, TempInsts.begin(), TempInsts.end());
+    rp.recompute(getBB());
+    return false;
+}
+
 // Implementation of preNode.
 preNode::~preNode() {}
 
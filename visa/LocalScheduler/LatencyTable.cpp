@@ -10,8 +10,144 @@ SPDX-License-Identifier: MIT
 #include "LocalScheduler_G4IR.h"
 #include "../G4_IR.hpp"
 
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
 using namespace vISA;
 
+static const char* const LatencyProfileKeyNames[LatencyProfile::NUM_KEYS] =
+{
+    "FPU_ACC",
+    "FPU",
+    "MATH",
+    "BRANCH",
+    "BARRIER",
+    "DELTA",
+    "DELTA_MATH",
+    "ARF",
+    "DPAS",
+    "SLM",
+    "SEND_OTHERS",
+    "DP_L3",
+    "SAMPLER_L3",
+    "SLM_FENCE",
+    "OC_MATH",
+    "OC_OTHERS",
+    "TOKEN_MATH",
+    "TOKEN_SLM",
+    "TOKEN_MEMORY",
+    "TOKEN_SAMPLER",
+    "TOKEN_DPAS",
+};
+
+static bool equalsIgnoreCase(const std::string& str1, const char* str2)
+{
+    return str1.size() == strlen(str2) &&
+        std::equal(str1.begin(), str1.end(), str2, [](char c1, char c2) {
+            return std::tolower((unsigned char)c1) == std::tolower((unsigned char)c2); });
+}
+
+static bool isPlatformName(const std::string& name, TARGET_PLATFORM platform)
+{
+    const char* const* symbols = getGenxPlatformStrings(platform);
+    for (; symbols && *symbols; symbols++)
+    {
+        if (equalsIgnoreCase(name, *symbols))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool LatencyProfile::parse(std::istream& is, TARGET_PLATFORM platform)
+{
+    bool inSection = true;
+    std::string line;
+    while (std::getline(is, line))
+    {
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), '=', ' ');
+        std::istringstream tokens(line);
+        std::string name;
+        if (!(tokens >> name))
+        {
+            continue;
+        }
+
+        if (name.front() == '[')
+        {
+            // [<platform> <platform> ...]
+            std::string names = line.substr(line.find('[') + 1);
+            size_t end = names.find(']');
+            if (end == std::string::npos)
+            {
+                return false;
+            }
+            std::istringstream platforms(names.substr(0, end));
+            inSection = false;
+            while (platforms >> name)
+            {
+                inSection |= isPlatformName(name, platform);
+            }
+            continue;
+        }
+
+        unsigned value = 0;
+        if (!(tokens >> value) || value > UINT16_MAX)
+        {
+            return false;
+        }
+        auto key = std::find_if(std::begin(LatencyProfileKeyNames), std::end(LatencyProfileKeyNames),
+            [&](const char* keyName) { return equalsIgnoreCase(name, keyName); });
+        if (key == std::end(LatencyProfileKeyNames))
+        {
+            return false;
+        }
+        if (inSection)
+        {
+            auto i = key - std::begin(LatencyProfileKeyNames);
+            values[i] = (uint16_t)value;
+            isSet[i] = true;
+        }
+    }
+    return true;
+}
+
+const LatencyProfile* LatencyProfile::get(const IR_Builder* builder)
+{
+    const char* fileName = builder->getOptions()->getOptionCstr(vISA_LatencyProfile);
+    if (!fileName || !*fileName)
+    {
+        return nullptr;
+    }
+
+    // Kernels may be compiled on multiple threads.
+    static std::mutex cacheLock;
+    static std::map<std::pair<std::string, TARGET_PLATFORM>, std::unique_ptr<LatencyProfile>> cache;
+    std::lock_guard<std::mutex> lock(cacheLock);
+
+    auto key = std::make_pair(std::string(fileName), builder->getPlatform());
+    auto it = cache.find(key);
+    if (it == cache.end())
+    {
+        std::unique_ptr<LatencyProfile> profile(new LatencyProfile());
+        std::ifstream is(fileName);
+        if (!is || !profile->parse(is, builder->getPlatform()))
+        {
+            std::cerr << "warning: ignoring invalid latency profile " << fileName << "\n";
+            profile.reset();
+        }
+        it = cache.emplace(key, std::move(profile)).first;
+    }
+    return it->second.get();
+}
+
 uint16_t LatencyTable::getLatency(G4_INST* Inst) const
 {
     auto GEN = getPlatformGeneration(m_builder->getPlatform());
@@ -121,39 +257,44 @@ uint16_t LatencyTable::getLatencyG12(const G4_INST* Inst) const
     if (Inst->isSend()) {
         G4_SendDesc* MsgDesc = Inst->getMsgDesc();
         if (MsgDesc->isSLM())
-            return Inst->asSendInst()->isFence() ? LatenciesXe::SLM_FENCE : LatenciesXe::SLM;
+            return Inst->asSendInst()->isFence() ?
+                value(LatencyProfile::SLM_FENCE, LatenciesXe::SLM_FENCE) :
+                value(LatencyProfile::SLM, LatenciesXe::SLM);
         if (MsgDesc->isSampler())
-            return LatenciesXe::SAMPLER_L3;
+            return value(LatencyProfile::SAMPLER_L3, LatenciesXe::SAMPLER_L3);
         if (MsgDesc->isHDC())
-            return LatenciesXe::DP_L3;
+            return value(LatencyProfile::DP_L3, LatenciesXe::DP_L3);
         if (MsgDesc->isBarrier())
-            return LatenciesXe::BARRIER;
-         return LatenciesXe::SEND_OTHERS;
+            return value(LatencyProfile::BARRIER, LatenciesXe::BARRIER);
+         return value(LatencyProfile::SEND_OTHERS, LatenciesXe::SEND_OTHERS);
     }
     if (Inst->isMath())
     {
-        return uint16_t(LatenciesXe::MATH + LatenciesXe::DELTA_MATH * Scale);
+        return uint16_t(value(LatencyProfile::MATH, LatenciesXe::MATH) +
+            value(LatencyProfile::DELTA_MATH, LatenciesXe::DELTA_MATH) * Scale);
     }
     if (Inst->isFlowControl())
     {
-        return LatenciesXe::BRANCH;
+        return value(LatencyProfile::BRANCH, LatenciesXe::BRANCH);
     }
     if (Inst->isDpas()) {
         G4_InstDpas *dpas = Inst->asDpasInst();
-        return uint16_t(LatenciesXe::DPAS + dpas->getRepeatCount() - 1);
+        return uint16_t(value(LatencyProfile::DPAS, LatenciesXe::DPAS) + dpas->getRepeatCount() - 1);
     }
     if (Inst->writesFlag() || (Dst && Dst->isA0()))
     {
-        return LatenciesXe::ARF;
+        return value(LatencyProfile::ARF, LatenciesXe::ARF);
     }
     if (Inst->isArithmetic()) {
         if (Dst->isAccReg())
-            return uint16_t(LatenciesXe::FPU_ACC + LatenciesXe::DELTA * Scale);
-        return uint16_t(LatenciesXe::FPU + LatenciesXe::DELTA * Scale);
+            return uint16_t(value(LatencyProfile::FPU_ACC, LatenciesXe::FPU_ACC) +
+                value(LatencyProfile::DELTA, LatenciesXe::DELTA) * Scale);
+        return uint16_t(value(LatencyProfile::FPU, LatenciesXe::FPU) +
+            value(LatencyProfile::DELTA, LatenciesXe::DELTA) * Scale);
     }
 
     // By default, use the FPU pipeline latency.
-    return uint16_t(LatenciesXe::FPU);
+    return uint16_t(value(LatencyProfile::FPU, LatenciesXe::FPU));
 }
 
 uint16_t LatencyTable::getOccupancyG12(G4_INST* Inst) const
@@ -166,12 +307,12 @@ uint16_t LatencyTable::getOccupancyG12(G4_INST* Inst) const
     int Sz = Inst->getExecSize();
     int Scale = (Sz <= 8) ? 1 : (Sz == 16) ? 2 : 4;
     if (Inst->isMath())
-        return uint16_t(G12_OC_MATH * Scale);
+        return uint16_t(value(LatencyProfile::OC_MATH, G12_OC_MATH) * Scale);
     if (Inst->isFastHFInstruction())
         Scale = (Sz <= 16) ? 1 : 2;
     else if (G4_DstRegRegion* Dst = Inst->getDst()) {
         if (Dst->getTypeSize() == 8)
             Scale = (Sz <= 4) ? 1 : 2;
     }
-    return uint16_t(G12_OC_Others * Scale);
+    return uint16_t(value(LatencyProfile::OC_OTHERS, G12_OC_Others) * Scale);
 }
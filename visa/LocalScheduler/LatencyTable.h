@@ -11,6 +11,8 @@ SPDX-License-Identifier: MIT
 
 #include "../BuildIR.h"
 
+#include <istream>
+
 namespace vISA
 {
 
@@ -83,17 +85,88 @@ namespace vISA
     };
 
 
+    //
+    // Latency and occupancy values loaded from a profile file (-latencyProfile),
+    // so that the Xe+ scheduling and SWSB tables can be calibrated for a given
+    // part without rebuilding. The file is plain text, one "<name> <value>"
+    // pair per line, with '#' starting a comment, e.g.
+    //
+    //     FPU 10
+    //     [XE_HP]        # the lines below only apply to this platform
+    //     DP_L3 180
+    //
+    // Names are the LatenciesXe entries, OC_MATH/OC_OTHERS for the occupancy
+    // and TOKEN_* for the SWSB token cycles. A section header lists platform
+    // names as accepted by -platform. Entries that are not in the file keep
+    // their built-in value.
+    //
+    class LatencyProfile
+    {
+    public:
+        enum Key
+        {
+            FPU_ACC,
+            FPU,
+            MATH,
+            BRANCH,
+            BARRIER,
+            DELTA,
+            DELTA_MATH,
+            ARF,
+            DPAS,
+            SLM,
+            SEND_OTHERS,
+            DP_L3,
+            SAMPLER_L3,
+            SLM_FENCE,
+            OC_MATH,
+            OC_OTHERS,
+            TOKEN_MATH,
+            TOKEN_SLM,
+            TOKEN_MEMORY,
+            TOKEN_SAMPLER,
+            TOKEN_DPAS,
+            NUM_KEYS
+        };
+
+        // Returns the profile selected for builder's platform, or nullptr if
+        // no profile is given. Profiles are parsed once per process.
+        static const LatencyProfile* get(const IR_Builder* builder);
+
+        static uint16_t getValue(const IR_Builder* builder, Key key, uint16_t defaultValue)
+        {
+            const LatencyProfile* profile = get(builder);
+            return profile ? profile->getValue(key, defaultValue) : defaultValue;
+        }
+
+        uint16_t getValue(Key key, uint16_t defaultValue) const
+        {
+            return isSet[key] ? values[key] : defaultValue;
+        }
+
+        bool parse(std::istream& is, TARGET_PLATFORM platform);
+
+    private:
+        uint16_t values[NUM_KEYS] = {};
+        bool isSet[NUM_KEYS] = {};
+    };
+
     class LatencyTable
     {
     public:
         explicit LatencyTable(const IR_Builder* builder)
-            : m_builder(builder)
+            : m_builder(builder), m_profile(LatencyProfile::get(builder))
         {
         }
         // Functions to get latencies/occupancy based on platforms
         uint16_t getOccupancy(G4_INST* Inst) const;
         uint16_t getLatency(G4_INST* Inst) const;
     private:
+        uint16_t value(LatencyProfile::Key key, uint16_t defaultValue) const
+        {
+            return m_profile ? m_profile->getValue(key, defaultValue) : defaultValue;
+        }
+
         uint16_t getLatencyLegacy(G4_INST* Inst) const;
         uint16_t getOccupancyLegacy(G4_INST* Inst) const;
 
@@ -102,6 +175,7 @@ namespace vISA
         uint16_t getOccupancyG12(G4_INST* Inst) const;
 
         const IR_Builder* m_builder;
+        const LatencyProfile* m_profile;
     };
 
 } // namespace vISA
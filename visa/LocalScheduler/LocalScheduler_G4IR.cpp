@@ -33,6 +33,12 @@ void LocalScheduler::localScheduling()
     const Options *m_options = fg.builder->getOptions();
     LatencyTable LT(fg.builder);
 
+    if (m_options->getOption(vISA_GlobalSendHoisting))
+    {
+        unsigned numHoisted = hoistSendsAcrossBlocks();
+        fg.builder->getcompilerStats().SetI64("NumHoistedSends", numHoisted, fg.getKernel()->getSimdSize());
+    }
+
     uint32_t totalCycles = 0;
     uint32_t scheduleStartBBId = m_options->getuInt32Option(vISA_LocalSchedulingStartBB);
     uint32_t shceduleEndBBId = m_options->getuInt32Option(vISA_LocalSchedulingEndBB);
@@ -107,6 +113,248 @@ void LocalScheduler::localScheduling()
     fg.builder->getcompilerStats().SetI64(CompilerStats::numCyclesStr(), totalCycles, fg.getKernel()->getSimdSize());
 }
 
+namespace {
+    // Registers read and written by one instruction after RA.
+    struct RegFootprint
+    {
+        std::vector<std::pair<unsigned, unsigned>> grfReads;  // byte ranges
+        std::vector<std::pair<unsigned, unsigned>> grfWrites;
+        uint32_t arfReads = 0;   // bit per G4_ArchRegKind
+        uint32_t arfWrites = 0;
+        bool unknown = false;    // indirect access
+
+        explicit RegFootprint(G4_INST* inst)
+        {
+            for (Gen4_Operand_Number opndNum
+                : {Opnd_dst, Opnd_condMod, Opnd_implAccDst,
+                Opnd_src0, Opnd_src1, Opnd_src2, Opnd_src3, Opnd_pred, Opnd_implAccSrc})
+            {
+                G4_Operand* opnd = inst->getOperand(opndNum);
+                if (!opnd || !opnd->getBase() || opnd->isLabel() || opnd->isImm())
+                {
+                    continue;
+                }
+                bool isWrite = opndNum == Opnd_dst || opndNum == Opnd_condMod || opndNum == Opnd_implAccDst;
+                if ((opnd->isDstRegRegion() && opnd->asDstRegRegion()->isIndirect()) ||
+                    (opnd->isSrcRegRegion() && opnd->asSrcRegRegion()->isIndirect()))
+                {
+                    unknown = true;
+                    continue;
+                }
+                G4_VarBase* base = opnd->getBase();
+                G4_VarBase* phyReg = base->isRegVar() ? base->asRegVar()->getPhyReg() : base;
+                if (!phyReg)
+                {
+                    unknown = true;
+                }
+                else if (phyReg->isGreg())
+                {
+                    auto range = std::make_pair(opnd->getLinearizedStart(), opnd->getLinearizedEnd());
+                    (isWrite ? grfWrites : grfReads).push_back(range);
+                }
+                else if (phyReg->isAreg())
+                {
+                    G4_ArchRegKind kind = phyReg->asAreg()->getArchRegType();
+                    if (kind != AREG_NULL)
+                    {
+                        (isWrite ? arfWrites : arfReads) |= 1u << kind;
+                    }
+                }
+                else
+                {
+                    unknown = true;
+                }
+            }
+        }
+
+        static bool overlap(const std::vector<std::pair<unsigned, unsigned>>& ranges1,
+            const std::vector<std::pair<unsigned, unsigned>>& ranges2)
+        {
+            for (auto& r1 : ranges1)
+            {
+                for (auto& r2 : ranges2)
+                {
+                    if (r1.first <= r2.second && r2.first <= r1.second)
+                    {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        // Can the instructions with this and other footprint be reordered?
+        bool isIndependent(const RegFootprint& other) const
+        {
+            return !unknown && !other.unknown &&
+                !overlap(grfWrites, other.grfReads) && !overlap(grfWrites, other.grfWrites) &&
+                !overlap(grfReads, other.grfWrites) &&
+                !(arfWrites & (other.arfReads | other.arfWrites)) && !(arfReads & other.arfWrites);
+        }
+    };
+
+    bool isReadOnlySend(const G4_INST* inst)
+    {
+        if (!inst->isSend() || inst->isEOT())
+        {
+            return false;
+        }
+        const G4_SendDesc* msgDesc = inst->getMsgDesc();
+        return (msgDesc->isSampler() || msgDesc->isHDC()) &&
+            msgDesc->isRead() && !msgDesc->isWrite() && !msgDesc->isAtomic() &&
+            !msgDesc->isFence() && !msgDesc->isBarrier();
+    }
+
+    // Instructions a read-only send cannot be moved across.
+    bool isHoistingBarrier(const G4_INST* inst)
+    {
+        return (inst->isSend() && !isReadOnlySend(inst)) || inst->isWait() || inst->isEOT() ||
+            inst->isCall() || inst->isFCall() || inst->isReturn() || inst->isFReturn() ||
+            inst->isIntrinsic();
+    }
+
+    std::vector<G4_BB*> getUniqueBBs(const std::list<G4_BB*>& bbs)
+    {
+        std::vector<G4_BB*> result;
+        for (G4_BB* bb : bbs)
+        {
+            if (std::find(result.begin(), result.end(), bb) == result.end())
+            {
+                result.push_back(bb);
+            }
+        }
+        return result;
+    }
+}
+
+//
+// Move long latency read-only sends from the head of a join block into the
+// block that branches around it, so that their latency overlaps with the
+// code on the branch arms. Only single entry/single exit if-then (triangle)
+// and if-then-else (diamond) regions are considered:
+//
+//        P              P
+//       / \            / \
+//      T   |          T1   T2
+//       \ /            \ /
+//        B              B
+//
+// B executes whenever P does and with the same execution mask, so the send
+// is never speculated. It is placed right before the branch of P and is
+// moved only if it is independent of the arm blocks, of the instructions of
+// B ahead of it, and of the branch itself. SWSB runs later and sets up the
+// dependences of the moved sends.
+//
+unsigned LocalScheduler::hoistSendsAcrossBlocks()
+{
+    unsigned numHoisted = 0;
+    // Visit the blocks bottom up, so that sends can move up nested regions.
+    for (auto ib = fg.rbegin(), ie = fg.rend(); ib != ie; ++ib)
+    {
+        G4_BB* bb = *ib;
+        std::vector<G4_BB*> preds = getUniqueBBs(bb->Preds);
+        if (preds.size() != 2)
+        {
+            continue;
+        }
+
+        // Find P and the arms of the region.
+        G4_BB* head = nullptr;
+        std::vector<G4_BB*> arms;
+        for (G4_BB* pred : preds)
+        {
+            if (pred->Preds.size() == 1 && getUniqueBBs(pred->Succs).size() == 1)
+            {
+                G4_BB* armPred = pred->Preds.front();
+                if (head && head != armPred)
+                {
+                    head = nullptr;
+                    break;
+                }
+                head = armPred;
+                arms.push_back(pred);
+            }
+        }
+        if (!head || head == bb ||
+            std::find(arms.begin(), arms.end(), head) != arms.end())
+        {
+            continue;
+        }
+        bool isTriangle = std::find(preds.begin(), preds.end(), head) != preds.end();
+        if (arms.size() != (isTriangle ? 1 : 2))
+        {
+            continue;
+        }
+        std::vector<G4_BB*> headSuccs = getUniqueBBs(head->Succs);
+        if (headSuccs.size() != 2 ||
+            !std::all_of(headSuccs.begin(), headSuccs.end(), [&](G4_BB* succ) {
+                return succ == bb || std::find(arms.begin(), arms.end(), succ) != arms.end(); }))
+        {
+            continue;
+        }
+
+        INST_LIST_ITER insertPos = head->end();
+        G4_INST* headBranch = head->empty() ? nullptr : head->back();
+        if (headBranch && headBranch->isFlowControl())
+        {
+            if (headBranch->isCall() || headBranch->isFCall() ||
+                headBranch->isReturn() || headBranch->isFReturn())
+            {
+                continue;
+            }
+            insertPos = std::prev(head->end());
+        }
+
+        // Everything a hoisted send moves across.
+        std::vector<RegFootprint> crossed;
+        bool hasBarrier = false;
+        if (headBranch && headBranch->isFlowControl())
+        {
+            crossed.emplace_back(headBranch);
+        }
+        for (G4_BB* arm : arms)
+        {
+            for (G4_INST* inst : *arm)
+            {
+                hasBarrier |= isHoistingBarrier(inst);
+                crossed.emplace_back(inst);
+            }
+        }
+        if (hasBarrier)
+        {
+            continue;
+        }
+
+        for (auto it = bb->begin(); it != bb->end();)
+        {
+            G4_INST* inst = *it;
+            if (inst->isLabel() || inst->opcode() == G4_endif || inst->opcode() == G4_join)
+            {
+                ++it;
+                continue;
+            }
+            if (isHoistingBarrier(inst) || inst->isFlowControl())
+            {
+                break;
+            }
+
+            RegFootprint footprint(inst);
+            if (isReadOnlySend(inst) && !inst->getPredicate() &&
+                std::all_of(crossed.begin(), crossed.end(),
+                    [&](const RegFootprint& other) { return footprint.isIndependent(other); }))
+            {
+                head->insertBefore(insertPos, inst);
+                it = bb->erase(it);
+                numHoisted++;
+                continue;
+            }
+            crossed.push_back(footprint);
+            ++it;
+        }
+    }
+    return numHoisted;
+}
+
 void G4_BB_Schedule::dumpSchedule(G4_BB *bb)
 {
     const char *asmName = nullptr;
@@ -1342,6 +1590,9 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
     TOTAL_BUCKETS = OTHER_ARF_BUCKET + 1;
 
     LiveBuckets LB(this, GRF_BUCKET, TOTAL_BUCKETS);
+    succEdgeIdx.resize(bb->size(), -1);
+    reachLatency.resize(bb->size(), 0);
+    reachOwner.resize(bb->size(), nullptr);
 
     // Building the graph in reverse relative to the original instruction
     // order, to naturally take care of the liveness of operands.
@@ -1355,6 +1606,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
         // If we have a pair of instructions to be mapped on a single DAG node:
         node = new (mem)Node(nodeId, *iInst, depEdgeAllocator, LT);
         allNodes.push_back(node);
+        edgeOwner = node;
         G4_INST *curInst = node->getInstructions()->front();
         bool hasIndir = false;
         BDvec.clear();
@@ -1546,6 +1798,8 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
                 createAddEdge(node, lastBarrier, lastBarrier->isBarrier());
                 node->hasTransitiveEdgeToBarrier = true;
             }
+
+            pruneTransitiveEdges(node);
         }
 
         // Add buckets of current instruction to bucket list
@@ -1557,6 +1811,7 @@ DDD::DDD(Mem_Manager& m, G4_BB* bb, const LatencyTable& lt, G4_Kernel* k)
         // Insert this node into the graph.
         InsertNode(node);
     }
+    edgeOwner = nullptr;
 
     if (Nodes.size())
     {
@@ -1883,8 +2138,18 @@ void DDD::setPriority(Node *pred, const Edge &edge)
 // The edge latency is also attached.
 void DDD::createAddEdge(Node* pred, Node* succ, DepType d)
 {
-    // Check whether an edge already exists
-    for (int i = 0; i < (int)(pred->succs.size()); i++)
+    // Check whether an edge already exists. While building the DAG, the
+    // edges of the current node are indexed by successor.
+    int begin = 0, end = (int)pred->succs.size();
+    if (pred == edgeOwner && succ->nodeID < succEdgeIdx.size())
+    {
+        int idx = succEdgeIdx[succ->nodeID];
+        bool found = idx >= 0 && idx < end && pred->succs[idx].getNode() == succ;
+        begin = found ? idx : end;
+        end = found ? idx + 1 : end;
+        succEdgeIdx[succ->nodeID] = found ? idx : (int)pred->succs.size();
+    }
+    for (int i = begin; i < end; i++)
     {
         Edge& curSucc = pred->succs[i];
         // Keep the deptype that has the highest latency
@@ -1915,6 +2180,66 @@ void DDD::createAddEdge(Node* pred, Node* succ, DepType d)
     succ->preds.emplace_back(pred, d, edgeLatency);
 }
 
+void DDD::pruneTransitiveEdges(Node* node)
+{
+    // Bound the work on nodes with many successors.
+    const unsigned maxVisits = 1024;
+    if (node->succs.size() < 2)
+    {
+        return;
+    }
+
+    unsigned numVisits = 0;
+    for (const Edge& edge : node->succs)
+    {
+        Node* succ = edge.getNode();
+        if (succ->isBarrier())
+        {
+            continue;
+        }
+        for (const Edge& succEdge : succ->succs)
+        {
+            Node* next = succEdge.getNode();
+            if (next->nodeID >= reachOwner.size())
+            {
+                continue;
+            }
+            uint32_t pathLatency = edge.getLatency() + succEdge.getLatency();
+            if (reachOwner[next->nodeID] != node || reachLatency[next->nodeID] < pathLatency)
+            {
+                reachOwner[next->nodeID] = node;
+                reachLatency[next->nodeID] = pathLatency;
+            }
+            if (++numVisits >= maxVisits)
+            {
+                break;
+            }
+        }
+        if (numVisits >= maxVisits)
+        {
+            break;
+        }
+    }
+
+    // A longer path keeps both the priority of node and the earliest issue
+    // time of the successor, so the direct edge carries no information.
+    for (int i = 0; i < (int)node->succs.size();)
+    {
+        Edge& edge = node->succs[i];
+        Node* succ = edge.getNode();
+        bool isDataDep = edge.getType() >= RAW && edge.getType() <= WAW_MEMORY;
+        if (isDataDep && succ->nodeID < reachOwner.size() && reachOwner[succ->nodeID] == node &&
+            reachLatency[succ->nodeID] >= edge.getLatency())
+        {
+            succ->deletePred(node);
+            node->succs[i] = node->succs.back();
+            node->succs.pop_back();
+            continue;
+        }
+        i++;
+    }
+}
+
 // Debug function for generating the dependency graph in dot format
 void DDD::dumpDagDot(G4_BB *bb)
 {
@@ -2314,6 +2639,27 @@ uint32_t DDD::listSchedule(G4_BB_Schedule *schedule)
     // Used to avoid WAW subreg hazards
     Node *lastScheduled = nullptr;
 
+    // With SWSB, each out-of-order instruction holds a token until it
+    // completes. When all tokens are in flight, the next one stalls until a
+    // token is released (forced token reuse), so model the token pool and
+    // prefer in-order instructions while it is exhausted.
+    const bool modelTokens = getBuilder()->hasSWSB() &&
+        getOptions()->getOption(vISA_SWSBAwareScheduling);
+    const unsigned numTokens = std::max(1u, kernel->getNumSWSBTokens());
+    std::vector<uint32_t> tokenReleaseCycles;
+    auto needsToken = [](Node* node) {
+        for (G4_INST* inst : *node->getInstructions())
+        {
+            if (inst->tokenHonourInstruction())
+                return true;
+        }
+        return false;
+    };
+    auto releaseTokens = [&tokenReleaseCycles](uint32_t cycle) {
+        tokenReleaseCycles.erase(std::remove_if(tokenReleaseCycles.begin(), tokenReleaseCycles.end(),
+            [cycle](uint32_t release) { return release <= cycle; }), tokenReleaseCycles.end());
+    };
+
     // Keep scheduling until both readyList or preReadyQueue contain instrs.
     while (!(readyList.empty() && preReadyQueue.empty()))
     {
@@ -2495,12 +2841,54 @@ uint32_t DDD::listSchedule(G4_BB_Schedule *schedule)
             }
         }
 
+        bool scheduledNeedsToken = modelTokens && needsToken(scheduled);
+        if (scheduledNeedsToken)
+        {
+            releaseTokens(currCycle);
+            if (tokenReleaseCycles.size() >= numTokens && !readyList.empty())
+            {
+                // All tokens are busy: issue an in-order instruction instead.
+                std::vector<Node*> popped;
+                const int searchSize = std::min(4, (int)readyList.size());
+                for (int i = 0; i < searchSize; ++i)
+                {
+                    Node* next = readyList.top();
+                    readyList.pop();
+                    if (!needsToken(next))
+                    {
+                        readyList.push(scheduled);
+                        scheduled = next;
+                        scheduledNeedsToken = false;
+                        break;
+                    }
+                    popped.push_back(next);
+                }
+                for (auto nodes : popped)
+                {
+                    readyList.push(nodes);
+                }
+            }
+        }
+
         assert(scheduled && "Must have found an instruction to schedule by now");
 
         // Append the scheduled node to the end of the schedule.
         schedule->scheduledNodes.push_back(scheduled);
         lastScheduled = scheduled;
 
+        if (scheduledNeedsToken)
+        {
+            if (tokenReleaseCycles.size() >= numTokens)
+            {
+                // Wait for the earliest token to be released.
+                auto first = std::min_element(tokenReleaseCycles.begin(), tokenReleaseCycles.end());
+                currCycle = std::max(currCycle, *first);
+                tokenReleaseCycles.erase(first);
+            }
+            tokenReleaseCycles.push_back(
+                currCycle + LT.getLatency(scheduled->getInstructions()->front()));
+        }
+
         // Set the cycle at which this node is scheduled.
         scheduled->schedTime = currCycle;
 
@@ -240,9 +240,24 @@ class DDD {
     int totalGRFNum;
     G4_Kernel* kernel;
 
+    // While building the DAG, the node whose edges are being added, and for
+    // each node ID the position of the edge to it in that node's succs.
+    // This avoids scanning succs for an existing edge on large blocks.
+    Node* edgeOwner = nullptr;
+    std::vector<int> succEdgeIdx;
+
+    // Longest known path latency from the node being pruned to each node
+    // ID, valid if reachOwner is that node.
+    std::vector<uint32_t> reachLatency;
+    std::vector<Node*> reachOwner;
+
     // Gather all initial ready nodes.
     void collectRoots();
 
+    // Remove the data dependence edges of node that are implied by a path
+    // through another successor, with at least the same latency.
+    void pruneTransitiveEdges(Node* node);
+
 public:
     typedef std::pair<Node *, Node *> instrPair_t;
     typedef std::vector<instrPair_t> instrPairVec_t;
@@ -323,6 +338,7 @@ class LocalScheduler {
 
     // send latencies are now defined in FFLatency in LIR.cpp
     void EmitNode(Node *);
+    unsigned hoistSendsAcrossBlocks();
 
 public:
     LocalScheduler(FlowGraph &flowgraph, Mem_Manager &m)
@@ -343,6 +359,22 @@ private:
     Options* m_options;
 };
 
+// Two stage software pipelining of single block loops. The read-only sends
+// of iteration i+1, together with the instructions computing their payload,
+// are issued from a new latch block at the end of iteration i, and a copy
+// of them feeds the first iteration from the preheader.
+class preRA_LoopPipeliner {
+public:
+    preRA_LoopPipeliner(G4_Kernel& k, Mem_Manager& m)
+        : kernel(k), mem(m) {}
+    // Returns the number of pipelined sends.
+    unsigned run();
+
+private:
+    G4_Kernel& kernel;
+    Mem_Manager& mem;
+};
+
 class GRFMode
 {
 public:
@@ -355,6 +387,24 @@ public:
     unsigned getMinNumThreads() const { return configurations[configurations.size() - 1].second; }
     unsigned getMaxNumThreads() const { return configurations[0].second; }
     unsigned getDefaultNumThreads() const { return configurations[defaultMode].second; }
+    // Number of threads of the smallest configuration with more than numGRF
+    // GRFs, or 0 if there is none.
+    unsigned getNumThreadsForLargerGRF(unsigned numGRF) const
+    {
+        for (auto& config : configurations)
+        {
+            if (config.first > numGRF)
+                return config.second;
+        }
+        return 0;
+    }
+    unsigned getNumModes() const { return (unsigned)configurations.size(); }
+    const std::pair<unsigned, unsigned>& getMode(unsigned mode) const { return configurations[mode]; }
+
+    // Occupancy model: estimated cost, in instruction issue slots, of running
+    // a kernel of instNum instructions with numThreads threads and the given
+    // number of loop weighted spill/fill references.
+    float estimateCost(unsigned numThreads, unsigned spillRefCount, unsigned instNum) const;
 
 private:
     // Store all configurations <GRF, numThreads> for current platform
@@ -932,6 +932,10 @@ void SWSB::SWSBGlobalTokenGenerator(PointsToAnalysis& p, LiveGRFBuckets& LB, Liv
         {
             quickTokenAllocation();
         }
+        else if (fg.builder->getOptions()->getOption(vISA_GraphColorTokenAllocation))
+        {
+            tokenAllocationGraphColoring();
+        }
         else
         {
             tokenAllocation();
@@ -1370,7 +1374,7 @@ unsigned SWSB::getDepDelay(const SBNode* curNode) const
     }
     else if (inst->isDpas())
     {
-        reuseDelay = TOKEN_AFTER_WRITE_DPAS_CYCLE;
+        reuseDelay = tokenAfterWriteDPASCycle;
     }
     else
     {
@@ -1514,7 +1518,7 @@ bool SWSB::cycleExpired(const SBNode* node, int currentID) const
     }
     else if (node->GetInstruction()->isDpas())
     {
-        return TOKEN_AFTER_WRITE_DPAS_CYCLE <= (currentID - node->getLiveStartID());
+        return tokenAfterWriteDPASCycle <= (currentID - node->getLiveStartID());
     }
     else
     {
@@ -2083,36 +2087,85 @@ void SWSB::SWSBGlobalTokenAnalysis()
     }
 }
 
+//
+// The reaching analyses below are solved with a worklist: every BB is visited
+// once in layout order, and afterwards a BB is revisited only if the live out
+// of one of its predecessors has grown. Since live_out only grows, a BB whose
+// live out is unchanged cannot affect its successors.
+//
 void SWSB::SWSBGlobalScalarCFGReachAnalysis()
 {
-    bool change = true;
-    while (change)
+    std::queue<G4_BB*> worklist;
+    std::vector<bool> inWorklist(BBVector.size(), true);
+    for (G4_BB* bb : fg)
     {
-        change = false;
-        for (G4_BB* bb : fg)
+        worklist.push(bb);
+    }
+
+    SBBitSets oldLiveOut(globalSendNum);
+    int64_t numVisits = 0;
+    while (!worklist.empty())
+    {
+        G4_BB* bb = worklist.front();
+        worklist.pop();
+        unsigned bbID = bb->getId();
+        inWorklist[bbID] = false;
+        numVisits++;
+
+        oldLiveOut = BBVector[bbID]->send_live_out;
+        globalDependenceDefReachAnalysis(bb);
+        if (BBVector[bbID]->send_live_out != oldLiveOut)
         {
-            if (globalDependenceDefReachAnalysis(bb))
+            for (G4_BB* succBB : bb->Succs)
             {
-                change = true;
+                if (!inWorklist[succBB->getId()])
+                {
+                    inWorklist[succBB->getId()] = true;
+                    worklist.push(succBB);
+                }
             }
         }
     }
+
+    fg.builder->getcompilerStats().SetI64("SWSBScalarReachVisits", numVisits, kernel.getSimdSize());
 }
 
 void SWSB::SWSBGlobalSIMDCFGReachAnalysis()
 {
-    bool change = true;
-    while (change)
+    std::queue<G4_BB*> worklist;
+    std::vector<bool> inWorklist(BBVector.size(), true);
+    for (G4_BB* bb : fg)
     {
-        change = false;
-        for (G4_BB* bb : fg)
+        worklist.push(bb);
+    }
+
+    SBBitSets oldLiveOut(globalSendNum);
+    int64_t numVisits = 0;
+    while (!worklist.empty())
+    {
+        G4_BB* bb = worklist.front();
+        worklist.pop();
+        unsigned bbID = bb->getId();
+        inWorklist[bbID] = false;
+        numVisits++;
+
+        oldLiveOut = BBVector[bbID]->send_live_out;
+        globalDependenceUseReachAnalysis(bb);
+        if (BBVector[bbID]->send_live_out != oldLiveOut)
         {
-            if (globalDependenceUseReachAnalysis(bb))
+            for (G4_BB_SB* succ : BBVector[bbID]->Succs)
             {
-                change = true;
+                G4_BB* succBB = succ->getBB();
+                if (!inWorklist[succBB->getId()])
+                {
+                    inWorklist[succBB->getId()] = true;
+                    worklist.push(succBB);
+                }
             }
         }
     }
+
+    fg.builder->getcompilerStats().SetI64("SWSBSIMDReachVisits", numVisits, kernel.getSimdSize());
 }
 
 void SWSB::setTopTokenIndex()
@@ -2414,6 +2467,207 @@ void SWSB::tokenAllocation()
     tokenProfile.setMathInstCount(mathInstCount);
 }
 
+//
+// The cost of giving node1 and node2, whose live ranges overlap, the same
+// token: the later one has to wait until the earlier one finishes. The stall
+// is weighted by the loop nest level of the stalling node, since it is paid
+// once per iteration.
+//
+unsigned SWSB::getTokenReuseCost(const SBNode* node1, const SBNode* node2) const
+{
+    const SBNode* earlier = node1->getNodeID() < node2->getNodeID() ? node1 : node2;
+    const SBNode* later = earlier == node1 ? node2 : node1;
+
+    unsigned distance = later->getNodeID() - earlier->getNodeID();
+    unsigned delay = getDepDelay(earlier);
+    unsigned stall = (delay > distance ? delay - distance : 0) + 1;
+
+    constexpr unsigned loopFactorForTokenReuse = 5;
+    constexpr unsigned maxWeightedNestLevel = 4;
+    unsigned nestLevel = std::min<unsigned>(BBVector[later->getBBID()]->getBB()->getNestLevel(), maxWeightedNestLevel);
+    for (unsigned i = 0; i < nestLevel; i++)
+    {
+        stall *= loopFactorForTokenReuse;
+    }
+    return stall;
+}
+
+/* Graph coloring algorithm for the token allocation.
+ * Two token nodes interfere if their live intervals overlap. Nodes are colored
+ * from the deepest loop nest level out, so that the sends in hot loops get the
+ * free tokens first. When no free token is left, the token with the least
+ * loop weighted reuse cost over the interfering nodes is taken.
+ */
+void SWSB::tokenAllocationGraphColoring()
+{
+    buildLiveIntervals();
+
+    tokenProfile.setTokenInstructionCount((int)SBSendNodes.size());
+    uint32_t AWTokenReuseCount = 0;
+    uint32_t ARTokenReuseCount = 0;
+    uint32_t AATokenReuseCount = 0;
+    uint32_t mathInstCount = 0;
+    uint32_t forcedSyncCount = 0;
+
+    SBNODE_VECT tokenNodes;
+    for (SBNode* node : SBSendNodes)
+    {
+        G4_INST* inst = node->getLastInstruction();
+        if (inst->isEOT())
+        {
+            continue;
+        }
+
+        if (fg.builder->getOptions()->getOption(vISA_EnableSendTokenReduction) && node->succs.size() == 0)
+        {
+            continue;
+        }
+
+        //If there is no instruction depends on a DPAS instruction, no SBID
+        if (inst->isDpas() && node->succs.size() == 0 &&
+            fg.builder->getOptions()->getOption(vISA_EnableDPASTokenReduction))
+        {
+            continue;
+        }
+
+        if (inst->isMathPipeInst())
+        {
+            mathInstCount++;
+        }
+        tokenNodes.push_back(node);
+    }
+
+    //Build the interference graph by sweeping the intervals in the order of start ID
+    const unsigned numNodes = (unsigned)tokenNodes.size();
+    std::vector<unsigned> order(numNodes);
+    for (unsigned i = 0; i < numNodes; i++)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+        return tokenNodes[a]->getLiveStartID() < tokenNodes[b]->getLiveStartID();
+    });
+
+    std::vector<std::vector<unsigned>> intf(numNodes);
+    std::vector<unsigned> active;
+    for (unsigned i : order)
+    {
+        unsigned startID = tokenNodes[i]->getLiveStartID();
+        active.erase(std::remove_if(active.begin(), active.end(), [&](unsigned a) {
+            return tokenNodes[a]->getLiveEndID() <= startID; }), active.end());
+        for (unsigned a : active)
+        {
+            intf[a].push_back(i);
+            intf[i].push_back(a);
+        }
+        active.push_back(i);
+    }
+
+    //Color the nodes in hot loops first, then the most constrained ones
+    std::vector<unsigned> nestLevels(numNodes);
+    for (unsigned i = 0; i < numNodes; i++)
+    {
+        nestLevels[i] = BBVector[tokenNodes[i]->getBBID()]->getBB()->getNestLevel();
+    }
+    std::stable_sort(order.begin(), order.end(), [&](unsigned a, unsigned b) {
+        if (nestLevels[a] != nestLevels[b])
+        {
+            return nestLevels[a] > nestLevels[b];
+        }
+        return intf[a].size() > intf[b].size();
+    });
+
+    std::vector<unsigned short> colors(numNodes, (unsigned short)UNKNOWN_TOKEN);
+    std::vector<uint64_t> tokenCost(totalTokenNum);
+    for (unsigned i : order)
+    {
+        SBNode* node = tokenNodes[i];
+        std::fill(tokenCost.begin(), tokenCost.end(), 0);
+        for (unsigned n : intf[i])
+        {
+            if (colors[n] != (unsigned short)UNKNOWN_TOKEN)
+            {
+                tokenCost[colors[n]] += getTokenReuseCost(node, tokenNodes[n]);
+            }
+        }
+
+        unsigned short token = 0;
+        for (unsigned short t = 1; t < totalTokenNum; t++)
+        {
+            if (tokenCost[t] < tokenCost[token])
+            {
+                token = t;
+            }
+        }
+
+        if (tokenCost[token] != 0)
+        {
+            //Forced reuse, the node with the largest stall is the one being reused
+            SBNode* oldNode = nullptr;
+            unsigned oldCost = 0;
+            for (unsigned n : intf[i])
+            {
+                if (colors[n] == token && getTokenReuseCost(node, tokenNodes[n]) > oldCost)
+                {
+                    oldNode = tokenNodes[n];
+                    oldCost = getTokenReuseCost(node, oldNode);
+                }
+            }
+            forcedSyncCount++;
+            tokenReuseCount++;
+            if (oldNode->hasAWDep())
+            {
+                AWTokenReuseCount++;
+            }
+            else if (oldNode->hasARDep())
+            {
+                ARTokenReuseCount++;
+            }
+            else
+            {
+                AATokenReuseCount++;
+            }
+            node->setTokenReuseNode(oldNode);
+        }
+
+        colors[i] = token;
+        sameTokenNodes[token].push_back(node);
+        node->getLastInstruction()->setSetToken(token);
+        allTokenNodesMap[token].set(node->sendID, true);
+    }
+
+#ifdef DEBUG_VERBOSE_ON
+    dumpTokeAssignResult();
+#endif
+
+    if (fg.builder->getOptions()->getOption(vISA_SWSBDepReduction))
+    {
+        for (size_t i = 0; i < BBVector.size(); i++)
+        {
+            BBVector[i]->getLiveOutToken(unsigned(SBSendNodes.size()), &SBNodes);
+        }
+        SWSBGlobalTokenAnalysis();
+
+        unsigned prunedEdgeNum = 0;
+        unsigned prunedGlobalEdgeNum = 0;
+        unsigned prunedDiffBBEdgeNum = 0;
+        unsigned prunedDiffBBSameTokenEdgeNum = 0;
+        tokenEdgePrune(prunedEdgeNum, prunedGlobalEdgeNum, prunedDiffBBEdgeNum, prunedDiffBBSameTokenEdgeNum);
+        tokenProfile.setPrunedEdgeNum(prunedEdgeNum);
+        tokenProfile.setPrunedGlobalEdgeNum(prunedGlobalEdgeNum);
+        tokenProfile.setPrunedDiffBBEdgeNum(prunedDiffBBEdgeNum);
+        tokenProfile.setPrunedDiffBBSameTokenEdgeNum(prunedDiffBBSameTokenEdgeNum);
+    }
+
+    assignDepTokens();
+
+    tokenProfile.setAWTokenReuseCount(AWTokenReuseCount);
+    tokenProfile.setARTokenReuseCount(ARTokenReuseCount);
+    tokenProfile.setAATokenReuseCount(AATokenReuseCount);
+    tokenProfile.setMathInstCount(mathInstCount);
+    tokenProfile.setForcedSyncCount(forcedSyncCount);
+}
+
 unsigned short SWSB::reuseTokenSelectionGlobal(SBNode* node, G4_BB* bb, SBNode*& candidateNode, bool& fromSibling)
 {
     SBBitSets temp_live_in(globalSendNum);
@@ -4560,13 +4814,14 @@ void G4_BB_SB::getGRFBucketDescrs(SBNode* node, std::vector<SBBucketDescr>& BDve
 // 2. instruction killed.
 // 3. source operands killed.
 // 4. operand killed.
+// Only the live buckets are scanned.
 // FIXME:
-// 1. scanning all buckets is time cost.
-// 2. some time, only 1 way checking is required.
-// 3. the function is called for every instruction, it's compilation time waste.
+// 1. some time, only 1 way checking is required.
+// 2. the function is called for every instruction, it's compilation time waste.
 void G4_BB_SB::clearKilledBucketNodeXeLP(LiveGRFBuckets* LB, int ALUID)
 {
-    for (int curBucket = 0; curBucket < LB->getNumOfBuckets(); curBucket++)
+    for (int curBucket = LB->getNextLiveBucket(0); curBucket < LB->getNumOfBuckets();
+        curBucket = LB->getNextLiveBucket(curBucket + 1))
     {
         for (LiveGRFBuckets::BN_iterator it = LB->begin(curBucket); it != LB->end(curBucket);)
         {
@@ -4591,7 +4846,8 @@ void G4_BB_SB::clearKilledBucketNodeXeLP(LiveGRFBuckets* LB, int ALUID)
 
 void G4_BB_SB::clearKilledBucketNodeXeHP(LiveGRFBuckets* LB, int integerID, int floatID, int longID, int mathID)
 {
-    for (int curBucket = 0; curBucket < LB->getNumOfBuckets(); curBucket++)
+    for (int curBucket = LB->getNextLiveBucket(0); curBucket < LB->getNumOfBuckets();
+        curBucket = LB->getNextLiveBucket(curBucket + 1))
     {
         for (LiveGRFBuckets::BN_iterator it = LB->begin(curBucket); it != LB->end(curBucket);)
         {
@@ -5627,7 +5883,8 @@ void G4_BB_SB::SBDDD(G4_BB* bb,
 
     //Check the live out token nodes after the scan of current BB.
     //Record the nodes and the buckets for global analysis.
-    for (int curBucket = 0; curBucket < LB->getNumOfBuckets(); curBucket++)
+    for (int curBucket = LB->getNextLiveBucket(0); curBucket < LB->getNumOfBuckets();
+        curBucket = LB->getNextLiveBucket(curBucket + 1))
     {
         for (auto it = LB->begin(curBucket); it != LB->end(curBucket);)
         {
@@ -6035,6 +6292,8 @@ void G4_BB_SB::getLiveBucketsFromFootprint(const SBFootprint* firstFootprint, SB
 */
 void SWSB::addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR* globalSendOpndList, SBNODE_VECT* SBNodes, PointsToAnalysis& p, bool afterWrite)
 {
+    // reused across BBs; clearing only touches the buckets left live
+    LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), kernel);
     for (size_t i = 0; i < BBVector.size(); i++)
     {
         //Get global send operands killed by current BB
@@ -6050,7 +6309,7 @@ void SWSB::addGlobalDependence(unsigned globalSendNum, SBBUCKET_VECTOR* globalSe
         //   For token dependence, thereis only implicit RAR and WAR dependencies.
         //   the order of the operands are scanned is not an issue anymore.
         //   i.e explicit RAW and WAW can cover all other dependences.
-        LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), BBVector[i]->getBB()->getKernel());
+        send_use_kills.clear();
         for (SBBucketNode* sBucketNode : *globalSendOpndList)
         {
             SBNode* sNode = sBucketNode->node;
@@ -6325,6 +6584,8 @@ void SWSB::addReachingUseSet(SBNode* node, SBNode* use)
 
 void SWSB::addGlobalDependenceWithReachingDef(unsigned globalSendNum, SBBUCKET_VECTOR* globalSendOpndList, SBNODE_VECT* SBNodes, PointsToAnalysis& p, bool afterWrite)
 {
+    // reused across BBs; clearing only touches the buckets left live
+    LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), kernel);
     for (size_t i = 0; i < BBVector.size(); i++)
     {
         //Get global send operands killed by current BB
@@ -6349,7 +6610,7 @@ void SWSB::addGlobalDependenceWithReachingDef(unsigned globalSendNum, SBBUCKET_V
         //   For token dependence, thereis only implicit RAR and WAR dependencies.
         //   the order of the operands are scanned is not an issue anymore.
         //   i.e explicit RAW and WAW can cover all other dependences.
-        LiveGRFBuckets send_use_kills(mem, kernel.getNumRegTotal(), BBVector[i]->getBB()->getKernel());
+        send_use_kills.clear();
         for (size_t j = 0; j < globalSendOpndList->size(); j++)
         {
             SBBucketNode* sBucketNode = (*globalSendOpndList)[j];
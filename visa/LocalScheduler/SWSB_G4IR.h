@@ -980,38 +980,70 @@ namespace vISA
     // This class hides the internals of dependence tracking using buckets
     class LiveGRFBuckets
     {
-        std::vector<SBBUCKET_VECTOR *> nodeBucketsArray;
+        std::vector<SBBUCKET_VECTOR> nodeBucketsArray;
+        // one bit per bucket, set if the bucket is not empty, so that scans
+        // over all buckets only visit the live ones
+        std::vector<uint64_t> nonEmptyBuckets;
         G4_Kernel &k;
-        vISA::Mem_Manager &mem;
         const int numOfBuckets;
 
-    public:
-        LiveGRFBuckets(vISA::Mem_Manager& m, int TOTAL_BUCKETS, G4_Kernel& k)
-            : nodeBucketsArray(TOTAL_BUCKETS), k(k), mem(m), numOfBuckets(TOTAL_BUCKETS)
+        void setNonEmpty(int bucket)
+        {
+            nonEmptyBuckets[bucket / 64] |= 1ULL << (bucket % 64);
+        }
+
+        void updateEmpty(int bucket)
         {
-            // Initialize a vector for each bucket
-            for (auto& bucket : nodeBucketsArray)
+            if (nodeBucketsArray[bucket].empty())
             {
-                void* allocedMem = mem.alloc(sizeof(SBBUCKET_VECTOR));
-                bucket = new (allocedMem) SBBUCKET_VECTOR();
+                nonEmptyBuckets[bucket / 64] &= ~(1ULL << (bucket % 64));
             }
         }
 
-        ~LiveGRFBuckets()
+    public:
+        LiveGRFBuckets(vISA::Mem_Manager&, int TOTAL_BUCKETS, G4_Kernel& k)
+            : nodeBucketsArray(TOTAL_BUCKETS), nonEmptyBuckets((TOTAL_BUCKETS + 63) / 64, 0),
+              k(k), numOfBuckets(TOTAL_BUCKETS)
+        {
+        }
+
+        int getNumOfBuckets() const
+        {
+            return numOfBuckets;
+        }
+
+        // Returns the first non-empty bucket not less than bucket, or
+        // getNumOfBuckets() if there is none.
+        int getNextLiveBucket(int bucket) const
         {
-            for (int i = 0; i < numOfBuckets; i++)
+            for (int word = bucket / 64, numWords = (int)nonEmptyBuckets.size(); word < numWords; word++)
             {
-                SBBUCKET_VECTOR *bucketVec = nodeBucketsArray[i];
-                if (bucketVec)
+                uint64_t bits = nonEmptyBuckets[word];
+                if (word == bucket / 64)
+                {
+                    bits &= ~0ULL << (bucket % 64);
+                }
+                if (bits)
                 {
-                    bucketVec->~SBBUCKET_VECTOR();
+                    int bit = 0;
+                    while (!(bits & (1ULL << bit)))
+                    {
+                        bit++;
+                    }
+                    return word * 64 + bit;
                 }
             }
+            return numOfBuckets;
         }
 
-        int getNumOfBuckets() const
+        // Empty all buckets, touching only the live ones.
+        void clear()
         {
-            return numOfBuckets;
+            for (int bucket = getNextLiveBucket(0); bucket < numOfBuckets; bucket = getNextLiveBucket(bucket + 1))
+            {
+                nodeBucketsArray[bucket].clear();
+            }
+            std::fill(nonEmptyBuckets.begin(), nonEmptyBuckets.end(), 0);
         }
 
         //The iterator which is used to scan the node vector of each bucket
@@ -1041,25 +1073,27 @@ namespace vISA
 
             SBBucketNode *operator*()
             {
-                assert(node_it != LB->nodeBucketsArray[bucket]->end());
+                assert(node_it != LB->nodeBucketsArray[bucket].end());
                 return *node_it;
             }
         };
 
         BN_iterator begin(int bucket) const
         {
-            return BN_iterator(this, nodeBucketsArray[bucket]->begin(), bucket);
+            auto& vec = const_cast<SBBUCKET_VECTOR&>(nodeBucketsArray[bucket]);
+            return BN_iterator(this, vec.begin(), bucket);
         }
 
         BN_iterator end(int bucket) const
         {
-            return BN_iterator(this, nodeBucketsArray[bucket]->end(), bucket);
+            auto& vec = const_cast<SBBUCKET_VECTOR&>(nodeBucketsArray[bucket]);
+            return BN_iterator(this, vec.end(), bucket);
         }
 
         //Scan the node vector of the bucket, and kill the bucket node with the specified node and operand
         void bucketKill(int bucket, SBNode *node, Gen4_Operand_Number opnd)
         {
-            SBBUCKET_VECTOR &vec = *nodeBucketsArray[bucket];
+            SBBUCKET_VECTOR &vec = nodeBucketsArray[bucket];
             for (unsigned int i = 0; i < vec.size(); i++)
             {
                 SBBucketNode *bNode = vec[i];
@@ -1068,7 +1102,10 @@ namespace vISA
                 if (bNode->node == node &&
                     bNode->opndNum == opnd)
                 {
-                    vec.erase(vec.begin() + i);
+                    // order within a bucket doesn't matter, see killSingleOperand
+                    vec[i] = vec.back();
+                    vec.pop_back();
+                    updateEmpty(bucket);
                     break;
                 }
             }
@@ -1076,7 +1113,7 @@ namespace vISA
         //Kill the bucket node specified by bn_it
         void killSingleOperand(BN_iterator &bn_it)
         {
-            SBBUCKET_VECTOR &vec = *nodeBucketsArray[bn_it.bucket];
+            SBBUCKET_VECTOR &vec = nodeBucketsArray[bn_it.bucket];
             SBBUCKET_VECTOR_ITER &node_it = bn_it.node_it;
 
             //Kill current node
@@ -1093,12 +1130,13 @@ namespace vISA
                 *node_it = vec.back();
                 vec.pop_back();
             }
+            updateEmpty(bn_it.bucket);
         }
 
         //Kill the bucket node specified by bn_it, also kill the same node in other buckets
         void killOperand(BN_iterator &bn_it)
         {
-            SBBUCKET_VECTOR &vec = *nodeBucketsArray[bn_it.bucket];
+            SBBUCKET_VECTOR &vec = nodeBucketsArray[bn_it.bucket];
             SBBUCKET_VECTOR_ITER &node_it = bn_it.node_it;
             SBBucketNode *bucketNode = *node_it; //Get the node before it is destroied
             int aregOffset = k.getNumRegTotal();
@@ -1117,6 +1155,7 @@ namespace vISA
                 *node_it = vec.back();
                 vec.pop_back();
             }
+            updateEmpty(bn_it.bucket);
 
             //Kill the same node in other bucket.
             for (const SBFootprint *footprint = bucketNode->node->getFirstFootprint(bucketNode->opndNum); footprint; footprint = footprint->next)
@@ -1133,7 +1172,7 @@ namespace vISA
                 {
                     for (unsigned int i = startBucket; (i < endBucket + 1) && (i < nodeBucketsArray.size()); i++)
                     {
-                        if (i == bn_it.bucket)
+                        if (i == bn_it.bucket || !(nonEmptyBuckets[i / 64] & (1ULL << (i % 64))))
                         {
                             continue;
                         }
@@ -1146,11 +1185,11 @@ namespace vISA
         //Add a node into bucket
         void add(SBBucketNode *bucketNode, int bucket)
         {
-            assert(nodeBucketsArray[bucket] != nullptr);
-            SBBUCKET_VECTOR& nodeVec = *(nodeBucketsArray[bucket]);
+            SBBUCKET_VECTOR& nodeVec = nodeBucketsArray[bucket];
             if (std::find(nodeVec.begin(), nodeVec.end(), bucketNode) == nodeVec.end())
             {
                 nodeVec.push_back(bucketNode);
+                setNonEmpty(bucket);
             }
         }
 
@@ -1160,10 +1199,10 @@ namespace vISA
         {
             for (int curBucket = 0; curBucket < numOfBuckets; curBucket++)
             {
-                if (nodeBucketsArray[curBucket]->size())
+                if (nodeBucketsArray[curBucket].size())
                 {
                     std::cerr << " GRF" << curBucket << ":";
-                    for (SBBucketNode *liveBN : *nodeBucketsArray[curBucket])
+                    for (SBBucketNode *liveBN : nodeBucketsArray[curBucket])
                     {
                         std::cerr << " " << liveBN->node->getNodeID() << "(" << liveBN->opndNum << ")";
                     }
@@ -1404,6 +1443,7 @@ namespace vISA
         uint32_t prunedGlobalEdgeNum = 0;
         uint32_t prunedDiffBBEdgeNum = 0;
         uint32_t prunedDiffBBSameTokenEdgeNum = 0;
+        uint32_t forcedSyncCount = 0;
     public:
         SWSB_TOKEN_PROFILE() {
             ;
@@ -1461,6 +1501,10 @@ namespace vISA
 
         void setPrunedDiffBBSameTokenEdgeNum(int num) { prunedDiffBBSameTokenEdgeNum = num; }
         uint32_t getPrunedDiffBBSameTokenEdgeNum() const { return prunedDiffBBSameTokenEdgeNum; }
+
+        // Token assignments that had to share a token with an overlapping live range
+        void setForcedSyncCount(int count) { forcedSyncCount = count; }
+        uint32_t getForcedSyncCount() const { return forcedSyncCount; }
     };
 
     class SWSB {
@@ -1484,6 +1528,7 @@ namespace vISA
         const unsigned tokenAfterWriteSendSlmCycle;
         const unsigned tokenAfterWriteSendMemoryCycle;
         const unsigned tokenAfterWriteSendSamplerCycle;
+        const unsigned tokenAfterWriteDPASCycle;
 
         //For profiling
         uint32_t syncInstCount = 0;
@@ -1528,6 +1573,8 @@ namespace vISA
 
         //Token allocation
         void tokenAllocation();
+        void tokenAllocationGraphColoring();
+        unsigned getTokenReuseCost(const SBNode* node1, const SBNode* node2) const;
         void buildLiveIntervals();
         void expireIntervals(unsigned startID);
         void addToLiveList(SBNode *node);
@@ -1606,14 +1653,20 @@ namespace vISA
         SWSB(G4_Kernel &k, vISA::Mem_Manager& m)
             : kernel(k), fg(k.fg), mem(m),
             totalTokenNum(k.fg.builder->kernel.getNumSWSBTokens()),
-            tokenAfterWriteMathCycle(k.fg.builder->isXeLP() ? 20u : 17u),
-            tokenAfterWriteSendSlmCycle(k.fg.builder->isXeLP() ? 33u : 25u), //unlocaled 25
-            tokenAfterWriteSendMemoryCycle(k.fg.builder->getOptions()->getOption(vISA_USEL3HIT)
+            tokenAfterWriteMathCycle(LatencyProfile::getValue(k.fg.builder, LatencyProfile::TOKEN_MATH,
+                k.fg.builder->isXeLP() ? 20u : 17u)),
+            tokenAfterWriteSendSlmCycle(LatencyProfile::getValue(k.fg.builder, LatencyProfile::TOKEN_SLM,
+                k.fg.builder->isXeLP() ? 33u : 25u)), //unlocaled 25
+            tokenAfterWriteSendMemoryCycle(LatencyProfile::getValue(k.fg.builder, LatencyProfile::TOKEN_MEMORY,
+                k.fg.builder->getOptions()->getOption(vISA_USEL3HIT)
                 ? (k.fg.builder->isXeLP() ? 106u : 150u) // TOKEN_AFTER_WRITE_SEND_L3_MEMORY_CYCLE
-                : (k.fg.builder->isXeLP() ? 65u : 50u)), // TOKEN_AFTER_WRITE_SEND_L1_MEMORY_CYCLE
-            tokenAfterWriteSendSamplerCycle(k.fg.builder->getOptions()->getOption(vISA_USEL3HIT)
+                : (k.fg.builder->isXeLP() ? 65u : 50u))), // TOKEN_AFTER_WRITE_SEND_L1_MEMORY_CYCLE
+            tokenAfterWriteSendSamplerCycle(LatencyProfile::getValue(k.fg.builder, LatencyProfile::TOKEN_SAMPLER,
+                k.fg.builder->getOptions()->getOption(vISA_USEL3HIT)
                 ? (k.fg.builder->isXeLP() ? 175u : 210u) // TOKEN_AFTER_WRITE_SEND_L3_SAMPLER_CYCLE
-                : 60u)                                   // TOKEN_AFTER_WRITE_SEND_L1_SAMPLER_CYCLE
+                : 60u)),                                 // TOKEN_AFTER_WRITE_SEND_L1_SAMPLER_CYCLE
+            tokenAfterWriteDPASCycle(LatencyProfile::getValue(k.fg.builder, LatencyProfile::TOKEN_DPAS,
+                TOKEN_AFTER_WRITE_DPAS_CYCLE))
         {
             indexes.instIndex = 0;
             indexes.ALUIndex = 0;
@@ -447,17 +447,57 @@ bool Dominator::dominates(G4_BB* bb1, G4_BB* bb2)
     return false;
 }
 
+// Everything a CFG analysis may depend on: the layout order, ids and
+// edges of the BBs, and the subroutine entries.
+static void getCFGShape(FlowGraph& fg, std::vector<const void*>& shape)
+{
+    shape.clear();
+    shape.push_back(fg.getEntryBB());
+    shape.push_back(reinterpret_cast<const void*>((uintptr_t)fg.getNumFuncs()));
+    for (auto fn : fg.funcInfoTable)
+    {
+        shape.push_back(fn->getInitBB());
+    }
+    for (G4_BB* bb : fg)
+    {
+        shape.push_back(bb);
+        shape.push_back(reinterpret_cast<const void*>((uintptr_t)bb->getId()));
+        shape.push_back(reinterpret_cast<const void*>((uintptr_t)bb->Succs.size()));
+        shape.insert(shape.end(), bb->Succs.begin(), bb->Succs.end());
+        shape.push_back(reinterpret_cast<const void*>((uintptr_t)bb->Preds.size()));
+        shape.insert(shape.end(), bb->Preds.begin(), bb->Preds.end());
+    }
+}
+
 void Analysis::recomputeIfStale()
 {
     if (!isStale() || inProgress)
         return;
 
+    std::vector<const void*> shape;
+    FlowGraph* cfg = getCFG();
+    if (cfg)
+    {
+        getCFGShape(*cfg, shape);
+        if (!cfgShape.empty() && shape == cfgShape)
+        {
+            // the CFG is the same as when the result was computed
+            setValid();
+            return;
+        }
+    }
+
     inProgress = true;
     reset();
     run();
     inProgress = false;
+    cfgShape = std::move(shape);
 }
 
+FlowGraph* Dominator::getCFG() const { return &kernel.fg; }
+FlowGraph* ImmDominator::getCFG() const { return &kernel.fg; }
+FlowGraph* PostDom::getCFG() const { return &kernel.fg; }
+
 PostDom::PostDom(G4_Kernel& k) : kernel(k)
 {
 }
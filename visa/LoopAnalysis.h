@@ -34,10 +34,21 @@ namespace vISA
         virtual void reset() = 0;
         virtual void run() = 0;
         virtual void dump(std::ostream& os = std::cerr) = 0;
+
+    protected:
+        // An analysis whose result depends only on the CFG returns it here.
+        // Once such an analysis is marked stale, it is re-run only if the
+        // CFG differs from the one it was last computed on, so spurious
+        // invalidations (ids reassigned to the same values, an edge removed
+        // and added back, etc.) do not cost a recomputation.
+        virtual FlowGraph* getCFG() const { return nullptr; }
+
     private:
         bool stale = true;
         // flag to avoid re-triggering of analysis run when run is already in progress
         bool inProgress = false;
+        // the CFG the current result was computed on (see getCFG)
+        std::vector<const void*> cfgShape;
     };
 
     class Dominator : public Analysis
@@ -62,6 +73,7 @@ namespace vISA
 
         void runDOM();
 
+        FlowGraph* getCFG() const override;
         void reset() override;
         void run() override;
         void dump(std::ostream& os = std::cerr) override;
@@ -94,6 +106,7 @@ namespace vISA
         void runIDOM();
         void updateImmDom();
 
+        FlowGraph* getCFG() const override;
         void reset() override;
         void run() override;
         void dump(std::ostream& os = std::cerr) override;
@@ -117,6 +130,7 @@ namespace vISA
 
         void updateImmPostDom();
 
+        FlowGraph* getCFG() const override;
         void reset() override;
         void run() override;
         void dump(std::ostream& os = std::cerr) override { dumpImmDom(os); }
@@ -180,6 +194,7 @@ namespace vISA
         bool contains(const G4_BB*);
 
         unsigned int getBBSize() { return BBs.size(); }
+        const std::vector<G4_BB*>& getBBs() const { return BBs; }
 
         G4_BB* getHeader() { return be.second; }
 
@@ -215,6 +230,7 @@ namespace vISA
         G4_Kernel& kernel;
         FlowGraph& fg;
 
+        FlowGraph* getCFG() const override { return &fg; }
         void reset() override;
         void run() override;
         void dump(std::ostream& os = std::cerr) override;
@@ -20,3 +20,39 @@ Mem_Manager::Mem_Manager(size_t defaultArenaSize)
 Mem_Manager::~Mem_Manager()
 {
 }
+
+void* Mem_Manager::allocSized(size_t size)
+{
+    if (size != 0 && size <= maxSizeClassBytes)
+    {
+        void*& head = _freeLists[getSizeClass(size)];
+        if (head)
+        {
+            void* block = head;
+            head = *static_cast<void**>(block);
+            return block;
+        }
+    }
+    return alloc(size);
+}
+
+void Mem_Manager::freeSized(void* ptr, size_t size)
+{
+    // the link is stored in the block itself, which is at least
+    // defaultAlign bytes large
+    if (ptr && size != 0 && size <= maxSizeClassBytes)
+    {
+        void*& head = _freeLists[getSizeClass(size)];
+        *static_cast<void**>(ptr) = head;
+        head = ptr;
+    }
+}
+
+void Mem_Manager::resetToMark(const ArenaMark& mark)
+{
+    for (auto& head : _freeLists)
+    {
+        head = nullptr;
+    }
+    _arenaManager.ResetToMark(mark);
+}
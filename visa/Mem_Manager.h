@@ -32,9 +32,49 @@ namespace vISA
             return _arenaManager.AllocDataSpace(size, static_cast<size_t>(al));
         }
 
+        // Small objects that are created and destroyed repeatedly may be
+        // recycled through per size class free lists: allocSized() reuses a
+        // block given back by freeSized() with the same size if there is
+        // one. Blocks larger than maxSizeClassBytes are not recycled.
+        void* allocSized(size_t size);
+        void freeSized(void* ptr, size_t size);
+
+        // Release everything allocated after getMark() was called. Any
+        // object allocated since then must no longer be used. The free
+        // lists are dropped as they may point into the released memory.
+        ArenaMark getMark() const { return _arenaManager.GetMark(); }
+
+        // total size of the arenas currently owned by this manager
+        size_t getReservedBytes() const { return _arenaManager._reservedBytes; }
+        void resetToMark(const ArenaMark& mark);
+
     private:
 
+        static const size_t maxSizeClassBytes = 256;
+        static const size_t numSizeClasses = maxSizeClassBytes / ArenaHeader::defaultAlign;
+
+        static size_t getSizeClass(size_t size)
+        {
+            return ArenaHeader::DefaultAlign(size) / ArenaHeader::defaultAlign - 1;
+        }
+
         vISA::ArenaManager _arenaManager;
+        void* _freeLists[numSizeClasses] = {};
+    };
+
+    // Releases the memory allocated from a Mem_Manager during its lifetime,
+    // e.g., for the temporaries of one RA iteration.
+    class ScopedMemMark
+    {
+    public:
+        explicit ScopedMemMark(Mem_Manager& m) : mem(m), mark(m.getMark()) {}
+        ~ScopedMemMark() { mem.resetToMark(mark); }
+        ScopedMemMark(const ScopedMemMark&) = delete;
+        ScopedMemMark& operator=(const ScopedMemMark&) = delete;
+
+    private:
+        Mem_Manager& mem;
+        const ArenaMark mark;
     };
 }
 #endif
@@ -15,9 +15,11 @@ SPDX-License-Identifier: MIT
 #include "Common_BinaryEncoding.h"
 #include "DebugInfo.h"
 #include "Passes/AccSubstitution.hpp"
+#include "Passes/GVN.hpp"
 #include "Passes/InstCombine.hpp"
 #include "Passes/LVN.hpp"
 #include "Passes/MergeScalars.hpp"
+#include "Passes/PerfModel.hpp"
 #include "Passes/SendFusion.hpp"
 
 #include <algorithm>
@@ -56,6 +58,12 @@ void Optimizer::LVN()
         numInstsRemoved += ::LVN::removeRedundantSamplerMovs(kernel, bb);
     }
 
+    // catch the redundancies across blocks that the local pass cannot see
+    if (builder.getOption(vISA_GVN))
+    {
+        numInstsRemoved += doGVN(kernel, p);
+    }
+
     if (kernel.getOption(vISA_OptReport))
     {
         std::ofstream optreport;
@@ -147,6 +155,73 @@ void Optimizer::insertFallThroughJump()
     }
 }
 
+//
+// Move early exits out of the way of hot code.
+//
+// An exit block (one ending in EOT) that is only entered by jumps can be
+// placed anywhere in the layout.  If it sits in front of a loop it splits the
+// hot code in the I-cache, so move it to the end of the kernel.
+// This is only done for kernels whose control flow is made of direct jmpi's;
+// SIMD CF and subroutines depend on the block order.
+// A jump in the previous block that becomes a jump to its fall-through is
+// removed by insertFallThroughJump.
+//
+void Optimizer::moveColdExitBlocks()
+{
+    if (!builder.getIsKernel() || fg.size() < 3)
+    {
+        return;
+    }
+    for (auto bb : fg)
+    {
+        for (auto inst : *bb)
+        {
+            if (inst->isFlowControl() &&
+                (inst->opcode() != G4_jmpi || !inst->getSrc(0)->isLabel()))
+            {
+                return;
+            }
+        }
+    }
+
+    // whether some block after each position is in a loop
+    std::vector<G4_BB*> layout(fg.begin(), fg.end());
+    std::vector<bool> loopFollows(layout.size(), false);
+    for (size_t i = layout.size() - 1; i > 0; i--)
+    {
+        loopFollows[i - 1] = loopFollows[i] || layout[i]->getNestLevel() > 0;
+    }
+
+    auto canFallThrough = [](G4_BB* bb)
+    {
+        if (bb->empty())
+        {
+            return true;
+        }
+        G4_INST* last = bb->back();
+        bool uncondJmp = last->opcode() == G4_jmpi && !last->getPredicate();
+        return !uncondJmp && !bb->isLastInstEOT();
+    };
+
+    std::vector<G4_BB*> coldBBs;
+    for (size_t i = 1; i + 1 < layout.size(); i++)
+    {
+        G4_BB* bb = layout[i];
+        if (loopFollows[i] && bb->getNestLevel() == 0 &&
+            bb->isLastInstEOT() && !bb->empty() && bb->front()->isLabel() &&
+            !canFallThrough(layout[i - 1]))
+        {
+            coldBBs.push_back(bb);
+        }
+    }
+
+    for (G4_BB* bb : coldBBs)
+    {
+        fg.erase(std::find(fg.begin(), fg.end(), bb));
+        fg.push_back(bb);
+    }
+}
+
 void Optimizer::regAlloc()
 {
 
@@ -323,6 +398,21 @@ void Optimizer::addSWSBInfo()
     return;
 }
 
+void Optimizer::estimatePerformance()
+{
+    uint64_t cycles = vISA::estimatePerformance(kernel, bankConflictInsts);
+
+    if (builder.getOption(vISA_OptReport))
+    {
+        std::ofstream optreport;
+        getOptReportStream(optreport, builder.getOptions());
+        optreport << std::endl << "===== Static performance model =====" << std::endl;
+        optreport << "Estimated " << cycles << " cycles for kernel: " << kernel.getName() << std::endl;
+        optreport << kernel.getPerfModelReport() << std::endl;
+        closeOptReportStream(optreport);
+    }
+}
+
 void Optimizer::countBankConflicts()
 {
     std::list<G4_INST*> conflicts;
@@ -345,73 +435,41 @@ void Optimizer::countBankConflicts()
             if (!src0->isSrcRegRegion() || !src1->isSrcRegRegion() || !src2->isSrcRegRegion())
                 continue;
 
-            if (!src0->asSrcRegRegion()->getBase()->asRegVar()->getPhyReg()->isGreg() ||
-                !src1->asSrcRegRegion()->getBase()->asRegVar()->getPhyReg()->isGreg() ||
-                !src1->asSrcRegRegion()->getBase()->asRegVar()->getPhyReg()->isGreg())
-                continue;
-
-            // We have a 3 src instruction with each src operand a GRF register region
-            unsigned int src0grf = 0, src1grf = 0, src2grf = 0;
-
-            src0grf = src0->getBase()->asRegVar()->getPhyReg()->asGreg()->getRegNum() +
-                src0->asSrcRegRegion()->getRegOff();
-            src1grf = src1->getBase()->asRegVar()->getPhyReg()->asGreg()->getRegNum() +
-                src1->asSrcRegRegion()->getRegOff();
-            src2grf = src2->getBase()->asRegVar()->getPhyReg()->asGreg()->getRegNum() +
-                src2->asSrcRegRegion()->getRegOff();
-
-            bool isConflict = false;
-
-            unsigned int src0partition = 0, src1partition = 0, src2partition = 0;
-
-            if (src0grf < 64)
-            {
-                src0partition = 1;
-                if (src0grf % 2 == 0)
-                    src0partition = 0;
-            }
-            else
-            {
-                src0partition = 3;
-                if (src0grf % 2 == 0)
-                    src0partition = 2;
-            }
-
-            if (src1grf < 64)
-            {
-                src1partition = 1;
-                if (src1grf % 2 == 0)
-                    src1partition = 0;
-            }
-            else
-            {
-                src1partition = 3;
-                if (src1grf % 2 == 0)
-                    src1partition = 2;
-            }
+            auto getGRF = [](G4_Operand* opnd) -> int {
+                G4_VarBase* base = opnd->getBase();
+                if (!base || !base->isRegVar() || !base->asRegVar()->getPhyReg() ||
+                    !base->asRegVar()->getPhyReg()->isGreg())
+                {
+                    return -1;
+                }
+                return base->asRegVar()->getPhyReg()->asGreg()->getRegNum() +
+                    opnd->asSrcRegRegion()->getRegOff();
+            };
 
-            if (src2grf < 64)
-            {
-                src2partition = 1;
-                if (src2grf % 2 == 0)
-                    src2partition = 0;
-            }
-            else
-            {
-                src2partition = 3;
-                if (src2grf % 2 == 0)
-                    src2partition = 2;
-            }
+            int src0grf = getGRF(src0), src1grf = getGRF(src1), src2grf = getGRF(src2);
+            if (src0grf < 0 || src1grf < 0 || src2grf < 0)
+                continue;
 
-            if (src0partition == src1partition && src1partition == src2partition)
-                isConflict = true;
+            // We have a 3 src instruction with each src operand a GRF register region.
+            // The partition is the bank, plus the half of the register file on
+            // platforms where the bundles are split into low and high halves.
+            auto getPartition = [this](int grf) -> unsigned {
+                unsigned bank = builder.oneGRFBankDivision() ? grf % 2 : (grf / 2) % 2;
+                if (builder.lowHighBundle() && grf >= SECOND_HALF_BANK_START_GRF)
+                {
+                    bank += 2;
+                }
+                return bank;
+            };
 
-            if (curInst->getExecSize() == g4::SIMD16)
-                isConflict = true;
+            unsigned src0partition = getPartition(src0grf);
+            bool isConflict = src0partition == getPartition(src1grf) &&
+                src0partition == getPartition(src2grf);
 
             if (isConflict == true)
             {
                 conflicts.push_back(curInst);
+                bankConflictInsts.insert(curInst);
                 numBankConflicts++;
 
                 auto isGlobal = [](G4_Operand* opnd, FlowGraph& fg)
@@ -442,7 +500,9 @@ void Optimizer::countBankConflicts()
         }
     }
 
-    if (numBankConflicts > 0)
+    builder.getcompilerStats().SetI64("NumBankConflicts", numBankConflicts, kernel.getSimdSize());
+
+    if (numBankConflicts > 0 && builder.getOption(vISA_OptReport))
     {
         std::ofstream optreport;
         getOptReportStream(optreport, builder.getOptions());
@@ -1010,9 +1070,18 @@ void Optimizer::runPass(PassIndex Index)
 
     kernel.dumpToFile("before." + Name);
 
+    ArenaPeakScope passMem;
+
     // Execute pass.
     (this->*(PI.Pass))();
 
+#if COMPILER_STATS_ENABLE
+    if (size_t peakGrowth = passMem.getPeakGrowth())
+    {
+        builder.getcompilerStats().SetI64("PeakMemBytes." + Name, peakGrowth, kernel.getSimdSize());
+    }
+#endif
+
     if (PI.Timer != TimerID::NUM_TIMERS)
         stopTimer(PI.Timer);
 
@@ -1054,9 +1123,10 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(preRA_HWWorkaround,      vISA_EnableAlways,            TimerID::MISC_OPTS);
     INITIALIZE_PASS(regAlloc,                vISA_EnableAlways,            TimerID::TOTAL_RA);
     INITIALIZE_PASS(removeLifetimeOps,       vISA_EnableAlways,            TimerID::MISC_OPTS);
-    INITIALIZE_PASS(countBankConflicts,      vISA_OptReport,               TimerID::MISC_OPTS);
+    INITIALIZE_PASS(countBankConflicts,      vISA_EnableAlways,            TimerID::MISC_OPTS);
     INITIALIZE_PASS(removeRedundMov,         vISA_EnableAlways,            TimerID::MISC_OPTS);
     INITIALIZE_PASS(removeEmptyBlocks,       vISA_EnableAlways,            TimerID::MISC_OPTS);
+    INITIALIZE_PASS(moveColdExitBlocks,      vISA_MoveColdExitBlocks,      TimerID::MISC_OPTS);
     INITIALIZE_PASS(insertFallThroughJump,   vISA_EnableAlways,            TimerID::MISC_OPTS);
     INITIALIZE_PASS(reassignBlockIDs,        vISA_EnableAlways,            TimerID::MISC_OPTS);
     INITIALIZE_PASS(evalAddrExp,             vISA_EnableAlways,            TimerID::MISC_OPTS);
@@ -1095,7 +1165,8 @@ void Optimizer::initOptimizations()
     INITIALIZE_PASS(analyzeMove,             vISA_analyzeMove,             TimerID::MISC_OPTS);
     INITIALIZE_PASS(removeInstrinsics,       vISA_removeInstrinsics,       TimerID::MISC_OPTS);
     INITIALIZE_PASS(expandMulPostSchedule,   vISA_expandMulPostSchedule,   TimerID::MISC_OPTS);
-    INITIALIZE_PASS(addSWSBInfo,             vISA_addSWSBInfo,             TimerID::MISC_OPTS);
+    INITIALIZE_PASS(addSWSBInfo,             vISA_addSWSBInfo,             TimerID::SWSB);
+    INITIALIZE_PASS(estimatePerformance,     vISA_PerfModel,               TimerID::MISC_OPTS);
     INITIALIZE_PASS(expandMadwPostSchedule,  vISA_expandMadwPostSchedule,  TimerID::MISC_OPTS);
 
     // Verify all passes are initialized.
@@ -1592,6 +1663,8 @@ int Optimizer::optimization()
 
     runPass(PI_countBankConflicts);
 
+    runPass(PI_moveColdExitBlocks);
+
     //
     // if a fall-through BB does not immediately follow its predecessor
     // in the code layout, then insert a jump-to-fall-through in the predecessor
@@ -1627,6 +1700,16 @@ int Optimizer::optimization()
 
     runPass(PI_reRAPostSchedule);
 
+    // Without re-RA, report the GRFs left free by the first RA pass (which
+    // include any reserved with -GTPinReserveGRFs) for gtpin.
+    if (kernel.getGTPinData() && builder.getOption(vISA_GetFreeGRFInfo) &&
+        !builder.getOption(vISA_ReRAPostSchedule) &&
+        !kernel.fg.getHasStackCalls() && !kernel.fg.getIsStackCallFunc() &&
+        !builder.getIsPayload())
+    {
+        computeGlobalFreeGRFs(kernel);
+    }
+
     runPass(PI_legalizeType);
 
     runPass(PI_changeMoveType);
@@ -1686,6 +1769,8 @@ int Optimizer::optimization()
     //-----------------------------------------------------------------------------------------------------------------
     runPass(PI_addSWSBInfo);
 
+    runPass(PI_estimatePerformance);
+
     return VISA_SUCCESS;
 }
 
@@ -5466,6 +5551,54 @@ bool Optimizer::foldPseudoAndOr(G4_BB* bb, INST_LIST_ITER& ii)
                 bb->end());
         }
 
+        // Every bindless access reloads the surface state offset into T252,
+        // which would also invalidate the a0.2 values below. Remove the moves
+        // that write the value T252 already holds.
+        G4_Declare* T252 = builder.getBuiltinT252();
+        for (auto bb : fg)
+        {
+            G4_INST* lastT252Def = nullptr;
+            for (auto iter = bb->begin(), iterEnd = bb->end(); iter != iterEnd;)
+            {
+                G4_INST* inst = *iter;
+                G4_DstRegRegion* dst = inst->getDst();
+                bool isT252Mov = inst->opcode() == G4_mov && !inst->getPredicate() &&
+                    !inst->getSaturate() && dst && dst->getTopDcl() == T252 &&
+                    inst->getExecSize() == g4::SIMD1;
+                if (isT252Mov && lastT252Def)
+                {
+                    G4_Operand* src = inst->getSrc(0);
+                    G4_Operand* lastSrc = lastT252Def->getSrc(0);
+                    bool sameValue = src->isImm() && lastSrc->isImm() ?
+                        src->asImm()->getInt() == lastSrc->asImm()->getInt() :
+                        src->compareOperand(lastSrc) == Rel_eq;
+                    if (sameValue && dst->compareOperand(lastT252Def->getDst()) == Rel_eq)
+                    {
+                        inst->transferUse(lastT252Def, true);
+                        inst->removeAllDefs();
+                        iter = bb->erase(iter);
+                        continue;
+                    }
+                }
+
+                if (inst->isCall() || inst->isFCall() || inst->isOptBarrier())
+                {
+                    lastT252Def = nullptr;
+                }
+                else if (isT252Mov)
+                {
+                    lastT252Def = inst;
+                }
+                else if (lastT252Def && dst &&
+                    (dst->isIndirect() || dst->getTopDcl() == T252 ||
+                     dst->compareOperand(lastT252Def->getSrc(0)) != Rel_disjoint))
+                {
+                    lastT252Def = nullptr;
+                }
+                ++iter;
+            }
+        }
+
         for (auto bb : fg)
         {
             InstValues values(4);
@@ -8000,7 +8133,7 @@ bool Optimizer::foldPseudoAndOr(G4_BB* bb, INST_LIST_ITER& ii)
     {
         VarSplitPass* splitPass = kernel.getVarSplitPass();
         // Run explicit variable split pass
-        if (kernel.getOption(vISA_IntrinsicSplit))
+        if (kernel.getOption(vISA_IntrinsicSplit) || kernel.getOption(vISA_SplitSendPayloads))
         {
             splitPass->run();
         }
@@ -8868,6 +9001,7 @@ void Optimizer::mergeScalarInst()
     {
         bundleSizeLimit = 4;
     }
+    int skipLimit = (int)builder.getOptions()->getuInt32Option(vISA_MergeScalarWindow);
 
     Mem_Manager mergeManager(1024);
     // set of declares that have been changed to alias to another declare
@@ -8889,7 +9023,7 @@ void Optimizer::mergeScalarInst()
             ++nextIter;
             if (nextIter != iiEnd && BUNDLE_INFO::isMergeCandidate(inst, builder, !bb->isAllLaneActive()))
             {
-                BUNDLE_INFO* bundle = new (mergeManager) BUNDLE_INFO(bb, ii, bundleSizeLimit);
+                BUNDLE_INFO* bundle = new (mergeManager) BUNDLE_INFO(bb, ii, bundleSizeLimit, skipLimit);
                 bundle->findInstructionToMerge(nextIter, builder);
                 if (bundle->size > 1)
                 {
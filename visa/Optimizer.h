@@ -119,6 +119,7 @@ class Optimizer
     void optimizeLogicOperation();
     void cselPeepHoleOpt();
     void regAlloc();
+    void moveColdExitBlocks();
     void insertFallThroughJump();
     void reverseOffsetProp(
             AddrSubReg_Node addrRegInfo[8],
@@ -156,6 +157,12 @@ class Optimizer
         }
         else
         {
+            if (builder.getOption(vISA_LoopPipelining))
+            {
+                preRA_LoopPipeliner pipeliner(kernel, mem);
+                unsigned numPipelined = pipeliner.run();
+                builder.getcompilerStats().SetI64("NumPipelinedSends", numPipelined, kernel.getSimdSize());
+            }
             preRA_Scheduler Sched(kernel, mem, /*rpe*/ nullptr);
             Sched.run();
         }
@@ -170,6 +177,8 @@ class Optimizer
 
     void addSWSBInfo();
 
+    void estimatePerformance();
+
     void lowerMadSequence();
 
     void LVN();
@@ -216,6 +225,8 @@ private:
 
     void countBankConflicts();
     unsigned int numBankConflicts;
+    // the instructions countBankConflicts found to conflict
+    std::unordered_set<const G4_INST*> bankConflictInsts;
 
     bool chkFwdOutputHazard(INST_LIST_ITER &, INST_LIST_ITER&);
     bool chkFwdOutputHazard(G4_INST*, INST_LIST_ITER);
@@ -323,6 +334,7 @@ public:
         PI_countBankConflicts,
         PI_removeRedundMov,            // always
         PI_removeEmptyBlocks,          // always
+        PI_moveColdExitBlocks,         // always
         PI_insertFallThroughJump,      // always
         PI_reassignBlockIDs,           // always
         PI_evalAddrExp,                // always
@@ -362,6 +374,7 @@ public:
         PI_removeInstrinsics,
         PI_expandMulPostSchedule,
         PI_addSWSBInfo,
+        PI_estimatePerformance,
         PI_expandMadwPostSchedule,
         PI_NUM_PASSES
     };
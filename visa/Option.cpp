@@ -251,6 +251,17 @@ bool Options::parseOptions(int argc, const char* argv[])
         target = VISA_3D;
     }
 
+    if (m_vISAOptions.isArgSetByUser(vISA_GTPinReserveGRFs)) {
+        uint32_t gtpinGRFs = m_vISAOptions.getUint32(vISA_GTPinReserveGRFs);
+        if (gtpinGRFs) {
+            if (gtpinGRFs > m_vISAOptions.getUint32(vISA_ReservedGRFNum)) {
+                m_vISAOptions.setUint32(vISA_ReservedGRFNum, gtpinGRFs);
+                m_vISAOptions.setArgSetByUser(vISA_ReservedGRFNum);
+            }
+            m_vISAOptions.setBool(vISA_GetFreeGRFInfo, true);
+        }
+    }
+
     if (m_vISAOptions.isArgSetByUser(vISA_ReservedGRFNum)) {
         if (m_vISAOptions.getUint32(vISA_ReservedGRFNum)) {
             m_vISAOptions.setBool(vISA_LocalBankConflictReduction, false);
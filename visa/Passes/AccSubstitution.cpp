@@ -1068,6 +1068,196 @@ void AccSubPass::multiAccSub(G4_BB* bb)
 }
 
 // substitute local operands with acc when possible
+// Return true if opnd may access the same register as the accumulation
+// variable accum.
+static bool mayOverlap(G4_Operand* opnd, G4_DstRegRegion* accum)
+{
+    if (!opnd || !(opnd->isSrcRegRegion() || opnd->isDstRegRegion()))
+    {
+        return false;
+    }
+    if ((opnd->isSrcRegRegion() && opnd->asSrcRegRegion()->isIndirect()) ||
+        (opnd->isDstRegRegion() && opnd->asDstRegRegion()->isIndirect()))
+    {
+        return true;
+    }
+    if (accum->isGreg())
+    {
+        return opnd->hasOverlappingGRF(accum);
+    }
+    G4_Declare* dcl = opnd->getTopDcl();
+    return dcl && dcl->getRootDeclare() == accum->getTopDcl()->getRootDeclare();
+}
+
+//
+// For a single block loop with a loop-carried accumulation
+//
+//   PH:   ...
+//   L:    ...
+//         mad (8) V  V  a  b        (or add (8) V V x)
+//         ...
+//         (f0) jmpi/while L
+//   E:    ... = V
+//
+// where V is not otherwise accessed in the loop and nothing else in the loop
+// touches acc, V is kept in acc0 for the whole loop:
+//
+//   PH:   ...
+//         (W) mov (8) acc0  V
+//   L:    mac (8) acc0  a  b        (or add (8) acc0 acc0 x)
+//         (f0) jmpi/while L
+//   E:    (W) mov (8) V  acc0
+//
+// acc0 is live from the end of PH to the start of E. This removes the GRF
+// read and write of V, and the dependence on it, from every iteration.
+//
+bool AccSubPass::loopAccSub(G4_BB* bb)
+{
+    if (bb->empty() || !bb->back()->isFlowControl())
+    {
+        return false;
+    }
+    G4_BB* preheader = nullptr;
+    G4_BB* exitBB = nullptr;
+    bool isSelfLoop = false;
+    for (G4_BB* pred : bb->Preds)
+    {
+        if (pred == bb)
+        {
+            isSelfLoop = true;
+        }
+        else if (preheader && preheader != pred)
+        {
+            return false;
+        }
+        else
+        {
+            preheader = pred;
+        }
+    }
+    for (G4_BB* succ : bb->Succs)
+    {
+        if (succ == bb)
+        {
+            continue;
+        }
+        if (exitBB && exitBB != succ)
+        {
+            return false;
+        }
+        exitBB = succ;
+    }
+    if (!isSelfLoop || !preheader || !exitBB || preheader->Succs.size() != 1 ||
+        exitBB->Preds.size() != 1 || exitBB == preheader)
+    {
+        return false;
+    }
+
+    // Find the accumulation.
+    G4_INST* accumInst = nullptr;
+    for (G4_INST* inst : *bb)
+    {
+        G4_DstRegRegion* dst = inst->getDst();
+        bool isAccumOp = inst->opcode() == G4_mad || inst->opcode() == G4_add;
+        if (!isAccumOp || !dst || dst->isNullReg() || dst->isIndirect() ||
+            dst->getType() != Type_F || dst->getHorzStride() != 1 || dst->getSubRegOff() != 0 ||
+            inst->getPredicate() || inst->getCondMod() || inst->getSaturate() ||
+            inst->getMaskOffset() != 0 || !inst->canDstBeAcc())
+        {
+            continue;
+        }
+        G4_Operand* src0 = inst->getSrc(0);
+        if (!src0->isSrcRegRegion() || src0->asSrcRegRegion()->getModifier() != Mod_src_undef ||
+            src0->getType() != dst->getType() || dst->compareOperand(src0) != Rel_eq ||
+            !inst->canSrcBeAcc(Opnd_src0))
+        {
+            continue;
+        }
+        if (inst->getExecSize() * dst->getTypeSize() > 2 * numEltPerGRF<Type_UB>())
+        {
+            continue;
+        }
+        accumInst = inst;
+        break;
+    }
+    if (!accumInst)
+    {
+        return false;
+    }
+
+    // The accumulation variable must not be accessed elsewhere in the loop,
+    // and acc must not be used by anything else.
+    G4_DstRegRegion* accum = accumInst->getDst();
+    for (G4_INST* inst : *bb)
+    {
+        if (inst->useAcc() || inst->mayExpandToAccMacro() || inst->isDpas() ||
+            inst->isCall() || inst->isFCall())
+        {
+            return false;
+        }
+        for (auto opndNum : { Opnd_dst, Opnd_src0, Opnd_src1, Opnd_src2, Opnd_src3 })
+        {
+            if (inst == accumInst && (opndNum == Opnd_dst || opndNum == Opnd_src0))
+            {
+                continue;
+            }
+            if (mayOverlap(inst->getOperand(opndNum), accum))
+            {
+                return false;
+            }
+        }
+    }
+
+    G4_ExecSize execSize = accumInst->getExecSize();
+    G4_Type type = accum->getType();
+    G4_Areg* accReg = builder.phyregpool.getAcc0Reg();
+
+    // Copy the initial value into acc at the end of the preheader.
+    auto phPos = preheader->end();
+    if (!preheader->empty() && preheader->back()->isFlowControl())
+    {
+        --phPos;
+    }
+    G4_SrcRegRegion* initSrc = builder.createSrcRegRegion(Mod_src_undef, Direct, accum->getBase(),
+        accum->getRegOff(), accum->getSubRegOff(), builder.getRegionStride1(), type);
+    preheader->insertBefore(phPos, builder.createMov(execSize,
+        builder.createDst(accReg, 0, 0, 1, type), initSrc, InstOpt_WriteEnable, false));
+
+    // Accumulate in acc.
+    G4_SrcRegRegion* accSrc = builder.createSrcRegRegion(Mod_src_undef, Direct, accReg, 0, 0,
+        builder.getRegionStride1(), type);
+    accumInst->setDest(builder.createDst(accReg, 0, 0, 1, type));
+    if (accumInst->opcode() == G4_mad && !builder.canMadHaveSrc0Acc())
+    {
+        // mac takes acc as its implicit src0.
+        accumInst->setSrc(accumInst->getSrc(1), 0);
+        accumInst->setSrc(accumInst->getSrc(2), 1);
+        accumInst->setSrc(nullptr, 2);
+        accumInst->setOpcode(G4_mac);
+        accumInst->setImplAccSrc(accSrc);
+    }
+    else
+    {
+        accumInst->setSrc(accSrc, 0);
+    }
+
+    // Copy the result back at the start of the exit block.
+    auto exitPos = exitBB->begin();
+    while (exitPos != exitBB->end() &&
+        ((*exitPos)->isLabel() || (*exitPos)->opcode() == G4_join || (*exitPos)->opcode() == G4_endif))
+    {
+        ++exitPos;
+    }
+    G4_SrcRegRegion* resultSrc = builder.createSrcRegRegion(Mod_src_undef, Direct, accReg, 0, 0,
+        builder.getRegionStride1(), type);
+    exitBB->insertBefore(exitPos, builder.createMov(execSize,
+        builder.createDstRegRegion(*accum), resultSrc, InstOpt_WriteEnable, false));
+
+    numAccSubDef++;
+    numAccSubUse++;
+    return true;
+}
+
 void AccSubPass::accSub(G4_BB* bb)
 {
     bb->resetLocalIds();
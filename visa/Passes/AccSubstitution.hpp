@@ -46,14 +46,34 @@ public:
 
     void run()
     {
+        // Loops whose accumulation stays in acc keep acc live across the
+        // back edge, so no other acc substitution is done in them.
+        std::set<G4_BB*> accLoops;
+        if (builder.getOption(vISA_loopAccSub))
+        {
+            for (auto bb : kernel.fg)
+            {
+                if (loopAccSub(bb))
+                {
+                    accLoops.insert(bb);
+                }
+            }
+        }
         for (auto bb : kernel.fg)
         {
-            accSub(bb);
+            if (!accLoops.count(bb))
+            {
+                accSub(bb);
+            }
         }
     }
     void accSub(G4_BB* bb);
     void multiAccSub(G4_BB* bb);
 
+    // Keep a loop-carried accumulation of a single block loop in acc0.
+    // Returns true if bb is such a loop and has been transformed.
+    bool loopAccSub(G4_BB* bb);
+
     bool isAccCandidate(G4_INST* inst, int& lastUse, bool& mustBeAcc0, int& readSuppressionSrcs, int& bundleBC,
         int& bankBC, std::map<G4_INST*, unsigned int>* BCInfo);
 
@@ -0,0 +1,407 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "GVN.hpp"
+#include "../BuildIR.h"
+#include "../G4_IR.hpp"
+#include "../RegAlloc.h"
+
+#include <unordered_map>
+#include <vector>
+
+using namespace vISA;
+
+namespace
+{
+    // Structural key of the value computed by an instruction.
+    struct GVNKey
+    {
+        std::vector<int64_t> fields;
+
+        bool operator==(const GVNKey& other) const { return fields == other.fields; }
+    };
+
+    struct GVNKeyHash
+    {
+        size_t operator()(const GVNKey& key) const
+        {
+            size_t h = 0;
+            for (auto f : key.fields)
+            {
+                h ^= std::hash<int64_t>()(f) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
+
+    struct DclInfo
+    {
+        unsigned numDefs = 0;
+        G4_INST* def = nullptr;
+        G4_BB* defBB = nullptr;
+        bool hasLifetimeEnd = false;
+        std::vector<std::pair<G4_BB*, G4_INST*>> uses;
+        std::vector<std::pair<G4_BB*, G4_INST*>> pseudoKills;
+    };
+
+    class GlobalValueNumbering
+    {
+        G4_Kernel& kernel;
+        FlowGraph& fg;
+        const PointsToAnalysis& p2a;
+
+        std::unordered_map<const G4_Declare*, DclInfo> dclInfo;
+        // an indirect write with no known points-to set may clobber any
+        // address taken variable
+        bool addrTakenClobbered = false;
+
+        std::unordered_map<GVNKey, std::pair<G4_BB*, G4_INST*>, GVNKeyHash> table;
+        unsigned numRemoved = 0;
+
+        static G4_Declare* getRoot(G4_Operand* opnd)
+        {
+            G4_Declare* dcl = opnd->getTopDcl();
+            return dcl ? dcl->getRootDeclare() : nullptr;
+        }
+
+        bool instDominates(G4_BB* bb1, G4_INST* inst1, G4_BB* bb2, G4_INST* inst2)
+        {
+            if (bb1 == bb2)
+            {
+                return inst1->getLocalId() < inst2->getLocalId();
+            }
+            return fg.getDominator().dominates(bb1, bb2);
+        }
+
+        void collectDefUses();
+        // Returns true if the value read by src at inst cannot change
+        // between any two executions of inst.
+        bool isImmutableSource(G4_BB* bb, G4_INST* inst, G4_Operand* src);
+        bool isCandidate(G4_BB* bb, G4_INST* inst);
+        GVNKey getKey(G4_INST* inst);
+        bool canReplace(G4_BB* defBB, G4_INST* defInst, G4_BB* bb, G4_INST* inst);
+        void replace(G4_INST* defInst, G4_BB* bb, INST_LIST_ITER it);
+
+    public:
+        GlobalValueNumbering(G4_Kernel& k, const PointsToAnalysis& p) :
+            kernel(k), fg(k.fg), p2a(p) {}
+
+        unsigned run();
+    };
+}
+
+void GlobalValueNumbering::collectDefUses()
+{
+    for (G4_BB* bb : fg)
+    {
+        bb->resetLocalIds();
+        for (G4_INST* inst : *bb)
+        {
+            G4_DstRegRegion* dst = inst->getDst();
+            if (dst && !dst->isNullReg())
+            {
+                if (dst->isIndirect())
+                {
+                    auto pointsTo = p2a.getAllInPointsTo(dst->getBase()->asRegVar());
+                    if (!pointsTo)
+                    {
+                        addrTakenClobbered = true;
+                    }
+                    else
+                    {
+                        for (auto var : *pointsTo)
+                        {
+                            // never a single definition
+                            dclInfo[var->getDeclare()->getRootDeclare()].numDefs += 2;
+                        }
+                    }
+                }
+                else if (G4_Declare* root = getRoot(dst))
+                {
+                    auto& info = dclInfo[root];
+                    if (inst->isPseudoKill())
+                    {
+                        info.pseudoKills.push_back(std::make_pair(bb, inst));
+                    }
+                    else
+                    {
+                        info.numDefs++;
+                        info.def = inst;
+                        info.defBB = bb;
+                    }
+                }
+            }
+
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+            {
+                G4_Operand* src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && !src->asSrcRegRegion()->isIndirect())
+                {
+                    if (G4_Declare* root = getRoot(src))
+                    {
+                        auto& info = dclInfo[root];
+                        info.uses.push_back(std::make_pair(bb, inst));
+                        info.hasLifetimeEnd |= inst->isLifeTimeEnd();
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool GlobalValueNumbering::isImmutableSource(G4_BB* bb, G4_INST* inst, G4_Operand* src)
+{
+    if (src->isImm())
+    {
+        return true;
+    }
+    if (!src->isSrcRegRegion())
+    {
+        return false;
+    }
+    G4_SrcRegRegion* srcRgn = src->asSrcRegRegion();
+    if (srcRgn->isIndirect() || !srcRgn->getBase()->isRegVar() ||
+        srcRgn->getBase()->asRegVar()->isPhyRegAssigned())
+    {
+        return false;
+    }
+    G4_Declare* root = getRoot(srcRgn);
+    if (!root || (root->getRegFile() != G4_GRF && root->getRegFile() != G4_INPUT) ||
+        (addrTakenClobbered && root->getAddressed()))
+    {
+        return false;
+    }
+    auto& info = dclInfo[root];
+    if (info.numDefs == 0)
+    {
+        return true;
+    }
+    // the single definition must be computed before every read, otherwise
+    // inst may read the value of the previous loop iteration
+    return info.numDefs == 1 && info.def != inst && instDominates(info.defBB, info.def, bb, inst);
+}
+
+bool GlobalValueNumbering::isCandidate(G4_BB* bb, G4_INST* inst)
+{
+    switch (inst->opcode())
+    {
+    case G4_mov: case G4_add: case G4_mul: case G4_mad:
+    case G4_shl: case G4_shr: case G4_asr:
+    case G4_and: case G4_or: case G4_xor: case G4_not:
+        break;
+    default:
+        return false;
+    }
+    if (inst->getPredicate() || inst->getCondMod() || inst->getImplAccSrc() || inst->getImplAccDst())
+    {
+        return false;
+    }
+
+    // dst must be the only definition of a whole, plain GRF variable whose
+    // uses are all known
+    G4_DstRegRegion* dst = inst->getDst();
+    if (!dst || dst->isNullReg() || dst->isIndirect() || !dst->getBase()->isRegVar() ||
+        dst->getBase()->asRegVar()->isPhyRegAssigned() ||
+        dst->getRegOff() != 0 || dst->getSubRegOff() != 0 || dst->getHorzStride() != 1)
+    {
+        return false;
+    }
+    G4_Declare* dcl = dst->getTopDcl();
+    if (!dcl || dcl->getAliasDeclare() || dcl->getRegFile() != G4_GRF ||
+        dcl->isInput() || dcl->isOutput() || dcl->isPreDefinedVar() || dcl->getAddressed() ||
+        dcl->getElemSize() != dst->getTypeSize() ||
+        dcl->getByteSize() != inst->getExecSize() * dst->getTypeSize())
+    {
+        return false;
+    }
+    auto& info = dclInfo[dcl];
+    if (info.numDefs != 1 || info.hasLifetimeEnd)
+    {
+        return false;
+    }
+
+    for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        if (!src || !isImmutableSource(bb, inst, src))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+GVNKey GlobalValueNumbering::getKey(G4_INST* inst)
+{
+    GVNKey key;
+    auto& f = key.fields;
+    G4_DstRegRegion* dst = inst->getDst();
+    f.push_back(inst->opcode());
+    f.push_back(inst->getExecSize());
+    f.push_back(inst->getOption());
+    f.push_back(inst->getSaturate());
+    f.push_back(dst->getType());
+    f.push_back(dst->getTopDcl()->getByteSize());
+    for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+    {
+        G4_Operand* src = inst->getSrc(i);
+        f.push_back(src->getType());
+        if (src->isImm())
+        {
+            f.push_back(0);
+            f.push_back(src->asImm()->getImm());
+            continue;
+        }
+        G4_SrcRegRegion* srcRgn = src->asSrcRegRegion();
+        const RegionDesc* rd = srcRgn->getRegion();
+        f.push_back(1);
+        f.push_back(getRoot(srcRgn)->getDeclId());
+        f.push_back(srcRgn->getLeftBound());
+        f.push_back(srcRgn->getModifier());
+        f.push_back(((int64_t)rd->vertStride << 32) | ((int64_t)rd->width << 16) | rd->horzStride);
+    }
+    return key;
+}
+
+bool GlobalValueNumbering::canReplace(G4_BB* defBB, G4_INST* defInst, G4_BB* bb, G4_INST* inst)
+{
+    // defInst must have written every channel inst writes
+    if (!defInst->isWriteEnableInst() && defBB != bb && !defBB->isAllLaneActive())
+    {
+        return false;
+    }
+
+    G4_Declare* dcl = inst->getDst()->getTopDcl();
+    G4_Declare* defDcl = defInst->getDst()->getTopDcl();
+    if (dcl->getElemType() != defDcl->getElemType() || dcl->getTotalElems() != defDcl->getTotalElems())
+    {
+        return false;
+    }
+
+    // every read of dcl must see this definition; a read that may happen
+    // before it (e.g., across a loop back edge) could observe a newer value
+    // of defDcl once they share storage
+    for (auto& use : dclInfo[dcl].uses)
+    {
+        if (!instDominates(bb, inst, use.first, use.second))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void GlobalValueNumbering::replace(G4_INST* defInst, G4_BB* bb, INST_LIST_ITER it)
+{
+    G4_INST* inst = *it;
+    G4_Declare* dcl = inst->getDst()->getTopDcl();
+    G4_Declare* defDcl = defInst->getDst()->getTopDcl();
+
+    // the pseudo kills of dcl would now end the live range of defDcl
+    for (auto& kill : dclInfo[dcl].pseudoKills)
+    {
+        kill.second->removeAllDefs();
+        kill.first->remove(kill.second);
+    }
+    dclInfo[dcl].pseudoKills.clear();
+
+    dcl->setAliasDeclare(defDcl, 0);
+    inst->transferUse(defInst, true);
+    inst->removeAllDefs();
+    bb->erase(it);
+    numRemoved++;
+}
+
+unsigned GlobalValueNumbering::run()
+{
+    if (fg.getNumFuncs() > 0 || fg.getHasStackCalls() || fg.getIsStackCallFunc())
+    {
+        // dominance does not account for subroutine and call edges
+        return 0;
+    }
+
+    fg.reassignBlockIDs();
+    fg.getImmDominator().setStale();
+    fg.getDominator().setStale();
+    const std::vector<G4_BB*>& iDoms = fg.getImmDominator().getIDoms();
+
+    std::vector<std::vector<G4_BB*>> domChildren(fg.size());
+    for (G4_BB* bb : fg)
+    {
+        G4_BB* iDom = iDoms[bb->getId()];
+        if (iDom && iDom != bb)
+        {
+            domChildren[iDom->getId()].push_back(bb);
+        }
+    }
+
+    collectDefUses();
+
+    // Walk the dominator tree, keeping in the table only the values
+    // computed by the dominators of the current block.
+    struct Scope
+    {
+        G4_BB* bb;
+        size_t nextChild;
+        std::vector<GVNKey> added;
+    };
+    std::vector<Scope> stack;
+    stack.push_back({ fg.getEntryBB(), 0, {} });
+    bool enter = true;
+    while (!stack.empty())
+    {
+        Scope& scope = stack.back();
+        G4_BB* bb = scope.bb;
+        if (enter)
+        {
+            for (auto it = bb->begin(); it != bb->end();)
+            {
+                auto curr = it++;
+                G4_INST* inst = *curr;
+                if (!isCandidate(bb, inst))
+                {
+                    continue;
+                }
+                GVNKey key = getKey(inst);
+                auto found = table.find(key);
+                if (found == table.end())
+                {
+                    table.emplace(key, std::make_pair(bb, inst));
+                    scope.added.push_back(std::move(key));
+                }
+                else if (canReplace(found->second.first, found->second.second, bb, inst))
+                {
+                    replace(found->second.second, bb, curr);
+                }
+            }
+        }
+
+        if (scope.nextChild < domChildren[bb->getId()].size())
+        {
+            G4_BB* child = domChildren[bb->getId()][scope.nextChild++];
+            stack.push_back({ child, 0, {} });
+            enter = true;
+            continue;
+        }
+
+        for (auto& key : scope.added)
+        {
+            table.erase(key);
+        }
+        stack.pop_back();
+        enter = false;
+    }
+
+    return numRemoved;
+}
+
+unsigned vISA::doGVN(G4_Kernel& kernel, const PointsToAnalysis& p2a)
+{
+    GlobalValueNumbering gvn(kernel, p2a);
+    return gvn.run();
+}
@@ -0,0 +1,31 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef VISA_PASSES_GVN_HPP
+#define VISA_PASSES_GVN_HPP
+
+namespace vISA
+{
+    class G4_Kernel;
+    class PointsToAnalysis;
+
+    // Dominator based value numbering, run after the per-BB LVN (-gvn).
+    //
+    // It only numbers instructions whose destination fully defines a
+    // variable that has no other definition, and whose sources are
+    // immediates or variables with a single dominating definition. Such
+    // values never change once computed, so an instruction computing the
+    // same value as one that dominates it is redundant: its destination is
+    // made an alias of the dominating one's and the instruction is removed.
+    // Indirect writes are accounted for with the points-to sets.
+    //
+    // Returns the number of instructions removed.
+    unsigned doGVN(G4_Kernel& kernel, const PointsToAnalysis& p2a);
+}
+
+#endif
@@ -8,6 +8,7 @@ SPDX-License-Identifier: MIT
 
 #include "MergeScalars.hpp"
 
+#include <algorithm>
 #include <vector>
 
 using namespace vISA;
@@ -275,10 +276,15 @@ bool BUNDLE_INFO::doMerge(IR_Builder& builder,
 
     newInst->setExecSize(execSize);
 
+    // the other members may be interleaved with skipped instructions
     auto iter = startIter;
     ++iter;
     for (int i = 1; i < size; ++i)
     {
+        while (*iter != inst[i])
+        {
+            ++iter;
+        }
         G4_INST* instToDelete = *iter;
         instToDelete->transferUse(newInst, true);
         for (int srcNum = 0, numSrc = instToDelete->getNumSrc(); srcNum < numSrc; ++srcNum)
@@ -760,24 +766,68 @@ bool BUNDLE_INFO::canMerge(G4_INST* inst)
 
 }
 
+//
+// check if inst, which comes after the skipped instructions, can be moved
+// before all of them, i.e., it neither reads nor writes what they write and
+// does not write what they read
+//
+bool BUNDLE_INFO::canHoistOverSkipped(G4_INST* inst)
+{
+    for (auto skippedInst : skipped)
+    {
+        if (inst->isRAWdep(skippedInst) || inst->isWARdep(skippedInst) ||
+            inst->isWAWdep(skippedInst))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 //
 // iter is advanced to the next instruction not belonging to the handle
 //
+// Up to skipLimit instructions that cannot join the bundle may be stepped
+// over, as long as the later members can be hoisted above them. The bundle
+// ends at the first instruction that can be neither merged nor skipped.
+//
 void BUNDLE_INFO::findInstructionToMerge(
     INST_LIST_ITER& iter, const IR_Builder& builder)
 {
+    // last instruction that is part of or before the bundle
+    INST_LIST_ITER lastIter = iter;
+    --lastIter;
 
     for (; iter != bb->end() && this->size < this->sizeLimit; ++iter)
     {
         G4_INST* nextInst = *iter;
-        if (!BUNDLE_INFO::isMergeCandidate(nextInst, builder, !bb->isAllLaneActive()))
+        if (BUNDLE_INFO::isMergeCandidate(nextInst, builder, !bb->isAllLaneActive()) &&
+            canHoistOverSkipped(nextInst))
         {
-            break;
+            // a failed attempt must not leave its operand patterns behind
+            OPND_PATTERN savedDstPattern = dstPattern;
+            OPND_PATTERN savedSrcPattern[maxNumSrc];
+            std::copy(srcPattern, srcPattern + maxNumSrc, savedSrcPattern);
+            if (canMerge(nextInst))
+            {
+                lastIter = iter;
+                continue;
+            }
+            dstPattern = savedDstPattern;
+            std::copy(savedSrcPattern, savedSrcPattern + maxNumSrc, srcPattern);
         }
 
-        if (!canMerge(nextInst))
+        if ((int)skipped.size() >= skipLimit || nextInst->isFlowControl() ||
+            nextInst->isLabel() || nextInst->isIntrinsic() || nextInst->isPseudoKill() ||
+            nextInst->isLifeTimeEnd() || nextInst->isSend())
         {
             break;
         }
+        skipped.push_back(nextInst);
     }
+
+    // resume right after the last member so that the skipped instructions
+    // at the end of the scan can still start their own bundle
+    iter = lastIter;
+    ++iter;
 }
\ No newline at end of file
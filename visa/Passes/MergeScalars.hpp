@@ -13,6 +13,8 @@ SPDX-License-Identifier: MIT
 #include "../BuildIR.h"
 #include "../FlowGraph.h"
 
+#include <vector>
+
 namespace vISA {
 
 // use by mergeScalar
@@ -38,13 +40,19 @@ struct BUNDLE_INFO
     static constexpr int maxNumSrc = 3;
     int size;
     int sizeLimit;
+    // max number of instructions that may be skipped between the members of
+    // the bundle; the members are hoisted to the first one when merged
+    int skipLimit;
     G4_BB* bb;
     INST_LIST_ITER startIter;
     G4_INST* inst[maxBundleSize];
     OPND_PATTERN dstPattern;
     OPND_PATTERN srcPattern[maxNumSrc];
+    // instructions between the members of the bundle that are not part of it
+    std::vector<G4_INST*> skipped;
 
-    BUNDLE_INFO(G4_BB* instBB, INST_LIST_ITER& instPos, int limit) : sizeLimit(limit), bb(instBB)
+    BUNDLE_INFO(G4_BB* instBB, INST_LIST_ITER& instPos, int limit, int skip = 0)
+        : sizeLimit(limit), skipLimit(skip), bb(instBB)
     {
 
         inst[0] = *instPos;
@@ -74,6 +82,7 @@ struct BUNDLE_INFO
     bool canMergeDst(G4_DstRegRegion* dst);
     bool canMergeSource(G4_Operand* src, int srcPos);
     bool canMerge(G4_INST* inst);
+    bool canHoistOverSkipped(G4_INST* inst);
 
     bool doMerge(IR_Builder& builder,
         std::unordered_set<G4_Declare*>& modifiedDcl,
@@ -0,0 +1,250 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "PerfModel.hpp"
+#include "../BuildIR.h"
+#include "../FlowGraph.h"
+#include "../G4_IR.hpp"
+#include "../LocalScheduler/LatencyTable.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace vISA;
+
+namespace
+{
+    struct BBCost
+    {
+        uint64_t cycles = 0;
+        uint64_t stallCycles = 0;
+        uint64_t numSends = 0;
+        uint64_t numBankConflicts = 0;
+    };
+
+    // When the read and the write of a token's instruction complete, as
+    // cycles after it issued.
+    struct TokenLatency
+    {
+        uint64_t read = 0;
+        uint64_t write = 0;
+    };
+
+    uint64_t saturatingMul(uint64_t a, uint64_t b)
+    {
+        if (a != 0 && b > std::numeric_limits<uint64_t>::max() / a)
+            return std::numeric_limits<uint64_t>::max();
+        return a * b;
+    }
+
+    uint64_t saturatingAdd(uint64_t a, uint64_t b)
+    {
+        return a > std::numeric_limits<uint64_t>::max() - b ?
+            std::numeric_limits<uint64_t>::max() : a + b;
+    }
+
+    uint64_t power(uint64_t base, unsigned exp)
+    {
+        uint64_t result = 1;
+        for (unsigned i = 0; i < exp; ++i)
+            result = saturatingMul(result, base);
+        return result;
+    }
+
+    class PerfModel
+    {
+        G4_Kernel& kernel;
+        const std::unordered_set<const G4_INST*>& bankConflicts;
+        LatencyTable LT;
+        // Latency of the last instruction setting each token, used for
+        // tokens set outside of the BB that waits on them.
+        std::unordered_map<unsigned short, TokenLatency> lastTokenLatency;
+
+    public:
+        PerfModel(G4_Kernel& k, const std::unordered_set<const G4_INST*>& bc)
+            : kernel(k), bankConflicts(bc), LT(k.fg.builder) {}
+
+        void collectTokenLatencies()
+        {
+            for (auto bb : kernel.fg)
+            {
+                for (auto inst : *bb)
+                {
+                    if (inst->getTokenType() == G4_INST::SB_SET)
+                    {
+                        lastTokenLatency[inst->getToken()] =
+                            { LT.getOccupancy(inst), LT.getLatency(inst) };
+                    }
+                }
+            }
+        }
+
+        BBCost estimate(G4_BB* bb)
+        {
+            BBCost cost;
+            // cycle at which the read and the write of each outstanding
+            // token complete
+            std::unordered_map<unsigned short, TokenLatency> pending;
+            uint64_t cycle = 0;
+
+            auto waitFor = [&](unsigned short token, bool afterWrite) {
+                uint64_t ready = 0;
+                auto it = pending.find(token);
+                if (it != pending.end())
+                {
+                    ready = afterWrite ? it->second.write : it->second.read;
+                }
+                else
+                {
+                    auto lastIt = lastTokenLatency.find(token);
+                    if (lastIt != lastTokenLatency.end())
+                        ready = afterWrite ? lastIt->second.write : lastIt->second.read;
+                }
+                if (ready > cycle)
+                {
+                    cost.stallCycles += ready - cycle;
+                    cycle = ready;
+                }
+            };
+
+            for (auto inst : *bb)
+            {
+                if (inst->isLabel())
+                    continue;
+
+                if (inst->opcode() == G4_sync_allrd || inst->opcode() == G4_sync_allwr)
+                {
+                    bool afterWrite = inst->opcode() == G4_sync_allwr;
+                    G4_Operand* src0 = inst->getSrc(0);
+                    if (src0 && src0->isImm())
+                    {
+                        uint64_t mask = (uint64_t)src0->asImm()->getInt();
+                        for (unsigned short token = 0; mask; ++token, mask >>= 1)
+                        {
+                            if (mask & 1)
+                                waitFor(token, afterWrite);
+                        }
+                    }
+                    else
+                    {
+                        // waits on all outstanding tokens of the BB
+                        for (auto& p : pending)
+                            waitFor(p.first, afterWrite);
+                    }
+                }
+                else if (inst->getTokenType() == G4_INST::AFTER_READ ||
+                    inst->getTokenType() == G4_INST::AFTER_WRITE)
+                {
+                    waitFor(inst->getToken(), inst->getTokenType() == G4_INST::AFTER_WRITE);
+                }
+
+                uint64_t issue = cycle;
+                cycle += LT.getOccupancy(inst);
+                if (bankConflicts.count(inst))
+                {
+                    // the conflicting source is read in an extra cycle
+                    cycle++;
+                    cost.numBankConflicts++;
+                }
+                if (inst->isSend())
+                {
+                    cost.numSends++;
+                }
+                if (inst->getTokenType() == G4_INST::SB_SET)
+                {
+                    pending[inst->getToken()] =
+                        { cycle, issue + LT.getLatency(inst) };
+                }
+            }
+            cost.cycles = cycle;
+            return cost;
+        }
+
+        uint64_t run()
+        {
+            collectTokenLatencies();
+
+            const uint64_t tripCount = std::max(1u,
+                kernel.getOptions()->getuInt32Option(vISA_PerfModelTripCount));
+            auto& loops = kernel.fg.getLoops();
+            auto getNestingLevel = [&loops](const G4_BB* bb) -> unsigned {
+                Loop* loop = loops.getInnerMostLoop(bb);
+                return loop ? loop->getNestingLevel() : 0;
+            };
+
+            std::unordered_map<const G4_BB*, BBCost> costs;
+            BBCost total;
+            for (auto bb : kernel.fg)
+            {
+                BBCost cost = estimate(bb);
+                costs[bb] = cost;
+                uint64_t weight = power(tripCount, getNestingLevel(bb));
+                total.cycles = saturatingAdd(total.cycles, saturatingMul(cost.cycles, weight));
+                total.stallCycles = saturatingAdd(total.stallCycles, saturatingMul(cost.stallCycles, weight));
+                total.numSends = saturatingAdd(total.numSends, saturatingMul(cost.numSends, weight));
+                total.numBankConflicts = saturatingAdd(total.numBankConflicts, saturatingMul(cost.numBankConflicts, weight));
+            }
+
+            std::ostringstream os;
+            os << "kernel: " << kernel.getName() << "\n";
+            os << "simd: " << kernel.getSimdSize() << "\n";
+            os << "trip_count: " << tripCount << "\n";
+            os << "cycles: " << total.cycles << "\n";
+            os << "stall_cycles: " << total.stallCycles << "\n";
+            os << "sends: " << total.numSends << "\n";
+            os << "bank_conflicts: " << total.numBankConflicts << "\n";
+
+            // Loops are listed outermost first, each followed by its nested
+            // loops.
+            std::vector<Loop*> worklist = loops.getTopLoops();
+            std::reverse(worklist.begin(), worklist.end());
+            if (!worklist.empty())
+                os << "loops:\n";
+            while (!worklist.empty())
+            {
+                Loop* loop = worklist.back();
+                worklist.pop_back();
+
+                unsigned level = loop->getNestingLevel();
+                BBCost iteration;
+                for (auto bb : loop->getBBs())
+                {
+                    const BBCost& cost = costs[bb];
+                    uint64_t weight = power(tripCount, getNestingLevel(bb) - level);
+                    iteration.cycles = saturatingAdd(iteration.cycles, saturatingMul(cost.cycles, weight));
+                    iteration.stallCycles = saturatingAdd(iteration.stallCycles, saturatingMul(cost.stallCycles, weight));
+                    iteration.numSends = saturatingAdd(iteration.numSends, saturatingMul(cost.numSends, weight));
+                }
+                os << "  - header: BB" << loop->getHeader()->getId() << "\n";
+                os << "    depth: " << level << "\n";
+                os << "    blocks: " << loop->getBBSize() << "\n";
+                os << "    cycles_per_iteration: " << iteration.cycles << "\n";
+                os << "    stall_cycles_per_iteration: " << iteration.stallCycles << "\n";
+                os << "    sends_per_iteration: " << iteration.numSends << "\n";
+
+                worklist.insert(worklist.end(), loop->immNested.rbegin(), loop->immNested.rend());
+            }
+
+            kernel.setPerfModelReport(os.str());
+
+            auto& stats = kernel.fg.builder->getcompilerStats();
+            stats.SetI64("PerfModelCycles", total.cycles, kernel.getSimdSize());
+            stats.SetI64("PerfModelStallCycles", total.stallCycles, kernel.getSimdSize());
+            return total.cycles;
+        }
+    };
+} // namespace
+
+uint64_t vISA::estimatePerformance(G4_Kernel& kernel,
+    const std::unordered_set<const G4_INST*>& bankConflicts)
+{
+    return PerfModel(kernel, bankConflicts).run();
+}
@@ -0,0 +1,37 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef VISA_PASSES_PERFMODEL_HPP
+#define VISA_PASSES_PERFMODEL_HPP
+
+#include <cstdint>
+#include <unordered_set>
+
+namespace vISA
+{
+    class G4_Kernel;
+    class G4_INST;
+
+    // Static throughput model of the final instruction stream (-perfModel).
+    //
+    // Every BB is walked in order as if its instructions issued back to
+    // back: each instruction costs its occupancy from the LatencyTable, an
+    // instruction in bankConflicts costs one more cycle, and an instruction
+    // waiting on an SBID token stalls until the send (or math) that set the
+    // token has completed. A token set in another BB is assumed to have been
+    // issued just before the BB began. BB cycles are then weighted by the
+    // assumed trip count (-perfModelTripCount) raised to the loop nesting
+    // level, and the cycles of one iteration of each loop are reported.
+    //
+    // The report is attached to the kernel (G4_Kernel::getPerfModelReport)
+    // and the weighted cycles are returned.
+    uint64_t estimatePerformance(G4_Kernel& kernel,
+        const std::unordered_set<const G4_INST*>& bankConflicts);
+}
+
+#endif
@@ -28,7 +28,11 @@ namespace vISA
 
             // Control how many instructions except send itself need to
             // be moved in order to move two sends together for fusion.
-            SEND_FUSION_MAX_INST_TOBEMOVED = 4
+            SEND_FUSION_MAX_INST_TOBEMOVED = 4,
+
+            // Control how many instructions a send can be hoisted over
+            // when moved from its BB into a dominating BB for fusion.
+            SEND_FUSION_MAX_HOIST_SPAN = 40
         };
 
         FlowGraph* CFG;
@@ -113,6 +117,10 @@ namespace vISA
         void simplifyMsg(INST_LIST_ITER SendIter);
         bool isAtomicCandidate(const G4_SendDescRaw * msgDesc);
 
+        // Return the last send of BB if it is a fusion candidate and no
+        // other send follows it.
+        G4_INST* getLastCandidate(G4_BB* BB);
+
         bool WAce0Read;
 
 
@@ -141,6 +149,10 @@ namespace vISA
         }
 
         bool run(G4_BB* BB);
+
+        // Move the first send of BB's immediate post-dominator into BB
+        // if it can be fused with BB's last send. Return true if moved.
+        bool hoistFromPostDominator(G4_BB* BB);
     };
 }
 
@@ -1599,6 +1611,138 @@ void SendFusion::doFusion(
 }
 
 
+G4_INST* SendFusion::getLastCandidate(G4_BB* BB)
+{
+    CurrBB = BB;
+    CurrBB->resetLocalIds();
+    for (auto II = BB->end(); II != BB->begin();)
+    {
+        --II;
+        G4_INST* inst = *II;
+        if (inst->isSend())
+        {
+            return simplifyAndCheckCandidate(II) ? inst : nullptr;
+        }
+        if (inst->isOptBarrier())
+        {
+            return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+// Given a single-entry single-exit region:
+//
+//      BB:   ...
+//            send0
+//            (f) jmpi  L
+//            ...         <-- region, no send
+//      PDom: ...
+//            send1
+//
+// where BB dominates PDom and PDom post-dominates BB, send1 runs under the
+// same channel mask as send0. If send1 does not depend on any instruction
+// in the region or ahead of it in PDom, it is moved to the end of BB, so
+// that run(BB) can fuse it with send0.
+//
+bool SendFusion::hoistFromPostDominator(G4_BB* BB)
+{
+    G4_INST* send0 = getLastCandidate(BB);
+    if (!send0)
+    {
+        return false;
+    }
+
+    auto& immPDoms = CFG->getPostDominator().getImmPostDom(BB);
+    G4_BB* PDom = immPDoms.size() > 1 ? immPDoms[1] : nullptr;
+    if (!PDom || PDom == BB || !CFG->getDominator().dominates(BB, PDom))
+    {
+        return false;
+    }
+
+    // Collect the region between BB and PDom. Reaching BB again means the
+    // region is not acyclic.
+    std::vector<G4_INST*> region;
+    std::vector<G4_BB*> worklist(BB->Succs.begin(), BB->Succs.end());
+    std::set<G4_BB*> visited;
+    while (!worklist.empty())
+    {
+        G4_BB* bb = worklist.back();
+        worklist.pop_back();
+        if (bb == PDom || !visited.insert(bb).second)
+        {
+            continue;
+        }
+        if (bb == BB || bb->Succs.empty())
+        {
+            return false;
+        }
+        region.insert(region.end(), bb->begin(), bb->end());
+        if (region.size() > SEND_FUSION_MAX_HOIST_SPAN)
+        {
+            return false;
+        }
+        worklist.insert(worklist.end(), bb->Succs.begin(), bb->Succs.end());
+    }
+
+    // Find the first send in PDom.
+    CurrBB = PDom;
+    CurrBB->resetLocalIds();
+    INST_LIST_ITER SendIt = PDom->end();
+    for (auto II = PDom->begin(), IE = PDom->end(); II != IE; ++II)
+    {
+        G4_INST* inst = *II;
+        if (inst->isSend())
+        {
+            if (simplifyAndCheckCandidate(II))
+            {
+                SendIt = II;
+            }
+            break;
+        }
+        if (inst->isOptBarrier())
+        {
+            break;
+        }
+        region.push_back(inst);
+    }
+    if (SendIt == PDom->end() || region.size() > SEND_FUSION_MAX_HOIST_SPAN)
+    {
+        return false;
+    }
+
+    G4_INST* send1 = *SendIt;
+    G4_SendDescRaw* desc0 = send0->getMsgDescRaw();
+    G4_SendDescRaw* desc1 = send1->getMsgDescRaw();
+    if (send1->opcode() != send0->opcode() ||
+        send1->getExecSize() != send0->getExecSize() ||
+        send1->getOption() != send0->getOption() ||
+        desc0->getDesc() != desc1->getDesc() ||
+        desc0->getExtendedDesc() != desc1->getExtendedDesc() ||
+        send1->isRAWdep(send0))
+    {
+        return false;
+    }
+
+    for (G4_INST* inst : region)
+    {
+        if (inst->isSend() || inst->isOptBarrier() || inst->isCall() || inst->isReturn() ||
+            send1->isRAWdep(inst) || send1->isWARdep(inst) || send1->isWAWdep(inst))
+        {
+            return false;
+        }
+    }
+
+    INST_LIST_ITER InsertPos = BB->end();
+    if (!BB->empty() && BB->back()->isFlowControl())
+    {
+        --InsertPos;
+    }
+    PDom->erase(SendIt);
+    BB->insertBefore(InsertPos, send1);
+    return true;
+}
+
 bool SendFusion::run(G4_BB* BB)
 {
     // Prepare for processing this BB
@@ -1716,6 +1860,17 @@ bool vISA::doSendFusion(FlowGraph* aCFG, Mem_Manager* aMMgr)
     SendFusion sendFusion(aCFG, aMMgr);
 
     bool change = false;
+
+    // Bring sends separated by small control flow into the same BB first.
+    // Only instructions move, so the dominator trees remain valid.
+    if (aCFG->builder->getOption(vISA_EnableCrossBBSendFusion))
+    {
+        for (G4_BB* BB : *aCFG)
+        {
+            change |= sendFusion.hoistFromPostDominator(BB);
+        }
+    }
+
     for (BB_LIST_ITER BI = aCFG->begin(), BE = aCFG->end(); BI != BE; ++BI)
     {
         G4_BB* BB = *BI;
@@ -250,6 +250,54 @@ unsigned short PhyRegUsage::getOccupiedBundle(const G4_Declare* dcl) const
     return occupiedBundles;
 }
 
+// Returns the alignment that places dcl in the bank less used by its three
+// source partners that already have an assignment, or Either if there is no
+// such preference.
+BankAlign PhyRegUsage::getPreferredBankAlign(const G4_Declare* dcl) const
+{
+    if (!builder.getOption(vISA_DynamicBankConflictReduction))
+    {
+        return BankAlign::Either;
+    }
+
+    int bankUses[2] = { 0, 0 };
+    for (const BundleConflict& conflict : gra.getBankConflictDcls(dcl))
+    {
+        int reg = -1;
+        const G4_RegVar* regVar = conflict.dcl->getRegVar();
+        if (regVar->isPhyRegAssigned())
+        {
+            reg = regVar->getPhyReg()->asGreg()->getRegNum();
+        }
+        else if (regVar->isRegAllocPartaker())
+        {
+            LiveRange* lr = lrs[regVar->getId()];
+            if (lr && lr->getPhyReg() && lr->getPhyReg()->isGreg())
+            {
+                reg = lr->getPhyReg()->asGreg()->getRegNum();
+            }
+        }
+
+        // our operand row would be in the same bank as the partner's if our
+        // base were in the bank of the partner's row minus the offset
+        if (reg != -1 && reg + conflict.offset >= 0)
+        {
+            bankUses[gra.getGRFBank(reg + conflict.offset)]++;
+        }
+    }
+
+    if (bankUses[0] == bankUses[1])
+    {
+        return BankAlign::Either;
+    }
+    bool useBank0 = bankUses[0] < bankUses[1];
+    if (builder.oneGRFBankDivision())
+    {
+        return useBank0 ? BankAlign::Even : BankAlign::Odd;
+    }
+    return useBank0 ? BankAlign::Even2GRF : BankAlign::Odd2GRF;
+}
+
 // returns the starting word index if we find enough free contiguous words satisfying alignment,
 // -1 otherwise
 int PhyRegUsage::findContiguousWords(
@@ -1171,9 +1219,26 @@ bool PhyRegUsage::assignRegs(bool  highInternalConflict,
 
             bool forceCalleeSaveAlloc = builder.kernel.fg.isPseudoVCEDcl(decl);
             unsigned short occupiedBundles = getOccupiedBundle(decl);
-            bool success = findContiguousGRF(availableGregs, forbidden, occupiedBundles,
-                getAlignToUse(align, bankAlign), decl->getNumRows(), endGRFReg,
-                startGRFReg, i, forceCalleeSaveAlloc, varBasis->getEOTSrc());
+            bool success = false;
+            if (align == BankAlign::Either && bankAlign == BankAlign::Either && !hintSet &&
+                !varBasis->getEOTSrc())
+            {
+                // try the bank that avoids conflicts with the three source
+                // partners assigned so far first
+                BankAlign preferredAlign = getPreferredBankAlign(decl);
+                if (preferredAlign != BankAlign::Either)
+                {
+                    success = findContiguousGRF(availableGregs, forbidden, occupiedBundles,
+                        preferredAlign, decl->getNumRows(), endGRFReg,
+                        startGRFReg, i, forceCalleeSaveAlloc, false);
+                }
+            }
+            if (!success)
+            {
+                success = findContiguousGRF(availableGregs, forbidden, occupiedBundles,
+                    getAlignToUse(align, bankAlign), decl->getNumRows(), endGRFReg,
+                    startGRFReg, i, forceCalleeSaveAlloc, varBasis->getEOTSrc());
+            }
             if (success) {
                 varBasis->setPhyReg(regPool.getGreg(i), 0);
             }
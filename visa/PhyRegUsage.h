@@ -307,6 +307,7 @@ private:
                                  bool oneGRFBankDivision);
 
     unsigned short getOccupiedBundle(const G4_Declare* dcl) const;
+    BankAlign getPreferredBankAlign(const G4_Declare* dcl) const;
 
     // find contiguous free words in a registers
     int findContiguousWords(uint32_t words, G4_SubReg_Align alignment, int numWord) const;
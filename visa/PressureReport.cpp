@@ -0,0 +1,244 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "PressureReport.h"
+#include "BuildIR.h"
+#include "GraphColor.h"
+#include "RPE.h"
+
+#include <algorithm>
+#include <fstream>
+#include <unordered_set>
+
+using namespace vISA;
+
+namespace
+{
+    // number of variables listed at the peak
+    const unsigned NumPeakVars = 10;
+
+    // Source range of a set of instructions, e.g. "foo.cl:12-40".
+    class LineRange
+    {
+        const char* file = nullptr;
+        int first = 0;
+        int last = 0;
+
+    public:
+        void add(const G4_INST* inst)
+        {
+            int line = inst->getLineNo();
+            if (line <= 0)
+                return;
+            if (!file && inst->getSrcFilename())
+                file = inst->getSrcFilename();
+            first = first ? std::min(first, line) : line;
+            last = std::max(last, line);
+        }
+
+        void add(G4_BB* bb)
+        {
+            for (auto inst : *bb)
+                add(inst);
+        }
+
+        bool empty() const { return first == 0; }
+
+        void print(std::ostream& os) const
+        {
+            if (file)
+                os << file << ":";
+            os << first;
+            if (last != first)
+                os << "-" << last;
+        }
+    };
+
+    void printLines(std::ostream& os, const char* indent, const LineRange& lines)
+    {
+        if (!lines.empty())
+        {
+            os << indent << "lines: ";
+            lines.print(os);
+            os << "\n";
+        }
+    }
+} // namespace
+
+std::string PressureReport::getReportFileName(G4_Kernel& kernel)
+{
+    const char* asmFileName = nullptr;
+    kernel.getOptions()->getOption(VISA_AsmFileName, asmFileName);
+    std::string base = asmFileName ? asmFileName : kernel.getName();
+    return base + "_pressure.txt";
+}
+
+void PressureReport::recordPressure(const GlobalRA& gra, const LivenessAnalysis& liveness)
+{
+    if (liveness.getNumSelectedVar() == 0)
+        return;
+
+    RPE rpe(gra, &liveness);
+    rpe.run();
+    for (auto bb : kernel.fg)
+    {
+        BBInfo& info = bbInfo[bb];
+        for (auto inst : *bb)
+        {
+            unsigned pressure = rpe.getRegisterPressure(inst);
+            info.peakPressure = std::max(info.peakPressure, pressure);
+            if (pressure > peakPressure || !peakInst)
+            {
+                peakPressure = pressure;
+                peakBB = bb;
+                peakInst = inst;
+            }
+        }
+    }
+    if (!peakInst)
+        return;
+
+    // Walk the peak BB again up to the peak to get what is live there.
+    rpe.runBB(const_cast<G4_BB*>(peakBB), const_cast<G4_INST*>(peakInst));
+    const BitSet& live = rpe.getLiveVars();
+    std::unordered_set<const G4_Declare*> seen;
+    peakVars.clear();
+    for (unsigned i = 0, size = live.getSize(); i < size; i++)
+    {
+        if (!live.isSet(i))
+            continue;
+        const G4_Declare* dcl = liveness.vars[i]->getDeclare()->getRootDeclare();
+        if (seen.insert(dcl).second)
+            peakVars.push_back(dcl);
+    }
+    std::stable_sort(peakVars.begin(), peakVars.end(),
+        [](const G4_Declare* a, const G4_Declare* b) { return a->getByteSize() > b->getByteSize(); });
+    if (peakVars.size() > NumPeakVars)
+        peakVars.resize(NumPeakVars);
+}
+
+void PressureReport::recordSpillCode()
+{
+    for (auto bb : kernel.fg)
+    {
+        BBInfo& info = bbInfo[bb];
+        info.spills = 0;
+        info.fills = 0;
+        for (auto inst : *bb)
+        {
+            if (inst->isSpillIntrinsic())
+                info.spills++;
+            else if (inst->isFillIntrinsic())
+                info.fills++;
+        }
+    }
+}
+
+bool PressureReport::write(const std::string& fileName)
+{
+    std::ofstream os(fileName);
+    if (!os)
+        return false;
+
+    unsigned spills = 0, fills = 0;
+    for (auto& it : bbInfo)
+    {
+        spills += it.second.spills;
+        fills += it.second.fills;
+    }
+
+    os << "kernel: " << kernel.getName() << "\n";
+    os << "grfs: " << kernel.getNumRegTotal() << "\n";
+    os << "peak_pressure: " << peakPressure << "\n";
+    os << "spills: " << spills << "\n";
+    os << "fills: " << fills << "\n";
+
+    if (peakInst)
+    {
+        // first definition of each peak variable, for its source line
+        std::unordered_map<const G4_Declare*, const G4_INST*> firstDef;
+        std::unordered_set<const G4_Declare*> wanted(peakVars.begin(), peakVars.end());
+        for (auto bb : kernel.fg)
+        {
+            for (auto inst : *bb)
+            {
+                G4_DstRegRegion* dst = inst->getDst();
+                const G4_Declare* dcl = dst && dst->getTopDcl() ? dst->getTopDcl()->getRootDeclare() : nullptr;
+                if (dcl && wanted.count(dcl) && !firstDef.count(dcl))
+                    firstDef[dcl] = inst;
+            }
+        }
+
+        LineRange peakLine;
+        peakLine.add(peakInst);
+        os << "peak:\n";
+        os << "  bb: " << peakBB->getId() << "\n";
+        printLines(os, "  ", peakLine);
+        os << "  variables:\n";
+        for (auto dcl : peakVars)
+        {
+            os << "    - name: " << dcl->getName() << "\n";
+            os << "      bytes: " << dcl->getByteSize() << "\n";
+            auto it = firstDef.find(dcl);
+            if (it != firstDef.end())
+            {
+                LineRange defLine;
+                defLine.add(it->second);
+                printLines(os, "      ", defLine);
+            }
+        }
+    }
+
+    auto& loops = kernel.fg.getLoops();
+    os << "blocks:\n";
+    for (auto bb : kernel.fg)
+    {
+        const BBInfo& info = bbInfo[bb];
+        Loop* loop = loops.getInnerMostLoop(bb);
+        LineRange lines;
+        lines.add(bb);
+        os << "  - bb: " << bb->getId() << "\n";
+        printLines(os, "    ", lines);
+        os << "    loop_depth: " << (loop ? loop->getNestingLevel() : 0) << "\n";
+        os << "    peak_pressure: " << info.peakPressure << "\n";
+        os << "    spills: " << info.spills << "\n";
+        os << "    fills: " << info.fills << "\n";
+    }
+
+    // Loops are listed outermost first, each followed by its nested loops.
+    // A loop's counts include those of its nested loops.
+    std::vector<Loop*> worklist = loops.getTopLoops();
+    std::reverse(worklist.begin(), worklist.end());
+    if (!worklist.empty())
+        os << "loops:\n";
+    while (!worklist.empty())
+    {
+        Loop* loop = worklist.back();
+        worklist.pop_back();
+
+        BBInfo total;
+        LineRange lines;
+        for (auto bb : loop->getBBs())
+        {
+            const BBInfo& info = bbInfo[bb];
+            total.peakPressure = std::max(total.peakPressure, info.peakPressure);
+            total.spills += info.spills;
+            total.fills += info.fills;
+            lines.add(bb);
+        }
+        os << "  - header: BB" << loop->getHeader()->getId() << "\n";
+        os << "    depth: " << loop->getNestingLevel() << "\n";
+        printLines(os, "    ", lines);
+        os << "    peak_pressure: " << total.peakPressure << "\n";
+        os << "    spills: " << total.spills << "\n";
+        os << "    fills: " << total.fills << "\n";
+
+        worklist.insert(worklist.end(), loop->immNested.rbegin(), loop->immNested.rend());
+    }
+    return true;
+}
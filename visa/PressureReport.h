@@ -0,0 +1,62 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef __PRESSUREREPORT_H__
+#define __PRESSUREREPORT_H__
+
+#include "G4_Kernel.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vISA
+{
+    class GlobalRA;
+    class LivenessAnalysis;
+
+    //
+    // Register pressure and spill report of one kernel (-pressureReport),
+    // written to <asm file name>_pressure.txt. It lists the peak pressure of
+    // every BB and loop as estimated by RPE when GRF RA starts, the largest
+    // variables live at the kernel's peak, and the spill and fill intrinsics
+    // RA inserted in each BB and loop nest. BBs, loops and variables are
+    // mapped back to source lines when the input has line info.
+    //
+    class PressureReport
+    {
+    public:
+        explicit PressureReport(G4_Kernel& k) : kernel(k) {}
+
+        static std::string getReportFileName(G4_Kernel& kernel);
+
+        // Called on the first GRF RA iteration, before anything is spilled.
+        void recordPressure(const GlobalRA& gra, const LivenessAnalysis& liveness);
+        // Called once spill code is final, before spill/fill intrinsics are
+        // expanded.
+        void recordSpillCode();
+        bool write(const std::string& fileName);
+
+    private:
+        struct BBInfo
+        {
+            unsigned peakPressure = 0;
+            unsigned spills = 0;
+            unsigned fills = 0;
+        };
+
+        G4_Kernel& kernel;
+        std::unordered_map<const G4_BB*, BBInfo> bbInfo;
+        unsigned peakPressure = 0;
+        const G4_BB* peakBB = nullptr;
+        const G4_INST* peakInst = nullptr;
+        // root declares live at peakInst, largest first
+        std::vector<const G4_Declare*> peakVars;
+    };
+}
+#endif // __PRESSUREREPORT_H__
@@ -0,0 +1,305 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#include "RADecisionLog.h"
+#include "BuildIR.h"
+#include "GraphColor.h"
+
+#include <fstream>
+
+using namespace vISA;
+
+namespace
+{
+    // "VRAL"
+    const uint32_t RALogMagic = 0x4c415256;
+    const uint32_t RALogVersion = 1;
+
+    enum RALogRecord : uint8_t
+    {
+        RALOG_ITERATION = 1,
+        RALOG_ASSIGNMENT = 2,
+        RALOG_END = 0xff
+    };
+
+    class HashBuilder
+    {
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ULL;
+    public:
+        void add(uint64_t v)
+        {
+            for (unsigned i = 0; i < 8; i++)
+            {
+                hash ^= (v >> (i * 8)) & 0xff;
+                hash *= 0x100000001b3ULL;
+            }
+        }
+        void addStr(const char* str)
+        {
+            for (; str && *str; str++)
+            {
+                hash ^= (unsigned char)*str;
+                hash *= 0x100000001b3ULL;
+            }
+            add(0ULL);
+        }
+        uint64_t get() const { return hash; }
+    };
+
+    template <typename T>
+    void writePOD(std::ostream& os, const T& v)
+    {
+        os.write(reinterpret_cast<const char*>(&v), sizeof(T));
+    }
+
+    template <typename T>
+    bool readPOD(std::istream& is, T& v)
+    {
+        is.read(reinterpret_cast<char*>(&v), sizeof(T));
+        return is.good();
+    }
+
+    void hashOperand(HashBuilder& h, G4_Operand* opnd)
+    {
+        if (!opnd)
+        {
+            h.add(0ULL);
+            return;
+        }
+        h.add(opnd->getKind());
+        h.add(opnd->getType());
+        if (opnd->isImm())
+        {
+            h.add(opnd->asImm()->getImm());
+            return;
+        }
+        G4_Declare* topDcl = opnd->getTopDcl();
+        h.add(topDcl ? topDcl->getDeclId() + 1 : 0);
+        if (opnd->isSrcRegRegion())
+        {
+            G4_SrcRegRegion* src = opnd->asSrcRegRegion();
+            h.add(src->getRegAccess());
+            h.add(src->getModifier());
+            h.add(((uint64_t)(uint16_t)src->getRegOff() << 16) | (uint16_t)src->getSubRegOff());
+        }
+        else if (opnd->isDstRegRegion())
+        {
+            G4_DstRegRegion* dst = opnd->asDstRegRegion();
+            h.add(dst->getRegAccess());
+            h.add(dst->getHorzStride());
+            h.add(((uint64_t)(uint16_t)dst->getRegOff() << 16) | (uint16_t)dst->getSubRegOff());
+        }
+        else if (!topDcl && opnd->getBase() && opnd->getBase()->isPhyReg())
+        {
+            h.add(opnd->getLinearizedStart());
+        }
+    }
+}
+
+uint64_t RADecisionLog::computeIRHash(G4_Kernel& kernel)
+{
+    HashBuilder h;
+    h.add(kernel.getNumRegTotal());
+    h.add(kernel.Declares.size());
+    for (G4_Declare* dcl : kernel.Declares)
+    {
+        h.addStr(dcl->getName());
+        h.add(dcl->getRegFile());
+        h.add(dcl->getElemType());
+        h.add(dcl->getTotalElems());
+        h.add(dcl->getAliasDeclare() ? dcl->getAliasDeclare()->getDeclId() + 1 : 0);
+        h.add(dcl->getAliasOffset());
+    }
+    for (G4_BB* bb : kernel.fg)
+    {
+        h.add(bb->getId());
+        for (G4_INST* inst : *bb)
+        {
+            h.add(inst->opcode());
+            h.add(inst->getExecSize());
+            h.add(inst->getOption());
+            hashOperand(h, inst->getDst());
+            for (int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+            {
+                hashOperand(h, inst->getSrc(i));
+            }
+            hashOperand(h, inst->getPredicate());
+            hashOperand(h, inst->getCondMod());
+        }
+    }
+    return h.get();
+}
+
+std::string RADecisionLog::getLogFileName(const G4_Kernel& kernel, const char* prefix)
+{
+    return std::string(prefix) + kernel.getName() + ".ralog";
+}
+
+void RADecisionLog::begin()
+{
+    irHash = computeIRHash(kernel);
+    numDclsAtStart = (uint32_t)kernel.Declares.size();
+    iterations.clear();
+    assignments.clear();
+    replayable = false;
+}
+
+void RADecisionLog::recordIteration(unsigned iterNo, bool success, const std::list<LiveRange*>& spilledLRs)
+{
+    IterationRecord record = { iterNo, success, {} };
+    for (LiveRange* lr : spilledLRs)
+    {
+        record.spills.push_back({ lr->getDcl()->getDeclId(), lr->getSpillCost(), lr->getRefCount() });
+    }
+    iterations.push_back(std::move(record));
+}
+
+void RADecisionLog::recordAssignment()
+{
+    // The assignment is only valid for the IR it was computed on, so it can be
+    // replayed only if RA itself did not change the IR.
+    replayable = kernel.Declares.size() == numDclsAtStart &&
+        computeIRHash(kernel) == irHash;
+    for (auto& iter : iterations)
+    {
+        replayable &= iter.success;
+    }
+
+    assignments.clear();
+    for (uint32_t i = 0; i < numDclsAtStart && i < kernel.Declares.size(); i++)
+    {
+        G4_Declare* dcl = kernel.Declares[i];
+        G4_RegVar* var = dcl->getRegVar();
+        if (dcl->getAliasDeclare() || (dcl->getRegFile() != G4_GRF && dcl->getRegFile() != G4_INPUT) ||
+            !var->isPhyRegAssigned() || !var->getPhyReg()->isGreg())
+        {
+            continue;
+        }
+        assignments.push_back({ i, (uint16_t)var->getPhyReg()->asGreg()->getRegNum(),
+            (uint16_t)var->getPhyRegOff() });
+    }
+}
+
+bool RADecisionLog::write(const std::string& fileName) const
+{
+    std::ofstream os(fileName, std::ios::binary);
+    if (!os)
+    {
+        return false;
+    }
+
+    writePOD(os, RALogMagic);
+    writePOD(os, RALogVersion);
+    writePOD(os, irHash);
+    writePOD(os, numDclsAtStart);
+    writePOD(os, (uint32_t)kernel.getRAType());
+
+    for (auto& iter : iterations)
+    {
+        writePOD(os, RALOG_ITERATION);
+        writePOD(os, iter.iterNo);
+        writePOD(os, (uint8_t)iter.success);
+        writePOD(os, (uint32_t)iter.spills.size());
+        for (auto& spill : iter.spills)
+        {
+            writePOD(os, spill.declId);
+            writePOD(os, spill.spillCost);
+            writePOD(os, spill.refCount);
+        }
+    }
+
+    writePOD(os, RALOG_ASSIGNMENT);
+    writePOD(os, (uint8_t)replayable);
+    writePOD(os, (uint32_t)assignments.size());
+    for (auto& assign : assignments)
+    {
+        writePOD(os, assign.dclIndex);
+        writePOD(os, assign.regNum);
+        writePOD(os, assign.subRegOff);
+    }
+    writePOD(os, RALOG_END);
+    return os.good();
+}
+
+bool RADecisionLog::replay(G4_Kernel& kernel, const std::string& fileName)
+{
+    std::ifstream is(fileName, std::ios::binary);
+    if (!is)
+    {
+        return false;
+    }
+
+    uint32_t magic = 0, version = 0, numDcls = 0, raType = 0;
+    uint64_t hash = 0;
+    if (!readPOD(is, magic) || magic != RALogMagic ||
+        !readPOD(is, version) || version != RALogVersion ||
+        !readPOD(is, hash) || !readPOD(is, numDcls) || !readPOD(is, raType) ||
+        numDcls != kernel.Declares.size() || hash != computeIRHash(kernel))
+    {
+        return false;
+    }
+
+    uint8_t tag = 0;
+    while (readPOD(is, tag) && tag == RALOG_ITERATION)
+    {
+        uint32_t iterNo = 0, numSpills = 0;
+        uint8_t success = 0;
+        if (!readPOD(is, iterNo) || !readPOD(is, success) || !readPOD(is, numSpills))
+        {
+            return false;
+        }
+        // spill decisions are only informative for replay
+        is.seekg(numSpills * (sizeof(uint32_t) + sizeof(float) + sizeof(uint32_t)), std::ios::cur);
+    }
+
+    uint8_t replayable = 0;
+    uint32_t numAssignments = 0;
+    if (tag != RALOG_ASSIGNMENT || !readPOD(is, replayable) || !replayable ||
+        !readPOD(is, numAssignments))
+    {
+        return false;
+    }
+
+    std::vector<G4_Declare*> assigned(numAssignments, nullptr);
+    std::vector<std::pair<uint16_t, uint16_t>> regs(numAssignments);
+    std::vector<bool> covered(kernel.Declares.size(), false);
+    for (uint32_t i = 0; i < numAssignments; i++)
+    {
+        uint32_t dclIndex = 0;
+        if (!readPOD(is, dclIndex) || !readPOD(is, regs[i].first) || !readPOD(is, regs[i].second) ||
+            dclIndex >= kernel.Declares.size() || regs[i].first >= kernel.getNumRegTotal())
+        {
+            return false;
+        }
+        assigned[i] = kernel.Declares[dclIndex];
+        covered[dclIndex] = true;
+    }
+
+    // every GRF variable that still needs a register must be in the log
+    for (size_t i = 0; i < kernel.Declares.size(); i++)
+    {
+        G4_Declare* dcl = kernel.Declares[i];
+        if (!covered[i] && !dcl->getAliasDeclare() && dcl->getRegFile() == G4_GRF &&
+            !dcl->getRegVar()->isPhyRegAssigned())
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < numAssignments; i++)
+    {
+        G4_RegVar* var = assigned[i]->getRegVar();
+        if (!var->isPhyRegAssigned())
+        {
+            var->setPhyReg(kernel.fg.builder->phyregpool.getGreg(regs[i].first), regs[i].second);
+        }
+    }
+    kernel.setRAType((RA_Type)raType);
+    return true;
+}
@@ -0,0 +1,85 @@
+/*========================== begin_copyright_notice ============================
+
+Copyright (C) 2021 Intel Corporation
+
+SPDX-License-Identifier: MIT
+
+============================= end_copyright_notice ===========================*/
+
+#ifndef __RADECISIONLOG_H__
+#define __RADECISIONLOG_H__
+
+#include "G4_Kernel.hpp"
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace vISA
+{
+    class LiveRange;
+
+    //
+    // Compact binary log of the GRF allocation decisions made for one kernel
+    // (-raLog <prefix>), written to <prefix><kernel name>.ralog. Each global
+    // RA iteration records its spill choices with their costs, and the final
+    // GRF assignment is recorded at the end.
+    //
+    // A log can be replayed (-raReplay <prefix>) to skip GRF RA: if the IR
+    // reaching GRF RA has the same fingerprint as in the logged compile and
+    // that compile did not change the IR (no spill, split or remat), the saved
+    // assignment is re-applied as is. This makes RA results reproducible when
+    // tuning heuristics, and lets repeated compiles of a kernel reuse them.
+    //
+    class RADecisionLog
+    {
+    public:
+        explicit RADecisionLog(G4_Kernel& k) : kernel(k) {}
+
+        // Fingerprint of the IR as seen by GRF RA. It does not depend on the
+        // GRF assignment, so it is the same before and after allocation.
+        static uint64_t computeIRHash(G4_Kernel& kernel);
+
+        static std::string getLogFileName(const G4_Kernel& kernel, const char* prefix);
+
+        // Called when GRF RA starts.
+        void begin();
+        void recordIteration(unsigned iterNo, bool success, const std::list<LiveRange*>& spilledLRs);
+        // Called once the GRF assignment is final.
+        void recordAssignment();
+        bool write(const std::string& fileName) const;
+
+        // Re-apply the assignment saved in fileName. Returns false and leaves
+        // the kernel untouched if the log does not match the kernel.
+        static bool replay(G4_Kernel& kernel, const std::string& fileName);
+
+    private:
+        struct SpillRecord
+        {
+            uint32_t declId;
+            float spillCost;
+            uint32_t refCount;
+        };
+        struct IterationRecord
+        {
+            uint32_t iterNo;
+            bool success;
+            std::vector<SpillRecord> spills;
+        };
+        struct Assignment
+        {
+            uint32_t dclIndex;  // position in kernel.Declares
+            uint16_t regNum;
+            uint16_t subRegOff;
+        };
+
+        G4_Kernel& kernel;
+        uint64_t irHash = 0;
+        uint32_t numDclsAtStart = 0;
+        bool replayable = false;
+        std::vector<IterationRecord> iterations;
+        std::vector<Assignment> assignments;
+    };
+}
+#endif // __RADECISIONLOG_H__
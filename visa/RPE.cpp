@@ -32,7 +32,7 @@ namespace vISA
         }
     }
 
-    void RPE::runBB(G4_BB* bb)
+    void RPE::runBB(G4_BB* bb, G4_INST* stopAt)
     {
         G4_Declare* topdcl = nullptr;
         unsigned int id = 0;
@@ -60,6 +60,10 @@ namespace vISA
             auto dst = inst->getDst();
 
             rp[inst] = (uint32_t) regPressure;
+            if (inst == stopAt)
+            {
+                break;
+            }
             LocalLiveRange* LLR = nullptr;
             if (dst && (topdcl = dst->getTopDcl()))
             {
@@ -26,7 +26,9 @@ namespace vISA
         }
 
         void run();
-        void runBB(G4_BB*);
+        // With stopAt, stops at that instruction, leaving getLiveVars() as
+        // the variables live across it.
+        void runBB(G4_BB*, G4_INST* stopAt = nullptr);
         unsigned int getRegisterPressure(G4_INST* inst)
         {
             auto it = rp.find(inst);
@@ -41,6 +43,7 @@ namespace vISA
         }
 
         const LivenessAnalysis* getLiveness() const { return liveAnalysis; }
+        const BitSet& getLiveVars() const { return live; }
 
         void recomputeMaxRP();
 
@@ -14,6 +14,7 @@ SPDX-License-Identifier: MIT
 #include "DebugInfo.h"
 #include "VarSplit.h"
 
+#include <algorithm>
 #include <bitset>
 #include <climits>
 #include <cmath>
@@ -26,7 +27,7 @@ using namespace vISA;
 #define GRAPH_COLOR
 
 PointsToAnalysis::PointsToAnalysis(const DECLARE_LIST &declares, unsigned int numBB) :
-    numBBs(numBB), numAddrs(0), indirectUses(std::make_unique<REGVAR_VECTOR[]>(numBB))
+    numBBs(numBB), numAddrs(0), indirectUses(std::make_unique<RegVarSet[]>(numBB))
 {
     for (auto decl : declares)
     {
@@ -66,6 +67,7 @@ PointsToAnalysis::PointsToAnalysis(const DECLARE_LIST &declares, unsigned int nu
                 decl->getRegVar()->getId() != UNDEFINED_VAL)
             {
                 regVars[decl->getRegVar()->getId()] = decl->getRegVar();
+                regVarIndex[decl->getRegVar()] = decl->getRegVar()->getId();
             }
         }
 
@@ -104,9 +106,9 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
     }
 
     // keep a list of address taken variables
-    std::vector<G4_RegVar*> addrTakenDsts;
-    std::map<G4_RegVar*, G4_RegVar*> addrTakenMapping;
-    std::vector<G4_RegVar*> addrTakenVariables;
+    std::unordered_set<G4_RegVar*> addrTakenDsts;
+    std::unordered_map<G4_RegVar*, G4_RegVar*> addrTakenMapping;
+    RegVarSet addrTakenVariables;
 
     for (G4_BB* bb : fg)
     {
@@ -123,8 +125,8 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
                     if (src != NULL && src->isAddrExp())
                     {
                         addrTakenMapping[ptr->asRegVar()] = src->asAddrExp()->getRegVar();
-                        addrTakenDsts.push_back(ptr->asRegVar());
-                        addrTakenVariables.push_back(src->asAddrExp()->getRegVar());
+                        addrTakenDsts.insert(ptr->asRegVar());
+                        addrTakenVariables.insert(src->asAddrExp()->getRegVar());
                     }
                 }
             }
@@ -198,9 +200,9 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
                                         DEBUG_MSG("unexpected addr move for pointer analysis:\n");
                                         DEBUG_EMIT(inst);
                                         DEBUG_MSG("\n");
-                                        for (int i = 0, size = (int)addrTakenVariables.size(); i < size; i++)
+                                        for (G4_RegVar* addrTakenVar : addrTakenVariables.getVars())
                                         {
-                                            addToPointsToSet(ptr->asRegVar(), addrTakenVariables[i]);
+                                            addToPointsToSet(ptr->asRegVar(), addrTakenVar);
                                         }
                                     }
                                 }
@@ -268,7 +270,7 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
                             DEBUG_MSG("unexpected addr add/mul for pointer analysis:\n");
                             DEBUG_EMIT(inst);
                             DEBUG_MSG("\n")
-                            for (G4_RegVar *addrTakenVar : addrTakenVariables)
+                            for (G4_RegVar *addrTakenVar : addrTakenVariables.getVars())
                             {
                                 addToPointsToSet(ptr->asRegVar(), addrTakenVar);
                             }
@@ -280,7 +282,7 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
                         DEBUG_MSG("unexpected instruction with address destination:\n");
                         DEBUG_EMIT(inst);
                         DEBUG_MSG("\n");
-                        for (G4_RegVar *addrTakenVar : addrTakenVariables)
+                        for (G4_RegVar *addrTakenVar : addrTakenVariables.getVars())
                         {
                             addToPointsToSet(ptr->asRegVar(), addrTakenVar);
                         }
@@ -294,10 +296,9 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
                         G4_VarBase* srcPtr = (src && src->isSrcRegRegion()) ? src->asSrcRegRegion()->getBase() : nullptr;
                         if (srcPtr != nullptr && srcPtr->isRegVar())
                         {
-                            std::vector<G4_RegVar*>::iterator addrDst = std::find(addrTakenDsts.begin(), addrTakenDsts.end(), srcPtr->asRegVar());
-                            if (addrDst != addrTakenDsts.end())
+                            if (addrTakenDsts.count(srcPtr->asRegVar()))
                             {
-                                addrTakenDsts.push_back(ptr->asRegVar());
+                                addrTakenDsts.insert(ptr->asRegVar());
                                 addrTakenMapping[ptr->asRegVar()] = addrTakenMapping[srcPtr->asRegVar()];
                             }
                         }
@@ -312,7 +313,7 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
     for (unsigned int i = 0; i < numAddrs; i++)
     {
         DEBUG_VERBOSE("Addr " << i);
-        for (G4_RegVar *grf : pointsToSets[addrPointsToSetIndex[i]])
+        for (G4_RegVar *grf : pointsToSets[getPointsToSetIndex(i)].getVars())
         {
             DEBUG_EMIT(grf);
             DEBUG_VERBOSE("\t");
@@ -363,7 +364,7 @@ void PointsToAnalysis::doPointsToAnalysis(FlowGraph& fg)
 #ifndef NDEBUG
     for (unsigned i = 0; i < numAddrs; i++)
     {
-        REGVAR_VECTOR& vec = pointsToSets[addrPointsToSetIndex[i]];
+        const REGVAR_VECTOR& vec = pointsToSets[getPointsToSetIndex(i)].getVars();
         for (const G4_RegVar* cur : vec)
         {
             unsigned indirectVarSize = cur->getDeclare()->getByteSize();
@@ -884,7 +885,7 @@ void LivenessAnalysis::detectNeverDefinedVarRows()
 // uses of reg vars are anticipated, which tell use the uses of reg vars.Def and Use vectors encapsulate the liveness
 // of reg vars.
 //
-void LivenessAnalysis::computeLiveness()
+void LivenessAnalysis::computeLiveness(LivenessHistory* history)
 {
     //
     // no reg var is selected, then no need to compute liveness
@@ -1043,10 +1044,21 @@ void LivenessAnalysis::computeLiveness()
     if (performIPA())
     {
         hierarchicalIPA(inputDefs, outputUses);
+        if (history)
+        {
+            history->clear();
+        }
         stopTimer(TimerID::LIVENESS);
         return;
     }
 
+    std::vector<BitSet> localDef;
+    if (history)
+    {
+        localDef = def_out;
+        seedFromHistory(*history, inputDefs, outputUses);
+    }
+
 
     if (fg.getKernel()->getInt32KernelAttr(Attributes::ATTR_Target) == VISA_3D &&
         (selectedRF & G4_GRF || selectedRF & G4_FLAG) &&
@@ -1065,6 +1077,20 @@ void LivenessAnalysis::computeLiveness()
 #endif
     }
 
+    if (fg.builder->getOption(vISA_LivenessWorklist))
+    {
+        std::vector<G4_BB*> postOrder = computePostOrder();
+        solveUseWorklist(postOrder);
+        def_in[fg.getEntryBB()->getId()] = inputDefs;
+        solveDefWorklist(postOrder);
+        if (history)
+        {
+            recordHistory(*history, inputDefs, outputUses, localDef);
+        }
+        stopTimer(TimerID::LIVENESS);
+        return;
+    }
+
     //
     // backward flow analysis to propagate uses (locate last uses)
     //
@@ -1073,6 +1099,7 @@ void LivenessAnalysis::computeLiveness()
 
     while (change)
     {
+        numUseVisits += numBBId;
         change = false;
         BB_LIST::iterator rit = fg.end();
         do
@@ -1103,6 +1130,7 @@ void LivenessAnalysis::computeLiveness()
     while (change)
     {
         change = false;
+        numDefVisits += numBBId;
         for (auto bb : fg)
         {
             //
@@ -1116,6 +1144,11 @@ void LivenessAnalysis::computeLiveness()
         }
     }
 
+    if (history)
+    {
+        recordHistory(*history, inputDefs, outputUses, localDef);
+    }
+
 #if 0
     // debug code to compare old v. new IPA
     {
@@ -2233,25 +2266,358 @@ bool LivenessAnalysis::contextFreeUseAnalyze(G4_BB* bb, bool isChanged)
     }
     else
     {
-        BitSet old = use_out[bbid];
+        changed = false;
         for (auto succBB : bb->Succs)
         {
-            use_out[bbid] |= use_in[succBB->getId()];
+            changed |= use_out[bbid].unionChanged(use_in[succBB->getId()]);
         }
-
-        changed = (old != use_out[bbid]);
     }
 
     //
     // in = gen + (out - kill)
     //
-    use_in[bbid] = use_out[bbid];
-    use_in[bbid] -= use_kill[bbid];
-    use_in[bbid] |= use_gen[bbid];
+    use_in[bbid].assignUnionDiff(use_gen[bbid], use_out[bbid], use_kill[bbid]);
 
     return changed;
 }
 
+//
+// Post order of all BBs: the entry BB's DFS first, then the DFS of any BB not
+// reached from it (e.g., subroutine entries) in layout order.
+//
+std::vector<G4_BB*> LivenessAnalysis::computePostOrder() const
+{
+    std::vector<G4_BB*> postOrder;
+    postOrder.reserve(numBBId);
+    std::vector<bool> visited(numBBId, false);
+    std::vector<std::pair<G4_BB*, BB_LIST_ITER>> stack;
+
+    auto dfs = [&](G4_BB* root)
+    {
+        if (visited[root->getId()])
+        {
+            return;
+        }
+        visited[root->getId()] = true;
+        stack.emplace_back(root, root->Succs.begin());
+        while (!stack.empty())
+        {
+            G4_BB* bb = stack.back().first;
+            BB_LIST_ITER& it = stack.back().second;
+            if (it == bb->Succs.end())
+            {
+                postOrder.push_back(bb);
+                stack.pop_back();
+                continue;
+            }
+            G4_BB* succ = *it++;
+            if (!visited[succ->getId()])
+            {
+                visited[succ->getId()] = true;
+                stack.emplace_back(succ, succ->Succs.begin());
+            }
+        }
+    };
+
+    dfs(fg.getEntryBB());
+    for (auto bb : fg)
+    {
+        dfs(bb);
+    }
+    return postOrder;
+}
+
+//
+// Worklist version of the backward use analysis. BBs are visited in post
+// order (successors first), and a BB is only revisited when the use_in of
+// one of its successors has changed.
+//
+void LivenessAnalysis::solveUseWorklist(const std::vector<G4_BB*>& postOrder)
+{
+    std::vector<bool> pending(numBBId, true);
+    std::vector<bool> visited(numBBId, false);
+    unsigned numPending = numBBId;
+
+    while (numPending > 0)
+    {
+        for (auto bb : postOrder)
+        {
+            unsigned bbid = bb->getId();
+            if (!pending[bbid])
+            {
+                continue;
+            }
+            pending[bbid] = false;
+            --numPending;
+            ++numUseVisits;
+
+            bool changed = false;
+            for (auto succBB : bb->Succs)
+            {
+                changed |= use_out[bbid].unionChanged(use_in[succBB->getId()]);
+            }
+
+            // use_in only has to be recomputed (and propagated) when use_out has changed,
+            // except on the first visit where it still holds its initial value
+            if (changed || !visited[bbid])
+            {
+                visited[bbid] = true;
+                use_in[bbid].assignUnionDiff(use_gen[bbid], use_out[bbid], use_kill[bbid]);
+                for (auto predBB : bb->Preds)
+                {
+                    if (!pending[predBB->getId()])
+                    {
+                        pending[predBB->getId()] = true;
+                        ++numPending;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+// Worklist version of the forward def analysis. BBs are visited in reverse
+// post order (predecessors first), and a BB is only revisited when the
+// def_out of one of its predecessors has changed.
+//
+void LivenessAnalysis::solveDefWorklist(const std::vector<G4_BB*>& postOrder)
+{
+    std::vector<bool> pending(numBBId, true);
+    unsigned numPending = numBBId;
+
+    while (numPending > 0)
+    {
+        for (auto rit = postOrder.rbegin(), rend = postOrder.rend(); rit != rend; ++rit)
+        {
+            G4_BB* bb = *rit;
+            unsigned bbid = bb->getId();
+            if (!pending[bbid])
+            {
+                continue;
+            }
+            pending[bbid] = false;
+            --numPending;
+            ++numDefVisits;
+
+            for (auto predBB : bb->Preds)
+            {
+                def_in[bbid] |= def_out[predBB->getId()];
+            }
+
+            if (def_out[bbid].unionChanged(def_in[bbid]))
+            {
+                for (auto succBB : bb->Succs)
+                {
+                    if (!pending[succBB->getId()])
+                    {
+                        pending[succBB->getId()] = true;
+                        ++numPending;
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+// A run of consecutive var ids that keep their relative order between
+// the recorded and the current liveness.
+//
+struct VarIdRun
+{
+    unsigned oldStart;
+    unsigned newStart;
+    unsigned len;
+};
+
+// copy len bits of src starting at srcStart to dst starting at dstStart,
+// dst bits in the range are expected to be clear
+static void copyBitRange(const BitSet& src, unsigned srcStart, BitSet& dst, unsigned dstStart, unsigned len)
+{
+    while (len > 0)
+    {
+        unsigned dstElt = dstStart / NUM_BITS_PER_ELT;
+        unsigned dstShift = dstStart % NUM_BITS_PER_ELT;
+        if ((dstElt + 1) * NUM_BITS_PER_ELT > dst.getSize())
+        {
+            // setElt() would grow dst, so the last partial element is copied bit by bit
+            for (unsigned i = 0; i < len; i++)
+            {
+                dst.set(dstStart + i, src.isSet(srcStart + i));
+            }
+            return;
+        }
+
+        unsigned n = std::min(len, (unsigned) NUM_BITS_PER_ELT - dstShift);
+        unsigned srcElt = srcStart / NUM_BITS_PER_ELT;
+        unsigned srcShift = srcStart % NUM_BITS_PER_ELT;
+        BITSET_ARRAY_TYPE bits = src.getElt(srcElt) >> srcShift;
+        if (srcShift != 0 && srcShift + n > NUM_BITS_PER_ELT)
+        {
+            bits |= src.getElt(srcElt + 1) << (NUM_BITS_PER_ELT - srcShift);
+        }
+        if (n < NUM_BITS_PER_ELT)
+        {
+            bits &= BIT(n) - 1;
+        }
+        dst.setElt(dstElt, bits << dstShift);
+
+        srcStart += n;
+        dstStart += n;
+        len -= n;
+    }
+}
+
+static BitSet remapBits(const BitSet& src, unsigned size, const std::vector<VarIdRun>& runs)
+{
+    BitSet dst(size, false);
+    for (auto& run : runs)
+    {
+        copyBitRange(src, run.oldStart, dst, run.newStart, run.len);
+    }
+    return dst;
+}
+
+//
+// Liveness is solved independently for each variable, so a variable whose
+// gen/kill sets are unchanged in every BB (and the CFG is unchanged) has the
+// same solution as in the recorded run. Seed use_in/use_out/def_in/def_out
+// with it; the data flow then starts at the fixed point for those variables
+// and only the remaining ones (e.g., spilled variables and new spill/fill
+// temps) need to propagate.
+//
+void LivenessAnalysis::seedFromHistory(
+    const LivenessHistory& history, const BitSet& inputDefs, const BitSet& outputUses)
+{
+    numSeededVarId = 0;
+    if (history.empty() || history.succs.size() != numBBId)
+    {
+        return;
+    }
+
+    for (auto bb : fg)
+    {
+        const std::vector<unsigned>& succs = history.succs[bb->getId()];
+        if (succs.size() != bb->Succs.size() ||
+            !std::equal(succs.begin(), succs.end(), bb->Succs.begin(),
+                [](unsigned id, const G4_BB* succ) { return id == succ->getId(); }))
+        {
+            return;
+        }
+    }
+
+    std::unordered_map<const G4_Declare*, unsigned> oldIds;
+    for (unsigned i = 0, size = (unsigned) history.vars.size(); i < size; i++)
+    {
+        oldIds[history.vars[i]] = i;
+    }
+
+    std::vector<VarIdRun> runs;
+    BitSet seeded(numVarId, false);
+    for (unsigned i = 0; i < numVarId; i++)
+    {
+        auto it = oldIds.find(vars[i]->getDeclare());
+        if (it == oldIds.end())
+        {
+            continue;
+        }
+        unsigned oldId = it->second;
+        if (!runs.empty() &&
+            runs.back().oldStart + runs.back().len == oldId &&
+            runs.back().newStart + runs.back().len == i)
+        {
+            runs.back().len++;
+        }
+        else
+        {
+            runs.push_back({ oldId, i, 1 });
+        }
+        seeded.set(i, true);
+    }
+
+    if (runs.empty())
+    {
+        return;
+    }
+
+    // exclude variables whose data flow equations differ from the recorded ones
+    BitSet changed(numVarId, false);
+    auto markChanged = [&](const BitSet& oldSet, const BitSet& newSet)
+    {
+        BitSet remapped = remapBits(oldSet, numVarId, runs);
+        BitSet diff = remapped;
+        diff -= newSet;
+        changed |= diff;
+        diff = newSet;
+        diff -= remapped;
+        changed |= diff;
+    };
+
+    markChanged(history.inputDefs, inputDefs);
+    markChanged(history.outputUses, outputUses);
+    for (unsigned i = 0; i < numBBId; i++)
+    {
+        markChanged(history.use_gen[i], use_gen[i]);
+        markChanged(history.use_kill[i], use_kill[i]);
+        markChanged(history.local_def[i], def_out[i]);
+    }
+    seeded -= changed;
+
+    for (unsigned i = 0; i < numBBId; i++)
+    {
+        auto seed = [&](const BitSet& oldSet, BitSet& newSet)
+        {
+            BitSet remapped = remapBits(oldSet, numVarId, runs);
+            remapped &= seeded;
+            newSet |= remapped;
+        };
+        seed(history.use_in[i], use_in[i]);
+        seed(history.use_out[i], use_out[i]);
+        seed(history.def_in[i], def_in[i]);
+        seed(history.def_out[i], def_out[i]);
+    }
+
+    for (unsigned i = 0; i < numVarId; i++)
+    {
+        if (seeded.isSet(i))
+        {
+            numSeededVarId++;
+        }
+    }
+}
+
+void LivenessAnalysis::recordHistory(LivenessHistory& history, const BitSet& inputDefs, const BitSet& outputUses,
+    std::vector<BitSet>& localDef) const
+{
+    history.vars.resize(numVarId);
+    for (unsigned i = 0; i < numVarId; i++)
+    {
+        history.vars[i] = vars[i]->getDeclare();
+    }
+
+    history.succs.resize(numBBId);
+    for (auto bb : fg)
+    {
+        auto& succs = history.succs[bb->getId()];
+        succs.clear();
+        for (auto succ : bb->Succs)
+        {
+            succs.push_back(succ->getId());
+        }
+    }
+
+    history.inputDefs = inputDefs;
+    history.outputUses = outputUses;
+    history.use_gen = use_gen;
+    history.use_kill = use_kill;
+    history.local_def.swap(localDef);
+    history.def_in = def_in;
+    history.def_out = def_out;
+    history.use_in = use_in;
+    history.use_out = use_out;
+}
+
 //
 // def_in = def_out(p1) + def_out(p2) + ... where p1 p2 ... are the predecessors of bb
 // def_out |= def_in
@@ -2276,12 +2642,10 @@ bool LivenessAnalysis::contextFreeDefAnalyze(G4_BB* bb, bool isChanged)
     }
     else
     {
-        BitSet old = def_in[bbid];
         for (auto predBB : bb->Preds)
         {
-            def_in[bbid] |= def_out[predBB->getId()];
+            changed |= def_in[bbid].unionChanged(def_out[predBB->getId()]);
         }
-        changed = (old != def_in[bbid]);
     }
 
      def_out[bb->getId()] |= def_in[bb->getId()];
@@ -2739,6 +3103,7 @@ void GlobalRA::resetGlobalRAStates()
             setBankConflict(dcl, BANK_CONFLICT_NONE);
         }
         clearBundleConflictDcl(dcl);
+        clearBankConflictDcl(dcl);
     }
 
     return;
@@ -3577,6 +3942,17 @@ int regAlloc(IR_Builder& builder, PhyRegPool& regPool, G4_Kernel& kernel)
         return status;
     }
 
+    if (gra.raLog)
+    {
+        gra.raLog->recordAssignment();
+        gra.raLog->write(RADecisionLog::getLogFileName(kernel, builder.getOptions()->getOptionCstr(vISA_RALog)));
+    }
+
+    if (gra.pressureReport)
+    {
+        gra.pressureReport->write(PressureReport::getReportFileName(kernel));
+    }
+
     if (auto sp = kernel.getVarSplitPass())
     {
         sp->replaceIntrinsics();
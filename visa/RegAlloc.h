@@ -10,6 +10,8 @@ SPDX-License-Identifier: MIT
 #define _REGALLOC_H_
 #include "PhyRegUsage.h"
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "BitSet.h"
@@ -53,6 +55,51 @@ typedef std::vector<vISA::G4_RegVar*> REGVAR_VECTOR;
  */
 namespace vISA
 {
+// A set of RegVars that keeps the insertion order for iteration, with a hash
+// index for membership tests.
+class RegVarSet
+{
+    REGVAR_VECTOR vars;
+    std::unordered_set<const G4_RegVar*> members;
+
+public:
+    bool insert(G4_RegVar* var)
+    {
+        if (!members.insert(var).second)
+        {
+            return false;
+        }
+        vars.push_back(var);
+        return true;
+    }
+
+    bool contains(const G4_RegVar* var) const { return members.count(var) != 0; }
+
+    // Remove the first var with the given id.
+    bool eraseById(unsigned id)
+    {
+        for (auto it = vars.begin(); it != vars.end(); ++it)
+        {
+            if ((*it)->getId() == id)
+            {
+                members.erase(*it);
+                vars.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear()
+    {
+        vars.clear();
+        members.clear();
+    }
+
+    size_t size() const { return vars.size(); }
+    const REGVAR_VECTOR& getVars() const { return vars; }
+};
+
 class PointsToAnalysis
 {
 private:
@@ -60,13 +107,16 @@ private:
     unsigned int numAddrs;
 
     // keeps track of the indirect variables used in each BB
-    const std::unique_ptr<REGVAR_VECTOR[]> indirectUses;
-    // vector of points-to set for each address variable
-    std::vector<REGVAR_VECTOR> pointsToSets;
-    // index of an address's points-to set in the pointsToSets vector
+    const std::unique_ptr<RegVarSet[]> indirectUses;
+    // points-to sets, indexed by the representative address of each set
+    std::vector<RegVarSet> pointsToSets;
+    // union-find parent of each address; addresses whose points-to sets are
+    // merged share the set of their representative
     std::vector<unsigned> addrPointsToSetIndex;
     // original regvar ptrs
     REGVAR_VECTOR regVars;
+    // index of each regvar in regVars
+    std::unordered_map<const G4_RegVar*, unsigned> regVarIndex;
 
     void resizePointsToSet(unsigned int newsize)
     {
@@ -84,11 +134,31 @@ private:
         numAddrs = newsize;
     }
 
+    unsigned getPointsToSetIndex(unsigned addrId) const
+    {
+        while (addrPointsToSetIndex[addrId] != addrId)
+        {
+            addrId = addrPointsToSetIndex[addrId];
+        }
+        return addrId;
+    }
+
+    unsigned findPointsToSetIndex(unsigned addrId)
+    {
+        // path halving
+        while (addrPointsToSetIndex[addrId] != addrId)
+        {
+            addrPointsToSetIndex[addrId] = addrPointsToSetIndex[addrPointsToSetIndex[addrId]];
+            addrId = addrPointsToSetIndex[addrId];
+        }
+        return addrId;
+    }
+
     void addPointsToSetToBB(int bbId, const G4_RegVar* addr)
     {
         MUST_BE_TRUE(addr->getDeclare()->getRegFile() == G4_ADDRESS,
             "expect address variable");
-        const REGVAR_VECTOR& addrTakens = pointsToSets[addrPointsToSetIndex[addr->getId()]];
+        const REGVAR_VECTOR& addrTakens = pointsToSets[findPointsToSetIndex(addr->getId())].getVars();
         for (G4_RegVar* addrTaken : addrTakens)
         {
             addIndirectUseToBB(bbId, addrTaken);
@@ -98,12 +168,7 @@ private:
     void addIndirectUseToBB(unsigned int bbId, G4_RegVar* var)
     {
         MUST_BE_TRUE(bbId < numBBs, "invalid basic block id");
-        REGVAR_VECTOR& vec = indirectUses[bbId];
-        bool isPresent = std::find(vec.begin(), vec.end(), var) != vec.end();
-        if (!isPresent)
-        {
-            vec.push_back(var);
-        }
+        indirectUses[bbId].insert(var);
     }
 
     void addToPointsToSet(const G4_RegVar* addr, G4_RegVar* var)
@@ -111,32 +176,37 @@ private:
         MUST_BE_TRUE(addr->getDeclare()->getRegFile() == G4_ADDRESS,
             "expect address variable");
         MUST_BE_TRUE(addr->getId() < numAddrs, "addr id is not set");
-        int addrPTIndex = addrPointsToSetIndex[addr->getId()];
-        REGVAR_VECTOR& vec = pointsToSets[addrPTIndex];
-        bool isPresent = std::find(vec.begin(), vec.end(), var) != vec.end();
-        if (!isPresent)
+        if (pointsToSets[findPointsToSetIndex(addr->getId())].insert(var))
         {
-            vec.push_back(var);
             DEBUG_VERBOSE("Addr " << addr->getId() << " <-- " << var->getDeclare()->getName() << "\n");
         }
     }
 
-    // Merge addr2's points-to set into addr1's
-    // basically we copy the content of addr2's points-to to addr1,
-    // and have addr2 point to addr1's points-to set
+    // Merge the points-to sets of addr1 and addr2; both addresses share the
+    // resulting set, as do all addresses previously merged with either one.
     void mergePointsToSet(const G4_RegVar* addr1, const G4_RegVar* addr2)
     {
          MUST_BE_TRUE(addr1->getDeclare()->getRegFile() == G4_ADDRESS &&
              addr2->getDeclare()->getRegFile() == G4_ADDRESS,
              "expect address variable");
-         int addr2PTIndex = addrPointsToSetIndex[addr2->getId()];
-         REGVAR_VECTOR& vec = pointsToSets[addr2PTIndex];
-         for (G4_RegVar* regVar : vec)
+         unsigned addr1PTIndex = findPointsToSetIndex(addr1->getId());
+         unsigned addr2PTIndex = findPointsToSetIndex(addr2->getId());
+         if (addr1PTIndex == addr2PTIndex)
          {
-             addToPointsToSet(addr1, regVar);
+             return;
          }
-         int addr1PTIndex = addrPointsToSetIndex[addr1->getId()];
-         addrPointsToSetIndex[addr2->getId()] = addr1PTIndex;
+         // move the smaller set into the larger one
+         if (pointsToSets[addr1PTIndex].size() < pointsToSets[addr2PTIndex].size())
+         {
+             std::swap(addr1PTIndex, addr2PTIndex);
+         }
+         RegVarSet& toSet = pointsToSets[addr1PTIndex];
+         for (G4_RegVar* regVar : pointsToSets[addr2PTIndex].getVars())
+         {
+             toSet.insert(regVar);
+         }
+         pointsToSets[addr2PTIndex].clear();
+         addrPointsToSetIndex[addr2PTIndex] = addr1PTIndex;
          DEBUG_VERBOSE("merge Addr " << addr1->getId() << " with Addr " << addr2->getId());
     }
 
@@ -146,8 +216,8 @@ private:
         // found. This function is useful when regvar ids
         // are reset.
 
-        const auto it = std::find(regVars.begin(), regVars.end(), r);
-        return it == regVars.end() ? UINT_MAX : static_cast<unsigned int>(it - regVars.begin());
+        const auto it = regVarIndex.find(r);
+        return it == regVarIndex.end() ? UINT_MAX : it->second;
     }
 
 public:
@@ -158,7 +228,7 @@ public:
     const REGVAR_VECTOR& getIndrUseVectorForBB(unsigned int bbId) const
     {
         MUST_BE_TRUE(bbId < numBBs, "invalid basic block id");
-        return indirectUses[bbId];
+        return indirectUses[bbId].getVars();
     }
 
     // Following methods were added to support address taken spill/fill
@@ -174,6 +244,7 @@ public:
             resizePointsToSet(numAddrs + 1);
 
         regVars.push_back(addr2);
+        regVarIndex[addr2] = numAddrs - 1;
 
         mergePointsToSet(addr1, addr2);
         addr2->setId(oldid);
@@ -188,7 +259,7 @@ public:
         if (id == UINT_MAX)
             return nullptr;
 
-        const REGVAR_VECTOR* vec = &pointsToSets[addrPointsToSetIndex[id]];
+        const REGVAR_VECTOR* vec = &pointsToSets[getPointsToSetIndex(id)].getVars();
 
         return vec;
     }
@@ -212,7 +283,7 @@ public:
         if (id == UINT_MAX)
             return NULL;
 
-        const REGVAR_VECTOR& vec = pointsToSets[addrPointsToSetIndex[id]];
+        const REGVAR_VECTOR& vec = pointsToSets[getPointsToSetIndex(id)].getVars();
 
         if (idx < (int)vec.size())
             return vec[idx];
@@ -229,8 +300,12 @@ public:
         if (id == UINT_MAX)
             return false;
 
-        const REGVAR_VECTOR& vec = pointsToSets[addrPointsToSetIndex[id]];
-        for (const G4_RegVar* pointsTo : vec)
+        const RegVarSet& pointsToSet = pointsToSets[getPointsToSetIndex(id)];
+        if (pointsToSet.contains(var))
+        {
+            return true;
+        }
+        for (const G4_RegVar* pointsTo : pointsToSet.getVars())
         {
             if (pointsTo->getId() == var->getId())
             {
@@ -253,8 +328,7 @@ public:
             MUST_BE_TRUE(false, "Could not find addr in points to set");
         }
 
-        REGVAR_VECTOR& vec = pointsToSets[addrPointsToSetIndex[id]];
-        vec.push_back(newvar);
+        pointsToSets[findPointsToSetIndex(id)].insert(newvar);
 
         addIndirectUseToBB(bbid, newvar);
     }
@@ -270,22 +344,7 @@ public:
             MUST_BE_TRUE(false, "Could not find addr in points to set");
         }
 
-        REGVAR_VECTOR& vec = pointsToSets[addrPointsToSetIndex[id]];
-        bool removed = false;
-
-        for (REGVAR_VECTOR::iterator it = vec.begin();
-            it != vec.end();
-            it++)
-        {
-            G4_RegVar* cur = (*it);
-
-            if (cur->getId() == vartoremove->getId())
-            {
-                vec.erase(it);
-                removed = true;
-                break;
-            }
-        }
+        bool removed = pointsToSets[findPointsToSetIndex(id)].eraseById(vartoremove->getId());
 
         MUST_BE_TRUE(removed == true, "Could not find spilled ref from points to");
 
@@ -296,20 +355,7 @@ public:
         // constructing liveness sets before RA.
         for (unsigned int i = 0; i < numBBs; i++)
         {
-            REGVAR_VECTOR& vec = indirectUses[i];
-
-            for (REGVAR_VECTOR::iterator it = vec.begin();
-                it != vec.end();
-                it++)
-            {
-                G4_RegVar* cur = (*it);
-
-                if (cur->getId() == vartoremove->getId())
-                {
-                    vec.erase(it);
-                    break;
-                }
-            }
+            indirectUses[i].eraseById(vartoremove->getId());
         }
     }
 };
@@ -331,6 +377,41 @@ struct VarRangeListPackage
     VAR_RANGE_LIST list;
 };
 
+//
+// Liveness solution of a previous run of LivenessAnalysis, kept across the
+// iterations of the global RA loop. Variables whose gen/kill sets are the same
+// in every BB as in the recorded run have the same solution, so it is used to
+// seed the data flow instead of recomputing it from scratch.
+//
+struct LivenessHistory
+{
+    std::vector<G4_Declare*> vars;               // declare of each recorded var id
+    std::vector<std::vector<unsigned>> succs;    // successor ids of each BB
+    BitSet inputDefs;
+    BitSet outputUses;
+    std::vector<BitSet> use_gen;
+    std::vector<BitSet> use_kill;
+    std::vector<BitSet> local_def;               // def_out before the forward flow
+    std::vector<BitSet> def_in;
+    std::vector<BitSet> def_out;
+    std::vector<BitSet> use_in;
+    std::vector<BitSet> use_out;
+
+    bool empty() const { return vars.empty(); }
+    void clear()
+    {
+        vars.clear();
+        succs.clear();
+        use_gen.clear();
+        use_kill.clear();
+        local_def.clear();
+        def_in.clear();
+        def_out.clear();
+        use_in.clear();
+        use_out.clear();
+    }
+};
+
 class LivenessAnalysis
 {
     unsigned numVarId = 0;         // the var count
@@ -341,6 +422,9 @@ class LivenessAnalysis
     unsigned numAddrId = 0;     // the addr count
     unsigned numBBId = 0;          // the block count
     unsigned numFnId = 0;          // the function count
+    unsigned numSeededVarId = 0;   // the var count seeded from LivenessHistory
+    unsigned numUseVisits = 0;     // BB visits of the backward use analysis
+    unsigned numDefVisits = 0;     // BB visits of the forward def analysis
     const unsigned char selectedRF = 0;  // the selected reg file kind for performing liveness
     const PointsToAnalysis& pointsToAnalysis;
     std::unordered_map<G4_Declare*, BitSet> neverDefinedRows;
@@ -355,6 +439,13 @@ class LivenessAnalysis
 
     bool contextFreeUseAnalyze(G4_BB* bb, bool isChanged);
     bool contextFreeDefAnalyze(G4_BB* bb, bool isChanged);
+    std::vector<G4_BB*> computePostOrder() const;
+    void solveUseWorklist(const std::vector<G4_BB*>& postOrder);
+    void solveDefWorklist(const std::vector<G4_BB*>& postOrder);
+
+    void seedFromHistory(const LivenessHistory& history, const BitSet& inputDefs, const BitSet& outputUses);
+    void recordHistory(LivenessHistory& history, const BitSet& inputDefs, const BitSet& outputUses,
+        std::vector<BitSet>& localDef) const;
 
     bool livenessCandidate(const G4_Declare* decl, bool verifyRA) const;
 
@@ -391,7 +482,7 @@ public:
     bool setVarIDs(bool verifyRA, bool areAllPhyRegAssigned);
     LivenessAnalysis(GlobalRA& gra, unsigned char kind, bool verifyRA = false, bool forceRun = false);
     ~LivenessAnalysis();
-    void computeLiveness();
+    void computeLiveness(LivenessHistory* history = nullptr);
     bool isLiveAtEntry(const G4_BB* bb, unsigned var_id) const;
     bool isUseThrough(const G4_BB* bb, unsigned var_id) const;
     bool isDefThrough(const G4_BB* bb, unsigned var_id) const;
@@ -411,6 +502,9 @@ public:
     unsigned getNumSplitVar() const {return numSplitVar;}
     unsigned getNumSplitStartID() const {return numSplitStartID;}
     unsigned getNumUnassignedVar() const {return numUnassignedVarId;}
+    unsigned getNumSeededVar() const { return numSeededVarId; }
+    unsigned getNumUseVisits() const { return numUseVisits; }
+    unsigned getNumDefVisits() const { return numDefVisits; }
     void dump() const;
     void dumpBB(G4_BB* bb) const;
     void dumpLive(BitSet& live) const;
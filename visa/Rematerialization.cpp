@@ -940,20 +940,15 @@ namespace vISA
 
         if (!isSampler)
         {
-            unsigned int diffBound = dst->getRightBound() - (dst->getRegOff() * numEltPerGRF<Type_UB>());
-            unsigned numElems = (diffBound + 1) / dst->getTypeSize();
-            auto newTemp = kernel.fg.builder->createTempVar(numElems, dst->getType(), Any, "REMAT_");
-            newTemp->copyAlign(dst->getTopDcl());
-            gra.copyAlignment(newTemp, dst->getTopDcl());
-            G4_DstRegRegion* newDst = kernel.fg.builder->createDst(newTemp->getRegVar(), 0,
-                (dst->getLeftBound() % numEltPerGRF<Type_UB>()) / dst->getTypeSize(),
-                dst->getHorzStride(), dst->getType());
-            G4_INST* dupOp = dstInst->cloneInst();
-            dupOp->setDest(newDst);
-            dupOp->inheritDIFrom(dstInst);
+            G4_Declare* newTemp = nullptr;
+            G4_INST* dupOp = cloneWithNewDst(dstInst, newTemp);
 
             rematSrc = createSrcRgn(src, dst, newTemp);
 
+            // Spilled sources of a scalar computation need not be filled if
+            // the computation producing them can be rematerialized as well.
+            rematerializeChainSrcs(dupOp, bb, src->getInst()->getLexicalId(), 1, newInst);
+
             newInst.push_back(dupOp);
 
             cacheInst = newInst.back();
@@ -1067,6 +1062,177 @@ namespace vISA
         return rematSrc;
     }
 
+    G4_INST* Rematerialization::cloneWithNewDst(G4_INST* defInst, G4_Declare*& newTemp)
+    {
+        auto dst = defInst->getDst();
+        unsigned int diffBound = dst->getRightBound() - (dst->getRegOff() * numEltPerGRF<Type_UB>());
+        unsigned numElems = (diffBound + 1) / dst->getTypeSize();
+        newTemp = kernel.fg.builder->createTempVar(numElems, dst->getType(), Any, "REMAT_");
+        newTemp->copyAlign(dst->getTopDcl());
+        gra.copyAlignment(newTemp, dst->getTopDcl());
+        G4_DstRegRegion* newDst = kernel.fg.builder->createDst(newTemp->getRegVar(), 0,
+            (dst->getLeftBound() % numEltPerGRF<Type_UB>()) / dst->getTypeSize(),
+            dst->getHorzStride(), dst->getType());
+        G4_INST* dupOp = defInst->cloneInst();
+        dupOp->setDest(newDst);
+        dupOp->inheritDIFrom(defInst);
+        return dupOp;
+    }
+
+    // Cheap scalar ALU operations typically used to compute addresses, offsets
+    // and message descriptors.
+    bool Rematerialization::isChainRematOp(G4_INST* inst) const
+    {
+        switch (inst->opcode())
+        {
+        case G4_mov:
+        case G4_add:
+        case G4_mul:
+        case G4_shl:
+        case G4_shr:
+        case G4_asr:
+        case G4_and:
+        case G4_or:
+        case G4_xor:
+            break;
+        default:
+            return false;
+        }
+
+        if (inst->getExecSize() != g4::SIMD1 ||
+            inst->getPredicate() || inst->getCondMod() || inst->getSaturate() ||
+            !inst->getDst() || inst->getDst()->isIndirect() ||
+            !isRematCandidateOp(inst))
+            return false;
+
+        for (unsigned int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+        {
+            auto src = inst->getSrc(i);
+            if (!src || src->isImm())
+                continue;
+            if (!src->isSrcRegRegion() || src->asSrcRegRegion()->isIndirect() ||
+                !src->getBase()->isRegVar())
+                return false;
+        }
+        return true;
+    }
+
+    // Whether the value of src, a source of a rematerialized chain instruction,
+    // is available at useLexId without rematerializing its definition.
+    bool Rematerialization::isChainSrcAvailable(G4_SrcRegRegion* src, G4_BB* bb, unsigned int useLexId, unsigned int depth)
+    {
+        auto topdcl = src->getTopDcl();
+        if (!topdcl || topdcl->getAddressed() ||
+            (topdcl->getRegFile() & (G4_RegFileKind::G4_GRF | G4_RegFileKind::G4_INPUT)) == 0x0 ||
+            (topdcl->getRegVar()->getPhyReg() && !topdcl->isInput()))
+            return false;
+
+        auto opIt = operations.find(topdcl);
+        if (opIt == operations.end())
+            return false;
+        auto& refs = (*opIt).second;
+
+        if (topdcl->isInput())
+        {
+            // Only inputs without an explicit def whose live-range already
+            // extends till the use.
+            return refs.def.empty() && refs.lastUseLexId >= useLexId;
+        }
+
+        if (isRangeSpilled(topdcl))
+        {
+            return depth < MAX_REMAT_CHAIN_DEPTH && canRematerializeChainSrc(src, bb, useLexId, depth + 1);
+        }
+
+        auto srcUniqueDef = findUniqueDef(refs, src);
+        if (!srcUniqueDef || !inSameSubroutine(bb, srcUniqueDef->second))
+            return false;
+
+        // Scalars may be extended, as for the top level remat
+        return liveness.isLiveAtExit(bb, topdcl->getRegVar()->getId()) ||
+            refs.lastUseLexId >= useLexId || topdcl->getNumElems() == 1;
+    }
+
+    const Reference* Rematerialization::canRematerializeChainSrc(
+        G4_SrcRegRegion* src, G4_BB* bb, unsigned int useLexId, unsigned int depth)
+    {
+        auto topdcl = src->getTopDcl();
+        if (!topdcl || !topdcl->getRegVar()->isRegAllocPartaker() ||
+            !isRangeSpilled(topdcl) || topdcl->getSpilledDeclare() ||
+            topdcl->getAddressed() || topdcl->getRegVar()->getPhyReg())
+            return nullptr;
+
+        auto opIt = operations.find(topdcl);
+        if (opIt == operations.end())
+            return nullptr;
+
+        auto& refs = (*opIt).second;
+        auto uniqueDef = findUniqueDef(refs, src);
+        if (!uniqueDef || gra.isNoRemat(uniqueDef->first) ||
+            refs.numUses > MAX_USES_REMAT ||
+            !isChainRematOp(uniqueDef->first) ||
+            uniqueDef->first->getLexicalId() > useLexId ||
+            !inSameSubroutine(bb, uniqueDef->second))
+            return nullptr;
+
+        auto defInst = uniqueDef->first;
+        for (unsigned int i = 0, numSrc = defInst->getNumSrc(); i < numSrc; i++)
+        {
+            auto defSrc = defInst->getSrc(i);
+            if (!defSrc || defSrc->isImm())
+                continue;
+            if (!isChainSrcAvailable(defSrc->asSrcRegRegion(), bb, useLexId, depth))
+                return nullptr;
+        }
+        return uniqueDef;
+    }
+
+    // Replace spilled sources of inst, a rematerialized instruction, by
+    // rematerializing their definitions as well. New instructions are appended
+    // to newInst in def-before-use order.
+    void Rematerialization::rematerializeChainSrcs(
+        G4_INST* inst, G4_BB* bb, unsigned int useLexId, unsigned int depth, std::list<G4_INST*>& newInst)
+    {
+        if (inst->getExecSize() != g4::SIMD1 || depth > MAX_REMAT_CHAIN_DEPTH)
+            return;
+
+        for (unsigned int i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+        {
+            auto src = inst->getSrc(i);
+            if (!src || !src->isSrcRegRegion())
+                continue;
+
+            auto srcRgn = src->asSrcRegRegion();
+            auto uniqueDef = canRematerializeChainSrc(srcRgn, bb, useLexId, depth);
+            if (!uniqueDef)
+                continue;
+
+            auto defInst = uniqueDef->first;
+            G4_Declare* newTemp = nullptr;
+            G4_INST* dupOp = cloneWithNewDst(defInst, newTemp);
+            for (unsigned int j = 0, numDefSrc = defInst->getNumSrc(); j < numDefSrc; j++)
+            {
+                auto defSrc = defInst->getSrc(j);
+                if (defSrc && defSrc->isSrcRegRegion())
+                {
+                    incNumRemat(defSrc->asSrcRegRegion()->getTopDcl());
+                }
+            }
+
+            rematerializeChainSrcs(dupOp, bb, useLexId, depth + 1, newInst);
+            newInst.push_back(dupOp);
+
+            if (kernel.getOption(vISA_RATrace))
+            {
+                std::cout << "\t--remat chain (depth " << depth << "): " << srcRgn->getTopDcl()->getName()
+                    << " from $" << defInst->getCISAOff() << "\n";
+            }
+
+            inst->setSrc(createSrcRgn(srcRgn, defInst->getDst(), newTemp), i);
+            reduceNumUses(srcRgn->getTopDcl());
+        }
+    }
+
     G4_SrcRegRegion* Rematerialization::createSrcRgn(G4_SrcRegRegion* srcToRemat, G4_DstRegRegion* uniqueDef, G4_Declare* rematTemp)
     {
         G4_SrcRegRegion* rematSrc = nullptr;
@@ -1234,6 +1400,12 @@ namespace vISA
                                     rematSrc = createSrcRgn(src->asSrcRegRegion(), uniqueDef->first->getDst(),
                                         (*prevRematIt).second.first->getDst()->getTopDcl());
 
+                                    if (kernel.getOption(vISA_RATrace))
+                                    {
+                                        std::cout << "\t--remat reuse: " << src->getTopDcl()->getName() << " in src" << opnd
+                                            << " of $" << inst->getCISAOff() << "\n";
+                                    }
+
                                     reduceNumUses(src->getTopDcl());
 
 #if 0
@@ -1251,6 +1423,11 @@ namespace vISA
                                 printf("Will rematerialize %s in src%d of $%d. Source computation at $%d\n",
                                     src->getTopDcl()->getName(), opnd, inst->getCISAOff(), uniqueDef->first->getCISAOff());
 #endif
+                                if (kernel.getOption(vISA_RATrace))
+                                {
+                                    std::cout << "\t--remat: " << src->getTopDcl()->getName() << " in src" << opnd
+                                        << " of $" << inst->getCISAOff() << " from $" << uniqueDef->first->getCISAOff() << "\n";
+                                }
                                 std::list<G4_INST*> newInsts;
                                 G4_INST* cacheInst = nullptr;
                                 rematSrc = rematerialize(src->asSrcRegRegion(), bb, uniqueDef, newInsts, cacheInst);
@@ -25,6 +25,9 @@ namespace vISA
 
 // Distance in instructions to reuse rematted value in BB
 #define MAX_LOCAL_REMAT_REUSE_DISTANCE 40
+// Max number of instructions rematerialized for a spilled source of a
+// rematerialized instruction, e.g. an add/shl address computation chain
+#define MAX_REMAT_CHAIN_DEPTH 3
 
     typedef std::pair<G4_INST*, G4_BB*> Reference;
     class References
@@ -98,6 +101,11 @@ namespace vISA
         bool canRematerialize(G4_SrcRegRegion*, G4_BB*, const Reference*&, INST_LIST_ITER instIter);
         G4_SrcRegRegion* rematerialize(G4_SrcRegRegion*, G4_BB*, const Reference*, std::list<G4_INST*>&, G4_INST*&);
         G4_SrcRegRegion* createSrcRgn(G4_SrcRegRegion*, G4_DstRegRegion*, G4_Declare*);
+        G4_INST* cloneWithNewDst(G4_INST*, G4_Declare*&);
+        bool isChainRematOp(G4_INST*) const;
+        bool isChainSrcAvailable(G4_SrcRegRegion*, G4_BB*, unsigned int, unsigned int);
+        const Reference* canRematerializeChainSrc(G4_SrcRegRegion*, G4_BB*, unsigned int, unsigned int);
+        void rematerializeChainSrcs(G4_INST*, G4_BB*, unsigned int, unsigned int, std::list<G4_INST*>&);
         const Reference* findUniqueDef(References&, G4_SrcRegRegion*);
         bool areInSameLoop(G4_BB*, G4_BB*, bool&);
         bool isRangeSpilled(G4_Declare*);
@@ -420,7 +420,20 @@ void SpillManager::replaceSpilledPredicate(G4_BB* bb,
     {
         G4_Declare* flagDcl = flagReg->asRegVar()->getDeclare();
         G4_Declare* spDcl = flagDcl->getSpilledDeclare();
-        if (spDcl != NULL)
+        G4_INST* rematInst = flagDcl->isSpilled() ? gra.getFlagRematInst(flagDcl) : nullptr;
+        if (rematInst)
+        {
+            // recompute the flag right before its use
+            G4_Declare* tmpDcl = createNewTempFlagDeclare(flagDcl);
+            G4_INST* cmp = rematInst->cloneInst();
+            cmp->setCondMod(builder.createCondMod(rematInst->getCondMod()->getMod(), tmpDcl->getRegVar(), 0));
+            cmp->setCISAOff(currCISAOffset);
+            bb->insertBefore(it, cmp);
+            G4_Predicate *new_pred = builder.createPredicate(predicate->getState(), tmpDcl->getRegVar(), 0, predicate->getControl());
+            inst->setPredicate(new_pred);
+            ++numFlagRemat;
+        }
+        else if (spDcl != NULL)
         {
             G4_Declare* tmpDcl = createNewTempFlagDeclare(flagDcl);
             genRegMov(bb, it,
@@ -501,6 +514,11 @@ void SpillManager::createSpillLocations(const G4_Kernel& kernel)
         dcl->setSpillFlag();
         MUST_BE_TRUE(lr->getPhyReg() == NULL, "Spilled Live Range shouldn't have physical reg");
         MUST_BE_TRUE(lr->getSpillCost() < MAXSPILLCOST, "ERROR: spill live range with infinite spill cost");
+        // rematerialized flags are recomputed at each use and need no spill loc
+        if (gra.getFlagRematInst(dcl))
+        {
+            continue;
+        }
         // create spill loc for holding spilled addr regs
         createNewSpillLocDeclare(dcl);
     }
@@ -564,6 +582,17 @@ void SpillManager::insertSpillCode()
 
             currCISAOffset = inst->getCISAOff();
 
+            // the def of a rematerialized flag is dead, as each use now
+            // recomputes it
+            G4_CondMod* condMod = inst->getCondMod();
+            if (condMod && condMod->getBase() && condMod->getBase()->isRegVar() &&
+                condMod->getTopDcl()->isSpilled() &&
+                gra.getFlagRematInst(condMod->getTopDcl()) == inst)
+            {
+                inst_it = bb->erase(inst_it);
+                continue;
+            }
+
             G4_Operand * operands_analyzed[G4_MAX_SRCS] = {NULL, NULL, NULL};
             G4_Declare * declares_created[G4_MAX_SRCS] = {NULL, NULL, NULL};
             // insert spill inst for spilled srcs
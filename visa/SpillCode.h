@@ -44,6 +44,9 @@ class SpillManager
     // The number of flag spill load inserted.
     unsigned numFlagSpillLoad;
 
+    // The number of flag uses recomputed instead of filled.
+    unsigned numFlagRemat = 0;
+
     unsigned int currCISAOffset;
 
     void genRegMov(G4_BB* bb,
@@ -94,6 +97,7 @@ public:
 
     unsigned getNumFlagSpillStore() const { return numFlagSpillStore; }
     unsigned getNumFlagSpillLoad() const { return numFlagSpillLoad; }
+    unsigned getNumFlagRemat() const { return numFlagRemat; }
 };
 }
 #endif // __SPILLCODE_H__
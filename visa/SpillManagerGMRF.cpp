@@ -18,6 +18,10 @@ SPDX-License-Identifier: MIT
 #include <sstream>
 #include <fstream>
 #include <unordered_set>
+#include <deque>
+#include <map>
+#include <tuple>
+#include <algorithm>
 
 using namespace vISA;
 
@@ -4103,6 +4107,181 @@ void SpillManagerGRF::runSpillAnalysis()
     }
 }
 
+// Spill slots are otherwise assigned lazily in program order at the lowest
+// free offset, so ranges that are filled back-to-back usually end up in
+// unrelated slots and CoalesceSpillFills can't merge their messages. Group
+// ranges referenced within the coalescing window of each other into clusters
+// of at most one max-sized fill/spill payload and give each cluster a single
+// contiguous spill area. Ranges left out of clusters are handled lazily as
+// before and see the packed slots through the interference graph.
+void SpillManagerGRF::packSpillSlots()
+{
+    const unsigned grfSize = numEltPerGRF<Type_UB>();
+    // in sync with CoalesceSpillFills's window and max payload
+    const unsigned windowSize = 10;
+    const unsigned maxClusterSize = 4 * grfSize;
+
+    std::vector<G4_RegVar*> cands;
+    std::unordered_map<unsigned, unsigned> idToCand;
+    for (const LiveRange* lr : *spilledLRs_)
+    {
+        G4_RegVar* var = lr->getVar();
+        if (!shouldSpillRegister(var) || var->isRegVarTransient() ||
+            var->getId() >= varIdCount_ || var->getDisp() != UINT_MAX ||
+            var->getDeclare()->getAddressed() || var->getDeclare()->getAliasDeclare() ||
+            lvInfo_->isAddressSensitive(var->getId()) ||
+            ROUND(getByteSize(var), grfSize) > maxClusterSize)
+            continue;
+        idToCand[var->getId()] = (unsigned)cands.size();
+        cands.push_back(var);
+    }
+
+    if (cands.size() < 2)
+        return;
+
+    // affinity between candidates referenced by the same kind of access (spill
+    // or fill) within the window, and first reference for ordering the clusters
+    std::map<std::pair<unsigned, unsigned>, unsigned> affinity;
+    std::vector<unsigned> firstRef(cands.size(), UINT_MAX);
+    unsigned pos = 0;
+    for (auto bb : gra.kernel.fg)
+    {
+        // (position, candidate, isFill) of recent references in this BB
+        std::deque<std::tuple<unsigned, unsigned, bool>> recent;
+        for (auto inst : *bb)
+        {
+            pos++;
+            while (!recent.empty() && std::get<0>(recent.front()) + windowSize <= pos)
+                recent.pop_front();
+
+            auto addRef = [&](G4_Operand* opnd, bool isFill)
+            {
+                auto dcl = opnd->getTopDcl();
+                if (!dcl)
+                    return;
+                auto it = idToCand.find(dcl->getRegVar()->getId());
+                if (it == idToCand.end())
+                    return;
+                unsigned cand = it->second;
+                firstRef[cand] = std::min(firstRef[cand], pos);
+                for (auto& r : recent)
+                {
+                    unsigned other = std::get<1>(r);
+                    if (other != cand && std::get<2>(r) == isFill)
+                        affinity[std::make_pair(std::min(cand, other), std::max(cand, other))]++;
+                }
+                recent.push_back(std::make_tuple(pos, cand, isFill));
+            };
+
+            if (inst->isPseudoKill() || inst->isLifeTimeEnd())
+                continue;
+            if (inst->getDst() && inst->getDst()->getBase()->isRegVar())
+                addRef(inst->getDst(), false);
+            for (unsigned i = 0, numSrc = inst->getNumSrc(); i < numSrc; i++)
+            {
+                auto src = inst->getSrc(i);
+                if (src && src->isSrcRegRegion() && src->getBase()->isRegVar())
+                    addRef(src, true);
+            }
+        }
+    }
+
+    if (affinity.empty())
+        return;
+
+    // greedily merge clusters along the heaviest edges
+    std::vector<std::pair<unsigned, std::pair<unsigned, unsigned>>> edges;
+    for (auto& a : affinity)
+        edges.push_back(std::make_pair(a.second, a.first));
+    std::stable_sort(edges.begin(), edges.end(),
+        [](const std::pair<unsigned, std::pair<unsigned, unsigned>>& e1,
+           const std::pair<unsigned, std::pair<unsigned, unsigned>>& e2)
+        { return e1.first > e2.first; });
+
+    std::vector<unsigned> clusterOf(cands.size());
+    std::vector<std::vector<unsigned>> clusters(cands.size());
+    std::vector<unsigned> clusterSize(cands.size());
+    for (unsigned i = 0; i < cands.size(); i++)
+    {
+        clusterOf[i] = i;
+        clusters[i].push_back(i);
+        clusterSize[i] = ROUND(getByteSize(cands[i]), grfSize);
+    }
+
+    for (auto& e : edges)
+    {
+        unsigned c1 = clusterOf[e.second.first], c2 = clusterOf[e.second.second];
+        if (c1 == c2 || clusterSize[c1] + clusterSize[c2] > maxClusterSize)
+            continue;
+        if (firstRef[clusters[c2].front()] < firstRef[clusters[c1].front()])
+            std::swap(c1, c2);
+        for (auto m : clusters[c2])
+        {
+            clusterOf[m] = c1;
+            clusters[c1].push_back(m);
+        }
+        clusters[c2].clear();
+        clusterSize[c1] += clusterSize[c2];
+        clusterSize[c2] = 0;
+    }
+
+    std::vector<unsigned> order;
+    for (unsigned i = 0; i < cands.size(); i++)
+    {
+        if (clusters[i].size() > 1)
+            order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [&](unsigned c1, unsigned c2)
+        { return firstRef[clusters[c1].front()] < firstRef[clusters[c2].front()]; });
+
+    // Place each cluster at the lowest offset, starting from nextSpillOffset_
+    // as calculateSpillDisp does, where no member overlaps the slot of an
+    // interfering range.
+    unsigned numPacked = 0;
+    for (auto c : order)
+    {
+        unsigned start = ROUND(nextSpillOffset_, grfSize);
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            unsigned rel = 0;
+            for (auto m : clusters[c])
+            {
+                unsigned size = ROUND(getByteSize(cands[m]), grfSize);
+                for (auto edge : spillIntf_->getSparseIntfForVar(cands[m]->getId()))
+                {
+                    auto lrEdge = getRegVar(edge);
+                    if (lrEdge->isRegVarTransient() || lrEdge->getDisp() == UINT_MAX)
+                        continue;
+                    unsigned edgeStart = lrEdge->getDisp();
+                    unsigned edgeEnd = ROUND(edgeStart + getByteSize(lrEdge), grfSize);
+                    if (start + rel < edgeEnd && edgeStart < start + rel + size)
+                    {
+                        start = ROUND(edgeEnd - rel, grfSize);
+                        changed = true;
+                    }
+                }
+                rel += size;
+            }
+        }
+
+        unsigned rel = 0;
+        for (auto m : clusters[c])
+        {
+            cands[m]->setDisp(start + rel);
+            rel += ROUND(getByteSize(cands[m]), grfSize);
+            numPacked++;
+        }
+    }
+
+    if (gra.kernel.getOption(vISA_RATrace) && numPacked)
+    {
+        std::cout << "\t--packed " << numPacked << " spilled ranges into "
+            << order.size() << " contiguous spill areas\n";
+    }
+}
+
 // Insert spill/fill code for all registers that have not been assigned
 // physical registers in the current iteration of the graph coloring
 // allocator.
@@ -4134,6 +4313,12 @@ bool SpillManagerGRF::insertSpillFillCode(
         }
     }
 
+    if (doSpillSpaceCompression && spilledLSLRs_ == nullptr &&
+        gra.kernel.getOption(vISA_PackSpillSlots))
+    {
+        packSpillSlots();
+    }
+
     // Handle address taken spills
     bool success = handleAddrTakenSpills(kernel, pointsToAnalysis);
 
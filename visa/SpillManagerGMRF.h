@@ -637,6 +637,10 @@ private:
     // later on we can add detection to avoid unncessary read-modify-write for spills
     void runSpillAnalysis();
 
+    // assign adjacent spill slots to spilled ranges that are accessed close to
+    // each other so that their spills/fills can be coalesced
+    void packSpillSlots();
+
     bool checkUniqueDefAligned(G4_DstRegRegion* dst, G4_BB* defBB);
     bool checkDefUseDomRel(G4_DstRegRegion* dst, G4_BB* bb);
     void updateRMWNeeded();
@@ -24,6 +24,7 @@ DEF_TIMER(COLORING,                                  "\t  Graph Coloring")
 DEF_TIMER(SPILL,                                              "\t  spill")
 DEF_TIMER(PRERA_SCHEDULING,                            "preRA_Scheduling")
 DEF_TIMER(SCHEDULING,                                        "Scheduling")
+DEF_TIMER(SWSB,                                                    "SWSB")
 DEF_TIMER(ENCODE_AND_EMIT,                                  "Encode+Emit")
 DEF_TIMER(ENCODE_COMPACTION,                                 "\tCompaction")
 DEF_TIMER(IGA_ENCODER,                                   "\tIGA_Encoding")
@@ -120,7 +120,17 @@ public:
     // Temporary function to move options to attributes!
     void finalizeAttributes();
     void finalizeKernel();
-    unsigned long writeInToCisaBinaryBuffer(const void * value, int size);
+    // defined inline since the binary emitter calls it once per field
+    unsigned long writeInToCisaBinaryBuffer(const void * value, int size)
+    {
+        MUST_BE_TRUE(m_bytes_written_cisa_buffer + size <= m_cisa_binary_size,
+            "Size of VISA instructions binary buffer is exceeded.");
+
+        memcpy_s(&m_cisa_binary_buffer[m_bytes_written_cisa_buffer], size, value, size);
+        m_bytes_written_cisa_buffer += size;
+
+        return m_bytes_written_cisa_buffer;
+    }
     unsigned long getBytesWritten() { return m_bytes_written_cisa_buffer; }
 
     void setName(const char* n);
@@ -188,6 +198,8 @@ public:
     CISA_GEN_VAR * getDeclFromName(const std::string &name);
     bool declExistsInCurrentScope(const std::string &name) const;
     bool setNameIndexMap(const std::string &name, CISA_GEN_VAR *, bool unique = false);
+    bool recordVarName(const std::string &name, CISA_GEN_VAR *);
+    bool keepsVarNames() const;
     void pushIndexMapScopeLevel();
     void popIndexMapScopeLevel();
 
@@ -327,6 +339,8 @@ public:
 
     VISA_BUILDER_API int AppendVISACFGotoInst(VISA_PredOpnd *pred, VISA_EMask_Ctrl emask, VISA_Exec_Size executionSize, VISA_LabelOpnd *label) override;
 
+    VISA_BUILDER_API int SetLastGotoBranchInfo(bool threadUniform, int fallThroughPercent) override;
+
     VISA_BUILDER_API int AppendVISACFLabelInst(VISA_LabelOpnd *label) override;
 
     VISA_BUILDER_API int AppendVISACFJmpInst(VISA_PredOpnd *pred, VISA_LabelOpnd *label) override;
@@ -657,6 +671,7 @@ public:
     VISA_BUILDER_API int GetGTPinBuffer(void*& buffer, unsigned int& size) override;
     VISA_BUILDER_API int SetGTPinInit(void* buffer) override;
     VISA_BUILDER_API int GetFreeGRFInfo(void*& buffer, unsigned int& size) override;
+    VISA_BUILDER_API int GetPerfModelReport(const char*& report, unsigned int& size) override;
 
     VISA_BUILDER_API int GetFunctionId(unsigned int& id) const override;
 
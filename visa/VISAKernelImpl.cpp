@@ -235,7 +235,12 @@ int VISAKernelImpl::compileTillOptimize()
 
     Optimizer optimizer(*m_kernelMem, *m_builder, *m_kernel, m_kernel->fg);
 
-    return optimizer.optimization();
+    int status = optimizer.optimization();
+    if (status == VISA_SUCCESS && m_options->getOption(vISA_IPRA) && !getIsKernel())
+    {
+        m_kernel->computeClobberedGRFs();
+    }
+    return status;
 }
 
 void VISAKernelImpl::adjustIndirectCallOffset()
@@ -601,11 +606,21 @@ void VISAKernelImpl::initCompilerStats()
 #if COMPILER_STATS_ENABLE
     m_compilerStats.Init("PreRASchedulerForPressure", CompilerStats::type_bool);
     m_compilerStats.Init("PreRASchedulerForLatency", CompilerStats::type_bool);
+    m_compilerStats.Init("PreRASchedulerBalanced", CompilerStats::type_bool);
     m_compilerStats.Init("IsRAsuccessful", CompilerStats::type_bool);
     m_compilerStats.Init("IsTrivialRA", CompilerStats::type_bool);
     m_compilerStats.Init("IsLocalRA", CompilerStats::type_bool);
     m_compilerStats.Init("IsHybridRA", CompilerStats::type_bool);
     m_compilerStats.Init("IsGlobalRA", CompilerStats::type_bool);
+    m_compilerStats.Init("AutoGRFSelection", CompilerStats::type_int64);
+    m_compilerStats.Init("NumBankConflicts", CompilerStats::type_int64);
+    m_compilerStats.Init("SWSBScalarReachVisits", CompilerStats::type_int64);
+    m_compilerStats.Init("SWSBSIMDReachVisits", CompilerStats::type_int64);
+    m_compilerStats.Init("NumHoistedSends", CompilerStats::type_int64);
+    m_compilerStats.Init("NumPipelinedSends", CompilerStats::type_int64);
+    m_compilerStats.Init("PerfModelCycles", CompilerStats::type_int64);
+    m_compilerStats.Init("PerfModelStallCycles", CompilerStats::type_int64);
+    m_compilerStats.Init("NumRegionFixesAvoided", CompilerStats::type_int64);
 #endif // COMPILER_STATS_ENABLE
 }
 
@@ -637,7 +652,8 @@ int VISAKernelImpl::CISABuildPreDefinedDecls()
                 std::string varName(getPredefinedVarString(predefId));
                 std::string alias = "V" + std::to_string(i);
                 decl->genVar.name_index = addStringPool(varName);
-                if (m_options->getOption(vISA_isParseMode))
+                if (m_options->getOption(vISA_isParseMode) ||
+                    m_options->getOption(vISA_ParseAsmFragment))
                 {
                     setNameIndexMap(alias, decl, true);
                     setNameIndexMap(varName, decl, true);
@@ -790,7 +806,8 @@ void VISAKernelImpl::ensureVariableNameUnique(const char *&varName)
 
 void VISAKernelImpl::generateVariableName(Common_ISA_Var_Class Ty, const char *&varName)
 {
-    if (!m_options->getOption(vISA_GenerateISAASM) && !IsAsmWriterMode())
+    if (!m_options->getOption(vISA_GenerateISAASM) && !IsAsmWriterMode() &&
+        !m_options->getOption(vISA_ParseAsmFragment))
     {
         // variable name is a don't care if we are not outputting vISA assembly
         return;
@@ -894,13 +911,14 @@ int VISAKernelImpl::CreateVISAGenVar(
 
     generateVariableName(decl->type, varName);
 
-    if (m_options->getOption(vISA_isParseMode) && !setNameIndexMap(varName, decl))
+    if (!recordVarName(varName, decl))
     {
         assert(0);
         return VISA_FAILURE;
     }
 
-    m_GenVarToNameMap[decl] = varName;
+    if (keepsVarNames())
+        m_GenVarToNameMap[decl] = varName;
 
     info->bit_properties = (uint8_t)dataType;
     info->bit_properties += varAlign << 4;
@@ -984,7 +1002,7 @@ int VISAKernelImpl::CreateVISAAddrVar(
     ////memset(decl, 0, sizeof(VISA_AddrVar));
     decl->type = ADDRESS_VAR;
 
-    if (m_options->getOption(vISA_isParseMode) && !setNameIndexMap(std::string(varName), decl))
+    if (!recordVarName(std::string(varName), decl))
     {
         assert(0);
         return VISA_FAILURE;
@@ -993,7 +1011,8 @@ int VISAKernelImpl::CreateVISAAddrVar(
     addr_info_t * addr = &decl->addrVar;
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    if (keepsVarNames())
+        m_GenVarToNameMap[decl] = varName;
 
     decl->index = m_addr_info_count++;
     if (IS_GEN_BOTH_PATH)
@@ -1039,14 +1058,15 @@ int VISAKernelImpl::CreateVISAPredVar(
     const int MAX_VISA_PRED_SIZE = 32;
     MUST_BE_TRUE(numberElements <= MAX_VISA_PRED_SIZE, "number of flags must be <= 32");
 
-    if (m_options->getOption(vISA_isParseMode) && !setNameIndexMap(std::string(varName), decl))
+    if (!recordVarName(std::string(varName), decl))
     {
         assert(0);
         return VISA_FAILURE;
     }
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    if (keepsVarNames())
+        m_GenVarToNameMap[decl] = varName;
 
     pred_info_t * pred = &decl->predVar;
 
@@ -1084,14 +1104,15 @@ int VISAKernelImpl::CreateStateVar(
     ////memset(decl, 0, sizeof(CISA_GEN_VAR));
     decl->type = type;
 
-    if (m_options->getOption(vISA_isParseMode) && !setNameIndexMap(std::string(varName), decl))
+    if (!recordVarName(std::string(varName), decl))
     {
         assert(0);
         return VISA_FAILURE;
     }
     generateVariableName(decl->type, varName);
 
-    m_GenVarToNameMap[decl] = varName;
+    if (keepsVarNames())
+        m_GenVarToNameMap[decl] = varName;
 
     state_info_t * state = &decl->stateVar;
     state->attribute_capacity = 0;
@@ -3247,6 +3268,27 @@ int VISAKernelImpl::AppendVISACFGotoInst(
     return status;
 }
 
+int VISAKernelImpl::SetLastGotoBranchInfo(bool threadUniform, int fallThroughPercent)
+{
+    if (fallThroughPercent < -1 || fallThroughPercent > 100)
+    {
+        return VISA_FAILURE;
+    }
+
+    if (IS_GEN_BOTH_PATH)
+    {
+        if (m_builder->instList.empty() || m_builder->instList.back()->opcode() != G4_goto)
+        {
+            return VISA_FAILURE;
+        }
+        G4_InstCF* gotoInst = m_builder->instList.back()->asCFInst();
+        gotoInst->setThreadUniformCond(threadUniform);
+        gotoInst->setFallThroughPercent(fallThroughPercent);
+    }
+
+    return VISA_SUCCESS;
+}
+
 int VISAKernelImpl::AppendVISACFJmpInst(VISA_PredOpnd *pred, VISA_LabelOpnd *label)
 {
     TIME_SCOPE(VISA_BUILDER_APPEND_INST);
@@ -7949,17 +7991,6 @@ void VISAKernelImpl::finalizeKernel()
 
 }
 
-unsigned long VISAKernelImpl::writeInToCisaBinaryBuffer(const void * value, int size)
-{
-    MUST_BE_TRUE(m_bytes_written_cisa_buffer + size <= m_cisa_binary_size,
-        "Size of VISA instructions binary buffer is exceeded.");
-
-    memcpy_s(&m_cisa_binary_buffer[m_bytes_written_cisa_buffer], size, value, size);
-    m_bytes_written_cisa_buffer += size;
-
-    return m_bytes_written_cisa_buffer;
-}
-
 VISA_LabelOpnd* VISAKernelImpl::getLabelOperandFromFunctionName(const std::string &name)
 {
     auto it = m_funcName_to_labelID_map.find(name);
@@ -8042,6 +8073,28 @@ bool VISAKernelImpl::setNameIndexMap(const std::string &name, CISA_GEN_VAR * gen
     return true;
 }
 
+// Variable names are only needed to print or parse vISA text; GEN-only
+// kernels lower straight to G4 IR and don't pay for keeping them.
+bool VISAKernelImpl::keepsVarNames() const
+{
+    return IS_VISA_BOTH_PATH || IsAsmWriterMode() ||
+        m_options->getOption(vISA_GenerateISAASM) ||
+        m_options->getOption(vISA_GenerateDebugInfo) ||
+        m_options->getOption(vISA_ParseAsmFragment);
+}
+
+// Records the name of a new variable for lookup by the vISA text parser.
+// Redefinitions are only an error for parsed declarations; names of API
+// created variables are already made unique by generateVariableName.
+bool VISAKernelImpl::recordVarName(const std::string &name, CISA_GEN_VAR * genDecl)
+{
+    if (m_options->getOption(vISA_isParseMode))
+        return setNameIndexMap(name, genDecl);
+    if (m_options->getOption(vISA_ParseAsmFragment))
+        (void)setNameIndexMap(name, genDecl);
+    return true;
+}
+
 void VISAKernelImpl::pushIndexMapScopeLevel()
 {
     m_GenNamedVarMap.push_back(GenDeclNameToVarMap());
@@ -8253,6 +8306,24 @@ int VISAKernelImpl::GetGTPinBuffer(void*& buffer, unsigned int& size)
     return VISA_SUCCESS;
 }
 
+int VISAKernelImpl::GetPerfModelReport(const char*& report, unsigned int& size)
+{
+    report = nullptr;
+    size = 0;
+
+    if (!m_kernel)
+        return VISA_FAILURE;
+
+    const std::string& perfModelReport = m_kernel->getPerfModelReport();
+    if (!perfModelReport.empty())
+    {
+        report = perfModelReport.c_str();
+        size = (unsigned int)perfModelReport.size();
+    }
+
+    return VISA_SUCCESS;
+}
+
 int VISAKernelImpl::GetFreeGRFInfo(void*& buffer, unsigned int& size)
 {
     buffer = nullptr;
@@ -257,13 +257,16 @@ void VarSplitPass::run()
 
 void VarSplitPass::findSplitCandidates()
 {
-    auto canSplit = [](G4_INST* inst)
+    auto canSplit = [this](G4_INST* inst)
     {
+        if (!inst->isSend() ||
+            inst->getMsgDesc()->getDstLenRegs() <= 2 ||
+            inst->getDst()->getTopDcl()->getRegVar()->isRegVarTransient())
+            return false;
         // Insert any new split candidates here
-        return (inst->isSend() &&
-            inst->getMsgDesc()->isSampler() &&
-            inst->getMsgDesc()->getDstLenRegs() > 2 &&
-            !inst->getDst()->getTopDcl()->getRegVar()->isRegVarTransient());
+        if (inst->getMsgDesc()->isSampler())
+            return kernel.getOption(vISA_IntrinsicSplit);
+        return kernel.getOption(vISA_SplitSendPayloads);
     };
 
     // Find all dcls that can be split in to smaller chunks
@@ -285,6 +288,7 @@ void VarSplitPass::findSplitCandidates()
                     if (canSplit(inst))
                     {
                         prop.candidateDef = true;
+                        prop.payloadDef = !inst->getMsgDesc()->isSampler();
                     }
                 }
             }
@@ -313,8 +317,10 @@ void VarSplitPass::findSplitCandidates()
     for (auto itemIt = splitVars.begin(); itemIt != splitVars.end(); itemIt++)
     {
         auto& item = (*itemIt);
+        // The split intrinsics are placed right after the only def, so uses
+        // of a send response in other BBs can still read the split parts.
         if (item.second.numDefs != 1 || !item.second.candidateDef ||
-            !item.second.isDefUsesInSameBB())
+            (!item.second.payloadDef && !item.second.isDefUsesInSameBB()))
         {
             item.second.legitCandidate = false;
             continue;
@@ -398,6 +404,14 @@ void VarSplitPass::findSplitCandidates()
             // Dont emit split if all uses are closeby
             unsigned int idx = instId[item.second.srcs.front().first->getInst()];
             bool split = true;
+            // distances below assume uses are laid out after the def,
+            // which only holds by construction for local uses
+            if (item.second.payloadDef &&
+                idx < instId[item.second.def.first->getInst()])
+            {
+                itemIt = splitVars.erase(itemIt);
+                continue;
+            }
             if (item.second.srcs.size() > 1)
             {
                 for (auto src : item.second.srcs)
@@ -32,6 +32,8 @@ public:
     std::vector<std::pair<G4_SrcRegRegion*, G4_BB*>> srcs;
     bool candidateDef = false;
     bool legitCandidate = true;
+    // non-sampler send response that may be consumed in other BBs
+    bool payloadDef = false;
 
     // API to check whether variable is local or global
     bool isDefUsesInSameBB()
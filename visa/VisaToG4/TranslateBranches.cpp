@@ -210,9 +210,15 @@ int IR_Builder::translateVISACFSymbolInst(
 {
     TIME_SCOPE(VISA_BUILDER_IR_CONSTRUCTION);
 
-    if (symbolName.compare("INTEL_PATCH_PRIVATE_MEMORY_SIZE") == 0)
+    // "INTEL_PATCH_" symbols name 32-bit values patched by the runtime
+    // (INTEL_PATCH_PRIVATE_MEMORY_SIZE is the runtime-calculated private
+    // memory size), not addresses
+    bool isPatchedImm = symbolName.compare("INTEL_PATCH_PRIVATE_MEMORY_SIZE") == 0 ||
+        (symbolName.compare(0, 12, "INTEL_PATCH_") == 0 &&
+         IS_TYPE_INT(dst->getType()) && TypeSize(dst->getType()) == 4);
+    if (isPatchedImm)
     {
-        // Relocation for runtime-calculated private memory size
+        // Relocation for a runtime-patched 32-bit immediate
         auto* privateMemPatch = createRelocImm(Type_UD);
         dst->setType(Type_UD);
         G4_INST* mov = createMov(g4::SIMD1, dst, privateMemPatch, InstOpt_WriteEnable, true);
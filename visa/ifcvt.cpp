@@ -424,8 +424,13 @@ namespace {
         void fullConvert(IfConvertible &);
         void partialConvert(IfConvertible &);
 
+        const unsigned uniformMaxInsts;
+        const unsigned coldPercent;
+
     public:
-        IfConverter(FlowGraph &g) : fg(g) {}
+        IfConverter(FlowGraph &g) : fg(g),
+            uniformMaxInsts(g.builder->getOptions()->getuInt32Option(vISA_ifCvtUniformMaxInsts)),
+            coldPercent(g.builder->getOptions()->getuInt32Option(vISA_ifCvtColdPercent)) {}
 
         void analyze(std::vector<IfConvertible> &);
 
@@ -464,6 +469,27 @@ void IfConverter::analyze(std::vector<IfConvertible> &list) {
         unsigned n0 = getPredictableInsts(s0, ifInst);
         unsigned n1 = s1 ? getPredictableInsts(s1, ifInst) : 0;
 
+        // When all channels go the same way, the branch executes one side
+        // only while predication executes both; only worth it on tiny
+        // bodies. Partial conversion keeps a branch anyway.
+        G4_InstCF *cfInst = ifInst->asCFInst();
+        if (cfInst->isUniform() || cfInst->isThreadUniformCond()) {
+            if (n0 > 0 && (!s1 || n1 > 0) && n0 + n1 <= uniformMaxInsts)
+                list.push_back(
+                    IfConvertible(FullConvert, pred, BB, s0, s1, t));
+            continue;
+        }
+
+        // A side that the profile shows few channels execute is likely
+        // skipped by the whole thread; keep jumping over it.
+        int fallThroughPercent = cfInst->getFallThroughPercent();
+        if (fallThroughPercent >= 0) {
+            if ((unsigned)fallThroughPercent < coldPercent)
+                n0 = 0;
+            if (s1 && (unsigned)(100 - fallThroughPercent) < coldPercent)
+                n1 = 0;
+        }
+
         if (s0 && s1) {
             if (((n0 > 0) && (n0 < FullyConvertibleMaxInsts)) &&
                 ((n1 > 0) && (n1 < FullyConvertibleMaxInsts))) {
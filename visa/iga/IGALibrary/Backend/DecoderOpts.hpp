@@ -8,11 +8,19 @@ SPDX-License-Identifier: MIT
 
 #ifndef IGA_BACKEND_DECODER_OPTS
 #define IGA_BACKEND_DECODER_OPTS
+
+#include <memory>
+
 namespace iga
 {
+class MemManager;
+
 struct DecoderOpts
 {
     bool useNumericLabels;
+    // if set, the decoded kernel is allocated entirely from this arena
+    // (see Kernel(const Model&, std::shared_ptr<MemManager>))
+    std::shared_ptr<MemManager> kernelMem;
 
     DecoderOpts(bool _useNumericLabels = false)
         : useNumericLabels(_useNumericLabels)
@@ -159,16 +159,16 @@ Kernel *Decoder::decodeKernel(
     m_binary = binary;
     if (binarySize == 0) {
         // edge case: empty kernel is okay
-        return new Kernel(m_model);
+        return newKernel();
     }
     if (binarySize < 8) {
         // bail if we don't have at least a compact instruction
         errorT("binary size is too small");
         return nullptr;
     }
-    Kernel *kernel = new Kernel(m_model);
+    Kernel *kernel = newKernel();
 
-    InstList insts;
+    InstList insts(InstList::allocator_type(kernel->getMemManagerPtr()));
     // NOTE: we could pre-allocate instruction list here
     // (this would block allocate everything)
     // insts.reserve(binarySize / 8 + 1);
@@ -192,7 +192,8 @@ Kernel *Decoder::decodeKernel(
         auto blockStarts = Block::inferBlocks(
             errorHandler(),
             kernel->getMemManager(),
-            insts);
+            insts,
+            kernel->getMemManagerPtr());
         int id = 1;
         for (auto bitr : blockStarts) {
             bitr.second->setID(id++);
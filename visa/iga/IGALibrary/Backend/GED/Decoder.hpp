@@ -113,6 +113,12 @@ namespace iga
             const void *binary,
             size_t binarySize);
 
+        // allocate decoded kernels from mem instead of a fresh arena
+        void setKernelMemManager(std::shared_ptr<MemManager> mem)
+        {
+            m_kernelMem = mem;
+        }
+
         // Set the SWSB endcoding mode, if not set, derived from platform
         void setSWSBEncodingMode(SWSB_ENCODE_MODE mode)
         {
@@ -125,6 +131,13 @@ namespace iga
         bool isMacro() const;
 
     private:
+        std::shared_ptr<MemManager> m_kernelMem;
+
+        Kernel *newKernel() const {
+            return m_kernelMem ?
+                new Kernel(m_model, m_kernelMem) : new Kernel(m_model);
+        }
+
         Kernel *decodeKernel(
             const void *binary,
             size_t binarySize,
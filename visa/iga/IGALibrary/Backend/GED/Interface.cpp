@@ -55,6 +55,7 @@ Kernel *iga::ged::Decode(
     Kernel *k = nullptr;
     try {
         iga::Decoder decoder(m, eh);
+        decoder.setKernelMemManager(dopts.kernelMem);
         k = dopts.useNumericLabels ?
             decoder.decodeKernelNumeric(bits, bitsLen) :
             decoder.decodeKernelBlocks(bits, bitsLen);
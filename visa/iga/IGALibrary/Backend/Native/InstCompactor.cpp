@@ -9,9 +9,52 @@ SPDX-License-Identifier: MIT
 #include "InstCompactor.hpp"
 #include "../../bits.hpp"
 
+#include <memory>
+#include <mutex>
+
 using namespace iga;
 
 
+// Compaction tables are static per platform, so their value indexes are
+// built on first use and shared by all kernels (and encoder threads).
+int32_t InstCompactor::findTableIndex(
+    const CompactionMapping &cm, uint64_t relevantBits, uint64_t mappedValue)
+{
+    if (relevantBits != 0xFFFFFFFFFFFFFFFFull) {
+        // some bits are don't-care (an immediate expands into them);
+        // any entry that agrees on the rest will do
+        for (size_t i = 0; i < cm.numValues; i++) {
+            if ((cm.values[i] & relevantBits) == mappedValue) {
+                return (int32_t)i;
+            }
+        }
+        return -1;
+    }
+
+    using ValueIndex = std::unordered_map<uint64_t, int32_t>;
+    static std::mutex indexMutex;
+    static std::unordered_map<const CompactionMapping *,
+        std::unique_ptr<ValueIndex>> indexes;
+
+    const ValueIndex *index = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        auto &entry = indexes[&cm];
+        if (!entry) {
+            entry.reset(new ValueIndex());
+            entry->reserve(cm.numValues);
+            for (size_t i = 0; i < cm.numValues; i++) {
+                // keep the first matching entry, as the linear search did
+                entry->emplace(cm.values[i], (int32_t)i);
+            }
+        }
+        index = entry.get();
+    }
+    auto it = index->find(mappedValue);
+    return it == index->end() ? -1 : it->second;
+}
+
+
 bool InstCompactor::compactIndex(
     const CompactionMapping &cm, int immLo, int immHi)
 {
@@ -51,14 +94,18 @@ bool InstCompactor::compactIndex(
         indexOffset += mappedFragment.length;
     }
 
-    // TODO: make lookup constant (could use a prefix tree or just a simple hash)
-    for (size_t i = 0; i < cm.numValues; i++) {
-        if ((cm.values[i] & relevantBits) == mappedValue) {
-            if (!compactedBits.setField(cm.index, (uint64_t)i)) {
-                IGA_ASSERT_FALSE("compaction index overruns field");
-            }
-            return true; // hit
+    int32_t tableIndex = -1;
+    if (!memo || !memo->lookup(cm, relevantBits, mappedValue, tableIndex)) {
+        tableIndex = findTableIndex(cm, relevantBits, mappedValue);
+        if (memo) {
+            memo->insert(cm, relevantBits, mappedValue, tableIndex);
+        }
+    }
+    if (tableIndex >= 0) {
+        if (!compactedBits.setField(cm.index, (uint64_t)tableIndex)) {
+            IGA_ASSERT_FALSE("compaction index overruns field");
         }
+        return true; // hit
     }
 
     // compaction miss
@@ -13,10 +13,52 @@ SPDX-License-Identifier: MIT
 #include "MInst.hpp"
 #include "InstEncoder.hpp"
 
+#include <unordered_map>
+
 
 namespace iga {
+    // Per-kernel memo of compaction table lookups. Kernels reuse the same
+    // control, datatype and region combinations heavily, so most lookups
+    // are repeats of an earlier instruction's.
+    class CompactionMemo {
+        struct Key {
+            const CompactionMapping *cm;
+            uint64_t relevantBits;
+            uint64_t mappedValue;
+            bool operator==(const Key &k) const {
+                return cm == k.cm && relevantBits == k.relevantBits &&
+                    mappedValue == k.mappedValue;
+            }
+        };
+        struct KeyHash {
+            size_t operator()(const Key &k) const {
+                return std::hash<const void *>()(k.cm) ^
+                    std::hash<uint64_t>()(k.mappedValue * 0x9E3779B97F4A7C15ull ^
+                        k.relevantBits);
+            }
+        };
+        // compacted index, or -1 for a miss
+        std::unordered_map<Key, int32_t, KeyHash> results;
+    public:
+        bool lookup(const CompactionMapping &cm,
+            uint64_t relevantBits, uint64_t mappedValue, int32_t &index) const
+        {
+            auto it = results.find({&cm, relevantBits, mappedValue});
+            if (it == results.end())
+                return false;
+            index = it->second;
+            return true;
+        }
+        void insert(const CompactionMapping &cm,
+            uint64_t relevantBits, uint64_t mappedValue, int32_t index)
+        {
+            results.emplace(Key{&cm, relevantBits, mappedValue}, index);
+        }
+    };
+
     class InstCompactor : public BitProcessor {
         const Model &model;
+        CompactionMemo *memo;
 
         const OpSpec *os = nullptr;
         Subfunction sfs;
@@ -31,10 +73,17 @@ namespace iga {
 
         CompactionResult tryToCompactImpl();
         CompactionResult tryToCompactImplFamilyXE();
+
+        // returns the first table entry matching mappedValue on relevantBits
+        // or -1 if there is none
+        static int32_t findTableIndex(
+            const CompactionMapping &cm, uint64_t relevantBits, uint64_t mappedValue);
     public:
-        InstCompactor(BitProcessor &_parent, const Model &_model)
+        InstCompactor(BitProcessor &_parent, const Model &_model,
+            CompactionMemo *_memo = nullptr)
             : BitProcessor(_parent)
             , model(_model)
+            , memo(_memo)
         {
         }
 
@@ -56,6 +56,7 @@ using namespace iga;
 ///////////////////////////////////////////////////////////////////////////
 static size_t encodeInst(
     InstEncoder &enc,
+    CompactionMemo &compactionMemo,
     const EncoderOpts &opts,
     int ix, // instruction's index in the output array
     Instruction *inst,
@@ -77,7 +78,7 @@ static size_t encodeInst(
 
     if (mustCompact || (opts.autoCompact && !mustntCompact)) {
         // attempt compaction
-        InstCompactor ic(enc, enc.getModel());
+        InstCompactor ic(enc, enc.getModel(), &compactionMemo);
         MathFC mfc = inst->is(Op::MATH) ? inst->getMathFc() : MathFC::INVALID;
 
         auto cr = ic.tryToCompact(&inst->getOpSpec(), mfc, *bits, bits, cbdi);
@@ -146,6 +147,7 @@ struct SerialEncoder : BitProcessor
     int                   instBufTotalBytes = 0; // valid number of bytes in the buffer to be returned
 
     InstEncoder           instEncoder;
+    CompactionMemo        compactionMemo;
     std::vector<MInst*>   encodedInsts; // pointers into where each instruction starts
 
     SerialEncoder(
@@ -194,6 +196,7 @@ struct SerialEncoder : BitProcessor
                     i->setPC((PC)(instBufCurr - instBufBase));
                     size_t iLen = encodeInst(
                         instEncoder,
+                        compactionMemo,
                         opts,
                         instIx++,
                         i,
@@ -17,6 +17,8 @@ SPDX-License-Identifier: MIT
 
 #include <algorithm>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <vector>
@@ -168,8 +170,8 @@ bool GenParser::LookupReg(
         len++;
     if (len == 0)
         return false;
-    auto itr = m_regmap.find(str.substr(0,len));
-    if (itr == m_regmap.end()) {
+    auto itr = m_regmap->find(str.substr(0,len));
+    if (itr == m_regmap->end()) {
         return false;
     }
     ri = itr->second;
@@ -770,26 +772,60 @@ bool GenParser::parsePrimaryExpr(
 } // parsePrimary
 
 
-void GenParser::initSymbolMaps()
+// The mnemonic and register name maps only depend on the platform, so
+// they are built once per model and shared by every parser (including
+// parsers running on different threads) instead of once per parse.
+struct ParserSymbolTables
 {
-    // map the register names
-    // this maps just the non-number part.
-    // e.g. with cr0, this maps "cr"; see LookupReg()
-    int tableLen;
-    const RegInfo *table = GetRegisterSpecificationTable(tableLen);
-    for (int i = 0; i < tableLen; i++) {
-        const RegInfo *ri = table + i;
-        if (ri->supportedOn(platform())) {
-            m_regmap[ri->syntax] = ri;
+    std::unordered_map<std::string,const OpSpec*>   ops;
+    std::unordered_map<std::string,const RegInfo*>  regs;
+
+    ParserSymbolTables(const Model &model)
+    {
+        // map mnemonics names to their ops
+        // subops only get mapped by their fully qualified names in this pass
+        for (const OpSpec *os : model.ops()) {
+            if (os->isValid()) {
+                ops[os->mnemonic] = os;
+            }
+        }
+        // map the register names
+        // this maps just the non-number part.
+        // e.g. with cr0, this maps "cr"; see LookupReg()
+        int tableLen;
+        const RegInfo *table = GetRegisterSpecificationTable(tableLen);
+        for (int i = 0; i < tableLen; i++) {
+            const RegInfo *ri = table + i;
+            if (ri->supportedOn(model.platform)) {
+                regs[ri->syntax] = ri;
+            }
         }
     }
+};
+
+static const ParserSymbolTables &GetParserSymbolTables(const Model &model)
+{
+    static std::mutex tablesMutex;
+    static std::unordered_map<const Model*,
+        std::unique_ptr<ParserSymbolTables>> tables;
+    std::lock_guard<std::mutex> lock(tablesMutex);
+    auto &t = tables[&model];
+    if (!t) {
+        t.reset(new ParserSymbolTables(model));
+    }
+    return *t;
+}
+
+void GenParser::initSymbolMaps()
+{
+    m_regmap = &GetParserSymbolTables(m_model).regs;
 }
 
 
 class KernelParser : GenParser
 {
-    // maps mnemonics and registers for faster lookup
-    std::unordered_map<std::string,const OpSpec*>   opmap;
+    // maps mnemonics for faster lookup (shared per platform)
+    const std::unordered_map<std::string,const OpSpec*> *opmap = nullptr;
 
     ExecSize              m_defaultExecutionSize;
     Type                  m_defaultRegisterType;
@@ -828,13 +864,7 @@ public:
     }
 
     void initSymbolMaps() {
-        // map mnemonics names to their ops
-        // subops only get mapped by their fully qualified names in this pass
-        for (const OpSpec *os : m_model.ops()) {
-            if (os->isValid()) {
-                opmap[os->mnemonic] = os;
-            }
-        }
+        opmap = &GetParserSymbolTables(m_model).ops;
     }
 
 
@@ -1392,14 +1422,11 @@ public:
         if (tk.lexeme != IDENT) {
             return nullptr;
         }
-        const char *p = &m_lexer.GetSource()[tk.loc.offset];
-        std::string s;
-        s.reserve((size_t)tk.loc.extent + 1);
-        for (size_t i = 0; i < tk.loc.extent; i++) {
-            s += *p++;
-        }
-        auto itr = opmap.find(s);
-        if (itr == opmap.end()) {
+        // mnemonics are short enough to stay in the small string buffer
+        const std::string s(
+            &m_lexer.GetSource()[tk.loc.offset], (size_t)tk.loc.extent);
+        auto itr = opmap->find(s);
+        if (itr == opmap->end()) {
             return nullptr;
         } else {
             Skip();
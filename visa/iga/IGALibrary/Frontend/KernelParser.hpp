@@ -19,6 +19,7 @@ SPDX-License-Identifier: MIT
 // #include <functional>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 namespace iga {
     struct ParseOpts {
@@ -151,7 +152,8 @@ namespace iga {
         bool parsePrimaryExpr(const ExprParseOpts &po, bool consumed, ImmVal &v);
     private:
         void initSymbolMaps();
-        std::map<std::string,const RegInfo*>  m_regmap;
+        // shared per platform; maps the non-number part of register names
+        const std::unordered_map<std::string,const RegInfo*> *m_regmap = nullptr;
     }; // class GenParser
 } // iga::
 #endif
@@ -33,7 +33,11 @@ namespace iga
 // time.  Alas this lacks some of the APIs that I need to efficiently
 // perform data flow.  Specifically, I need efficient testAny/testAll
 // predicates.
-template <typename I = uint32_t>
+//
+// Words are 64b by default so that the set operations used by dataflow
+// (union, subtraction, intersection) touch as few words as possible; those
+// loops are simple enough for the compiler to vectorize.
+template <typename I = uint64_t>
 class BitSet {
 public:
     static const size_t BITS_PER_WORD = 8 * sizeof(I);
@@ -98,7 +102,7 @@ public:
     bool testAny(size_t off, size_t len) const;
     bool testAll(size_t off, size_t len) const;
     void containsAll(const BitSet<I> &rhs) const;
-    bool empty() const {return !testAny(0, N);}
+    bool empty() const;
 
     bool intersects(const BitSet<I> &rhs) const;
 
@@ -143,7 +147,7 @@ private:
         if (len == BITS_PER_WORD) {
             return (I)-1;
         }
-        return (1 << len) - 1;
+        return ((I)1 << len) - 1;
     }
 };
 
@@ -172,7 +176,7 @@ inline bool BitSet<I>::set(size_t off, size_t len, bool val)
     while (len > 0) {
         w_ix++; // next word
 
-        auto aligned_len = len >= 32 ? 32 : len % BITS_PER_WORD; // last will be <32
+        auto aligned_len = std::min<size_t>(len, BITS_PER_WORD);
         auto aligned_mask = makeMask(aligned_len);
         auto oldWord = words[w_ix];
         if (val) {
@@ -190,6 +194,17 @@ inline bool BitSet<I>::set(size_t off, size_t len, bool val)
 }
 
 
+template <typename I>
+inline bool BitSet<I>::empty() const {
+    // padding bits are always 0
+    for (size_t i = 0; i < wordsSize; i++) {
+        if (words[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 template <typename I>
 inline bool BitSet<I>::intersects(const BitSet<I> &rhs) const {
     for (size_t i = 0; i < wordsSize; i++) {
@@ -223,7 +238,7 @@ inline bool BitSet<I>::intersects(
     while (len > 0) {
         w_ix++; // next word
 
-        auto aligned_len = len >= 32 ? 32 : len % BITS_PER_WORD; // last will be <32
+        auto aligned_len = std::min<size_t>(len, BITS_PER_WORD);
         auto aligned_mask = makeMask(aligned_len);
         if ((words[w_ix] & aligned_mask) &
             (rhs.words[w_ix] & aligned_mask)) {
@@ -237,15 +252,9 @@ inline bool BitSet<I>::intersects(
 
 template <typename I>
 inline bool BitSet<I>::equal(const BitSet<I> &rhs) const {
-    bool result = true;
-    for (size_t i = 0; i < wordsSize; i++) {
-        result = (words[i] == rhs.words[i]) ? true : false;
-        if (!result)
-            break;
-    }
     // padding will remain 0 since both padding are 0's
     // 0 & 0 is 0 so no need special handling on padding
-    return result;
+    return memcmp(words, rhs.words, wordsSize * sizeof(I)) == 0;
 }
 
 template <typename I>
@@ -312,7 +321,7 @@ inline bool BitSet<I>::testAny(size_t off, size_t len) const
     while (len > 0) {
         w_ix++; // next word
 
-        auto aligned_len = len >= 32 ? 32 : len % BITS_PER_WORD; // last will be <32
+        auto aligned_len = std::min<size_t>(len, BITS_PER_WORD);
         auto aligned_mask = makeMask(aligned_len);
         if (words[w_ix] & aligned_mask) {
             return true;
@@ -345,7 +354,7 @@ inline bool BitSet<I>::testAll(size_t off, size_t len) const
     while (len > 0) {
         w_ix++; // next word
 
-        auto aligned_len = len >= 32 ? 32 : len % BITS_PER_WORD; // last will be <32
+        auto aligned_len = std::min<size_t>(len, BITS_PER_WORD);
         auto aligned_mask = makeMask(aligned_len);
         if ((words[w_ix] & aligned_mask) != aligned_mask) {
             return false;
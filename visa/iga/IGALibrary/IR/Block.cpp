@@ -26,6 +26,7 @@ using namespace iga;
 struct BlockInference
 {
     MemManager *allocator;
+    std::shared_ptr<MemManager> listAllocator;
 
     std::map<int32_t, Block *> &blockStarts;
     std::set<int32_t>           instStarts;
@@ -39,13 +40,16 @@ struct BlockInference
     };
     std::vector<ResolvedTarget> resolved;
 
-    BlockInference(std::map<int32_t, Block *> &bs, MemManager *a)
-        : allocator(a), blockStarts(bs) { }
+    BlockInference(std::map<int32_t, Block *> &bs, MemManager *a,
+        std::shared_ptr<MemManager> la)
+        : allocator(a), listAllocator(la), blockStarts(bs) { }
 
     Block *getBlock(int32_t pc) {
         auto itr = blockStarts.find(pc);
         if (itr == blockStarts.end()) {
-            Block *blk      = new (allocator) Block(pc);
+            Block *blk      = listAllocator ?
+                new (allocator) Block(listAllocator, pc) :
+                new (allocator) Block(pc);
             blockStarts[pc] = blk;
             return blk;
         } else {
@@ -197,10 +201,11 @@ static void traceOperand(const Operand &op) {
 std::map<int32_t, Block *> Block::inferBlocks(
     ErrorHandler &errHandler,
     MemManager &mem,
-    InstList &insts)
+    InstList &insts,
+    std::shared_ptr<MemManager> listMem)
 {
     std::map<int32_t, Block *> blockStarts;
-    BlockInference bi(blockStarts, &mem);
+    BlockInference bi(blockStarts, &mem, listMem);
     int32_t binaryLength = 0;
     if (!insts.empty()) {
         Instruction *i = insts.back();
@@ -36,6 +36,15 @@ namespace iga
             , m_id(pc)
         {
         }
+        // the instruction list nodes are allocated from mem
+        Block(std::shared_ptr<MemManager> mem,
+            int32_t pc = -1, const Loc &loc = Loc::INVALID)
+            : m_offset(pc)
+            , m_loc(loc)
+            , m_instructions(InstList::allocator_type(mem))
+            , m_id(pc)
+        {
+        }
         ~Block() {
             // Destruct instructions.  The memory allocated for them will be
             // de-allocated by the top-level MemManager allocator, but we need
@@ -66,10 +75,12 @@ namespace iga
 
         // infers the control flow graph
         // sets the Block* within these instructions
+        // if listMem is given, the blocks' instruction lists use it too
         static std::map<int32_t,Block*> inferBlocks(
             ErrorHandler &errHandler,
             MemManager& mem,
-            InstList &insts);
+            InstList &insts,
+            std::shared_ptr<MemManager> listMem = nullptr);
 
     private:
         int32_t             m_offset;
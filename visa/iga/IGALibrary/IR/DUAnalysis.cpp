@@ -215,7 +215,7 @@ struct LivePath {
         : use(u), useId(u.getID())
         , live(u.model())
         , usePredInv(u.hasPredication() && u.getPredication().inverse)
-        , usePred(RegSet(u.model()).bitSetFor(RegName::ARF_F))
+        , usePred(RegSet::emptyPredSet(u.model()))
     { }
 
 
@@ -357,7 +357,9 @@ struct LivePath {
             }
             // RegSet::Bits prOverlap =
             //    RegSet::Bits::intersection(pred, *pk.predicate);
-            if (!pred.intersects(*pk.predicate)) {
+            if (!pred.intersects(*pk.predicate) ||
+                !overlap.intersects(pk.kills))
+            {
                 continue;
             }
             RegSet killOverlap = RegSet::intersection(overlap, pk.kills);
@@ -396,11 +398,11 @@ struct LivePath {
     void subtractComplPredKills(const RegSet &overlap) {
         for (int i = (int)pKills.size() - 1; i >= 0; --i) {
             PredicatedKill &pk = pKills[i];
-            RegSet killOverlap = RegSet::intersection(overlap, pk.kills);
-            if (killOverlap.empty()) {
+            // subtracting the whole overlap only removes the intersection
+            if (!overlap.intersects(pk.kills)) {
                 continue;
             }
-            bool changedP = pk.kills.destructiveSubtract(killOverlap);
+            bool changedP = pk.kills.destructiveSubtract(overlap);
             if (changedP && pk.kills.empty()) {
                 TRACE("         I#", use.getID(),
                     ": invalidating predicated write (uncond.)");
@@ -621,12 +623,19 @@ struct DepAnalysisComputer
     // outputs
     DepAnalysis                     &results;
 
+    // scratch sets reused across instructions and paths so the inner
+    // loops don't allocate
+    RegSet                           overlapScratch;
+    RegSet                           liveScratch;
+
     DepAnalysisComputer(
         Kernel *_k,
         DepAnalysis &_results)
         : model(_k->getModel())
         , k(_k)
         , results(_results)
+        , overlapScratch(_k->getModel())
+        , liveScratch(_k->getModel())
     {
         sanityCheckIR(k); // should nop in release
 
@@ -856,7 +865,8 @@ struct DepAnalysisComputer
 
             // after all paths are moved back we
             if (copyOut) {
-                RegSet rs(model);
+                RegSet &rs = liveScratch;
+                rs.reset();
                 for (const auto &lps : lps) {
                     const LivePath &lp = lps.second;
                     rs.destructiveUnion(lp.live);
@@ -938,7 +948,7 @@ struct DepAnalysisComputer
         // don't want to accidentially subtract out this def
         lp.updateForPredicateRedefs(iKills);
 
-        RegSet iOverlap(model);
+        RegSet &iOverlap = overlapScratch;
 
         bool matchesPredication = lp.matchesPredication(iPred, iPredInv);
         if (matchesPredication) {
@@ -948,6 +958,8 @@ struct DepAnalysisComputer
             if (overlapNotEmpty && copyOut) {
                 results.deps.push_back(lp.toDep(&i, iOverlap));
             }
+        } else {
+            iOverlap.reset();
         }
 
         lp.update(
@@ -973,7 +985,7 @@ struct DepAnalysisComputer
         const InstSrcs &iInps = instSrcs[i.getID()];
         const RegSet &rsPreds = iInps.predication;
         const RegSet &rsSrcs = iInps.sources;
-        const RegSet::Bits usePred = rsPreds.bitSetFor(RegName::ARF_F);
+        const RegSet::Bits &usePred = rsPreds.bitSetFor(RegName::ARF_F);
 
         // early out (no dependencies on this instruction)
         if (rsPreds.empty() && rsSrcs.empty()) {
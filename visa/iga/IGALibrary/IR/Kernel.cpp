@@ -12,8 +12,14 @@ SPDX-License-Identifier: MIT
 using namespace iga;
 
 Kernel::Kernel(const Model &model)
+  : Kernel(model, std::make_shared<MemManager>(4096))
+{
+}
+
+Kernel::Kernel(const Model &model, std::shared_ptr<MemManager> mem)
   : m_model(model)
-  , m_mem(4096)
+  , m_mem(mem)
+  , m_blocks(BlockList::allocator_type(mem))
 {
 }
 
@@ -43,7 +49,7 @@ size_t Kernel::getInstructionCount() const
 
 Block *Kernel::createBlock()
 {
-    return new(&m_mem)Block();
+    return new(m_mem.get())Block(m_mem);
 }
 
 
@@ -63,7 +69,7 @@ Instruction *Kernel::createBasicInstruction(
     FlagModifier condMod,
     Subfunction sf)
 {
-    Instruction *inst = new(&m_mem)Instruction(os, execSize, chOff, mc);
+    Instruction *inst = new(m_mem.get())Instruction(os, execSize, chOff, mc);
     inst->setSubfunction(sf);
 
     inst->setPredication(predOpnd);
@@ -83,7 +89,7 @@ Instruction *Kernel::createBranchInstruction(
     MaskCtrl ectr,
     Subfunction sf)
 {
-    Instruction *inst = new(&m_mem)Instruction(
+    Instruction *inst = new(m_mem.get())Instruction(
         os,
         execSize,
         chOff,
@@ -109,7 +115,7 @@ Instruction *Kernel::createSendInstruction(
     const SendDesc &exDesc,
     const SendDesc &desc)
 {
-    Instruction *inst = new(&m_mem)Instruction(
+    Instruction *inst = new(m_mem.get())Instruction(
         op,
         execSize,
         chOff,
@@ -163,7 +169,7 @@ Instruction *Kernel::createSendInstruction(
 
 Instruction *Kernel::createNopInstruction()
 {
-    Instruction *inst = new(&m_mem)Instruction(
+    Instruction *inst = new(m_mem.get())Instruction(
         m_model.lookupOpSpec(Op::NOP),
         ExecSize::SIMD1,
         ChannelOffset::M0,
@@ -180,7 +186,7 @@ Instruction *Kernel::createNopInstruction()
 
 Instruction *Kernel::createIllegalInstruction()
 {
-    Instruction *inst = new(&m_mem)Instruction(
+    Instruction *inst = new(m_mem.get())Instruction(
         m_model.lookupOpSpec(Op::ILLEGAL),
         ExecSize::SIMD1,
         ChannelOffset::M0,
@@ -216,15 +222,15 @@ static Instruction *createSyncInstruction(
 Instruction *Kernel::createSyncNopInstruction(SWSB sw)
 {
     return createSyncInstruction(sw,
-        m_model.lookupOpSpec(Op::SYNC), SyncFC::NOP, m_mem);
+        m_model.lookupOpSpec(Op::SYNC), SyncFC::NOP, *m_mem);
 }
 Instruction *Kernel::createSyncAllRdInstruction(SWSB sw)
 {
     return createSyncInstruction(sw,
-        m_model.lookupOpSpec(Op::SYNC), SyncFC::ALLRD, m_mem);
+        m_model.lookupOpSpec(Op::SYNC), SyncFC::ALLRD, *m_mem);
 }
 Instruction *Kernel::createSyncAllWrInstruction(SWSB sw)
 {
     return createSyncInstruction(sw,
-        m_model.lookupOpSpec(Op::SYNC), SyncFC::ALLWR, m_mem);
+        m_model.lookupOpSpec(Op::SYNC), SyncFC::ALLWR, *m_mem);
 }
\ No newline at end of file
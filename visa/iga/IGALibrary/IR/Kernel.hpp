@@ -20,6 +20,7 @@ SPDX-License-Identifier: MIT
 #include "Instruction.hpp"
 
 #include <list>
+#include <memory>
 
 namespace iga {
     typedef std::list<
@@ -29,13 +30,17 @@ namespace iga {
     {
     public:
         Kernel(const Model &model);
+        // Allocates the whole kernel (blocks, instructions, lists) from mem,
+        // which the caller may reset and reuse once the kernel is deleted.
+        Kernel(const Model &model, std::shared_ptr<MemManager> mem);
         ~Kernel();
         // disabling copy constructor to prevent problems with
         // shallow copy and mem manager
         Kernel(const Kernel &) = delete;
         Kernel& operator=(const Kernel&) = delete;
 
-        MemManager&       getMemManager() { return m_mem; }
+        MemManager&       getMemManager() { return *m_mem; }
+        const std::shared_ptr<MemManager>& getMemManagerPtr() const { return m_mem; }
         const Model&      getModel() const { return m_model; }
         const BlockList&  getBlockList() const { return m_blocks; }
         BlockList&        getBlockList() { return m_blocks; }
@@ -89,7 +94,7 @@ namespace iga {
         Instruction *createSyncAllWrInstruction(SWSB sw);
     private:
         const Model&                      m_model;
-        MemManager                        m_mem;
+        std::shared_ptr<MemManager>       m_mem;
 
         BlockList                         m_blocks;
     };
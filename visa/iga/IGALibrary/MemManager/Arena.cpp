@@ -41,6 +41,23 @@ void *ArenaHeader::AllocSpace(size_t size)
     return allocSpace;
 }
 
+void ArenaManager::Reset()
+{
+    size_t totalDataSize = 0;
+    int numArenas = 0;
+    for (ArenaHeader *arena = _arenas; arena; arena = arena->_nextArena) {
+        totalDataSize += arena->_lastByte - arena->GetArenaData();
+        numArenas++;
+    }
+
+    if (numArenas > 1) {
+        FreeArenas();
+        CreateArena(totalDataSize);
+    } else if (_arenas) {
+        _arenas->_nextByte = _arenas->GetArenaData();
+    }
+}
+
 void ArenaManager::FreeArenas()
 {
     while (_arenas) {
@@ -174,6 +174,11 @@ private:
 
     void FreeArenas();
 
+    // Discards everything allocated so far but keeps the memory: the arenas
+    // are coalesced into a single one large enough for the same demand, so
+    // a manager reused for similar workloads stops touching the heap.
+    void Reset();
+
     // Data
 
     ArenaHeader  *_arenas;
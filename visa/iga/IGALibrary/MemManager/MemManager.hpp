@@ -28,6 +28,13 @@ public:
         return _arenaManager.AllocDataSpace(size);
     }
 
+    // Releases all allocations at once, keeping the memory for reuse.
+    // Nothing allocated from this manager may be used afterwards.
+    void reset()
+    {
+        _arenaManager.Reset();
+    }
+
 private:
     ArenaManager   _arenaManager;
 
@@ -222,6 +222,13 @@ static const struct RegInfo REGISTER_SPECIFICATIONS[] = {
         1, (2*4)), // dbg0.{0,1}:ud
 };
 
+// Lookup indices derived from the immutable model tables (see GetModelIndex)
+struct ModelIndex {
+    const OpSpec  *opsByCode[128]; // machine opcodes are 7b
+    const RegInfo *regsByName[(int)RegName::GRF_R + 1];
+};
+static const ModelIndex *GetModelIndex(const Model &m);
+
 const OpSpec& Model::lookupOpSpec(Op op) const
 {
     if (op < Op::FIRST_OP || op > Op::LAST_OP) {
@@ -243,6 +250,10 @@ const OpSpec& Model::lookupOpSpecByCode(unsigned opcode) const
     //     }
     //     opsByCodeValid = true;
     // }
+    const ModelIndex *mi = GetModelIndex(*this);
+    if (mi && opcode < sizeof(mi->opsByCode)/sizeof(mi->opsByCode[0])) {
+        return *mi->opsByCode[opcode];
+    }
     for (int i = (int)Op::FIRST_OP; i <= (int)Op::LAST_OP; i++) {
         if (opsArray[i].op != Op::INVALID &&
             opsArray[i].opcode == opcode)
@@ -288,6 +299,10 @@ const OpSpec& Model::lookupOpSpecFromBits(
 
 const RegInfo *Model::lookupRegInfoByRegName(RegName name) const
 {
+    const ModelIndex *mi = GetModelIndex(*this);
+    if (mi && (int)name >= 0 && (int)name <= (int)RegName::GRF_R) {
+        return mi->regsByName[(int)name];
+    }
     // static tester should check this
     for (const RegInfo &ri : REGISTER_SPECIFICATIONS) {
         if (ri.regName == name && ri.supportedOn(platform)) {
@@ -444,6 +459,57 @@ const Model * const iga::ALL_MODELS[] {
 };
 const size_t iga::ALL_MODELS_LEN = sizeof(ALL_MODELS)/sizeof(ALL_MODELS[0]);
 
+// The models are compile-time constants, but opcode and register lookups
+// on them were linear scans repeated for every decoded instruction and every
+// register set constructed.  The indices for all models are built once per
+// process on first use and shared (read-only) by every context and thread.
+static const ModelIndex *GetModelIndex(const Model &m)
+{
+    struct ModelIndices {
+        ModelIndex indices[sizeof(ALL_MODELS)/sizeof(ALL_MODELS[0])];
+
+        ModelIndices() {
+            for (size_t mIx = 0; mIx < ALL_MODELS_LEN; mIx++) {
+                const Model &model = *ALL_MODELS[mIx];
+                ModelIndex &mi = indices[mIx];
+                const OpSpec *invalid = &model.lookupOpSpec(Op::INVALID);
+                for (auto &os : mi.opsByCode) {
+                    os = invalid;
+                }
+                // walk backwards so the first matching op wins
+                // (same as the linear search)
+                for (int i = (int)Op::LAST_OP; i >= (int)Op::FIRST_OP; i--) {
+                    const OpSpec &os = model.lookupOpSpec((Op)i);
+                    if (os.op != Op::INVALID && os.opcode < 128) {
+                        mi.opsByCode[os.opcode] = &os;
+                    }
+                }
+                for (auto &ri : mi.regsByName) {
+                    ri = nullptr;
+                }
+                for (const RegInfo &ri : REGISTER_SPECIFICATIONS) {
+                    int rnIx = (int)ri.regName;
+                    if (rnIx >= 0 && rnIx <= (int)RegName::GRF_R &&
+                        !mi.regsByName[rnIx] &&
+                        ri.supportedOn(model.platform))
+                    {
+                        mi.regsByName[rnIx] = &ri;
+                    }
+                }
+            }
+        }
+    };
+    // thread-safe initialization
+    static const ModelIndices s_indices;
+
+    for (size_t mIx = 0; mIx < ALL_MODELS_LEN; mIx++) {
+        if (ALL_MODELS[mIx] == &m) {
+            return &s_indices.indices[mIx];
+        }
+    }
+    return nullptr; // not one of ours; callers fall back to the tables
+}
+
 const Model *Model::LookupModel(Platform p)
 {
     switch (p) {
@@ -25,10 +25,12 @@ SPDX-License-Identifier: MIT
 
 // external dependencies
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <map>
 #include <ostream>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -219,6 +221,9 @@ private:
     char                           *m_disassemble_text;
     // a reusable empty string to return on errors
     char                            m_empty_string[4];
+    // if set, iga_context_disassemble decodes into this arena and resets
+    // it afterwards instead of allocating a fresh one per kernel
+    std::shared_ptr<MemManager>     m_decodeMem;
 
     // diagnostics from the last compile
     bool                            m_errorsValid, m_warningsValid;
@@ -473,17 +478,27 @@ public:
         }
     }
 
+    void reuseDecodeMemory(bool enable)
+    {
+        if (!enable)
+            m_decodeMem.reset();
+        else if (!m_decodeMem)
+            m_decodeMem = std::make_shared<MemManager>(64 * 1024);
+    }
+
     iga_status_t disassembleKernel(
         iga::ErrorHandler &errHandler,
         iga_disassemble_options_t &dopts,
         const void *bits,
         uint32_t bitsLen,
-        Kernel *&k)
+        Kernel *&k,
+        std::shared_ptr<MemManager> kernelMem = nullptr)
     {
         k = nullptr;
         checkForLegacyFields(dopts, errHandler);
         DecoderOpts dopts2(
             (dopts.formatting_opts & IGA_FORMATTING_OPT_NUMERIC_LABELS) != 0);
+        dopts2.kernelMem = kernelMem;
         if ((dopts.decoder_opts & IGA_DECODING_OPT_NATIVE) == 0) {
             if (!iga::ged::IsDecodeSupported(m_model,dopts2)) {
                 return IGA_UNSUPPORTED_PLATFORM;
@@ -500,6 +515,86 @@ public:
         return k == nullptr ? IGA_DECODE_ERROR : IGA_SUCCESS;
     }
 
+    // decodes and formats one kernel of a batch; this touches no context
+    // state so that batch entries can be processed concurrently
+    void disassembleBatchEntry(
+        iga_disassemble_options_t dopts,
+        iga_disassemble_batch_entry_t &entry)
+    {
+        entry.output_size = 0;
+        if (entry.output_capacity > 0 && entry.output)
+            entry.output[0] = 0;
+        if ((entry.input == nullptr && entry.input_size != 0) ||
+            (entry.output == nullptr && entry.output_capacity != 0))
+        {
+            entry.status = IGA_INVALID_ARG;
+            return;
+        }
+
+        iga::ErrorHandler errHandler;
+        iga::Kernel *k = nullptr;
+        entry.status = disassembleKernel(
+            errHandler, dopts, entry.input, entry.input_size, k);
+        if (k == nullptr)
+            return;
+
+        std::stringstream ss;
+        FormatOpts fopts = formatterOpts(dopts, nullptr, nullptr);
+        DepAnalysis la;
+        if (dopts.formatting_opts & IGA_FORMATTING_OPT_PRINT_DEFS) {
+            la = ComputeDepAnalysis(k);
+            fopts.liveAnalysis = &la;
+        }
+        FormatKernel(errHandler, ss, fopts, *k, entry.input);
+        delete k;
+
+        std::string text = ss.str();
+        entry.output_size = (uint32_t)text.size();
+        if (entry.output_capacity > 0) {
+            size_t copyLen = std::min<size_t>(text.size(), entry.output_capacity - 1);
+            memcpy_s(entry.output, entry.output_capacity, text.data(), copyLen);
+            entry.output[copyLen] = 0;
+        }
+        if (errHandler.hasErrors()) {
+            entry.status = IGA_DECODE_ERROR;
+        }
+    }
+
+    iga_status_t disassembleBatch(
+        iga_disassemble_options_t &dopts,
+        iga_disassemble_batch_entry_t *entries,
+        uint32_t numEntries,
+        uint32_t numThreads)
+    {
+        if (numThreads == 0)
+            numThreads = std::max(1u, std::thread::hardware_concurrency());
+        numThreads = std::min(numThreads, numEntries);
+
+        std::atomic<uint32_t> nextEntry(0);
+        auto worker = [&]() {
+            for (uint32_t i = nextEntry++; i < numEntries; i = nextEntry++) {
+                disassembleBatchEntry(dopts, entries[i]);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (uint32_t i = 1; i < numThreads; i++) {
+            threads.emplace_back(worker);
+        }
+        worker();
+        for (auto &t : threads) {
+            t.join();
+        }
+
+        for (uint32_t i = 0; i < numEntries; i++) {
+            if (entries[i].status != IGA_SUCCESS ||
+                entries[i].output_size >= entries[i].output_capacity)
+            {
+                return IGA_ERROR;
+            }
+        }
+        return IGA_SUCCESS;
+    }
+
     iga_status_t disassemble(
         iga_disassemble_options_t &dopts,
         const void *bits,
@@ -520,7 +615,8 @@ public:
             dopts,
             bits,
             bitsLen,
-            k);
+            k,
+            m_decodeMem);
         if (k != nullptr) {
             // we succeeded in decoding; now format the output to text
             std::stringstream ss;
@@ -551,6 +647,9 @@ public:
             }
 
             delete k;
+            // nothing refers to the arena once the kernel is gone
+            if (m_decodeMem && m_decodeMem.use_count() == 1)
+                m_decodeMem->reset();
         } // k non-null
 
         st = translateDiagnostics(errHandler);
@@ -728,6 +827,17 @@ iga_status_t  iga_release_context(iga_context_t ctx)
     return iga_context_release(ctx);
 }
 
+iga_status_t  iga_context_reuse_decode_memory(
+    iga_context_t ctx,
+    uint32_t enable)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    ctx_obj->reuseDecodeMemory(enable != 0);
+    return IGA_SUCCESS;
+}
+
 iga_status_t  iga_context_assemble(
     iga_context_t ctx,
     const iga_assemble_options_t *aopts,
@@ -793,6 +903,28 @@ iga_status_t  iga_context_disassemble(
         fmt_label_ctx,
         kernel_text);
 }
+iga_status_t  iga_context_disassemble_batch(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *dopts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads)
+{
+    RETURN_INVALID_ARG_ON_NULL(ctx);
+    RETURN_INVALID_ARG_ON_NULL(dopts);
+    if (entries == nullptr && num_entries != 0)
+        return IGA_INVALID_ARG;
+    if (dopts->cb > sizeof(*dopts)) {
+        return IGA_VERSION_ERROR;
+    }
+    iga_disassemble_options_t doptsInternal = IGA_DISASSEMBLE_OPTIONS_INIT();
+    memcpy_s(&doptsInternal, dopts->cb, dopts, dopts->cb);
+
+    CAST_CONTEXT(ctx_obj, ctx);
+    return ctx_obj->disassembleBatch(
+        doptsInternal, entries, num_entries, num_threads);
+}
+
 iga_status_t  iga_disassemble(
     iga_context_t ctx,
     const iga_disassemble_options_t *dopts,
@@ -1169,6 +1301,9 @@ iga_status_t  iga_get_interface(iga_functions_t *funcs)
     funcs->iga_opspec_description = &iga_opspec_description;
     funcs->iga_opspec_op = &iga_opspec_op;
 
+    funcs->iga_context_disassemble_batch = &iga_context_disassemble_batch;
+    funcs->iga_context_reuse_decode_memory = &iga_context_reuse_decode_memory;
+
     return IGA_SUCCESS;
 }
 
@@ -235,6 +235,23 @@ IGA_API iga_status_t  iga_context_release(iga_context_t ctx);
 /* deprecated: covers to iga_context_release */
 IGA_API iga_status_t  iga_release_context(iga_context_t ctx);
 
+/*
+ * Makes iga_context_disassemble decode every kernel into a single memory
+ * arena owned by the context, which is reset (not freed) between kernels.
+ * Once the arena has grown to fit the largest kernel seen, decoding does
+ * no further heap allocation for the IR, which avoids heap fragmentation
+ * in long-running services that decode continuously. Passing 0 releases
+ * the arena.
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         upon success
+ *  IGA_INVALID_ARG     if an argument is NULL
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ */
+IGA_API iga_status_t  iga_context_reuse_decode_memory(
+    iga_context_t ctx,
+    uint32_t enable);
+
 
 /*****************************************************************************/
 /*                  Assembly Functions                                       */
@@ -507,6 +524,52 @@ IGA_API  iga_status_t  iga_disassemble(
     char **kernel_text);
 
 
+/*
+ * One kernel of a batch disassembly (see iga_context_disassemble_batch)
+ */
+typedef struct {
+    /* the kernel binary to decode */
+    const void      *input;
+    uint32_t         input_size;
+    /* caller-supplied output buffer; may be NULL if output_capacity is 0 */
+    uint32_t         output_capacity;
+    char            *output;
+    /* [out] the length of the full output excluding the NUL terminator;
+     * if this is not less than output_capacity the output was truncated
+     * and the kernel can be resubmitted with a big enough buffer */
+    uint32_t         output_size;
+    /* [out] the status of this kernel's disassembly */
+    iga_status_t     status;
+} iga_disassemble_batch_entry_t;
+
+/*
+ * Disassembles many kernels at once.
+ *
+ * The kernels are decoded and formatted independently on up to
+ * 'num_threads' threads (0 means one per hardware thread) and each
+ * result is written, NUL-terminated, into the entry's own buffer.
+ * Set IGA_FORMATTING_OPT_PRINT_JSON in 'opts' to get a structured
+ * (JSON) listing with the opcode, operands and SWSB of each instruction
+ * instead of assembly text.
+ *
+ * Unlike iga_context_disassemble, no label callback is accepted and no
+ * diagnostics are recorded in the context; only per-entry statuses.
+ *
+ * RETURNS:
+ *  IGA_SUCCESS         if every entry succeeded and fit its buffer
+ *  IGA_INVALID_ARG     if an argument is NULL
+ *  IGA_INVALID_OBJECT  if ctx has already been destroyed
+ *  IGA_ERROR           if any entry failed or was truncated; see the
+ *                      per-entry status and output_size
+ */
+IGA_API  iga_status_t  iga_context_disassemble_batch(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads);
+
+
 /*
  * Disassembles a single instruction.
  *
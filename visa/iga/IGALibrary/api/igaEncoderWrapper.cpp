@@ -8,10 +8,20 @@ SPDX-License-Identifier: MIT
 
 // IGA headers
 #include "../Backend/GED/Encoder.hpp"
+#include "../Backend/Native/Interface.hpp"
 #include "igaEncoderWrapper.hpp"
 
+#include <cstring>
+
 using namespace iga;
 
+bool KernelEncoder::useNativeEncoder(const EncoderOpts& opts) const
+{
+    // SWSB auto-dependency setting is only done by the GED encoder
+    return !m_forceGED && !opts.autoDepSet &&
+        iga::native::IsEncodeSupported(m_kernel->getModel(), opts);
+}
+
 iga_status_t KernelEncoder::encode()
 {
 
@@ -20,12 +30,38 @@ iga_status_t KernelEncoder::encode()
     enc_opt.autoDepSet = m_enableAutoDeps;
     enc_opt.swsbEncodeMode = m_swsbEncodeMode;
 
-    Encoder enc(m_kernel->getModel(), errHandler, enc_opt);
-    enc.encodeKernel(
-        *m_kernel,
-        m_kernel->getMemManager(),
-        m_buf,
-        m_binarySize);
+    if (useNativeEncoder(enc_opt))
+    {
+        size_t bitsLen = 0;
+        iga::native::Encode(m_kernel->getModel(), enc_opt, errHandler,
+            *m_kernel, m_buf, bitsLen);
+        m_binarySize = (uint32_t)bitsLen;
+
+        if (m_verifyWithGED && !errHandler.hasErrors())
+        {
+            // both encoders write PCs into the kernel; the layout must match
+            ErrorHandler gedErrHandler;
+            void* gedBuf = nullptr;
+            uint32_t gedSize = 0;
+            Encoder enc(m_kernel->getModel(), gedErrHandler, enc_opt);
+            enc.encodeKernel(*m_kernel, m_kernel->getMemManager(), gedBuf, gedSize);
+            if (gedErrHandler.hasErrors() || gedSize != m_binarySize ||
+                memcmp(gedBuf, m_buf, m_binarySize) != 0)
+            {
+                IGA_ASSERT_FALSE("native encoding differs from GED encoding");
+                return IGA_ENCODE_ERROR;
+            }
+        }
+    }
+    else
+    {
+        Encoder enc(m_kernel->getModel(), errHandler, enc_opt);
+        enc.encodeKernel(
+            *m_kernel,
+            m_kernel->getMemManager(),
+            m_buf,
+            m_binarySize);
+    }
 #ifdef _DEBUG
     if (errHandler.hasErrors()) {
         // failed encode
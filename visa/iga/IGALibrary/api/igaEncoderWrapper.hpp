@@ -10,6 +10,7 @@ SPDX-License-Identifier: MIT
 #define _IGA_ENCODER_WRAPPER_HPP
 
 #include "../IR/Kernel.hpp"
+#include "../Backend/EncoderOpts.hpp"
 #include "iga.h"
 
 // entry point for binary encoding of a IGA IR kernel
@@ -23,6 +24,12 @@ class KernelEncoder
     bool m_enableAutoDeps = false;
     // swsb encoding mode
     iga::SWSB_ENCODE_MODE m_swsbEncodeMode = iga::SWSB_ENCODE_MODE::SWSBInvalidMode;
+    // encode through GED even if the native encoder supports the platform
+    bool m_forceGED = false;
+    // re-encode through GED and compare when the native encoder is used
+    bool m_verifyWithGED = false;
+
+    bool useNativeEncoder(const iga::EncoderOpts& opts) const;
 
 public:
     // @param compact: auto compact instructions if applicable
@@ -59,6 +66,18 @@ public:
     {
         m_enableAutoDeps = enable;
     }
+
+    // The table-driven native encoder is used by default on the platforms it
+    // supports, as it avoids the per-field GED calls. GED remains available
+    // as a fallback and as a reference to check the native encoding against.
+    void forceGEDEncoder(bool force = true)
+    {
+        m_forceGED = force;
+    }
+    void verifyWithGED(bool verify = true)
+    {
+        m_verifyWithGED = verify;
+    }
 };
 
 #endif // _IGA_ENCODER_WRAPPER_HPP
@@ -45,6 +45,10 @@ typedef iga_status_t(CDECLATTRIBUTE * pIGACreateContext)(
 
 #define IGA_CONTEXT_RELEASE_STR "iga_context_release"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAContextRelease)(iga_context_t ctx);
+#define IGA_CONTEXT_REUSE_DECODE_MEMORY_STR "iga_context_reuse_decode_memory"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextReuseDecodeMemory)(
+    iga_context_t ctx,
+    uint32_t enable);
 /* deprecated name */
 #define IGA_RELEASE_CONTEXT_STR "iga_release_context"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAReleaseContext)(iga_context_t ctx);
@@ -103,6 +107,14 @@ typedef iga_status_t(CDECLATTRIBUTE * pIGADisassembleInstruction)(
     void *fmt_label_ctx,
     char **kernel_text);
 
+#define IGA_CONTEXT_DISASSEMBLE_BATCH_STR "iga_context_disassemble_batch"
+typedef iga_status_t(CDECLATTRIBUTE * pIGAContextDisassembleBatch)(
+    iga_context_t ctx,
+    const iga_disassemble_options_t *opts,
+    iga_disassemble_batch_entry_t *entries,
+    uint32_t num_entries,
+    uint32_t num_threads);
+
 #define IGA_CONTEXT_GET_ERRORS_STR "iga_context_get_errors"
 typedef iga_status_t(CDECLATTRIBUTE * pIGAContextGetErrors)(
     iga_context_t ctx,
@@ -350,6 +362,9 @@ typedef struct
     pIGAOpspecName                      iga_opspec_name;
     pIGAOpspecDescription               iga_opspec_description;
     pIGAOpspecOp                        iga_opspec_op;
+    /* batch functions (appended to keep the table layout) */
+    pIGAContextDisassembleBatch         iga_context_disassemble_batch;
+    pIGAContextReuseDecodeMemory        iga_context_reuse_decode_memory;
 } iga_functions_t;
 
 /*
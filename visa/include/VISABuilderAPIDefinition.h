@@ -323,6 +323,12 @@ public:
     /// [pred] goto (emask, execSize) label
     VISA_BUILDER_API virtual int AppendVISACFGotoInst(VISA_PredOpnd *pred, VISA_EMask_Ctrl emask, VISA_Exec_Size executionSize, VISA_LabelOpnd *label) = 0;
 
+    /// SetLastGotoBranchInfo -- describe the last appended goto to the branch heuristics:
+    /// whether its condition is uniform within the thread (even if the goto itself has to
+    /// stay divergent), and the profiled percentage of channels not taking it, or -1 if
+    /// unknown. It is not kept in the vISA binary.
+    VISA_BUILDER_API virtual int SetLastGotoBranchInfo(bool threadUniform, int fallThroughPercent) = 0;
+
     /// AppendVISACFLabelInst -- append a label instruction to this kernel
     /// label:
     VISA_BUILDER_API virtual int AppendVISACFLabelInst(VISA_LabelOpnd *label) = 0;
@@ -359,6 +365,9 @@ public:
     /// faddr symbolName dst
     /// symbolName is the unique string to identify the symbol whose address is taken
     /// dst must have UD type with scalar region
+    /// If symbolName starts with "INTEL_PATCH_" and dst is a 32-bit integer, dst
+    /// instead gets a 32-bit immediate that the runtime patches directly into
+    /// the binary (e.g., to specialize a constant without recompiling)
     VISA_BUILDER_API virtual int AppendVISACFSymbolInst(std::string symbolName, VISA_VectorOpnd* dst) = 0;
 
     /// AppendVISACFFunctionRetInst -- append a function return instruction to this kernel
@@ -780,6 +789,10 @@ public:
     /// This requires reRA pass to be executed, otherwise it returs nullptr
     VISA_BUILDER_API virtual int GetFreeGRFInfo(void *& buffer, unsigned int& size) = 0;
 
+    /// GetPerfModelReport -- returns the text report of the static performance model
+    /// This requires -perfModel, otherwise it returns nullptr
+    VISA_BUILDER_API virtual int GetPerfModelReport(const char*& report, unsigned int& size) = 0;
+
     ///Gets declaration id GenVar
     VISA_BUILDER_API virtual int getDeclarationID(VISA_GenVar *decl) const = 0;
 
@@ -863,6 +876,10 @@ public:
     // For inline asm code generation
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaText, const std::string& visaTextFile) = 0;
     VISA_BUILDER_API virtual int ParseVISAText(const std::string& visaFile) = 0;
+    // Parses a sequence of vISA text statements into the end of an existing kernel/function.
+    // Variables are referred to by their names in the kernel; vISA_ParseAsmFragment must be
+    // set before the kernel is created.
+    VISA_BUILDER_API virtual int ParseVISAFragment(VISAKernel* kernel, const std::string& visaText) = 0;
     VISA_BUILDER_API virtual std::stringstream& GetAsmTextStream() = 0;
     VISA_BUILDER_API virtual VISAKernel* GetVISAKernel(const std::string& kernelName = "") = 0;
     VISA_BUILDER_API virtual int ClearAsmTextStreams() = 0;
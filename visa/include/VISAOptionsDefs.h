@@ -57,6 +57,7 @@ DEF_VISA_OPTION(vISA_EnableAlways,          ET_BOOL, NULLSTR,            UNUSED,
 DEF_VISA_OPTION(vISA_EnableSendFusion,      ET_BOOL, "-enableSendFusion",   UNUSED, false)
 DEF_VISA_OPTION(vISA_EnableWriteFusion,     ET_BOOL, "-enableWriteFusion",  UNUSED, false)
 DEF_VISA_OPTION(vISA_EnableAtomicFusion,    ET_BOOL, "-enableAtomicFusion", UNUSED, false)
+DEF_VISA_OPTION(vISA_EnableCrossBBSendFusion, ET_BOOL, "-enableCrossBBSendFusion", UNUSED, false)
 DEF_VISA_OPTION(vISA_LocalCopyProp,         ET_BOOL, "-nocopyprop",      UNUSED, true)
 DEF_VISA_OPTION(vISA_LocalInstCombine,      ET_BOOL, "-noinstcombine",   UNUSED, true)
 DEF_VISA_OPTION(vISA_LocalFlagOpt,          ET_BOOL, "-noflagopt",       UNUSED, true)
@@ -67,7 +68,11 @@ DEF_VISA_OPTION(vISA_LocalDefHoist,         ET_BOOL, "-nodefhoist",      UNUSED,
 DEF_VISA_OPTION(vISA_FoldAddrImmed,         ET_BOOL, "-nofoldaddrimmed", UNUSED, true)
 DEF_VISA_OPTION(vISA_enableCSEL,            ET_BOOL, "-disablecsel",     UNUSED, true)
 DEF_VISA_OPTION(vISA_OptReport,             ET_BOOL, "-optreport",       UNUSED, false)
+DEF_VISA_OPTION(vISA_PerfModel,             ET_BOOL, "-perfModel",       UNUSED, false)
+DEF_VISA_OPTION(vISA_PerfModelTripCount,    ET_INT32, "-perfModelTripCount", "USAGE: -perfModelTripCount <loop trip count assumed by -perfModel>\n", 8)
 DEF_VISA_OPTION(vISA_MergeScalar,           ET_BOOL, "-nomergescalar",   UNUSED, true)
+DEF_VISA_OPTION(vISA_PreAlignUnalignedRegions, ET_BOOL, "-noPreAlignRegions", UNUSED, true)
+DEF_VISA_OPTION(vISA_MergeScalarWindow,     ET_INT32, "-mergeScalarWindow", "USAGE: -mergeScalarWindow <max instructions skipped between merged scalars>\n", 4)
 DEF_VISA_OPTION(vISA_EnableMACOpt,          ET_BOOL, "-nomac",           UNUSED, true)
 DEF_VISA_OPTION(vISA_EnableDCE,             ET_BOOL, "-dce",             UNUSED, false)
 DEF_VISA_OPTION(vISA_DisableleHFOpt,        ET_BOOL, "-disableHFOpt",    UNUSED, false)
@@ -84,9 +89,15 @@ DEF_VISA_OPTION(vISA_doAccSubAfterSchedule, ET_BOOL, "-accSubPostSchedule",    U
 DEF_VISA_OPTION(vISA_localizationForAccSub, ET_BOOL, "-localizeForACC",    UNUSED, false)
 DEF_VISA_OPTION(vISA_mathAccSub, ET_BOOL, "-mathAccSub",    UNUSED, false)
 DEF_VISA_OPTION(vISA_src2AccSub, ET_BOOL, "-src2AccSub",    UNUSED, false)
+DEF_VISA_OPTION(vISA_loopAccSub, ET_BOOL, "-loopAccSub",    UNUSED, false)
 DEF_VISA_OPTION(vISA_ifCvt,                 ET_BOOL, "-noifcvt",     UNUSED, true)
+DEF_VISA_OPTION(vISA_ifCvtUniformMaxInsts,  ET_INT32, "-ifCvtUniformMaxInsts", "USAGE: -ifCvtUniformMaxInsts <num>\n", 1)
+DEF_VISA_OPTION(vISA_ifCvtColdPercent,      ET_INT32, "-ifCvtColdPercent", "USAGE: -ifCvtColdPercent <percent>\n", 10)
+DEF_VISA_OPTION(vISA_MoveColdExitBlocks,    ET_BOOL, "-noMoveColdExitBlocks", UNUSED, true)
 DEF_VISA_OPTION(vISA_RegSharingHeuristics,  ET_BOOL, (IGC_MANGLE("-regSharingHeuristics")), UNUSED, false)
+DEF_VISA_OPTION(vISA_OccupancyGRFSelection, ET_BOOL, "-noOccupancyGRFSelection", UNUSED, true)
 DEF_VISA_OPTION(vISA_LVN,                   ET_BOOL, "-nolvn",       UNUSED, true)
+DEF_VISA_OPTION(vISA_GVN,                   ET_BOOL, "-gvn",         UNUSED, false)
 // only affects acc substitution for now
 DEF_VISA_OPTION(vISA_numGeneralAcc,         ET_INT32, "-numGeneralAcc", "USAGE: -numGeneralAcc <accNum>\n", 0)
 DEF_VISA_OPTION(vISA_reassociate,           ET_BOOL, "-noreassoc",   UNUSED, true)
@@ -124,28 +135,43 @@ DEF_VISA_OPTION(vISA_loadThreadPayloadStartReg, ET_INT32, (IGC_MANGLE("-setStart
 DEF_VISA_OPTION(vISA_emitCrossThreadOffR0Reloc,  ET_BOOL, "-emitCrossThreadOffR0Reloc",    UNUSED, false)
 DEF_VISA_OPTION(vISA_CodePatch,   ET_INT32, (IGC_MANGLE("-codePatch")),        UNUSED, 0)
 DEF_VISA_OPTION(vISA_Linker,      ET_INT32, (IGC_MANGLE("-linker")),        UNUSED, 0)
+DEF_VISA_OPTION(vISA_ParallelCompileThreads, ET_INT32, "-parallelCompileThreads", "USAGE: -parallelCompileThreads <num>\n", 0)
 
 //=== RA options ===
 DEF_VISA_OPTION(vISA_RoundRobin,            ET_BOOL, "-noroundrobin",    UNUSED, true)
 DEF_VISA_OPTION(vISA_PrintRegUsage,         ET_BOOL, "-printregusage",   UNUSED, false)
 DEF_VISA_OPTION(vISA_IPA,                   ET_BOOL, "-noipa",           UNUSED, true)
+DEF_VISA_OPTION(vISA_IPRA,                  ET_BOOL, "-noIPRA",          UNUSED, true)
 DEF_VISA_OPTION(vISA_LocalRA,               ET_BOOL, "-nolocalra",       UNUSED, true)
 DEF_VISA_OPTION(vISA_LocalRARoundRobin,     ET_BOOL, "-nolocalraroundrobin", UNUSED, true)
+DEF_VISA_OPTION(vISA_LocalRAHazardAware,    ET_BOOL, "-nolocalrahazardaware", UNUSED, true)
 DEF_VISA_OPTION(vISA_ForceSpills,           ET_BOOL, "-forcespills",     UNUSED, false)
 DEF_VISA_OPTION(vISA_NoIndirectForceSpills, ET_BOOL, "-noindirectforcespills", UNUSED, false)
 DEF_VISA_OPTION(vISA_AbortOnSpill,          ET_BOOL, "-abortonspill",    UNUSED, false)
 DEF_VISA_OPTION(vISA_VerifyRA,              ET_BOOL, "-verifyra",        UNUSED, false)
+DEF_VISA_OPTION(vISA_RALog,                 ET_CSTR, "-raLog",           "USAGE: -raLog <file prefix>\n", NULL)
+DEF_VISA_OPTION(vISA_RAReplay,              ET_CSTR, "-raReplay",        "USAGE: -raReplay <file prefix>\n", NULL)
 DEF_VISA_OPTION(vISA_LocalBankConflictReduction, ET_BOOL, "-nolocalBCR",   UNUSED, true)
+DEF_VISA_OPTION(vISA_DynamicBankConflictReduction, ET_BOOL, "-nodynamicBCR", UNUSED, true)
 DEF_VISA_OPTION(vISA_FailSafeRA,            ET_BOOL, "-nofailsafera",    UNUSED, true)
+DEF_VISA_OPTION(vISA_ARFSpillTempAssignment, ET_BOOL, "-noARFSpillTempAssignment", UNUSED, true)
+DEF_VISA_OPTION(vISA_FlagRemat,             ET_BOOL, "-noflagremat",     UNUSED, true)
 DEF_VISA_OPTION(vISA_FlagSpillCodeCleanup,  ET_BOOL, "-disableFlagSpillClean",            UNUSED, true)
 DEF_VISA_OPTION(vISA_GRFSpillCodeCleanup,   ET_BOOL, NULLSTR,            UNUSED, true)
 DEF_VISA_OPTION(vISA_SpillSpaceCompression, ET_BOOL, "-nospillcompression",            UNUSED, true)
+DEF_VISA_OPTION(vISA_PackSpillSlots,        ET_BOOL, "-nopackspillslots", UNUSED, true)
 DEF_VISA_OPTION(vISA_ConsiderLoopInfoInRA,  ET_BOOL, "-noloopra",        UNUSED, true)
+DEF_VISA_OPTION(vISA_LoopThroughSpillCost,  ET_BOOL, "-noLoopThroughSpillCost", UNUSED, true)
 DEF_VISA_OPTION(vISA_ReserveR0,             ET_BOOL, "-reserveR0",       UNUSED, false)
 DEF_VISA_OPTION(vISA_SpiltLLR,              ET_BOOL, "-nosplitllr",      UNUSED, true)
 DEF_VISA_OPTION(vISA_EnableGlobalScopeAnalysis,   ET_BOOL,  "-enableGlobalScopeAnalysis", UNUSED, false)
 DEF_VISA_OPTION(vISA_LocalDeclareSplitInGlobalRA, ET_BOOL, "-noLocalSplit",        UNUSED, true)
 DEF_VISA_OPTION(vISA_DisableSpillCoalescing, ET_BOOL, "-nospillcleanup", UNUSED, false)
+DEF_VISA_OPTION(vISA_ReuseGRFLiveness,      ET_BOOL, "-noReuseGRFLiveness", UNUSED, true)
+DEF_VISA_OPTION(vISA_LivenessWorklist,      ET_BOOL, "-noLivenessWorklist", UNUSED, true)
+DEF_VISA_OPTION(vISA_IntfBuildThreads,      ET_INT32, "-intfBuildThreads", "USAGE: -intfBuildThreads <num>\n", 0)
+DEF_VISA_OPTION(vISA_LocalDataflowThreads,  ET_INT32, "-localDataflowThreads", "USAGE: -localDataflowThreads <num>\n", 0)
+DEF_VISA_OPTION(vISA_ColoringThreads,       ET_INT32, "-coloringThreads", "USAGE: -coloringThreads <num>\n", 0)
 DEF_VISA_OPTION(vISA_GlobalSendVarSplit,    ET_BOOL, "-globalSendVarSplit", UNUSED, false)
 DEF_VISA_OPTION(vISA_NoRemat,               ET_BOOL, "-noremat",         UNUSED, false)
 DEF_VISA_OPTION(vISA_ForceRemat,            ET_BOOL, "-forceremat",      UNUSED, false)
@@ -156,26 +182,31 @@ DEF_VISA_OPTION(vISA_GRFNumToUse,           ET_INT32, "-GRFNumToUse",
 DEF_VISA_OPTION(vISA_RATrace,               ET_BOOL, "-ratrace", UNUSED, false)
 DEF_VISA_OPTION(vISA_FastSpill,             ET_BOOL, "-fasterRA", UNUSED, false)
 DEF_VISA_OPTION(vISA_AbortOnSpillThreshold, ET_INT32, NULLSTR, UNUSED, 0)
+DEF_VISA_OPTION(vISA_AutoGRFSelectionOnSpill, ET_BOOL, "-noAutoGRFOnSpill", UNUSED, true)
 DEF_VISA_OPTION(vISA_enableBCR, ET_BOOL, "-enableBCR",   UNUSED, false)
 DEF_VISA_OPTION(vISA_forceBCR, ET_BOOL, "-forceBCR",   UNUSED, false)
 DEF_VISA_OPTION(vISA_enableBundleCR, ET_BOOL, "-enableBundleCR",   UNUSED, true)
 DEF_VISA_OPTION(vISA_IntrinsicSplit,       ET_BOOL, "-doSplit", UNUSED, false)
+DEF_VISA_OPTION(vISA_SplitSendPayloads,    ET_BOOL, "-splitSendPayloads", UNUSED, false)
 DEF_VISA_OPTION(vISA_LraFFWindowSize,       ET_INT32, "-lraFFWindowSize", UNUSED, 12)
 DEF_VISA_OPTION(vISA_SplitGRFAlignedScalar, ET_BOOL, "-splitGRFalignedscalar", UNUSED, false)
 
 DEF_VISA_OPTION(vISA_VerifyAugmentation,    ET_BOOL, "-verifyaugmentation", UNUSED, false)
 DEF_VISA_OPTION(vISA_VerifyExplicitSplit,   ET_BOOL, "-verifysplit", UNUSED, false)
 DEF_VISA_OPTION(vISA_DumpRegChart,          ET_BOOL, "-dumpregchart", UNUSED, false)
+DEF_VISA_OPTION(vISA_PressureReport,        ET_BOOL, "-pressureReport", UNUSED, false)
 DEF_VISA_OPTION(vISA_DumpAllBCInfo,          ET_BOOL, "-dumpAllBCInfo", UNUSED, false)
 DEF_VISA_OPTION(vISA_LinearScan,               ET_BOOL, "-linearScan",       UNUSED, false)
 DEF_VISA_OPTION(vISA_LSFristFit,               ET_BOOL, "-lsFirstFit",       UNUSED, true)
 DEF_VISA_OPTION(vISA_verifyLinearScan,               ET_BOOL, "-verifyLinearScan",       UNUSED, false)
+DEF_VISA_OPTION(vISA_TieredRAInstThreshold,  ET_INT32, "-tieredRAThreshold", "USAGE: -tieredRAThreshold <instNum>\n", 200000)
 
 //=== scheduler options ===
 DEF_VISA_OPTION(vISA_LocalScheduling,       ET_BOOL, "-noschedule",      UNUSED, true)
 DEF_VISA_OPTION(vISA_preRA_Schedule,        ET_BOOL, "-nopresched",      UNUSED, true)
 DEF_VISA_OPTION(vISA_preRA_ScheduleForce,   ET_BOOL, "-presched",        UNUSED, false)
-DEF_VISA_OPTION(vISA_preRA_ScheduleCtrl,      ET_INT32, "-presched-ctrl",      "USAGE: -presched-ctrl <ctrl>\n", 4)
+DEF_VISA_OPTION(vISA_LoopPipelining,        ET_BOOL, "-loopPipelining",  UNUSED, false)
+DEF_VISA_OPTION(vISA_preRA_ScheduleCtrl,      ET_INT32, "-presched-ctrl",      "USAGE: -presched-ctrl <ctrl> (1: dump, 2: latency, 4: sethi-ullman, 8: clustering, 16: balanced)\n", 4)
 DEF_VISA_OPTION(vISA_preRA_ScheduleRPThreshold, ET_INT32, "-presched-rp",      "USAGE: -presched-rp <threshold>\n", 0)
 DEF_VISA_OPTION(vISA_ScheduleStartBBID, ET_INT32, "-sched-start",      "USAGE: -sched-start <BB ID>\n", 0)
 DEF_VISA_OPTION(vISA_ScheduleEndBBID, ET_INT32, "-sched-end",      "USAGE: -sched-end <BB ID>\n", 0)
@@ -201,6 +232,8 @@ DEF_VISA_OPTION(vISA_ReadSuppressionDepth, ET_INT32, "-readSuppressionDepth", UN
 DEF_VISA_OPTION(vISA_ScheduleForReadSuppression, ET_BOOL, "-scheduleForReadSuppression", UNUSED, false)
 DEF_VISA_OPTION(vISA_LocalSchedulingStartBB,   ET_INT32, "-scheduleStartBB", UNUSED, 0)
 DEF_VISA_OPTION(vISA_LocalSchedulingEndBB,     ET_INT32, "-scheduleEndBB", UNUSED, UINT_MAX)
+DEF_VISA_OPTION(vISA_SWSBAwareScheduling,     ET_BOOL, "-swsbAwareSchedule", UNUSED, false)
+DEF_VISA_OPTION(vISA_GlobalSendHoisting,       ET_BOOL, "-globalSendHoisting", UNUSED, false)
 
 //=== SWSB options ===
 DEF_VISA_OPTION(vISA_USEL3HIT,      ET_BOOL,  "-SBIDL3Hit",    UNUSED, false)
@@ -218,6 +251,8 @@ DEF_VISA_OPTION(vISA_EnableSendTokenReduction,      ET_BOOL,  "-SendTokenReducti
 DEF_VISA_OPTION(vISA_GlobalTokenAllocation,      ET_BOOL,  "-globalTokenAllocation",    UNUSED, false)
 DEF_VISA_OPTION(vISA_QuickTokenAllocation,      ET_BOOL,  "-quickTokenAllocation",    UNUSED, false)
 DEF_VISA_OPTION(vISA_DistPropTokenAllocation,      ET_BOOL,  "-distPropTokenAllocation",    UNUSED, false)
+DEF_VISA_OPTION(vISA_LatencyProfile,      ET_CSTR,  "-latencyProfile",    "USAGE: -latencyProfile <file>\n", NULL)
+DEF_VISA_OPTION(vISA_GraphColorTokenAllocation,      ET_BOOL,  "-graphColorTokenAllocation",    UNUSED, false)
 DEF_VISA_OPTION(vISA_SWSBStitch,      ET_BOOL,  "-SWSBStitch",    UNUSED, false)
 DEF_VISA_OPTION(vISA_SBIDDepLoc,      ET_BOOL,  "-SBIDDepLoc",    UNUSED, false)
 DEF_VISA_OPTION(vISA_DumpSBID,      ET_BOOL,  "-dumpSBID",    UNUSED, false)
@@ -237,6 +272,9 @@ DEF_VISA_OPTION(vISA_HybridRAWithSpill,    ET_BOOL, (IGC_MANGLE("-hybridRAWithSp
 DEF_VISA_OPTION(vISA_Compaction,          ET_BOOL,  "-nocompaction",    UNUSED, true)
 DEF_VISA_OPTION(vISA_BXMLEncoder,         ET_BOOL,  "-nobxmlencoder",   UNUSED, true)
 DEF_VISA_OPTION(vISA_IGAEncoder,          ET_BOOL,  "-IGAEncoder",      UNUSED, false)
+DEF_VISA_OPTION(vISA_IGANativeEncoder,    ET_BOOL,  "-noIGANativeEncoder", UNUSED, true)
+DEF_VISA_OPTION(vISA_IGAVerifyNativeEncoder, ET_BOOL, "-verifyIGANativeEncoder", UNUSED, false)
+DEF_VISA_OPTION(vISA_RemoveNoopSync,      ET_BOOL,  "-noRemoveNoopSync", UNUSED, true)
 
 //=== asm/isaasm/isa emission options ===
 DEF_VISA_OPTION(vISA_outputToFile,        ET_BOOL,  "-output",          UNUSED, false)
@@ -269,11 +307,15 @@ DEF_VISA_OPTION(vISA_PlatformIsSet,       ET_BOOL,  NULLSTR,              UNUSED
 DEF_VISA_OPTION(vISA_NoVerifyvISA,        ET_BOOL,  "-noverifyCISA",      UNUSED, false)
 DEF_VISA_OPTION(vISA_InitPayload,         ET_BOOL,  "-initializePayload", UNUSED, false)
 DEF_VISA_OPTION(vISA_isParseMode,         ET_BOOL,  NULLSTR,              UNUSED, false)
+// keep variable names of API-built kernels so that vISA text fragments can be parsed into them
+DEF_VISA_OPTION(vISA_ParseAsmFragment,    ET_BOOL,  NULLSTR,              UNUSED, false)
 //   rerun RA post scheduling for gtpin
 DEF_VISA_OPTION(vISA_ReRAPostSchedule,    ET_BOOL,  "-rerapostschedule",  UNUSED, false)
 DEF_VISA_OPTION(vISA_GTPinReRA,           ET_BOOL, "-GTPinReRA",          UNUSED, false)
 DEF_VISA_OPTION(vISA_GetFreeGRFInfo,      ET_BOOL,  "-getfreegrfinfo",    UNUSED, false)
 DEF_VISA_OPTION(vISA_GTPinScratchAreaSize,ET_INT32, "-GTPinScratchAreaSize", UNUSED, 0)
+//   keep the top <regNum> GRFs out of RA and report them as free to gtpin, without re-RA
+DEF_VISA_OPTION(vISA_GTPinReserveGRFs,    ET_INT32, "-GTPinReserveGRFs",  "USAGE: -GTPinReserveGRFs <regNum>\n", 0)
 DEF_VISA_OPTION(vISA_skipFenceCommit,     ET_BOOL,  "-skipFenceCommit", UNUSED, false)
 
 //=== HW Workarounds ===
@@ -309,6 +351,7 @@ DEF_VISA_OPTION(vISA_dumpPayload,         ET_BOOL, "-dumpPayload",        UNUSED
 
 DEF_VISA_OPTION(vISA_dumpToCurrentDir,    ET_BOOL, "-dumpToCurrentDir",   UNUSED, false)
 DEF_VISA_OPTION(vISA_dumpTimer,           ET_BOOL, "-timestats",          UNUSED, false)
+DEF_VISA_OPTION(vISA_BenchmarkIterations, ET_INT32, "-benchmark", "USAGE: -benchmark <iterations>\n", 0)
 DEF_VISA_OPTION(vISA_EnableCompilerStats,   ET_BOOL, "-compilerStats",      UNUSED, false)
 
 DEF_VISA_OPTION(vISA_3DOption,            ET_BOOL, "-3d",                 UNUSED, false)
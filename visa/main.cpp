@@ -9,6 +9,10 @@ SPDX-License-Identifier: MIT
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <vector>
 
 
 #include "visa_igc_common_header.h"
@@ -277,6 +281,77 @@ static bool endsWith(const std::string &str, const std::string &suf)
     return 0 == str.compare(str.length() - suf.length(), suf.length(), suf);
 }
 
+extern "C" double getTimerCounts(unsigned int idx);
+
+// Backend phases reported by -benchmark.
+static const struct {
+    TimerID timer;
+    const char *name;
+} benchmarkTimers[] = {
+    { TimerID::TOTAL,           "total" },
+    { TimerID::TOTAL_RA,        "ra" },
+    { TimerID::GRF_GLOBAL_RA,   "ra.global" },
+    { TimerID::INTERFERENCE,    "ra.interference" },
+    { TimerID::COLORING,        "ra.coloring" },
+    { TimerID::SPILL,           "ra.spill" },
+    { TimerID::SCHEDULING,      "scheduling" },
+    { TimerID::SWSB,            "swsb" },
+    { TimerID::ENCODE_AND_EMIT, "encode" },
+    { TimerID::IGA_ENCODER,     "encode.iga" },
+};
+
+// Compiles fName (1 + iterations) times and prints min/median/mean/stddev
+// of the backend phase timers over all but the first, warm-up, compilation.
+// Timers are thread local, so parallel kernel compilation must be disabled
+// for the numbers to be complete.
+static void runBenchmark(const std::string &fName, bool parserMode,
+    int argc, const char *argv[], Options &opt, unsigned iterations)
+{
+    const size_t numTimers = sizeof(benchmarkTimers) / sizeof(benchmarkTimers[0]);
+    std::vector<std::vector<double>> samples(numTimers);
+    for (unsigned iter = 0; iter <= iterations; iter++)
+    {
+        if (parserMode)
+        {
+            parseText(fName, argc, argv, opt);
+        }
+        else
+        {
+            parseBinary(fName, argc, argv, opt);
+        }
+        // the first compilation only warms up caches and the allocator
+        if (iter == 0)
+            continue;
+        for (size_t i = 0; i < numTimers; i++)
+        {
+            samples[i].push_back(getTimerCounts(static_cast<unsigned>(benchmarkTimers[i].timer)) * 1000.0);
+        }
+    }
+
+    std::cout << "benchmark " << fName << " (" << iterations << " iterations, ms)\n";
+    std::cout << std::left << std::setw(18) << "phase"
+        << std::right << std::setw(12) << "min" << std::setw(12) << "median"
+        << std::setw(12) << "mean" << std::setw(12) << "stddev" << "\n";
+    for (size_t i = 0; i < numTimers; i++)
+    {
+        auto &s = samples[i];
+        std::sort(s.begin(), s.end());
+        double mean = 0.0;
+        for (double v : s)
+            mean += v;
+        mean /= s.size();
+        double var = 0.0;
+        for (double v : s)
+            var += (v - mean) * (v - mean);
+        double stddev = std::sqrt(var / s.size());
+        std::cout << std::left << std::setw(18) << benchmarkTimers[i].name << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(12) << s.front() << std::setw(12) << s[s.size() / 2]
+            << std::setw(12) << mean << std::setw(12) << stddev << "\n";
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
 int main(int argc, const char *argv[])
 {
     char fileName[256];
@@ -405,7 +480,11 @@ int main(int argc, const char *argv[])
                 asmFileRoots.back().c_str());
         }
 
-        if (parserMode)
+        if (unsigned iterations = opt.getuInt32Option(vISA_BenchmarkIterations))
+        {
+            runBenchmark(fName, parserMode, argc - startPos, &argv[startPos], opt, iterations);
+        }
+        else if (parserMode)
         {
             parseText(fName, argc - startPos, &argv[startPos], opt);
         }